@@ -7,10 +7,15 @@
  */
 
 #include "AIEngine.h"
+#include "ShardedRosterLoader.h"
+#include "RosterSnapshot.h"
+#include "DatabaseManager.h"
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QUuid>
 #include <QtCore/QRandomGenerator>
+#include <QtCore/QTimer>
 #include <QtConcurrent/QtConcurrent>
 #include <random>
 #include <algorithm>
@@ -28,6 +33,12 @@ AIEngine::AIEngine(QObject *parent)
     , m_processTimer(new QTimer(this))
     , m_statusTimer(new QTimer(this))
     , m_heartbeatTimer(new QTimer(this))
+    , m_snapshotTimer(new QTimer(this))
+    , m_snapshotPath("data/ai_roster.snapshot")
+    , m_snapshotWriting(false)
+    , m_snapshotGeneration(0)
+    , m_snapshotWrittenGeneration(0)
+    , m_rosterIncomplete(false)
     , m_totalAiCount(0)
     , m_activeAiCount(0)
     , m_currentServerId(1)
@@ -40,6 +51,9 @@ AIEngine::AIEngine(QObject *parent)
     m_processTimer->setInterval(100);  // 100ms处理一次命令队列
     m_statusTimer->setInterval(5000);  // 5秒更新一次状态
     m_heartbeatTimer->setInterval(30000); // 30秒发送一次心跳
+    m_snapshotTimer->setInterval(SNAPSHOT_INTERVAL); // 定期写名册快照
+    
+    connect(m_snapshotTimer, &QTimer::timeout, this, [this]() { saveRosterSnapshot(); });
     
     // 连接信号槽
     connectSignalsAndSlots();
@@ -101,6 +115,7 @@ bool AIEngine::start()
     m_processTimer->start();
     m_statusTimer->start();
     m_heartbeatTimer->start();
+    m_snapshotTimer->start();
     
     // 启动性能监控
     m_performanceMonitor->start();
@@ -131,6 +146,10 @@ void AIEngine::stop()
     m_processTimer->stop();
     m_statusTimer->stop();
     m_heartbeatTimer->stop();
+    m_snapshotTimer->stop();
+    
+    // 停止前保存最新名册，下次启动直接从快照恢复
+    saveFinalRosterSnapshot();
     
     // 停止所有AI实例
     stopAllAiInstances();
@@ -155,6 +174,9 @@ void AIEngine::shutdown()
     
     stop();
     
+    // 等待未完成的名册分片，避免加载线程写入已清理的集合
+    m_rosterLoader.reset();
+    
     // 清理资源
     {
         QMutexLocker locker(&m_aiInstancesMutex);
@@ -211,5 +233,312 @@ QString AIEngine::createAiInstance(const AIPlayerData& playerData)
     return aiId;
 }
 
+/**
+ * @brief 从数据库并行分片加载AI名册
+ */
+bool AIEngine::loadRoster(DatabaseManager* databaseManager)
+{
+    if (m_rosterLoader && m_rosterLoader->isLoading()) {
+        qWarning() << "AIEngine: 名册正在加载中";
+        return false;
+    }
+    
+    // 有可用快照时直接从快照恢复，数据库只补齐快照之后的变化
+    if (loadRosterSnapshot(databaseManager)) {
+        return true;
+    }
+    
+    m_rosterLoader = std::make_unique<ShardedRosterLoader>(databaseManager);
+    m_rosterIncomplete = false;
+    
+    // 就绪信号从加载线程发出，排队到引擎线程处理
+    connect(m_rosterLoader.get(), &ShardedRosterLoader::serverReady,
+            this, &AIEngine::activateServerShard, Qt::QueuedConnection);
+    
+    // 失败信号在加载结束前发出，直接置位，之后不会写出缺少该服务器的快照
+    connect(m_rosterLoader.get(), &ShardedRosterLoader::serverFailed,
+            this, [this](int, int) { m_rosterIncomplete = true; }, Qt::DirectConnection);
+    
+    return m_rosterLoader->start([this](const QString& aiId, const AIPlayerData& playerData) {
+        registerLoadedInstance(aiId, playerData);
+    });
+}
+
+/**
+ * @brief 检查服务器名册是否已加载完成
+ */
+bool AIEngine::isServerRosterReady(int serverId) const
+{
+    return m_rosterLoader && m_rosterLoader->isServerReady(serverId);
+}
+
+/**
+ * @brief 登记从数据库加载的AI
+ */
+void AIEngine::registerLoadedInstance(const QString& aiId, const AIPlayerData& playerData, AIStatus status)
+{
+    // 沿用数据库中的ID和服务器分配，不再经过负载均衡器
+    auto aiInstance = std::make_shared<AIPlayerInstance>();
+    aiInstance->id = aiId;
+    aiInstance->playerData = playerData;
+    aiInstance->status = status;
+    aiInstance->createdTime = QDateTime::currentDateTime();
+    aiInstance->lastUpdateTime = aiInstance->createdTime;
+    
+    QMutexLocker locker(&m_aiInstancesMutex);
+    m_aiInstances[aiId] = aiInstance;
+    m_pendingActivation[playerData.serverId].push_back(aiId);
+    m_totalAiCount++;
+}
+
+/**
+ * @brief 启动已就绪服务器上加载的AI
+ */
+void AIEngine::activateServerShard(int serverId, int rows)
+{
+    QVector<std::shared_ptr<AIPlayerInstance>> instances;
+    {
+        QMutexLocker locker(&m_aiInstancesMutex);
+        auto pending = m_pendingActivation.find(serverId);
+        if (pending == m_pendingActivation.end()) {
+            return;
+        }
+        
+        instances.reserve(static_cast<int>(pending->second.size()));
+        for (const QString& aiId : pending->second) {
+            auto it = m_aiInstances.find(aiId);
+            if (it != m_aiInstances.end()) {
+                instances.append(it.value());
+            }
+        }
+        m_pendingActivation.erase(pending);
+    }
+    
+    for (const auto& aiInstance : instances) {
+        AICommand command;
+        command.type = AICommandType::CREATE;
+        command.aiId = aiInstance->id;
+        command.priority = CommandPriority::NORMAL;
+        command.timestamp = QDateTime::currentMSecsSinceEpoch();
+        command.data = aiInstanceToJson(aiInstance);
+        
+        addCommand(command);
+    }
+    
+    qDebug() << "AIEngine: 服务器" << serverId << "名册就绪，启动AI数:" << instances.size()
+             << "/" << rows;
+}
+
+/**
+ * @brief 将当前AI名册写入本地快照
+ */
+bool AIEngine::saveRosterSnapshot(const QString& filePath)
+{
+    // 名册仍在从数据库加载或有服务器加载失败时不写快照，避免覆盖为不完整的名册
+    if ((m_rosterLoader && m_rosterLoader->isLoading()) || m_rosterIncomplete ||
+        m_snapshotWriting.exchange(true)) {
+        return false;
+    }
+    
+    const quint64 generation = ++m_snapshotGeneration;
+    QDateTime capturedAt = QDateTime::currentDateTimeUtc();
+    QVector<RosterSnapshot::Entry> entries = captureRosterSnapshot();
+    QString path = filePath.isEmpty() ? m_snapshotPath : filePath;
+    
+    // 编码和落盘在后台线程完成
+    m_threadPool->start([this, entries, capturedAt, path, generation]() {
+        {
+            QMutexLocker locker(&m_snapshotMutex);
+            writeRosterSnapshotLocked(path, entries, capturedAt, generation);
+        }
+        m_snapshotWriting.store(false);
+    });
+    
+    return true;
+}
+
+/**
+ * @brief 停止时同步写入最终快照
+ */
+bool AIEngine::saveFinalRosterSnapshot()
+{
+    // 加载中的名册不完整，等加载线程结束后再采集
+    if (m_rosterLoader && m_rosterLoader->isLoading()) {
+        m_rosterLoader->waitForFinished();
+    }
+    if (m_rosterIncomplete) {
+        qWarning() << "AIEngine: 名册有服务器加载失败，不写入最终快照";
+        return false;
+    }
+    
+    const quint64 generation = ++m_snapshotGeneration;
+    QDateTime capturedAt = QDateTime::currentDateTimeUtc();
+    QVector<RosterSnapshot::Entry> entries = captureRosterSnapshot();
+    
+    // 持锁即等待进行中的后台写入；尚未开始的旧写入在其后发现序号较旧而跳过
+    QMutexLocker locker(&m_snapshotMutex);
+    return writeRosterSnapshotLocked(m_snapshotPath, entries, capturedAt, generation);
+}
+
+/**
+ * @brief 采集当前名册
+ */
+QVector<RosterSnapshot::Entry> AIEngine::captureRosterSnapshot()
+{
+    QVector<RosterSnapshot::Entry> entries;
+    QMutexLocker locker(&m_aiInstancesMutex);
+    entries.reserve(m_aiInstances.size());
+    
+    for (auto it = m_aiInstances.constBegin(); it != m_aiInstances.constEnd(); ++it) {
+        const auto& aiInstance = it.value();
+        RosterSnapshot::Entry entry;
+        entry.aiId = aiInstance->id;
+        entry.name = aiInstance->playerData.name;
+        entry.school = static_cast<int>(aiInstance->playerData.school);
+        entry.level = aiInstance->playerData.level;
+        entry.serverId = aiInstance->playerData.serverId;
+        entry.aggression = aiInstance->playerData.aggression;
+        entry.intelligence = aiInstance->playerData.intelligence;
+        entry.social = aiInstance->playerData.social;
+        entry.antiLag = aiInstance->playerData.antiLag;
+        entry.status = static_cast<int>(aiInstance->status);
+        entries.append(entry);
+    }
+    return entries;
+}
+
+/**
+ * @brief 写入快照（调用方持有m_snapshotMutex）
+ */
+bool AIEngine::writeRosterSnapshotLocked(const QString& path, const QVector<RosterSnapshot::Entry>& entries,
+                                         const QDateTime& capturedAt, quint64 generation)
+{
+    if (path == m_snapshotPath) {
+        if (generation < m_snapshotWrittenGeneration) {
+            return true;    // 已写入更新的快照
+        }
+        m_snapshotWrittenGeneration = generation;
+    }
+    
+    QString error;
+    if (!RosterSnapshot::write(path, entries, capturedAt, &error)) {
+        qWarning() << "AIEngine: 名册快照保存失败:" << error;
+        return false;
+    }
+    qDebug() << "AIEngine: 名册快照已保存，AI数:" << entries.size();
+    return true;
+}
+
+/**
+ * @brief 从本地快照恢复名册，并在后台与数据库对账
+ */
+bool AIEngine::loadRosterSnapshot(DatabaseManager* databaseManager)
+{
+    QVector<RosterSnapshot::Entry> entries;
+    QDateTime capturedAt;
+    QString error;
+    
+    if (!RosterSnapshot::read(m_snapshotPath, entries, capturedAt, &error)) {
+        if (QFile::exists(m_snapshotPath)) {
+            qWarning() << "AIEngine: 名册快照不可用，改为从数据库加载:" << error;
+        }
+        return false;
+    }
+    
+    for (const RosterSnapshot::Entry& entry : entries) {
+        AIPlayerData playerData;
+        playerData.name = entry.name;
+        playerData.school = static_cast<School>(entry.school);
+        playerData.level = entry.level;
+        playerData.serverId = entry.serverId;
+        playerData.aggression = entry.aggression;
+        playerData.intelligence = entry.intelligence;
+        playerData.social = entry.social;
+        playerData.antiLag = entry.antiLag;
+        
+        // 恢复保存时的状态，后续对账只更新数据不改变状态
+        registerLoadedInstance(entry.aiId, playerData, static_cast<AIStatus>(entry.status));
+    }
+    
+    activatePendingInstances();
+    
+    qDebug() << "AIEngine: 从快照恢复名册，AI数:" << entries.size()
+             << "快照时间:" << capturedAt.toString(Qt::ISODate);
+    
+    // 后台补齐快照之后数据库中的变化，回退一段余量覆盖两端时钟偏差
+    reconcileRosterSince(databaseManager, capturedAt.addMSecs(-SNAPSHOT_RECONCILE_MARGIN));
+    
+    return true;
+}
+
+/**
+ * @brief 后台补齐指定时间之后数据库中的名册变化，失败时退避重试
+ */
+void AIEngine::reconcileRosterSince(DatabaseManager* databaseManager, const QDateTime& since, int attempt)
+{
+    // 对账成功前名册缺少快照之后的变化，不写快照，否则新快照的时间会越过这些变化
+    m_rosterIncomplete = true;
+    
+    m_threadPool->start([this, databaseManager, since, attempt]() {
+        int rows = databaseManager->scanAiChangedSince(since, [this](const QString& aiId, const AIPlayerData& playerData) {
+            applyReconciledInstance(aiId, playerData);
+        });
+        
+        if (rows < 0) {
+            // 已应用的部分在重试时按相同数据覆盖，从同一时间点重新扫描即可
+            const int delay = qMin(RECONCILE_RETRY_MAX_DELAY, RECONCILE_RETRY_INITIAL_DELAY << qMin(attempt, 6));
+            qWarning() << "AIEngine: 名册快照对账失败，" << delay << "毫秒后第" << attempt + 1 << "次重试";
+            QMetaObject::invokeMethod(this, [this, databaseManager, since, attempt, delay]() {
+                QTimer::singleShot(delay, this, [this, databaseManager, since, attempt]() {
+                    reconcileRosterSince(databaseManager, since, attempt + 1);
+                });
+            }, Qt::QueuedConnection);
+            return;
+        }
+        
+        qDebug() << "AIEngine: 名册快照对账完成，更新AI数:" << rows;
+        m_rosterIncomplete = false;
+        QMetaObject::invokeMethod(this, [this]() { activatePendingInstances(); }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 应用对账得到的AI数据
+ */
+void AIEngine::applyReconciledInstance(const QString& aiId, const AIPlayerData& playerData)
+{
+    {
+        QMutexLocker locker(&m_aiInstancesMutex);
+        auto it = m_aiInstances.find(aiId);
+        if (it != m_aiInstances.end()) {
+            // 已在运行的AI只更新数据，保持当前状态
+            it.value()->playerData = playerData;
+            it.value()->lastUpdateTime = QDateTime::currentDateTime();
+            return;
+        }
+    }
+    
+    // 快照之后新增的AI
+    registerLoadedInstance(aiId, playerData);
+}
+
+/**
+ * @brief 启动所有已登记但尚未启动的AI
+ */
+void AIEngine::activatePendingInstances()
+{
+    QVector<QPair<int, int>> servers;
+    {
+        QMutexLocker locker(&m_aiInstancesMutex);
+        for (const auto& pending : m_pendingActivation) {
+            servers.append(qMakePair(pending.first, static_cast<int>(pending.second.size())));
+        }
+    }
+    
+    for (const auto& server : servers) {
+        activateServerShard(server.first, server.second);
+    }
+}
+
 // 继续添加其他方法的实现...
 // [为了简洁，这里显示主要的初始化和创建方法]
\ No newline at end of file
@@ -27,11 +27,20 @@
 #include <string>
 #include <random>
 
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "RosterSnapshot.h"
+
 // 前置声明
 class PlayerSimulator;
 class DecisionMaker;
 class ThreadPool;
 class DatabaseManager;
+class ShardedRosterLoader;
+class QTimer;
 
 /**
  * @struct AIPlayerData
@@ -202,6 +211,30 @@ public:
      */
     std::vector<std::shared_ptr<AIPlayerData>> getAIByServer(int serverId);
     
+    /**
+     * @brief 从数据库并行分片加载AI名册
+     * @param databaseManager 数据库管理器
+     * @return 是否成功开始加载
+     * 
+     * 每个服务器的名册加载完成后，该服务器上的AI立即开始运行，
+     * 不等待其他服务器。
+     */
+    bool loadRoster(DatabaseManager* databaseManager);
+    
+    /**
+     * @brief 检查服务器名册是否已加载完成
+     * @param serverId 服务器ID
+     * @return 是否就绪
+     */
+    bool isServerRosterReady(int serverId) const;
+    
+    /**
+     * @brief 将当前AI名册写入本地快照
+     * @param filePath 快照路径，为空时使用默认路径
+     * @return 是否成功开始写入（写入在后台线程完成）
+     */
+    bool saveRosterSnapshot(const QString& filePath = QString());
+    
     // 指令处理接口
     /**
      * @brief 发送指令给AI
@@ -318,16 +351,88 @@ private:
      * @return AI ID
      */
     std::string generateUniqueId();
+    
+    /**
+     * @brief 登记从数据库加载的AI（加载线程调用）
+     * @param aiId AI ID
+     * @param playerData AI数据
+     * @param status 初始状态（从快照恢复时为保存时的状态）
+     */
+    void registerLoadedInstance(const QString& aiId, const AIPlayerData& playerData,
+                                AIStatus status = AIStatus::OFFLINE);
+    
+    /**
+     * @brief 启动已就绪服务器上加载的AI
+     * @param serverId 服务器ID
+     * @param rows 该服务器加载的AI数量
+     */
+    void activateServerShard(int serverId, int rows);
+    
+    /**
+     * @brief 从本地快照恢复名册，并在后台与数据库对账
+     * @param databaseManager 数据库管理器
+     * @return 是否成功从快照恢复
+     */
+    bool loadRosterSnapshot(DatabaseManager* databaseManager);
+    
+    /**
+     * @brief 后台补齐指定时间之后数据库中的名册变化，扫描失败时退避重试
+     * @param databaseManager 数据库管理器
+     * @param since 起始时间
+     * @param attempt 已重试次数
+     */
+    void reconcileRosterSince(DatabaseManager* databaseManager, const QDateTime& since, int attempt = 0);
+    
+    /**
+     * @brief 应用对账得到的AI数据（对账线程调用）
+     * @param aiId AI ID
+     * @param playerData 数据库中的AI数据
+     */
+    void applyReconciledInstance(const QString& aiId, const AIPlayerData& playerData);
+    
+    /**
+     * @brief 启动所有已登记但尚未启动的AI
+     */
+    void activatePendingInstances();
+    
+    /**
+     * @brief 采集当前名册
+     * @return 快照条目
+     */
+    QVector<RosterSnapshot::Entry> captureRosterSnapshot();
+    
+    /**
+     * @brief 写入快照（调用方持有m_snapshotMutex）
+     * @param generation 采集序号，早于已写入序号的快照不再覆盖
+     * @return 是否成功
+     */
+    bool writeRosterSnapshotLocked(const QString& path, const QVector<RosterSnapshot::Entry>& entries,
+                                   const QDateTime& capturedAt, quint64 generation);
+    
+    /**
+     * @brief 停止时同步写入最终快照（等待进行中的加载和写入）
+     * @return 是否成功
+     */
+    bool saveFinalRosterSnapshot();
 
 private:
     // 核心组件
     std::unique_ptr<ThreadPool> m_threadPool;          ///< 线程池
     std::unique_ptr<DecisionMaker> m_decisionMaker;    ///< 决策制定器
     std::unique_ptr<DatabaseManager> m_databaseManager; ///< 数据库管理器
+    std::unique_ptr<ShardedRosterLoader> m_rosterLoader; ///< 名册分片加载器
+    QTimer* m_snapshotTimer;                            ///< 名册快照定时器
+    QString m_snapshotPath;                             ///< 名册快照路径
+    std::atomic<bool> m_snapshotWriting;                ///< 快照是否正在写入
+    QMutex m_snapshotMutex;                             ///< 快照写入互斥锁（停止时借此等待后台写入）
+    std::atomic<quint64> m_snapshotGeneration;          ///< 快照采集序号
+    quint64 m_snapshotWrittenGeneration;                ///< 已写入默认路径的采集序号
+    std::atomic<bool> m_rosterIncomplete;               ///< 名册有服务器加载失败或快照对账未完成，不写快照
     
     // AI数据存储
     std::unordered_map<std::string, std::shared_ptr<AIPlayerData>> m_aiPlayers;
     mutable std::shared_mutex m_aiPlayersMutex;        ///< AI数据读写锁
+    std::unordered_map<int, std::vector<QString>> m_pendingActivation; ///< 服务器ID -> 已加载待启动的AI
     
     // 指令队列
     std::priority_queue<AICommand, std::vector<AICommand>, 
@@ -359,6 +464,10 @@ private:
     static constexpr int DEFAULT_MAX_AI_COUNT = 1000;     ///< 默认最大AI数量
     static constexpr int DEFAULT_THREAD_COUNT = 8;        ///< 默认线程数量
     static constexpr int COMMAND_QUEUE_MAX_SIZE = 10000;  ///< 指令队列最大大小
+    static constexpr int SNAPSHOT_INTERVAL = 300000;      ///< 名册快照间隔（毫秒）
+    static constexpr int SNAPSHOT_RECONCILE_MARGIN = 60000; ///< 对账时间回退余量（毫秒，覆盖时钟偏差）
+    static constexpr int RECONCILE_RETRY_INITIAL_DELAY = 1000; ///< 对账失败首次重试延迟（毫秒，之后逐次翻倍）
+    static constexpr int RECONCILE_RETRY_MAX_DELAY = 60000;    ///< 对账失败重试延迟上限（毫秒）
 };
 
 /**
@@ -0,0 +1,254 @@
+/**
+ * @file RosterSnapshot.cpp
+ * @brief RANOnline EP7 AI系统 - AI名册本地快照实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "RosterSnapshot.h"
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <array>
+#include <cstring>
+
+namespace {
+
+/**
+ * @struct SnapshotHeader
+ * @brief 文件头（64字节）
+ */
+struct SnapshotHeader {
+    quint32 magic;              ///< 魔数
+    quint32 version;            ///< 格式版本
+    quint32 headerSize;         ///< 文件头大小
+    quint32 recordSize;         ///< 单条记录大小
+    quint32 recordCount;        ///< 记录数
+    quint32 checksum;           ///< 文件头之后全部内容的CRC32
+    qint64 capturedAtMs;        ///< 快照时间（UTC毫秒）
+    quint64 stringsOffset;      ///< 字符串区偏移（字节）
+    quint64 stringsLength;      ///< 字符串区长度（UTF-16码元）
+    quint8 reserved[16];        ///< 保留
+};
+
+/**
+ * @struct SnapshotRecord
+ * @brief 定长AI记录（48字节）
+ */
+struct SnapshotRecord {
+    quint32 idOffset;           ///< AI ID在字符串区的偏移（码元）
+    quint32 nameOffset;         ///< 名称在字符串区的偏移（码元）
+    quint16 idLength;           ///< AI ID长度
+    quint16 nameLength;         ///< 名称长度
+    qint32 school;
+    qint32 level;
+    qint32 serverId;
+    qint32 aggression;
+    qint32 intelligence;
+    qint32 social;
+    qint32 status;
+    quint8 antiLag;
+    quint8 reserved[7];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "快照文件头必须为64字节");
+static_assert(sizeof(SnapshotRecord) == 48, "快照记录必须为48字节");
+
+/**
+ * @brief 生成CRC32查找表（IEEE 802.3多项式）
+ */
+constexpr std::array<quint32, 256> makeCrc32Table()
+{
+    std::array<quint32, 256> table{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> CRC32_TABLE = makeCrc32Table();
+
+/**
+ * @brief 设置错误信息
+ */
+void setError(QString* error, const QString& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 计算CRC32
+ */
+quint32 RosterSnapshot::crc32(const uchar* data, qint64 size, quint32 crc)
+{
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = CRC32_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief 写入快照
+ */
+bool RosterSnapshot::write(const QString& filePath, const QVector<Entry>& entries,
+                           const QDateTime& capturedAt, QString* error)
+{
+    QVector<SnapshotRecord> records(entries.size());
+    QString strings;
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry& entry = entries.at(i);
+        SnapshotRecord& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+
+        const QString aiId = entry.aiId.left(0xFFFF);
+        const QString name = entry.name.left(0xFFFF);
+
+        record.idOffset = static_cast<quint32>(strings.size());
+        record.idLength = static_cast<quint16>(aiId.size());
+        strings.append(aiId);
+        record.nameOffset = static_cast<quint32>(strings.size());
+        record.nameLength = static_cast<quint16>(name.size());
+        strings.append(name);
+
+        record.school = entry.school;
+        record.level = entry.level;
+        record.serverId = entry.serverId;
+        record.aggression = entry.aggression;
+        record.intelligence = entry.intelligence;
+        record.social = entry.social;
+        record.status = entry.status;
+        record.antiLag = entry.antiLag ? 1 : 0;
+    }
+
+    const qint64 recordBytes = static_cast<qint64>(records.size()) * sizeof(SnapshotRecord);
+    const qint64 stringBytes = static_cast<qint64>(strings.size()) * sizeof(QChar);
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.recordSize = sizeof(SnapshotRecord);
+    header.recordCount = static_cast<quint32>(records.size());
+    header.capturedAtMs = capturedAt.toMSecsSinceEpoch();
+    header.stringsOffset = sizeof(SnapshotHeader) + recordBytes;
+    header.stringsLength = static_cast<quint64>(strings.size());
+    header.checksum = crc32(reinterpret_cast<const uchar*>(records.constData()), recordBytes);
+    header.checksum = crc32(reinterpret_cast<const uchar*>(strings.constData()), stringBytes, header.checksum);
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // 先写临时文件再原子替换
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.constData()), recordBytes);
+    file.write(reinterpret_cast<const char*>(strings.constData()), stringBytes);
+
+    if (!file.commit()) {
+        setError(error, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取快照
+ */
+bool RosterSnapshot::read(const QString& filePath, QVector<Entry>& entries,
+                          QDateTime& capturedAt, QString* error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(SnapshotHeader))) {
+        setError(error, "快照文件过短");
+        return false;
+    }
+
+    // 优先内存映射，映射失败时退回整体读取
+    QByteArray buffer;
+    const uchar* base = file.map(0, size);
+    if (!base) {
+        buffer = file.readAll();
+        base = reinterpret_cast<const uchar*>(buffer.constData());
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (header.magic != MAGIC || header.headerSize != sizeof(SnapshotHeader)) {
+        setError(error, "快照格式无效");
+        return false;
+    }
+    if (header.version != VERSION || header.recordSize != sizeof(SnapshotRecord)) {
+        setError(error, QString("快照版本不兼容: %1").arg(header.version));
+        return false;
+    }
+
+    const quint64 recordBytes = static_cast<quint64>(header.recordCount) * sizeof(SnapshotRecord);
+    if (header.stringsOffset != sizeof(SnapshotHeader) + recordBytes ||
+        header.stringsOffset + header.stringsLength * sizeof(QChar) != static_cast<quint64>(size)) {
+        setError(error, "快照长度与文件头不符");
+        return false;
+    }
+
+    const uchar* body = base + sizeof(SnapshotHeader);
+    if (crc32(body, size - static_cast<qint64>(sizeof(SnapshotHeader))) != header.checksum) {
+        setError(error, "快照校验失败");
+        return false;
+    }
+
+    const auto* records = reinterpret_cast<const SnapshotRecord*>(body);
+    const auto* strings = reinterpret_cast<const QChar*>(base + header.stringsOffset);
+
+    entries.clear();
+    entries.reserve(static_cast<int>(header.recordCount));
+
+    for (quint32 i = 0; i < header.recordCount; ++i) {
+        const SnapshotRecord& record = records[i];
+        if (static_cast<quint64>(record.idOffset) + record.idLength > header.stringsLength ||
+            static_cast<quint64>(record.nameOffset) + record.nameLength > header.stringsLength) {
+            setError(error, "快照字符串引用越界");
+            entries.clear();
+            return false;
+        }
+
+        Entry entry;
+        entry.aiId = QString(strings + record.idOffset, record.idLength);
+        entry.name = QString(strings + record.nameOffset, record.nameLength);
+        entry.school = record.school;
+        entry.level = record.level;
+        entry.serverId = record.serverId;
+        entry.aggression = record.aggression;
+        entry.intelligence = record.intelligence;
+        entry.social = record.social;
+        entry.status = record.status;
+        entry.antiLag = record.antiLag != 0;
+        entries.append(entry);
+    }
+
+    capturedAt = QDateTime::fromMSecsSinceEpoch(header.capturedAtMs);
+    return true;
+}
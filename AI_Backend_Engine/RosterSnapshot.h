@@ -0,0 +1,83 @@
+/**
+ * @file RosterSnapshot.h
+ * @brief RANOnline EP7 AI系统 - AI名册本地快照头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 带版本号和CRC32校验的二进制快照
+ * - 定长记录 + 字符串区布局，加载时直接内存映射读取
+ * - QSaveFile原子替换，写入中途崩溃不会破坏旧快照
+ * - 记录快照时间，重启后只需从数据库补齐此后的变化
+ */
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * @class RosterSnapshot
+ * @brief AI名册快照读写
+ *
+ * 文件布局（小端）:
+ *   Header（64字节） | Record × recordCount | UTF-16字符串区
+ * Record为定长结构，字符串以（偏移, 长度）引用字符串区，
+ * 读取时不需要逐条反序列化。CRC32覆盖Header之后的全部内容。
+ */
+class RosterSnapshot
+{
+public:
+    /**
+     * @struct Entry
+     * @brief 快照中的一个AI
+     */
+    struct Entry {
+        QString aiId;               ///< AI ID
+        QString name;               ///< 名称
+        int school = 0;             ///< 学校
+        int level = 1;              ///< 等级
+        int serverId = 1;           ///< 服务器ID
+        int aggression = 50;        ///< 攻击性
+        int intelligence = 50;      ///< 智能度
+        int social = 50;            ///< 社交性
+        bool antiLag = false;       ///< 防卡顿
+        int status = 0;             ///< 状态
+    };
+
+    /**
+     * @brief 写入快照
+     * @param filePath 文件路径
+     * @param entries AI列表
+     * @param capturedAt 快照时间（用于之后的增量对账）
+     * @param error 输出错误信息（可为空）
+     * @return 是否成功
+     */
+    static bool write(const QString& filePath, const QVector<Entry>& entries,
+                      const QDateTime& capturedAt, QString* error = nullptr);
+
+    /**
+     * @brief 读取快照
+     * @param filePath 文件路径
+     * @param entries 输出AI列表
+     * @param capturedAt 输出快照时间
+     * @param error 输出错误信息（可为空）
+     * @return 是否成功（版本不符或校验失败返回false）
+     */
+    static bool read(const QString& filePath, QVector<Entry>& entries,
+                     QDateTime& capturedAt, QString* error = nullptr);
+
+    /**
+     * @brief 计算CRC32
+     * @param data 数据
+     * @param size 长度
+     * @param crc 初始值（用于分段计算）
+     * @return CRC32
+     */
+    static quint32 crc32(const uchar* data, qint64 size, quint32 crc = 0);
+
+    static constexpr quint32 MAGIC = 0x534E5352;    ///< "RSNS"
+    static constexpr quint32 VERSION = 1;           ///< 当前格式版本
+};
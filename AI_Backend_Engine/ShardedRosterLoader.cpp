@@ -0,0 +1,271 @@
+/**
+ * @file ShardedRosterLoader.cpp
+ * @brief RANOnline EP7 AI系统 - AI名册并行分片加载器实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "ShardedRosterLoader.h"
+#include "DatabaseManager.h"
+#include <QtCore/QDebug>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <algorithm>
+
+/**
+ * @brief 构造函数
+ */
+ShardedRosterLoader::ShardedRosterLoader(DatabaseManager* databaseManager, QObject* parent)
+    : QObject(parent)
+    , m_databaseManager(databaseManager)
+    , m_totalRows(0)
+    , m_failedShards(0)
+    , m_pendingShards(0)
+    , m_targetShardRows(DEFAULT_TARGET_SHARD_ROWS)
+    , m_maxRetries(DEFAULT_MAX_RETRIES)
+    , m_retryBackoffMs(DEFAULT_RETRY_BACKOFF_MS)
+    , m_cancelled(false)
+{
+    m_threadPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+/**
+ * @brief 析构函数
+ */
+ShardedRosterLoader::~ShardedRosterLoader()
+{
+    m_cancelled = true;
+    m_threadPool.waitForDone();
+}
+
+/**
+ * @brief 设置最大并行分片数
+ */
+void ShardedRosterLoader::setMaxParallelShards(int count)
+{
+    m_threadPool.setMaxThreadCount(qMax(1, count));
+}
+
+/**
+ * @brief 设置每个分片的目标行数
+ */
+void ShardedRosterLoader::setTargetShardRows(int rows)
+{
+    m_targetShardRows = qMax(1, rows);
+}
+
+/**
+ * @brief 设置失败分片的重试策略
+ */
+void ShardedRosterLoader::setRetryPolicy(int maxRetries, int backoffMs)
+{
+    m_maxRetries = qMax(0, maxRetries);
+    m_retryBackoffMs = qMax(0, backoffMs);
+}
+
+/**
+ * @brief 开始异步加载
+ */
+bool ShardedRosterLoader::start(const RowSink& sink)
+{
+    if (isLoading()) {
+        return false;
+    }
+
+    m_sink = sink;
+    m_timer.start();
+
+    QVector<Shard> shards = planShards();
+    if (shards.isEmpty()) {
+        qDebug() << "ShardedRosterLoader: 数据库中没有AI名册";
+        emit loadFinished(0, 0, m_timer.elapsed());
+        return false;
+    }
+
+    m_pendingShards.store(shards.size());
+
+    qDebug() << "ShardedRosterLoader: 开始并行加载，服务器数:" << m_progress.size()
+             << "分片数:" << shards.size() << "并行度:" << m_threadPool.maxThreadCount();
+
+    // 行数多的服务器先提交，缩短整体完成时间
+    for (const Shard& shard : shards) {
+        m_threadPool.start([this, shard]() { loadShard(shard); });
+    }
+    return true;
+}
+
+/**
+ * @brief 等待加载完成
+ */
+bool ShardedRosterLoader::waitForFinished(int msecs)
+{
+    return m_threadPool.waitForDone(msecs);
+}
+
+/**
+ * @brief 检查服务器是否已加载完成
+ */
+bool ShardedRosterLoader::isServerReady(int serverId) const
+{
+    QMutexLocker locker(&m_progressMutex);
+    return m_progress.value(serverId).ready;
+}
+
+/**
+ * @brief 规划分片
+ */
+QVector<ShardedRosterLoader::Shard> ShardedRosterLoader::planShards()
+{
+    QMap<int, int> counts = countRowsByServer();
+
+    // 按行数从大到小排序
+    QVector<QPair<int, int>> servers;
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        if (it.value() > 0) {
+            servers.append(qMakePair(it.key(), it.value()));
+        }
+    }
+    std::sort(servers.begin(), servers.end(), [](const QPair<int, int>& a, const QPair<int, int>& b) {
+        return a.second > b.second;
+    });
+
+    QVector<Shard> shards;
+    QMutexLocker locker(&m_progressMutex);
+    m_progress.clear();
+    m_totalRows = 0;
+    m_failedShards = 0;
+
+    for (const auto& server : servers) {
+        int parts = qBound(1, (server.second + m_targetShardRows - 1) / m_targetShardRows,
+                           MAX_PARTS_PER_SERVER);
+
+        // 边界查询失败时整个服务器作为一个分片
+        QStringList bounds = parts > 1
+            ? keyBoundaries(server.first, parts)
+            : QStringList();
+        if (bounds.size() < 2) {
+            bounds.clear();
+        }
+
+        int partCount = qMax(1, bounds.size());
+        for (int part = 0; part < partCount; ++part) {
+            Shard shard;
+            shard.serverId = server.first;
+            shard.part = part;
+            // 首个分片不设下界、末个分片不设上界，加载期间新插入的AI也不会遗漏
+            shard.fromAiId = part > 0 ? bounds.at(part) : QString();
+            shard.toAiId = part + 1 < bounds.size() ? bounds.at(part + 1) : QString();
+            shards << shard;
+        }
+
+        m_progress[server.first].pendingParts = partCount;
+    }
+
+    return shards;
+}
+
+/**
+ * @brief 按服务器统计AI数量
+ */
+QMap<int, int> ShardedRosterLoader::countRowsByServer()
+{
+    return m_databaseManager ? m_databaseManager->getAiCountByServer() : QMap<int, int>();
+}
+
+/**
+ * @brief 将服务器内的AI按ai_id切分为区间
+ */
+QStringList ShardedRosterLoader::keyBoundaries(int serverId, int parts)
+{
+    return m_databaseManager ? m_databaseManager->getAiKeyBoundaries(serverId, parts) : QStringList();
+}
+
+/**
+ * @brief 扫描一个分片
+ */
+int ShardedRosterLoader::scanShard(int serverId, const QString& fromAiId, const QString& toAiId,
+                                   const RowSink& sink)
+{
+    return m_databaseManager ? m_databaseManager->scanAiShard(serverId, fromAiId, toAiId, sink) : -1;
+}
+
+/**
+ * @brief 加载单个分片
+ */
+void ShardedRosterLoader::loadShard(const Shard& shard)
+{
+    // 失败的扫描可能已送出部分行，重试时跳过这些AI，行回调不会收到重复行
+    QSet<QString> delivered;
+    const RowSink sink = [this, &delivered](const QString& aiId, const AIPlayerData& playerData) {
+        if (!delivered.contains(aiId)) {
+            delivered.insert(aiId);
+            m_sink(aiId, playerData);
+        }
+    };
+
+    int rows = scanShard(shard.serverId, shard.fromAiId, shard.toAiId, sink);
+    for (int attempt = 1; rows < 0 && attempt <= m_maxRetries && !m_cancelled; ++attempt) {
+        const int delay = m_retryBackoffMs << (attempt - 1);
+        qWarning() << "ShardedRosterLoader: 分片加载失败，服务器:" << shard.serverId
+                   << "分片:" << shard.part << delay << "ms后第" << attempt << "次重试";
+        QThread::msleep(static_cast<unsigned long>(delay));
+        rows = scanShard(shard.serverId, shard.fromAiId, shard.toAiId, sink);
+    }
+    if (rows >= 0) {
+        rows = delivered.size();
+    }
+
+    bool serverDone = false;
+    int failedParts = 0;
+    int serverRows = 0;
+    {
+        QMutexLocker locker(&m_progressMutex);
+        ServerProgress& progress = m_progress[shard.serverId];
+        if (rows >= 0) {
+            progress.rows += rows;
+            m_totalRows += rows;
+        } else {
+            ++progress.failedParts;
+            ++m_failedShards;
+        }
+
+        // 只有全部分片都成功时服务器才算就绪
+        if (--progress.pendingParts == 0) {
+            progress.ready = progress.failedParts == 0;
+            serverDone = true;
+            failedParts = progress.failedParts;
+            serverRows = progress.rows;
+        }
+    }
+
+    emit shardLoaded(shard.serverId, shard.part, rows);
+
+    if (rows < 0) {
+        qCritical() << "ShardedRosterLoader: 分片重试后仍失败，服务器:" << shard.serverId
+                    << "分片:" << shard.part;
+    }
+
+    if (serverDone && failedParts == 0) {
+        qDebug() << "ShardedRosterLoader: 服务器" << shard.serverId << "名册就绪，AI数:" << serverRows;
+        emit serverReady(shard.serverId, serverRows);
+    } else if (serverDone) {
+        qCritical() << "ShardedRosterLoader: 服务器" << shard.serverId << "有" << failedParts
+                    << "个分片加载失败，名册未就绪";
+        emit serverFailed(shard.serverId, failedParts);
+    }
+
+    if (m_pendingShards.fetch_sub(1) == 1) {
+        int totalRows;
+        int failedShards;
+        {
+            QMutexLocker locker(&m_progressMutex);
+            totalRows = m_totalRows;
+            failedShards = m_failedShards;
+        }
+
+        qDebug() << "ShardedRosterLoader: 名册加载完成，AI数:" << totalRows
+                 << "耗时:" << m_timer.elapsed() << "ms";
+        emit loadFinished(totalRows, failedShards, m_timer.elapsed());
+    }
+}
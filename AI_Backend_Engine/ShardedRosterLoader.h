@@ -0,0 +1,216 @@
+/**
+ * @file ShardedRosterLoader.h
+ * @brief RANOnline EP7 AI系统 - AI名册并行分片加载器头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 按server_id拆分名册，大服务器再按ai_id区间等分
+ * - 多个分片在不同池连接上并行流式读取
+ * - 失败分片按指数退避重试，重试时不重复送出已读取的行
+ * - 每个服务器的全部分片成功后立即发布就绪信号
+ * - 已就绪服务器上的AI无需等待整个名册加载完成即可开始运行
+ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <atomic>
+#include <functional>
+
+class DatabaseManager;
+struct AIPlayerData;
+
+/**
+ * @class ShardedRosterLoader
+ * @brief AI名册并行分片加载器
+ *
+ * 行回调在工作线程上执行，接收方须自行保证线程安全；
+ * shardLoaded/serverReady/serverFailed/loadFinished信号可跨线程连接。
+ * 有分片重试后仍失败的服务器不会发布serverReady，改为发布serverFailed。
+ */
+class ShardedRosterLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 行回调：AI ID + 数据
+     */
+    using RowSink = std::function<void(const QString&, const AIPlayerData&)>;
+
+    /**
+     * @brief 构造函数
+     * @param databaseManager 数据库管理器（生命周期须长于加载器）
+     * @param parent 父对象
+     */
+    explicit ShardedRosterLoader(DatabaseManager* databaseManager, QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数，等待未完成的分片
+     */
+    ~ShardedRosterLoader();
+
+    /**
+     * @brief 设置最大并行分片数（不应超过连接池大小）
+     * @param count 并行数
+     */
+    void setMaxParallelShards(int count);
+
+    /**
+     * @brief 设置每个分片的目标行数
+     * @param rows 行数
+     */
+    void setTargetShardRows(int rows);
+
+    /**
+     * @brief 设置失败分片的重试策略
+     * @param maxRetries 最大重试次数
+     * @param backoffMs 首次重试等待（毫秒），之后每次翻倍
+     */
+    void setRetryPolicy(int maxRetries, int backoffMs);
+
+    /**
+     * @brief 开始异步加载
+     * @param sink 行回调
+     * @return 是否成功开始（已在加载中或无数据时返回false）
+     */
+    bool start(const RowSink& sink);
+
+    /**
+     * @brief 等待加载完成
+     * @param msecs 超时（毫秒），-1为一直等待
+     * @return 是否全部完成
+     */
+    bool waitForFinished(int msecs = -1);
+
+    /**
+     * @brief 检查服务器是否已加载完成
+     * @param serverId 服务器ID
+     * @return 是否就绪
+     */
+    bool isServerReady(int serverId) const;
+
+    /**
+     * @brief 检查是否正在加载
+     * @return 是否加载中
+     */
+    bool isLoading() const { return m_pendingShards.load() > 0; }
+
+signals:
+    /**
+     * @brief 单个分片加载完成
+     * @param serverId 服务器ID
+     * @param part 分片序号
+     * @param rows 读取行数，失败为-1
+     */
+    void shardLoaded(int serverId, int part, int rows);
+
+    /**
+     * @brief 服务器全部分片加载完成
+     * @param serverId 服务器ID
+     * @param rows 该服务器读取的总行数
+     */
+    void serverReady(int serverId, int rows);
+
+    /**
+     * @brief 服务器有分片重试后仍失败，不会就绪
+     * @param serverId 服务器ID
+     * @param failedParts 失败的分片数
+     */
+    void serverFailed(int serverId, int failedParts);
+
+    /**
+     * @brief 整个名册加载完成
+     * @param rows 总行数
+     * @param failedShards 失败的分片数
+     * @param elapsedMs 耗时（毫秒）
+     */
+    void loadFinished(int rows, int failedShards, qint64 elapsedMs);
+
+private:
+    /**
+     * @struct Shard
+     * @brief 分片描述
+     */
+    struct Shard {
+        int serverId = 0;           ///< 服务器ID
+        int part = 0;               ///< 分片序号
+        QString fromAiId;           ///< 区间下界（含），为空不设限
+        QString toAiId;             ///< 区间上界（不含），为空不设限
+    };
+
+    /**
+     * @struct ServerProgress
+     * @brief 单个服务器的加载进度
+     */
+    struct ServerProgress {
+        int pendingParts = 0;       ///< 未完成分片数
+        int failedParts = 0;        ///< 失败分片数
+        int rows = 0;               ///< 已读取行数
+        bool ready = false;         ///< 是否就绪
+    };
+
+protected:
+    /**
+     * @brief 按服务器统计AI数量
+     * @return 服务器ID -> AI数量
+     */
+    virtual QMap<int, int> countRowsByServer();
+
+    /**
+     * @brief 将服务器内的AI按ai_id切分为区间
+     * @return 各区间下界（升序）
+     */
+    virtual QStringList keyBoundaries(int serverId, int parts);
+
+    /**
+     * @brief 扫描一个分片
+     * @return 读取的行数，失败返回-1
+     */
+    virtual int scanShard(int serverId, const QString& fromAiId, const QString& toAiId, const RowSink& sink);
+
+private:
+    /**
+     * @brief 规划分片
+     * @return 分片列表
+     */
+    QVector<Shard> planShards();
+
+    /**
+     * @brief 加载单个分片（工作线程）
+     * @param shard 分片
+     */
+    void loadShard(const Shard& shard);
+
+private:
+    DatabaseManager* m_databaseManager;             ///< 数据库管理器
+    QThreadPool m_threadPool;                       ///< 分片工作线程
+    RowSink m_sink;                                 ///< 行回调
+
+    mutable QMutex m_progressMutex;                 ///< 进度互斥锁
+    QHash<int, ServerProgress> m_progress;          ///< 服务器ID -> 进度
+    int m_totalRows;                                ///< 总行数
+    int m_failedShards;                             ///< 失败分片数
+    std::atomic<int> m_pendingShards;               ///< 未完成分片数
+    QElapsedTimer m_timer;                          ///< 加载计时
+
+    int m_targetShardRows;                          ///< 每个分片目标行数
+    int m_maxRetries;                               ///< 失败分片最大重试次数
+    int m_retryBackoffMs;                           ///< 首次重试等待（毫秒）
+    std::atomic<bool> m_cancelled;                  ///< 析构中，停止重试
+
+    static constexpr int DEFAULT_TARGET_SHARD_ROWS = 5000;  ///< 默认每分片行数
+    static constexpr int MAX_PARTS_PER_SERVER = 16;         ///< 单服务器最大分片数
+    static constexpr int DEFAULT_MAX_RETRIES = 3;           ///< 默认重试次数
+    static constexpr int DEFAULT_RETRY_BACKOFF_MS = 200;    ///< 默认首次重试等待（毫秒）
+};
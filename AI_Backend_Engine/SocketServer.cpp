@@ -0,0 +1,326 @@
+/**
+ * @file SocketServer.cpp
+ * @brief RANOnline EP7 AI系统 - 后端通信服务实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "SocketServer.h"
+#include "SharedMemoryChannel.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <iostream>
+
+#ifdef __linux__
+#include "EpollSocketServer.h"
+#endif
+
+/**
+ * @brief 从communication段解析配置
+ */
+SocketServer::Config SocketServer::Config::fromJson(const QJsonObject& communication)
+{
+    Config config;
+
+    const QJsonObject backend = communication.value("backend").toObject();
+    config.port = static_cast<uint16_t>(backend.value("port").toInt(config.port));
+    config.eventLoops = backend.value("eventLoops").toInt(config.eventLoops);
+    config.workerThreads = backend.value("workerThreads").toInt(config.workerThreads);
+
+    const QJsonObject messages = communication.value("messages").toObject();
+    config.maxMessageSize = static_cast<size_t>(
+        messages.value("maxMessageSize").toDouble(static_cast<double>(config.maxMessageSize)));
+
+    const QJsonObject sharedMemory = communication.value("sharedMemory").toObject();
+    config.sharedMemoryEnabled = sharedMemory.value("enabled").toBool(config.sharedMemoryEnabled);
+    config.sharedMemoryName = sharedMemory.value("name")
+        .toString(QString::fromStdString(config.sharedMemoryName)).toStdString();
+    config.sharedMemoryRingCapacity = static_cast<size_t>(
+        sharedMemory.value("ringCapacity").toDouble(static_cast<double>(config.sharedMemoryRingCapacity)));
+
+    return config;
+}
+
+/**
+ * @brief 从配置文件加载
+ */
+bool SocketServer::Config::loadFromFile(const std::string& configPath, Config& config)
+{
+    QFile file(QString::fromStdString(configPath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        return false;
+    }
+
+    config = fromJson(document.object().value("communication").toObject());
+    return true;
+}
+
+/**
+ * @brief 构造函数
+ */
+SocketServer::SocketServer()
+    : m_initialized(false)
+    , m_sharedMemoryReading(false)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+SocketServer::~SocketServer()
+{
+    stop();
+}
+
+/**
+ * @brief 初始化服务配置
+ */
+bool SocketServer::initialize(const Config& config)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    m_config = config;
+    m_initialized = true;
+    return true;
+}
+
+/**
+ * @brief 启动服务
+ */
+bool SocketServer::start()
+{
+    if (!m_initialized) {
+        return false;
+    }
+    if (isRunning()) {
+        return true;
+    }
+
+#ifdef __linux__
+    EpollSocketServer::Config serverConfig;
+    serverConfig.eventLoopCount = m_config.eventLoops;
+    serverConfig.workerCount = m_config.workerThreads;
+    serverConfig.maxFrameSize = m_config.maxMessageSize;
+
+    m_tcpServer = std::make_unique<EpollSocketServer>(serverConfig);
+    m_tcpServer->setConnectionMessageCallback([this](uint64_t connectionId, std::unique_ptr<Message> message) {
+        onMessage(connectionId, std::move(message));
+    });
+    if (!m_tcpServer->startServer(m_config.port)) {
+        m_tcpServer.reset();
+        return false;
+    }
+
+    // 共享内存通道是附加传输，创建失败时前端仍可走TCP
+    if (m_config.sharedMemoryEnabled && !startSharedMemory()) {
+        std::cerr << "SocketServer: 共享内存通道创建失败，仅提供TCP服务" << std::endl;
+    }
+    return true;
+#else
+    std::cerr << "SocketServer: 当前平台暂不支持后端Socket服务" << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * @brief 停止服务
+ */
+void SocketServer::stop()
+{
+    // 先停TCP工作线程，之后不会再有线程向共享内存通道写入
+#ifdef __linux__
+    if (m_tcpServer) {
+        m_tcpServer->stop();
+        m_tcpServer.reset();
+    }
+#endif
+
+    stopSharedMemory();
+}
+
+/**
+ * @brief 检查服务是否运行中
+ */
+bool SocketServer::isRunning() const
+{
+#ifdef __linux__
+    return m_tcpServer && m_tcpServer->isRunning();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取实际监听端口
+ */
+uint16_t SocketServer::getPort() const
+{
+#ifdef __linux__
+    if (m_tcpServer) {
+        return m_tcpServer->getPort();
+    }
+#endif
+    return m_config.port;
+}
+
+/**
+ * @brief 广播消息到所有连接
+ */
+bool SocketServer::sendMessage(const Message& message)
+{
+    bool sent = sendSharedMemory(message);
+#ifdef __linux__
+    if (m_tcpServer && m_tcpServer->sendMessage(message)) {
+        sent = true;
+    }
+#endif
+    return sent;
+}
+
+/**
+ * @brief 发送消息到指定连接
+ */
+bool SocketServer::sendMessage(uint64_t connectionId, const Message& message)
+{
+    if (connectionId == SHARED_MEMORY_CONNECTION_ID) {
+        return sendSharedMemory(message);
+    }
+
+#ifdef __linux__
+    return m_tcpServer && m_tcpServer->sendMessage(connectionId, message);
+#else
+    (void)connectionId;
+    (void)message;
+    return false;
+#endif
+}
+
+/**
+ * @brief 设置消息处理器
+ */
+void SocketServer::setMessageHandler(std::function<void(uint64_t, std::unique_ptr<Message>)> handler)
+{
+    m_handler = std::move(handler);
+}
+
+/**
+ * @brief 获取统计信息
+ */
+std::unordered_map<std::string, uint64_t> SocketServer::getStatistics() const
+{
+    std::unordered_map<std::string, uint64_t> stats = {
+        {"messagesSent", 0},
+        {"messagesReceived", 0},
+        {"activeConnections", 0}
+    };
+#ifdef __linux__
+    if (m_tcpServer) {
+        stats = m_tcpServer->getStatistics();
+    }
+#endif
+    std::lock_guard<std::mutex> lock(m_sharedMemoryWriteMutex);
+    stats["sharedMemoryAttached"] = m_sharedMemory && m_sharedMemory->isPeerAttached() ? 1 : 0;
+    return stats;
+}
+
+/**
+ * @brief 处理收到的消息
+ */
+void SocketServer::onMessage(uint64_t connectionId, std::unique_ptr<Message> message)
+{
+    // 心跳在通信层直接应答，原样带回负载
+    if (message->getType() == MessageType::SYSTEM_PING) {
+        Message pong(MessageType::SYSTEM_PONG);
+        pong.setSequence(message->getSequence());
+        pong.setData(message->getData());
+        sendMessage(connectionId, pong);
+        return;
+    }
+
+    if (m_handler) {
+        m_handler(connectionId, std::move(message));
+    }
+}
+
+/**
+ * @brief 创建共享内存通道并启动读取线程
+ */
+bool SocketServer::startSharedMemory()
+{
+    auto channel = std::make_unique<SharedMemoryChannel>();
+    if (!channel->create(m_config.sharedMemoryName, m_config.sharedMemoryRingCapacity)) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sharedMemoryWriteMutex);
+        m_sharedMemory = std::move(channel);
+    }
+    m_sharedMemoryReading = true;
+
+    // 记录内容与TCP帧相同，解码后走同一处理路径
+    m_sharedMemoryReader = std::thread([this]() {
+        std::vector<uint8_t> record;
+        while (m_sharedMemoryReading) {
+            if (!m_sharedMemory->read(record, SHARED_MEMORY_POLL_TIMEOUT)) {
+                continue;
+            }
+            if (record.size() > MessageHeader::SIZE + m_config.maxMessageSize) {
+                std::cerr << "SocketServer: 共享内存记录超过最大消息长度，已丢弃" << std::endl;
+                continue;
+            }
+            auto message = std::make_unique<Message>(MessageType::SYSTEM_PING);
+            if (!message->deserialize(record)) {
+                std::cerr << "SocketServer: 共享内存记录解析失败，已丢弃" << std::endl;
+                continue;
+            }
+            onMessage(SHARED_MEMORY_CONNECTION_ID, std::move(message));
+        }
+    });
+
+    std::cout << "SocketServer: 共享内存通道 " << m_config.sharedMemoryName << " 已创建" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 停止读取线程并删除共享内存通道
+ */
+void SocketServer::stopSharedMemory()
+{
+    if (!m_sharedMemory) {
+        return;
+    }
+
+    m_sharedMemoryReading = false;
+    m_sharedMemory->interruptRead();
+    if (m_sharedMemoryReader.joinable()) {
+        m_sharedMemoryReader.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_sharedMemoryWriteMutex);
+    m_sharedMemory->close();
+    m_sharedMemory.reset();
+}
+
+/**
+ * @brief 写入一帧到共享内存下行环
+ */
+bool SocketServer::sendSharedMemory(const Message& message)
+{
+    std::vector<uint8_t> frame = message.serialize();
+
+    // 前端未映射通道时不写入，避免下行环被无人读取的广播填满
+    std::lock_guard<std::mutex> lock(m_sharedMemoryWriteMutex);
+    return m_sharedMemory && m_sharedMemory->isPeerAttached() &&
+           m_sharedMemory->write(frame.data(), frame.size());
+}
@@ -0,0 +1,184 @@
+/**
+ * @file SocketServer.h
+ * @brief RANOnline EP7 AI系统 - 后端通信服务头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 从app_config.json的communication.backend段读取端口与线程配置
+ * - Linux下使用EpollSocketServer承载前端与游戏服务器连接
+ * - 按communication.sharedMemory段创建共享内存通道，供同主机前端直连
+ * - 心跳请求在通信层直接应答，其余消息交给上层处理器
+ */
+
+#pragma once
+
+#include "Protocol.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+class QJsonObject;
+class EpollSocketServer;
+class SharedMemoryChannel;
+
+/**
+ * @class SocketServer
+ * @brief AI后端通信服务
+ *
+ * 对main.cpp暴露initialize/start/stop的生命周期接口，
+ * 内部按平台选择具体的服务器实现。
+ */
+class SocketServer {
+public:
+    /**
+     * @struct Config
+     * @brief 通信配置（对应app_config.json的communication段）
+     */
+    struct Config {
+        uint16_t port = 9902;               ///< backend.port，0表示由系统分配
+        int eventLoops = 0;                 ///< backend.eventLoops，0表示按CPU核心数
+        int workerThreads = 4;              ///< backend.workerThreads
+        size_t maxMessageSize = 1048576;    ///< messages.maxMessageSize
+        bool sharedMemoryEnabled = true;    ///< sharedMemory.enabled
+        std::string sharedMemoryName = "ranonline_ep7_ipc"; ///< sharedMemory.name
+        size_t sharedMemoryRingCapacity = 4194304; ///< sharedMemory.ringCapacity
+
+        /**
+         * @brief 从communication段解析配置，缺失的键保留默认值
+         * @param communication communication段JSON对象
+         * @return 配置
+         */
+        static Config fromJson(const QJsonObject& communication);
+
+        /**
+         * @brief 从配置文件加载
+         * @param configPath app_config.json路径
+         * @param config 输出配置（失败时不修改）
+         * @return 是否成功加载
+         */
+        static bool loadFromFile(const std::string& configPath, Config& config);
+    };
+
+    static constexpr uint64_t SHARED_MEMORY_CONNECTION_ID = ~0ULL; ///< 共享内存对端的连接ID
+
+    /**
+     * @brief 构造函数
+     */
+    SocketServer();
+
+    /**
+     * @brief 析构函数
+     */
+    ~SocketServer();
+
+    SocketServer(const SocketServer&) = delete;
+    SocketServer& operator=(const SocketServer&) = delete;
+
+    /**
+     * @brief 初始化服务配置
+     * @param config 通信配置
+     * @return 是否成功
+     */
+    bool initialize(const Config& config);
+
+    /**
+     * @brief 启动服务
+     * @return 是否成功启动
+     */
+    bool start();
+
+    /**
+     * @brief 停止服务并关闭全部连接
+     */
+    void stop();
+
+    /**
+     * @brief 检查服务是否运行中
+     * @return 运行状态
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 获取实际监听端口
+     * @return 端口号
+     */
+    uint16_t getPort() const;
+
+    /**
+     * @brief 广播消息到所有连接（含共享内存对端）
+     * @param message 消息对象
+     * @return 是否成功加入发送队列
+     */
+    bool sendMessage(const Message& message);
+
+    /**
+     * @brief 发送消息到指定连接
+     * @param connectionId 连接ID，SHARED_MEMORY_CONNECTION_ID表示共享内存对端
+     * @param message 消息对象
+     * @return 是否成功加入发送队列
+     */
+    bool sendMessage(uint64_t connectionId, const Message& message);
+
+    /**
+     * @brief 设置消息处理器（在通信工作线程中调用）
+     * @param handler 处理函数，参数为连接ID和消息
+     */
+    void setMessageHandler(std::function<void(uint64_t, std::unique_ptr<Message>)> handler);
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计数据映射
+     */
+    std::unordered_map<std::string, uint64_t> getStatistics() const;
+
+private:
+    /**
+     * @brief 处理收到的消息
+     * @param connectionId 连接ID
+     * @param message 消息
+     */
+    void onMessage(uint64_t connectionId, std::unique_ptr<Message> message);
+
+    /**
+     * @brief 创建共享内存通道并启动读取线程
+     * @return 是否成功
+     */
+    bool startSharedMemory();
+
+    /**
+     * @brief 停止读取线程并删除共享内存通道
+     */
+    void stopSharedMemory();
+
+    /**
+     * @brief 写入一帧到共享内存下行环
+     * @param message 消息对象
+     * @return 是否写入成功
+     */
+    bool sendSharedMemory(const Message& message);
+
+private:
+    Config m_config;                        ///< 通信配置
+    bool m_initialized;                     ///< 是否已初始化
+
+#ifdef __linux__
+    std::unique_ptr<EpollSocketServer> m_tcpServer; ///< TCP服务器
+#endif
+
+    std::unique_ptr<SharedMemoryChannel> m_sharedMemory; ///< 共享内存通道
+    std::thread m_sharedMemoryReader;       ///< 共享内存读取线程
+    std::atomic<bool> m_sharedMemoryReading; ///< 读取线程运行标志
+    mutable std::mutex m_sharedMemoryWriteMutex; ///< 下行环只允许一个写者，也保护通道的创建与销毁
+
+    std::function<void(uint64_t, std::unique_ptr<Message>)> m_handler; ///< 上层消息处理器（启动前设置）
+
+    static constexpr int SHARED_MEMORY_POLL_TIMEOUT = 200; ///< 共享内存读取等待（毫秒）
+};
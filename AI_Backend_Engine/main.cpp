@@ -25,6 +25,9 @@
 #include "AIEngine.h"
 #include "SocketServer.h"
 #include "DatabaseManager.h"
+#include "ConnectionPool.h"
+#include "GroupCommitPipeline.h"
+#include "OfflineWriteBuffer.h"
 
 // 全局变量
 std::atomic<bool> g_shouldExit(false);
@@ -108,10 +111,11 @@ void showSystemStatus()
     std::cout << "   🔗 活跃连接: " << socketStats["activeConnections"] << std::endl;
     
     // 数据库状态
-    std::cout << "🗄️ 数据库管理器: " << (g_databaseManager->isRunning() ? "✅ 运行中" : "❌ 停止") << std::endl;
-    auto dbStats = g_databaseManager->getConnectionPoolStatus();
-    std::cout << "   🔗 连接池状态: " << dbStats["activeConnections"] << "/" << dbStats["totalConnections"] << std::endl;
-    std::cout << "   📊 待处理操作: " << dbStats["pendingOperations"] << std::endl;
+    std::cout << "🗄️ 数据库管理器: " << (g_databaseManager->isConnected() ? "✅ 已连接" : "❌ 离线") << std::endl;
+    auto poolStats = g_databaseManager->getConnectionPoolStats();
+    std::cout << "   🔗 连接池状态: " << poolStats.inUse << "/" << poolStats.total << std::endl;
+    std::cout << "   📊 待处理操作: " << g_databaseManager->getGroupCommitStats().pending
+              << " (离线缓冲 " << g_databaseManager->getOfflineBufferStats().pending << ")" << std::endl;
     
     // 性能统计
     auto perfStats = g_aiEngine->getPerformanceStats();
@@ -253,7 +257,12 @@ bool initializeSystem()
         // 初始化数据库管理器
         std::cout << "🗄️ 初始化数据库管理器..." << std::endl;
         g_databaseManager = std::make_unique<DatabaseManager>();
-        if (!g_databaseManager->initialize(AIEngineConfig::getDatabaseConnectionString())) {
+        bool databaseConfigLoaded = false;
+        DatabaseConfig databaseConfig = DatabaseConfig::loadFromFile("config/database_config.json", &databaseConfigLoaded);
+        if (!databaseConfigLoaded) {
+            std::cout << "⚠️ 无法加载数据库配置，使用默认配置" << std::endl;
+        }
+        if (!g_databaseManager->initialize(databaseConfig)) {
             std::cout << "❌ 数据库管理器初始化失败" << std::endl;
             return false;
         }
@@ -268,8 +277,12 @@ bool initializeSystem()
         
         // 初始化Socket服务器
         std::cout << "🌐 初始化Socket服务器..." << std::endl;
+        SocketServer::Config socketConfig;
+        if (!SocketServer::Config::loadFromFile("config/app_config.json", socketConfig)) {
+            std::cout << "⚠️ 无法加载通信配置，使用默认端口 " << socketConfig.port << std::endl;
+        }
         g_socketServer = std::make_unique<SocketServer>();
-        if (!g_socketServer->initialize(8080)) {
+        if (!g_socketServer->initialize(socketConfig)) {
             std::cout << "❌ Socket服务器初始化失败" << std::endl;
             return false;
         }
@@ -292,11 +305,7 @@ bool startServices()
     std::cout << "🚀 正在启动系统服务..." << std::endl;
     
     try {
-        // 启动数据库管理器
-        if (!g_databaseManager->start()) {
-            std::cout << "❌ 数据库管理器启动失败" << std::endl;
-            return false;
-        }
+        // 数据库管理器在初始化时已启动同步与心跳
         std::cout << "✅ 数据库管理器已启动" << std::endl;
         
         // 启动AI引擎
@@ -306,6 +315,11 @@ bool startServices()
         }
         std::cout << "✅ AI推理引擎已启动" << std::endl;
         
+        // 并行分片加载AI名册，各服务器就绪后其AI立即开始运行
+        if (g_aiEngine->loadRoster(g_databaseManager.get())) {
+            std::cout << "📥 AI名册分片加载已开始" << std::endl;
+        }
+        
         // 启动Socket服务器
         if (!g_socketServer->start()) {
             std::cout << "❌ Socket服务器启动失败" << std::endl;
@@ -341,7 +355,7 @@ void stopServices()
         }
         
         if (g_databaseManager) {
-            g_databaseManager->stop();
+            g_databaseManager->shutdown();
             std::cout << "✅ 数据库管理器已停止" << std::endl;
         }
         
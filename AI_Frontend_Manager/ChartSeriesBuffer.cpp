@@ -0,0 +1,131 @@
+/**
+ * @file ChartSeriesBuffer.cpp
+ * @brief RANOnline EP7 AI系统 - 图表数据窗口实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "ChartSeriesBuffer.h"
+#include <algorithm>
+
+/**
+ * @brief 构造函数
+ */
+ChartSeriesBuffer::ChartSeriesBuffer(int capacity)
+    : m_points(std::max(1, capacity))
+{
+}
+
+/**
+ * @brief 追加采样点
+ */
+void ChartSeriesBuffer::append(double x, double y)
+{
+    const int cap = m_points.size();
+    if (m_size < cap) {
+        m_points[(m_head + m_size) % cap] = QPointF(x, y);
+        ++m_size;
+    } else {
+        m_points[m_head] = QPointF(x, y);
+        m_head = (m_head + 1) % cap;
+    }
+}
+
+/**
+ * @brief 清空窗口
+ */
+void ChartSeriesBuffer::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+/**
+ * @brief 按时间顺序访问
+ */
+QPointF ChartSeriesBuffer::at(int index) const
+{
+    return m_points[(m_head + index) % m_points.size()];
+}
+
+/**
+ * @brief 最小/最大值抽取
+ */
+QList<QPointF> ChartSeriesBuffer::decimated(double minX, double maxX, int buckets) const
+{
+    QList<QPointF> result;
+    if (m_size == 0 || maxX < minX) {
+        return result;
+    }
+    
+    // X单调不减，二分查找可见范围
+    int first = 0;
+    int count = m_size;
+    while (count > 0) {
+        const int step = count / 2;
+        if (at(first + step).x() < minX) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    int end = first;
+    count = m_size - first;
+    while (count > 0) {
+        const int step = count / 2;
+        if (at(end + step).x() <= maxX) {
+            end += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    
+    const int pointCount = end - first;
+    buckets = std::max(1, buckets);
+    if (pointCount <= 2 * buckets) {
+        result.reserve(pointCount);
+        for (int i = first; i < end; ++i) {
+            result.append(at(i));
+        }
+        return result;
+    }
+    
+    // 每个桶只保留最小点和最大点，按出现顺序输出，峰值不会被抹平
+    result.reserve(2 * buckets);
+    const double scale = maxX > minX ? buckets / (maxX - minX) : 0.0;
+    int currentBucket = -1;
+    int minIndex = first;
+    int maxIndex = first;
+    auto flush = [&]() {
+        if (currentBucket < 0) {
+            return;
+        }
+        result.append(at(std::min(minIndex, maxIndex)));
+        if (minIndex != maxIndex) {
+            result.append(at(std::max(minIndex, maxIndex)));
+        }
+    };
+    
+    for (int i = first; i < end; ++i) {
+        const QPointF point = at(i);
+        const int bucket = std::min(buckets - 1, static_cast<int>((point.x() - minX) * scale));
+        if (bucket != currentBucket) {
+            flush();
+            currentBucket = bucket;
+            minIndex = i;
+            maxIndex = i;
+            continue;
+        }
+        if (point.y() < at(minIndex).y()) {
+            minIndex = i;
+        }
+        if (point.y() > at(maxIndex).y()) {
+            maxIndex = i;
+        }
+    }
+    flush();
+    return result;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file ChartSeriesBuffer.h
+ * @brief RANOnline EP7 AI系统 - 图表数据窗口头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 定长环形窗口，追加不分配内存，运行时间再长内存也不增长
+ * - 按像素宽度做最小/最大值抽取，输出点数与窗口大小无关
+ */
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QVector>
+
+/**
+ * @class ChartSeriesBuffer
+ * @brief 图表数据窗口
+ *
+ * 保存最近capacity()个采样点，X值须单调不减。非线程安全，由GUI线程独占。
+ */
+class ChartSeriesBuffer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 窗口容量(点数)
+     */
+    explicit ChartSeriesBuffer(int capacity);
+
+    /**
+     * @brief 追加采样点，窗口已满时覆盖最旧的点
+     */
+    void append(double x, double y);
+
+    /**
+     * @brief 清空窗口
+     */
+    void clear();
+
+    /**
+     * @brief 按时间顺序访问，0为最旧的点
+     */
+    QPointF at(int index) const;
+
+    int size() const { return m_size; }
+    int capacity() const { return m_points.size(); }
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 最小/最大值抽取
+     * @param minX 可见范围起点
+     * @param maxX 可见范围终点
+     * @param buckets 桶数，通常为绘图区像素宽度
+     * @return 按时间顺序排列的点，每个桶最多输出该桶的最小点和最大点；
+     *         范围内点数不超过2*buckets时原样返回
+     */
+    QList<QPointF> decimated(double minX, double maxX, int buckets) const;
+
+private:
+    QVector<QPointF> m_points;
+    int m_head = 0;     // 最旧点的下标
+    int m_size = 0;
+};
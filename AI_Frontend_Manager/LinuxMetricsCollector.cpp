@@ -0,0 +1,360 @@
+#include "LinuxMetricsCollector.h"
+
+#ifdef Q_OS_LINUX
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+int openReadOnly(const char *path)
+{
+    return ::open(path, O_RDONLY | O_CLOEXEC);
+}
+
+double monotonicSeconds()
+{
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+const char *skipSpaces(const char *p)
+{
+    while (*p == ' ' || *p == '\t') {
+        ++p;
+    }
+    return p;
+}
+
+quint64 parseNumber(const char *&p)
+{
+    p = skipSpaces(p);
+    quint64 value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<quint64>(*p - '0');
+        ++p;
+    }
+    return value;
+}
+
+void skipNumbers(const char *&p, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        // 负数字段 (如tpgid、nice) 只需跳过
+        p = skipSpaces(p);
+        if (*p == '-') {
+            ++p;
+        }
+        parseNumber(p);
+    }
+}
+
+// /proc/<pid>/stat中comm可能含空格和括号，字段从最后一个')'之后开始
+const char *statFields(const char *buffer, char *name, int nameSize)
+{
+    const char *open = std::strchr(buffer, '(');
+    const char *close = std::strrchr(buffer, ')');
+    if (!open || !close || close < open) {
+        return nullptr;
+    }
+    if (name) {
+        const int length = qMin(static_cast<int>(close - open - 1), nameSize - 1);
+        std::memcpy(name, open + 1, length);
+        name[length] = '\0';
+    }
+    return close + 2; // 跳过") "，指向第3个字段 (state)
+}
+
+quint64 meminfoValue(const char *buffer, const char *key)
+{
+    const char *line = std::strstr(buffer, key);
+    if (!line) {
+        return 0;
+    }
+    const char *p = line + std::strlen(key);
+    return parseNumber(p) * 1024; // kB
+}
+
+}
+
+LinuxMetricsCollector::LinuxMetricsCollector(const char *diskPath)
+{
+    m_statFd = openReadOnly("/proc/stat");
+    m_meminfoFd = openReadOnly("/proc/meminfo");
+    m_selfStatFd = openReadOnly("/proc/self/stat");
+    m_netDevFd = openReadOnly("/proc/net/dev");
+    m_diskFd = ::open(diskPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    
+    m_clockTicks = qMax(1L, sysconf(_SC_CLK_TCK));
+    m_pageSize = qMax(1L, sysconf(_SC_PAGESIZE));
+    m_cpuCount = static_cast<int>(qMax(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+}
+
+LinuxMetricsCollector::~LinuxMetricsCollector()
+{
+    for (int fd : { m_statFd, m_meminfoFd, m_selfStatFd, m_netDevFd, m_diskFd }) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    for (int i = 0; i < m_threadSlotsUsed; ++i) {
+        ::close(m_threadSlots[i].fd);
+    }
+}
+
+void LinuxMetricsCollector::sample()
+{
+    const double now = monotonicSeconds();
+    const double elapsedSec = m_hasSample ? now - m_lastSampleSec : 0.0;
+    
+    readSystemCpu();
+    readMemory();
+    readProcess(elapsedSec);
+    readNetwork(elapsedSec);
+    readDisk();
+    readThreads(elapsedSec);
+    
+    m_lastSampleSec = now;
+    m_hasSample = true;
+}
+
+int LinuxMetricsCollector::readFile(int fd, char *buffer, int size)
+{
+    if (fd < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    
+    // proc文件每次从偏移0读取即得到最新内容，无需重新打开
+    const ssize_t length = ::pread(fd, buffer, size - 1, 0);
+    const int used = length > 0 ? static_cast<int>(length) : 0;
+    buffer[used] = '\0';
+    return used;
+}
+
+void LinuxMetricsCollector::readSystemCpu()
+{
+    // 只需第一行: cpu user nice system idle iowait irq softirq steal
+    char buffer[256];
+    if (readFile(m_statFd, buffer, sizeof(buffer)) == 0 || std::strncmp(buffer, "cpu ", 4) != 0) {
+        return;
+    }
+    
+    const char *p = buffer + 4;
+    quint64 fields[8] = {};
+    for (quint64 &field : fields) {
+        field = parseNumber(p);
+    }
+    
+    quint64 total = 0;
+    for (quint64 field : fields) {
+        total += field;
+    }
+    const quint64 idle = fields[3] + fields[4];
+    
+    if (m_hasSample && total > m_lastCpuTotal) {
+        const quint64 totalDiff = total - m_lastCpuTotal;
+        const quint64 idleDiff = idle >= m_lastCpuIdle ? idle - m_lastCpuIdle : 0;
+        m_systemCpuUsage = qBound(0.0, (totalDiff - qMin(idleDiff, totalDiff)) * 100.0 / totalDiff, 100.0);
+    }
+    m_lastCpuTotal = total;
+    m_lastCpuIdle = idle;
+}
+
+void LinuxMetricsCollector::readMemory()
+{
+    // MemTotal和MemAvailable都在前几行
+    char buffer[512];
+    if (readFile(m_meminfoFd, buffer, sizeof(buffer)) == 0) {
+        return;
+    }
+    
+    m_memoryTotal = meminfoValue(buffer, "MemTotal:");
+    m_memoryAvailable = meminfoValue(buffer, "MemAvailable:");
+}
+
+void LinuxMetricsCollector::readProcess(double elapsedSec)
+{
+    char buffer[1024];
+    if (readFile(m_selfStatFd, buffer, sizeof(buffer)) == 0) {
+        return;
+    }
+    
+    const char *p = statFields(buffer, nullptr, 0);
+    if (!p) {
+        return;
+    }
+    
+    // 从state之后：ppid(4) ... utime(14) stime(15) ... num_threads(20) ... rss(24)
+    ++p; // state
+    skipNumbers(p, 10);
+    const quint64 utime = parseNumber(p);
+    const quint64 stime = parseNumber(p);
+    skipNumbers(p, 4);
+    const int threads = static_cast<int>(parseNumber(p));
+    skipNumbers(p, 3);
+    const quint64 rssPages = parseNumber(p);
+    
+    const quint64 ticks = utime + stime;
+    if (elapsedSec > 0.0 && ticks >= m_lastProcessTicks) {
+        const double cpuSec = static_cast<double>(ticks - m_lastProcessTicks) / m_clockTicks;
+        m_processCpuUsage = qBound(0.0, cpuSec / elapsedSec / m_cpuCount * 100.0, 100.0);
+    }
+    m_lastProcessTicks = ticks;
+    m_processRss = rssPages * static_cast<quint64>(m_pageSize);
+    
+    if (threads != m_lastThreadCount) {
+        rescanThreads();
+        m_lastThreadCount = threads;
+    }
+}
+
+void LinuxMetricsCollector::readNetwork(double elapsedSec)
+{
+    if (readFile(m_netDevFd, m_buffer.data(), static_cast<int>(m_buffer.size())) == 0) {
+        return;
+    }
+    
+    // 前两行是表头；每行 "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast tx_bytes ..."
+    quint64 received = 0;
+    quint64 sent = 0;
+    const char *line = m_buffer.data();
+    while (line && *line) {
+        const char *colon = std::strchr(line, ':');
+        const char *end = std::strchr(line, '\n');
+        if (colon && (!end || colon < end)) {
+            const char *name = skipSpaces(line);
+            const bool loopback = colon - name == 2 && std::strncmp(name, "lo", 2) == 0;
+            if (!loopback) {
+                const char *p = colon + 1;
+                received += parseNumber(p);
+                skipNumbers(p, 7);
+                sent += parseNumber(p);
+            }
+        }
+        line = end ? end + 1 : nullptr;
+    }
+    
+    if (!m_hasSample) {
+        m_netReceivedBase = received;
+        m_netSentBase = sent;
+    } else if (elapsedSec > 0.0) {
+        m_netReceiveRate = received >= m_netReceived ? (received - m_netReceived) / elapsedSec : 0.0;
+        m_netSendRate = sent >= m_netSent ? (sent - m_netSent) / elapsedSec : 0.0;
+    }
+    m_netReceived = qMax(received, m_netReceivedBase);
+    m_netSent = qMax(sent, m_netSentBase);
+}
+
+void LinuxMetricsCollector::readDisk()
+{
+    struct statvfs stats{};
+    if (m_diskFd < 0 || fstatvfs(m_diskFd, &stats) != 0 || stats.f_blocks == 0) {
+        return;
+    }
+    
+    // 与df一致：已用 / (已用 + 普通用户可用)
+    const double used = static_cast<double>(stats.f_blocks - stats.f_bfree);
+    const double available = used + static_cast<double>(stats.f_bavail);
+    m_diskUsage = available > 0.0 ? used * 100.0 / available : 0.0;
+}
+
+void LinuxMetricsCollector::readThreads(double elapsedSec)
+{
+    char buffer[512];
+    bool readFailed = false;
+    for (int i = 0; i < m_threadSlotsUsed; ++i) {
+        ThreadSlot &slot = m_threadSlots[i];
+        if (readFile(slot.fd, buffer, sizeof(buffer)) == 0) {
+            readFailed = true;
+            continue;
+        }
+        
+        // 线程名可能在运行中被修改，每次采样都更新
+        const char *p = statFields(buffer, slot.usage.name, sizeof(slot.usage.name));
+        if (!p) {
+            continue;
+        }
+        ++p;
+        skipNumbers(p, 10);
+        const quint64 utime = parseNumber(p);
+        const quint64 stime = parseNumber(p);
+        const quint64 ticks = utime + stime;
+        
+        if (elapsedSec > 0.0 && slot.lastTicks > 0 && ticks >= slot.lastTicks) {
+            const double cpuSec = static_cast<double>(ticks - slot.lastTicks) / m_clockTicks;
+            slot.usage.cpuUsage = qBound(0.0, cpuSec / elapsedSec * 100.0, 100.0);
+        }
+        slot.lastTicks = qMax<quint64>(ticks, 1);
+    }
+    
+    // 线程已退出：线程数可能因新线程补位而不变，仍需重新扫描
+    if (readFailed) {
+        rescanThreads();
+    }
+}
+
+void LinuxMetricsCollector::rescanThreads()
+{
+    // 只在线程数变化或线程退出时执行；opendir会分配内存，不在每次采样路径上
+    DIR *dir = opendir("/proc/self/task");
+    if (!dir) {
+        return;
+    }
+    
+    for (int i = 0; i < m_threadSlotsUsed; ++i) {
+        m_threadSlots[i].seen = false;
+    }
+    
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        const int tid = atoi(entry->d_name);
+        
+        bool known = false;
+        for (int i = 0; i < m_threadSlotsUsed; ++i) {
+            if (m_threadSlots[i].usage.threadId == tid) {
+                m_threadSlots[i].seen = true;
+                known = true;
+                break;
+            }
+        }
+        if (known || m_threadSlotsUsed >= MAX_THREADS) {
+            continue;
+        }
+        
+        char path[64];
+        std::snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+        const int fd = openReadOnly(path);
+        if (fd < 0) {
+            continue;
+        }
+        
+        ThreadSlot &slot = m_threadSlots[m_threadSlotsUsed++];
+        slot = ThreadSlot();
+        slot.fd = fd;
+        slot.seen = true;
+        slot.usage.threadId = tid;
+    }
+    closedir(dir);
+    
+    // 已退出的线程：关闭描述符，用最后一个槽位填补
+    for (int i = 0; i < m_threadSlotsUsed;) {
+        if (m_threadSlots[i].seen) {
+            ++i;
+            continue;
+        }
+        ::close(m_threadSlots[i].fd);
+        m_threadSlots[i] = m_threadSlots[--m_threadSlotsUsed];
+        m_threadSlots[m_threadSlotsUsed] = ThreadSlot();
+    }
+}
+
+#endif // Q_OS_LINUX
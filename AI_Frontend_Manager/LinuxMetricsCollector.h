@@ -0,0 +1,113 @@
+#ifndef LINUXMETRICSCOLLECTOR_H
+#define LINUXMETRICSCOLLECTOR_H
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include <array>
+
+/**
+ * @brief Linux系统指标采集器 - 常驻文件描述符，pread读取，采样不分配内存
+ *
+ * 功能特性:
+ * - /proc/stat: 整机CPU使用率
+ * - /proc/meminfo: 总内存与可用内存
+ * - /proc/self/stat: 进程CPU使用率、常驻内存、线程数
+ * - /proc/self/task/<tid>/stat: 各线程CPU使用率 (线程数变化或线程已退出时才重新扫描)
+ * - /proc/net/dev: 除lo以外所有网卡的收发字节数与速率
+ * - fstatvfs: 磁盘使用率
+ */
+class LinuxMetricsCollector
+{
+public:
+    struct ThreadUsage {
+        int threadId = 0;               // 线程ID (tid)
+        char name[16] = {};             // 线程名 (QThread::setObjectName或pthread_setname_np设置)
+        double cpuUsage = 0.0;          // CPU使用率 (单核百分比)
+    };
+
+    static constexpr int MAX_THREADS = 256;
+
+    explicit LinuxMetricsCollector(const char *diskPath = "/");
+    ~LinuxMetricsCollector();
+
+    LinuxMetricsCollector(const LinuxMetricsCollector &) = delete;
+    LinuxMetricsCollector &operator=(const LinuxMetricsCollector &) = delete;
+
+    // 采样一次，之后的读取返回本次结果；速率和使用率按两次采样之差计算
+    void sample();
+
+    double systemCpuUsage() const { return m_systemCpuUsage; }     // 整机CPU (0-100)
+    double processCpuUsage() const { return m_processCpuUsage; }   // 本进程CPU，按核数归一 (0-100)
+    quint64 memoryTotal() const { return m_memoryTotal; }
+    quint64 memoryUsed() const { return m_memoryTotal - qMin(m_memoryAvailable, m_memoryTotal); }
+    quint64 processResidentMemory() const { return m_processRss; }
+    double diskUsage() const { return m_diskUsage; }
+    quint64 networkBytesReceived() const { return m_netReceived - m_netReceivedBase; } // 采集器创建以来
+    quint64 networkBytesSent() const { return m_netSent - m_netSentBase; }
+    double networkReceiveRate() const { return m_netReceiveRate; } // 字节/秒
+    double networkSendRate() const { return m_netSendRate; }
+
+    int threadCount() const { return m_threadSlotsUsed; }
+    const ThreadUsage &threadUsage(int index) const { return m_threadSlots[index].usage; }
+
+private:
+    struct ThreadSlot {
+        int fd = -1;
+        quint64 lastTicks = 0;
+        bool seen = false;
+        ThreadUsage usage;
+    };
+
+    void readSystemCpu();
+    void readMemory();
+    void readProcess(double elapsedSec);
+    void readNetwork(double elapsedSec);
+    void readDisk();
+    void readThreads(double elapsedSec);
+    void rescanThreads();
+    int readFile(int fd, char *buffer, int size);
+
+    // 常驻文件描述符
+    int m_statFd = -1;
+    int m_meminfoFd = -1;
+    int m_selfStatFd = -1;
+    int m_netDevFd = -1;
+    int m_diskFd = -1;
+
+    // 读取缓冲区 (/proc/net/dev在网卡较多时可能较长)
+    std::array<char, 16384> m_buffer{};
+
+    // 上次采样
+    double m_lastSampleSec = 0.0;
+    bool m_hasSample = false;
+    quint64 m_lastCpuTotal = 0;
+    quint64 m_lastCpuIdle = 0;
+    quint64 m_lastProcessTicks = 0;
+    int m_lastThreadCount = 0;
+    long m_clockTicks = 100;
+    long m_pageSize = 4096;
+    int m_cpuCount = 1;
+
+    // 本次结果
+    double m_systemCpuUsage = 0.0;
+    double m_processCpuUsage = 0.0;
+    quint64 m_memoryTotal = 0;
+    quint64 m_memoryAvailable = 0;
+    quint64 m_processRss = 0;
+    double m_diskUsage = 0.0;
+    quint64 m_netReceived = 0;
+    quint64 m_netSent = 0;
+    quint64 m_netReceivedBase = 0;
+    quint64 m_netSentBase = 0;
+    double m_netReceiveRate = 0.0;
+    double m_netSendRate = 0.0;
+
+    std::array<ThreadSlot, MAX_THREADS> m_threadSlots{};
+    int m_threadSlotsUsed = 0;
+};
+
+#endif // Q_OS_LINUX
+
+#endif // LINUXMETRICSCOLLECTOR_H
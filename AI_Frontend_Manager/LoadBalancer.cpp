@@ -3,25 +3,24 @@
 #include <QMutexLocker>
 #include <QUuid>
 #include <QRandomGenerator>
+#include <QFile>
 #include <QtAlgorithms>
 #include <algorithm>
+#include <cmath>
 
 LoadBalancer::LoadBalancer(QObject *parent)
     : QObject(parent)
-    , m_queueProcessor(new QTimer(this))
     , m_healthCheckTimer(new QTimer(this))
     , m_autoScalingTimer(new QTimer(this))
 {
     // 连接定时器
-    connect(m_queueProcessor, &QTimer::timeout, this, &LoadBalancer::processRequestQueue);
     connect(m_healthCheckTimer, &QTimer::timeout, this, &LoadBalancer::performHealthCheck);
     connect(m_autoScalingTimer, &QTimer::timeout, this, &LoadBalancer::checkAutoScaling);
     
-    // 启动请求队列处理器
-    m_queueProcessor->start(100); // 每100ms处理一次队列
+    // 请求在提交和实例容量变化时立即分派，不再轮询队列
     
-    // 启动自动扩缩容检查
-    m_autoScalingTimer->start(60000); // 每分钟检查一次
+    // 自动扩缩容采样在启用后以亚秒间隔运行
+    m_autoScalingTimer->setInterval(SCALING_SAMPLE_INTERVAL_MS);
     
     m_lastStatsUpdate = QDateTime::currentDateTime();
     
@@ -35,17 +34,21 @@ LoadBalancer::~LoadBalancer()
 
 void LoadBalancer::setAlgorithm(Algorithm algorithm)
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_algorithm != algorithm) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_algorithm == algorithm) {
+            return;
+        }
+        
         m_algorithm = algorithm;
         
         // 重置算法相关状态
         m_roundRobinIndex = 0;
         m_weightedRoundRobinCounters.clear();
-        
-        qDebug() << "⚖️ Load balancing algorithm changed to:" << static_cast<int>(algorithm);
-        emit algorithmChanged(algorithm);
     }
+    
+    qDebug() << "⚖️ Load balancing algorithm changed to:" << static_cast<int>(algorithm);
+    emit algorithmChanged(algorithm);
 }
 
 LoadBalancer::Algorithm LoadBalancer::getCurrentAlgorithm() const
@@ -56,73 +59,99 @@ LoadBalancer::Algorithm LoadBalancer::getCurrentAlgorithm() const
 
 bool LoadBalancer::addAIInstance(const AIInstance &instance)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (m_instances.contains(instance.id)) {
-        qWarning() << "⚖️ AI instance already exists:" << instance.id;
-        return false;
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        if (m_instances.contains(instance.id)) {
+            qWarning() << "⚖️ AI instance already exists:" << instance.id;
+            return false;
+        }
+        
+        AIInstance newInstance = instance;
+        newInstance.createdTime = QDateTime::currentDateTime();
+        newInstance.lastHealthCheck = QDateTime::currentDateTime();
+        
+        m_instances.insert(instance.id, newInstance);
+        refreshDispatchable(instance.id);
+        rebuildHashRing();
+        
+        // 新实例带来容量，排队的请求立即分派
+        dispatchQueuedRequests(assigned);
     }
     
-    AIInstance newInstance = instance;
-    newInstance.createdTime = QDateTime::currentDateTime();
-    newInstance.lastHealthCheck = QDateTime::currentDateTime();
-    
-    m_instances.insert(instance.id, newInstance);
-    
     qDebug() << "⚖️ AI instance added:" << instance.id << instance.name;
     emit instanceAdded(instance.id);
+    emitAssignments(assigned);
     
-    updateStatistics();
+    scheduleStatisticsUpdate();
     return true;
 }
 
 bool LoadBalancer::removeAIInstance(const QString &instanceId)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (!m_instances.contains(instanceId)) {
-        qWarning() << "⚖️ AI instance not found:" << instanceId;
-        return false;
-    }
-    
-    // 检查是否有活跃请求
-    int activeRequests = 0;
-    for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); ++it) {
-        if (it.value().assignedInstanceId == instanceId) {
-            activeRequests++;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        if (!m_instances.contains(instanceId)) {
+            qWarning() << "⚖️ AI instance not found:" << instanceId;
+            return false;
         }
+        
+        // 检查是否有活跃请求
+        int activeRequests = 0;
+        for (auto it = m_activeRequests.cbegin(); it != m_activeRequests.cend(); ++it) {
+            if (it.value().assignedInstanceId == instanceId) {
+                activeRequests++;
+            }
+        }
+        
+        if (activeRequests > 0) {
+            qWarning() << "⚖️ Cannot remove AI instance with active requests:" << instanceId << "(" << activeRequests << "requests)";
+            return false;
+        }
+        
+        m_instances.remove(instanceId);
+        m_weightedRoundRobinCounters.remove(instanceId);
+        refreshDispatchable(instanceId);
+        rebuildHashRing();
     }
     
-    if (activeRequests > 0) {
-        qWarning() << "⚖️ Cannot remove AI instance with active requests:" << instanceId << "(" << activeRequests << "requests)";
-        return false;
-    }
-    
-    m_instances.remove(instanceId);
-    
     qDebug() << "⚖️ AI instance removed:" << instanceId;
     emit instanceRemoved(instanceId);
     
-    updateStatistics();
+    scheduleStatisticsUpdate();
     return true;
 }
 
 bool LoadBalancer::updateAIInstance(const QString &instanceId, const AIInstance &instance)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (!m_instances.contains(instanceId)) {
-        qWarning() << "⚖️ AI instance not found for update:" << instanceId;
-        return false;
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        if (!m_instances.contains(instanceId)) {
+            qWarning() << "⚖️ AI instance not found for update:" << instanceId;
+            return false;
+        }
+        
+        AIInstance &current = m_instances[instanceId];
+        const bool weightChanged = current.weight != instance.weight;
+        
+        AIInstance updatedInstance = instance;
+        updatedInstance.id = instanceId; // 确保ID不变
+        updatedInstance.createdTime = current.createdTime; // 保持创建时间
+        
+        current = updatedInstance;
+        refreshDispatchable(instanceId);
+        if (weightChanged) {
+            rebuildHashRing();
+        }
+        dispatchQueuedRequests(assigned);
     }
     
-    AIInstance updatedInstance = instance;
-    updatedInstance.id = instanceId; // 确保ID不变
-    updatedInstance.createdTime = m_instances[instanceId].createdTime; // 保持创建时间
-    
-    m_instances[instanceId] = updatedInstance;
-    
-    updateStatistics();
+    emitAssignments(assigned);
+    scheduleStatisticsUpdate();
     return true;
 }
 
@@ -142,7 +171,7 @@ QList<LoadBalancer::AIInstance> LoadBalancer::getHealthyAIInstances() const
 {
     QMutexLocker locker(&m_mutex);
     QList<AIInstance> healthy;
-    for (const auto &instance : m_instances.values()) {
+    for (const auto &instance : m_instances) {
         if (instance.isHealthy && instance.isActive) {
             healthy.append(instance);
         }
@@ -152,56 +181,69 @@ QList<LoadBalancer::AIInstance> LoadBalancer::getHealthyAIInstances() const
 
 QString LoadBalancer::submitRequest(const Request &request)
 {
-    QMutexLocker locker(&m_mutex);
-    
     Request newRequest = request;
     if (newRequest.id.isEmpty()) {
         newRequest.id = generateRequestId();
     }
     newRequest.timestamp = QDateTime::currentDateTime();
     
-    // 添加到队列
-    m_requestQueue.enqueue(newRequest);
-    
-    qDebug() << "⚖️ Request submitted:" << newRequest.id << "Type:" << newRequest.type;
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        if (m_queuedRequests.contains(newRequest.id) || m_activeRequests.contains(newRequest.id)) {
+            qWarning() << "⚖️ Duplicate request id:" << newRequest.id;
+            return QString();
+        }
+        
+        m_totalRequests++;
+        m_arrivalsSinceSample++;
+        
+        // 先入队再分派，保持先到先服务
+        enqueueRequest(newRequest);
+        dispatchQueuedRequests(assigned);
+    }
     
-    emit queueSizeChanged(m_requestQueue.size());
-    updateStatistics();
+    emitAssignments(assigned);
+    scheduleStatisticsUpdate();
     
     return newRequest.id;
 }
 
 bool LoadBalancer::cancelRequest(const QString &requestId)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    // 从队列中移除
-    QQueue<Request> newQueue;
-    bool found = false;
-    while (!m_requestQueue.isEmpty()) {
-        Request req = m_requestQueue.dequeue();
-        if (req.id == requestId) {
-            found = true;
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        // 排队中的请求：通过句柄直接删除链表节点
+        auto queued = m_queuedRequests.find(requestId);
+        if (queued != m_queuedRequests.end()) {
+            m_requestQueue.erase(queued.value());
+            m_queuedRequests.erase(queued);
             qDebug() << "⚖️ Request cancelled from queue:" << requestId;
         } else {
-            newQueue.enqueue(req);
+            auto active = m_activeRequests.find(requestId);
+            if (active == m_activeRequests.end()) {
+                return false;
+            }
+            
+            // 已分派的请求：释放其占用的连接，空出的容量分派给排队请求
+            const QString instanceId = active.value().assignedInstanceId;
+            m_activeRequests.erase(active);
+            
+            auto instance = m_instances.find(instanceId);
+            if (instance != m_instances.end()) {
+                setConnections(instance.value(), instance->currentConnections - 1);
+                dispatchQueuedRequests(assigned);
+            }
+            qDebug() << "⚖️ Active request cancelled:" << requestId;
         }
     }
-    m_requestQueue = newQueue;
-    
-    // 从活跃请求中移除
-    if (m_activeRequests.contains(requestId)) {
-        m_activeRequests.remove(requestId);
-        found = true;
-        qDebug() << "⚖️ Active request cancelled:" << requestId;
-    }
     
-    if (found) {
-        emit queueSizeChanged(m_requestQueue.size());
-        updateStatistics();
-    }
-    
-    return found;
+    emitAssignments(assigned);
+    scheduleStatisticsUpdate();
+    return true;
 }
 
 LoadBalancer::Request LoadBalancer::getRequest(const QString &requestId) const
@@ -209,15 +251,15 @@ LoadBalancer::Request LoadBalancer::getRequest(const QString &requestId) const
     QMutexLocker locker(&m_mutex);
     
     // 检查活跃请求
-    if (m_activeRequests.contains(requestId)) {
-        return m_activeRequests[requestId];
+    auto active = m_activeRequests.constFind(requestId);
+    if (active != m_activeRequests.cend()) {
+        return active.value();
     }
     
     // 检查队列中的请求
-    for (const auto &request : m_requestQueue) {
-        if (request.id == requestId) {
-            return request;
-        }
+    auto queued = m_queuedRequests.constFind(requestId);
+    if (queued != m_queuedRequests.cend()) {
+        return *queued.value();
     }
     
     return Request(); // 返回空请求
@@ -227,6 +269,7 @@ QList<LoadBalancer::Request> LoadBalancer::getPendingRequests() const
 {
     QMutexLocker locker(&m_mutex);
     QList<Request> pending;
+    pending.reserve(static_cast<qsizetype>(m_requestQueue.size()));
     for (const auto &request : m_requestQueue) {
         pending.append(request);
     }
@@ -236,7 +279,7 @@ QList<LoadBalancer::Request> LoadBalancer::getPendingRequests() const
 int LoadBalancer::getQueueSize() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_requestQueue.size();
+    return static_cast<int>(m_requestQueue.size());
 }
 
 void LoadBalancer::startHealthCheck(int intervalMs)
@@ -262,292 +305,611 @@ void LoadBalancer::stopHealthCheck()
 
 void LoadBalancer::checkInstanceHealth(const QString &instanceId)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (!m_instances.contains(instanceId)) {
-        return;
-    }
-    
-    AIInstance &instance = m_instances[instanceId];
-    
-    // 简单的健康检查逻辑
-    bool wasHealthy = instance.isHealthy;
-    
-    // 检查响应时间
-    if (instance.averageResponseTime > 5000.0) { // 超过5秒认为不健康
-        instance.isHealthy = false;
-    }
-    
-    // 检查资源使用率
-    if (instance.cpuUsage > 95.0 || instance.memoryUsage > 95.0) {
-        instance.isHealthy = false;
-    }
-    
-    // 检查连接数
-    if (instance.currentConnections >= instance.maxConnections) {
-        instance.isHealthy = false;
-    }
-    
-    // 如果长时间没有更新，认为不健康
-    QDateTime now = QDateTime::currentDateTime();
-    if (instance.lastHealthCheck.secsTo(now) > 300) { // 5分钟没有更新
-        instance.isHealthy = false;
+    bool changed = false;
+    bool isHealthy = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        auto it = m_instances.find(instanceId);
+        if (it == m_instances.end()) {
+            return;
+        }
+        
+        changed = evaluateInstanceHealth(it.value());
+        isHealthy = it->isHealthy;
     }
     
-    instance.lastHealthCheck = now;
-    
-    if (wasHealthy != instance.isHealthy) {
-        qDebug() << "⚖️ Instance health changed:" << instanceId << "Healthy:" << instance.isHealthy;
-        emit instanceHealthChanged(instanceId, instance.isHealthy);
+    if (changed) {
+        qDebug() << "⚖️ Instance health changed:" << instanceId << "Healthy:" << isHealthy;
+        emit instanceHealthChanged(instanceId, isHealthy);
+        scheduleStatisticsUpdate();
     }
 }
 
 void LoadBalancer::enableAutoScaling(bool enabled)
 {
-    QMutexLocker locker(&m_mutex);
-    m_autoScalingEnabled = enabled;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_autoScalingEnabled = enabled;
+        m_scalingController.reset();
+        m_arrivalsSinceSample = 0;
+        m_lastScalingSampleMs = 0;
+    }
+    
+    if (enabled) {
+        m_autoScalingTimer->start();
+    } else {
+        m_autoScalingTimer->stop();
+    }
     qDebug() << "⚖️ Auto-scaling" << (enabled ? "enabled" : "disabled");
 }
 
 void LoadBalancer::setScalingThresholds(double scaleUpThreshold, double scaleDownThreshold)
 {
     QMutexLocker locker(&m_mutex);
-    m_scaleUpThreshold = scaleUpThreshold;
-    m_scaleDownThreshold = scaleDownThreshold;
+    ScalingController::Config config = m_scalingController.config();
+    config.cpuScaleUpThreshold = scaleUpThreshold;
+    config.cpuScaleDownThreshold = scaleDownThreshold;
+    m_scalingController.setConfig(config);
     qDebug() << "⚖️ Scaling thresholds set - Up:" << scaleUpThreshold << "%, Down:" << scaleDownThreshold << "%";
 }
 
 void LoadBalancer::setInstanceLimits(int minInstances, int maxInstances)
 {
     QMutexLocker locker(&m_mutex);
-    m_minInstances = minInstances;
-    m_maxInstances = maxInstances;
+    ScalingController::Config config = m_scalingController.config();
+    config.minInstances = minInstances;
+    config.maxInstances = maxInstances;
+    m_scalingController.setConfig(config);
     qDebug() << "⚖️ Instance limits set - Min:" << minInstances << ", Max:" << maxInstances;
 }
 
-LoadBalancer::Statistics LoadBalancer::getStatistics() const
+void LoadBalancer::setScalingConfig(const ScalingController::Config &config)
 {
     QMutexLocker locker(&m_mutex);
-    return m_statistics;
+    m_scalingController.setConfig(config);
 }
 
-void LoadBalancer::handleRequestSuccess(const QString &requestId, const QString &instanceId, 
-                                      double responseTime, const QByteArray &result)
+ScalingController::Config LoadBalancer::getScalingConfig() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_scalingController.config();
+}
+
+bool LoadBalancer::setScalingTraceFile(const QString &filePath)
 {
     QMutexLocker locker(&m_mutex);
+    m_scalingTrace.reset();
     
-    if (!m_activeRequests.contains(requestId)) {
-        qWarning() << "⚖️ Success callback for unknown request:" << requestId;
-        return;
+    if (filePath.isEmpty()) {
+        return true;
     }
     
-    // 更新实例统计
-    if (m_instances.contains(instanceId)) {
-        AIInstance &instance = m_instances[instanceId];
-        instance.successfulRequests++;
-        instance.totalRequests++;
-        instance.totalResponseTime += responseTime;
-        instance.averageResponseTime = instance.totalResponseTime / instance.totalRequests;
-        instance.currentConnections = qMax(0, instance.currentConnections - 1);
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "⚖️ Cannot open scaling trace file:" << filePath << file->errorString();
+        return false;
+    }
+    if (file->size() == 0) {
+        file->write((ScalingController::traceHeader() + '\n').toUtf8());
     }
     
-    // 移除活跃请求
-    m_activeRequests.remove(requestId);
-    m_successfulRequests++;
-    
-    qDebug() << "⚖️ Request completed successfully:" << requestId << "ResponseTime:" << responseTime << "ms";
-    
-    emit requestCompleted(requestId, result);
-    updateStatistics();
+    m_scalingTrace = std::move(file);
+    return true;
 }
 
-void LoadBalancer::handleRequestFailure(const QString &requestId, const QString &instanceId, 
-                                      const QString &error)
+LoadBalancer::Statistics LoadBalancer::getStatistics() const
 {
     QMutexLocker locker(&m_mutex);
-    
-    if (!m_activeRequests.contains(requestId)) {
-        qWarning() << "⚖️ Failure callback for unknown request:" << requestId;
-        return;
-    }
-    
-    Request &request = m_activeRequests[requestId];
-    
-    // 更新实例统计
-    if (m_instances.contains(instanceId)) {
-        AIInstance &instance = m_instances[instanceId];
-        instance.failedRequests++;
-        instance.totalRequests++;
-        instance.currentConnections = qMax(0, instance.currentConnections - 1);
+    updateStatistics();
+    return m_statistics;
+}
+
+void LoadBalancer::handleRequestSuccess(const QString &requestId, const QString &instanceId,
+                                      double responseTime, const QByteArray &result)
+{
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        auto active = m_activeRequests.find(requestId);
+        if (active == m_activeRequests.end()) {
+            qWarning() << "⚖️ Success callback for unknown request:" << requestId;
+            return;
+        }
+        
+        // 更新实例统计
+        auto it = m_instances.find(instanceId);
+        if (it != m_instances.end()) {
+            AIInstance &instance = it.value();
+            instance.successfulRequests++;
+            instance.totalRequests++;
+            instance.totalResponseTime += responseTime;
+            instance.averageResponseTime = instance.totalResponseTime / instance.totalRequests;
+            instance.ewmaResponseTime = instance.successfulRequests == 1
+                ? responseTime
+                : EWMA_ALPHA * responseTime + (1.0 - EWMA_ALPHA) * instance.ewmaResponseTime;
+            setConnections(instance, instance.currentConnections - 1);
+        }
+        
+        // 近期响应时间供扩缩容采样使用
+        if (m_recentResponseTimes.size() < RESPONSE_TIME_WINDOW) {
+            m_recentResponseTimes.append(responseTime);
+        } else {
+            m_recentResponseTimes[m_responseTimeCursor] = responseTime;
+            m_responseTimeCursor = (m_responseTimeCursor + 1) % RESPONSE_TIME_WINDOW;
+        }
+        m_serviceTimeEwma = m_serviceTimeEwma == 0.0
+            ? responseTime
+            : EWMA_ALPHA * responseTime + (1.0 - EWMA_ALPHA) * m_serviceTimeEwma;
+        
+        // 移除活跃请求
+        m_activeRequests.erase(active);
+        m_successfulRequests++;
+        
+        // 释放的连接立即分派给排队请求
+        dispatchQueuedRequests(assigned);
     }
     
-    // 检查是否需要重试
-    if (request.retryCount < request.maxRetries) {
-        request.retryCount++;
-        request.assignedInstanceId.clear();
+    emit requestCompleted(requestId, result);
+    emitAssignments(assigned);
+    scheduleStatisticsUpdate();
+}
+
+void LoadBalancer::handleRequestFailure(const QString &requestId, const QString &instanceId,
+                                      const QString &error)
+{
+    QList<Assignment> assigned;
+    int retryCount = -1;
+    {
+        QMutexLocker locker(&m_mutex);
         
-        qDebug() << "⚖️ Request failed, retrying:" << requestId << "Retry:" << request.retryCount << "/" << request.maxRetries;
+        auto active = m_activeRequests.find(requestId);
+        if (active == m_activeRequests.end()) {
+            qWarning() << "⚖️ Failure callback for unknown request:" << requestId;
+            return;
+        }
         
-        // 重新加入队列
-        m_requestQueue.enqueue(request);
-        m_activeRequests.remove(requestId);
+        Request request = active.value();
+        m_activeRequests.erase(active);
         
-        emit requestRetrying(requestId, request.retryCount);
-    } else {
-        // 超过最大重试次数，请求失败
-        m_activeRequests.remove(requestId);
-        m_failedRequests++;
+        // 更新实例统计
+        auto it = m_instances.find(instanceId);
+        if (it != m_instances.end()) {
+            AIInstance &instance = it.value();
+            instance.failedRequests++;
+            instance.totalRequests++;
+            setConnections(instance, instance.currentConnections - 1);
+        }
         
-        qDebug() << "⚖️ Request failed permanently:" << requestId << "Error:" << error;
-        emit requestFailed(requestId, error);
+        // 检查是否需要重试
+        if (request.retryCount < request.maxRetries) {
+            request.retryCount++;
+            request.assignedInstanceId.clear();
+            retryCount = request.retryCount;
+            
+            qDebug() << "⚖️ Request failed, retrying:" << requestId << "Retry:" << request.retryCount << "/" << request.maxRetries;
+            
+            // 重新加入队列
+            enqueueRequest(request);
+        } else {
+            // 超过最大重试次数，请求失败
+            m_failedRequests++;
+            qDebug() << "⚖️ Request failed permanently:" << requestId << "Error:" << error;
+        }
+        
+        dispatchQueuedRequests(assigned);
     }
     
-    updateStatistics();
+    if (retryCount >= 0) {
+        emit requestRetrying(requestId, retryCount);
+    } else {
+        emit requestFailed(requestId, error);
+    }
+    emitAssignments(assigned);
+    scheduleStatisticsUpdate();
 }
 
-void LoadBalancer::updateInstanceMetrics(const QString &instanceId, double cpuUsage, 
+void LoadBalancer::updateInstanceMetrics(const QString &instanceId, double cpuUsage,
                                        double memoryUsage, int connections)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (m_instances.contains(instanceId)) {
-        AIInstance &instance = m_instances[instanceId];
+    QList<Assignment> assigned;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        auto it = m_instances.find(instanceId);
+        if (it == m_instances.end()) {
+            return;
+        }
+        
+        AIInstance &instance = it.value();
         instance.cpuUsage = cpuUsage;
         instance.memoryUsage = memoryUsage;
-        instance.currentConnections = connections;
         instance.lastHealthCheck = QDateTime::currentDateTime();
+        
+        // 实例上报的连接数可能空出容量
+        setConnections(instance, connections);
+        dispatchQueuedRequests(assigned);
     }
+    
+    emitAssignments(assigned);
 }
 
 void LoadBalancer::updateInstanceHealth(const QString &instanceId, bool isHealthy)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    if (m_instances.contains(instanceId)) {
-        AIInstance &instance = m_instances[instanceId];
-        bool wasHealthy = instance.isHealthy;
+    QList<Assignment> assigned;
+    bool changed = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        auto it = m_instances.find(instanceId);
+        if (it == m_instances.end()) {
+            return;
+        }
+        
+        AIInstance &instance = it.value();
+        changed = instance.isHealthy != isHealthy;
         instance.isHealthy = isHealthy;
         instance.lastHealthCheck = QDateTime::currentDateTime();
         
-        if (wasHealthy != isHealthy) {
-            qDebug() << "⚖️ Instance health updated:" << instanceId << "Healthy:" << isHealthy;
-            emit instanceHealthChanged(instanceId, isHealthy);
-        }
+        refreshDispatchable(instanceId);
+        dispatchQueuedRequests(assigned);
+    }
+    
+    if (changed) {
+        qDebug() << "⚖️ Instance health updated:" << instanceId << "Healthy:" << isHealthy;
+        emit instanceHealthChanged(instanceId, isHealthy);
+        scheduleStatisticsUpdate();
     }
+    emitAssignments(assigned);
 }
 
-void LoadBalancer::processRequestQueue()
+void LoadBalancer::performHealthCheck()
 {
-    QMutexLocker locker(&m_mutex);
+    QList<QPair<QString, bool>> changes;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        for (auto it = m_instances.begin(); it != m_instances.end(); ++it) {
+            if (evaluateInstanceHealth(it.value())) {
+                changes.append(qMakePair(it.key(), it->isHealthy));
+            }
+        }
+    }
+    
+    for (const auto &change : changes) {
+        qDebug() << "⚖️ Instance health changed:" << change.first << "Healthy:" << change.second;
+        emit instanceHealthChanged(change.first, change.second);
+    }
     
-    // 处理队列中的请求
-    while (!m_requestQueue.isEmpty()) {
-        QList<AIInstance> healthyInstances = getHealthyAIInstances();
-        if (healthyInstances.isEmpty()) {
-            qWarning() << "⚖️ No healthy AI instances available for request processing";
-            break;
-        }
-        
-        QString selectedInstanceId;
-        switch (m_algorithm) {
-        case Algorithm::RoundRobin:
-            selectedInstanceId = selectInstanceRoundRobin();
-            break;
-        case Algorithm::WeightedRoundRobin:
-            selectedInstanceId = selectInstanceWeightedRoundRobin();
-            break;
-        case Algorithm::LeastConnections:
-            selectedInstanceId = selectInstanceLeastConnections();
-            break;
-        case Algorithm::ResponseTime:
-            selectedInstanceId = selectInstanceResponseTime();
-            break;
-        case Algorithm::ResourceBased:
-            selectedInstanceId = selectInstanceResourceBased();
-            break;
+    scheduleStatisticsUpdate();
+}
+
+void LoadBalancer::checkAutoScaling()
+{
+    ScalingController::Decision decision;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        if (!m_autoScalingEnabled) {
+            return;
         }
         
-        if (selectedInstanceId.isEmpty()) {
-            break; // 没有可用实例
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        const double elapsedSec = m_lastScalingSampleMs > 0
+            ? (now - m_lastScalingSampleMs) / 1000.0
+            : SCALING_SAMPLE_INTERVAL_MS / 1000.0;
+        
+        ScalingController::Sample sample;
+        sample.timestampMs = now;
+        sample.instances = m_instances.size();
+        sample.queueDepth = static_cast<int>(m_requestQueue.size());
+        sample.inFlight = m_activeRequests.size();
+        sample.arrivalRate = elapsedSec > 0.0 ? m_arrivalsSinceSample / elapsedSec : 0.0;
+        sample.p95LatencyMs = recentResponseTimePercentile(95.0);
+        sample.serviceTimeMs = m_serviceTimeEwma;
+        
+        // 资源使用率取CPU与内存的较高者
+        double totalUsage = 0.0;
+        int healthyCount = 0;
+        for (const auto &instance : std::as_const(m_instances)) {
+            if (instance.isHealthy && instance.isActive) {
+                totalUsage += qMax(instance.cpuUsage, instance.memoryUsage);
+                healthyCount++;
+            }
         }
+        sample.cpuUsage = healthyCount > 0 ? totalUsage / healthyCount : 0.0;
+        
+        m_arrivalsSinceSample = 0;
+        m_lastScalingSampleMs = now;
         
-        // 分配请求
-        Request request = m_requestQueue.dequeue();
-        assignRequest(request.id, selectedInstanceId);
+        if (m_scalingTrace) {
+            m_scalingTrace->write((ScalingController::toTraceLine(sample) + '\n').toUtf8());
+        }
+        
+        decision = m_scalingController.observe(sample);
+    }
+    
+    if (!decision.isScaling()) {
+        return;
     }
     
-    if (!m_requestQueue.isEmpty()) {
-        emit queueSizeChanged(m_requestQueue.size());
+    // 扩缩容通过公共接口增删实例，需在锁外调用
+    qDebug() << "⚖️ Auto-scaling decision:" << decision.description();
+    const QString reason = ScalingController::reasonName(decision.reason);
+    if (decision.toInstances > decision.fromInstances) {
+        scaleUp(decision.toInstances - decision.fromInstances, reason);
+    } else {
+        scaleDown(reason);
     }
 }
 
-void LoadBalancer::performHealthCheck()
+void LoadBalancer::publishStatistics()
 {
-    QMutexLocker locker(&m_mutex);
+    Statistics stats;
+    int queueSize = 0;
+    bool sizeChanged = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_statisticsScheduled = false;
+        
+        updateStatistics();
+        stats = m_statistics;
+        queueSize = stats.queuedRequests;
+        sizeChanged = queueSize != m_lastPublishedQueueSize;
+        m_lastPublishedQueueSize = queueSize;
+    }
     
-    for (auto it = m_instances.begin(); it != m_instances.end(); ++it) {
-        checkInstanceHealth(it.key());
+    emit statisticsUpdated(stats);
+    if (sizeChanged) {
+        emit queueSizeChanged(queueSize);
     }
+}
+
+QString LoadBalancer::selectInstance(const Request &request)
+{
+    switch (m_algorithm) {
+    case Algorithm::PowerOfTwoChoices:
+        return selectInstancePowerOfTwo();
+    case Algorithm::ConsistentHash:
+        // 没有亲和键的请求不需要固定实例
+        return request.affinityKey.isEmpty() ? selectInstancePowerOfTwo()
+                                             : selectInstanceConsistentHash(request.affinityKey);
+    case Algorithm::RoundRobin:
+        return selectInstanceRoundRobin();
+    case Algorithm::WeightedRoundRobin:
+        return selectInstanceWeightedRoundRobin();
+    case Algorithm::LeastConnections:
+        return selectInstanceLeastConnections();
+    case Algorithm::ResponseTime:
+        return selectInstanceResponseTime();
+    case Algorithm::ResourceBased:
+        return selectInstanceResourceBased();
+    }
+    return QString();
+}
+
+void LoadBalancer::dispatchQueuedRequests(QList<Assignment> &assigned)
+{
+    // 每个请求的分派只涉及队首和可分派集合，与队列长度无关
+    while (!m_requestQueue.empty() && !m_dispatchable.isEmpty()) {
+        QString selectedInstanceId = selectInstance(m_requestQueue.front());
+        if (selectedInstanceId.isEmpty()) {
+            break; // 没有可用实例
+        }
+        
+        Request request = std::move(m_requestQueue.front());
+        m_requestQueue.pop_front();
+        m_queuedRequests.remove(request.id);
+        
+        assignRequest(std::move(request), selectedInstanceId, assigned);
+    }
+}
+
+void LoadBalancer::assignRequest(Request request, const QString &instanceId, QList<Assignment> &assigned)
+{
+    request.assignedInstanceId = instanceId;
+    assigned.append({request.id, instanceId});
+    m_activeRequests.insert(request.id, std::move(request));
     
-    updateStatistics();
+    // 更新实例连接数，满载的实例退出可分派集合
+    auto it = m_instances.find(instanceId);
+    if (it != m_instances.end()) {
+        setConnections(it.value(), it->currentConnections + 1);
+    }
 }
 
-void LoadBalancer::checkAutoScaling()
+void LoadBalancer::enqueueRequest(const Request &request)
 {
-    QMutexLocker locker(&m_mutex);
+    m_requestQueue.push_back(request);
+    m_queuedRequests.insert(request.id, std::prev(m_requestQueue.end()));
+}
+
+void LoadBalancer::refreshDispatchable(const QString &instanceId)
+{
+    auto it = m_instances.constFind(instanceId);
+    const bool eligible = it != m_instances.cend()
+        && it->isActive && it->isHealthy
+        && it->currentConnections < it->maxConnections;
+    
+    // 连接数之和只统计可分派实例，与有界负载上限的平均分母一致
+    auto indexed = m_dispatchableIndex.find(instanceId);
+    if (eligible && indexed == m_dispatchableIndex.end()) {
+        m_dispatchableIndex.insert(instanceId, m_dispatchable.size());
+        m_dispatchable.append(instanceId);
+        m_dispatchableConnections.append(it->currentConnections);
+        m_totalDispatchableConnections += it->currentConnections;
+    } else if (eligible) {
+        int &counted = m_dispatchableConnections[indexed.value()];
+        m_totalDispatchableConnections += it->currentConnections - counted;
+        counted = it->currentConnections;
+    } else if (indexed != m_dispatchableIndex.end()) {
+        // 与末尾元素交换后删除
+        const int index = indexed.value();
+        m_dispatchableIndex.erase(indexed);
+        m_totalDispatchableConnections -= m_dispatchableConnections[index];
+        const QString last = m_dispatchable.takeLast();
+        const int lastConnections = m_dispatchableConnections.takeLast();
+        if (index < m_dispatchable.size()) {
+            m_dispatchable[index] = last;
+            m_dispatchableConnections[index] = lastConnections;
+            m_dispatchableIndex[last] = index;
+        }
+    }
+}
+
+void LoadBalancer::setConnections(AIInstance &instance, int connections)
+{
+    connections = qMax(0, connections);
+    instance.currentConnections = connections;
+    refreshDispatchable(instance.id);
+}
+
+void LoadBalancer::rebuildHashRing()
+{
+    // 虚拟节点位置只取决于实例ID，增删实例时其他实例的节点不动，只有约1/n的键迁移
+    m_hashRing.clear();
+    for (const auto &instance : std::as_const(m_instances)) {
+        const int nodes = VIRTUAL_NODES_PER_WEIGHT * qBound(1, instance.weight, 16);
+        for (int i = 0; i < nodes; ++i) {
+            m_hashRing.emplace_back(hashKey(instance.id + QLatin1Char('#') + QString::number(i)), instance.id);
+        }
+    }
+    std::sort(m_hashRing.begin(), m_hashRing.end());
+}
+
+quint64 LoadBalancer::hashKey(const QString &key)
+{
+    // FNV-1a后接64位混合，跨进程稳定，前端重启后同一AI仍落在同一实例
+    quint64 hash = 1469598103934665603ULL;
+    for (const QChar ch : key) {
+        hash ^= ch.unicode();
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool LoadBalancer::evaluateInstanceHealth(AIInstance &instance)
+{
+    // 简单的健康检查逻辑
+    bool wasHealthy = instance.isHealthy;
     
-    if (!m_autoScalingEnabled) {
-        return;
+    // 检查响应时间
+    if (instance.averageResponseTime > 5000.0) { // 超过5秒认为不健康
+        instance.isHealthy = false;
     }
     
-    // 计算平均资源使用率
-    double avgCpuUsage = 0.0;
-    double avgMemoryUsage = 0.0;
-    int healthyCount = 0;
+    // 检查资源使用率
+    if (instance.cpuUsage > 95.0 || instance.memoryUsage > 95.0) {
+        instance.isHealthy = false;
+    }
     
-    for (const auto &instance : m_instances.values()) {
-        if (instance.isHealthy && instance.isActive) {
-            avgCpuUsage += instance.cpuUsage;
-            avgMemoryUsage += instance.memoryUsage;
-            healthyCount++;
-        }
+    // 连接数满载只是暂不分派 (由可分派集合处理)，不判为不健康
+    
+    // 如果长时间没有更新，认为不健康
+    QDateTime now = QDateTime::currentDateTime();
+    if (instance.lastHealthCheck.secsTo(now) > 300) { // 5分钟没有更新
+        instance.isHealthy = false;
     }
     
-    if (healthyCount == 0) {
-        return;
+    instance.lastHealthCheck = now;
+    refreshDispatchable(instance.id);
+    
+    return wasHealthy != instance.isHealthy;
+}
+
+void LoadBalancer::emitAssignments(const QList<Assignment> &assigned)
+{
+    for (const Assignment &assignment : assigned) {
+        emit requestAssigned(assignment.requestId, assignment.instanceId);
+    }
+}
+
+void LoadBalancer::scheduleStatisticsUpdate()
+{
+    // 同一事件循环周期内的多次变化合并为一次统计计算和信号
+    if (!m_statisticsScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, &LoadBalancer::publishStatistics, Qt::QueuedConnection);
+    }
+}
+
+QString LoadBalancer::selectInstancePowerOfTwo()
+{
+    const int count = m_dispatchable.size();
+    if (count == 0) {
+        return QString();
     }
+    if (count == 1) {
+        return m_dispatchable.first();
+    }
+    
+    // 随机取两个不同实例，选代价低者：O(1)，且不会像最少连接那样让所有请求涌向同一实例
+    auto *random = QRandomGenerator::global();
+    const int first = random->bounded(count);
+    const int second = (first + 1 + random->bounded(count - 1)) % count;
     
-    avgCpuUsage /= healthyCount;
-    avgMemoryUsage /= healthyCount;
+    auto cost = [this](const QString &id) {
+        const AIInstance &instance = m_instances[id];
+        return (instance.ewmaResponseTime + 1.0) * (instance.currentConnections + 1);
+    };
     
-    // 检查是否需要扩容
-    if ((avgCpuUsage > m_scaleUpThreshold || avgMemoryUsage > m_scaleUpThreshold) && canScaleUp()) {
-        scaleUp();
+    const QString &a = m_dispatchable[first];
+    const QString &b = m_dispatchable[second];
+    return cost(a) <= cost(b) ? a : b;
+}
+
+QString LoadBalancer::selectInstanceConsistentHash(const QString &affinityKey)
+{
+    if (m_dispatchable.isEmpty() || m_hashRing.empty()) {
+        return QString();
     }
-    // 检查是否需要缩容
-    else if ((avgCpuUsage < m_scaleDownThreshold && avgMemoryUsage < m_scaleDownThreshold) && canScaleDown()) {
-        scaleDown();
+    
+    // 负载上限：超过平均负载一定比例的实例把键让给环上的下一个实例
+    const int bound = static_cast<int>(std::ceil(HASH_LOAD_FACTOR * (m_totalDispatchableConnections + 1)
+                                                 / m_dispatchable.size()));
+    
+    const quint64 point = hashKey(affinityKey);
+    auto start = std::lower_bound(m_hashRing.begin(), m_hashRing.end(),
+                                  std::make_pair(point, QString()));
+    const size_t begin = static_cast<size_t>(start - m_hashRing.begin());
+    
+    // 顺时针查找第一个可分派且未超限的实例；通常第一个节点即命中
+    QString fallback;
+    for (size_t step = 0; step < m_hashRing.size(); ++step) {
+        const QString &id = m_hashRing[(begin + step) % m_hashRing.size()].second;
+        if (!m_dispatchableIndex.contains(id)) {
+            continue;
+        }
+        if (m_instances[id].currentConnections < bound) {
+            return id;
+        }
+        if (fallback.isEmpty()) {
+            fallback = id;
+        }
     }
+    
+    return fallback;
 }
 
 QString LoadBalancer::selectInstanceRoundRobin()
 {
-    QList<AIInstance> healthy = getHealthyAIInstances();
-    if (healthy.isEmpty()) {
+    if (m_dispatchable.isEmpty()) {
         return QString();
     }
     
-    m_roundRobinIndex = m_roundRobinIndex % healthy.size();
-    QString selectedId = healthy[m_roundRobinIndex].id;
-    m_roundRobinIndex = (m_roundRobinIndex + 1) % healthy.size();
+    m_roundRobinIndex = m_roundRobinIndex % m_dispatchable.size();
+    QString selectedId = m_dispatchable[m_roundRobinIndex];
+    m_roundRobinIndex = (m_roundRobinIndex + 1) % m_dispatchable.size();
     
     return selectedId;
 }
 
 QString LoadBalancer::selectInstanceWeightedRoundRobin()
 {
-    QList<AIInstance> healthy = getHealthyAIInstances();
-    if (healthy.isEmpty()) {
+    if (m_dispatchable.isEmpty()) {
         return QString();
     }
     
@@ -555,12 +917,13 @@ QString LoadBalancer::selectInstanceWeightedRoundRobin()
     QString selectedId;
     int maxWeightCount = 0;
     
-    for (const auto &instance : healthy) {
-        int currentCount = m_weightedRoundRobinCounters.value(instance.id, 0);
+    for (const QString &id : std::as_const(m_dispatchable)) {
+        const AIInstance &instance = m_instances[id];
+        int currentCount = m_weightedRoundRobinCounters.value(id, 0);
         if (currentCount < instance.weight) {
             if (instance.weight - currentCount > maxWeightCount) {
                 maxWeightCount = instance.weight - currentCount;
-                selectedId = instance.id;
+                selectedId = id;
             }
         }
     }
@@ -568,7 +931,7 @@ QString LoadBalancer::selectInstanceWeightedRoundRobin()
     if (selectedId.isEmpty()) {
         // 重置所有计数器
         m_weightedRoundRobinCounters.clear();
-        selectedId = healthy.first().id;
+        selectedId = m_dispatchable.first();
     }
     
     m_weightedRoundRobinCounters[selectedId]++;
@@ -577,18 +940,14 @@ QString LoadBalancer::selectInstanceWeightedRoundRobin()
 
 QString LoadBalancer::selectInstanceLeastConnections()
 {
-    QList<AIInstance> healthy = getHealthyAIInstances();
-    if (healthy.isEmpty()) {
-        return QString();
-    }
-    
     QString selectedId;
     int minConnections = INT_MAX;
     
-    for (const auto &instance : healthy) {
+    for (const QString &id : std::as_const(m_dispatchable)) {
+        const AIInstance &instance = m_instances[id];
         if (instance.currentConnections < minConnections) {
             minConnections = instance.currentConnections;
-            selectedId = instance.id;
+            selectedId = id;
         }
     }
     
@@ -597,18 +956,14 @@ QString LoadBalancer::selectInstanceLeastConnections()
 
 QString LoadBalancer::selectInstanceResponseTime()
 {
-    QList<AIInstance> healthy = getHealthyAIInstances();
-    if (healthy.isEmpty()) {
-        return QString();
-    }
-    
     QString selectedId;
     double minResponseTime = DBL_MAX;
     
-    for (const auto &instance : healthy) {
+    for (const QString &id : std::as_const(m_dispatchable)) {
+        const AIInstance &instance = m_instances[id];
         if (instance.averageResponseTime < minResponseTime) {
             minResponseTime = instance.averageResponseTime;
-            selectedId = instance.id;
+            selectedId = id;
         }
     }
     
@@ -617,19 +972,15 @@ QString LoadBalancer::selectInstanceResponseTime()
 
 QString LoadBalancer::selectInstanceResourceBased()
 {
-    QList<AIInstance> healthy = getHealthyAIInstances();
-    if (healthy.isEmpty()) {
-        return QString();
-    }
-    
     QString selectedId;
     double minResourceUsage = DBL_MAX;
     
-    for (const auto &instance : healthy) {
+    for (const QString &id : std::as_const(m_dispatchable)) {
+        const AIInstance &instance = m_instances[id];
         double resourceUsage = (instance.cpuUsage + instance.memoryUsage) / 2.0;
         if (resourceUsage < minResourceUsage) {
             minResourceUsage = resourceUsage;
-            selectedId = instance.id;
+            selectedId = id;
         }
     }
     
@@ -646,50 +997,24 @@ QString LoadBalancer::generateInstanceId() const
     return "AI_" + QUuid::createUuid().toString(QUuid::WithoutBraces).toUpper();
 }
 
-void LoadBalancer::assignRequest(const QString &requestId, const QString &instanceId)
-{
-    if (!m_activeRequests.contains(requestId)) {
-        qWarning() << "⚖️ Trying to assign unknown request:" << requestId;
-        return;
-    }
-    
-    Request &request = m_activeRequests[requestId];
-    request.assignedInstanceId = instanceId;
-    
-    // 更新实例连接数
-    if (m_instances.contains(instanceId)) {
-        m_instances[instanceId].currentConnections++;
-    }
-    
-    qDebug() << "⚖️ Request assigned:" << requestId << "to instance:" << instanceId;
-    emit requestAssigned(requestId, instanceId);
-}
-
-void LoadBalancer::retryRequest(const QString &requestId)
-{
-    if (m_activeRequests.contains(requestId)) {
-        Request request = m_activeRequests[requestId];
-        request.assignedInstanceId.clear();
-        m_activeRequests.remove(requestId);
-        m_requestQueue.enqueue(request);
-    }
-}
-
-void LoadBalancer::updateStatistics()
+void LoadBalancer::updateStatistics() const
 {
     m_statistics.totalInstances = m_instances.size();
-    m_statistics.healthyInstances = getHealthyAIInstances().size();
-    m_statistics.queuedRequests = m_requestQueue.size();
+    m_statistics.queuedRequests = static_cast<int>(m_requestQueue.size());
     m_statistics.totalRequests = m_totalRequests;
     m_statistics.successfulRequests = m_successfulRequests;
     m_statistics.failedRequests = m_failedRequests;
     
-    // 计算活跃连接数和平均响应时间
+    // 计算健康实例数、活跃连接数和平均响应时间
+    int healthyInstances = 0;
     int totalConnections = 0;
     double totalResponseTime = 0.0;
     int responseTimeCount = 0;
     
-    for (const auto &instance : m_instances.values()) {
+    for (const auto &instance : m_instances) {
+        if (instance.isHealthy && instance.isActive) {
+            healthyInstances++;
+        }
         totalConnections += instance.currentConnections;
         if (instance.totalRequests > 0) {
             totalResponseTime += instance.averageResponseTime;
@@ -697,6 +1022,7 @@ void LoadBalancer::updateStatistics()
         }
     }
     
+    m_statistics.healthyInstances = healthyInstances;
     m_statistics.activeConnections = totalConnections;
     if (responseTimeCount > 0) {
         m_statistics.averageResponseTime = totalResponseTime / responseTimeCount;
@@ -708,59 +1034,69 @@ void LoadBalancer::updateStatistics()
     if (secondsElapsed > 0) {
         m_statistics.requestsPerSecond = static_cast<double>(m_totalRequests) / secondsElapsed;
     }
-    
-    emit statisticsUpdated(m_statistics);
-}
-
-bool LoadBalancer::canScaleUp() const
-{
-    return m_instances.size() < m_maxInstances;
 }
 
-bool LoadBalancer::canScaleDown() const
+double LoadBalancer::recentResponseTimePercentile(double percentile) const
 {
-    return m_instances.size() > m_minInstances;
+    if (m_recentResponseTimes.isEmpty()) {
+        return 0.0;
+    }
+    
+    QVector<double> values = m_recentResponseTimes;
+    const int index = qBound(0, static_cast<int>(std::ceil(percentile / 100.0 * values.size())) - 1,
+                             static_cast<int>(values.size()) - 1);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
 }
 
-void LoadBalancer::scaleUp()
+void LoadBalancer::scaleUp(int count, const QString &reason)
 {
     // 这里应该实现实际的扩容逻辑
     // 例如启动新的AI实例
-    qDebug() << "⚖️ Scaling up (placeholder implementation)";
-    
-    // 示例：创建新实例
-    AIInstance newInstance;
-    newInstance.id = generateInstanceId();
-    newInstance.name = QString("Auto-scaled AI %1").arg(m_instances.size() + 1);
-    newInstance.isActive = true;
-    newInstance.isHealthy = true;
-    newInstance.maxConnections = 100;
-    newInstance.weight = 1;
+    qDebug() << "⚖️ Scaling up by" << count << "(" << reason << ", placeholder implementation)";
+    
+    int added = 0;
+    for (int i = 0; i < count; ++i) {
+        // 示例：创建新实例
+        AIInstance newInstance;
+        newInstance.id = generateInstanceId();
+        newInstance.name = QString("Auto-scaled AI %1").arg(getStatistics().totalInstances + 1);
+        newInstance.isActive = true;
+        newInstance.isHealthy = true;
+        newInstance.maxConnections = 100;
+        newInstance.weight = 1;
+        
+        if (addAIInstance(newInstance)) {
+            added++;
+        }
+    }
     
-    addAIInstance(newInstance);
-    emit instanceScaled(m_instances.size());
+    if (added > 0) {
+        emit instanceScaled(getStatistics().totalInstances, reason);
+    }
 }
 
-void LoadBalancer::scaleDown()
+void LoadBalancer::scaleDown(const QString &reason)
 {
     // 这里应该实现实际的缩容逻辑
     // 例如停止最少使用的AI实例
-    qDebug() << "⚖️ Scaling down (placeholder implementation)";
+    qDebug() << "⚖️ Scaling down (" << reason << ", placeholder implementation)";
     
     // 示例：移除连接数最少且健康的实例
     QString instanceToRemove;
     int minConnections = INT_MAX;
-    
-    for (const auto &instance : m_instances.values()) {
-        if (instance.isHealthy && instance.currentConnections < minConnections) {
-            minConnections = instance.currentConnections;
-            instanceToRemove = instance.id;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto &instance : std::as_const(m_instances)) {
+            if (instance.isHealthy && instance.currentConnections < minConnections) {
+                minConnections = instance.currentConnections;
+                instanceToRemove = instance.id;
+            }
         }
     }
     
-    if (!instanceToRemove.isEmpty() && minConnections == 0) {
-        removeAIInstance(instanceToRemove);
-        emit instanceScaled(m_instances.size());
+    if (!instanceToRemove.isEmpty() && minConnections == 0 && removeAIInstance(instanceToRemove)) {
+        emit instanceScaled(getStatistics().totalInstances, reason);
     }
 }
 
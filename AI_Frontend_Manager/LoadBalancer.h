@@ -5,22 +5,29 @@
 #include <QTimer>
 #include <QMutex>
 #include <QThread>
-#include <QQueue>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QDateTime>
 #include <atomic>
+#include <list>
 #include <memory>
+#include <utility>
+#include <vector>
+#include "ScalingController.h"
+
+class QFile;
 
 /**
  * @brief AI引擎负载均衡器 - 智能分配AI请求和资源管理
  * 
  * 功能特性:
- * - 多种负载均衡算法 (轮询、加权轮询、最少连接、响应时间)
+ * - 多种负载均衡算法 (双随机选择、有界负载一致性哈希、轮询、加权轮询、最少连接、响应时间)
  * - 动态AI实例管理
  * - 健康检查和故障转移
- * - 请求队列管理
+ * - 请求队列管理 (提交和容量变化时立即分派，按ID O(1)取消)
  * - 性能监控集成
- * - 自动扩缩容
+ * - 预测式自动扩缩容 (亚秒级采样，Holt趋势预测，滞回与冷却)
  */
 class LoadBalancer : public QObject
 {
@@ -28,6 +35,8 @@ class LoadBalancer : public QObject
 
 public:
     enum class Algorithm {
+        PowerOfTwoChoices, // 双随机选择 (EWMA延迟×连接数)，默认
+        ConsistentHash,    // 有界负载一致性哈希 (按亲和键)
         RoundRobin,        // 轮询
         WeightedRoundRobin, // 加权轮询
         LeastConnections,  // 最少连接
@@ -43,6 +52,7 @@ public:
         int currentConnections = 0;     // 当前连接数
         int maxConnections = 100;       // 最大连接数
         double averageResponseTime = 0.0; // 平均响应时间
+        double ewmaResponseTime = 0.0;  // 响应时间指数加权移动平均 (近期延迟)
         double cpuUsage = 0.0;          // CPU使用率
         double memoryUsage = 0.0;       // 内存使用率
         int weight = 1;                 // 权重 (用于加权算法)
@@ -65,6 +75,7 @@ public:
         int retryCount = 0;            // 重试次数
         int maxRetries = 3;            // 最大重试次数
         QString assignedInstanceId;    // 分配的实例ID
+        QString affinityKey;           // 亲和键 (如AI ID)，一致性哈希模式下同键请求路由到同一实例
     };
 
     explicit LoadBalancer(QObject *parent = nullptr);
@@ -98,6 +109,9 @@ public:
     void enableAutoScaling(bool enabled);
     void setScalingThresholds(double scaleUpThreshold, double scaleDownThreshold);
     void setInstanceLimits(int minInstances, int maxInstances);
+    void setScalingConfig(const ScalingController::Config &config);
+    ScalingController::Config getScalingConfig() const;
+    bool setScalingTraceFile(const QString &filePath); // 录制扩缩容采样轨迹 (CSV)，空路径停止录制
 
     // 统计信息
     struct Statistics {
@@ -136,7 +150,7 @@ signals:
     void instanceAdded(const QString &instanceId);
     void instanceRemoved(const QString &instanceId);
     void instanceHealthChanged(const QString &instanceId, bool isHealthy);
-    void instanceScaled(int newInstanceCount);
+    void instanceScaled(int newInstanceCount, const QString &reason);
 
     // 负载均衡状态信号
     void algorithmChanged(Algorithm newAlgorithm);
@@ -144,38 +158,68 @@ signals:
     void queueSizeChanged(int queueSize);
 
 private slots:
-    void processRequestQueue();
     void performHealthCheck();
     void checkAutoScaling();
+    void publishStatistics();
 
 private:
     // 负载均衡算法实现
+    QString selectInstancePowerOfTwo();
+    QString selectInstanceConsistentHash(const QString &affinityKey);
     QString selectInstanceRoundRobin();
     QString selectInstanceWeightedRoundRobin();
     QString selectInstanceLeastConnections();
     QString selectInstanceResponseTime();
     QString selectInstanceResourceBased();
 
+    // 分派 (以下方法调用方持有m_mutex，信号在解锁后由调用方发射)
+    struct Assignment {
+        QString requestId;
+        QString instanceId;
+    };
+    QString selectInstance(const Request &request);
+    void dispatchQueuedRequests(QList<Assignment> &assigned);
+    void assignRequest(Request request, const QString &instanceId, QList<Assignment> &assigned);
+    void enqueueRequest(const Request &request);
+    void refreshDispatchable(const QString &instanceId);
+    void setConnections(AIInstance &instance, int connections);
+    void rebuildHashRing();
+    static quint64 hashKey(const QString &key);
+    bool evaluateInstanceHealth(AIInstance &instance);
+    void emitAssignments(const QList<Assignment> &assigned);
+    void scheduleStatisticsUpdate();
+
     // 内部辅助方法
     QString generateRequestId() const;
     QString generateInstanceId() const;
-    void assignRequest(const QString &requestId, const QString &instanceId);
-    void retryRequest(const QString &requestId);
-    void updateStatistics();
-    bool canScaleUp() const;
-    bool canScaleDown() const;
-    void scaleUp();
-    void scaleDown();
+    void updateStatistics() const;
+    void scaleUp(int count, const QString &reason);
+    void scaleDown(const QString &reason);
+    double recentResponseTimePercentile(double percentile) const;
 
     // 数据成员
     mutable QMutex m_mutex;
-    Algorithm m_algorithm = Algorithm::RoundRobin;
+    Algorithm m_algorithm = Algorithm::PowerOfTwoChoices;
     
     QMap<QString, AIInstance> m_instances;
-    QQueue<Request> m_requestQueue;
-    QMap<QString, Request> m_activeRequests;
+    QHash<QString, Request> m_activeRequests;
+    
+    // 请求队列：链表节点在其他节点增删时不失效，按ID保存迭代器作为取消句柄
+    std::list<Request> m_requestQueue;
+    QHash<QString, std::list<Request>::iterator> m_queuedRequests;
+    
+    // 可分派实例 (活跃、健康且有空余连接)：数组加下标索引，增删O(1)，空集合时分派直接返回
+    QVector<QString> m_dispatchable;
+    QHash<QString, int> m_dispatchableIndex;
+    QVector<int> m_dispatchableConnections; // 与m_dispatchable对应，已计入总和的连接数
+    int m_totalDispatchableConnections = 0; // 可分派实例连接数之和 (有界负载上限)
+    
+    // 一致性哈希环：每个实例按权重放置虚拟节点，只在实例增删时重建
+    std::vector<std::pair<quint64, QString>> m_hashRing;
+    static constexpr int VIRTUAL_NODES_PER_WEIGHT = 64;
+    static constexpr double HASH_LOAD_FACTOR = 1.25;   // 单实例负载上限 = 平均负载 × 系数
+    static constexpr double EWMA_ALPHA = 0.3;          // EWMA新样本权重
     
-    QTimer *m_queueProcessor = nullptr;
     QTimer *m_healthCheckTimer = nullptr;
     QTimer *m_autoScalingTimer = nullptr;
     
@@ -183,19 +227,26 @@ private:
     int m_roundRobinIndex = 0;
     QMap<QString, int> m_weightedRoundRobinCounters;
     
-    // 自动扩缩容设置
+    // 自动扩缩容设置 (阈值、实例数上下限和冷却时间在控制器配置中)
     bool m_autoScalingEnabled = false;
-    double m_scaleUpThreshold = 80.0;      // CPU/内存使用率阈值
-    double m_scaleDownThreshold = 30.0;
-    int m_minInstances = 1;
-    int m_maxInstances = 10;
+    ScalingController m_scalingController;
+    int m_arrivalsSinceSample = 0;          // 上次采样以来的到达请求数
+    qint64 m_lastScalingSampleMs = 0;       // 上次采样时间
+    QVector<double> m_recentResponseTimes;  // 近期响应时间环 (用于p95)
+    int m_responseTimeCursor = 0;
+    double m_serviceTimeEwma = 0.0;         // 服务时间EWMA
+    std::unique_ptr<QFile> m_scalingTrace;  // 采样轨迹录制文件
+    static constexpr int SCALING_SAMPLE_INTERVAL_MS = 250;
+    static constexpr int RESPONSE_TIME_WINDOW = 256;
     
     // 统计数据
-    Statistics m_statistics;
+    mutable Statistics m_statistics;
     std::atomic<int> m_totalRequests{0};
     std::atomic<int> m_successfulRequests{0};
     std::atomic<int> m_failedRequests{0};
     QDateTime m_lastStatsUpdate;
+    std::atomic<bool> m_statisticsScheduled{false};
+    int m_lastPublishedQueueSize = -1;
 };
 
 Q_DECLARE_METATYPE(LoadBalancer::Algorithm)
@@ -0,0 +1,1100 @@
+/**
+ * @file LogArchive.cpp
+ * @brief RANOnline EP7 AI系统 - 日志持久化归档实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "LogArchive.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x49474C52;     // "RLGI"
+constexpr quint32 INDEX_VERSION = 1;
+constexpr int LEVEL_COUNT = 5;
+constexpr qint64 MS_PER_DAY = 24LL * 60 * 60 * 1000;
+
+// 数据文件中每条记录的头部，后接来源、分类、消息的UTF-8字节（本机字节序）
+struct RecordHeader
+{
+    qint64 timestamp;
+    quint32 messageBytes;
+    quint16 sourceBytes;
+    quint16 categoryBytes;
+    quint8 level;
+    quint8 reserved[7];
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout");
+
+// 索引文件头，其后依次为条目表、级别数组、级别倒排、词表、倒排数据、词字符串
+struct IndexHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 entryCount;
+    quint32 tokenCount;
+    quint32 postingsBytes;
+    quint32 stringsBytes;
+    qint64 firstTimestamp;
+    qint64 lastTimestamp;
+    quint32 levelCounts[LEVEL_COUNT];
+    quint32 reserved;
+};
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader layout");
+
+// 条目表（时间索引）：数据文件偏移和单调化的时间戳，时钟回拨时取此前的最大值
+struct IndexEntry
+{
+    quint64 offset;
+    qint64 timestamp;
+};
+
+// 词表按词的字节序排序，前缀查询为一段连续区间
+struct IndexToken
+{
+    quint32 stringOffset;
+    quint32 stringLength;
+    quint32 postingsOffset;
+    quint32 postingsCount;
+};
+
+// 各部分在索引文件中的偏移
+struct IndexLayout
+{
+    qint64 entries;
+    qint64 levels;
+    qint64 levelPostings;
+    qint64 tokens;
+    qint64 postings;
+    qint64 strings;
+    qint64 total;
+};
+
+qint64 align8(qint64 value)
+{
+    return (value + 7) & ~qint64(7);
+}
+
+IndexLayout indexLayout(const IndexHeader& header)
+{
+    qint64 levelPostingCount = 0;
+    for (quint32 count : header.levelCounts) {
+        levelPostingCount += count;
+    }
+    
+    IndexLayout layout;
+    layout.entries = sizeof(IndexHeader);
+    layout.levels = layout.entries + qint64(header.entryCount) * qint64(sizeof(IndexEntry));
+    layout.levelPostings = align8(layout.levels + header.entryCount);
+    layout.tokens = align8(layout.levelPostings + levelPostingCount * qint64(sizeof(quint32)));
+    layout.postings = layout.tokens + qint64(header.tokenCount) * qint64(sizeof(IndexToken));
+    layout.strings = layout.postings + header.postingsBytes;
+    layout.total = layout.strings + header.stringsBytes;
+    return layout;
+}
+
+// 倒排列表存条目号的差值，变长编码
+void appendVarint(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+quint32 readVarint(const uchar*& p, const uchar* end)
+{
+    quint32 value = 0;
+    for (int shift = 0; p < end && shift < 35; shift += 7) {
+        const uchar byte = *p++;
+        value |= quint32(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+// 解码一条记录，越界或损坏时返回false
+bool decodeRecord(const uchar* data, qint64 size, qint64 offset,
+                  LogEntry& entry, qint64& timestampMs, qint64& recordBytes)
+{
+    if (offset < 0 || offset + qint64(sizeof(RecordHeader)) > size) {
+        return false;
+    }
+    
+    RecordHeader header;
+    std::memcpy(&header, data + offset, sizeof(header));
+    if (header.level >= LEVEL_COUNT) {
+        return false;
+    }
+    
+    const qint64 total = qint64(sizeof(RecordHeader)) + header.sourceBytes + header.categoryBytes + header.messageBytes;
+    if (offset + total > size) {
+        return false;
+    }
+    
+    const char* p = reinterpret_cast<const char*>(data + offset + sizeof(RecordHeader));
+    entry.timestamp = QDateTime::fromMSecsSinceEpoch(header.timestamp);
+    entry.level = static_cast<LogLevel>(header.level);
+    entry.source = QString::fromUtf8(p, header.sourceBytes);
+    p += header.sourceBytes;
+    entry.category = QString::fromUtf8(p, header.categoryBytes);
+    p += header.categoryBytes;
+    entry.message = QString::fromUtf8(p, header.messageBytes);
+    
+    timestampMs = header.timestamp;
+    recordBytes = total;
+    return true;
+}
+
+// 从文件读取一条记录（当前分段用，数据文件不做映射）
+bool readRecord(QFile& file, qint64 offset, LogEntry& out)
+{
+    if (!file.seek(offset)) {
+        return false;
+    }
+    
+    QByteArray buffer = file.read(sizeof(RecordHeader));
+    if (buffer.size() != int(sizeof(RecordHeader))) {
+        return false;
+    }
+    RecordHeader header;
+    std::memcpy(&header, buffer.constData(), sizeof(header));
+    buffer.append(file.read(qint64(header.sourceBytes) + header.categoryBytes + header.messageBytes));
+    
+    qint64 timestampMs = 0;
+    qint64 recordBytes = 0;
+    return decodeRecord(reinterpret_cast<const uchar*>(buffer.constData()), buffer.size(), 0,
+                        out, timestampMs, recordBytes);
+}
+
+// 读出的条目确认真实时间和关键词子串
+bool matchesEntry(const LogEntry& entry, const LogArchive::Query& query, qint64 fromMs, qint64 toMs)
+{
+    const qint64 timestamp = entry.timestamp.toMSecsSinceEpoch();
+    if (timestamp < fromMs || timestamp > toMs) {
+        return false;
+    }
+    return query.keyword.isEmpty()
+        || entry.message.contains(query.keyword, Qt::CaseInsensitive)
+        || entry.source.contains(query.keyword, Qt::CaseInsensitive);
+}
+
+// 词中间的片段查询：超长词建索引时被截断，片段可能落在截掉的部分，一并作为候选
+bool tokenContains(const QByteArray& token, const QByteArray& fragment)
+{
+    if (token.contains(fragment)) {
+        return true;
+    }
+    return token.size() >= LogArchive::MAX_TOKEN_LENGTH
+        && QString::fromUtf8(token).size() >= LogArchive::MAX_TOKEN_LENGTH;
+}
+
+// 从新到旧遍历候选条目，visit返回false时停止
+template<typename Visit>
+void forEachNewestFirst(bool indexed, quint32 begin, quint32 end,
+                        const std::vector<quint32>& candidates, Visit visit)
+{
+    if (indexed) {
+        const auto first = std::lower_bound(candidates.begin(), candidates.end(), begin);
+        auto it = std::lower_bound(first, candidates.end(), end);
+        while (it != first && visit(*--it)) {
+        }
+    } else {
+        for (quint32 number = end; number > begin && visit(--number);) {
+        }
+    }
+}
+
+QString segmentBaseName(qint64 timestampMs)
+{
+    return QString("segment-%1").arg(timestampMs, 13, 10, QLatin1Char('0'));
+}
+
+QString indexPathFor(const QString& dataPath)
+{
+    return dataPath.left(dataPath.size() - 4) + ".idx";
+}
+
+// 有序条目号集合求交
+void intersect(std::vector<quint32>& candidates, const std::vector<quint32>& other)
+{
+    std::vector<quint32> result;
+    result.reserve(qMin(candidates.size(), other.size()));
+    std::set_intersection(candidates.begin(), candidates.end(), other.begin(), other.end(),
+                          std::back_inserter(result));
+    candidates.swap(result);
+}
+
+} // namespace
+
+/**
+ * @class LogArchive::Segment
+ * @brief 分段的只读访问接口，查询逻辑对封存分段和当前分段通用
+ */
+class LogArchive::Segment
+{
+public:
+    virtual ~Segment() = default;
+    
+    virtual quint32 entryCount() const = 0;
+    virtual qint64 firstTimestamp() const = 0;
+    virtual qint64 lastTimestamp() const = 0;
+    
+    // 单调化的时间戳，可二分
+    virtual qint64 timestampAt(quint32 entry) const = 0;
+    virtual int levelAt(quint32 entry) const = 0;
+    
+    // 级别恰为level的条目号（升序），追加到out
+    virtual void levelPostings(int level, std::vector<quint32>& out) const = 0;
+    
+    // 以prefix开头的所有词的条目号，追加到out（未排序）
+    virtual void prefixPostings(const QByteArray& prefix, std::vector<quint32>& out) const = 0;
+    
+    // 包含fragment的所有词的条目号，追加到out（未排序，扫描整个词表）
+    virtual void infixPostings(const QByteArray& fragment, std::vector<quint32>& out) const = 0;
+    
+    virtual bool readEntry(quint32 entry, LogEntry& out) const = 0;
+};
+
+/**
+ * @class LogArchive::ActiveSegment
+ * @brief 正在写入的分段，索引保存在内存中，封存时写出
+ */
+class LogArchive::ActiveSegment : public LogArchive::Segment
+{
+public:
+    ActiveSegment(const QString& dataPath, qint64 rollTimestamp)
+        : m_dataPath(dataPath)
+        , m_rollTimestamp(rollTimestamp)
+        , m_writer(dataPath)
+        , m_reader(dataPath)
+    {
+    }
+    
+    /**
+     * @brief 新建数据文件
+     */
+    bool create()
+    {
+        return m_writer.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && m_reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+    
+    /**
+     * @brief 扫描已有数据文件重建索引，截掉不完整的尾部记录
+     */
+    bool recover()
+    {
+        QFile file(m_dataPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        
+        const qint64 fileSize = file.size();
+        qint64 offset = 0;
+        if (fileSize > 0) {
+            const uchar* data = file.map(0, fileSize);
+            if (!data) {
+                return false;
+            }
+            
+            LogEntry entry;
+            qint64 timestampMs = 0;
+            qint64 recordBytes = 0;
+            while (decodeRecord(data, fileSize, offset, entry, timestampMs, recordBytes)) {
+                index(offset, timestampMs, entry);
+                offset += recordBytes;
+            }
+            file.unmap(const_cast<uchar*>(data));
+        }
+        file.close();
+        
+        if (offset < fileSize && !QFile::resize(m_dataPath, offset)) {
+            return false;
+        }
+        m_size = offset;
+        return true;
+    }
+    
+    /**
+     * @brief 追加条目
+     */
+    void append(const LogEntry& entry, qint64 timestampMs)
+    {
+        const QByteArray source = entry.source.toUtf8().left(0xFFFF);
+        const QByteArray category = entry.category.toUtf8().left(0xFFFF);
+        const QByteArray message = entry.message.toUtf8();
+        
+        RecordHeader header{};
+        header.timestamp = timestampMs;
+        header.messageBytes = quint32(message.size());
+        header.sourceBytes = quint16(source.size());
+        header.categoryBytes = quint16(category.size());
+        header.level = quint8(entry.level);
+        
+        QByteArray record;
+        record.reserve(int(sizeof(header)) + source.size() + category.size() + message.size());
+        record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        record.append(source);
+        record.append(category);
+        record.append(message);
+        
+        // 写入失败时不建索引，残缺的记录由下次open时截掉
+        const qint64 offset = m_size;
+        const qint64 written = m_writer.write(record);
+        m_size += qMax<qint64>(0, written);
+        if (written != record.size()) {
+            return;
+        }
+        index(offset, timestampMs, entry);
+    }
+    
+    void flush()
+    {
+        m_writer.flush();
+    }
+    
+    /**
+     * @brief 写出索引文件（先写临时文件再改名）
+     */
+    bool writeIndex(const QString& indexPath) const
+    {
+        IndexHeader header{};
+        header.magic = INDEX_MAGIC;
+        header.version = INDEX_VERSION;
+        header.entryCount = entryCount();
+        header.tokenCount = quint32(m_postings.size());
+        header.firstTimestamp = m_minTimestamp;
+        header.lastTimestamp = m_maxTimestamp;
+        for (int level = 0; level < LEVEL_COUNT; ++level) {
+            header.levelCounts[level] = quint32(m_levelPostings[level].size());
+        }
+        
+        QByteArray postings;
+        QByteArray strings;
+        std::vector<IndexToken> tokens;
+        tokens.reserve(m_postings.size());
+        for (const auto& [token, list] : m_postings) {
+            IndexToken record;
+            record.stringOffset = quint32(strings.size());
+            record.stringLength = quint32(token.size());
+            record.postingsOffset = quint32(postings.size());
+            record.postingsCount = quint32(list.size());
+            tokens.push_back(record);
+            
+            quint32 previous = 0;
+            for (quint32 entry : list) {
+                appendVarint(postings, entry - previous);
+                previous = entry;
+            }
+            strings.append(token);
+        }
+        header.postingsBytes = quint32(postings.size());
+        header.stringsBytes = quint32(strings.size());
+        
+        const IndexLayout layout = indexLayout(header);
+        QByteArray out(layout.total, '\0');
+        char* base = out.data();
+        std::memcpy(base, &header, sizeof(header));
+        for (quint32 i = 0; i < header.entryCount; ++i) {
+            const IndexEntry entry{ m_offsets[i], m_timestamps[i] };
+            std::memcpy(base + layout.entries + qint64(i) * qint64(sizeof(IndexEntry)), &entry, sizeof(entry));
+        }
+        std::memcpy(base + layout.levels, m_levels.data(), m_levels.size());
+        qint64 levelOffset = layout.levelPostings;
+        for (const auto& list : m_levelPostings) {
+            if (!list.empty()) {
+                std::memcpy(base + levelOffset, list.data(), list.size() * sizeof(quint32));
+                levelOffset += qint64(list.size() * sizeof(quint32));
+            }
+        }
+        if (!tokens.empty()) {
+            std::memcpy(base + layout.tokens, tokens.data(), tokens.size() * sizeof(IndexToken));
+        }
+        std::memcpy(base + layout.postings, postings.constData(), size_t(postings.size()));
+        std::memcpy(base + layout.strings, strings.constData(), size_t(strings.size()));
+        
+        const QString tempPath = indexPath + ".tmp";
+        QFile file(tempPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(out) != out.size()) {
+            file.remove();
+            return false;
+        }
+        file.close();
+        
+        QFile::remove(indexPath);
+        return QFile::rename(tempPath, indexPath);
+    }
+    
+    QString dataPath() const { return m_dataPath; }
+    qint64 size() const { return m_size; }
+    qint64 rollTimestamp() const { return m_rollTimestamp; }
+    
+    quint32 entryCount() const override { return quint32(m_offsets.size()); }
+    qint64 firstTimestamp() const override { return m_minTimestamp; }
+    qint64 lastTimestamp() const override { return m_maxTimestamp; }
+    qint64 timestampAt(quint32 entry) const override { return m_timestamps[entry]; }
+    int levelAt(quint32 entry) const override { return m_levels[entry]; }
+    
+    void levelPostings(int level, std::vector<quint32>& out) const override
+    {
+        const auto& list = m_levelPostings[level];
+        out.insert(out.end(), list.begin(), list.end());
+    }
+    
+    void prefixPostings(const QByteArray& prefix, std::vector<quint32>& out) const override
+    {
+        for (auto it = m_postings.lower_bound(prefix); it != m_postings.end() && it->first.startsWith(prefix); ++it) {
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+    }
+    
+    void infixPostings(const QByteArray& fragment, std::vector<quint32>& out) const override
+    {
+        for (const auto& [token, list] : m_postings) {
+            if (tokenContains(token, fragment)) {
+                out.insert(out.end(), list.begin(), list.end());
+            }
+        }
+    }
+    
+    bool readEntry(quint32 entry, LogEntry& out) const override
+    {
+        return readRecord(m_reader, qint64(m_offsets[entry]), out);
+    }
+    
+    quint64 offsetAt(quint32 entry) const { return m_offsets[entry]; }
+
+private:
+    /**
+     * @brief 把一条记录加入内存索引
+     */
+    void index(qint64 offset, qint64 timestampMs, const LogEntry& entry)
+    {
+        const quint32 number = entryCount();
+        if (number == 0) {
+            m_minTimestamp = timestampMs;
+            m_maxTimestamp = timestampMs;
+        } else {
+            m_minTimestamp = qMin(m_minTimestamp, timestampMs);
+            m_maxTimestamp = qMax(m_maxTimestamp, timestampMs);
+        }
+        
+        const int level = static_cast<int>(entry.level);
+        m_offsets.push_back(quint64(offset));
+        m_timestamps.push_back(m_maxTimestamp);
+        m_levels.push_back(quint8(level));
+        m_levelPostings[level].push_back(number);
+        
+        for (const QString* text : { &entry.message, &entry.source }) {
+            for (const QByteArray& token : LogArchive::tokenize(*text)) {
+                std::vector<quint32>& list = m_postings[token];
+                if (list.empty() || list.back() != number) {
+                    list.push_back(number);
+                }
+            }
+        }
+    }
+    
+    QString m_dataPath;
+    qint64 m_rollTimestamp;
+    QFile m_writer;
+    mutable QFile m_reader;
+    qint64 m_size = 0;
+    qint64 m_minTimestamp = 0;
+    qint64 m_maxTimestamp = 0;
+    
+    std::vector<quint64> m_offsets;
+    std::vector<qint64> m_timestamps;
+    std::vector<quint8> m_levels;
+    std::array<std::vector<quint32>, LEVEL_COUNT> m_levelPostings;
+    std::map<QByteArray, std::vector<quint32>> m_postings;
+};
+
+/**
+ * @class LogArchive::SealedSegment
+ * @brief 已封存的分段，数据文件和索引文件都以内存映射方式只读访问
+ */
+class LogArchive::SealedSegment : public LogArchive::Segment
+{
+public:
+    SealedSegment(const QString& dataPath, const QString& indexPath)
+        : m_dataFile(dataPath)
+        , m_indexFile(indexPath)
+    {
+    }
+    
+    ~SealedSegment() override
+    {
+        m_dataFile.close();
+        m_indexFile.close();
+        if (m_removeWhenReleased) {
+            QFile::remove(m_dataFile.fileName());
+            QFile::remove(m_indexFile.fileName());
+        }
+    }
+    
+    /**
+     * @brief 映射文件并校验索引
+     */
+    bool load()
+    {
+        if (!m_dataFile.open(QIODevice::ReadOnly) || !m_indexFile.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        
+        m_dataSize = m_dataFile.size();
+        const qint64 indexSize = m_indexFile.size();
+        if (m_dataSize <= 0 || indexSize < qint64(sizeof(IndexHeader))) {
+            return false;
+        }
+        
+        m_data = m_dataFile.map(0, m_dataSize);
+        m_index = m_indexFile.map(0, indexSize);
+        if (!m_data || !m_index) {
+            return false;
+        }
+        
+        std::memcpy(&m_header, m_index, sizeof(m_header));
+        if (m_header.magic != INDEX_MAGIC || m_header.version != INDEX_VERSION) {
+            return false;
+        }
+        m_layout = indexLayout(m_header);
+        return m_layout.total == indexSize;
+    }
+    
+    /**
+     * @brief 最后一个使用者释放后删除文件
+     */
+    void removeWhenReleased() { m_removeWhenReleased = true; }
+    
+    quint32 entryCount() const override { return m_header.entryCount; }
+    qint64 firstTimestamp() const override { return m_header.firstTimestamp; }
+    qint64 lastTimestamp() const override { return m_header.lastTimestamp; }
+    
+    qint64 timestampAt(quint32 entry) const override
+    {
+        return indexEntry(entry).timestamp;
+    }
+    
+    int levelAt(quint32 entry) const override
+    {
+        return m_index[m_layout.levels + entry];
+    }
+    
+    void levelPostings(int level, std::vector<quint32>& out) const override
+    {
+        qint64 offset = m_layout.levelPostings;
+        for (int i = 0; i < level; ++i) {
+            offset += qint64(m_header.levelCounts[i]) * qint64(sizeof(quint32));
+        }
+        
+        if (m_header.levelCounts[level] == 0) {
+            return;
+        }
+        const size_t existing = out.size();
+        out.resize(existing + m_header.levelCounts[level]);
+        std::memcpy(out.data() + existing, m_index + offset, m_header.levelCounts[level] * sizeof(quint32));
+    }
+    
+    void prefixPostings(const QByteArray& prefix, std::vector<quint32>& out) const override
+    {
+        // 二分找到第一个不小于prefix的词，之后连续的词都以prefix开头
+        quint32 low = 0;
+        quint32 high = m_header.tokenCount;
+        while (low < high) {
+            const quint32 middle = low + (high - low) / 2;
+            if (tokenAt(middle) < prefix) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        
+        for (quint32 i = low; i < m_header.tokenCount && tokenAt(i).startsWith(prefix); ++i) {
+            appendPostings(i, out);
+        }
+    }
+    
+    void infixPostings(const QByteArray& fragment, std::vector<quint32>& out) const override
+    {
+        for (quint32 i = 0; i < m_header.tokenCount; ++i) {
+            if (tokenContains(tokenAt(i), fragment)) {
+                appendPostings(i, out);
+            }
+        }
+    }
+    
+    bool readEntry(quint32 entry, LogEntry& out) const override
+    {
+        qint64 timestampMs = 0;
+        qint64 recordBytes = 0;
+        return decodeRecord(m_data, m_dataSize, qint64(indexEntry(entry).offset), out, timestampMs, recordBytes);
+    }
+
+private:
+    IndexEntry indexEntry(quint32 entry) const
+    {
+        IndexEntry record;
+        std::memcpy(&record, m_index + m_layout.entries + qint64(entry) * qint64(sizeof(IndexEntry)), sizeof(record));
+        return record;
+    }
+    
+    IndexToken tokenRecord(quint32 i) const
+    {
+        IndexToken record;
+        std::memcpy(&record, m_index + m_layout.tokens + qint64(i) * qint64(sizeof(IndexToken)), sizeof(record));
+        return record;
+    }
+    
+    // 解码第i个词的倒排列表，追加到out
+    void appendPostings(quint32 i, std::vector<quint32>& out) const
+    {
+        const IndexToken token = tokenRecord(i);
+        const uchar* p = m_index + m_layout.postings + token.postingsOffset;
+        const uchar* end = m_index + m_layout.strings;
+        quint32 entry = 0;
+        for (quint32 n = 0; n < token.postingsCount; ++n) {
+            entry += readVarint(p, end);
+            out.push_back(entry);
+        }
+    }
+    
+    // 不复制的词视图
+    QByteArray tokenAt(quint32 i) const
+    {
+        const IndexToken record = tokenRecord(i);
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(m_index + m_layout.strings + record.stringOffset),
+                                       int(record.stringLength));
+    }
+    
+    QFile m_dataFile;
+    QFile m_indexFile;
+    const uchar* m_data = nullptr;
+    const uchar* m_index = nullptr;
+    qint64 m_dataSize = 0;
+    IndexHeader m_header{};
+    IndexLayout m_layout{};
+    bool m_removeWhenReleased = false;
+};
+
+/**
+ * @brief 构造函数
+ */
+LogArchive::LogArchive(const QString& directory, qint64 maxSegmentBytes, int retentionDays)
+    : m_directory(directory)
+    , m_maxSegmentBytes(qMax<qint64>(4096, maxSegmentBytes))
+    , m_retentionDays(qMax(1, retentionDays))
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+LogArchive::~LogArchive()
+{
+    close();
+}
+
+/**
+ * @brief 打开归档目录
+ */
+bool LogArchive::open()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open) {
+        return true;
+    }
+    
+    QDir dir(m_directory);
+    if (!dir.mkpath(".")) {
+        return false;
+    }
+    
+    // 文件名中的时间补零到固定宽度，按名称排序即按时间排序
+    const QStringList dataFiles = dir.entryList({ "segment-*.log" }, QDir::Files, QDir::Name);
+    for (const QString& name : dataFiles) {
+        const QString dataPath = dir.filePath(name);
+        const QString indexPath = indexPathFor(dataPath);
+        
+        if (!QFile::exists(indexPath)) {
+            // 上次未正常封存，扫描数据文件重建索引
+            ActiveSegment recovered(dataPath, 0);
+            if (!recovered.recover()) {
+                continue;
+            }
+            if (recovered.entryCount() == 0) {
+                QFile::remove(dataPath);
+                continue;
+            }
+            if (!recovered.writeIndex(indexPath)) {
+                continue;
+            }
+        }
+        
+        auto segment = std::make_shared<SealedSegment>(dataPath, indexPath);
+        if (segment->load()) {
+            m_sealed.push_back(std::move(segment));
+        }
+    }
+    
+    m_open = true;
+    removeExpiredSegments(QDateTime::currentMSecsSinceEpoch());
+    return true;
+}
+
+/**
+ * @brief 封存当前分段并关闭
+ */
+void LogArchive::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return;
+    }
+    
+    sealActiveSegment();
+    m_sealed.clear();
+    m_open = false;
+}
+
+/**
+ * @brief 是否已打开
+ */
+bool LogArchive::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_open;
+}
+
+/**
+ * @brief 追加日志条目
+ */
+void LogArchive::append(const LogEntry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return;
+    }
+    
+    const qint64 timestampMs = entry.timestamp.isValid()
+        ? entry.timestamp.toMSecsSinceEpoch()
+        : QDateTime::currentMSecsSinceEpoch();
+    
+    // 跨天或超过大小时切换分段
+    if (m_active && (m_active->size() >= m_maxSegmentBytes || timestampMs >= m_active->rollTimestamp())) {
+        sealActiveSegment();
+    }
+    if (!m_active && !startSegment(timestampMs)) {
+        return;
+    }
+    m_active->append(entry, timestampMs);
+}
+
+/**
+ * @brief 把缓冲的写入刷到磁盘
+ */
+void LogArchive::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_active) {
+        m_active->flush();
+    }
+}
+
+/**
+ * @brief 查询日志
+ */
+QVector<LogEntry> LogArchive::search(const Query& query)
+{
+    QVector<LogEntry> results;
+    if (query.limit <= 0) {
+        return results;
+    }
+    
+    const qint64 fromMs = query.from.isValid() ? query.from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    const qint64 toMs = query.to.isValid() ? query.to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    
+    QVector<QByteArray> tokens = tokenize(query.keyword);
+    
+    // 关键词以字母数字开头时，首个词在条目中可能从词中间开始，需要扫描词表；
+    // 其后的词前面都有分隔，按词前缀查找即可
+    QByteArray fragment;
+    if (!tokens.isEmpty()) {
+        const QChar first = query.keyword.at(0);
+        if (first.script() != QChar::Script_Han && (first.isLetterOrNumber() || first == QLatin1Char('_'))) {
+            fragment = tokens.first();
+        }
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    
+    // 当前分段的索引随写入增长，锁内只选出候选条目并复制其偏移；
+    // 封存的分段只读，复制列表后不持锁查询
+    std::vector<std::shared_ptr<SealedSegment>> sealed;
+    QString activePath;
+    std::vector<quint64> activeOffsets;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_active) {
+            m_active->flush();
+            activePath = m_active->dataPath();
+            
+            quint32 begin = 0;
+            quint32 end = 0;
+            std::vector<quint32> candidates;
+            const bool indexed = selectEntries(*m_active, query, tokens, fragment, fromMs, toMs,
+                                               begin, end, candidates);
+            const int minimumLevel = static_cast<int>(query.minimumLevel);
+            forEachNewestFirst(indexed, begin, end, candidates, [&](quint32 number) {
+                if (m_active->levelAt(number) >= minimumLevel) {
+                    activeOffsets.push_back(m_active->offsetAt(number));
+                }
+                return true;
+            });
+        }
+        sealed = m_sealed;
+    }
+    
+    // 用独立的读句柄读取当前分段的记录，不阻塞写入线程；封存后数据文件不变
+    if (!activeOffsets.empty()) {
+        QFile reader(activePath);
+        if (reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            LogEntry entry;
+            for (quint64 offset : activeOffsets) {
+                if (results.size() >= query.limit) {
+                    break;
+                }
+                if (readRecord(reader, qint64(offset), entry) && matchesEntry(entry, query, fromMs, toMs)) {
+                    results.append(entry);
+                }
+            }
+        }
+    }
+    
+    for (auto it = sealed.rbegin(); it != sealed.rend() && results.size() < query.limit; ++it) {
+        searchSegment(**it, query, tokens, fragment, fromMs, toMs, results);
+    }
+    return results;
+}
+
+/**
+ * @brief 分段数量
+ */
+int LogArchive::segmentCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_sealed.size()) + (m_active ? 1 : 0);
+}
+
+/**
+ * @brief 分词
+ */
+QVector<QByteArray> LogArchive::tokenize(const QString& text)
+{
+    QVector<QByteArray> tokens;
+    QString word;
+    
+    auto finishWord = [&]() {
+        if (!word.isEmpty()) {
+            tokens.append(word.left(MAX_TOKEN_LENGTH).toLower().toUtf8());
+            word.clear();
+        }
+    };
+    
+    for (const QChar ch : text) {
+        if (ch.script() == QChar::Script_Han) {
+            // 中文没有空格分词，逐字建索引，多字关键词由各字求交后再做子串确认
+            finishWord();
+            tokens.append(QString(ch).toUtf8());
+        } else if (ch.isLetterOrNumber() || ch == QLatin1Char('_')) {
+            word.append(ch);
+        } else {
+            finishWord();
+        }
+    }
+    finishWord();
+    return tokens;
+}
+
+/**
+ * @brief 为新条目开始一个分段
+ */
+bool LogArchive::startSegment(qint64 timestampMs)
+{
+    // 同一毫秒内切换分段时顺延文件名
+    qint64 nameMs = timestampMs;
+    QString dataPath = QDir(m_directory).filePath(segmentBaseName(nameMs) + ".log");
+    while (QFile::exists(dataPath)) {
+        dataPath = QDir(m_directory).filePath(segmentBaseName(++nameMs) + ".log");
+    }
+    
+    const QDate date = QDateTime::fromMSecsSinceEpoch(timestampMs).date();
+    const qint64 nextDayMs = QDateTime(date.addDays(1), QTime(0, 0)).toMSecsSinceEpoch();
+    
+    m_active = std::make_unique<ActiveSegment>(dataPath, nextDayMs);
+    if (!m_active->create()) {
+        m_active.reset();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 封存当前分段
+ */
+bool LogArchive::sealActiveSegment()
+{
+    if (!m_active) {
+        return true;
+    }
+    
+    m_active->flush();
+    const QString dataPath = m_active->dataPath();
+    const QString indexPath = indexPathFor(dataPath);
+    const bool empty = m_active->entryCount() == 0;
+    const bool written = empty || m_active->writeIndex(indexPath);
+    m_active.reset();
+    
+    if (empty) {
+        QFile::remove(dataPath);
+        return true;
+    }
+    if (!written) {
+        // 数据文件仍在，下次open时重建索引
+        return false;
+    }
+    
+    auto segment = std::make_shared<SealedSegment>(dataPath, indexPath);
+    if (segment->load()) {
+        m_sealed.push_back(std::move(segment));
+    }
+    removeExpiredSegments(QDateTime::currentMSecsSinceEpoch());
+    return true;
+}
+
+/**
+ * @brief 删除超过保留期的分段
+ */
+void LogArchive::removeExpiredSegments(qint64 nowMs)
+{
+    // 补写的旧日志可能排在较新的分段之后，逐个检查
+    const qint64 cutoff = nowMs - qint64(m_retentionDays) * MS_PER_DAY;
+    auto expired = [cutoff](const std::shared_ptr<SealedSegment>& segment) {
+        if (segment->lastTimestamp() >= cutoff) {
+            return false;
+        }
+        // 正在被查询的分段在查询结束后删除
+        segment->removeWhenReleased();
+        return true;
+    };
+    m_sealed.erase(std::remove_if(m_sealed.begin(), m_sealed.end(), expired), m_sealed.end());
+}
+
+/**
+ * @brief 在单个分段中选出候选条目
+ */
+bool LogArchive::selectEntries(const Segment& segment, const Query& query,
+                               const QVector<QByteArray>& tokens, const QByteArray& fragment,
+                               qint64 fromMs, qint64 toMs,
+                               quint32& begin, quint32& end, std::vector<quint32>& candidates)
+{
+    begin = 0;
+    end = 0;
+    const quint32 count = segment.entryCount();
+    if (count == 0 || segment.lastTimestamp() < fromMs || segment.firstTimestamp() > toMs) {
+        return false;
+    }
+    
+    // 时间索引：在单调化的时间戳上二分出条目号区间
+    auto firstAfter = [&segment, count](auto predicate) {
+        quint32 low = 0;
+        quint32 high = count;
+        while (low < high) {
+            const quint32 middle = low + (high - low) / 2;
+            if (predicate(segment.timestampAt(middle))) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        return low;
+    };
+    const quint32 first = firstAfter([fromMs](qint64 timestamp) { return timestamp >= fromMs; });
+    const quint32 last = firstAfter([toMs](qint64 timestamp) { return timestamp > toMs; });
+    if (first >= last) {
+        return false;
+    }
+    
+    // 倒排索引：各关键词取条目号后求交（首个词可能在词中间，按包含查找，其余按前缀）；
+    // 无关键词时用级别索引
+    const int minimumLevel = static_cast<int>(query.minimumLevel);
+    bool indexed = false;
+    for (const QByteArray& token : tokens) {
+        std::vector<quint32> postings;
+        if (token == fragment) {
+            segment.infixPostings(token, postings);
+        } else {
+            segment.prefixPostings(token, postings);
+        }
+        std::sort(postings.begin(), postings.end());
+        postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+        
+        if (!indexed) {
+            candidates.swap(postings);
+            indexed = true;
+        } else {
+            intersect(candidates, postings);
+        }
+        if (candidates.empty()) {
+            return false;
+        }
+    }
+    if (!indexed && minimumLevel > 0) {
+        for (int level = minimumLevel; level < LEVEL_COUNT; ++level) {
+            segment.levelPostings(level, candidates);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        indexed = true;
+    }
+    
+    begin = first;
+    end = last;
+    return indexed;
+}
+
+/**
+ * @brief 在单个分段中查询
+ */
+void LogArchive::searchSegment(const Segment& segment, const Query& query,
+                               const QVector<QByteArray>& tokens, const QByteArray& fragment,
+                               qint64 fromMs, qint64 toMs, QVector<LogEntry>& results)
+{
+    quint32 begin = 0;
+    quint32 end = 0;
+    std::vector<quint32> candidates;
+    const bool indexed = selectEntries(segment, query, tokens, fragment, fromMs, toMs, begin, end, candidates);
+    
+    // 只读取命中的条目，确认真实时间和关键词子串
+    const int minimumLevel = static_cast<int>(query.minimumLevel);
+    LogEntry entry;
+    forEachNewestFirst(indexed, begin, end, candidates, [&](quint32 number) {
+        if (segment.levelAt(number) >= minimumLevel && segment.readEntry(number, entry)
+            && matchesEntry(entry, query, fromMs, toMs)) {
+            results.append(entry);
+        }
+        return results.size() < query.limit;
+    });
+}
@@ -0,0 +1,174 @@
+/**
+ * @file LogArchive.h
+ * @brief RANOnline EP7 AI系统 - 日志持久化归档头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 日志追加写入滚动分段文件，按天或按大小切换分段
+ * - 分段封存时生成索引文件：倒排索引（词 -> 条目号）、时间索引、级别索引
+ * - 查询先按分段时间范围裁剪，再用索引求交，只读取命中的条目
+ * - 封存的分段通过内存映射访问，打开时自动为未封存的分段重建索引
+ */
+
+#pragma once
+
+#include "LogStore.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <memory>
+#include <vector>
+
+/**
+ * @class LogArchive
+ * @brief 日志持久化归档
+ *
+ * 分段文件为 segment-<首条时间毫秒>.log，封存后生成同名 .idx 索引文件。
+ * append()/flush() 由写入线程调用，search() 可在任意线程并发调用。
+ */
+class LogArchive
+{
+public:
+    static constexpr qint64 DEFAULT_SEGMENT_BYTES = 64LL * 1024 * 1024;    ///< 单个分段的最大字节数
+    static constexpr int DEFAULT_RETENTION_DAYS = 7;                        ///< 默认保留天数
+    static constexpr int MAX_TOKEN_LENGTH = 32;                             ///< 索引词最大字符数
+
+    /**
+     * @struct Query
+     * @brief 查询条件
+     */
+    struct Query
+    {
+        QDateTime from;                             ///< 起始时间（无效表示不限）
+        QDateTime to;                               ///< 结束时间（无效表示不限）
+        LogLevel minimumLevel = LogLevel::DEBUG;    ///< 最低级别
+        QString keyword;                            ///< 关键词（消息或来源，不区分大小写）
+        int limit = 10000;                          ///< 最多返回条数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param directory 归档目录
+     * @param maxSegmentBytes 单个分段的最大字节数
+     * @param retentionDays 保留天数，超过的分段被删除
+     */
+    explicit LogArchive(const QString& directory,
+                        qint64 maxSegmentBytes = DEFAULT_SEGMENT_BYTES,
+                        int retentionDays = DEFAULT_RETENTION_DAYS);
+
+    /**
+     * @brief 析构函数，封存当前分段
+     */
+    ~LogArchive();
+
+    /**
+     * @brief 打开归档目录，加载已封存的分段并为未封存的分段重建索引
+     * @return 是否成功
+     */
+    bool open();
+
+    /**
+     * @brief 封存当前分段并关闭
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 追加日志条目
+     * @param entry 日志条目
+     */
+    void append(const LogEntry& entry);
+
+    /**
+     * @brief 把缓冲的写入刷到磁盘
+     */
+    void flush();
+
+    /**
+     * @brief 查询日志
+     * @param query 查询条件
+     * @return 匹配的条目，按时间从新到旧
+     *
+     * 关键词按子串匹配：首个词可能出现在条目中某个词的中间，扫描词表按包含查找；
+     * 其余词按词前缀查找，在倒排索引中求交后再对命中条目做子串确认。
+     * 当前分段只在锁内选出候选条目，记录在锁外读取。
+     */
+    QVector<LogEntry> search(const Query& query);
+
+    /**
+     * @brief 分段数量（含当前分段）
+     */
+    int segmentCount() const;
+
+    /**
+     * @brief 归档目录
+     */
+    QString directory() const { return m_directory; }
+
+    /**
+     * @brief 分词：字母数字连续成词并转小写，汉字逐字成词
+     * @param text 文本
+     * @return 词列表（UTF-8）
+     */
+    static QVector<QByteArray> tokenize(const QString& text);
+
+private:
+    class Segment;
+    class SealedSegment;
+    class ActiveSegment;
+
+    /**
+     * @brief 为新条目开始一个分段
+     * @param timestampMs 首条时间
+     */
+    bool startSegment(qint64 timestampMs);
+
+    /**
+     * @brief 封存当前分段
+     */
+    bool sealActiveSegment();
+
+    /**
+     * @brief 删除超过保留期的分段
+     * @param nowMs 当前时间
+     */
+    void removeExpiredSegments(qint64 nowMs);
+
+    /**
+     * @brief 用时间索引和倒排/级别索引在单个分段中选出候选条目
+     * @param fragment 按包含查找的词（关键词开头可能在词中间时为首个词，否则为空）
+     * @param begin 输出时间范围内的首个条目号
+     * @param end 输出时间范围之后的首个条目号，begin >= end表示无命中
+     * @param candidates 输出索引命中的条目号（升序）
+     * @return candidates是否有效，否则[begin, end)内的条目都是候选
+     */
+    static bool selectEntries(const Segment& segment, const Query& query,
+                              const QVector<QByteArray>& tokens, const QByteArray& fragment,
+                              qint64 fromMs, qint64 toMs,
+                              quint32& begin, quint32& end, std::vector<quint32>& candidates);
+
+    /**
+     * @brief 在单个分段中查询，结果追加到results
+     */
+    static void searchSegment(const Segment& segment, const Query& query,
+                              const QVector<QByteArray>& tokens, const QByteArray& fragment,
+                              qint64 fromMs, qint64 toMs, QVector<LogEntry>& results);
+
+private:
+    QString m_directory;                                    ///< 归档目录
+    qint64 m_maxSegmentBytes;                               ///< 单个分段的最大字节数
+    int m_retentionDays;                                    ///< 保留天数
+    bool m_open = false;                                    ///< 是否已打开
+
+    mutable QMutex m_mutex;                                 ///< 保护分段列表和当前分段
+    std::vector<std::shared_ptr<SealedSegment>> m_sealed;   ///< 已封存的分段（从旧到新）
+    std::unique_ptr<ActiveSegment> m_active;                ///< 正在写入的分段
+};
@@ -0,0 +1,397 @@
+/**
+ * @file LogListModel.cpp
+ * @brief RANOnline EP7 AI系统 - 日志列表模型实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "LogListModel.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QtGui/QBrush>
+#include <algorithm>
+
+/**
+ * @brief 构造函数
+ */
+LogListModel::LogListModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(capacity)
+{
+    m_pending.reserve(FLUSH_THRESHOLD);
+    setBaseFont(QFont());
+}
+
+/**
+ * @brief 析构函数
+ */
+LogListModel::~LogListModel()
+{
+    cancelSearch();
+}
+
+/**
+ * @brief 可见行数
+ */
+int LogListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    if (!m_keyword.isEmpty()) {
+        return static_cast<int>(m_searchMatches.size() + m_liveMatches.size());
+    }
+    return m_store.countAtLeast(m_minimumLevel);
+}
+
+/**
+ * @brief 行数据
+ */
+QVariant LogListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    
+    const LogEntry& entry = m_store.at(rowSequence(index.row()));
+    switch (role) {
+    case Qt::DisplayRole:
+        return formatEntry(entry);
+    case Qt::ForegroundRole:
+        return QBrush(levelColor(entry.level));
+    case Qt::FontRole:
+        // 关键日志加粗
+        return entry.level >= LogLevel::ERROR ? m_boldFont : m_baseFont;
+    case Qt::BackgroundRole:
+        // 搜索高亮
+        if (!m_keyword.isEmpty()) {
+            return QBrush(QColor(255, 255, 0, 50));
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief 缓存日志条目
+ */
+void LogListModel::enqueue(const LogEntry& entry)
+{
+    m_pending.append(entry);
+    if (m_pending.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+/**
+ * @brief 批量插入缓存的条目
+ */
+int LogListModel::flush()
+{
+    if (m_pending.isEmpty()) {
+        return 0;
+    }
+    
+    // 一批超过容量时只有最后capacity条会留下
+    const int skip = qMax(0, static_cast<int>(m_pending.size()) - m_store.capacity());
+    const int incoming = static_cast<int>(m_pending.size()) - skip;
+    
+    // 先淘汰旧条目，一次通知移除的可见行
+    const int overflow = qMax(0, m_store.size() + incoming - m_store.capacity());
+    if (overflow > 0) {
+        const quint64 cutoff = m_store.firstSequence() + static_cast<quint64>(overflow);
+        const int removed = visibleRowsBefore(cutoff);
+        if (removed > 0) {
+            beginRemoveRows(QModelIndex(), 0, removed - 1);
+        }
+        m_store.removeOldest(overflow);
+        while (!m_searchMatches.empty() && m_searchMatches.front() < cutoff) {
+            m_searchMatches.pop_front();
+        }
+        while (!m_liveMatches.empty() && m_liveMatches.front() < cutoff) {
+            m_liveMatches.pop_front();
+        }
+        if (removed > 0) {
+            endRemoveRows();
+        }
+    }
+    
+    // 再插入新条目，一次通知新增的可见行
+    int added = 0;
+    for (int i = skip; i < m_pending.size(); ++i) {
+        if (passesFilter(m_pending[i])) {
+            added++;
+        }
+    }
+    
+    const int firstRow = rowCount();
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), firstRow, firstRow + added - 1);
+    }
+    for (int i = skip; i < m_pending.size(); ++i) {
+        const quint64 sequence = m_store.append(m_pending[i]);
+        if (!m_keyword.isEmpty() && passesFilter(m_pending[i])) {
+            m_liveMatches.push_back(sequence);
+        }
+    }
+    if (added > 0) {
+        endInsertRows();
+    }
+    
+    m_pending.clear();
+    return added;
+}
+
+/**
+ * @brief 清空全部日志
+ */
+void LogListModel::clear()
+{
+    cancelSearch();
+    
+    beginResetModel();
+    m_store.clear();
+    m_pending.clear();
+    m_searchMatches.clear();
+    m_liveMatches.clear();
+    endResetModel();
+}
+
+/**
+ * @brief 设置最低显示级别
+ */
+void LogListModel::setMinimumLevel(LogLevel level)
+{
+    if (level == m_minimumLevel) {
+        return;
+    }
+    m_minimumLevel = level;
+    restartSearch();
+}
+
+/**
+ * @brief 设置搜索关键词
+ */
+void LogListModel::setKeyword(const QString& keyword)
+{
+    m_keyword = keyword;
+    restartSearch();
+}
+
+/**
+ * @brief 设置基础字体
+ */
+void LogListModel::setBaseFont(const QFont& font)
+{
+    m_baseFont = font;
+    m_boldFont = font;
+    m_boldFont.setBold(true);
+}
+
+/**
+ * @brief 格式化日志条目
+ */
+QString LogListModel::formatEntry(const LogEntry& entry)
+{
+    QString timestamp = entry.timestamp.toString("hh:mm:ss.zzz");
+    QString levelName = LogListModel::levelName(entry.level);
+    QString source = entry.source.isEmpty() ? "System" : entry.source;
+    
+    return QString("[%1] [%2] [%3] %4")
+           .arg(timestamp)
+           .arg(levelName)
+           .arg(source)
+           .arg(entry.message);
+}
+
+/**
+ * @brief 日志级别颜色
+ */
+QColor LogListModel::levelColor(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::DEBUG:
+            return QColor(150, 150, 150);  // 灰色
+        case LogLevel::INFO:
+            return QColor(100, 200, 255);  // 浅蓝色
+        case LogLevel::WARNING:
+            return QColor(255, 200, 100);  // 橙色
+        case LogLevel::ERROR:
+            return QColor(255, 100, 100);  // 红色
+        case LogLevel::CRITICAL:
+            return QColor(255, 50, 150);   // 洋红色
+        default:
+            return QColor(255, 255, 255);  // 白色
+    }
+}
+
+/**
+ * @brief 日志级别名称
+ */
+QString LogListModel::levelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::DEBUG:
+            return "DEBUG";
+        case LogLevel::INFO:
+            return "INFO ";
+        case LogLevel::WARNING:
+            return "WARN ";
+        case LogLevel::ERROR:
+            return "ERROR";
+        case LogLevel::CRITICAL:
+            return "CRIT ";
+        default:
+            return "UNKN ";
+    }
+}
+
+/**
+ * @brief 条目是否匹配关键词
+ */
+bool LogListModel::matchesKeyword(const LogEntry& entry, const QString& keyword)
+{
+    return entry.message.contains(keyword, Qt::CaseInsensitive)
+        || entry.source.contains(keyword, Qt::CaseInsensitive);
+}
+
+/**
+ * @brief 行号对应的序号
+ */
+quint64 LogListModel::rowSequence(int row) const
+{
+    if (!m_keyword.isEmpty()) {
+        const int searched = static_cast<int>(m_searchMatches.size());
+        return row < searched ? m_searchMatches[row] : m_liveMatches[row - searched];
+    }
+    return m_store.sequenceAtLeast(m_minimumLevel, row);
+}
+
+/**
+ * @brief 序号小于sequence的可见行数
+ */
+int LogListModel::visibleRowsBefore(quint64 sequence) const
+{
+    if (!m_keyword.isEmpty()) {
+        const auto searched = std::lower_bound(m_searchMatches.begin(), m_searchMatches.end(), sequence);
+        const auto live = std::lower_bound(m_liveMatches.begin(), m_liveMatches.end(), sequence);
+        return static_cast<int>((searched - m_searchMatches.begin()) + (live - m_liveMatches.begin()));
+    }
+    return m_store.countAtLeastBefore(m_minimumLevel, sequence);
+}
+
+/**
+ * @brief 条目是否通过当前过滤
+ */
+bool LogListModel::passesFilter(const LogEntry& entry) const
+{
+    if (entry.level < m_minimumLevel) {
+        return false;
+    }
+    return m_keyword.isEmpty() || matchesKeyword(entry, m_keyword);
+}
+
+/**
+ * @brief 重新开始搜索
+ */
+void LogListModel::restartSearch()
+{
+    cancelSearch();
+    
+    // 未插入的条目在搜索快照之后，由flush()按新关键词判断
+    beginResetModel();
+    m_searchMatches.clear();
+    m_liveMatches.clear();
+    m_searchGeneration++;
+    endResetModel();
+    
+    if (m_keyword.isEmpty()) {
+        return;
+    }
+    
+    const LogStore::Snapshot snapshot = m_store.snapshot();
+    const QString keyword = m_keyword;
+    const LogLevel minimumLevel = m_minimumLevel;
+    const int generation = m_searchGeneration;
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    
+    m_searchCancel = cancel;
+    m_searchTotal = static_cast<int>(snapshot.endSequence() - snapshot.firstSequence());
+    m_searching = true;
+    emit searchProgress(0, m_searchTotal, 0, false);
+    
+    // 从新到旧扫描，每批结果投递回GUI线程；析构和重新搜索时等待本任务退出
+    m_searchFuture = QtConcurrent::run([this, snapshot, keyword, minimumLevel, generation, cancel]() {
+        QVector<quint64> batch;
+        int scanned = 0;
+        for (quint64 sequence = snapshot.endSequence(); sequence > snapshot.firstSequence();) {
+            --sequence;
+            const LogEntry& entry = snapshot.at(sequence);
+            if (entry.level >= minimumLevel && matchesKeyword(entry, keyword)) {
+                batch.append(sequence);
+            }
+            
+            if (++scanned % SEARCH_BATCH_SIZE == 0) {
+                if (cancel->load()) {
+                    return;
+                }
+                QMetaObject::invokeMethod(this, [this, generation, batch, scanned]() {
+                    addSearchResults(generation, batch, scanned, false);
+                }, Qt::QueuedConnection);
+                batch.clear();
+            }
+        }
+        
+        if (!cancel->load()) {
+            QMetaObject::invokeMethod(this, [this, generation, batch, scanned]() {
+                addSearchResults(generation, batch, scanned, true);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+/**
+ * @brief 取消并等待当前搜索
+ */
+void LogListModel::cancelSearch()
+{
+    if (m_searchCancel) {
+        m_searchCancel->store(true);
+        m_searchCancel.reset();
+    }
+    // 最多等待一批扫描完成
+    m_searchFuture.waitForFinished();
+    m_searching = false;
+}
+
+/**
+ * @brief 接收一批搜索结果
+ */
+void LogListModel::addSearchResults(int generation, const QVector<quint64>& sequences, int scanned, bool finished)
+{
+    if (generation != m_searchGeneration) {
+        return;
+    }
+    
+    // 扫描期间被淘汰的条目不再显示
+    int count = 0;
+    while (count < sequences.size() && sequences[count] >= m_store.firstSequence()) {
+        count++;
+    }
+    
+    // 结果比已显示的都旧，插入到最前面
+    if (count > 0) {
+        beginInsertRows(QModelIndex(), 0, count - 1);
+        for (int i = 0; i < count; ++i) {
+            m_searchMatches.push_front(sequences[i]);
+        }
+        endInsertRows();
+    }
+    
+    if (finished) {
+        m_searching = false;
+        m_searchCancel.reset();
+    }
+    emit searchProgress(scanned, m_searchTotal, rowCount(), finished);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file LogListModel.h
+ * @brief RANOnline EP7 AI系统 - 日志列表模型头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 虚拟化：视图只对可见行调用data()，格式化按需进行
+ * - 新日志先进入缓冲，flush()时一次性插入并淘汰旧行
+ * - 级别过滤直接使用存储的级别索引，不重新扫描
+ * - 关键词搜索在后台线程分批进行，结果从新到旧逐批显示
+ */
+
+#pragma once
+
+#include "LogStore.h"
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QFuture>
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+#include <atomic>
+#include <deque>
+#include <memory>
+
+/**
+ * @class LogListModel
+ * @brief 日志列表模型
+ */
+class LogListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FLUSH_THRESHOLD = 4096;        ///< 缓冲达到该条数时立即flush
+    static constexpr int SEARCH_BATCH_SIZE = 16384;     ///< 后台搜索每批扫描的条数
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最多保留的日志条数
+     * @param parent 父对象
+     */
+    explicit LogListModel(int capacity, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，等待后台搜索退出
+     */
+    ~LogListModel();
+
+    /**
+     * @brief 可见行数
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief 行数据（显示文本、前景色、字体、搜索高亮）
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 缓存日志条目，下次flush()时插入
+     * @param entry 日志条目
+     */
+    void enqueue(const LogEntry& entry);
+
+    /**
+     * @brief 把缓存的条目批量插入存储并通知视图
+     * @return 新增的可见行数
+     */
+    int flush();
+
+    /**
+     * @brief 清空全部日志
+     */
+    void clear();
+
+    /**
+     * @brief 设置最低显示级别
+     * @param level 级别
+     */
+    void setMinimumLevel(LogLevel level);
+
+    /**
+     * @brief 设置搜索关键词，非空时启动后台搜索
+     * @param keyword 关键词
+     */
+    void setKeyword(const QString& keyword);
+
+    /**
+     * @brief 设置基础字体（错误及以上级别加粗显示）
+     * @param font 字体
+     */
+    void setBaseFont(const QFont& font);
+
+    /**
+     * @brief 最低显示级别
+     */
+    LogLevel minimumLevel() const { return m_minimumLevel; }
+
+    /**
+     * @brief 当前关键词
+     */
+    QString keyword() const { return m_keyword; }
+
+    /**
+     * @brief 是否正在后台搜索
+     */
+    bool isSearching() const { return m_searching; }
+
+    /**
+     * @brief 日志存储
+     */
+    const LogStore& store() const { return m_store; }
+
+    /**
+     * @brief 格式化日志条目
+     */
+    static QString formatEntry(const LogEntry& entry);
+
+    /**
+     * @brief 日志级别颜色
+     */
+    static QColor levelColor(LogLevel level);
+
+    /**
+     * @brief 日志级别名称
+     */
+    static QString levelName(LogLevel level);
+
+    /**
+     * @brief 条目是否匹配关键词（消息或来源，不区分大小写）
+     */
+    static bool matchesKeyword(const LogEntry& entry, const QString& keyword);
+
+signals:
+    /**
+     * @brief 搜索进度信号
+     * @param scanned 已扫描条数
+     * @param total 需扫描条数
+     * @param matches 当前匹配行数
+     * @param finished 是否完成
+     */
+    void searchProgress(int scanned, int total, int matches, bool finished);
+
+private:
+    /**
+     * @brief 行号对应的序号
+     */
+    quint64 rowSequence(int row) const;
+
+    /**
+     * @brief 序号小于sequence的可见行数
+     */
+    int visibleRowsBefore(quint64 sequence) const;
+
+    /**
+     * @brief 条目是否通过当前过滤
+     */
+    bool passesFilter(const LogEntry& entry) const;
+
+    /**
+     * @brief 重新开始搜索（关键词为空时只重置模型）
+     */
+    void restartSearch();
+
+    /**
+     * @brief 取消并等待当前搜索
+     */
+    void cancelSearch();
+
+    /**
+     * @brief 接收一批搜索结果（GUI线程）
+     * @param generation 搜索代次，过期结果丢弃
+     * @param sequences 匹配序号（从新到旧）
+     * @param scanned 已扫描条数
+     * @param finished 是否完成
+     */
+    void addSearchResults(int generation, const QVector<quint64>& sequences, int scanned, bool finished);
+
+private:
+    LogStore m_store;                                   ///< 日志存储
+    QVector<LogEntry> m_pending;                        ///< 待插入的条目
+
+    LogLevel m_minimumLevel = LogLevel::DEBUG;          ///< 最低显示级别
+    QString m_keyword;                                  ///< 搜索关键词
+    QFont m_baseFont;                                   ///< 基础字体
+    QFont m_boldFont;                                   ///< 加粗字体
+
+    // 关键词模式下的可见行 = 历史搜索结果 + 搜索开始后新增的匹配
+    std::deque<quint64> m_searchMatches;                ///< 历史搜索结果（升序）
+    std::deque<quint64> m_liveMatches;                  ///< 新增匹配（升序）
+    int m_searchGeneration = 0;                         ///< 搜索代次
+    int m_searchTotal = 0;                              ///< 搜索需扫描条数
+    bool m_searching = false;                           ///< 是否正在搜索
+    std::shared_ptr<std::atomic<bool>> m_searchCancel;  ///< 取消标志
+    QFuture<void> m_searchFuture;                       ///< 后台搜索任务
+};
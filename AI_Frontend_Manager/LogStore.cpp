@@ -0,0 +1,170 @@
+/**
+ * @file LogStore.cpp
+ * @brief RANOnline EP7 AI系统 - 日志环形存储实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "LogStore.h"
+#include <algorithm>
+
+/**
+ * @brief 按序号取快照中的条目
+ */
+const LogEntry& LogStore::Snapshot::at(quint64 sequence) const
+{
+    if (sequence >= m_tailFirstSequence) {
+        return m_tail[sequence - m_tailFirstSequence];
+    }
+    
+    const quint64 index = sequence / CHUNK_SIZE - m_chunks.first()->firstSequence / CHUNK_SIZE;
+    const Chunk& chunk = *m_chunks[static_cast<int>(index)];
+    return chunk.entries[sequence - chunk.firstSequence];
+}
+
+/**
+ * @brief 构造函数
+ */
+LogStore::LogStore(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+/**
+ * @brief 追加条目
+ */
+quint64 LogStore::append(const LogEntry& entry)
+{
+    if (size() >= m_capacity) {
+        removeOldest(size() - m_capacity + 1);
+    }
+    
+    // 块按序号对齐，新块在序号落到块边界时创建
+    if (m_chunks.empty() || m_endSequence % CHUNK_SIZE == 0) {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->firstSequence = m_endSequence;
+        chunk->entries.reserve(CHUNK_SIZE - m_endSequence % CHUNK_SIZE);
+        m_chunks.push_back(std::move(chunk));
+    }
+    m_chunks.back()->entries.push_back(entry);
+    
+    const quint64 sequence = m_endSequence++;
+    for (int level = static_cast<int>(LogLevel::INFO); level <= static_cast<int>(entry.level); ++level) {
+        m_levelIndex[level - 1].push_back(sequence);
+    }
+    return sequence;
+}
+
+/**
+ * @brief 淘汰最旧的条目
+ */
+void LogStore::removeOldest(int count)
+{
+    const quint64 cutoff = qMin(m_firstSequence + static_cast<quint64>(qMax(0, count)), m_endSequence);
+    
+    // 被淘汰的条目都在各级别索引的最前面
+    for (auto& index : m_levelIndex) {
+        while (!index.empty() && index.front() < cutoff) {
+            index.pop_front();
+        }
+    }
+    m_firstSequence = cutoff;
+    
+    // 整块都已淘汰时释放该块（快照仍持有时延后释放）
+    while (!m_chunks.empty()) {
+        const Chunk& front = *m_chunks.front();
+        if (front.firstSequence + front.entries.size() > m_firstSequence
+            || (m_chunks.size() == 1 && m_endSequence % CHUNK_SIZE != 0)) {
+            break;
+        }
+        m_chunks.pop_front();
+    }
+}
+
+/**
+ * @brief 清空
+ */
+void LogStore::clear()
+{
+    m_chunks.clear();
+    for (auto& index : m_levelIndex) {
+        index.clear();
+    }
+    m_firstSequence = m_endSequence;
+}
+
+/**
+ * @brief 按序号取条目
+ */
+const LogEntry& LogStore::at(quint64 sequence) const
+{
+    const Chunk& chunk = chunkFor(sequence);
+    return chunk.entries[sequence - chunk.firstSequence];
+}
+
+/**
+ * @brief 级别不低于level的条目数
+ */
+int LogStore::countAtLeast(LogLevel level) const
+{
+    if (level <= LogLevel::DEBUG) {
+        return size();
+    }
+    return static_cast<int>(m_levelIndex[static_cast<int>(level) - 1].size());
+}
+
+/**
+ * @brief 级别不低于level的第row条的序号
+ */
+quint64 LogStore::sequenceAtLeast(LogLevel level, int row) const
+{
+    if (level <= LogLevel::DEBUG) {
+        return m_firstSequence + static_cast<quint64>(row);
+    }
+    return m_levelIndex[static_cast<int>(level) - 1][row];
+}
+
+/**
+ * @brief 级别不低于level且序号小于sequence的条目数
+ */
+int LogStore::countAtLeastBefore(LogLevel level, quint64 sequence) const
+{
+    if (level <= LogLevel::DEBUG) {
+        return static_cast<int>(qBound(m_firstSequence, sequence, m_endSequence) - m_firstSequence);
+    }
+    const auto& index = m_levelIndex[static_cast<int>(level) - 1];
+    return static_cast<int>(std::lower_bound(index.begin(), index.end(), sequence) - index.begin());
+}
+
+/**
+ * @brief 创建快照
+ */
+LogStore::Snapshot LogStore::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.m_firstSequence = m_firstSequence;
+    snapshot.m_endSequence = m_endSequence;
+    snapshot.m_tailFirstSequence = m_endSequence;
+    
+    for (const auto& chunk : m_chunks) {
+        const bool writing = chunk == m_chunks.back() && m_endSequence % CHUNK_SIZE != 0;
+        if (!writing) {
+            snapshot.m_chunks.append(chunk);
+        } else {
+            // 最后一个块仍在写入，复制其内容
+            snapshot.m_tail = chunk->entries;
+            snapshot.m_tailFirstSequence = chunk->firstSequence;
+        }
+    }
+    return snapshot;
+}
+
+/**
+ * @brief 序号所在的块
+ */
+const LogStore::Chunk& LogStore::chunkFor(quint64 sequence) const
+{
+    const quint64 index = sequence / CHUNK_SIZE - m_chunks.front()->firstSequence / CHUNK_SIZE;
+    return *m_chunks[index];
+}
@@ -0,0 +1,199 @@
+/**
+ * @file LogStore.h
+ * @brief RANOnline EP7 AI系统 - 日志环形存储头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 按块分配的环形存储，容量固定，淘汰最旧条目为O(1)
+ * - 每条日志有单调递增的序号，行号与序号的换算为O(1)
+ * - 按最低级别预建索引，切换级别过滤不需要重新扫描
+ * - 快照只共享已写满的块，可交给后台线程搜索
+ */
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/**
+ * @enum LogLevel
+ * @brief 日志级别枚举
+ */
+enum class LogLevel
+{
+    DEBUG = 0,
+    INFO = 1,
+    WARNING = 2,
+    ERROR = 3,
+    CRITICAL = 4
+};
+
+/**
+ * @struct LogEntry
+ * @brief 日志条目结构
+ */
+struct LogEntry
+{
+    QDateTime timestamp;
+    LogLevel level;
+    QString category;
+    QString message;
+    QString source;
+};
+
+/**
+ * @class LogStore
+ * @brief 日志环形存储
+ *
+ * 条目按序号寻址，有效序号为[firstSequence(), endSequence())。序号在clear()后
+ * 继续递增，旧序号不会被复用。非线程安全，由GUI线程独占；后台线程只使用snapshot()。
+ */
+class LogStore
+{
+public:
+    static constexpr int CHUNK_SIZE = 4096;     ///< 每块条目数
+
+    /**
+     * @struct Chunk
+     * @brief 存储块，写满后不再修改
+     */
+    struct Chunk
+    {
+        quint64 firstSequence = 0;              ///< 块内第一条的序号
+        std::vector<LogEntry> entries;          ///< 条目
+    };
+
+    /**
+     * @class Snapshot
+     * @brief 存储快照，可在其他线程只读访问
+     */
+    class Snapshot
+    {
+    public:
+        /**
+         * @brief 第一条的序号
+         */
+        quint64 firstSequence() const { return m_firstSequence; }
+
+        /**
+         * @brief 最后一条之后的序号
+         */
+        quint64 endSequence() const { return m_endSequence; }
+
+        /**
+         * @brief 按序号取条目
+         * @param sequence 序号，须在[firstSequence(), endSequence())内
+         * @return 条目
+         */
+        const LogEntry& at(quint64 sequence) const;
+
+    private:
+        friend class LogStore;
+
+        QVector<std::shared_ptr<const Chunk>> m_chunks;     ///< 共享的已满块
+        std::vector<LogEntry> m_tail;                       ///< 未满块的副本
+        quint64 m_tailFirstSequence = 0;                    ///< 未满块第一条的序号
+        quint64 m_firstSequence = 0;
+        quint64 m_endSequence = 0;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最多保留的条目数
+     */
+    explicit LogStore(int capacity);
+
+    /**
+     * @brief 追加条目，超出容量时淘汰最旧的条目
+     * @param entry 日志条目
+     * @return 新条目的序号
+     */
+    quint64 append(const LogEntry& entry);
+
+    /**
+     * @brief 淘汰最旧的条目
+     * @param count 条数
+     */
+    void removeOldest(int count);
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+    /**
+     * @brief 容量
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief 当前条目数
+     */
+    int size() const { return static_cast<int>(m_endSequence - m_firstSequence); }
+
+    /**
+     * @brief 第一条的序号
+     */
+    quint64 firstSequence() const { return m_firstSequence; }
+
+    /**
+     * @brief 最后一条之后的序号
+     */
+    quint64 endSequence() const { return m_endSequence; }
+
+    /**
+     * @brief 按序号取条目
+     * @param sequence 序号，须在[firstSequence(), endSequence())内
+     * @return 条目
+     */
+    const LogEntry& at(quint64 sequence) const;
+
+    /**
+     * @brief 级别不低于level的条目数
+     * @param level 最低级别
+     * @return 条目数
+     */
+    int countAtLeast(LogLevel level) const;
+
+    /**
+     * @brief 级别不低于level的第row条的序号
+     * @param level 最低级别
+     * @param row 行号
+     * @return 序号
+     */
+    quint64 sequenceAtLeast(LogLevel level, int row) const;
+
+    /**
+     * @brief 级别不低于level且序号小于sequence的条目数
+     * @param level 最低级别
+     * @param sequence 序号
+     * @return 条目数
+     */
+    int countAtLeastBefore(LogLevel level, quint64 sequence) const;
+
+    /**
+     * @brief 创建快照
+     * @return 快照（复制不超过一个块的条目）
+     */
+    Snapshot snapshot() const;
+
+private:
+    /**
+     * @brief 序号所在的块
+     */
+    const Chunk& chunkFor(quint64 sequence) const;
+
+private:
+    int m_capacity;                                         ///< 容量
+    std::deque<std::shared_ptr<Chunk>> m_chunks;            ///< 存储块
+    quint64 m_firstSequence = 0;                            ///< 第一条的序号
+    quint64 m_endSequence = 0;                              ///< 最后一条之后的序号
+    std::array<std::deque<quint64>, 4> m_levelIndex;        ///< INFO/WARNING/ERROR/CRITICAL及以上的序号
+};
@@ -13,6 +13,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDebug>
+#include <QtConcurrent/QtConcurrent>
 
 /**
  * @brief 构造函数
@@ -24,25 +25,37 @@ LogViewer::LogViewer(QWidget *parent)
     , m_levelFilterCombo(nullptr)
     , m_searchEdit(nullptr)
     , m_searchButton(nullptr)
+    , m_scopeCombo(nullptr)
     , m_clearButton(nullptr)
     , m_exportButton(nullptr)
     , m_autoScrollCheckBox(nullptr)
     , m_logDisplay(nullptr)
+    , m_logModel(nullptr)
+    , m_archiveModel(nullptr)
     , m_statusLayout(nullptr)
     , m_statusLabel(nullptr)
     , m_countLabel(nullptr)
     , m_currentFilter(LogLevel::DEBUG)
     , m_autoScroll(true)
-    , m_maxLogEntries(10000)
+    , m_maxLogEntries(1000000)
     , m_refreshTimer(new QTimer(this))
     , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_archive(std::make_unique<LogArchive>(
+          QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs/viewer"))
+    , m_archiveSearchWatcher(new QFutureWatcher<QVector<LogEntry>>(this))
+    , m_archiveSearchPending(false)
 {
+    // 打开日志归档，上次未封存的分段在这里重建索引
+    if (!m_archive->open()) {
+        qWarning() << "日志归档目录不可用:" << m_archive->directory();
+    }
+    
     initializeUI();
     setupCyberpunkStyle();
     connectSignalsAndSlots();
     
-    // 启动刷新定时器
-    m_refreshTimer->start(1000); // 每秒刷新一次
+    // 启动刷新定时器，新日志按批插入
+    m_refreshTimer->start(100);
     
     // 添加一些初始日志
     addInfoLog("RANOnline EP7 AI系统启动", "System");
@@ -55,7 +68,8 @@ LogViewer::LogViewer(QWidget *parent)
  */
 LogViewer::~LogViewer()
 {
-    // Qt自动清理
+    // 等待历史检索结束，归档在析构时封存当前分段
+    m_archiveSearchWatcher->waitForFinished();
 }
 
 /**
@@ -109,6 +123,17 @@ void LogViewer::createToolbar()
     m_searchButton->setObjectName("searchButton");
     m_searchButton->setFixedSize(30, 30);
     
+    // 搜索范围：当前内存中的日志或归档的历史日志
+    QLabel* scopeLabel = new QLabel("范围:");
+    scopeLabel->setObjectName("toolLabel");
+    
+    m_scopeCombo = new QComboBox;
+    m_scopeCombo->setObjectName("scopeCombo");
+    m_scopeCombo->addItems({
+        "当前", "最近1小时", "今天", "昨天", "最近7天"
+    });
+    m_scopeCombo->setCurrentIndex(0);
+    
     // 控制按钮
     m_clearButton = new QPushButton("🗑️ 清空");
     m_clearButton->setObjectName("clearButton");
@@ -127,6 +152,8 @@ void LogViewer::createToolbar()
     m_toolbarLayout->addWidget(searchLabel);
     m_toolbarLayout->addWidget(m_searchEdit);
     m_toolbarLayout->addWidget(m_searchButton);
+    m_toolbarLayout->addWidget(scopeLabel);
+    m_toolbarLayout->addWidget(m_scopeCombo);
     m_toolbarLayout->addStretch();
     m_toolbarLayout->addWidget(m_autoScrollCheckBox);
     m_toolbarLayout->addWidget(m_clearButton);
@@ -140,11 +167,19 @@ void LogViewer::createToolbar()
  */
 void LogViewer::createLogDisplay()
 {
-    m_logDisplay = new QTextEdit;
+    m_logModel = new LogListModel(m_maxLogEntries, this);
+    m_archiveModel = new LogListModel(ARCHIVE_RESULT_LIMIT, this);
+    
+    // 行高统一，视图只布局和绘制可见行
+    m_logDisplay = new QListView;
     m_logDisplay->setObjectName("logDisplay");
-    m_logDisplay->setReadOnly(true);
     m_logDisplay->setFont(QFont("Consolas", 9));
-    m_logDisplay->setLineWrapMode(QTextEdit::WidgetWidth);
+    m_logDisplay->setUniformItemSizes(true);
+    m_logDisplay->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logDisplay->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logDisplay->setModel(m_logModel);
+    m_logModel->setBaseFont(m_logDisplay->font());
+    m_archiveModel->setBaseFont(m_logDisplay->font());
     
     // 设置滚动条样式
     m_logDisplay->verticalScrollBar()->setObjectName("logScrollBar");
@@ -187,10 +222,17 @@ void LogViewer::connectSignalsAndSlots()
             this, &LogViewer::applyFilter);
     connect(m_searchEdit, &QLineEdit::returnPressed, this, &LogViewer::searchLogs);
     connect(m_searchButton, &QPushButton::clicked, this, &LogViewer::searchLogs);
+    connect(m_scopeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &LogViewer::searchLogs);
     connect(m_clearButton, &QPushButton::clicked, this, &LogViewer::clearDisplay);
     connect(m_exportButton, &QPushButton::clicked, this, &LogViewer::exportToFile);
     connect(m_autoScrollCheckBox, &QCheckBox::toggled, this, &LogViewer::toggleAutoScroll);
     
+    // 搜索进度
+    connect(m_logModel, &LogListModel::searchProgress, this, &LogViewer::onSearchProgress);
+    connect(m_archiveSearchWatcher, &QFutureWatcher<QVector<LogEntry>>::finished,
+            this, &LogViewer::onArchiveSearchFinished);
+    
     // 定时器
     connect(m_refreshTimer, &QTimer::timeout, this, &LogViewer::refreshDisplay);
 }
@@ -236,7 +278,8 @@ void LogViewer::setupCyberpunkStyle()
         }
         
         /* 下拉框样式 */
-        QComboBox#levelFilterCombo {
+        QComboBox#levelFilterCombo,
+        QComboBox#scopeCombo {
             background: rgba(0, 0, 0, 150);
             border: 2px solid #0096FF;
             border-radius: 4px;
@@ -246,17 +289,20 @@ void LogViewer::setupCyberpunkStyle()
             min-width: 80px;
         }
         
-        QComboBox#levelFilterCombo:focus {
+        QComboBox#levelFilterCombo:focus,
+        QComboBox#scopeCombo:focus {
             border: 2px solid #00FFAA;
         }
         
-        QComboBox#levelFilterCombo::drop-down {
+        QComboBox#levelFilterCombo::drop-down,
+        QComboBox#scopeCombo::drop-down {
             background: #0096FF;
             border: none;
             width: 20px;
         }
         
-        QComboBox#levelFilterCombo QAbstractItemView {
+        QComboBox#levelFilterCombo QAbstractItemView,
+        QComboBox#scopeCombo QAbstractItemView {
             background: rgba(0, 0, 0, 200);
             border: 2px solid #0096FF;
             selection-background-color: #00FFAA;
@@ -342,7 +388,7 @@ void LogViewer::setupCyberpunkStyle()
         }
         
         /* 日志显示区域 */
-        QTextEdit#logDisplay {
+        QListView#logDisplay {
             background: rgba(0, 0, 0, 200);
             border: 2px solid #0096FF;
             border-radius: 6px;
@@ -402,30 +448,9 @@ void LogViewer::setupCyberpunkStyle()
  */
 void LogViewer::addLogEntry(const LogEntry& entry)
 {
-    m_logEntries.append(entry);
-    
-    // 限制日志条目数量
-    while (m_logEntries.size() > m_maxLogEntries) {
-        m_logEntries.removeFirst();
-    }
-    
-    // 更新计数
-    m_countLabel->setText(QString("日志数: %1").arg(m_logEntries.size()));
-    
-    // 应用过滤并显示
-    if (passesFilter(entry)) {
-        m_filteredEntries.append(entry);
-        
-        // 格式化并添加到显示区域
-        applyTextFormat(entry);
-        
-        // 自动滚动到底部
-        if (m_autoScroll) {
-            QTextCursor cursor = m_logDisplay->textCursor();
-            cursor.movePosition(QTextCursor::End);
-            m_logDisplay->setTextCursor(cursor);
-        }
-    }
+    // 先进入缓冲，由定时器批量插入，避免每条日志都触发视图更新
+    m_logModel->enqueue(entry);
+    m_archive->append(entry);
 }
 
 /**
@@ -438,7 +463,14 @@ void LogViewer::applyFilter()
         m_currentFilter = LogLevel::DEBUG; // 全部显示
     }
     
-    refreshDisplay();
+    // 级别索引已预建，切换过滤不重新扫描
+    m_logModel->flush();
+    m_logModel->setMinimumLevel(m_currentFilter);
+    if (m_scopeCombo->currentIndex() > 0) {
+        startArchiveSearch();
+    } else if (m_autoScroll) {
+        m_logDisplay->scrollToBottom();
+    }
     emit filterChanged(m_currentFilter, m_currentKeyword);
 }
 
@@ -448,16 +480,19 @@ void LogViewer::applyFilter()
 void LogViewer::searchLogs()
 {
     m_currentKeyword = m_searchEdit->text();
-    refreshDisplay();
     
-    int matchCount = 0;
-    for (const auto& entry : m_filteredEntries) {
-        if (entry.message.contains(m_currentKeyword, Qt::CaseInsensitive)) {
-            matchCount++;
-        }
+    if (m_scopeCombo->currentIndex() > 0) {
+        startArchiveSearch();
+        return;
     }
+    setDisplayModel(m_logModel);
     
-    m_statusLabel->setText(QString("搜索到 %1 条匹配记录").arg(matchCount));
+    // 关键词非空时在后台线程分批搜索，结果逐批显示
+    m_logModel->flush();
+    m_logModel->setKeyword(m_currentKeyword);
+    if (m_currentKeyword.isEmpty()) {
+        m_statusLabel->setText("就绪");
+    }
 }
 
 /**
@@ -468,9 +503,7 @@ void LogViewer::toggleAutoScroll(bool enabled)
     m_autoScroll = enabled;
     
     if (enabled) {
-        QTextCursor cursor = m_logDisplay->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        m_logDisplay->setTextCursor(cursor);
+        m_logDisplay->scrollToBottom();
     }
 }
 
@@ -479,9 +512,9 @@ void LogViewer::toggleAutoScroll(bool enabled)
  */
 void LogViewer::clearDisplay()
 {
-    m_logDisplay->clear();
-    m_logEntries.clear();
-    m_filteredEntries.clear();
+    // 只清空显示，归档中的历史日志保留
+    m_logModel->clear();
+    m_archiveModel->clear();
     
     m_countLabel->setText("日志数: 0");
     m_statusLabel->setText("日志已清空");
@@ -521,137 +554,119 @@ void LogViewer::exportToFile()
  */
 void LogViewer::refreshDisplay()
 {
-    // 重新应用过滤器
-    m_filteredEntries.clear();
-    m_logDisplay->clear();
-    
-    for (const auto& entry : m_logEntries) {
-        if (passesFilter(entry)) {
-            m_filteredEntries.append(entry);
-            applyTextFormat(entry);
-        }
-    }
-    
-    // 滚动到底部
-    if (m_autoScroll) {
-        QTextCursor cursor = m_logDisplay->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        m_logDisplay->setTextCursor(cursor);
+    // 批量插入缓冲的日志，只通知一次视图
+    const int added = m_logModel->flush();
+    m_archive->flush();
+    m_countLabel->setText(QString("日志数: %1").arg(m_logModel->store().size()));
+    
+    // 显示实时日志且有新行时滚动到底部
+    if (added > 0 && m_autoScroll && m_logDisplay->model() == m_logModel) {
+        m_logDisplay->scrollToBottom();
     }
 }
 
 /**
- * @brief 格式化日志条目
- */
-QString LogViewer::formatLogEntry(const LogEntry& entry)
-{
-    QString timestamp = entry.timestamp.toString("hh:mm:ss.zzz");
-    QString levelName = getLogLevelName(entry.level);
-    QString source = entry.source.isEmpty() ? "System" : entry.source;
-    
-    return QString("[%1] [%2] [%3] %4")
-           .arg(timestamp)
-           .arg(levelName)
-           .arg(source)
-           .arg(entry.message);
-}
-
-/**
- * @brief 获取日志级别颜色
+ * @brief 更新搜索进度
  */
-QColor LogViewer::getLogLevelColor(LogLevel level)
+void LogViewer::onSearchProgress(int scanned, int total, int matches, bool finished)
 {
-    switch (level) {
-        case LogLevel::DEBUG:
-            return QColor(150, 150, 150);  // 灰色
-        case LogLevel::INFO:
-            return QColor(100, 200, 255);  // 浅蓝色
-        case LogLevel::WARNING:
-            return QColor(255, 200, 100);  // 橙色
-        case LogLevel::ERROR:
-            return QColor(255, 100, 100);  // 红色
-        case LogLevel::CRITICAL:
-            return QColor(255, 50, 150);   // 洋红色
-        default:
-            return QColor(255, 255, 255);  // 白色
+    if (finished) {
+        m_statusLabel->setText(QString("搜索到 %1 条匹配记录").arg(matches));
+    } else {
+        m_statusLabel->setText(QString("搜索中 %1/%2，已匹配 %3 条").arg(scanned).arg(total).arg(matches));
     }
 }
 
 /**
- * @brief 获取日志级别名称
+ * @brief 检索历史日志
  */
-QString LogViewer::getLogLevelName(LogLevel level)
+void LogViewer::startArchiveSearch()
 {
-    switch (level) {
-        case LogLevel::DEBUG:
-            return "DEBUG";
-        case LogLevel::INFO:
-            return "INFO ";
-        case LogLevel::WARNING:
-            return "WARN ";
-        case LogLevel::ERROR:
-            return "ERROR";
-        case LogLevel::CRITICAL:
-            return "CRIT ";
+    if (!m_archive->isOpen()) {
+        m_statusLabel->setText("日志归档不可用");
+        return;
+    }
+    
+    // 上一次检索未结束时，结束后按最新条件重新检索
+    if (m_archiveSearchWatcher->isRunning()) {
+        m_archiveSearchPending = true;
+        return;
+    }
+    
+    LogArchive::Query query;
+    query.minimumLevel = m_currentFilter;
+    query.keyword = m_currentKeyword;
+    query.limit = ARCHIVE_RESULT_LIMIT;
+    
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime today(QDate::currentDate(), QTime(0, 0));
+    switch (m_scopeCombo->currentIndex()) {
+        case 1:
+            query.from = now.addSecs(-3600);
+            break;
+        case 2:
+            query.from = today;
+            break;
+        case 3:
+            query.from = today.addDays(-1);
+            query.to = today.addMSecs(-1);
+            break;
         default:
-            return "UNKN ";
+            query.from = now.addDays(-7);
+            break;
     }
+    
+    m_statusLabel->setText("正在检索历史日志...");
+    m_archiveSearchTimer.start();
+    
+    LogArchive* archive = m_archive.get();
+    m_archiveSearchWatcher->setFuture(QtConcurrent::run([archive, query]() {
+        return archive->search(query);
+    }));
 }
 
 /**
- * @brief 应用文本格式
+ * @brief 历史日志检索完成
  */
-void LogViewer::applyTextFormat(const LogEntry& entry)
+void LogViewer::onArchiveSearchFinished()
 {
-    QTextCursor cursor = m_logDisplay->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    
-    QTextCharFormat format;
-    format.setForeground(getLogLevelColor(entry.level));
-    
-    // 关键日志加粗
-    if (entry.level >= LogLevel::ERROR) {
-        format.setFontWeight(QFont::Bold);
+    if (m_archiveSearchPending) {
+        m_archiveSearchPending = false;
+        startArchiveSearch();
+        return;
     }
-    
-    // 搜索高亮
-    QString text = formatLogEntry(entry);
-    if (!m_currentKeyword.isEmpty() && 
-        text.contains(m_currentKeyword, Qt::CaseInsensitive)) {
-        QTextCharFormat highlightFormat = format;
-        highlightFormat.setBackground(QColor(255, 255, 0, 100));
-        
-        // 应用高亮（简化实现）
-        format.setBackground(QColor(255, 255, 0, 50));
+    if (m_scopeCombo->currentIndex() == 0) {
+        return;
     }
     
-    cursor.setCharFormat(format);
-    cursor.insertText(text + "\n");
+    // 结果从新到旧，按时间顺序放入结果模型
+    const QVector<LogEntry> results = m_archiveSearchWatcher->result();
+    m_archiveModel->clear();
+    for (auto it = results.crbegin(); it != results.crend(); ++it) {
+        m_archiveModel->enqueue(*it);
+    }
+    m_archiveModel->flush();
     
-    m_logDisplay->setTextCursor(cursor);
+    setDisplayModel(m_archiveModel);
+    m_logDisplay->scrollToBottom();
+    m_statusLabel->setText(QString("历史日志匹配 %1 条，用时 %2 ms")
+                           .arg(results.size())
+                           .arg(m_archiveSearchTimer.elapsed()));
 }
 
 /**
- * @brief 过滤日志条目
+ * @brief 切换显示的模型
  */
-bool LogViewer::passesFilter(const LogEntry& entry)
+void LogViewer::setDisplayModel(LogListModel* model)
 {
-    // 级别过滤
-    if (m_levelFilterCombo->currentIndex() > 0) {
-        if (entry.level < m_currentFilter) {
-            return false;
-        }
-    }
-    
-    // 关键词过滤
-    if (!m_currentKeyword.isEmpty()) {
-        if (!entry.message.contains(m_currentKeyword, Qt::CaseInsensitive) &&
-            !entry.source.contains(m_currentKeyword, Qt::CaseInsensitive)) {
-            return false;
-        }
+    if (m_logDisplay->model() == model) {
+        return;
     }
     
-    return true;
+    // setModel不会释放旧的选择模型
+    QItemSelectionModel* oldSelection = m_logDisplay->selectionModel();
+    m_logDisplay->setModel(model);
+    delete oldSelection;
 }
 
 /**
@@ -670,12 +685,17 @@ bool LogViewer::exportLogs(const QString& filename)
     // 写入头部信息
     out << "RANOnline EP7 AI System - Log Export\n";
     out << "Export Time: " << QDateTime::currentDateTime().toString() << "\n";
-    out << "Total Entries: " << m_logEntries.size() << "\n";
+    // 显示历史检索结果时导出结果
+    m_logModel->flush();
+    const LogStore& store = m_logDisplay->model() == m_archiveModel
+        ? m_archiveModel->store()
+        : m_logModel->store();
+    out << "Total Entries: " << store.size() << "\n";
     out << "=".repeated(80) << "\n\n";
     
     // 写入日志条目
-    for (const auto& entry : m_logEntries) {
-        out << formatLogEntry(entry) << "\n";
+    for (quint64 sequence = store.firstSequence(); sequence < store.endSequence(); ++sequence) {
+        out << LogListModel::formatEntry(store.at(sequence)) << "\n";
     }
     
     file.close();
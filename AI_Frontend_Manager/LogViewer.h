@@ -11,7 +11,7 @@
 #include <QtWidgets/QWidget>
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QHBoxLayout>
-#include <QtWidgets/QTextEdit>
+#include <QtWidgets/QListView>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QCheckBox>
@@ -22,35 +22,12 @@
 #include <QtCore/QTimer>
 #include <QtCore/QDateTime>
 #include <QtCore/QFileSystemWatcher>
-#include <QtGui/QTextCursor>
-#include <QtGui/QTextCharFormat>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QElapsedTimer>
 #include <memory>
-
-/**
- * @enum LogLevel
- * @brief 日志级别枚举
- */
-enum class LogLevel
-{
-    DEBUG = 0,
-    INFO = 1,
-    WARNING = 2,
-    ERROR = 3,
-    CRITICAL = 4
-};
-
-/**
- * @struct LogEntry
- * @brief 日志条目结构
- */
-struct LogEntry
-{
-    QDateTime timestamp;
-    LogLevel level;
-    QString category;
-    QString message;
-    QString source;
-};
+#include "LogStore.h"
+#include "LogListModel.h"
+#include "LogArchive.h"
 
 /**
  * @class LogViewer
@@ -63,6 +40,8 @@ struct LogEntry
  * 4. 日志导出
  * 5. 自动滚动和暂停
  * 6. 颜色编码显示
+ * 7. 虚拟化列表，只渲染可见行，可容纳百万级日志
+ * 8. 日志持久化归档，可按时间范围检索历史日志
  */
 class LogViewer : public QWidget
 {
@@ -186,9 +165,23 @@ private slots:
     void exportToFile();
     
     /**
-     * @brief 定时刷新显示
+     * @brief 定时刷新显示（批量插入新日志）
      */
     void refreshDisplay();
+    
+    /**
+     * @brief 更新搜索进度
+     * @param scanned 已扫描条数
+     * @param total 需扫描条数
+     * @param matches 匹配行数
+     * @param finished 是否完成
+     */
+    void onSearchProgress(int scanned, int total, int matches, bool finished);
+    
+    /**
+     * @brief 历史日志检索完成
+     */
+    void onArchiveSearchFinished();
 
 private:
     /**
@@ -212,38 +205,18 @@ private:
     void connectSignalsAndSlots();
     
     /**
-     * @brief 格式化日志条目
-     * @param entry 日志条目
-     * @return 格式化后的字符串
-     */
-    QString formatLogEntry(const LogEntry& entry);
-    
-    /**
-     * @brief 获取日志级别颜色
-     * @param level 日志级别
-     * @return 颜色
-     */
-    QColor getLogLevelColor(LogLevel level);
-    
-    /**
-     * @brief 获取日志级别名称
-     * @param level 日志级别
-     * @return 级别名称
-     */
-    QString getLogLevelName(LogLevel level);
-    
-    /**
-     * @brief 应用文本格式
-     * @param entry 日志条目
+     * @brief 在后台线程检索归档的历史日志
      */
-    void applyTextFormat(const LogEntry& entry);
+    void startArchiveSearch();
     
     /**
-     * @brief 过滤日志条目
-     * @param entry 日志条目
-     * @return 是否通过过滤
+     * @brief 切换显示的模型（实时日志或历史检索结果）
+     * @param model 模型
      */
-    bool passesFilter(const LogEntry& entry);
+    void setDisplayModel(LogListModel* model);
+
+private:
+    static constexpr int ARCHIVE_RESULT_LIMIT = 100000;    ///< 历史检索最多显示条数
 
 private:
     // UI组件
@@ -254,22 +227,21 @@ private:
     QComboBox* m_levelFilterCombo;
     QLineEdit* m_searchEdit;
     QPushButton* m_searchButton;
+    QComboBox* m_scopeCombo;
     QPushButton* m_clearButton;
     QPushButton* m_exportButton;
     QCheckBox* m_autoScrollCheckBox;
     
     // 日志显示区域
-    QTextEdit* m_logDisplay;
+    QListView* m_logDisplay;
+    LogListModel* m_logModel;
+    LogListModel* m_archiveModel;
     
     // 状态栏
     QHBoxLayout* m_statusLayout;
     QLabel* m_statusLabel;
     QLabel* m_countLabel;
     
-    // 数据存储
-    QVector<LogEntry> m_logEntries;
-    QVector<LogEntry> m_filteredEntries;
-    
     // 设置
     LogLevel m_currentFilter;
     QString m_currentKeyword;
@@ -281,4 +253,10 @@ private:
     
     // 文件监视器
     QFileSystemWatcher* m_fileWatcher;
+    
+    // 日志归档
+    std::unique_ptr<LogArchive> m_archive;
+    QFutureWatcher<QVector<LogEntry>>* m_archiveSearchWatcher;
+    QElapsedTimer m_archiveSearchTimer;
+    bool m_archiveSearchPending;
 };
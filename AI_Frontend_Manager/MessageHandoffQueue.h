@@ -0,0 +1,97 @@
+/**
+ * @file MessageHandoffQueue.h
+ * @brief RANOnline EP7 AI系统 - 线程间消息交接队列头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 单生产者单消费者无锁链表队列，容量不设上限，生产者永不阻塞
+ * - 入队与出队各只有一次原子读写，无互斥锁、无CAS重试
+ * - 用于I/O线程把解码后的消息交给GUI线程
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @class MessageHandoffQueue
+ * @brief 单生产者单消费者无锁队列
+ *
+ * 队列由哨兵节点起头：生产者只写尾节点的next，消费者只移动头节点。
+ * push()只能由一个线程调用，tryPop()只能由另一个线程调用。
+ *
+ * @tparam T 元素类型（须可默认构造和移动）
+ */
+template<typename T>
+class MessageHandoffQueue
+{
+public:
+    MessageHandoffQueue()
+        : m_head(new Node)
+        , m_tail(m_head)
+    {
+    }
+    
+    ~MessageHandoffQueue()
+    {
+        while (m_head) {
+            Node* next = m_head->next.load(std::memory_order_relaxed);
+            delete m_head;
+            m_head = next;
+        }
+    }
+    
+    MessageHandoffQueue(const MessageHandoffQueue&) = delete;
+    MessageHandoffQueue& operator=(const MessageHandoffQueue&) = delete;
+    
+    /**
+     * @brief 入队（仅生产者线程）
+     */
+    void push(T value)
+    {
+        Node* node = new Node;
+        node->value = std::move(value);
+        // release保证消费者看到next时节点内容已写完
+        m_tail->next.store(node, std::memory_order_release);
+        m_tail = node;
+    }
+    
+    /**
+     * @brief 出队（仅消费者线程）
+     * @param value 输出元素
+     * @return 队列为空时返回false
+     */
+    bool tryPop(T& value)
+    {
+        Node* next = m_head->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        
+        // next成为新的哨兵，旧哨兵由消费者释放
+        value = std::move(next->value);
+        delete m_head;
+        m_head = next;
+        return true;
+    }
+    
+    /**
+     * @brief 队列是否为空（仅消费者线程）
+     */
+    bool isEmpty() const
+    {
+        return m_head->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+    
+    alignas(64) Node* m_head;   // 消费者独占
+    alignas(64) Node* m_tail;   // 生产者独占
+};
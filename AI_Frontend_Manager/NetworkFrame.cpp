@@ -0,0 +1,81 @@
+/**
+ * @file NetworkFrame.cpp
+ * @brief RANOnline EP7 AI系统 - 前端消息帧编解码实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "NetworkFrame.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+
+/**
+ * @brief 编码一帧
+ */
+QByteArray NetworkFrame::encode(quint16 type, const QByteArray& payload, quint32 sequence)
+{
+    QByteArray result;
+    result.reserve(HEADER_SIZE + payload.size());
+
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << MAGIC
+           << VERSION
+           << type
+           << static_cast<quint32>(payload.size())
+           << sequence
+           << static_cast<quint64>(QDateTime::currentMSecsSinceEpoch())
+           << checksum(payload)
+           << quint32(0);
+
+    result.append(payload);
+    return result;
+}
+
+/**
+ * @brief 从缓冲区头部取出一帧
+ */
+NetworkFrame::Status NetworkFrame::decode(QByteArray& buffer, quint16& type, QByteArray& payload)
+{
+    if (buffer.size() < HEADER_SIZE) {
+        return Status::Incomplete;
+    }
+
+    QDataStream stream(buffer.left(HEADER_SIZE));
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 length = 0;
+    quint32 sequence = 0;
+    quint64 timestamp = 0;
+    quint32 expected = 0;
+    stream >> magic >> version >> type >> length >> sequence >> timestamp >> expected;
+
+    // 魔数或长度不可信时后续字节无法对齐，交给调用方丢弃缓冲区
+    if (magic != MAGIC || length > static_cast<quint32>(MAX_PAYLOAD_SIZE)) {
+        return Status::Invalid;
+    }
+
+    if (buffer.size() < HEADER_SIZE + static_cast<int>(length)) {
+        return Status::Incomplete;
+    }
+
+    payload = buffer.mid(HEADER_SIZE, static_cast<int>(length));
+    buffer.remove(0, HEADER_SIZE + static_cast<int>(length));
+
+    return checksum(payload) == expected ? Status::Complete : Status::Corrupt;
+}
+
+/**
+ * @brief 计算负载校验和
+ */
+quint32 NetworkFrame::checksum(const QByteArray& payload)
+{
+    quint32 sum = 0;
+    for (char byte : payload) {
+        sum += static_cast<quint8>(byte);
+    }
+    return sum;
+}
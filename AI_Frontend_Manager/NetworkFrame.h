@@ -0,0 +1,69 @@
+/**
+ * @file NetworkFrame.h
+ * @brief RANOnline EP7 AI系统 - 前端消息帧编解码头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 与后端Message（Protocol.h）使用同一种32字节"RANO"帧头，TCP与共享内存通道通用
+ * - 只依赖QtCore，不引入Protocol.h（两边的MessageType同名）
+ * - 解码时校验魔数、长度上限和校验和，损坏的长度不会让接收缓冲区无限等待
+ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+
+/**
+ * @class NetworkFrame
+ * @brief 消息帧编解码
+ *
+ * 帧头布局（小端）：magic(4) version(2) type(2) length(4) sequence(4)
+ * timestamp(8) checksum(4) reserved(4)，随后是length字节的负载。
+ */
+class NetworkFrame
+{
+public:
+    /**
+     * @enum Status
+     * @brief 解码结果
+     */
+    enum class Status {
+        Complete,       ///< 已取出一帧
+        Incomplete,     ///< 数据不足一帧，等待更多数据
+        Corrupt,        ///< 校验和不符，该帧已移除
+        Invalid         ///< 帧头损坏或长度超限，缓冲区无法继续对齐
+    };
+
+    static constexpr quint32 MAGIC = 0x52414E4F;        ///< "RANO"
+    static constexpr quint16 VERSION = 1;               ///< 协议版本
+    static constexpr int HEADER_SIZE = 32;              ///< 帧头大小
+    static constexpr int MAX_PAYLOAD_SIZE = 1048576;    ///< 负载上限，与后端messages.maxMessageSize默认值一致
+    static constexpr quint16 PING_TYPE = 0x0001;        ///< 后端SYSTEM_PING
+    static constexpr quint16 PONG_TYPE = 0x0002;        ///< 后端SYSTEM_PONG
+
+    /**
+     * @brief 编码一帧
+     * @param type 帧类型
+     * @param payload 负载
+     * @param sequence 序列号（后端应答时原样带回）
+     * @return 帧数据
+     */
+    static QByteArray encode(quint16 type, const QByteArray& payload, quint32 sequence = 0);
+
+    /**
+     * @brief 从缓冲区头部取出一帧，成功时从缓冲区移除该帧
+     * @param buffer 接收缓冲区
+     * @param type 输出帧类型
+     * @param payload 输出负载
+     * @return 解码结果
+     */
+    static Status decode(QByteArray& buffer, quint16& type, QByteArray& payload);
+
+    /**
+     * @brief 计算负载校验和（逐字节累加）
+     */
+    static quint32 checksum(const QByteArray& payload);
+};
@@ -0,0 +1,592 @@
+/**
+ * @file NetworkIoWorker.cpp
+ * @brief RANOnline EP7 AI系统 - 网络I/O工作对象实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "NetworkIoWorker.h"
+#include "NetworkFrame.h"
+#include "SharedMemoryChannel.h"
+#include <QtCore/QDebug>
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonDocument>
+#include <QtNetwork/QHostAddress>
+
+/**
+ * @brief 构造函数
+ */
+NetworkIoWorker::NetworkIoWorker(QObject *parent)
+    : QObject(parent)
+    , m_connectionType(ConnectionType::TCP_SOCKET)
+    , m_serverPort(0)
+    , m_sharedMemoryReading(false)
+    , m_connected(false)
+    , m_reconnecting(false)
+    , m_reconnectAttempts(0)
+    , m_maxReconnectAttempts(MAX_RECONNECT_ATTEMPTS)
+    , m_notifyPending(false)
+    , m_heartbeatTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_queueTimer(new QTimer(this))
+{
+    // 定时器是子对象，随moveToThread一起进入I/O线程
+    m_heartbeatTimer->setInterval(HEARTBEAT_INTERVAL);
+    m_heartbeatTimer->setSingleShot(false);
+    
+    m_reconnectTimer->setInterval(RECONNECT_INTERVAL);
+    m_reconnectTimer->setSingleShot(true);
+    
+    m_queueTimer->setInterval(MESSAGE_QUEUE_INTERVAL);
+    m_queueTimer->setSingleShot(false);
+    
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &NetworkIoWorker::sendHeartbeat);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &NetworkIoWorker::onReconnectTimer);
+    connect(m_queueTimer, &QTimer::timeout, this, &NetworkIoWorker::processMessageQueue);
+}
+
+/**
+ * @brief 析构函数
+ */
+NetworkIoWorker::~NetworkIoWorker()
+{
+    stopSharedMemoryReader();
+}
+
+/**
+ * @brief 设置连接参数并创建连接对象
+ */
+bool NetworkIoWorker::initialize(ConnectionType type, const QString& address, quint16 port)
+{
+    m_connectionType = type;
+    m_serverAddress = address;
+    m_serverPort = port;
+    
+    if (type == ConnectionType::NAMED_PIPE || type == ConnectionType::LOCAL_SOCKET ||
+        type == ConnectionType::SHARED_MEMORY) {
+        m_pipeName = address;
+    }
+    
+    return createConnection();
+}
+
+/**
+ * @brief 连接到后端
+ */
+bool NetworkIoWorker::connectToBackend()
+{
+    if (isConnected()) {
+        return true;
+    }
+    
+    qDebug() << "NetworkIoWorker: 正在连接到后端...";
+    
+    switch (m_connectionType) {
+        case ConnectionType::TCP_SOCKET:
+            if (m_tcpSocket) {
+                m_tcpSocket->connectToHost(QHostAddress(m_serverAddress), m_serverPort);
+                return true;
+            }
+            break;
+            
+        case ConnectionType::LOCAL_SOCKET:
+        case ConnectionType::NAMED_PIPE:
+            if (m_localSocket) {
+                m_localSocket->connectToServer(m_pipeName);
+                return true;
+            }
+            break;
+            
+        case ConnectionType::SHARED_MEMORY:
+            // 共享内存段由后端创建，打开即视为连接成功
+            if (m_sharedMemory && m_sharedMemory->open(m_pipeName.toStdString())) {
+                startSharedMemoryReader();
+                onConnected();
+                return true;
+            }
+            break;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief 断开连接
+ */
+void NetworkIoWorker::disconnectFromBackend()
+{
+    qDebug() << "NetworkIoWorker: 断开连接";
+    
+    m_heartbeatTimer->stop();
+    m_reconnectTimer->stop();
+    
+    if (m_tcpSocket && m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
+        m_tcpSocket->disconnectFromHost();
+    }
+    
+    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
+        m_localSocket->disconnectFromServer();
+    }
+    
+    if (m_sharedMemory && m_sharedMemory->isOpen()) {
+        stopSharedMemoryReader();
+        m_sharedMemory->close();
+    }
+    
+    setConnected(false);
+}
+
+/**
+ * @brief 启动发送队列并连接
+ */
+void NetworkIoWorker::start()
+{
+    m_queueTimer->start();
+    
+    if (!isConnected()) {
+        connectToBackend();
+    }
+}
+
+/**
+ * @brief 停止定时器并断开连接
+ */
+void NetworkIoWorker::stop()
+{
+    m_queueTimer->stop();
+    disconnectFromBackend();
+}
+
+/**
+ * @brief 重新连接
+ */
+void NetworkIoWorker::reconnect()
+{
+    if (m_reconnecting) {
+        return;
+    }
+    
+    qDebug() << "NetworkIoWorker: 开始重连";
+    
+    m_reconnecting = true;
+    m_reconnectAttempts = 0;
+    
+    disconnectFromBackend();
+    m_reconnectTimer->start();
+}
+
+/**
+ * @brief 发送消息
+ */
+void NetworkIoWorker::sendMessage(const NetworkMessage& message)
+{
+    if (!isConnected()) {
+        qDebug() << "NetworkIoWorker: 未连接，将消息加入队列";
+        m_messageQueue.enqueue(message);
+        m_counters.queuedMessages.store(m_messageQueue.size(), std::memory_order_relaxed);
+        return;
+    }
+    
+    writeMessage(message);
+}
+
+/**
+ * @brief 写出一条消息
+ */
+bool NetworkIoWorker::writeMessage(const NetworkMessage& message)
+{
+    QByteArray data = serializeMessage(message);
+    qint64 bytesWritten = 0;
+    
+    switch (m_connectionType) {
+        case ConnectionType::TCP_SOCKET:
+            if (m_tcpSocket) {
+                bytesWritten = m_tcpSocket->write(data);
+                m_tcpSocket->flush();
+            }
+            break;
+            
+        case ConnectionType::LOCAL_SOCKET:
+        case ConnectionType::NAMED_PIPE:
+            if (m_localSocket) {
+                bytesWritten = m_localSocket->write(data);
+                m_localSocket->flush();
+            }
+            break;
+            
+        case ConnectionType::SHARED_MEMORY:
+            if (m_sharedMemory && m_sharedMemory->write(data.constData(), static_cast<size_t>(data.size()))) {
+                bytesWritten = data.size();
+            } else {
+                qDebug() << "NetworkIoWorker: 共享内存发送环已满或已关闭";
+            }
+            break;
+    }
+    
+    if (bytesWritten > 0) {
+        m_counters.totalBytesSent.fetch_add(bytesWritten, std::memory_order_relaxed);
+        m_counters.messagesSent.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief 处理连接成功
+ */
+void NetworkIoWorker::onConnected()
+{
+    qDebug() << "NetworkIoWorker: 连接成功";
+    
+    m_reconnecting = false;
+    m_reconnectAttempts = 0;
+    m_counters.connectTime.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+    setConnected(true);
+    
+    // 启动心跳
+    m_heartbeatTimer->start();
+    
+    // 处理队列中的消息
+    processMessageQueue();
+}
+
+/**
+ * @brief 处理连接断开
+ */
+void NetworkIoWorker::onDisconnected()
+{
+    qDebug() << "NetworkIoWorker: 连接断开";
+    
+    const bool wasConnected = isConnected();
+    m_heartbeatTimer->stop();
+    
+    if (wasConnected) {
+        setConnected(false);
+        
+        // 自动重连
+        if (!m_reconnecting && m_reconnectAttempts < m_maxReconnectAttempts) {
+            reconnect();
+        }
+    }
+}
+
+/**
+ * @brief 处理连接错误
+ */
+void NetworkIoWorker::onError()
+{
+    QString errorString;
+    
+    switch (m_connectionType) {
+        case ConnectionType::TCP_SOCKET:
+            if (m_tcpSocket) {
+                errorString = m_tcpSocket->errorString();
+            }
+            break;
+            
+        case ConnectionType::LOCAL_SOCKET:
+        case ConnectionType::NAMED_PIPE:
+            if (m_localSocket) {
+                errorString = m_localSocket->errorString();
+            }
+            break;
+            
+        case ConnectionType::SHARED_MEMORY:
+            errorString = QStringLiteral("共享内存通道对端已断开");
+            break;
+    }
+    
+    qDebug() << "NetworkIoWorker: 连接错误:" << errorString;
+    emit errorOccurred(errorString);
+    
+    // 尝试重连
+    if (m_reconnectAttempts < m_maxReconnectAttempts) {
+        reconnect();
+    }
+}
+
+/**
+ * @brief 处理数据接收
+ */
+void NetworkIoWorker::onDataReceived()
+{
+    QByteArray newData;
+    
+    switch (m_connectionType) {
+        case ConnectionType::TCP_SOCKET:
+            if (m_tcpSocket) {
+                newData = m_tcpSocket->readAll();
+            }
+            break;
+            
+        case ConnectionType::LOCAL_SOCKET:
+        case ConnectionType::NAMED_PIPE:
+            if (m_localSocket) {
+                newData = m_localSocket->readAll();
+            }
+            break;
+            
+        case ConnectionType::SHARED_MEMORY:
+            // 共享内存数据由读取线程投递到processReceivedData
+            break;
+    }
+    
+    processReceivedData(newData);
+}
+
+/**
+ * @brief 解析接收缓冲区中的完整消息帧
+ */
+void NetworkIoWorker::processReceivedData(const QByteArray& newData)
+{
+    if (newData.isEmpty()) {
+        return;
+    }
+    
+    m_receiveBuffer.append(newData);
+    m_counters.totalBytesReceived.fetch_add(newData.size(), std::memory_order_relaxed);
+    
+    // 处理完整的消息帧
+    bool delivered = false;
+    quint16 frameType = 0;
+    QByteArray payload;
+    for (;;) {
+        NetworkFrame::Status status = NetworkFrame::decode(m_receiveBuffer, frameType, payload);
+        if (status == NetworkFrame::Status::Incomplete) {
+            break;
+        }
+        
+        if (status == NetworkFrame::Status::Invalid) {
+            // 帧头不可信时无法重新对齐，丢弃已缓冲数据而不是按错误长度无限等待
+            qWarning() << "NetworkIoWorker: 收到无效帧头，丢弃" << m_receiveBuffer.size() << "字节";
+            m_receiveBuffer.clear();
+            break;
+        }
+        
+        if (status == NetworkFrame::Status::Corrupt) {
+            qWarning() << "NetworkIoWorker: 帧校验和不符，已丢弃";
+            continue;
+        }
+        
+        m_counters.messagesReceived.fetch_add(1, std::memory_order_relaxed);
+        
+        // 心跳响应在此消化，不打扰GUI线程
+        if (frameType == NetworkFrame::PONG_TYPE || frameType == NetworkFrame::PING_TYPE) {
+            continue;
+        }
+        
+        // 反序列化在I/O线程完成，消息类型以帧头为准
+        NetworkMessage message = deserializeMessage(payload);
+        message.type = static_cast<MessageType>(frameType);
+        
+        m_inbox.push(std::move(message));
+        delivered = true;
+    }
+    
+    // 整批只唤醒一次，GUI确认之前不再重复唤醒
+    if (delivered && !m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit messagesAvailable();
+    }
+}
+
+/**
+ * @brief 发送心跳
+ */
+void NetworkIoWorker::sendHeartbeat()
+{
+    NetworkMessage heartbeat(MessageType::HEARTBEAT);
+    sendMessage(heartbeat);
+}
+
+/**
+ * @brief 处理重连定时器
+ */
+void NetworkIoWorker::onReconnectTimer()
+{
+    if (m_reconnectAttempts >= m_maxReconnectAttempts) {
+        qDebug() << "NetworkIoWorker: 达到最大重连次数，停止重连";
+        m_reconnecting = false;
+        return;
+    }
+    
+    m_reconnectAttempts++;
+    m_counters.reconnectCount.fetch_add(1, std::memory_order_relaxed);
+    
+    qDebug() << QString("NetworkIoWorker: 重连尝试 %1/%2")
+                .arg(m_reconnectAttempts)
+                .arg(m_maxReconnectAttempts);
+    
+    if (connectToBackend()) {
+        // 连接已启动，等待连接结果
+    } else {
+        // 连接失败，继续重连
+        m_reconnectTimer->start();
+    }
+}
+
+/**
+ * @brief 处理消息队列
+ */
+void NetworkIoWorker::processMessageQueue()
+{
+    while (!m_messageQueue.isEmpty() && isConnected()) {
+        writeMessage(m_messageQueue.dequeue());
+    }
+    m_counters.queuedMessages.store(m_messageQueue.size(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief 创建连接对象
+ */
+bool NetworkIoWorker::createConnection()
+{
+    switch (m_connectionType) {
+        case ConnectionType::TCP_SOCKET:
+            m_tcpSocket = std::make_unique<QTcpSocket>(this);
+            
+            connect(m_tcpSocket.get(), &QTcpSocket::connected,
+                    this, &NetworkIoWorker::onConnected);
+            connect(m_tcpSocket.get(), &QTcpSocket::disconnected,
+                    this, &NetworkIoWorker::onDisconnected);
+            connect(m_tcpSocket.get(), QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::error),
+                    this, &NetworkIoWorker::onError);
+            connect(m_tcpSocket.get(), &QTcpSocket::readyRead,
+                    this, &NetworkIoWorker::onDataReceived);
+            
+            return true;
+            
+        case ConnectionType::LOCAL_SOCKET:
+        case ConnectionType::NAMED_PIPE:
+            m_localSocket = std::make_unique<QLocalSocket>(this);
+            
+            connect(m_localSocket.get(), &QLocalSocket::connected,
+                    this, &NetworkIoWorker::onConnected);
+            connect(m_localSocket.get(), &QLocalSocket::disconnected,
+                    this, &NetworkIoWorker::onDisconnected);
+            connect(m_localSocket.get(), QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error),
+                    this, &NetworkIoWorker::onError);
+            connect(m_localSocket.get(), &QLocalSocket::readyRead,
+                    this, &NetworkIoWorker::onDataReceived);
+            
+            return true;
+            
+        case ConnectionType::SHARED_MEMORY:
+            m_sharedMemory = std::make_unique<SharedMemoryChannel>();
+            return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief 启动共享内存读取线程
+ */
+void NetworkIoWorker::startSharedMemoryReader()
+{
+    stopSharedMemoryReader();
+    
+    m_sharedMemoryReading = true;
+    m_sharedMemoryReader = std::thread([this]() {
+        std::vector<uint8_t> record;
+        
+        while (m_sharedMemoryReading) {
+            if (m_sharedMemory->read(record, SHARED_MEMORY_POLL_TIMEOUT)) {
+                // 每条记录即一个完整帧，投递到I/O线程复用Socket通道的解析路径
+                QByteArray frame(reinterpret_cast<const char*>(record.data()),
+                                 static_cast<int>(record.size()));
+                QMetaObject::invokeMethod(this, [this, frame]() {
+                    processReceivedData(frame);
+                }, Qt::QueuedConnection);
+                continue;
+            }
+            
+            if (!m_sharedMemory->isPeerAttached()) {
+                m_sharedMemoryReading = false;
+                QMetaObject::invokeMethod(this, [this]() {
+                    onError();
+                }, Qt::QueuedConnection);
+            }
+        }
+    });
+}
+
+/**
+ * @brief 停止共享内存读取线程
+ */
+void NetworkIoWorker::stopSharedMemoryReader()
+{
+    m_sharedMemoryReading = false;
+    
+    if (m_sharedMemoryReader.joinable()) {
+        if (m_sharedMemory) {
+            m_sharedMemory->interruptRead();
+        }
+        
+        if (m_sharedMemoryReader.get_id() != std::this_thread::get_id()) {
+            m_sharedMemoryReader.join();
+        } else {
+            m_sharedMemoryReader.detach();
+        }
+    }
+}
+
+/**
+ * @brief 序列化消息
+ */
+QByteArray NetworkIoWorker::serializeMessage(const NetworkMessage& message)
+{
+    QJsonObject json;
+    json["type"] = static_cast<int>(message.type);
+    json["timestamp"] = message.timestamp;
+    json["requestId"] = message.requestId;
+    json["data"] = message.data;
+    
+    QJsonDocument doc(json);
+    QByteArray jsonData = doc.toJson(QJsonDocument::Compact);
+    
+    // 与后端Message使用同一种帧头；心跳映射为后端的SYSTEM_PING，由通信层直接应答
+    quint16 frameType = message.type == MessageType::HEARTBEAT
+        ? NetworkFrame::PING_TYPE
+        : static_cast<quint16>(message.type);
+    return NetworkFrame::encode(frameType, jsonData);
+}
+
+/**
+ * @brief 反序列化消息
+ */
+NetworkMessage NetworkIoWorker::deserializeMessage(const QByteArray& data)
+{
+    NetworkMessage message;
+    
+    // 后端的状态通知可以没有负载
+    if (data.isEmpty()) {
+        return message;
+    }
+    
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    
+    if (error.error != QJsonParseError::NoError) {
+        qDebug() << "NetworkIoWorker: JSON解析错误:" << error.errorString();
+        return message;
+    }
+    
+    QJsonObject json = doc.object();
+    message.type = static_cast<MessageType>(json["type"].toInt());
+    message.timestamp = json["timestamp"].toVariant().toLongLong();
+    message.requestId = json["requestId"].toString();
+    message.data = json["data"].toObject();
+    
+    return message;
+}
+
+/**
+ * @brief 更新连接状态并通知
+ */
+void NetworkIoWorker::setConnected(bool connected)
+{
+    m_connected.store(connected, std::memory_order_release);
+    emit connectionStateChanged(connected);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file NetworkIoWorker.h
+ * @brief RANOnline EP7 AI系统 - 网络I/O工作对象头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 运行在独立的I/O线程，Socket读写、分帧、JSON解析、心跳都不占用GUI线程
+ * - 解码后的消息经无锁队列交给GUI线程，每批只唤醒GUI一次
+ * - 统计计数为原子变量，GUI线程可直接读取
+ */
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QQueue>
+#include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QLocalSocket>
+#include "NetworkManager.h"
+#include "MessageHandoffQueue.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+class SharedMemoryChannel;
+
+/**
+ * @class NetworkIoWorker
+ * @brief 网络I/O工作对象
+ *
+ * 由NetworkManager创建并移入I/O线程。除标注"任意线程"的方法外，
+ * 其余公有方法只能在I/O线程中调用（NetworkManager通过invokeMethod投递）。
+ */
+class NetworkIoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Counters
+     * @brief 连接统计（I/O线程写，任意线程读）
+     */
+    struct Counters {
+        std::atomic<qint64> connectTime{0};
+        std::atomic<qint64> totalBytesSent{0};
+        std::atomic<qint64> totalBytesReceived{0};
+        std::atomic<int> messagesSent{0};
+        std::atomic<int> messagesReceived{0};
+        std::atomic<int> reconnectCount{0};
+        std::atomic<int> queuedMessages{0};
+    };
+    
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit NetworkIoWorker(QObject *parent = nullptr);
+    
+    /**
+     * @brief 析构函数
+     */
+    ~NetworkIoWorker();
+    
+    /**
+     * @brief 设置连接参数并创建连接对象
+     * @param type 连接类型
+     * @param address 连接地址
+     * @param port 端口（TCP连接时使用）
+     * @return 是否成功
+     */
+    bool initialize(ConnectionType type, const QString& address, quint16 port);
+    
+    /**
+     * @brief 连接到后端
+     * @return 是否已发起连接
+     */
+    bool connectToBackend();
+    
+    /**
+     * @brief 断开连接
+     */
+    void disconnectFromBackend();
+    
+    /**
+     * @brief 启动发送队列并连接
+     */
+    void start();
+    
+    /**
+     * @brief 停止定时器并断开连接
+     */
+    void stop();
+    
+    /**
+     * @brief 重新连接
+     */
+    void reconnect();
+    
+    /**
+     * @brief 发送消息，未连接时加入发送队列
+     * @param message 消息内容
+     */
+    void sendMessage(const NetworkMessage& message);
+    
+    /**
+     * @brief 是否已连接（任意线程）
+     */
+    bool isConnected() const { return m_connected.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief 连接统计（任意线程）
+     */
+    const Counters& counters() const { return m_counters; }
+    
+    /**
+     * @brief 取出一条已解码消息（仅GUI线程）
+     * @param message 输出消息
+     * @return 没有消息时返回false
+     */
+    bool takeMessage(NetworkMessage& message) { return m_inbox.tryPop(message); }
+    
+    /**
+     * @brief 确认已收到唤醒，之后的新消息会再次发出messagesAvailable（仅GUI线程）
+     */
+    void acknowledgeMessages() { m_notifyPending.store(false, std::memory_order_release); }
+
+signals:
+    /**
+     * @brief 连接状态改变信号
+     * @param connected 是否已连接
+     */
+    void connectionStateChanged(bool connected);
+    
+    /**
+     * @brief 连接错误信号
+     * @param error 错误信息
+     */
+    void errorOccurred(const QString& error);
+    
+    /**
+     * @brief 有新消息可取；在GUI确认前最多发出一次
+     */
+    void messagesAvailable();
+
+private slots:
+    /**
+     * @brief 处理连接成功
+     */
+    void onConnected();
+    
+    /**
+     * @brief 处理连接断开
+     */
+    void onDisconnected();
+    
+    /**
+     * @brief 处理连接错误
+     */
+    void onError();
+    
+    /**
+     * @brief 处理数据接收
+     */
+    void onDataReceived();
+    
+    /**
+     * @brief 发送心跳
+     */
+    void sendHeartbeat();
+    
+    /**
+     * @brief 处理重连定时器
+     */
+    void onReconnectTimer();
+    
+    /**
+     * @brief 处理消息队列
+     */
+    void processMessageQueue();
+
+private:
+    /**
+     * @brief 创建连接对象
+     * @return 是否成功
+     */
+    bool createConnection();
+    
+    /**
+     * @brief 写出一条消息
+     * @return 是否写出
+     */
+    bool writeMessage(const NetworkMessage& message);
+    
+    /**
+     * @brief 序列化消息
+     * @param message 消息对象
+     * @return 序列化后的数据
+     */
+    QByteArray serializeMessage(const NetworkMessage& message);
+    
+    /**
+     * @brief 反序列化消息
+     * @param data 数据
+     * @return 消息对象
+     */
+    NetworkMessage deserializeMessage(const QByteArray& data);
+    
+    /**
+     * @brief 解析接收缓冲区中的完整消息帧
+     * @param newData 新接收的数据
+     */
+    void processReceivedData(const QByteArray& newData);
+    
+    /**
+     * @brief 启动共享内存读取线程
+     */
+    void startSharedMemoryReader();
+    
+    /**
+     * @brief 停止共享内存读取线程
+     */
+    void stopSharedMemoryReader();
+    
+    /**
+     * @brief 更新连接状态并通知
+     */
+    void setConnected(bool connected);
+
+private:
+    // 连接配置
+    ConnectionType m_connectionType;
+    QString m_serverAddress;
+    quint16 m_serverPort;
+    QString m_pipeName;
+    
+    // 连接对象
+    std::unique_ptr<QTcpSocket> m_tcpSocket;
+    std::unique_ptr<QLocalSocket> m_localSocket;
+    std::unique_ptr<SharedMemoryChannel> m_sharedMemory;
+    std::thread m_sharedMemoryReader;            // 共享内存读取线程
+    std::atomic<bool> m_sharedMemoryReading;     // 读取线程运行标志
+    
+    // 状态管理
+    std::atomic<bool> m_connected;
+    bool m_reconnecting;
+    int m_reconnectAttempts;
+    int m_maxReconnectAttempts;
+    
+    // 消息处理
+    QQueue<NetworkMessage> m_messageQueue;       // 未连接时的发送队列
+    QByteArray m_receiveBuffer;
+    MessageHandoffQueue<NetworkMessage> m_inbox; // 交给GUI线程的消息
+    std::atomic<bool> m_notifyPending;           // 已唤醒GUI且尚未确认
+    
+    // 定时器
+    QTimer* m_heartbeatTimer;
+    QTimer* m_reconnectTimer;
+    QTimer* m_queueTimer;
+    
+    Counters m_counters;
+    
+    // 常量
+    static constexpr int HEARTBEAT_INTERVAL = 30000;     // 30秒
+    static constexpr int RECONNECT_INTERVAL = 5000;      // 5秒
+    static constexpr int MAX_RECONNECT_ATTEMPTS = 10;     // 最大重连次数
+    static constexpr int MESSAGE_QUEUE_INTERVAL = 100;   // 消息队列处理间隔
+    static constexpr int SHARED_MEMORY_POLL_TIMEOUT = 200; // 共享内存读取等待（毫秒）
+};
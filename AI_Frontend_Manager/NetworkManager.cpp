@@ -7,11 +7,12 @@
  */
 
 #include "NetworkManager.h"
+#include "NetworkIoWorker.h"
 #include <QtCore/QDebug>
 #include <QtCore/QDateTime>
-#include <QtCore/QUuid>
-#include <QtCore/QJsonDocument>
-#include <QtNetwork/QHostAddress>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <algorithm>
 
 /**
  * @brief 构造函数
@@ -20,28 +21,32 @@ NetworkManager::NetworkManager(QObject *parent)
     : QObject(parent)
     , m_connectionType(ConnectionType::TCP_SOCKET)
     , m_serverPort(0)
-    , m_connected(false)
-    , m_reconnecting(false)
-    , m_reconnectAttempts(0)
-    , m_maxReconnectAttempts(MAX_RECONNECT_ATTEMPTS)
-    , m_heartbeatTimer(new QTimer(this))
-    , m_reconnectTimer(new QTimer(this))
-    , m_queueTimer(new QTimer(this))
+    , m_ioThread(new QThread(this))
+    , m_worker(new NetworkIoWorker)
+    , m_frameTimer(new QTimer(this))
+    , m_requestTimer(new QTimer(this))
+    , m_averageLatency(0.0)
 {
-    // 设置定时器
-    m_heartbeatTimer->setInterval(HEARTBEAT_INTERVAL);
-    m_heartbeatTimer->setSingleShot(false);
+    // 工作对象移入I/O线程，线程结束时在该线程内释放
+    m_ioThread->setObjectName("NetworkIO");
+    m_worker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    
+    // 跨线程信号自动排队到GUI线程
+    connect(m_worker, &NetworkIoWorker::connectionStateChanged, this, &NetworkManager::connectionStateChanged);
+    connect(m_worker, &NetworkIoWorker::errorOccurred, this, &NetworkManager::errorOccurred);
+    connect(m_worker, &NetworkIoWorker::messagesAvailable, this, &NetworkManager::onMessagesAvailable);
     
-    m_reconnectTimer->setInterval(RECONNECT_INTERVAL);
-    m_reconnectTimer->setSingleShot(true);
+    // 设置定时器
+    m_frameTimer->setSingleShot(true);
+    m_requestTimer->setInterval(REQUEST_EXPIRE_INTERVAL);
+    m_requestTimer->setSingleShot(false);
     
-    m_queueTimer->setInterval(MESSAGE_QUEUE_INTERVAL);
-    m_queueTimer->setSingleShot(false);
+    connect(m_frameTimer, &QTimer::timeout, this, &NetworkManager::processFrame);
+    connect(m_requestTimer, &QTimer::timeout, this, &NetworkManager::expirePendingRequests);
     
-    // 连接信号
-    connect(m_heartbeatTimer, &QTimer::timeout, this, &NetworkManager::sendHeartbeat);
-    connect(m_reconnectTimer, &QTimer::timeout, this, &NetworkManager::onReconnectTimer);
-    connect(m_queueTimer, &QTimer::timeout, this, &NetworkManager::processMessageQueue);
+    m_frameClock.start();
+    m_ioThread->start();
 }
 
 /**
@@ -50,6 +55,8 @@ NetworkManager::NetworkManager(QObject *parent)
 NetworkManager::~NetworkManager()
 {
     stop();
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 /**
@@ -61,11 +68,12 @@ bool NetworkManager::initialize(ConnectionType type, const QString& address, qui
     m_serverAddress = address;
     m_serverPort = port;
     
-    if (type == ConnectionType::NAMED_PIPE || type == ConnectionType::LOCAL_SOCKET) {
-        m_pipeName = address;
-    }
-    
-    return createConnection();
+    // 连接对象须在I/O线程中创建
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, [this, type, address, port]() {
+        return m_worker->initialize(type, address, port);
+    }, Qt::BlockingQueuedConnection, &ok);
+    return ok;
 }
 
 /**
@@ -73,30 +81,11 @@ bool NetworkManager::initialize(ConnectionType type, const QString& address, qui
  */
 bool NetworkManager::connectToBackend()
 {
-    if (m_connected) {
-        return true;
-    }
-    
-    qDebug() << "NetworkManager: 正在连接到后端...";
-    
-    switch (m_connectionType) {
-        case ConnectionType::TCP_SOCKET:
-            if (m_tcpSocket) {
-                m_tcpSocket->connectToHost(QHostAddress(m_serverAddress), m_serverPort);
-                return true;
-            }
-            break;
-            
-        case ConnectionType::LOCAL_SOCKET:
-        case ConnectionType::NAMED_PIPE:
-            if (m_localSocket) {
-                m_localSocket->connectToServer(m_pipeName);
-                return true;
-            }
-            break;
-    }
-    
-    return false;
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, [this]() {
+        return m_worker->connectToBackend();
+    }, Qt::BlockingQueuedConnection, &ok);
+    return ok;
 }
 
 /**
@@ -104,21 +93,9 @@ bool NetworkManager::connectToBackend()
  */
 void NetworkManager::disconnectFromBackend()
 {
-    qDebug() << "NetworkManager: 断开连接";
-    
-    m_heartbeatTimer->stop();
-    m_reconnectTimer->stop();
-    
-    if (m_tcpSocket && m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
-        m_tcpSocket->disconnectFromHost();
-    }
-    
-    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->disconnectFromServer();
-    }
-    
-    m_connected = false;
-    emit connectionStateChanged(false);
+    QMetaObject::invokeMethod(m_worker, [this]() {
+        m_worker->disconnectFromBackend();
+    }, Qt::BlockingQueuedConnection);
 }
 
 /**
@@ -126,40 +103,12 @@ void NetworkManager::disconnectFromBackend()
  */
 bool NetworkManager::sendMessage(const NetworkMessage& message)
 {
-    if (!m_connected) {
-        qDebug() << "NetworkManager: 未连接，将消息加入队列";
-        QMutexLocker locker(&m_queueMutex);
-        m_messageQueue.enqueue(message);
-        return false;
-    }
-    
-    QByteArray data = serializeMessage(message);
-    qint64 bytesWritten = 0;
-    
-    switch (m_connectionType) {
-        case ConnectionType::TCP_SOCKET:
-            if (m_tcpSocket) {
-                bytesWritten = m_tcpSocket->write(data);
-                m_tcpSocket->flush();
-            }
-            break;
-            
-        case ConnectionType::LOCAL_SOCKET:
-        case ConnectionType::NAMED_PIPE:
-            if (m_localSocket) {
-                bytesWritten = m_localSocket->write(data);
-                m_localSocket->flush();
-            }
-            break;
-    }
-    
-    if (bytesWritten > 0) {
-        m_stats.totalBytesSent += bytesWritten;
-        m_stats.messagesSent++;
-        return true;
-    }
-    
-    return false;
+    // 序列化和写出都在I/O线程完成，GUI线程只投递
+    const bool connected = m_worker->isConnected();
+    QMetaObject::invokeMethod(m_worker, [this, message]() {
+        m_worker->sendMessage(message);
+    }, Qt::QueuedConnection);
+    return connected;
 }
 
 /**
@@ -167,20 +116,34 @@ bool NetworkManager::sendMessage(const NetworkMessage& message)
  */
 QString NetworkManager::sendAsyncRequest(const NetworkMessage& message)
 {
-    QString requestId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    // 登记请求用于响应匹配，请求ID为64位序列号
+    const qint64 sentAt = QDateTime::currentMSecsSinceEpoch();
+    const uint64_t sequence = m_pendingRequests.nextRequestId();
+    const QString requestId = QString::number(sequence);
+    
+    m_pendingRequests.registerRequestWithId(sequence, std::chrono::milliseconds(ASYNC_REQUEST_TIMEOUT),
+        [this, requestId, sentAt](CorrelationStatus status, NetworkMessage response) {
+            if (status == CorrelationStatus::Completed) {
+                // 计算延迟
+                qint64 latency = QDateTime::currentMSecsSinceEpoch() - sentAt;
+                m_averageLatency = (m_averageLatency + latency) / 2.0;
+                
+                emit asyncResponseReceived(requestId, response);
+            } else if (status == CorrelationStatus::TimedOut) {
+                qDebug() << "NetworkManager: 异步请求超时:" << requestId;
+                emit asyncRequestTimedOut(requestId);
+            }
+        });
     
     NetworkMessage request = message;
     request.requestId = requestId;
-    request.timestamp = QDateTime::currentMSecsSinceEpoch();
-    
-    // 保存请求用于响应匹配
-    m_pendingRequests[requestId] = request;
+    request.timestamp = sentAt;
     
     if (sendMessage(request)) {
         return requestId;
     }
     
-    m_pendingRequests.remove(requestId);
+    m_pendingRequests.cancel(sequence);
     return QString();
 }
 
@@ -189,7 +152,7 @@ QString NetworkManager::sendAsyncRequest(const NetworkMessage& message)
  */
 bool NetworkManager::isConnected() const
 {
-    return m_connected;
+    return m_worker->isConnected();
 }
 
 /**
@@ -197,20 +160,22 @@ bool NetworkManager::isConnected() const
  */
 QJsonObject NetworkManager::getConnectionStats() const
 {
+    const NetworkIoWorker::Counters& counters = m_worker->counters();
+    
     QJsonObject stats;
-    stats["connected"] = m_connected;
+    stats["connected"] = isConnected();
     stats["connectionType"] = static_cast<int>(m_connectionType);
     stats["serverAddress"] = m_serverAddress;
     stats["serverPort"] = m_serverPort;
-    stats["connectTime"] = m_stats.connectTime;
-    stats["totalBytesSent"] = static_cast<qint64>(m_stats.totalBytesSent);
-    stats["totalBytesReceived"] = static_cast<qint64>(m_stats.totalBytesReceived);
-    stats["messagesSent"] = m_stats.messagesSent;
-    stats["messagesReceived"] = m_stats.messagesReceived;
-    stats["reconnectCount"] = m_stats.reconnectCount;
-    stats["averageLatency"] = m_stats.averageLatency;
-    stats["pendingRequests"] = m_pendingRequests.size();
-    stats["queuedMessages"] = m_messageQueue.size();
+    stats["connectTime"] = counters.connectTime.load(std::memory_order_relaxed);
+    stats["totalBytesSent"] = counters.totalBytesSent.load(std::memory_order_relaxed);
+    stats["totalBytesReceived"] = counters.totalBytesReceived.load(std::memory_order_relaxed);
+    stats["messagesSent"] = counters.messagesSent.load(std::memory_order_relaxed);
+    stats["messagesReceived"] = counters.messagesReceived.load(std::memory_order_relaxed);
+    stats["reconnectCount"] = counters.reconnectCount.load(std::memory_order_relaxed);
+    stats["averageLatency"] = m_averageLatency;
+    stats["pendingRequests"] = static_cast<qint64>(m_pendingRequests.size());
+    stats["queuedMessages"] = counters.queuedMessages.load(std::memory_order_relaxed);
     
     return stats;
 }
@@ -222,11 +187,10 @@ void NetworkManager::start()
 {
     qDebug() << "NetworkManager: 启动网络管理器";
     
-    m_queueTimer->start();
-    
-    if (!m_connected) {
-        connectToBackend();
-    }
+    m_requestTimer->start();
+    QMetaObject::invokeMethod(m_worker, [this]() {
+        m_worker->start();
+    }, Qt::QueuedConnection);
 }
 
 /**
@@ -236,8 +200,10 @@ void NetworkManager::stop()
 {
     qDebug() << "NetworkManager: 停止网络管理器";
     
-    m_queueTimer->stop();
-    disconnectFromBackend();
+    m_requestTimer->stop();
+    QMetaObject::invokeMethod(m_worker, [this]() {
+        m_worker->stop();
+    }, Qt::BlockingQueuedConnection);
 }
 
 /**
@@ -245,283 +211,82 @@ void NetworkManager::stop()
  */
 void NetworkManager::reconnect()
 {
-    if (m_reconnecting) {
-        return;
-    }
-    
-    qDebug() << "NetworkManager: 开始重连";
-    
-    m_reconnecting = true;
-    m_reconnectAttempts = 0;
-    
-    disconnectFromBackend();
-    m_reconnectTimer->start();
+    QMetaObject::invokeMethod(m_worker, [this]() {
+        m_worker->reconnect();
+    }, Qt::QueuedConnection);
 }
 
 /**
- * @brief 处理连接成功
+ * @brief I/O线程通知有新消息，安排一帧
  */
-void NetworkManager::onConnected()
+void NetworkManager::onMessagesAvailable()
 {
-    qDebug() << "NetworkManager: 连接成功";
-    
-    m_connected = true;
-    m_reconnecting = false;
-    m_reconnectAttempts = 0;
-    m_stats.connectTime = QDateTime::currentMSecsSinceEpoch();
-    
-    // 启动心跳
-    m_heartbeatTimer->start();
-    
-    // 处理队列中的消息
-    processMessageQueue();
-    
-    emit connectionStateChanged(true);
-}
-
-/**
- * @brief 处理连接断开
- */
-void NetworkManager::onDisconnected()
-{
-    qDebug() << "NetworkManager: 连接断开";
-    
-    bool wasConnected = m_connected;
-    m_connected = false;
-    m_heartbeatTimer->stop();
-    
-    if (wasConnected) {
-        emit connectionStateChanged(false);
-        
-        // 自动重连
-        if (!m_reconnecting && m_reconnectAttempts < m_maxReconnectAttempts) {
-            reconnect();
-        }
+    if (m_frameTimer->isActive()) {
+        return;  // 本帧已安排，届时一并取出
     }
-}
-
-/**
- * @brief 处理连接错误
- */
-void NetworkManager::onError()
-{
-    QString errorString;
     
-    switch (m_connectionType) {
-        case ConnectionType::TCP_SOCKET:
-            if (m_tcpSocket) {
-                errorString = m_tcpSocket->errorString();
-            }
-            break;
-            
-        case ConnectionType::LOCAL_SOCKET:
-        case ConnectionType::NAMED_PIPE:
-            if (m_localSocket) {
-                errorString = m_localSocket->errorString();
-            }
-            break;
-    }
-    
-    qDebug() << "NetworkManager: 连接错误:" << errorString;
-    emit errorOccurred(errorString);
-    
-    // 尝试重连
-    if (m_reconnectAttempts < m_maxReconnectAttempts) {
-        reconnect();
-    }
+    const qint64 wait = std::max<qint64>(0, FRAME_INTERVAL - m_frameClock.elapsed());
+    m_frameTimer->start(static_cast<int>(wait));
 }
 
 /**
- * @brief 处理数据接收
+ * @brief 按帧取出消息并分发
  */
-void NetworkManager::onDataReceived()
+void NetworkManager::processFrame()
 {
-    QByteArray newData;
+    m_frameClock.restart();
     
-    switch (m_connectionType) {
-        case ConnectionType::TCP_SOCKET:
-            if (m_tcpSocket) {
-                newData = m_tcpSocket->readAll();
-            }
-            break;
-            
-        case ConnectionType::LOCAL_SOCKET:
-        case ConnectionType::NAMED_PIPE:
-            if (m_localSocket) {
-                newData = m_localSocket->readAll();
-            }
-            break;
-    }
+    // 先确认再取，取的过程中到达的消息会重新唤醒
+    m_worker->acknowledgeMessages();
     
-    if (newData.isEmpty()) {
-        return;
+    QVector<NetworkMessage> batch;
+    NetworkMessage message;
+    while (batch.size() < MAX_MESSAGES_PER_FRAME && m_worker->takeMessage(message)) {
+        batch.append(std::move(message));
     }
     
-    m_receiveBuffer.append(newData);
-    m_stats.totalBytesReceived += newData.size();
-    
-    // 处理完整的消息
-    while (m_receiveBuffer.size() >= sizeof(qint32)) {
-        // 读取消息长度
-        qint32 messageLength;
-        QDataStream lengthStream(m_receiveBuffer.left(sizeof(qint32)));
-        lengthStream.setByteOrder(QDataStream::LittleEndian);
-        lengthStream >> messageLength;
-        
-        // 检查是否有完整消息
-        if (m_receiveBuffer.size() < sizeof(qint32) + messageLength) {
-            break;
+    // 同一帧内的状态快照只分发最新一条（请求的响应不合并）
+    QHash<int, int> latestSnapshot;
+    for (int i = 0; i < batch.size(); ++i) {
+        if (isSnapshotMessage(batch[i])) {
+            latestSnapshot[static_cast<int>(batch[i].type)] = i;
         }
-        
-        // 提取消息数据
-        QByteArray messageData = m_receiveBuffer.mid(sizeof(qint32), messageLength);
-        m_receiveBuffer.remove(0, sizeof(qint32) + messageLength);
-        
-        // 反序列化消息
-        NetworkMessage message = deserializeMessage(messageData);
-        
-        m_stats.messagesReceived++;
-        handleReceivedMessage(message);
     }
-}
-
-/**
- * @brief 发送心跳
- */
-void NetworkManager::sendHeartbeat()
-{
-    NetworkMessage heartbeat(MessageType::HEARTBEAT);
-    sendMessage(heartbeat);
-}
-
-/**
- * @brief 处理重连定时器
- */
-void NetworkManager::onReconnectTimer()
-{
-    if (m_reconnectAttempts >= m_maxReconnectAttempts) {
-        qDebug() << "NetworkManager: 达到最大重连次数，停止重连";
-        m_reconnecting = false;
-        return;
-    }
-    
-    m_reconnectAttempts++;
-    m_stats.reconnectCount++;
-    
-    qDebug() << QString("NetworkManager: 重连尝试 %1/%2")
-                .arg(m_reconnectAttempts)
-                .arg(m_maxReconnectAttempts);
     
-    if (connectToBackend()) {
-        // 连接已启动，等待连接结果
-    } else {
-        // 连接失败，继续重连
-        m_reconnectTimer->start();
-    }
-}
-
-/**
- * @brief 处理消息队列
- */
-void NetworkManager::processMessageQueue()
-{
-    if (!m_connected || m_messageQueue.isEmpty()) {
-        return;
+    for (int i = 0; i < batch.size(); ++i) {
+        if (isSnapshotMessage(batch[i]) && latestSnapshot.value(static_cast<int>(batch[i].type)) != i) {
+            continue;
+        }
+        handleReceivedMessage(batch[i]);
     }
     
-    QMutexLocker locker(&m_queueMutex);
-    
-    while (!m_messageQueue.isEmpty() && m_connected) {
-        NetworkMessage message = m_messageQueue.dequeue();
-        sendMessage(message);
+    // 超出单帧预算的留到下一帧
+    if (batch.size() == MAX_MESSAGES_PER_FRAME) {
+        m_frameTimer->start(FRAME_INTERVAL);
     }
 }
 
 /**
- * @brief 创建连接对象
+ * @brief 推进请求超时时间轮
  */
-bool NetworkManager::createConnection()
+void NetworkManager::expirePendingRequests()
 {
-    switch (m_connectionType) {
-        case ConnectionType::TCP_SOCKET:
-            m_tcpSocket = std::make_unique<QTcpSocket>(this);
-            
-            connect(m_tcpSocket.get(), &QTcpSocket::connected, 
-                    this, &NetworkManager::onConnected);
-            connect(m_tcpSocket.get(), &QTcpSocket::disconnected, 
-                    this, &NetworkManager::onDisconnected);
-            connect(m_tcpSocket.get(), QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::error),
-                    this, &NetworkManager::onError);
-            connect(m_tcpSocket.get(), &QTcpSocket::readyRead, 
-                    this, &NetworkManager::onDataReceived);
-            
-            return true;
-            
-        case ConnectionType::LOCAL_SOCKET:
-        case ConnectionType::NAMED_PIPE:
-            m_localSocket = std::make_unique<QLocalSocket>(this);
-            
-            connect(m_localSocket.get(), &QLocalSocket::connected, 
-                    this, &NetworkManager::onConnected);
-            connect(m_localSocket.get(), &QLocalSocket::disconnected, 
-                    this, &NetworkManager::onDisconnected);
-            connect(m_localSocket.get(), QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error),
-                    this, &NetworkManager::onError);
-            connect(m_localSocket.get(), &QLocalSocket::readyRead, 
-                    this, &NetworkManager::onDataReceived);
-            
-            return true;
-    }
-    
-    return false;
+    m_pendingRequests.expire();
 }
 
 /**
- * @brief 序列化消息
+ * @brief 是否为可合并的状态快照消息
  */
-QByteArray NetworkManager::serializeMessage(const NetworkMessage& message)
+bool NetworkManager::isSnapshotMessage(const NetworkMessage& message)
 {
-    QJsonObject json;
-    json["type"] = static_cast<int>(message.type);
-    json["timestamp"] = message.timestamp;
-    json["requestId"] = message.requestId;
-    json["data"] = message.data;
-    
-    QJsonDocument doc(json);
-    QByteArray jsonData = doc.toJson(QJsonDocument::Compact);
-    
-    // 添加消息长度前缀
-    QByteArray result;
-    QDataStream stream(&result, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << static_cast<qint32>(jsonData.size());
-    result.append(jsonData);
-    
-    return result;
-}
-
-/**
- * @brief 反序列化消息
- */
-NetworkMessage NetworkManager::deserializeMessage(const QByteArray& data)
-{
-    NetworkMessage message;
-    
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    
-    if (error.error != QJsonParseError::NoError) {
-        qDebug() << "NetworkManager: JSON解析错误:" << error.errorString();
-        return message;
+    // 带请求ID的是对某个请求的响应，必须送达等待者，不参与合并
+    if (!message.requestId.isEmpty()) {
+        return false;
     }
     
-    QJsonObject json = doc.object();
-    message.type = static_cast<MessageType>(json["type"].toInt());
-    message.timestamp = json["timestamp"].toVariant().toLongLong();
-    message.requestId = json["requestId"].toString();
-    message.data = json["data"].toObject();
-    
-    return message;
+    // 性能数据和系统统计由后端周期推送，只关心最新值
+    return message.type == MessageType::PERFORMANCE_DATA ||
+           message.type == MessageType::SYSTEM_STATS;
 }
 
 /**
@@ -529,16 +294,13 @@ NetworkMessage NetworkManager::deserializeMessage(const QByteArray& data)
  */
 void NetworkManager::handleReceivedMessage(const NetworkMessage& message)
 {
-    // 检查是否为异步响应
-    if (!message.requestId.isEmpty() && m_pendingRequests.contains(message.requestId)) {
-        NetworkMessage originalRequest = m_pendingRequests.take(message.requestId);
-        
-        // 计算延迟
-        qint64 latency = message.timestamp - originalRequest.timestamp;
-        m_stats.averageLatency = (m_stats.averageLatency + latency) / 2.0;
-        
-        emit asyncResponseReceived(message.requestId, message);
-        return;
+    // 检查是否为异步响应（回调中发出asyncResponseReceived）
+    if (!message.requestId.isEmpty()) {
+        bool ok = false;
+        uint64_t sequence = message.requestId.toULongLong(&ok);
+        if (ok && m_pendingRequests.complete(sequence, message)) {
+            return;
+        }
     }
     
     // 处理特殊消息类型
@@ -561,12 +323,3 @@ void NetworkManager::handleReceivedMessage(const NetworkMessage& message)
             break;
     }
 }
-
-/**
- * @brief 更新连接统计
- */
-void NetworkManager::updateConnectionStats()
-{
-    // 这里可以添加更多统计信息的更新逻辑
-    // 当前统计信息在其他方法中更新
-}
@@ -10,14 +10,14 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
-#include <QtCore/QQueue>
-#include <QtCore/QMutex>
 #include <QtCore/QThread>
-#include <QtNetwork/QTcpSocket>
-#include <QtNetwork/QLocalSocket>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonDocument>
-#include <memory>
+#include "RequestCorrelator.h"
+
+class NetworkIoWorker;
 
 /**
  * @enum ConnectionType
@@ -27,7 +27,8 @@ enum class ConnectionType
 {
     TCP_SOCKET,     // TCP Socket连接
     NAMED_PIPE,     // Named Pipe连接
-    LOCAL_SOCKET    // Local Socket连接
+    LOCAL_SOCKET,   // Local Socket连接
+    SHARED_MEMORY   // 共享内存连接（同主机部署）
 };
 
 /**
@@ -104,6 +105,11 @@ struct NetworkMessage
  * 4. 自动重连机制
  * 5. 心跳检测
  * 6. 异步消息处理
+ * 
+ * 线程模型: Socket读写、分帧、JSON解析、心跳和发送队列都在独立的I/O线程中
+ * 由NetworkIoWorker完成；解码后的消息经无锁队列交给GUI线程，GUI线程按帧
+ * 批量取出并发出信号，同一帧内的状态快照类消息只发最新一条。
+ * 公有接口和信号都在GUI线程中使用。
  */
 class NetworkManager : public QObject
 {
@@ -142,9 +148,9 @@ public:
     void disconnectFromBackend();
     
     /**
-     * @brief 发送消息
+     * @brief 发送消息，由I/O线程序列化并写出
      * @param message 消息内容
-     * @return 是否成功
+     * @return 已连接时返回true；未连接时消息进入发送队列并返回false
      */
     bool sendMessage(const NetworkMessage& message);
     
@@ -187,6 +193,12 @@ signals:
      */
     void asyncResponseReceived(const QString& requestId, const NetworkMessage& response);
     
+    /**
+     * @brief 异步请求超时信号
+     * @param requestId 请求ID
+     */
+    void asyncRequestTimedOut(const QString& requestId);
+    
     /**
      * @brief 错误信号
      * @param error 错误信息
@@ -217,61 +229,21 @@ public slots:
 
 private slots:
     /**
-     * @brief 处理连接成功
-     */
-    void onConnected();
-    
-    /**
-     * @brief 处理连接断开
-     */
-    void onDisconnected();
-    
-    /**
-     * @brief 处理连接错误
-     */
-    void onError();
-    
-    /**
-     * @brief 处理数据接收
-     */
-    void onDataReceived();
-    
-    /**
-     * @brief 发送心跳
+     * @brief I/O线程通知有新消息，安排一帧
      */
-    void sendHeartbeat();
+    void onMessagesAvailable();
     
     /**
-     * @brief 处理重连定时器
+     * @brief 按帧取出消息并分发
      */
-    void onReconnectTimer();
+    void processFrame();
     
     /**
-     * @brief 处理消息队列
+     * @brief 推进请求超时时间轮
      */
-    void processMessageQueue();
+    void expirePendingRequests();
 
 private:
-    /**
-     * @brief 创建连接对象
-     * @return 是否成功
-     */
-    bool createConnection();
-    
-    /**
-     * @brief 序列化消息
-     * @param message 消息对象
-     * @return 序列化后的数据
-     */
-    QByteArray serializeMessage(const NetworkMessage& message);
-    
-    /**
-     * @brief 反序列化消息
-     * @param data 数据
-     * @return 消息对象
-     */
-    NetworkMessage deserializeMessage(const QByteArray& data);
-    
     /**
      * @brief 处理接收到的消息
      * @param message 消息
@@ -279,52 +251,33 @@ private:
     void handleReceivedMessage(const NetworkMessage& message);
     
     /**
-     * @brief 更新连接统计
+     * @brief 是否为可合并的状态快照消息（主动推送且只关心最新值，带请求ID的响应除外）
      */
-    void updateConnectionStats();
+    static bool isSnapshotMessage(const NetworkMessage& message);
 
 private:
-    // 连接配置
+    // 连接配置（GUI线程副本，供统计使用）
     ConnectionType m_connectionType;
     QString m_serverAddress;
     quint16 m_serverPort;
-    QString m_pipeName;
-    
-    // 连接对象
-    std::unique_ptr<QTcpSocket> m_tcpSocket;
-    std::unique_ptr<QLocalSocket> m_localSocket;
     
-    // 状态管理
-    bool m_connected;
-    bool m_reconnecting;
-    int m_reconnectAttempts;
-    int m_maxReconnectAttempts;
+    // I/O线程
+    QThread* m_ioThread;
+    NetworkIoWorker* m_worker;                   // 归属I/O线程，线程结束时释放
     
     // 消息处理
-    QQueue<NetworkMessage> m_messageQueue;
-    QMap<QString, NetworkMessage> m_pendingRequests;
-    QMutex m_queueMutex;
-    QByteArray m_receiveBuffer;
+    RequestCorrelator<NetworkMessage> m_pendingRequests;  // 异步请求关联表
     
     // 定时器
-    QTimer* m_heartbeatTimer;
-    QTimer* m_reconnectTimer;
-    QTimer* m_queueTimer;
+    QTimer* m_frameTimer;                        // 帧合并
+    QTimer* m_requestTimer;                      // 请求超时
+    QElapsedTimer m_frameClock;
     
-    // 统计信息
-    struct ConnectionStats {
-        qint64 connectTime = 0;
-        qint64 totalBytesSent = 0;
-        qint64 totalBytesReceived = 0;
-        int messagesSent = 0;
-        int messagesReceived = 0;
-        int reconnectCount = 0;
-        double averageLatency = 0.0;
-    } m_stats;
+    double m_averageLatency;
     
     // 常量
-    static constexpr int HEARTBEAT_INTERVAL = 30000;     // 30秒
-    static constexpr int RECONNECT_INTERVAL = 5000;      // 5秒
-    static constexpr int MAX_RECONNECT_ATTEMPTS = 10;     // 最大重连次数
-    static constexpr int MESSAGE_QUEUE_INTERVAL = 100;   // 消息队列处理间隔
+    static constexpr int FRAME_INTERVAL = 16;            // 约60帧/秒
+    static constexpr int MAX_MESSAGES_PER_FRAME = 4096;  // 单帧最多处理的消息数
+    static constexpr int REQUEST_EXPIRE_INTERVAL = 100;  // 请求超时检查间隔
+    static constexpr int ASYNC_REQUEST_TIMEOUT = 30000;  // 异步请求超时（毫秒）
 };
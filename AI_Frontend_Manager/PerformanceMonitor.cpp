@@ -22,6 +22,9 @@ PerformanceMonitor::PerformanceMonitor(QObject *parent)
 #ifdef Q_OS_WIN
     m_processHandle = GetCurrentProcess();
 #endif
+#ifdef Q_OS_LINUX
+    m_linuxCollector = std::make_unique<LinuxMetricsCollector>();
+#endif
     
     qDebug() << "🔍 PerformanceMonitor initialized";
 }
@@ -71,22 +74,87 @@ PerformanceMonitor::AIMetrics PerformanceMonitor::getAIMetrics() const
     return m_currentAIMetrics;
 }
 
-QList<PerformanceMonitor::SystemMetrics> PerformanceMonitor::getSystemHistory(int maxPoints) const
+QList<PerformanceMonitor::ThreadMetrics> PerformanceMonitor::getThreadMetrics() const
 {
+    QList<ThreadMetrics> threads;
+#ifdef Q_OS_LINUX
     QMutexLocker locker(&m_mutex);
-    if (m_systemHistory.size() <= maxPoints) {
-        return m_systemHistory;
+    threads.reserve(m_threadUsageCount);
+    for (int i = 0; i < m_threadUsageCount; ++i) {
+        ThreadMetrics thread;
+        thread.threadId = m_threadUsage[i].threadId;
+        thread.name = QString::fromLocal8Bit(m_threadUsage[i].name);
+        thread.cpuUsage = m_threadUsage[i].cpuUsage;
+        threads.append(thread);
     }
-    return m_systemHistory.mid(m_systemHistory.size() - maxPoints);
+#endif
+    return threads;
+}
+
+QList<PerformanceMonitor::SystemMetrics> PerformanceMonitor::getSystemHistory(int maxPoints) const
+{
+    const QVector<TimeSeriesStore::Point> points = m_systemSeries.latest(TimeSeriesStore::Resolution::Raw, maxPoints);
+    
+    QList<SystemMetrics> history;
+    history.reserve(points.size());
+    for (const auto &point : points) {
+        SystemMetrics metrics;
+        metrics.cpuUsage = point.values[CpuUsageChannel].avg;
+        metrics.memoryUsed = static_cast<quint64>(point.values[MemoryUsedChannel].avg);
+        metrics.memoryTotal = static_cast<quint64>(point.values[MemoryTotalChannel].avg);
+        metrics.memoryUsagePercent = point.values[MemoryUsagePercentChannel].avg;
+        metrics.networkBytesReceived = static_cast<quint64>(point.values[NetworkReceivedChannel].avg);
+        metrics.networkBytesSent = static_cast<quint64>(point.values[NetworkSentChannel].avg);
+        metrics.diskUsage = point.values[DiskUsageChannel].avg;
+        metrics.activeConnections = static_cast<int>(point.values[ActiveConnectionsChannel].avg);
+        metrics.processCpuUsage = point.values[ProcessCpuUsageChannel].avg;
+        metrics.processMemoryUsage = static_cast<quint64>(point.values[ProcessMemoryUsageChannel].avg);
+        metrics.nicBytesReceived = static_cast<quint64>(point.values[NicReceivedChannel].avg);
+        metrics.nicBytesSent = static_cast<quint64>(point.values[NicSentChannel].avg);
+        history.append(metrics);
+    }
+    return history;
 }
 
 QList<PerformanceMonitor::AIMetrics> PerformanceMonitor::getAIHistory(int maxPoints) const
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_aiHistory.size() <= maxPoints) {
-        return m_aiHistory;
+    const QVector<TimeSeriesStore::Point> points = m_aiSeries.latest(TimeSeriesStore::Resolution::Raw, maxPoints);
+    
+    QList<AIMetrics> history;
+    history.reserve(points.size());
+    for (const auto &point : points) {
+        AIMetrics metrics;
+        metrics.activeAIs = static_cast<int>(point.values[ActiveAIsChannel].avg);
+        metrics.totalRequests = static_cast<int>(point.values[TotalRequestsChannel].avg);
+        metrics.averageResponseTime = point.values[AverageResponseTimeChannel].avg;
+        metrics.successfulRequests = static_cast<int>(point.values[SuccessfulRequestsChannel].avg);
+        metrics.failedRequests = static_cast<int>(point.values[FailedRequestsChannel].avg);
+        metrics.requestsPerSecond = point.values[RequestsPerSecondChannel].avg;
+        metrics.aiCpuUsage = point.values[AICpuUsageChannel].avg;
+        metrics.aiMemoryUsage = static_cast<quint64>(point.values[AIMemoryUsageChannel].avg);
+        history.append(metrics);
     }
-    return m_aiHistory.mid(m_aiHistory.size() - maxPoints);
+    return history;
+}
+
+QVector<TimeSeriesStore::Point> PerformanceMonitor::getSystemSeries(qint64 fromMs, qint64 toMs, int maxPoints) const
+{
+    return m_systemSeries.range(m_systemSeries.resolutionFor(toMs - fromMs), fromMs, toMs, maxPoints);
+}
+
+QVector<TimeSeriesStore::Point> PerformanceMonitor::getAISeries(qint64 fromMs, qint64 toMs, int maxPoints) const
+{
+    return m_aiSeries.range(m_aiSeries.resolutionFor(toMs - fromMs), fromMs, toMs, maxPoints);
+}
+
+const TimeSeriesStore &PerformanceMonitor::systemSeries() const
+{
+    return m_systemSeries;
+}
+
+const TimeSeriesStore &PerformanceMonitor::aiSeries() const
+{
+    return m_aiSeries;
 }
 
 void PerformanceMonitor::setWarningThresholds(double cpuThreshold, double memoryThreshold)
@@ -128,10 +196,23 @@ void PerformanceMonitor::updateNetworkMetrics(quint64 bytesReceived, quint64 byt
     m_currentSystemMetrics.networkBytesSent += bytesSent;
 }
 
+void PerformanceMonitor::updateEngineMetrics(double cpuUsage, quint64 memoryUsage)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    m_currentAIMetrics.aiCpuUsage = cpuUsage;
+    m_currentAIMetrics.aiMemoryUsage = memoryUsage;
+}
+
 void PerformanceMonitor::updateMetrics()
 {
     SystemMetrics newMetrics;
     
+#ifdef Q_OS_LINUX
+    // 一次读取所有/proc数据，下面的各项指标都取自本次采样
+    m_linuxCollector->sample();
+#endif
+    
     // 收集系统指标
     newMetrics.cpuUsage = getCpuUsage();
     getMemoryUsage(newMetrics.memoryUsed, newMetrics.memoryTotal);
@@ -139,27 +220,56 @@ void PerformanceMonitor::updateMetrics()
         newMetrics.memoryUsagePercent = (static_cast<double>(newMetrics.memoryUsed) / newMetrics.memoryTotal) * 100.0;
     }
     newMetrics.diskUsage = getDiskUsage();
-    getNetworkStats(newMetrics.networkBytesReceived, newMetrics.networkBytesSent);
+    getNicStats(newMetrics.nicBytesReceived, newMetrics.nicBytesSent);
+    getProcessUsage(newMetrics.processCpuUsage, newMetrics.processMemoryUsage);
     
+    AIMetrics aiMetrics;
     {
         QMutexLocker locker(&m_mutex);
         
-        // 更新当前指标
+        // 更新当前指标 (应用流量由updateNetworkMetrics累计，采样不覆盖)
+        newMetrics.networkBytesReceived = m_currentSystemMetrics.networkBytesReceived;
+        newMetrics.networkBytesSent = m_currentSystemMetrics.networkBytesSent;
         m_currentSystemMetrics = newMetrics;
-        
-        // 添加到历史记录
-        m_systemHistory.append(newMetrics);
-        if (m_systemHistory.size() > 1000) { // 保持最近1000个数据点
-            m_systemHistory.removeFirst();
-        }
-        
-        // 更新AI指标历史
-        m_aiHistory.append(m_currentAIMetrics);
-        if (m_aiHistory.size() > 1000) {
-            m_aiHistory.removeFirst();
+#ifdef Q_OS_LINUX
+        m_threadUsageCount = m_linuxCollector->threadCount();
+        for (int i = 0; i < m_threadUsageCount; ++i) {
+            m_threadUsage[i] = m_linuxCollector->threadUsage(i);
         }
+#endif
+        aiMetrics = m_currentAIMetrics;
     }
     
+    // 添加到历史记录 (时序存储单写者，读取方不加锁)
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const double systemValues[SystemChannelCount] = {
+        newMetrics.cpuUsage,
+        static_cast<double>(newMetrics.memoryUsed),
+        static_cast<double>(newMetrics.memoryTotal),
+        newMetrics.memoryUsagePercent,
+        static_cast<double>(newMetrics.networkBytesReceived),
+        static_cast<double>(newMetrics.networkBytesSent),
+        newMetrics.diskUsage,
+        static_cast<double>(newMetrics.activeConnections),
+        newMetrics.processCpuUsage,
+        static_cast<double>(newMetrics.processMemoryUsage),
+        static_cast<double>(newMetrics.nicBytesReceived),
+        static_cast<double>(newMetrics.nicBytesSent)
+    };
+    m_systemSeries.append(now, systemValues);
+    
+    const double aiValues[AIChannelCount] = {
+        static_cast<double>(aiMetrics.activeAIs),
+        static_cast<double>(aiMetrics.totalRequests),
+        aiMetrics.averageResponseTime,
+        static_cast<double>(aiMetrics.successfulRequests),
+        static_cast<double>(aiMetrics.failedRequests),
+        aiMetrics.requestsPerSecond,
+        aiMetrics.aiCpuUsage,
+        static_cast<double>(aiMetrics.aiMemoryUsage)
+    };
+    m_aiSeries.append(now, aiValues);
+    
     // 检查阈值警告
     if (newMetrics.cpuUsage > m_cpuCriticalThreshold) {
         emit performanceCritical(QString("CPU使用率过高: %1%").arg(newMetrics.cpuUsage, 0, 'f', 1));
@@ -196,39 +306,10 @@ double PerformanceMonitor::getCpuUsage()
     PdhGetFormattedCounterValue(cpuTotal, PDH_FMT_DOUBLE, NULL, &counterVal);
     
     return counterVal.doubleValue;
+#elif defined(Q_OS_LINUX)
+    return m_linuxCollector->systemCpuUsage();
 #else
-    // Linux/Mac实现
-    static QFile statFile("/proc/stat");
-    static quint64 lastIdle = 0, lastTotal = 0;
-    
-    if (!statFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return 0.0;
-    }
-    
-    QString line = statFile.readLine();
-    statFile.close();
-    
-    QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-    if (parts.size() < 8) return 0.0;
-    
-    quint64 user = parts[1].toULongLong();
-    quint64 nice = parts[2].toULongLong();
-    quint64 system = parts[3].toULongLong();
-    quint64 idle = parts[4].toULongLong();
-    
-    quint64 total = user + nice + system + idle;
-    quint64 totalDiff = total - lastTotal;
-    quint64 idleDiff = idle - lastIdle;
-    
-    double cpuUsage = 0.0;
-    if (totalDiff > 0) {
-        cpuUsage = ((totalDiff - idleDiff) * 100.0) / totalDiff;
-    }
-    
-    lastTotal = total;
-    lastIdle = idle;
-    
-    return cpuUsage;
+    return 0.0;
 #endif
 }
 
@@ -241,26 +322,11 @@ void PerformanceMonitor::getMemoryUsage(quint64 &used, quint64 &total)
     
     total = memInfo.ullTotalPhys;
     used = total - memInfo.ullAvailPhys;
+#elif defined(Q_OS_LINUX)
+    total = m_linuxCollector->memoryTotal();
+    used = m_linuxCollector->memoryUsed();
 #else
-    // Linux实现
-    QFile meminfoFile("/proc/meminfo");
-    if (!meminfoFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        used = total = 0;
-        return;
-    }
-    
-    quint64 memTotal = 0, memAvailable = 0;
-    while (!meminfoFile.atEnd()) {
-        QString line = meminfoFile.readLine();
-        if (line.startsWith("MemTotal:")) {
-            memTotal = line.split(' ', Qt::SkipEmptyParts)[1].toULongLong() * 1024;
-        } else if (line.startsWith("MemAvailable:")) {
-            memAvailable = line.split(' ', Qt::SkipEmptyParts)[1].toULongLong() * 1024;
-        }
-    }
-    
-    total = memTotal;
-    used = memTotal - memAvailable;
+    used = total = 0;
 #endif
 }
 
@@ -272,16 +338,33 @@ double PerformanceMonitor::getDiskUsage()
         double usedBytes = totalNumberOfBytes.QuadPart - freeBytesAvailable.QuadPart;
         return (usedBytes / totalNumberOfBytes.QuadPart) * 100.0;
     }
+#elif defined(Q_OS_LINUX)
+    return m_linuxCollector->diskUsage();
 #endif
     return 0.0;
 }
 
-void PerformanceMonitor::getNetworkStats(quint64 &received, quint64 &sent)
+void PerformanceMonitor::getNicStats(quint64 &received, quint64 &sent)
 {
-    // 这里可以实现网络统计收集
-    // 暂时使用累积值
-    received = m_currentSystemMetrics.networkBytesReceived;
-    sent = m_currentSystemMetrics.networkBytesSent;
+#ifdef Q_OS_LINUX
+    // 网卡收发字节数 (不含lo)，从监控器创建时起累计
+    received = m_linuxCollector->networkBytesReceived();
+    sent = m_linuxCollector->networkBytesSent();
+#else
+    received = sent = 0;
+#endif
+}
+
+void PerformanceMonitor::getProcessUsage(double &cpuUsage, quint64 &memoryUsage)
+{
+#ifdef Q_OS_LINUX
+    // 本进程 (前端) 的占用，AI引擎的占用由后端通过updateEngineMetrics上报
+    cpuUsage = m_linuxCollector->processCpuUsage();
+    memoryUsage = m_linuxCollector->processResidentMemory();
+#else
+    cpuUsage = 0.0;
+    memoryUsage = 0;
+#endif
 }
 
 #include "PerformanceMonitor.moc"
@@ -7,17 +7,19 @@
 #include <QThread>
 #include <atomic>
 #include <memory>
+#include "TimeSeriesStore.h"
+#include "LinuxMetricsCollector.h"
 
 /**
  * @brief 性能监控器 - 实时监控系统性能指标
  * 
  * 功能特性:
- * - CPU使用率监控
+ * - CPU使用率监控 (Linux下含进程和各线程CPU)
  * - 内存使用统计
  * - 网络流量监控
  * - AI引擎性能指标
  * - 实时数据更新
- * - 历史数据记录
+ * - 历史数据记录 (定长多分辨率时序存储，最长24小时，读取不阻塞采样)
  */
 class PerformanceMonitor : public QObject
 {
@@ -29,10 +31,14 @@ public:
         quint64 memoryUsed = 0;         // 内存使用量 (字节)
         quint64 memoryTotal = 0;        // 总内存 (字节)
         double memoryUsagePercent = 0.0; // 内存使用率 (0-100)
-        quint64 networkBytesReceived = 0; // 网络接收字节数
-        quint64 networkBytesSent = 0;    // 网络发送字节数
+        quint64 networkBytesReceived = 0; // 网络接收字节数 (updateNetworkMetrics累计的应用流量)
+        quint64 networkBytesSent = 0;    // 网络发送字节数 (updateNetworkMetrics累计的应用流量)
         double diskUsage = 0.0;         // 磁盘使用率 (0-100)
         int activeConnections = 0;      // 活跃连接数
+        double processCpuUsage = 0.0;   // 本进程CPU使用率 (0-100，仅Linux)
+        quint64 processMemoryUsage = 0; // 本进程常驻内存 (字节，仅Linux)
+        quint64 nicBytesReceived = 0;   // 网卡接收字节数 (不含lo，监控器创建以来，仅Linux)
+        quint64 nicBytesSent = 0;       // 网卡发送字节数 (不含lo，监控器创建以来，仅Linux)
     };
 
     struct AIMetrics {
@@ -42,8 +48,43 @@ public:
         int successfulRequests = 0;     // 成功请求数
         int failedRequests = 0;         // 失败请求数
         double requestsPerSecond = 0.0; // 每秒请求数
-        double aiCpuUsage = 0.0;        // AI引擎CPU使用率
-        quint64 aiMemoryUsage = 0;      // AI引擎内存使用量
+        double aiCpuUsage = 0.0;        // AI引擎工作线程CPU使用率 (后端上报)
+        quint64 aiMemoryUsage = 0;      // AI引擎内存使用量 (后端上报)
+    };
+
+    struct ThreadMetrics {
+        int threadId = 0;               // 线程ID
+        QString name;                   // 线程名
+        double cpuUsage = 0.0;          // CPU使用率 (单核百分比)
+    };
+
+    // 时序存储中的通道
+    enum SystemChannel {
+        CpuUsageChannel,
+        MemoryUsedChannel,
+        MemoryTotalChannel,
+        MemoryUsagePercentChannel,
+        NetworkReceivedChannel,
+        NetworkSentChannel,
+        DiskUsageChannel,
+        ActiveConnectionsChannel,
+        ProcessCpuUsageChannel,
+        ProcessMemoryUsageChannel,
+        NicReceivedChannel,
+        NicSentChannel,
+        SystemChannelCount
+    };
+
+    enum AIChannel {
+        ActiveAIsChannel,
+        TotalRequestsChannel,
+        AverageResponseTimeChannel,
+        SuccessfulRequestsChannel,
+        FailedRequestsChannel,
+        RequestsPerSecondChannel,
+        AICpuUsageChannel,
+        AIMemoryUsageChannel,
+        AIChannelCount
     };
 
     explicit PerformanceMonitor(QObject *parent = nullptr);
@@ -57,11 +98,18 @@ public:
     // 获取实时指标
     SystemMetrics getSystemMetrics() const;
     AIMetrics getAIMetrics() const;
+    QList<ThreadMetrics> getThreadMetrics() const; // 各线程CPU (仅Linux)
 
     // 历史数据
     QList<SystemMetrics> getSystemHistory(int maxPoints = 100) const;
     QList<AIMetrics> getAIHistory(int maxPoints = 100) const;
 
+    // 按时间范围查询 (按跨度自动选择1秒/10秒/1分钟汇总，值含最小/最大/平均)
+    QVector<TimeSeriesStore::Point> getSystemSeries(qint64 fromMs, qint64 toMs, int maxPoints = -1) const;
+    QVector<TimeSeriesStore::Point> getAISeries(qint64 fromMs, qint64 toMs, int maxPoints = -1) const;
+    const TimeSeriesStore &systemSeries() const;
+    const TimeSeriesStore &aiSeries() const;
+
     // 性能阈值设置
     void setWarningThresholds(double cpuThreshold, double memoryThreshold);
     void setCriticalThresholds(double cpuThreshold, double memoryThreshold);
@@ -70,6 +118,8 @@ public slots:
     // 更新AI指标
     void updateAIMetrics(int activeAIs, double responseTime, int requests);
     void updateNetworkMetrics(quint64 bytesReceived, quint64 bytesSent);
+    // 更新后端上报的AI引擎资源占用 (工作线程CPU、引擎内存)
+    void updateEngineMetrics(double cpuUsage, quint64 memoryUsage);
 
 signals:
     // 指标更新信号
@@ -88,7 +138,8 @@ private:
     double getCpuUsage();
     void getMemoryUsage(quint64 &used, quint64 &total);
     double getDiskUsage();
-    void getNetworkStats(quint64 &received, quint64 &sent);
+    void getNicStats(quint64 &received, quint64 &sent);
+    void getProcessUsage(double &cpuUsage, quint64 &memoryUsage);
 
     // 数据成员
     QTimer *m_updateTimer;
@@ -97,8 +148,9 @@ private:
     SystemMetrics m_currentSystemMetrics;
     AIMetrics m_currentAIMetrics;
     
-    QList<SystemMetrics> m_systemHistory;
-    QList<AIMetrics> m_aiHistory;
+    // 历史数据 (只在updateMetrics中写入)
+    TimeSeriesStore m_systemSeries{SystemChannelCount};
+    TimeSeriesStore m_aiSeries{AIChannelCount};
     
     // 阈值设置
     double m_cpuWarningThreshold = 80.0;
@@ -117,6 +169,11 @@ private:
     quint64 m_lastCpuTime = 0;
     quint64 m_lastSystemTime = 0;
 #endif
+#ifdef Q_OS_LINUX
+    std::unique_ptr<LinuxMetricsCollector> m_linuxCollector;
+    std::array<LinuxMetricsCollector::ThreadUsage, LinuxMetricsCollector::MAX_THREADS> m_threadUsage; // 最近一次采样的线程CPU
+    int m_threadUsageCount = 0;
+#endif
 };
 
 #endif // PERFORMANCEMONITOR_H
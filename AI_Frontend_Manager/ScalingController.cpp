@@ -0,0 +1,246 @@
+#include "ScalingController.h"
+#include <QStringList>
+#include <cmath>
+
+ScalingController::ScalingController()
+    : ScalingController(Config())
+{
+}
+
+ScalingController::ScalingController(const Config &config)
+    : m_config(config)
+{
+}
+
+void ScalingController::setConfig(const Config &config)
+{
+    m_config = config;
+}
+
+ScalingController::Config ScalingController::config() const
+{
+    return m_config;
+}
+
+ScalingController::Decision ScalingController::observe(const Sample &sample)
+{
+    Decision decision;
+    decision.timestampMs = sample.timestampMs;
+    decision.fromInstances = sample.instances;
+    decision.toInstances = sample.instances;
+    
+    updateForecast(sample);
+    decision.forecastRate = forecastArrivalRate(m_config.forecastHorizonSec);
+    decision.desiredInstances = desiredInstances(sample);
+    
+    const int current = sample.instances;
+    const qint64 now = sample.timestampMs;
+    
+    // 扩容信号：预测负载优先，其次队列积压，再次延迟和CPU
+    Sample withoutQueue = sample;
+    withoutQueue.queueDepth = 0;
+    
+    int target = current;
+    Reason upReason = Reason::None;
+    if (decision.desiredInstances > current) {
+        target = decision.desiredInstances;
+        upReason = desiredInstances(withoutQueue) > current ? Reason::ForecastLoad : Reason::QueueBacklog;
+    } else if (sample.p95LatencyMs > m_config.latencySloMs) {
+        target = current + 1;
+        upReason = Reason::LatencySlo;
+    } else if (sample.cpuUsage > m_config.cpuScaleUpThreshold) {
+        target = current + 1;
+        upReason = Reason::ResourcePressure;
+    }
+    target = qBound(m_config.minInstances, target, m_config.maxInstances);
+    
+    if (upReason != Reason::None && target > current) {
+        m_lowLoadSinceMs = -1;
+        if (m_lastScaleUpMs >= 0 && now - m_lastScaleUpMs < m_config.scaleUpCooldownMs) {
+            return decision; // 扩容冷却中
+        }
+        
+        decision.toInstances = current + qMin(m_config.maxScaleUpStep, target - current);
+        decision.reason = upReason;
+        m_lastScaleUpMs = now;
+        m_lastScaleMs = now;
+        return decision;
+    }
+    
+    // 缩容需同时满足：所需实例数落在滞回区间以下、无积压、延迟和CPU都低
+    const bool lowLoad = current > m_config.minInstances
+        && decision.desiredInstances < current * m_config.scaleDownMargin
+        && sample.queueDepth == 0
+        && sample.p95LatencyMs <= m_config.latencySloMs
+        && sample.cpuUsage < m_config.cpuScaleDownThreshold;
+    
+    if (!lowLoad) {
+        m_lowLoadSinceMs = -1;
+        return decision;
+    }
+    
+    if (m_lowLoadSinceMs < 0) {
+        m_lowLoadSinceMs = now;
+    }
+    
+    const bool stable = now - m_lowLoadSinceMs >= m_config.scaleDownStableMs;
+    const bool cooledDown = m_lastScaleMs < 0 || now - m_lastScaleMs >= m_config.scaleDownCooldownMs;
+    if (stable && cooledDown) {
+        // 每次只缩一个实例，并重新开始计算低负载持续时间
+        decision.toInstances = current - 1;
+        decision.reason = Reason::LowLoad;
+        m_lastScaleMs = now;
+        m_lowLoadSinceMs = now;
+    }
+    
+    return decision;
+}
+
+void ScalingController::reset()
+{
+    m_hasForecast = false;
+    m_level = 0.0;
+    m_trend = 0.0;
+    m_lastSampleMs = 0;
+    m_lastScaleUpMs = -1;
+    m_lastScaleMs = -1;
+    m_lowLoadSinceMs = -1;
+}
+
+double ScalingController::forecastArrivalRate(double horizonSec) const
+{
+    return qMax(0.0, m_level + m_trend * horizonSec);
+}
+
+int ScalingController::desiredInstances(const Sample &sample) const
+{
+    // Little定律：所需并发 = 到达率 × 服务时间；当前处理中的请求数作为下限，积压请求另计
+    const double serviceSec = sample.serviceTimeMs / 1000.0;
+    const double forecast = forecastArrivalRate(m_config.forecastHorizonSec);
+    const double concurrency = qMax(static_cast<double>(sample.inFlight), forecast * serviceSec)
+        + sample.queueDepth;
+    
+    const double perInstance = qMax(1.0, m_config.instanceCapacity * m_config.targetUtilization);
+    return qMax(m_config.minInstances, static_cast<int>(std::ceil(concurrency / perInstance)));
+}
+
+QVector<ScalingController::Decision> ScalingController::replay(const Config &config, const QVector<Sample> &trace)
+{
+    // 轨迹中的负载按录制值输入，实例数以回放中的决策为准
+    ScalingController controller(config);
+    QVector<Decision> decisions;
+    
+    int instances = trace.isEmpty() ? config.minInstances : trace.first().instances;
+    for (Sample sample : trace) {
+        sample.instances = instances;
+        const Decision decision = controller.observe(sample);
+        if (decision.isScaling()) {
+            decisions.append(decision);
+            instances = decision.toInstances;
+        }
+    }
+    
+    return decisions;
+}
+
+QString ScalingController::traceHeader()
+{
+    return "timestamp_ms,instances,queue_depth,in_flight,arrival_rate,p95_ms,service_ms,cpu";
+}
+
+QString ScalingController::toTraceLine(const Sample &sample)
+{
+    return QStringList{
+        QString::number(sample.timestampMs),
+        QString::number(sample.instances),
+        QString::number(sample.queueDepth),
+        QString::number(sample.inFlight),
+        QString::number(sample.arrivalRate, 'f', 3),
+        QString::number(sample.p95LatencyMs, 'f', 3),
+        QString::number(sample.serviceTimeMs, 'f', 3),
+        QString::number(sample.cpuUsage, 'f', 2)
+    }.join(',');
+}
+
+QVector<ScalingController::Sample> ScalingController::parseTrace(const QString &text)
+{
+    QVector<Sample> trace;
+    
+    const QStringList lines = text.split('\n', Qt::SkipEmptyParts);
+    for (const QString &rawLine : lines) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith("timestamp_ms")) {
+            continue;
+        }
+        
+        const QStringList fields = line.split(',');
+        if (fields.size() < 8) {
+            continue;
+        }
+        
+        Sample sample;
+        sample.timestampMs = fields[0].toLongLong();
+        sample.instances = fields[1].toInt();
+        sample.queueDepth = fields[2].toInt();
+        sample.inFlight = fields[3].toInt();
+        sample.arrivalRate = fields[4].toDouble();
+        sample.p95LatencyMs = fields[5].toDouble();
+        sample.serviceTimeMs = fields[6].toDouble();
+        sample.cpuUsage = fields[7].toDouble();
+        trace.append(sample);
+    }
+    
+    return trace;
+}
+
+QString ScalingController::reasonName(Reason reason)
+{
+    switch (reason) {
+    case Reason::None:
+        return "none";
+    case Reason::ForecastLoad:
+        return "forecast-load";
+    case Reason::QueueBacklog:
+        return "queue-backlog";
+    case Reason::LatencySlo:
+        return "latency-slo";
+    case Reason::ResourcePressure:
+        return "resource-pressure";
+    case Reason::LowLoad:
+        return "low-load";
+    }
+    return QString();
+}
+
+QString ScalingController::Decision::description() const
+{
+    return QString("%1: %2 -> %3 instances (forecast %4 req/s, desired %5)")
+        .arg(reasonName(reason))
+        .arg(fromInstances)
+        .arg(toInstances)
+        .arg(forecastRate, 0, 'f', 1)
+        .arg(desiredInstances);
+}
+
+void ScalingController::updateForecast(const Sample &sample)
+{
+    if (!m_hasForecast) {
+        m_level = sample.arrivalRate;
+        m_trend = 0.0;
+        m_lastSampleMs = sample.timestampMs;
+        m_hasForecast = true;
+        return;
+    }
+    
+    const double dt = (sample.timestampMs - m_lastSampleMs) / 1000.0;
+    if (dt <= 0.0) {
+        return;
+    }
+    
+    // Holt线性趋势：采样间隔不固定，趋势按每秒计
+    const double predicted = m_level + m_trend * dt;
+    const double level = m_config.levelAlpha * sample.arrivalRate + (1.0 - m_config.levelAlpha) * predicted;
+    m_trend = m_config.trendBeta * (level - m_level) / dt + (1.0 - m_config.trendBeta) * m_trend;
+    m_level = level;
+    m_lastSampleMs = sample.timestampMs;
+}
@@ -0,0 +1,112 @@
+#ifndef SCALINGCONTROLLER_H
+#define SCALINGCONTROLLER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 预测式扩缩容控制器 - 根据队列深度、到达率和延迟趋势决定实例数
+ *
+ * 功能特性:
+ * - Holt双指数平滑预测到达率，按实例启动时间提前扩容
+ * - 按Little定律把预测到达率换算为所需并发，再换算为实例数
+ * - 队列积压、p95延迟超标、CPU压力作为补充信号
+ * - 扩容快、缩容慢：缩容需低负载持续一段时间，并有独立冷却期
+ * - 不含定时器和随机数，输入相同则决策相同，可用录制的采样轨迹回放
+ */
+class ScalingController
+{
+public:
+    enum class Reason {
+        None,               // 不调整
+        ForecastLoad,       // 预测负载超过当前容量
+        QueueBacklog,       // 队列积压
+        LatencySlo,         // p95延迟超过目标
+        ResourcePressure,   // CPU使用率超过阈值
+        LowLoad             // 持续低负载
+    };
+
+    struct Config {
+        int minInstances = 1;               // 最少实例数
+        int maxInstances = 10;              // 最多实例数
+        int instanceCapacity = 100;         // 单实例并发容量
+        double targetUtilization = 0.7;     // 目标利用率
+        double forecastHorizonSec = 10.0;   // 预测提前量 (约等于实例启动时间)
+        double levelAlpha = 0.5;            // Holt水平平滑系数
+        double trendBeta = 0.3;             // Holt趋势平滑系数
+        double latencySloMs = 500.0;        // p95延迟目标
+        double cpuScaleUpThreshold = 80.0;  // CPU扩容阈值 (%)
+        double cpuScaleDownThreshold = 30.0; // CPU缩容阈值 (%)
+        double scaleDownMargin = 0.8;       // 所需实例数低于当前×系数才算低负载 (滞回区间)
+        int maxScaleUpStep = 4;             // 单次最多扩容实例数
+        int scaleUpCooldownMs = 5000;       // 两次扩容的最小间隔
+        int scaleDownCooldownMs = 60000;    // 任意扩缩容后到下次缩容的最小间隔
+        int scaleDownStableMs = 30000;      // 低负载需持续的时间
+    };
+
+    struct Sample {
+        qint64 timestampMs = 0;             // 采样时间
+        int instances = 0;                  // 当前实例数
+        int queueDepth = 0;                 // 排队请求数
+        int inFlight = 0;                   // 处理中请求数
+        double arrivalRate = 0.0;           // 到达率 (请求/秒)
+        double p95LatencyMs = 0.0;          // 近期p95响应时间
+        double serviceTimeMs = 0.0;         // 平均服务时间 (EWMA)
+        double cpuUsage = 0.0;              // 平均CPU使用率 (%)
+    };
+
+    struct Decision {
+        qint64 timestampMs = 0;             // 决策时间
+        int fromInstances = 0;              // 调整前实例数
+        int toInstances = 0;                // 调整后实例数
+        Reason reason = Reason::None;       // 原因
+        double forecastRate = 0.0;          // 预测到达率
+        int desiredInstances = 0;           // 按负载计算的所需实例数
+
+        bool isScaling() const { return reason != Reason::None && toInstances != fromInstances; }
+        QString description() const;
+    };
+
+    ScalingController();
+    explicit ScalingController(const Config &config);
+
+    // 配置
+    void setConfig(const Config &config);
+    Config config() const;
+
+    // 输入一次采样，返回决策 (reason为None时不调整)
+    Decision observe(const Sample &sample);
+    void reset();
+
+    // 预测
+    double forecastArrivalRate(double horizonSec) const;
+    int desiredInstances(const Sample &sample) const;
+
+    // 回放：按轨迹逐个输入采样，实例数按决策模拟变化
+    static QVector<Decision> replay(const Config &config, const QVector<Sample> &trace);
+
+    // 轨迹格式 (CSV，每行一个采样)
+    static QString traceHeader();
+    static QString toTraceLine(const Sample &sample);
+    static QVector<Sample> parseTrace(const QString &text);
+
+    static QString reasonName(Reason reason);
+
+private:
+    void updateForecast(const Sample &sample);
+
+    Config m_config;
+
+    // Holt预测状态
+    bool m_hasForecast = false;
+    double m_level = 0.0;                   // 到达率水平
+    double m_trend = 0.0;                   // 到达率趋势 (请求/秒²)
+    qint64 m_lastSampleMs = 0;
+
+    // 冷却与滞回状态
+    qint64 m_lastScaleUpMs = -1;
+    qint64 m_lastScaleMs = -1;
+    qint64 m_lowLoadSinceMs = -1;
+};
+
+#endif // SCALINGCONTROLLER_H
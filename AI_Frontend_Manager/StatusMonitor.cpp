@@ -10,6 +10,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QProcess>
 #include <QtWidgets/QApplication>
+#include <algorithm>
 #include <random>
 
 /**
@@ -43,6 +44,12 @@ StatusMonitor::StatusMonitor(QWidget *parent)
     , m_networkSeries(nullptr)
     , m_axisX(nullptr)
     , m_axisY(nullptr)
+    , m_cpuHistory(CHART_WINDOW_POINTS)
+    , m_memoryHistory(CHART_WINDOW_POINTS)
+    , m_networkHistory(CHART_WINDOW_POINTS)
+    , m_renderTimer(new QTimer(this))
+    , m_chartFpsLimit(DEFAULT_CHART_FPS)
+    , m_chartDirty(false)
     , m_connectionGroupBox(nullptr)
     , m_connectionStatusLabel(nullptr)
     , m_lastUpdateLabel(nullptr)
@@ -56,9 +63,13 @@ StatusMonitor::StatusMonitor(QWidget *parent)
     setupCyberpunkStyle();
     connectSignalsAndSlots();
     
+    // 重绘由采样触发，单次定时器保证不超过帧率上限
+    m_renderTimer->setSingleShot(true);
+    m_lastRenderTimer.start();
+    
     // 启动定时器
     m_updateTimer->start(1000);  // 每秒更新状态
-    m_chartTimer->start(2000);   // 每2秒更新图表
+    m_chartTimer->start(CHART_SAMPLE_INTERVAL_MS);
 }
 
 /**
@@ -231,7 +242,7 @@ void StatusMonitor::createPerformanceChartSection()
     
     // 创建坐标轴
     m_axisX = new QValueAxis();
-    m_axisX->setRange(0, 60); // 显示最近60秒
+    m_axisX->setRange(0, CHART_WINDOW_SECONDS);
     m_axisX->setTitleText("时间 (秒)");
     m_axisX->setTitleBrush(QBrush(QColor(255, 255, 255)));
     m_axisX->setLabelsBrush(QBrush(QColor(200, 200, 200)));
@@ -297,6 +308,7 @@ void StatusMonitor::connectSignalsAndSlots()
 {
     connect(m_updateTimer, &QTimer::timeout, this, &StatusMonitor::updateMonitorData);
     connect(m_chartTimer, &QTimer::timeout, this, &StatusMonitor::updatePerformanceChart);
+    connect(m_renderTimer, &QTimer::timeout, this, &StatusMonitor::renderPerformanceChart);
 }
 
 /**
@@ -470,30 +482,88 @@ void StatusMonitor::updateMonitorData()
 }
 
 /**
- * @brief 更新性能图表
+ * @brief 采样性能数据到图表窗口
  */
 void StatusMonitor::updatePerformanceChart()
 {
-    // 添加新的数据点
-    double currentTime = m_dataPoints * 2; // 每2秒一个数据点
-    
-    m_cpuSeries->append(currentTime, m_currentStats.cpuUsage);
-    m_memorySeries->append(currentTime, m_currentStats.memoryUsage);
-    m_networkSeries->append(currentTime, m_currentStats.networkSpeed);
-    
-    // 限制显示的数据点数量（最近30个点，即60秒）
-    if (m_cpuSeries->count() > 30) {
-        m_cpuSeries->remove(0);
-        m_memorySeries->remove(0);
-        m_networkSeries->remove(0);
-        
-        // 调整X轴范围
-        double minX = m_cpuSeries->at(0).x();
-        double maxX = minX + 60;
-        m_axisX->setRange(minX, maxX);
-    }
+    // 窗口容量固定，最旧的点被覆盖，不再逐点增删系列
+    const double currentTime = m_dataPoints * (CHART_SAMPLE_INTERVAL_MS / 1000.0);
+    
+    m_cpuHistory.append(currentTime, m_currentStats.cpuUsage);
+    m_memoryHistory.append(currentTime, m_currentStats.memoryUsage);
+    m_networkHistory.append(currentTime, m_currentStats.networkSpeed);
     
     m_dataPoints++;
+    scheduleChartRender();
+}
+
+/**
+ * @brief 按帧率上限安排一次图表重绘
+ */
+void StatusMonitor::scheduleChartRender()
+{
+    m_chartDirty = true;
+    if (m_renderTimer->isActive()) {
+        return;  // 已安排的重绘会带上本次数据
+    }
+    
+    const qint64 frameInterval = 1000 / m_chartFpsLimit;
+    const qint64 wait = std::max<qint64>(0, frameInterval - m_lastRenderTimer.elapsed());
+    m_renderTimer->start(static_cast<int>(wait));
+}
+
+/**
+ * @brief 抽取窗口数据并整体替换图表系列
+ */
+void StatusMonitor::renderPerformanceChart()
+{
+    // 面板不可见时保留脏标记，显示时再画
+    if (!m_chartDirty || !isVisible() || m_cpuHistory.isEmpty()) {
+        return;
+    }
+    
+    const double maxX = std::max<double>(CHART_WINDOW_SECONDS, m_cpuHistory.at(m_cpuHistory.size() - 1).x());
+    const double minX = maxX - CHART_WINDOW_SECONDS;
+    
+    // 每个像素列最多保留最小、最大两个点
+    const int pixelWidth = std::max(1, static_cast<int>(m_chart->plotArea().width()));
+    m_cpuSeries->replace(m_cpuHistory.decimated(minX, maxX, pixelWidth));
+    m_memorySeries->replace(m_memoryHistory.decimated(minX, maxX, pixelWidth));
+    m_networkSeries->replace(m_networkHistory.decimated(minX, maxX, pixelWidth));
+    m_axisX->setRange(minX, maxX);
+    
+    m_chartDirty = false;
+    m_lastRenderTimer.restart();
+}
+
+/**
+ * @brief 设置图表刷新帧率上限
+ */
+void StatusMonitor::setChartFpsLimit(int fps)
+{
+    m_chartFpsLimit = std::clamp(fps, 1, 60);
+}
+
+/**
+ * @brief 显示时补画隐藏期间积累的数据
+ */
+void StatusMonitor::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    if (m_chartDirty) {
+        scheduleChartRender();
+    }
+}
+
+/**
+ * @brief 尺寸变化后按新的像素宽度重新抽取
+ */
+void StatusMonitor::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    if (!m_cpuHistory.isEmpty()) {
+        scheduleChartRender();
+    }
 }
 
 /**
@@ -23,7 +23,9 @@
 #include <QtCharts/QValueAxis>
 #include <QtCore/QTimer>
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 #include <memory>
+#include "ChartSeriesBuffer.h"
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -84,6 +86,12 @@ public:
      * @param stats 系统统计数据
      */
     void updateSystemStats(const SystemStats& stats);
+    
+    /**
+     * @brief 设置图表刷新帧率上限
+     * @param fps 每秒最多重绘次数
+     */
+    void setChartFpsLimit(int fps);
 
 signals:
     /**
@@ -99,6 +107,17 @@ signals:
      */
     void warningTriggered(const QString& message, int level);
 
+protected:
+    /**
+     * @brief 显示时补画隐藏期间积累的数据
+     */
+    void showEvent(QShowEvent* event) override;
+    
+    /**
+     * @brief 尺寸变化后按新的像素宽度重新抽取
+     */
+    void resizeEvent(QResizeEvent* event) override;
+
 private slots:
     /**
      * @brief 定时更新监控数据
@@ -106,10 +125,15 @@ private slots:
     void updateMonitorData();
     
     /**
-     * @brief 更新性能图表
+     * @brief 采样性能数据到图表窗口
      */
     void updatePerformanceChart();
     
+    /**
+     * @brief 抽取窗口数据并整体替换图表系列
+     */
+    void renderPerformanceChart();
+    
     /**
      * @brief 检查系统警告
      */
@@ -141,6 +165,11 @@ private:
      */
     void connectSignalsAndSlots();
     
+    /**
+     * @brief 按帧率上限安排一次图表重绘
+     */
+    void scheduleChartRender();
+    
     /**
      * @brief 获取系统CPU使用率
      * @return CPU使用率百分比
@@ -193,6 +222,13 @@ private:
     QLineSeries* m_networkSeries;
     QValueAxis* m_axisX;
     QValueAxis* m_axisY;
+    ChartSeriesBuffer m_cpuHistory;
+    ChartSeriesBuffer m_memoryHistory;
+    ChartSeriesBuffer m_networkHistory;
+    QTimer* m_renderTimer;
+    QElapsedTimer m_lastRenderTimer;
+    int m_chartFpsLimit;
+    bool m_chartDirty;
     
     // 连接状态区域
     QGroupBox* m_connectionGroupBox;
@@ -211,4 +247,10 @@ private:
     static constexpr double CPU_WARNING_THRESHOLD = 80.0;
     static constexpr double MEMORY_WARNING_THRESHOLD = 85.0;
     static constexpr int SERVER_LOAD_WARNING_THRESHOLD = 90;
+    
+    // 图表参数
+    static constexpr int CHART_SAMPLE_INTERVAL_MS = 1000;   // 采样间隔
+    static constexpr int CHART_WINDOW_SECONDS = 600;        // 显示最近10分钟
+    static constexpr int CHART_WINDOW_POINTS = CHART_WINDOW_SECONDS * 1000 / CHART_SAMPLE_INTERVAL_MS;
+    static constexpr int DEFAULT_CHART_FPS = 5;
 };
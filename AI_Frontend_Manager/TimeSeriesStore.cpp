@@ -0,0 +1,222 @@
+#include "TimeSeriesStore.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+struct TimeSeriesStore::Level
+{
+    Level(qint64 bucket, int slots, int channels)
+        : bucketMs(bucket)
+        , capacity(qMax(1, slots))
+        , sequence(capacity)
+        , timestamps(capacity)
+        , values(static_cast<size_t>(capacity) * channels * 3)
+        , min(channels)
+        , max(channels)
+        , sum(channels)
+        , avg(channels)
+    {
+    }
+    
+    const qint64 bucketMs;                      // 汇总桶宽度，0表示原始采样
+    const int capacity;
+    
+    // 环形槽位：序列号为奇数表示正在写入
+    std::vector<std::atomic<quint32>> sequence;
+    std::vector<std::atomic<qint64>> timestamps;
+    std::vector<std::atomic<double>> values;    // [槽位][通道][min, max, avg]
+    std::atomic<quint64> written{0};            // 累计写入的点数
+    
+    // 当前汇总桶 (仅写入线程访问)
+    qint64 bucketStartMs = std::numeric_limits<qint64>::min();
+    int samples = 0;
+    std::vector<double> min;
+    std::vector<double> max;
+    std::vector<double> sum;
+    std::vector<double> avg;
+};
+
+TimeSeriesStore::TimeSeriesStore(int channels)
+    : TimeSeriesStore(channels, Capacity())
+{
+}
+
+TimeSeriesStore::TimeSeriesStore(int channels, const Capacity &capacity)
+    : m_channels(qMax(1, channels))
+{
+    m_levels[0] = std::make_unique<Level>(bucketMs(Resolution::Raw), capacity.raw, m_channels);
+    m_levels[1] = std::make_unique<Level>(bucketMs(Resolution::OneSecond), capacity.oneSecond, m_channels);
+    m_levels[2] = std::make_unique<Level>(bucketMs(Resolution::TenSeconds), capacity.tenSeconds, m_channels);
+    m_levels[3] = std::make_unique<Level>(bucketMs(Resolution::OneMinute), capacity.oneMinute, m_channels);
+}
+
+TimeSeriesStore::~TimeSeriesStore() = default;
+
+int TimeSeriesStore::channelCount() const
+{
+    return m_channels;
+}
+
+void TimeSeriesStore::append(qint64 timestampMs, const double *values)
+{
+    writeSlot(*m_levels[0], timestampMs, values, values, values);
+    
+    for (int i = 1; i < LEVEL_COUNT; ++i) {
+        Level &level = *m_levels[i];
+        const qint64 bucketStart = timestampMs - timestampMs % level.bucketMs;
+        
+        // 进入新的时间桶时把上一个桶写入汇总环
+        if (bucketStart != level.bucketStartMs) {
+            flushBucket(level);
+            level.bucketStartMs = bucketStart;
+        }
+        
+        for (int channel = 0; channel < m_channels; ++channel) {
+            const double value = values[channel];
+            if (level.samples == 0) {
+                level.min[channel] = value;
+                level.max[channel] = value;
+                level.sum[channel] = value;
+            } else {
+                level.min[channel] = qMin(level.min[channel], value);
+                level.max[channel] = qMax(level.max[channel], value);
+                level.sum[channel] += value;
+            }
+        }
+        level.samples++;
+    }
+}
+
+QVector<TimeSeriesStore::Point> TimeSeriesStore::range(Resolution resolution, qint64 fromMs, qint64 toMs, int maxPoints) const
+{
+    const Level &level = *m_levels[static_cast<int>(resolution)];
+    QVector<Point> points;
+    
+    const quint64 written = level.written.load(std::memory_order_acquire);
+    const quint64 available = qMin<quint64>(written, level.capacity);
+    const int limit = maxPoints < 0 ? static_cast<int>(available) : qMin(maxPoints, static_cast<int>(available));
+    if (limit == 0) {
+        return points;
+    }
+    points.reserve(limit);
+    
+    // 从最新往回读；时间不再递减说明该槽位已被写入线程覆盖，更早的数据不再可信
+    qint64 previous = std::numeric_limits<qint64>::max();
+    Point point;
+    for (quint64 i = 0; i < available && points.size() < limit; ++i) {
+        const int slot = static_cast<int>((written - 1 - i) % level.capacity);
+        if (!readSlot(level, slot, point) || point.timestampMs >= previous) {
+            break;
+        }
+        previous = point.timestampMs;
+        
+        if (point.timestampMs > toMs) {
+            continue;
+        }
+        if (point.timestampMs < fromMs) {
+            break;
+        }
+        points.append(point);
+    }
+    
+    std::reverse(points.begin(), points.end());
+    return points;
+}
+
+QVector<TimeSeriesStore::Point> TimeSeriesStore::latest(Resolution resolution, int maxPoints) const
+{
+    return range(resolution, std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max(), maxPoints);
+}
+
+int TimeSeriesStore::size(Resolution resolution) const
+{
+    const Level &level = *m_levels[static_cast<int>(resolution)];
+    return static_cast<int>(qMin<quint64>(level.written.load(std::memory_order_acquire), level.capacity));
+}
+
+TimeSeriesStore::Resolution TimeSeriesStore::resolutionFor(qint64 spanMs) const
+{
+    for (Resolution resolution : { Resolution::OneSecond, Resolution::TenSeconds }) {
+        const Level &level = *m_levels[static_cast<int>(resolution)];
+        if (level.bucketMs * level.capacity >= spanMs) {
+            return resolution;
+        }
+    }
+    return Resolution::OneMinute;
+}
+
+qint64 TimeSeriesStore::bucketMs(Resolution resolution)
+{
+    switch (resolution) {
+    case Resolution::Raw:
+        return 0;
+    case Resolution::OneSecond:
+        return 1000;
+    case Resolution::TenSeconds:
+        return 10000;
+    case Resolution::OneMinute:
+        return 60000;
+    }
+    return 0;
+}
+
+void TimeSeriesStore::writeSlot(Level &level, qint64 timestampMs, const double *min, const double *max, const double *avg)
+{
+    const quint64 written = level.written.load(std::memory_order_relaxed);
+    const int slot = static_cast<int>(written % level.capacity);
+    
+    const quint32 sequence = level.sequence[slot].load(std::memory_order_relaxed);
+    level.sequence[slot].store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    level.timestamps[slot].store(timestampMs, std::memory_order_relaxed);
+    std::atomic<double> *values = &level.values[static_cast<size_t>(slot) * m_channels * 3];
+    for (int channel = 0; channel < m_channels; ++channel) {
+        values[channel * 3].store(min[channel], std::memory_order_relaxed);
+        values[channel * 3 + 1].store(max[channel], std::memory_order_relaxed);
+        values[channel * 3 + 2].store(avg[channel], std::memory_order_relaxed);
+    }
+    
+    level.sequence[slot].store(sequence + 2, std::memory_order_release);
+    level.written.store(written + 1, std::memory_order_release);
+}
+
+bool TimeSeriesStore::readSlot(const Level &level, int slot, Point &point) const
+{
+    point.values.resize(m_channels);
+    const std::atomic<double> *values = &level.values[static_cast<size_t>(slot) * m_channels * 3];
+    
+    // 写入只需几十纳秒，读到奇数序列号或前后不一致时重读
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const quint32 before = level.sequence[slot].load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        
+        point.timestampMs = level.timestamps[slot].load(std::memory_order_relaxed);
+        for (int channel = 0; channel < m_channels; ++channel) {
+            point.values[channel].min = values[channel * 3].load(std::memory_order_relaxed);
+            point.values[channel].max = values[channel * 3 + 1].load(std::memory_order_relaxed);
+            point.values[channel].avg = values[channel * 3 + 2].load(std::memory_order_relaxed);
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (level.sequence[slot].load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TimeSeriesStore::flushBucket(Level &level)
+{
+    if (level.samples == 0) {
+        return;
+    }
+    
+    for (int channel = 0; channel < m_channels; ++channel) {
+        level.avg[channel] = level.sum[channel] / level.samples;
+    }
+    writeSlot(level, level.bucketStartMs, level.min.data(), level.max.data(), level.avg.data());
+    level.samples = 0;
+}
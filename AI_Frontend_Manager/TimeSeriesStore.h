@@ -0,0 +1,83 @@
+#ifndef TIMESERIESSTORE_H
+#define TIMESERIESSTORE_H
+
+#include <QVarLengthArray>
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 定长时序存储 - 多分辨率环形缓冲区，内存占用固定
+ *
+ * 功能特性:
+ * - 原始采样环 + 1秒/10秒/1分钟汇总环，每个汇总点保存最小/最大/平均值
+ * - 所有环在构造时分配，追加不分配内存
+ * - 单写者多读者：每个槽位带序列锁，读取不加锁也不阻塞写入
+ * - 按时间范围查询，并可按跨度自动选择分辨率
+ */
+class TimeSeriesStore
+{
+public:
+    enum class Resolution {
+        Raw,            // 原始采样 (采样间隔)
+        OneSecond,      // 1秒汇总
+        TenSeconds,     // 10秒汇总
+        OneMinute       // 1分钟汇总
+    };
+
+    struct Aggregate {
+        double min = 0.0;
+        double max = 0.0;
+        double avg = 0.0;
+    };
+
+    struct Point {
+        qint64 timestampMs = 0;                 // 采样时间或汇总桶起始时间
+        QVarLengthArray<Aggregate, 8> values;   // 各通道的值
+    };
+
+    struct Capacity {
+        int raw = 1000;                         // 原始采样点数
+        int oneSecond = 3600;                   // 1小时
+        int tenSeconds = 2160;                  // 6小时
+        int oneMinute = 1440;                   // 24小时
+    };
+
+    explicit TimeSeriesStore(int channels);
+    TimeSeriesStore(int channels, const Capacity &capacity);
+    ~TimeSeriesStore();
+
+    TimeSeriesStore(const TimeSeriesStore &) = delete;
+    TimeSeriesStore &operator=(const TimeSeriesStore &) = delete;
+
+    int channelCount() const;
+
+    // 写入 (只能由一个线程调用)；values须有channelCount()个元素，时间须单调递增
+    void append(qint64 timestampMs, const double *values);
+
+    // 读取 (任意线程)；按时间升序返回[fromMs, toMs]内最新的最多maxPoints个点
+    // 汇总点在其时间桶结束后才可见
+    QVector<Point> range(Resolution resolution, qint64 fromMs, qint64 toMs, int maxPoints = -1) const;
+    QVector<Point> latest(Resolution resolution, int maxPoints) const;
+    int size(Resolution resolution) const;
+
+    // 能覆盖给定时间跨度的最细汇总分辨率
+    Resolution resolutionFor(qint64 spanMs) const;
+    static qint64 bucketMs(Resolution resolution);
+
+private:
+    struct Level;
+
+    void writeSlot(Level &level, qint64 timestampMs, const double *min, const double *max, const double *avg);
+    bool readSlot(const Level &level, int slot, Point &point) const;
+    void flushBucket(Level &level);
+
+    static constexpr int LEVEL_COUNT = 4;
+
+    const int m_channels;
+    std::array<std::unique_ptr<Level>, LEVEL_COUNT> m_levels;
+};
+
+#endif // TIMESERIESSTORE_H
@@ -14,6 +14,7 @@
 #include <QtGui/QIcon>
 #include <QtGui/QPixmap>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <iostream>
 #include <memory>
 
@@ -149,20 +149,28 @@ bool AILogWidget::exportLogs(const QString &filePath)
 
 // AIPlayerTableWidget Implementation
 AIPlayerTableWidget::AIPlayerTableWidget(QWidget *parent)
-    : QTableWidget(parent)
+    : QTableView(parent)
+    , m_playerModel(new AIPlayerTableModel(this))
+    , m_proxyModel(new AIPlayerFilterProxyModel(this))
+    , m_flushTimer(new QTimer(this))
 {
     setupTable();
+    
+    // 生成器逐個發出的AI先緩衝，回到事件循環時整批插入
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, &QTimer::timeout, this, &AIPlayerTableWidget::flushPendingPlayers);
+    connect(this, &QTableView::clicked, this, &AIPlayerTableWidget::onCellClicked);
 }
 
 void AIPlayerTableWidget::setupTable()
 {
-    setColumnCount(8);
-    QStringList headers = {"AI ID", "學院", "部門", "姓名", "性格", "戰鬥風格", "狀態", "操作"};
-    setHorizontalHeaderLabels(headers);
+    m_proxyModel->setSourceModel(m_playerModel);
+    setModel(m_proxyModel);
     
     // 設置表格樣式
     setStyleSheet(
-        "QTableWidget {"
+        "QTableView {"
         "    background-color: #2d2d2d;"
         "    color: white;"
         "    gridline-color: #555555;"
@@ -188,95 +196,79 @@ void AIPlayerTableWidget::setupTable()
     setColumnWidth(6, 80);   // 狀態
     setColumnWidth(7, 100);  // 操作
     
+    // 固定行高，不需逐行計算尺寸
+    verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    verticalHeader()->setDefaultSectionSize(26);
+    
     // 其他設置
     setAlternatingRowColors(true);
     setSelectionBehavior(QAbstractItemView::SelectRows);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setSortingEnabled(true);
+    sortByColumn(AIPlayerTableModel::IdColumn, Qt::AscendingOrder);
 }
 
 void AIPlayerTableWidget::addAIPlayer(const AIPlayerData &player)
 {
-    int row = rowCount();
-    insertRow(row);
-    
-    setItem(row, 0, new QTableWidgetItem(player.aiId));
-    setItem(row, 1, new QTableWidgetItem(player.academy));
-    setItem(row, 2, new QTableWidgetItem(player.department));
-    setItem(row, 3, new QTableWidgetItem(player.name));
-    setItem(row, 4, new QTableWidgetItem(player.personality));
-    setItem(row, 5, new QTableWidgetItem(player.combatStyle));
-    setItem(row, 6, new QTableWidgetItem(player.state));
-    
-    // 添加移除按鈕
-    QPushButton *removeButton = createRemoveButton(player.aiId);
-    setCellWidget(row, 7, removeButton);
-    
-    // 記錄AI ID到行號的映射
-    m_aiRowMap[player.aiId] = row;
+    m_pendingPlayers.append(player);
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
 }
 
-QPushButton *AIPlayerTableWidget::createRemoveButton(const QString &aiId)
+void AIPlayerTableWidget::flushPendingPlayers()
 {
-    QPushButton *button = new QPushButton("移除", this);
-    button->setStyleSheet("QPushButton { background-color: #ff4500; color: white; border: none; padding: 4px 8px; border-radius: 3px; }");
-    button->setProperty("aiId", aiId);
-    
-    connect(button, &QPushButton::clicked, this, &AIPlayerTableWidget::onRemoveButtonClicked);
+    if (m_pendingPlayers.isEmpty()) {
+        return;
+    }
     
-    return button;
+    QVector<AIPlayerData> players;
+    players.swap(m_pendingPlayers);
+    m_playerModel->appendPlayers(players);
 }
 
 void AIPlayerTableWidget::updateAIStatus(const QString &aiId, const QString &status)
 {
-    if (m_aiRowMap.contains(aiId)) {
-        int row = m_aiRowMap[aiId];
-        if (item(row, 6)) {
-            item(row, 6)->setText(status);
-        }
-    }
+    flushPendingPlayers();
+    m_playerModel->updateState(aiId, status);
 }
 
 void AIPlayerTableWidget::clearAllPlayers()
 {
-    setRowCount(0);
-    m_aiRowMap.clear();
+    m_pendingPlayers.clear();
+    m_playerModel->clear();
 }
 
-void AIPlayerTableWidget::onCellClicked(int row, int column)
+void AIPlayerTableWidget::setAcademyFilter(const QString &academy)
 {
-    Q_UNUSED(column)
-    if (row < rowCount() && item(row, 0)) {
-        QString aiId = item(row, 0)->text();
-        emit aiPlayerSelected(aiId);
-    }
+    m_proxyModel->setAcademyFilter(academy);
 }
 
-void AIPlayerTableWidget::onRemoveButtonClicked()
-{
-    QPushButton *button = qobject_cast<QPushButton*>(sender());
-    if (button) {
-        QString aiId = button->property("aiId").toString();
-        
-        int ret = QMessageBox::question(this, "確認", 
-                                       QString("確定要移除AI玩家 %1 嗎？").arg(aiId),
-                                       QMessageBox::Yes | QMessageBox::No);
-        
-        if (ret == QMessageBox::Yes) {
-            // 找到並移除行
-            if (m_aiRowMap.contains(aiId)) {
-                int row = m_aiRowMap[aiId];
-                removeRow(row);
-                m_aiRowMap.remove(aiId);
-                
-                // 更新其他行的映射
-                for (auto it = m_aiRowMap.begin(); it != m_aiRowMap.end(); ++it) {
-                    if (it.value() > row) {
-                        it.value()--;
-                    }
-                }
-                
-                emit aiPlayerRemoved(aiId);
-            }
-        }
+void AIPlayerTableWidget::setDepartmentFilter(const QString &department)
+{
+    m_proxyModel->setDepartmentFilter(department);
+}
+
+void AIPlayerTableWidget::onCellClicked(const QModelIndex &index)
+{
+    if (!index.isValid()) {
+        return;
+    }
+    
+    const QModelIndex sourceIndex = m_proxyModel->mapToSource(index);
+    const QString aiId = m_playerModel->playerAt(sourceIndex.row()).aiId;
+    
+    if (sourceIndex.column() != AIPlayerTableModel::ActionColumn) {
+        emit aiPlayerSelected(aiId);
+        return;
+    }
+    
+    int ret = QMessageBox::question(this, "確認", 
+                                   QString("確定要移除AI玩家 %1 嗎？").arg(aiId),
+                                   QMessageBox::Yes | QMessageBox::No);
+    
+    if (ret == QMessageBox::Yes && m_playerModel->removePlayer(aiId)) {
+        emit aiPlayerRemoved(aiId);
     }
 }
 
@@ -398,6 +390,10 @@ void AIManagementWidget::setupGenerationTab()
     // 連接信號
     connect(m_generateButton, &QPushButton::clicked, this, &AIManagementWidget::onGenerateAIClicked);
     connect(m_clearAIButton, &QPushButton::clicked, this, &AIManagementWidget::onClearAIClicked);
+    connect(m_academyFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &AIManagementWidget::onRosterFilterChanged);
+    connect(m_departmentFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &AIManagementWidget::onRosterFilterChanged);
     
     m_tabWidget->addTab(m_generationTab, "🎮 AI生成");
 }
@@ -619,6 +615,13 @@ void AIManagementWidget::onClearAIClicked()
     }
 }
 
+void AIManagementWidget::onRosterFilterChanged()
+{
+    // 第一項為「全部」
+    m_playerTable->setAcademyFilter(m_academyFilterCombo->currentIndex() > 0 ? m_academyFilterCombo->currentText() : QString());
+    m_playerTable->setDepartmentFilter(m_departmentFilterCombo->currentIndex() > 0 ? m_departmentFilterCombo->currentText() : QString());
+}
+
 void AIManagementWidget::onAIPlayerGenerated(const AIPlayerData &player)
 {
     m_playerTable->addAIPlayer(player);
@@ -18,13 +18,14 @@
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QProgressBar>
-#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QTableView>
 #include <QtWidgets/QTabWidget>
 #include <QtWidgets/QGroupBox>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QLineEdit>
 #include <QtCore/QTimer>
 #include "AIPlayerGenerator.h"
+#include "AIPlayerTableModel.h"
 #include "AIDecisionEngine.h"
 #include "GameEventSyncer.h"
 
@@ -76,8 +77,10 @@ private:
 
 /**
  * @brief AI玩家表格顯示
+ *
+ * 名冊模型 + 篩選排序代理，固定行高，逐個加入的AI在事件循環返回後整批插入。
  */
-class AIPlayerTableWidget : public QTableWidget
+class AIPlayerTableWidget : public QTableView
 {
     Q_OBJECT
 
@@ -86,20 +89,26 @@ public:
     void addAIPlayer(const AIPlayerData &player);
     void updateAIStatus(const QString &aiId, const QString &status);
     void clearAllPlayers();
+    
+    // 篩選（空字串表示全部）
+    void setAcademyFilter(const QString &academy);
+    void setDepartmentFilter(const QString &department);
 
 signals:
     void aiPlayerSelected(const QString &aiId);
     void aiPlayerRemoved(const QString &aiId);
 
 private slots:
-    void onCellClicked(int row, int column);
-    void onRemoveButtonClicked();
+    void onCellClicked(const QModelIndex &index);
+    void flushPendingPlayers();
 
 private:
     void setupTable();
-    QPushButton *createRemoveButton(const QString &aiId);
     
-    QMap<QString, int> m_aiRowMap; // AI ID -> 行號映射
+    AIPlayerTableModel *m_playerModel;
+    AIPlayerFilterProxyModel *m_proxyModel;
+    QVector<AIPlayerData> m_pendingPlayers;
+    QTimer *m_flushTimer;
 };
 
 /**
@@ -132,6 +141,7 @@ private slots:
     void onGenerateAIClicked();
     void onClearAIClicked();
     void onAIPlayerGenerated(const AIPlayerData &player);
+    void onRosterFilterChanged();
     
     // 決策相關
     void onBatchDecisionClicked();
@@ -0,0 +1,261 @@
+/**
+ * @file AIPlayerTableModel.cpp
+ * @brief RAN Online AI玩家名冊表格模型實現
+ * @author Jy技術團隊
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "AIPlayerTableModel.h"
+#include <QtCore/QSet>
+#include <QtGui/QColor>
+
+namespace RANOnline {
+namespace AI {
+
+// AIPlayerTableModel Implementation
+AIPlayerTableModel::AIPlayerTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int AIPlayerTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_players.size();
+}
+
+int AIPlayerTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant AIPlayerTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_players.size()) {
+        return QVariant();
+    }
+    
+    const AIPlayerData &player = m_players[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        return columnText(player, index.column());
+    case Qt::ToolTipRole:
+        return index.column() == NameColumn ? player.signatureLine : QVariant();
+    case Qt::ForegroundRole:
+        // 操作欄以文字代替按鈕，上萬行不再建立上萬個控件
+        return index.column() == ActionColumn ? QColor("#ff4500") : QVariant();
+    case Qt::TextAlignmentRole:
+        return index.column() == ActionColumn ? QVariant(int(Qt::AlignCenter)) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant AIPlayerTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    static const QStringList headers = {"AI ID", "學院", "部門", "姓名", "性格", "戰鬥風格", "狀態", "操作"};
+    
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < headers.size()) {
+        return headers[section];
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void AIPlayerTableModel::appendPlayers(const QVector<AIPlayerData> &players)
+{
+    insertPlayers(updateExisting(players));
+}
+
+void AIPlayerTableModel::syncPlayers(const QVector<AIPlayerData> &players)
+{
+    QSet<QString> incomingIds;
+    incomingIds.reserve(players.size());
+    for (const AIPlayerData &player : players) {
+        incomingIds.insert(player.aiId);
+    }
+    
+    // 移除名冊中已不存在的AI，相鄰的行合併成一次通知
+    bool removed = false;
+    for (int row = m_players.size() - 1; row >= 0; --row) {
+        if (incomingIds.contains(m_players[row].aiId)) {
+            continue;
+        }
+        const int last = row;
+        while (row > 0 && !incomingIds.contains(m_players[row - 1].aiId)) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, last);
+        m_players.remove(row, last - row + 1);
+        endRemoveRows();
+        removed = true;
+    }
+    if (removed) {
+        m_rowById.clear();
+        rebuildRowIndex();
+    }
+    
+    // 更新已有的AI，新的AI整批追加
+    insertPlayers(updateExisting(players));
+}
+
+QVector<AIPlayerData> AIPlayerTableModel::updateExisting(const QVector<AIPlayerData> &players)
+{
+    // 已存在的ID只更新；同一批內重複的ID只新增一行，以最後一筆為準
+    QVector<AIPlayerData> added;
+    QHash<QString, int> addedIndex;
+    added.reserve(players.size());
+    for (const AIPlayerData &player : players) {
+        const int row = rowOf(player.aiId);
+        if (row >= 0) {
+            updateRow(row, player);
+            continue;
+        }
+        
+        auto it = addedIndex.constFind(player.aiId);
+        if (it != addedIndex.constEnd()) {
+            added[it.value()] = player;
+        } else {
+            addedIndex.insert(player.aiId, added.size());
+            added.append(player);
+        }
+    }
+    return added;
+}
+
+void AIPlayerTableModel::insertPlayers(const QVector<AIPlayerData> &players)
+{
+    if (players.isEmpty()) {
+        return;
+    }
+    
+    const int firstRow = m_players.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + players.size() - 1);
+    m_players.append(players);
+    rebuildRowIndex(firstRow);
+    endInsertRows();
+}
+
+bool AIPlayerTableModel::updateState(const QString &aiId, const QString &state)
+{
+    const int row = rowOf(aiId);
+    if (row < 0) {
+        return false;
+    }
+    if (m_players[row].state != state) {
+        m_players[row].state = state;
+        const QModelIndex cell = index(row, StateColumn);
+        emit dataChanged(cell, cell, {Qt::DisplayRole});
+    }
+    return true;
+}
+
+bool AIPlayerTableModel::removePlayer(const QString &aiId)
+{
+    const int row = rowOf(aiId);
+    if (row < 0) {
+        return false;
+    }
+    
+    beginRemoveRows(QModelIndex(), row, row);
+    m_players.remove(row);
+    m_rowById.remove(aiId);
+    rebuildRowIndex(row);
+    endRemoveRows();
+    return true;
+}
+
+void AIPlayerTableModel::clear()
+{
+    beginResetModel();
+    m_players.clear();
+    m_rowById.clear();
+    endResetModel();
+}
+
+QString AIPlayerTableModel::columnText(const AIPlayerData &player, int column)
+{
+    switch (column) {
+    case IdColumn:          return player.aiId;
+    case AcademyColumn:     return player.academy;
+    case DepartmentColumn:  return player.department;
+    case NameColumn:        return player.name;
+    case PersonalityColumn: return player.personality;
+    case CombatStyleColumn: return player.combatStyle;
+    case StateColumn:       return player.state;
+    case ActionColumn:      return QStringLiteral("移除");
+    default:                return QString();
+    }
+}
+
+void AIPlayerTableModel::updateRow(int row, const AIPlayerData &player)
+{
+    // 只通知有變化的儲存格範圍
+    AIPlayerData &current = m_players[row];
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int column = IdColumn; column < ActionColumn; ++column) {
+        if (columnText(current, column) != columnText(player, column)) {
+            if (firstChanged < 0) {
+                firstChanged = column;
+            }
+            lastChanged = column;
+        }
+    }
+    
+    const bool tooltipChanged = current.signatureLine != player.signatureLine;
+    current = player;
+    if (firstChanged >= 0) {
+        emit dataChanged(index(row, firstChanged), index(row, lastChanged), {Qt::DisplayRole});
+    }
+    if (tooltipChanged) {
+        emit dataChanged(index(row, NameColumn), index(row, NameColumn), {Qt::ToolTipRole});
+    }
+}
+
+void AIPlayerTableModel::rebuildRowIndex(int firstRow)
+{
+    for (int row = firstRow; row < m_players.size(); ++row) {
+        m_rowById[m_players[row].aiId] = row;
+    }
+}
+
+// AIPlayerFilterProxyModel Implementation
+AIPlayerFilterProxyModel::AIPlayerFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+}
+
+void AIPlayerFilterProxyModel::setAcademyFilter(const QString &academy)
+{
+    if (m_academy != academy) {
+        m_academy = academy;
+        invalidateFilter();
+    }
+}
+
+void AIPlayerFilterProxyModel::setDepartmentFilter(const QString &department)
+{
+    if (m_department != department) {
+        m_department = department;
+        invalidateFilter();
+    }
+}
+
+bool AIPlayerFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+    const auto *model = static_cast<const AIPlayerTableModel *>(sourceModel());
+    const AIPlayerData &player = model->playerAt(sourceRow);
+    
+    if (!m_academy.isEmpty() && player.academy != m_academy) {
+        return false;
+    }
+    if (!m_department.isEmpty() && player.department != m_department) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace AI
+} // namespace RANOnline
@@ -0,0 +1,106 @@
+/**
+ * @file AIPlayerTableModel.h
+ * @brief RAN Online AI玩家名冊表格模型
+ * @author Jy技術團隊
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#pragma once
+
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include "AIPlayerGenerator.h"
+
+namespace RANOnline {
+namespace AI {
+
+/**
+ * @brief AI玩家名冊模型
+ *
+ * 名冊資料直接存放在模型中，視圖只讀取可見行。
+ * 批次新增只發一次插入通知，同步名冊時只對有變化的儲存格發dataChanged。
+ */
+class AIPlayerTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn = 0,
+        AcademyColumn,
+        DepartmentColumn,
+        NameColumn,
+        PersonalityColumn,
+        CombatStyleColumn,
+        StateColumn,
+        ActionColumn,
+        ColumnCount
+    };
+
+    explicit AIPlayerTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 批次追加，整批只通知一次
+    void appendPlayers(const QVector<AIPlayerData> &players);
+
+    // 與名冊同步：移除不存在的、更新有變化的儲存格、追加新的
+    void syncPlayers(const QVector<AIPlayerData> &players);
+
+    // 更新單個AI的狀態欄
+    bool updateState(const QString &aiId, const QString &state);
+
+    bool removePlayer(const QString &aiId);
+    void clear();
+
+    const AIPlayerData &playerAt(int row) const { return m_players[row]; }
+    int rowOf(const QString &aiId) const { return m_rowById.value(aiId, -1); }
+
+    // 儲存格顯示文字
+    static QString columnText(const AIPlayerData &player, int column);
+
+private:
+    // 更新已存在的AI，返回需新增的AI（批內ID已去重）
+    QVector<AIPlayerData> updateExisting(const QVector<AIPlayerData> &players);
+    // 整批追加到末尾，只通知一次
+    void insertPlayers(const QVector<AIPlayerData> &players);
+    void updateRow(int row, const AIPlayerData &player);
+    void rebuildRowIndex(int firstRow = 0);
+
+private:
+    QVector<AIPlayerData> m_players;
+    QHash<QString, int> m_rowById; // AI ID -> 行號
+};
+
+/**
+ * @brief AI玩家篩選排序代理
+ *
+ * 按學院、部門篩選，篩選直接讀取名冊資料，不經過QVariant。
+ */
+class AIPlayerFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit AIPlayerFilterProxyModel(QObject *parent = nullptr);
+
+    // 空字串表示不篩選
+    void setAcademyFilter(const QString &academy);
+    void setDepartmentFilter(const QString &department);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString m_academy;
+    QString m_department;
+};
+
+} // namespace AI
+} // namespace RANOnline
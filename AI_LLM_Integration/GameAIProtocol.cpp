@@ -7,7 +7,6 @@
  */
 
 #include "GameAIProtocol.h"
-#include <QtCore/QUuid>
 
 namespace RANOnline {
 namespace AI {
@@ -82,8 +81,7 @@ QJsonObject ProtocolUtils::createSpawnRequest(Academy academy, Department depart
         {"department", departmentToString(department)},
         {"count", count},
         {"team", teamId},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
 }
 
@@ -93,8 +91,7 @@ QJsonObject ProtocolUtils::createCommandRequest(const QString &aiId, const QStri
         {"cmd", Commands::AI_COMMAND},
         {"ai_id", aiId},
         {"action", action},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     
     if (!params.isEmpty()) {
@@ -115,8 +112,7 @@ QJsonObject ProtocolUtils::createTeamAssignRequest(const QStringList &aiIds, int
         {"cmd", Commands::ASSIGN_TEAM},
         {"ai_ids", idsArray},
         {"team", teamId},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
 }
 
@@ -124,8 +120,7 @@ QJsonObject ProtocolUtils::createStatusRequest(const QStringList &aiIds)
 {
     QJsonObject request{
         {"cmd", Commands::GET_STATUS},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     
     if (!aiIds.isEmpty()) {
@@ -144,8 +139,7 @@ QJsonObject ProtocolUtils::createBatchRequest(const QJsonArray &operations)
     return QJsonObject{
         {"cmd", Commands::BATCH_OPERATION},
         {"operations", operations},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
 }
 
@@ -9,7 +9,6 @@
 #include "GameWebSocketClient.h"
 #include <QtCore/QJsonDocument>
 #include <QtCore/QDebug>
-#include <QtCore/QUuid>
 #include <QtCore/QDateTime>
 
 namespace RANOnline {
@@ -52,9 +51,9 @@ void GameWebSocketClient::setupTimers()
     m_messageQueueTimer->setInterval(100); // 100ms處理一次
     connect(m_messageQueueTimer, &QTimer::timeout, this, &GameWebSocketClient::processMessageQueue);
     
-    // 請求超時定時器
+    // 請求超時定時器（推進時間輪，只觸發到期請求）
     m_requestTimeoutTimer->setSingleShot(false);
-    m_requestTimeoutTimer->setInterval(5000); // 5秒檢查一次
+    m_requestTimeoutTimer->setInterval(REQUEST_TIMEOUT_TICK);
     connect(m_requestTimeoutTimer, &QTimer::timeout, this, &GameWebSocketClient::onRequestTimeout);
 }
 
@@ -187,8 +186,7 @@ QString GameWebSocketClient::deleteAI(const QString &aiId)
     QJsonObject request{
         {"cmd", Commands::DELETE_AI},
         {"ai_id", aiId},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     return sendRequest(request);
 }
@@ -198,8 +196,7 @@ QString GameWebSocketClient::deleteTeam(int teamId)
     QJsonObject request{
         {"cmd", Commands::DELETE_AI},
         {"team_id", teamId},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     return sendRequest(request);
 }
@@ -209,8 +206,7 @@ QString GameWebSocketClient::pauseAllAI()
     QJsonObject request{
         {"cmd", Commands::SYSTEM_CONTROL},
         {"action", "pause_all"},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     return sendRequest(request);
 }
@@ -220,8 +216,7 @@ QString GameWebSocketClient::resumeAllAI()
     QJsonObject request{
         {"cmd", Commands::SYSTEM_CONTROL},
         {"action", "resume_all"},
-        {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"request_id", QUuid::createUuid().toString(QUuid::WithoutBraces)}
+        {"timestamp", QDateTime::currentMSecsSinceEpoch()}
     };
     return sendRequest(request);
 }
@@ -230,24 +225,31 @@ QString GameWebSocketClient::resumeAllAI()
 
 QString GameWebSocketClient::sendRequest(const QJsonObject &request)
 {
-    QString requestId = request["request_id"].toString();
+    // 以64位序列號取代UUID作為請求ID；已分配過的（排隊後重發）沿用原ID
+    QJsonObject tracked = request;
+    bool hasSequence = false;
+    quint64 sequence = tracked["request_id"].toString().toULongLong(&hasSequence);
+    if (!hasSequence || sequence == 0) {
+        sequence = m_pendingRequests.nextRequestId();
+        tracked["request_id"] = QString::number(sequence);
+    }
+    QString requestId = tracked["request_id"].toString();
     
     if (!isConnected()) {
-        queueMessage(request);
+        queueMessage(tracked);
         qWarning() << "Not connected, queued message:" << requestId;
         return requestId;
     }
     
-    // 記錄待處理請求
-    QMutexLocker locker(&m_requestMutex);
-    PendingRequest pending;
-    pending.requestId = requestId;
-    pending.request = request;
-    pending.timestamp = QDateTime::currentMSecsSinceEpoch();
-    m_pendingRequests[requestId] = pending;
+    // 記錄待處理請求；登記失敗（如該序列號仍在待處理中）時不發送，直接回報失敗
+    if (!trackRequest(sequence, tracked, 0)) {
+        emit requestFailed(requestId, "Request could not be tracked");
+        qWarning() << "Request not sent, tracking failed:" << requestId;
+        return requestId;
+    }
     
     // 發送請求
-    QJsonDocument doc(request);
+    QJsonDocument doc(tracked);
     m_webSocket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
     
     m_stats.sentMessages++;
@@ -376,44 +378,33 @@ void GameWebSocketClient::processMessageQueue()
 
 void GameWebSocketClient::onRequestTimeout()
 {
-    QMutexLocker locker(&m_requestMutex);
-    
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    QStringList timeoutRequests;
-    
-    for (auto it = m_pendingRequests.begin(); it != m_pendingRequests.end(); ++it) {
-        if (now - it->timestamp > m_requestTimeout) {
-            timeoutRequests.append(it.key());
-        }
-    }
-    
-    for (const QString &requestId : timeoutRequests) {
-        handleRequestTimeout(requestId);
-    }
+    // 時間輪只回調到期的請求，無需掃描全部待處理請求
+    m_pendingRequests.expire();
 }
 
-void GameWebSocketClient::handleRequestTimeout(const QString &requestId)
+bool GameWebSocketClient::trackRequest(quint64 sequence, const QJsonObject &request, int retryCount)
 {
-    QMutexLocker locker(&m_requestMutex);
-    
-    if (!m_pendingRequests.contains(requestId)) {
-        return;
-    }
-    
-    PendingRequest &request = m_pendingRequests[requestId];
+    return m_pendingRequests.registerRequestWithId(sequence, std::chrono::milliseconds(m_requestTimeout),
+        [this, sequence, request, retryCount](CorrelationStatus status, QJsonObject) {
+            if (status == CorrelationStatus::TimedOut) {
+                handleRequestTimeout(sequence, request, retryCount);
+            }
+        });
+}
+
+void GameWebSocketClient::handleRequestTimeout(quint64 sequence, const QJsonObject &request, int retryCount)
+{
+    QString requestId = QString::number(sequence);
     
-    if (request.retryCount < 3) {
-        // 重試請求
-        request.retryCount++;
-        request.timestamp = QDateTime::currentMSecsSinceEpoch();
-        
-        QJsonDocument doc(request.request);
+    if (retryCount < MAX_REQUEST_RETRIES && isConnected() &&
+        trackRequest(sequence, request, retryCount + 1)) {
+        // 重試請求（沿用同一序列號）
+        QJsonDocument doc(request);
         m_webSocket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
         
-        qDebug() << "Retrying request:" << requestId << "Attempt:" << request.retryCount;
+        qDebug() << "Retrying request:" << requestId << "Attempt:" << retryCount + 1;
     } else {
         // 請求失敗
-        m_pendingRequests.remove(requestId);
         emit requestFailed(requestId, "Request timeout after retries");
         
         qWarning() << "Request failed after retries:" << requestId;
@@ -424,10 +415,12 @@ void GameWebSocketClient::processResponse(const QJsonObject &response)
 {
     QString requestId = response["request_id"].toString();
     
-    // 移除待處理請求
-    QMutexLocker locker(&m_requestMutex);
-    m_pendingRequests.remove(requestId);
-    locker.unlock();
+    // 移除待處理請求（遲到或重複的響應仍照常分派）
+    bool hasSequence = false;
+    quint64 sequence = requestId.toULongLong(&hasSequence);
+    if (hasSequence) {
+        m_pendingRequests.complete(sequence, response);
+    }
     
     QString status = response["status"].toString();
     
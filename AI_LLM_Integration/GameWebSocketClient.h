@@ -19,6 +19,7 @@
 #include <memory>
 
 #include "GameAIProtocol.h"
+#include "RequestCorrelator.h"
 
 namespace RANOnline {
 namespace AI {
@@ -131,15 +132,10 @@ private:
     QQueue<QJsonObject> m_messageQueue;
     QMutex m_queueMutex;
     
-    // 請求追蹤
-    struct PendingRequest {
-        QString requestId;
-        QJsonObject request;
-        qint64 timestamp;
-        int retryCount = 0;
-    };
-    QMap<QString, PendingRequest> m_pendingRequests;
-    QMutex m_requestMutex;
+    // 請求追蹤（64位序列號 + 時間輪超時）
+    RequestCorrelator<QJsonObject> m_pendingRequests;
+    static constexpr int REQUEST_TIMEOUT_TICK = 100; // 時間輪推進間隔（毫秒）
+    static constexpr int MAX_REQUEST_RETRIES = 3;
     
     // 統計信息
     struct Statistics {
@@ -157,7 +153,8 @@ private:
     void queueMessage(const QJsonObject &message);
     void processResponse(const QJsonObject &response);
     void processNotification(const QJsonObject &notification);
-    void handleRequestTimeout(const QString &requestId);
+    bool trackRequest(quint64 sequence, const QJsonObject &request, int retryCount);
+    void handleRequestTimeout(quint64 sequence, const QJsonObject &request, int retryCount);
     void retryFailedRequest(const QString &requestId);
     void updateStatistics();
     
@@ -0,0 +1,700 @@
+/**
+ * @file EpollSocketServer.cpp
+ * @brief RANOnline EP7 AI系统 - 基于epoll的多路复用Socket服务器实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "EpollSocketServer.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t PROTOCOL_MAGIC = 0x52414E4F; ///< "RANO"
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ */
+EpollSocketServer::EpollSocketServer()
+    : EpollSocketServer(Config())
+{
+}
+
+/**
+ * @brief 构造函数
+ */
+EpollSocketServer::EpollSocketServer(const Config& config)
+    : m_config(config)
+    , m_port(0)
+    , m_isRunning(false)
+    , m_shouldStop(false)
+    , m_connectionCount(0)
+    , m_messagesSent(0)
+    , m_messagesReceived(0)
+    , m_bytesSent(0)
+    , m_bytesReceived(0)
+    , m_connectionsAccepted(0)
+    , m_errors(0)
+{
+    if (m_config.eventLoopCount <= 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        m_config.eventLoopCount = cores > 0 ? static_cast<int>(cores) : 2;
+    }
+    if (m_config.workerCount <= 0) {
+        m_config.workerCount = 1;
+    }
+    if (m_config.maxReadsPerWakeup <= 0) {
+        m_config.maxReadsPerWakeup = 1;
+    }
+    // 缓冲上限至少容纳一个最大帧的剩余部分加一次read，否则合法帧也会被拒绝
+    size_t minBuffered = MessageHeader::SIZE + m_config.maxFrameSize + m_config.readChunkSize;
+    if (m_config.maxBufferedBytes < minBuffered) {
+        m_config.maxBufferedBytes = minBuffered;
+    }
+}
+
+/**
+ * @brief 析构函数
+ */
+EpollSocketServer::~EpollSocketServer()
+{
+    stop();
+}
+
+/**
+ * @brief 启动服务器模式
+ */
+bool EpollSocketServer::startServer(uint16_t port)
+{
+    if (m_isRunning.load()) {
+        return true;
+    }
+
+    m_port = port;
+    m_shouldStop.store(false);
+
+    // 创建事件循环，每个循环拥有独立的监听套接字
+    for (int i = 0; i < m_config.eventLoopCount; ++i) {
+        auto loop = std::make_unique<EventLoop>();
+        loop->index = i;
+        loop->listenFd = createListenSocket(m_port);
+
+        // 端口0由系统分配，其余循环绑定到同一端口
+        if (m_port == 0 && loop->listenFd >= 0) {
+            sockaddr_in bound{};
+            socklen_t boundLength = sizeof(bound);
+            if (getsockname(loop->listenFd, reinterpret_cast<sockaddr*>(&bound), &boundLength) == 0) {
+                m_port = ntohs(bound.sin_port);
+            }
+        }
+        loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (loop->listenFd < 0 || loop->epollFd < 0 || loop->wakeFd < 0) {
+            std::cerr << "EpollSocketServer: 创建事件循环失败: " << std::strerror(errno) << std::endl;
+            m_loops.push_back(std::move(loop));
+            releaseResources();
+            return false;
+        }
+
+        epoll_event listenEvent{};
+        listenEvent.events = EPOLLIN | EPOLLET;
+        listenEvent.data.fd = loop->listenFd;
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->listenFd, &listenEvent);
+
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN | EPOLLET;
+        wakeEvent.data.fd = loop->wakeFd;
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &wakeEvent);
+
+        m_loops.push_back(std::move(loop));
+    }
+
+    // 启动工作线程
+    for (int i = 0; i < m_config.workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : m_workers) {
+        worker->thread = std::thread(&EpollSocketServer::workerFunction, this, worker.get());
+    }
+
+    // 启动事件循环线程
+    for (auto& loop : m_loops) {
+        loop->thread = std::thread(&EpollSocketServer::eventLoopFunction, this, loop.get());
+    }
+
+    m_isRunning.store(true);
+    std::cout << "EpollSocketServer: 监听端口 " << m_port << "，事件循环 " << m_config.eventLoopCount
+              << "，工作线程 " << m_config.workerCount << std::endl;
+    return true;
+}
+
+/**
+ * @brief 停止服务器并关闭所有连接
+ */
+void EpollSocketServer::stop()
+{
+    if (!m_isRunning.exchange(false)) {
+        return;
+    }
+
+    m_shouldStop.store(true);
+
+    for (auto& loop : m_loops) {
+        wakeLoop(loop.get());
+    }
+    for (auto& loop : m_loops) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+    }
+
+    for (auto& worker : m_workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        worker->condition.notify_all();
+    }
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    releaseResources();
+    std::cout << "EpollSocketServer: 已停止" << std::endl;
+}
+
+/**
+ * @brief 广播消息到所有已连接客户端
+ */
+bool EpollSocketServer::sendMessage(const Message& message)
+{
+    if (!m_isRunning.load()) {
+        return false;
+    }
+
+    auto data = std::make_shared<const std::vector<uint8_t>>(message.serialize());
+    for (auto& loop : m_loops) {
+        postToLoop(loop.get(), OutgoingFrame{0, data});
+    }
+    return true;
+}
+
+/**
+ * @brief 发送消息到指定连接
+ */
+bool EpollSocketServer::sendMessage(uint64_t connectionId, const Message& message)
+{
+    if (!m_isRunning.load() || connectionId == 0) {
+        return false;
+    }
+
+    size_t loopIndex = static_cast<size_t>(connectionId >> CONNECTION_ID_LOOP_SHIFT) - 1;
+    if (loopIndex >= m_loops.size()) {
+        return false;
+    }
+
+    auto data = std::make_shared<const std::vector<uint8_t>>(message.serialize());
+    postToLoop(m_loops[loopIndex].get(), OutgoingFrame{connectionId, std::move(data)});
+    return true;
+}
+
+/**
+ * @brief 设置消息接收回调
+ */
+void EpollSocketServer::setMessageCallback(std::function<void(std::unique_ptr<Message>)> callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_messageCallback = std::move(callback);
+}
+
+/**
+ * @brief 设置带连接ID的消息接收回调
+ */
+void EpollSocketServer::setConnectionMessageCallback(
+    std::function<void(uint64_t, std::unique_ptr<Message>)> callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_connectionMessageCallback = std::move(callback);
+}
+
+/**
+ * @brief 获取统计信息
+ */
+std::unordered_map<std::string, uint64_t> EpollSocketServer::getStatistics() const
+{
+    return {
+        {"messagesSent", m_messagesSent.load()},
+        {"messagesReceived", m_messagesReceived.load()},
+        {"bytesSent", m_bytesSent.load()},
+        {"bytesReceived", m_bytesReceived.load()},
+        {"connectionsAccepted", m_connectionsAccepted.load()},
+        {"activeConnections", m_connectionCount.load()},
+        {"eventLoops", static_cast<uint64_t>(m_loops.size())},
+        {"workers", static_cast<uint64_t>(m_workers.size())},
+        {"errors", m_errors.load()}
+    };
+}
+
+/**
+ * @brief 创建监听套接字
+ */
+int EpollSocketServer::createListenSocket(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    // 多个循环绑定同一端口，由内核分配连接
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+        std::cerr << "EpollSocketServer: SO_REUSEPORT不可用: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, m_config.listenBacklog) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief 事件循环线程函数
+ */
+void EpollSocketServer::eventLoopFunction(EventLoop* loop)
+{
+    std::vector<epoll_event> events(static_cast<size_t>(m_config.maxEventsPerWait));
+
+    while (!m_shouldStop.load()) {
+        // 有未读完的连接时不阻塞，处理完就绪事件后继续读取
+        int timeout = loop->pendingReads.empty() ? -1 : 0;
+        int count = epoll_wait(loop->epollFd, events.data(), static_cast<int>(events.size()), timeout);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            m_errors++;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+
+            if (fd == loop->listenFd) {
+                acceptConnections(loop);
+                continue;
+            }
+
+            if (fd == loop->wakeFd) {
+                uint64_t value;
+                while (read(loop->wakeFd, &value, sizeof(value)) > 0) {
+                }
+                drainOutbox(loop);
+                continue;
+            }
+
+            auto it = loop->connections.find(fd);
+            if (it == loop->connections.end()) {
+                continue;
+            }
+            Connection* connection = it->second.get();
+
+            if (flags & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(loop, fd);
+                continue;
+            }
+
+            if ((flags & EPOLLIN) && !handleReadable(loop, connection)) {
+                closeConnection(loop, fd);
+                continue;
+            }
+
+            if ((flags & EPOLLOUT) && !flushWrites(connection)) {
+                closeConnection(loop, fd);
+                continue;
+            }
+
+            if (flags & EPOLLRDHUP) {
+                closeConnection(loop, fd);
+            }
+        }
+
+        // 继续读取上一轮用完读预算的连接
+        if (!loop->pendingReads.empty()) {
+            std::vector<int> pending;
+            pending.swap(loop->pendingReads);
+            for (int fd : pending) {
+                auto it = loop->connections.find(fd);
+                if (it == loop->connections.end() || !it->second->readPending) {
+                    continue;
+                }
+                it->second->readPending = false;
+                if (!handleReadable(loop, it->second.get())) {
+                    closeConnection(loop, fd);
+                }
+            }
+        }
+    }
+
+    // 关闭本循环的全部连接
+    while (!loop->connections.empty()) {
+        closeConnection(loop, loop->connections.begin()->first);
+    }
+}
+
+/**
+ * @brief 工作线程函数
+ */
+void EpollSocketServer::workerFunction(Worker* worker)
+{
+    std::deque<DecodedMessage> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->condition.wait(lock, [this, worker] {
+                return !worker->queue.empty() || m_shouldStop.load();
+            });
+            if (worker->queue.empty() && m_shouldStop.load()) {
+                break;
+            }
+            batch.swap(worker->queue);
+        }
+
+        std::function<void(std::unique_ptr<Message>)> callback;
+        std::function<void(uint64_t, std::unique_ptr<Message>)> connectionCallback;
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            callback = m_messageCallback;
+            connectionCallback = m_connectionMessageCallback;
+        }
+
+        for (auto& item : batch) {
+            if (connectionCallback) {
+                connectionCallback(item.connectionId, std::move(item.message));
+            } else if (callback) {
+                callback(std::move(item.message));
+            }
+        }
+        batch.clear();
+    }
+}
+
+/**
+ * @brief 接受所有挂起的新连接
+ */
+void EpollSocketServer::acceptConnections(EventLoop* loop)
+{
+    while (true) {
+        int fd = accept4(loop->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                m_errors++;
+            }
+            return;
+        }
+
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = (static_cast<uint64_t>(loop->index + 1) << CONNECTION_ID_LOOP_SHIFT) |
+                         loop->nextConnectionSerial++;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.fd = fd;
+        if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            m_errors++;
+            continue;
+        }
+
+        loop->connectionFds[connection->id] = fd;
+        loop->connections[fd] = std::move(connection);
+        m_connectionCount++;
+        m_connectionsAccepted++;
+    }
+}
+
+/**
+ * @brief 读取连接数据并解析完整帧
+ */
+bool EpollSocketServer::handleReadable(EventLoop* loop, Connection* connection)
+{
+    std::vector<uint8_t>& buffer = connection->readBuffer;
+
+    // 边缘触发：必须读到EAGAIN，否则不会再收到通知；预算用完时转入pendingReads
+    for (int reads = 0; ; ++reads) {
+        if (reads >= m_config.maxReadsPerWakeup) {
+            if (!connection->readPending) {
+                connection->readPending = true;
+                loop->pendingReads.push_back(connection->fd);
+            }
+            return true;
+        }
+
+        // 每次read后立即解析，未解析数据超过上限说明对端在灌入垃圾数据
+        size_t used = buffer.size();
+        if (used - connection->readOffset + m_config.readChunkSize > m_config.maxBufferedBytes) {
+            m_errors++;
+            return false;
+        }
+
+        buffer.resize(used + m_config.readChunkSize);
+        ssize_t received = read(connection->fd, buffer.data() + used, m_config.readChunkSize);
+
+        if (received > 0) {
+            buffer.resize(used + static_cast<size_t>(received));
+            m_bytesReceived += static_cast<uint64_t>(received);
+            if (!parseFrames(connection)) {
+                return false;
+            }
+            continue;
+        }
+
+        buffer.resize(used);
+        if (received == 0) {
+            return false;   // 对端关闭
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        }
+        m_errors++;
+        return false;
+    }
+}
+
+/**
+ * @brief 解析接收缓冲区中的完整帧
+ */
+bool EpollSocketServer::parseFrames(Connection* connection)
+{
+    std::vector<uint8_t>& buffer = connection->readBuffer;
+
+    while (buffer.size() - connection->readOffset >= MessageHeader::SIZE) {
+        const uint8_t* frameStart = buffer.data() + connection->readOffset;
+
+        uint32_t magic;
+        uint32_t length;
+        std::memcpy(&magic, frameStart + offsetof(MessageHeader, magic), sizeof(magic));
+        std::memcpy(&length, frameStart + offsetof(MessageHeader, length), sizeof(length));
+
+        if (magic != PROTOCOL_MAGIC || length > m_config.maxFrameSize) {
+            m_errors++;
+            return false;   // 协议错误或帧过大，断开连接
+        }
+
+        size_t frameSize = MessageHeader::SIZE + length;
+        if (buffer.size() - connection->readOffset < frameSize) {
+            break;
+        }
+
+        std::vector<uint8_t> frame(frameStart, frameStart + frameSize);
+        connection->readOffset += frameSize;
+
+        auto message = std::make_unique<Message>(MessageType::SYSTEM_PING);
+        if (message->deserialize(frame)) {
+            m_messagesReceived++;
+            dispatchMessage(connection->id, std::move(message));
+        } else {
+            m_errors++;
+        }
+    }
+
+    // 压缩已解析的数据
+    if (connection->readOffset == buffer.size()) {
+        buffer.clear();
+        connection->readOffset = 0;
+    } else if (connection->readOffset > m_config.readChunkSize) {
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(connection->readOffset));
+        connection->readOffset = 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 尽可能发送连接的待发送数据
+ */
+bool EpollSocketServer::flushWrites(Connection* connection)
+{
+    while (!connection->writeQueue.empty()) {
+        const std::vector<uint8_t>& frame = *connection->writeQueue.front();
+        size_t remaining = frame.size() - connection->writeOffset;
+
+        ssize_t written = send(connection->fd, frame.data() + connection->writeOffset,
+                               remaining, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;    // 等待EPOLLOUT
+            }
+            m_errors++;
+            return false;
+        }
+
+        m_bytesSent += static_cast<uint64_t>(written);
+        connection->writeOffset += static_cast<size_t>(written);
+
+        if (connection->writeOffset == frame.size()) {
+            connection->writeQueue.pop_front();
+            connection->writeOffset = 0;
+            m_messagesSent++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 处理发件箱中的跨线程发送请求
+ */
+void EpollSocketServer::drainOutbox(EventLoop* loop)
+{
+    std::vector<OutgoingFrame> frames;
+    {
+        std::lock_guard<std::mutex> lock(loop->outboxMutex);
+        frames.swap(loop->outbox);
+    }
+
+    std::vector<int> touched;
+    for (const auto& frame : frames) {
+        if (frame.connectionId == 0) {
+            for (auto& entry : loop->connections) {
+                entry.second->writeQueue.push_back(frame.data);
+                touched.push_back(entry.first);
+            }
+            continue;
+        }
+
+        auto it = loop->connectionFds.find(frame.connectionId);
+        if (it == loop->connectionFds.end()) {
+            continue;   // 连接已关闭
+        }
+        loop->connections[it->second]->writeQueue.push_back(frame.data);
+        touched.push_back(it->second);
+    }
+
+    for (int fd : touched) {
+        auto it = loop->connections.find(fd);
+        if (it != loop->connections.end() && !flushWrites(it->second.get())) {
+            closeConnection(loop, fd);
+        }
+    }
+}
+
+/**
+ * @brief 关闭并移除连接
+ */
+void EpollSocketServer::closeConnection(EventLoop* loop, int fd)
+{
+    auto it = loop->connections.find(fd);
+    if (it == loop->connections.end()) {
+        return;
+    }
+
+    epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+
+    loop->connectionFds.erase(it->second->id);
+    loop->connections.erase(it);
+    m_connectionCount--;
+}
+
+/**
+ * @brief 投递帧到事件循环
+ */
+void EpollSocketServer::postToLoop(EventLoop* loop, OutgoingFrame frame)
+{
+    bool needWake;
+    {
+        std::lock_guard<std::mutex> lock(loop->outboxMutex);
+        needWake = loop->outbox.empty();
+        loop->outbox.push_back(std::move(frame));
+    }
+
+    // 发件箱非空时循环已被唤醒，无需重复写eventfd
+    if (needWake) {
+        wakeLoop(loop);
+    }
+}
+
+/**
+ * @brief 唤醒事件循环
+ */
+void EpollSocketServer::wakeLoop(EventLoop* loop)
+{
+    uint64_t one = 1;
+    ssize_t ignored = write(loop->wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+/**
+ * @brief 将解码后的消息派发到工作线程
+ */
+void EpollSocketServer::dispatchMessage(uint64_t connectionId, std::unique_ptr<Message> message)
+{
+    // 同一连接固定分配到同一工作线程，保证处理顺序
+    Worker* worker = m_workers[connectionId % m_workers.size()].get();
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queue.push_back(DecodedMessage{connectionId, std::move(message)});
+    }
+    worker->condition.notify_one();
+}
+
+/**
+ * @brief 释放所有资源
+ */
+void EpollSocketServer::releaseResources()
+{
+    for (auto& loop : m_loops) {
+        if (loop->listenFd >= 0) close(loop->listenFd);
+        if (loop->wakeFd >= 0) close(loop->wakeFd);
+        if (loop->epollFd >= 0) close(loop->epollFd);
+    }
+    m_loops.clear();
+    m_workers.clear();
+    m_connectionCount.store(0);
+}
+
+#endif // __linux__
@@ -0,0 +1,314 @@
+/**
+ * @file EpollSocketServer.h
+ * @brief RANOnline EP7 AI系统 - 基于epoll的多路复用Socket服务器头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - epoll边缘触发读写，单线程管理数千连接
+ * - 多个事件循环通过SO_REUSEPORT分担连接
+ * - 固定大小的消息处理线程池
+ * - 按连接分片派发，保证同一连接的消息顺序
+ * - 与SocketCommunicator服务器模式相同的接口
+ */
+
+#pragma once
+
+#include "Protocol.h"
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#ifdef __linux__
+
+/**
+ * @class EpollSocketServer
+ * @brief Linux事件驱动Socket服务器
+ *
+ * 每个事件循环线程拥有独立的epoll实例和监听套接字（SO_REUSEPORT），
+ * 内核按四元组哈希把新连接分配到各循环。循环线程只负责非阻塞收发和
+ * 帧解析，解码后的消息按连接ID分片投递到固定数量的工作线程执行回调。
+ *
+ * 跨线程发送通过每个循环的发件箱加eventfd唤醒完成，套接字只在
+ * 其所属的循环线程内读写。
+ */
+class EpollSocketServer {
+public:
+    /**
+     * @struct Config
+     * @brief 服务器配置
+     */
+    struct Config {
+        int eventLoopCount = 0;         ///< 事件循环数量，0表示按CPU核心数
+        int workerCount = 4;            ///< 消息处理线程数量
+        int maxEventsPerWait = 256;     ///< 单次epoll_wait最大事件数
+        int listenBacklog = 1024;       ///< 监听队列长度
+        size_t maxFrameSize = 1048576;  ///< 单帧最大字节数（与maxMessageSize一致）
+        size_t readChunkSize = 65536;   ///< 单次read缓冲大小
+        size_t maxBufferedBytes = 4194304; ///< 单连接未解析数据上限（不小于单帧加一次read）
+        int maxReadsPerWakeup = 16;     ///< 单连接每轮最多read次数，用完后让出给其他连接
+    };
+
+    /**
+     * @brief 构造函数
+     */
+    EpollSocketServer();
+
+    /**
+     * @brief 构造函数
+     * @param config 服务器配置
+     */
+    explicit EpollSocketServer(const Config& config);
+
+    /**
+     * @brief 析构函数
+     */
+    ~EpollSocketServer();
+
+    EpollSocketServer(const EpollSocketServer&) = delete;
+    EpollSocketServer& operator=(const EpollSocketServer&) = delete;
+
+    /**
+     * @brief 启动服务器模式
+     * @param port 监听端口
+     * @return 是否成功启动
+     */
+    bool startServer(uint16_t port);
+
+    /**
+     * @brief 停止服务器并关闭所有连接
+     */
+    void stop();
+
+    /**
+     * @brief 广播消息到所有已连接客户端
+     * @param message 消息对象
+     * @return 是否成功加入发送队列
+     */
+    bool sendMessage(const Message& message);
+
+    /**
+     * @brief 发送消息到指定连接
+     * @param connectionId 连接ID
+     * @param message 消息对象
+     * @return 是否成功加入发送队列
+     */
+    bool sendMessage(uint64_t connectionId, const Message& message);
+
+    /**
+     * @brief 设置消息接收回调
+     * @param callback 回调函数（在工作线程中调用）
+     */
+    void setMessageCallback(std::function<void(std::unique_ptr<Message>)> callback);
+
+    /**
+     * @brief 设置带连接ID的消息接收回调，用于回复请求方
+     * @param callback 回调函数（在工作线程中调用）
+     */
+    void setConnectionMessageCallback(std::function<void(uint64_t, std::unique_ptr<Message>)> callback);
+
+    /**
+     * @brief 获取实际监听端口（以端口0启动时由系统分配）
+     * @return 端口号
+     */
+    uint16_t getPort() const { return m_port; }
+
+    /**
+     * @brief 检查服务器是否运行中
+     * @return 运行状态
+     */
+    bool isRunning() const { return m_isRunning.load(); }
+
+    /**
+     * @brief 获取当前连接数
+     * @return 连接数
+     */
+    size_t getConnectionCount() const { return m_connectionCount.load(); }
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计数据映射
+     */
+    std::unordered_map<std::string, uint64_t> getStatistics() const;
+
+private:
+    /**
+     * @struct Connection
+     * @brief 单个客户端连接状态（仅由所属事件循环线程访问）
+     */
+    struct Connection {
+        int fd = -1;
+        uint64_t id = 0;
+        std::vector<uint8_t> readBuffer;    ///< 未解析完的接收数据
+        size_t readOffset = 0;              ///< 已解析位置
+        std::deque<std::shared_ptr<const std::vector<uint8_t>>> writeQueue; ///< 待发送帧（广播时各连接共享同一缓冲）
+        size_t writeOffset = 0;             ///< 队首帧已发送字节数
+        bool readPending = false;           ///< 读预算用完，内核中仍有未读数据
+    };
+
+    /**
+     * @struct OutgoingFrame
+     * @brief 跨线程投递到事件循环的待发送帧
+     */
+    struct OutgoingFrame {
+        uint64_t connectionId;              ///< 0表示广播
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+
+    /**
+     * @struct EventLoop
+     * @brief 事件循环上下文
+     */
+    struct EventLoop {
+        int index = 0;
+        int epollFd = -1;
+        int listenFd = -1;
+        int wakeFd = -1;                    ///< eventfd，用于停止和发件箱唤醒
+        std::thread thread;
+        std::unordered_map<int, std::unique_ptr<Connection>> connections;
+        std::unordered_map<uint64_t, int> connectionFds;  ///< 连接ID到fd
+        std::vector<int> pendingReads;      ///< 下一轮需继续读取的连接
+        uint64_t nextConnectionSerial = 1;
+
+        std::mutex outboxMutex;
+        std::vector<OutgoingFrame> outbox;
+    };
+
+    /**
+     * @struct DecodedMessage
+     * @brief 待工作线程处理的消息
+     */
+    struct DecodedMessage {
+        uint64_t connectionId;
+        std::unique_ptr<Message> message;
+    };
+
+    /**
+     * @struct Worker
+     * @brief 消息处理线程（每个线程独立队列）
+     */
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<DecodedMessage> queue;
+    };
+
+    /**
+     * @brief 创建监听套接字
+     * @param port 监听端口
+     * @return 套接字描述符，失败返回-1
+     */
+    int createListenSocket(uint16_t port);
+
+    /**
+     * @brief 事件循环线程函数
+     * @param loop 循环上下文
+     */
+    void eventLoopFunction(EventLoop* loop);
+
+    /**
+     * @brief 工作线程函数
+     * @param worker 线程上下文
+     */
+    void workerFunction(Worker* worker);
+
+    /**
+     * @brief 接受所有挂起的新连接（边缘触发需读到EAGAIN）
+     * @param loop 循环上下文
+     */
+    void acceptConnections(EventLoop* loop);
+
+    /**
+     * @brief 读取连接数据并解析完整帧
+     *
+     * 读到EAGAIN为止，但单轮最多maxReadsPerWakeup次；预算用完时连接被记入
+     * pendingReads，由事件循环在下一轮继续读取（边缘触发不会再次通知）。
+     *
+     * @param loop 循环上下文
+     * @param connection 连接
+     * @return 连接是否仍然有效
+     */
+    bool handleReadable(EventLoop* loop, Connection* connection);
+
+    /**
+     * @brief 解析接收缓冲区中的完整帧
+     * @param connection 连接
+     * @return 协议是否正确，帧头非法或帧过大时返回false
+     */
+    bool parseFrames(Connection* connection);
+
+    /**
+     * @brief 尽可能发送连接的待发送数据
+     * @param connection 连接
+     * @return 连接是否仍然有效
+     */
+    bool flushWrites(Connection* connection);
+
+    /**
+     * @brief 处理发件箱中的跨线程发送请求
+     * @param loop 循环上下文
+     */
+    void drainOutbox(EventLoop* loop);
+
+    /**
+     * @brief 关闭并移除连接
+     * @param loop 循环上下文
+     * @param fd 连接描述符
+     */
+    void closeConnection(EventLoop* loop, int fd);
+
+    /**
+     * @brief 投递帧到事件循环
+     * @param loop 循环上下文
+     * @param frame 待发送帧
+     */
+    void postToLoop(EventLoop* loop, OutgoingFrame frame);
+
+    /**
+     * @brief 唤醒事件循环
+     * @param loop 循环上下文
+     */
+    static void wakeLoop(EventLoop* loop);
+
+    /**
+     * @brief 将解码后的消息派发到工作线程
+     * @param connectionId 连接ID
+     * @param message 消息
+     */
+    void dispatchMessage(uint64_t connectionId, std::unique_ptr<Message> message);
+
+    /**
+     * @brief 释放所有资源
+     */
+    void releaseResources();
+
+private:
+    Config m_config;                        ///< 服务器配置
+    uint16_t m_port;                        ///< 监听端口
+
+    std::vector<std::unique_ptr<EventLoop>> m_loops;  ///< 事件循环组
+    std::vector<std::unique_ptr<Worker>> m_workers;   ///< 工作线程组
+
+    std::atomic<bool> m_isRunning;          ///< 运行状态
+    std::atomic<bool> m_shouldStop;         ///< 停止标志
+    std::atomic<size_t> m_connectionCount;  ///< 当前连接数
+
+    std::mutex m_callbackMutex;             ///< 回调设置互斥锁
+    std::function<void(std::unique_ptr<Message>)> m_messageCallback;
+    std::function<void(uint64_t, std::unique_ptr<Message>)> m_connectionMessageCallback;
+
+    // 统计信息
+    std::atomic<uint64_t> m_messagesSent;
+    std::atomic<uint64_t> m_messagesReceived;
+    std::atomic<uint64_t> m_bytesSent;
+    std::atomic<uint64_t> m_bytesReceived;
+    std::atomic<uint64_t> m_connectionsAccepted;
+    std::atomic<uint64_t> m_errors;
+
+    static constexpr int CONNECTION_ID_LOOP_SHIFT = 48;   ///< 连接ID高位存放循环索引
+};
+
+#endif // __linux__
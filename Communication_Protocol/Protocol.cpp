@@ -11,6 +11,9 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QDateTime>
 #include <QtCore/QUuid>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
 
 /**
  * @brief MessageFrame构造函数
@@ -670,3 +673,91 @@ void NamedPipeClient::sendHeartbeat()
     Message heartbeat = m_protocol->createHeartbeatMessage();
     sendMessage(heartbeat);
 }
+
+// ==================== Message实现 ====================
+// 线上格式：32字节MessageHeader（主机字节序，字段偏移与结构体一致）+ 消息体
+
+static_assert(sizeof(MessageHeader) == MessageHeader::SIZE, "MessageHeader必须为32字节且无额外填充");
+
+std::atomic<uint32_t> Message::s_sequenceCounter{0};
+
+/**
+ * @brief Message构造函数
+ */
+Message::Message(MessageType type)
+{
+    m_header.type = type;
+    m_header.sequence = ++s_sequenceCounter;
+    m_header.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 设置消息体数据
+ */
+void Message::setData(const std::vector<uint8_t>& data)
+{
+    m_data = data;
+    m_header.length = static_cast<uint32_t>(m_data.size());
+    m_header.checksum = calculateChecksum();
+}
+
+/**
+ * @brief 序列化消息
+ */
+std::vector<uint8_t> Message::serialize() const
+{
+    MessageHeader header = m_header;
+    header.length = static_cast<uint32_t>(m_data.size());
+    header.checksum = calculateChecksum();
+    
+    std::vector<uint8_t> result(MessageHeader::SIZE + m_data.size());
+    std::memcpy(result.data(), &header, MessageHeader::SIZE);
+    if (!m_data.empty()) {
+        std::memcpy(result.data() + MessageHeader::SIZE, m_data.data(), m_data.size());
+    }
+    return result;
+}
+
+/**
+ * @brief 反序列化消息
+ */
+bool Message::deserialize(const std::vector<uint8_t>& data)
+{
+    if (data.size() < MessageHeader::SIZE) {
+        return false;
+    }
+    
+    MessageHeader header;
+    std::memcpy(&header, data.data(), MessageHeader::SIZE);
+    if (header.magic != MessageHeader().magic || data.size() - MessageHeader::SIZE < header.length) {
+        return false;
+    }
+    
+    m_header = header;
+    m_data.assign(data.begin() + MessageHeader::SIZE,
+                  data.begin() + static_cast<std::ptrdiff_t>(MessageHeader::SIZE + header.length));
+    return isValid();
+}
+
+/**
+ * @brief 计算校验和
+ */
+uint32_t Message::calculateChecksum() const
+{
+    uint32_t checksum = 0;
+    for (uint8_t byte : m_data) {
+        checksum += byte;
+    }
+    return checksum;
+}
+
+/**
+ * @brief 验证消息完整性
+ */
+bool Message::isValid() const
+{
+    return m_header.magic == MessageHeader().magic &&
+           m_header.length == m_data.size() &&
+           m_header.checksum == calculateChecksum();
+}
@@ -18,15 +18,24 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <functional>
 #include <chrono>
 #include <cstdint>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+typedef int SOCKET;                 ///< POSIX下套接字即文件描述符
 #endif
 
 /**
@@ -178,12 +187,16 @@ protected:
     std::vector<uint8_t> m_data;   ///< 消息体数据
     
 private:
-    static uint32_t s_sequenceCounter; ///< 全局序列号计数器
+    static std::atomic<uint32_t> s_sequenceCounter; ///< 全局序列号计数器（多线程构造消息）
 };
 
 /**
  * @class SocketCommunicator
  * @brief Socket通信器类
+ * 
+ * 服务器模式为每个客户端创建一个处理线程，适用于少量连接。
+ * Linux下需要承载大量游戏服务器分片连接时，请使用EpollSocketServer
+ * （EpollSocketServer.h），其接口与本类的服务器部分保持一致。
  */
 class SocketCommunicator {
 public:
@@ -317,6 +330,7 @@ private:
     uint64_t m_errors;              ///< 错误计数
 };
 
+#ifdef _WIN32
 /**
  * @class NamedPipeCommunicator
  * @brief 命名管道通信器类（Windows专用）
@@ -378,6 +392,7 @@ private:
     bool m_isConnected;             ///< 连接状态
     std::string m_pipeName;         ///< 管道名称
 };
+#endif // _WIN32
 
 /**
  * @class MessageQueue
@@ -504,5 +519,3 @@ namespace ProtocolUtils {
      */
     std::unique_ptr<Message> createErrorResponse(uint32_t originalSequence, const std::string& errorMessage);
 }
-
-#endif // PROTOCOL_H
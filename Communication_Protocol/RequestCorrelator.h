@@ -0,0 +1,530 @@
+/**
+ * @file RequestCorrelator.h
+ * @brief RANOnline EP7 AI系统 - 请求/响应关联表头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 64位单调序列号作为请求ID，不会因时间戳相同而冲突
+ * - 开放寻址哈希表，完成/取消为O(1)
+ * - 分层时间轮，超时到期为O(1)摊销，无需周期性全表扫描
+ * - 每个请求可使用回调或future获取结果
+ * - 仅依赖标准库，可在Qt前端和后端共同使用
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @enum CorrelationStatus
+ * @brief 请求结束状态
+ */
+enum class CorrelationStatus {
+    Completed,      ///< 收到响应
+    TimedOut,       ///< 超时
+    Cancelled       ///< 被取消（断线、关闭等）
+};
+
+/**
+ * @struct CorrelationResult
+ * @brief 请求结果（future方式使用）
+ */
+template<typename Payload>
+struct CorrelationResult {
+    CorrelationStatus status = CorrelationStatus::Cancelled;
+    Payload payload{};
+};
+
+/**
+ * @class RequestCorrelator
+ * @brief 请求/响应关联表
+ *
+ * 请求登记时分配64位序列号并挂入时间轮；响应到达时按序列号在开放寻址表中
+ * 查找并从时间轮摘除。时间轮共4层、每层64槽，默认10ms一格，最长可表达约
+ * 46小时的超时。调用方需周期性调用expire()推进时间轮，回调总是在调用
+ * complete()/cancel()/expire()的线程中、且在内部锁释放后执行。
+ *
+ * @tparam Payload 响应负载类型（须可默认构造和移动）
+ */
+template<typename Payload>
+class RequestCorrelator {
+public:
+    using Callback = std::function<void(CorrelationStatus, Payload)>;
+    using Clock = std::function<uint64_t()>;   ///< 返回单调毫秒时间
+
+    /**
+     * @brief 构造函数
+     * @param tickMs 时间轮刻度（毫秒）
+     * @param clock 时钟函数，默认使用steady_clock
+     */
+    explicit RequestCorrelator(uint32_t tickMs = 10, Clock clock = Clock())
+        : m_tickMs(tickMs > 0 ? tickMs : 1)
+        , m_clock(clock ? std::move(clock) : Clock(&RequestCorrelator::steadyNowMs))
+        , m_startMs(m_clock())
+        , m_currentTick(0)
+        , m_nextId(1)
+        , m_size(0)
+        , m_freeHead(NIL)
+    {
+        m_table.resize(INITIAL_TABLE_CAPACITY);
+        for (auto& level : m_wheel) {
+            level.fill(NIL);
+        }
+    }
+
+    RequestCorrelator(const RequestCorrelator&) = delete;
+    RequestCorrelator& operator=(const RequestCorrelator&) = delete;
+
+    /**
+     * @brief 分配一个新的请求ID（不登记）
+     * @return 序列号，从1开始，0保留为无效值
+     */
+    uint64_t nextRequestId()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_nextId++;
+    }
+
+    /**
+     * @brief 登记请求并分配ID
+     * @param timeout 超时时间
+     * @param callback 结果回调
+     * @return 请求ID
+     */
+    uint64_t registerRequest(std::chrono::milliseconds timeout, Callback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t id = m_nextId++;
+        insertLocked(id, timeout, std::move(callback));
+        return id;
+    }
+
+    /**
+     * @brief 以指定ID登记请求（用于预分配ID或超时重发）
+     * @param id 请求ID（非0，且当前未在表中）
+     * @param timeout 超时时间
+     * @param callback 结果回调
+     * @return 是否登记成功
+     */
+    bool registerRequestWithId(uint64_t id, std::chrono::milliseconds timeout, Callback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (id == 0 || findLocked(id) != NIL) {
+            return false;
+        }
+        if (id >= m_nextId) {
+            m_nextId = id + 1;
+        }
+        insertLocked(id, timeout, std::move(callback));
+        return true;
+    }
+
+    /**
+     * @brief 登记请求并返回future
+     * @param timeout 超时时间
+     * @return 请求ID和结果future
+     */
+    std::pair<uint64_t, std::future<CorrelationResult<Payload>>> registerRequestFuture(std::chrono::milliseconds timeout)
+    {
+        auto promise = std::make_shared<std::promise<CorrelationResult<Payload>>>();
+        auto future = promise->get_future();
+        uint64_t id = registerRequest(timeout, [promise](CorrelationStatus status, Payload payload) {
+            promise->set_value(CorrelationResult<Payload>{status, std::move(payload)});
+        });
+        return {id, std::move(future)};
+    }
+
+    /**
+     * @brief 以响应完成请求
+     * @param id 请求ID
+     * @param payload 响应负载
+     * @return 请求是否存在（迟到或重复的响应返回false）
+     */
+    bool complete(uint64_t id, Payload payload)
+    {
+        Callback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!takeLocked(id, callback)) {
+                return false;
+            }
+        }
+        if (callback) {
+            callback(CorrelationStatus::Completed, std::move(payload));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 取消请求
+     * @param id 请求ID
+     * @return 请求是否存在
+     */
+    bool cancel(uint64_t id)
+    {
+        Callback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!takeLocked(id, callback)) {
+                return false;
+            }
+        }
+        if (callback) {
+            callback(CorrelationStatus::Cancelled, Payload{});
+        }
+        return true;
+    }
+
+    /**
+     * @brief 取消全部未完成请求
+     * @return 取消的请求数量
+     */
+    size_t cancelAll()
+    {
+        std::vector<Callback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            callbacks.reserve(m_size);
+            for (auto& record : m_records) {
+                if (record.id != 0) {
+                    callbacks.push_back(std::move(record.callback));
+                }
+            }
+            resetLocked();
+        }
+        for (auto& callback : callbacks) {
+            if (callback) {
+                callback(CorrelationStatus::Cancelled, Payload{});
+            }
+        }
+        return callbacks.size();
+    }
+
+    /**
+     * @brief 推进时间轮到当前时间并触发超时回调
+     * @return 超时的请求数量
+     */
+    size_t expire()
+    {
+        std::vector<Callback> expired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint64_t targetTick = (m_clock() - m_startMs) / m_tickMs;
+
+            while (m_currentTick < targetTick) {
+                if (m_size == 0) {
+                    m_currentTick = targetTick;   // 空闲时直接跳到目标刻度
+                    break;
+                }
+                ++m_currentTick;
+                cascadeLocked();
+                collectExpiredLocked(expired);
+            }
+        }
+        for (auto& callback : expired) {
+            if (callback) {
+                callback(CorrelationStatus::TimedOut, Payload{});
+            }
+        }
+        return expired.size();
+    }
+
+    /**
+     * @brief 检查请求是否未完成
+     * @param id 请求ID
+     * @return 是否仍在等待响应
+     */
+    bool contains(uint64_t id) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return findLocked(id) != NIL;
+    }
+
+    /**
+     * @brief 获取未完成请求数量
+     * @return 数量
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_size;
+    }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr int WHEEL_LEVELS = 4;
+    static constexpr int WHEEL_BITS = 6;
+    static constexpr uint32_t WHEEL_SLOTS = 1u << WHEEL_BITS;
+    static constexpr uint64_t MAX_TICKS = (uint64_t(1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    static constexpr size_t INITIAL_TABLE_CAPACITY = 64;
+
+    /**
+     * @struct Record
+     * @brief 请求记录（同时是时间轮槽内双向链表节点）
+     */
+    struct Record {
+        uint64_t id = 0;                ///< 0表示空闲
+        uint64_t expiryTick = 0;
+        Callback callback;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+    };
+
+    /**
+     * @struct TableEntry
+     * @brief 开放寻址表项
+     */
+    struct TableEntry {
+        uint64_t id = 0;                ///< 0表示空槽
+        uint32_t record = NIL;
+    };
+
+    static uint64_t steadyNowMs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static size_t hashId(uint64_t id)
+    {
+        // 序列号连续，乘以黄金比例常数打散到高位
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+    uint32_t findLocked(uint64_t id) const
+    {
+        if (id == 0) {
+            return NIL;
+        }
+        size_t mask = m_table.size() - 1;
+        for (size_t index = hashId(id) & mask;; index = (index + 1) & mask) {
+            const TableEntry& entry = m_table[index];
+            if (entry.id == id) {
+                return entry.record;
+            }
+            if (entry.id == 0) {
+                return NIL;
+            }
+        }
+    }
+
+    void tableInsertLocked(uint64_t id, uint32_t record)
+    {
+        if ((m_size + 1) * 2 > m_table.size()) {
+            growTableLocked();
+        }
+        size_t mask = m_table.size() - 1;
+        size_t index = hashId(id) & mask;
+        while (m_table[index].id != 0) {
+            index = (index + 1) & mask;
+        }
+        m_table[index] = TableEntry{id, record};
+    }
+
+    void growTableLocked()
+    {
+        std::vector<TableEntry> old;
+        old.swap(m_table);
+        m_table.resize(old.size() * 2);
+        size_t mask = m_table.size() - 1;
+        for (const TableEntry& entry : old) {
+            if (entry.id != 0) {
+                size_t index = hashId(entry.id) & mask;
+                while (m_table[index].id != 0) {
+                    index = (index + 1) & mask;
+                }
+                m_table[index] = entry;
+            }
+        }
+    }
+
+    void tableEraseLocked(uint64_t id)
+    {
+        size_t mask = m_table.size() - 1;
+        size_t index = hashId(id) & mask;
+        while (m_table[index].id != id) {
+            index = (index + 1) & mask;
+        }
+
+        // 后移删除：把后续探测链上的表项前移，避免墓碑
+        size_t hole = index;
+        for (size_t next = (hole + 1) & mask; m_table[next].id != 0; next = (next + 1) & mask) {
+            size_t home = hashId(m_table[next].id) & mask;
+            bool movable = (hole <= next) ? (home <= hole || home > next)
+                                          : (home <= hole && home > next);
+            if (movable) {
+                m_table[hole] = m_table[next];
+                hole = next;
+            }
+        }
+        m_table[hole] = TableEntry{};
+    }
+
+    uint32_t allocateRecordLocked()
+    {
+        if (m_freeHead != NIL) {
+            uint32_t index = m_freeHead;
+            m_freeHead = m_records[index].next;
+            return index;
+        }
+        m_records.emplace_back();
+        return static_cast<uint32_t>(m_records.size() - 1);
+    }
+
+    void releaseRecordLocked(uint32_t index)
+    {
+        Record& record = m_records[index];
+        record.id = 0;
+        record.callback = nullptr;
+        record.prev = NIL;
+        record.next = m_freeHead;
+        m_freeHead = index;
+    }
+
+    void insertLocked(uint64_t id, std::chrono::milliseconds timeout, Callback callback)
+    {
+        uint64_t timeoutMs = timeout.count() > 0 ? static_cast<uint64_t>(timeout.count()) : 0;
+        // 向上取整到刻度边界，保证超时不会早于设定时间触发
+        uint64_t deadlineTick = (m_clock() - m_startMs + timeoutMs + m_tickMs - 1) / m_tickMs;
+
+        uint32_t index = allocateRecordLocked();
+        Record& record = m_records[index];
+        record.id = id;
+        record.callback = std::move(callback);
+        record.expiryTick = std::max(deadlineTick, m_currentTick + 1);
+
+        wheelInsertLocked(index);
+        tableInsertLocked(id, index);
+        ++m_size;
+    }
+
+    bool takeLocked(uint64_t id, Callback& callback)
+    {
+        uint32_t index = findLocked(id);
+        if (index == NIL) {
+            return false;
+        }
+        callback = std::move(m_records[index].callback);
+        wheelUnlinkLocked(index);
+        tableEraseLocked(id);
+        releaseRecordLocked(index);
+        --m_size;
+        return true;
+    }
+
+    void wheelInsertLocked(uint32_t index)
+    {
+        Record& record = m_records[index];
+        uint64_t delta = record.expiryTick > m_currentTick ? record.expiryTick - m_currentTick : 0;
+        if (delta > MAX_TICKS) {
+            record.expiryTick = m_currentTick + MAX_TICKS;
+            delta = MAX_TICKS;
+        }
+
+        int level = 0;
+        while (level < WHEEL_LEVELS - 1 && delta >= (uint64_t(1) << (WHEEL_BITS * (level + 1)))) {
+            ++level;
+        }
+        // 下放时恰好到期的记录放入当前槽，随后的collectExpiredLocked立即触发
+        uint64_t tick = delta == 0 ? m_currentTick : record.expiryTick;
+        uint32_t slot = static_cast<uint32_t>((tick >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+
+        record.level = static_cast<uint8_t>(level);
+        record.slot = static_cast<uint8_t>(slot);
+        record.prev = NIL;
+        record.next = m_wheel[level][slot];
+        if (record.next != NIL) {
+            m_records[record.next].prev = index;
+        }
+        m_wheel[level][slot] = index;
+    }
+
+    void wheelUnlinkLocked(uint32_t index)
+    {
+        Record& record = m_records[index];
+        if (record.prev != NIL) {
+            m_records[record.prev].next = record.next;
+        } else {
+            m_wheel[record.level][record.slot] = record.next;
+        }
+        if (record.next != NIL) {
+            m_records[record.next].prev = record.prev;
+        }
+        record.prev = NIL;
+        record.next = NIL;
+    }
+
+    void cascadeLocked()
+    {
+        // 从高层到低层下放，保证下放到低层当前槽的记录也能继续下放
+        for (int level = WHEEL_LEVELS - 1; level >= 1; --level) {
+            uint64_t mask = (uint64_t(1) << (WHEEL_BITS * level)) - 1;
+            if ((m_currentTick & mask) != 0) {
+                continue;
+            }
+            uint32_t slot = static_cast<uint32_t>((m_currentTick >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+            uint32_t index = m_wheel[level][slot];
+            m_wheel[level][slot] = NIL;
+            while (index != NIL) {
+                uint32_t next = m_records[index].next;
+                wheelInsertLocked(index);
+                index = next;
+            }
+        }
+    }
+
+    void collectExpiredLocked(std::vector<Callback>& expired)
+    {
+        uint32_t slot = static_cast<uint32_t>(m_currentTick & (WHEEL_SLOTS - 1));
+        uint32_t index = m_wheel[0][slot];
+        m_wheel[0][slot] = NIL;
+        while (index != NIL) {
+            uint32_t next = m_records[index].next;
+            expired.push_back(std::move(m_records[index].callback));
+            tableEraseLocked(m_records[index].id);
+            releaseRecordLocked(index);
+            --m_size;
+            index = next;
+        }
+    }
+
+    void resetLocked()
+    {
+        m_records.clear();
+        m_freeHead = NIL;
+        m_table.assign(INITIAL_TABLE_CAPACITY, TableEntry{});
+        for (auto& level : m_wheel) {
+            level.fill(NIL);
+        }
+        m_size = 0;
+    }
+
+private:
+    const uint32_t m_tickMs;                ///< 时间轮刻度
+    const Clock m_clock;                    ///< 时钟
+    const uint64_t m_startMs;               ///< 起始时间
+    uint64_t m_currentTick;                 ///< 当前刻度
+
+    mutable std::mutex m_mutex;             ///< 保护以下全部状态
+    uint64_t m_nextId;                      ///< 下一个序列号
+    size_t m_size;                          ///< 未完成请求数
+
+    std::vector<Record> m_records;          ///< 请求记录池
+    uint32_t m_freeHead;                    ///< 空闲记录链表头
+    std::vector<TableEntry> m_table;        ///< 开放寻址表（容量为2的幂）
+    std::array<std::array<uint32_t, WHEEL_SLOTS>, WHEEL_LEVELS> m_wheel; ///< 分层时间轮
+};
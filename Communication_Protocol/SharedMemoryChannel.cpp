@@ -0,0 +1,458 @@
+/**
+ * @file SharedMemoryChannel.cpp
+ * @brief RANOnline EP7 AI系统 - 共享内存IPC通道实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "SharedMemoryChannel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC = 0x524E5348;  ///< "RNSH"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t RECORD_PREFIX = sizeof(uint32_t);
+
+/**
+ * @brief 向上取整为2的幂
+ */
+size_t roundUpPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * @struct SharedMemoryChannel::RingHeader
+ * @brief 单个环的控制块，读写位置分处不同缓存行避免伪共享
+ */
+struct SharedMemoryChannel::RingHeader {
+    alignas(CACHE_LINE) std::atomic<uint64_t> writePosition;   ///< 写者独占
+    alignas(CACHE_LINE) std::atomic<uint64_t> readPosition;    ///< 读者独占
+    alignas(CACHE_LINE) std::atomic<uint32_t> dataSignal;      ///< futex字，每次写入递增
+    std::atomic<uint32_t> readerWaiting;                       ///< 读者是否在futex上休眠
+};
+
+/**
+ * @struct SharedMemoryChannel::SegmentHeader
+ * @brief 共享内存段头部
+ */
+struct SharedMemoryChannel::SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ringCapacity;
+    std::atomic<uint32_t> serverAttached;
+    std::atomic<uint32_t> clientAttached;
+};
+
+namespace {
+
+constexpr size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ */
+SharedMemoryChannel::SharedMemoryChannel()
+    : m_role(Role::Client)
+    , m_base(nullptr)
+    , m_mappedSize(0)
+    , m_ringCapacity(0)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    close();
+}
+
+#ifdef __linux__
+
+/**
+ * @brief 创建共享内存通道（服务端）
+ */
+bool SharedMemoryChannel::create(const std::string& name, size_t ringCapacity)
+{
+    close();
+
+    m_role = Role::Server;
+    m_name = "/" + name;
+    m_ringCapacity = roundUpPowerOfTwo(ringCapacity);
+
+    // 清理上次异常退出残留的段
+    shm_unlink(m_name.c_str());
+
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "SharedMemoryChannel: 创建共享内存失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    size_t ringBlock = alignUp(sizeof(RingHeader), CACHE_LINE) + m_ringCapacity;
+    size_t totalSize = alignUp(sizeof(SegmentHeader), CACHE_LINE) + 2 * ringBlock;
+
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0 || !mapSegment(fd, totalSize)) {
+        ::close(fd);
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    // 初始化段头和两个环
+    auto* segment = new (m_base) SegmentHeader();
+    segment->ringCapacity = m_ringCapacity;
+    segment->serverAttached.store(1);
+    segment->clientAttached.store(0);
+
+    for (RingHeader* ring : {txRing(), rxRing()}) {
+        new (ring) RingHeader();
+        ring->writePosition.store(0);
+        ring->readPosition.store(0);
+        ring->dataSignal.store(0);
+        ring->readerWaiting.store(0);
+    }
+
+    // 最后写入魔数，客户端据此判断段已初始化完成
+    segment->version = SEGMENT_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    segment->magic = SEGMENT_MAGIC;
+
+    return true;
+}
+
+/**
+ * @brief 打开已存在的共享内存通道（客户端）
+ */
+bool SharedMemoryChannel::open(const std::string& name)
+{
+    close();
+
+    m_role = Role::Client;
+    m_name = "/" + name;
+
+    int fd = shm_open(m_name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < alignUp(sizeof(SegmentHeader), CACHE_LINE) ||
+        !mapSegment(fd, static_cast<size_t>(info.st_size))) {
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    auto* segment = static_cast<SegmentHeader*>(m_base);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment->magic != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION) {
+        std::cerr << "SharedMemoryChannel: 共享内存段版本不匹配" << std::endl;
+        munmap(m_base, m_mappedSize);
+        m_base = nullptr;
+        return false;
+    }
+
+    // 段内容来自对端，容量须为2的幂且两个环都落在映射范围内
+    uint64_t ringCapacity = segment->ringCapacity;
+    size_t ringArea = m_mappedSize - alignUp(sizeof(SegmentHeader), CACHE_LINE);
+    size_t ringHeaderSize = alignUp(sizeof(RingHeader), CACHE_LINE);
+    if (ringCapacity <= RECORD_PREFIX || (ringCapacity & (ringCapacity - 1)) != 0 ||
+        ringArea / 2 < ringHeaderSize || ringCapacity > ringArea / 2 - ringHeaderSize) {
+        std::cerr << "SharedMemoryChannel: 共享内存段容量非法: " << ringCapacity << std::endl;
+        munmap(m_base, m_mappedSize);
+        m_base = nullptr;
+        m_mappedSize = 0;
+        return false;
+    }
+
+    m_ringCapacity = static_cast<size_t>(ringCapacity);
+    segment->clientAttached.store(1);
+    return true;
+}
+
+/**
+ * @brief 关闭通道
+ */
+void SharedMemoryChannel::close()
+{
+    if (!m_base) {
+        return;
+    }
+
+    auto* segment = static_cast<SegmentHeader*>(m_base);
+    if (m_role == Role::Server) {
+        segment->serverAttached.store(0);
+    } else {
+        segment->clientAttached.store(0);
+    }
+
+    // 唤醒对端读者，使其感知断开
+    txRing()->dataSignal.fetch_add(1);
+    futexWake(&txRing()->dataSignal);
+
+    munmap(m_base, m_mappedSize);
+    m_base = nullptr;
+    m_mappedSize = 0;
+
+    if (m_role == Role::Server) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+/**
+ * @brief 映射共享内存段
+ */
+bool SharedMemoryChannel::mapSegment(int fd, size_t size)
+{
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        std::cerr << "SharedMemoryChannel: 映射共享内存失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    m_base = address;
+    m_mappedSize = size;
+    return true;
+}
+
+/**
+ * @brief 在futex字上等待
+ */
+void SharedMemoryChannel::futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs)
+{
+    timespec timeout{};
+    timespec* timeoutPtr = nullptr;
+    if (timeoutMs >= 0) {
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+        timeoutPtr = &timeout;
+    }
+
+    // 跨进程共享，不能使用FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeoutPtr, nullptr, 0);
+}
+
+/**
+ * @brief 唤醒futex字上的等待者
+ */
+void SharedMemoryChannel::futexWake(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+#else
+
+bool SharedMemoryChannel::create(const std::string&, size_t) { return false; }
+bool SharedMemoryChannel::open(const std::string&) { return false; }
+void SharedMemoryChannel::close() {}
+bool SharedMemoryChannel::mapSegment(int, size_t) { return false; }
+void SharedMemoryChannel::futexWait(std::atomic<uint32_t>*, uint32_t, int) {}
+void SharedMemoryChannel::futexWake(std::atomic<uint32_t>*) {}
+
+#endif // __linux__
+
+/**
+ * @brief 检查对端是否仍在线
+ */
+bool SharedMemoryChannel::isPeerAttached() const
+{
+    if (!m_base) {
+        return false;
+    }
+
+    auto* segment = static_cast<SegmentHeader*>(m_base);
+    return m_role == Role::Server ? segment->clientAttached.load() != 0
+                                  : segment->serverAttached.load() != 0;
+}
+
+/**
+ * @brief 写入一条记录（不阻塞）
+ */
+bool SharedMemoryChannel::write(const void* data, size_t size)
+{
+    if (!m_base || size > maxRecordSize()) {
+        return false;
+    }
+
+    RingHeader* ring = txRing();
+    uint64_t writePosition = ring->writePosition.load(std::memory_order_relaxed);
+    uint64_t readPosition = ring->readPosition.load(std::memory_order_acquire);
+
+    size_t needed = RECORD_PREFIX + size;
+    uint64_t used = writePosition - readPosition;
+    if (used > m_ringCapacity || m_ringCapacity - static_cast<size_t>(used) < needed) {
+        return false;   // 环已满，由调用方决定重试或丢弃
+    }
+
+    uint32_t length = static_cast<uint32_t>(size);
+    copyIn(ring, writePosition, &length, RECORD_PREFIX);
+    copyIn(ring, writePosition + RECORD_PREFIX, data, size);
+    ring->writePosition.store(writePosition + needed, std::memory_order_release);
+
+    // 只有读者已休眠时才进入内核
+    ring->dataSignal.fetch_add(1, std::memory_order_release);
+    if (ring->readerWaiting.load(std::memory_order_acquire)) {
+        futexWake(&ring->dataSignal);
+    }
+    return true;
+}
+
+/**
+ * @brief 读取一条记录
+ */
+bool SharedMemoryChannel::read(std::vector<uint8_t>& out, int timeoutMs)
+{
+    if (!m_base) {
+        return false;
+    }
+
+    RingHeader* ring = rxRing();
+    uint64_t readPosition = ring->readPosition.load(std::memory_order_relaxed);
+
+    if (ring->writePosition.load(std::memory_order_acquire) == readPosition) {
+        if (timeoutMs == 0) {
+            return false;
+        }
+
+        // 先声明等待再复查，避免写者在两次检查之间写入而错过唤醒
+        uint32_t signal = ring->dataSignal.load(std::memory_order_acquire);
+        ring->readerWaiting.store(1, std::memory_order_seq_cst);
+        if (ring->writePosition.load(std::memory_order_seq_cst) == readPosition) {
+            futexWait(&ring->dataSignal, signal, timeoutMs);
+        }
+        ring->readerWaiting.store(0, std::memory_order_relaxed);
+
+        if (ring->writePosition.load(std::memory_order_acquire) == readPosition) {
+            return false;
+        }
+    }
+
+    // 写位置与长度前缀都由对端写入，越界即视为环已损坏
+    uint64_t writePosition = ring->writePosition.load(std::memory_order_acquire);
+    uint64_t available = writePosition - readPosition;
+    uint32_t length = 0;
+    if (available >= RECORD_PREFIX && available <= m_ringCapacity) {
+        copyOut(ring, readPosition, &length, RECORD_PREFIX);
+    }
+    if (available < RECORD_PREFIX || available > m_ringCapacity ||
+        length > m_ringCapacity - RECORD_PREFIX || length > available - RECORD_PREFIX) {
+        // 丢弃全部未读数据，从写者当前位置重新对齐记录边界
+        std::cerr << "SharedMemoryChannel: 接收环记录损坏，丢弃 " << available << " 字节" << std::endl;
+        ring->readPosition.store(writePosition, std::memory_order_release);
+        return false;
+    }
+
+    out.resize(length);
+    copyOut(ring, readPosition + RECORD_PREFIX, out.data(), length);
+
+    ring->readPosition.store(readPosition + RECORD_PREFIX + length, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 唤醒阻塞在read()中的本端读线程
+ */
+void SharedMemoryChannel::interruptRead()
+{
+    if (!m_base) {
+        return;
+    }
+
+    RingHeader* ring = rxRing();
+    ring->dataSignal.fetch_add(1, std::memory_order_release);
+    futexWake(&ring->dataSignal);
+}
+
+/**
+ * @brief 获取单条记录的最大负载大小
+ */
+size_t SharedMemoryChannel::maxRecordSize() const
+{
+    return m_ringCapacity > RECORD_PREFIX ? m_ringCapacity - RECORD_PREFIX : 0;
+}
+
+/**
+ * @brief 获取本端写入的环
+ */
+SharedMemoryChannel::RingHeader* SharedMemoryChannel::txRing() const
+{
+    size_t ringBlock = alignUp(sizeof(RingHeader), CACHE_LINE) + m_ringCapacity;
+    uint8_t* first = static_cast<uint8_t*>(m_base) + alignUp(sizeof(SegmentHeader), CACHE_LINE);
+    return reinterpret_cast<RingHeader*>(m_role == Role::Server ? first : first + ringBlock);
+}
+
+/**
+ * @brief 获取本端读取的环
+ */
+SharedMemoryChannel::RingHeader* SharedMemoryChannel::rxRing() const
+{
+    size_t ringBlock = alignUp(sizeof(RingHeader), CACHE_LINE) + m_ringCapacity;
+    uint8_t* first = static_cast<uint8_t*>(m_base) + alignUp(sizeof(SegmentHeader), CACHE_LINE);
+    return reinterpret_cast<RingHeader*>(m_role == Role::Server ? first + ringBlock : first);
+}
+
+/**
+ * @brief 获取环的数据区
+ */
+uint8_t* SharedMemoryChannel::ringData(RingHeader* ring) const
+{
+    return reinterpret_cast<uint8_t*>(ring) + alignUp(sizeof(RingHeader), CACHE_LINE);
+}
+
+/**
+ * @brief 环形复制写入
+ */
+void SharedMemoryChannel::copyIn(RingHeader* ring, uint64_t position, const void* data, size_t size)
+{
+    size_t offset = static_cast<size_t>(position & (m_ringCapacity - 1));
+    size_t firstPart = std::min(size, m_ringCapacity - offset);
+
+    std::memcpy(ringData(ring) + offset, data, firstPart);
+    if (firstPart < size) {
+        std::memcpy(ringData(ring), static_cast<const uint8_t*>(data) + firstPart, size - firstPart);
+    }
+}
+
+/**
+ * @brief 环形复制读取
+ */
+void SharedMemoryChannel::copyOut(RingHeader* ring, uint64_t position, void* data, size_t size) const
+{
+    size_t offset = static_cast<size_t>(position & (m_ringCapacity - 1));
+    size_t firstPart = std::min(size, m_ringCapacity - offset);
+
+    std::memcpy(data, ringData(ring) + offset, firstPart);
+    if (firstPart < size) {
+        std::memcpy(static_cast<uint8_t*>(data) + firstPart, ringData(ring), size - firstPart);
+    }
+}
@@ -0,0 +1,172 @@
+/**
+ * @file SharedMemoryChannel.h
+ * @brief RANOnline EP7 AI系统 - 共享内存IPC通道头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - POSIX共享内存上的一对单生产者单消费者环形缓冲区
+ * - 无锁读写，仅在对端等待时通过futex唤醒
+ * - 帧内容与Socket通道完全相同，上层解析逻辑无需区分
+ * - 适用于前端与后端部署在同一主机的场景
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class SharedMemoryChannel
+ * @brief 基于共享内存的双向消息通道
+ *
+ * 服务端（AI后端）调用create()创建共享内存段，客户端（前端管理器）调用
+ * open()映射同一段。段内包含两个环：服务端写、客户端读的下行环，以及
+ * 客户端写、服务端读的上行环。每个环只有一个写者和一个读者，读写位置
+ * 以单调递增的64位计数器表示，不需要互斥锁。
+ *
+ * 每条记录为4字节长度前缀加负载，负载即Socket通道上传输的完整帧。
+ */
+class SharedMemoryChannel {
+public:
+    /**
+     * @enum Role
+     * @brief 通道端角色
+     */
+    enum class Role {
+        Server,     ///< 创建者，写下行环、读上行环
+        Client      ///< 连接者，写上行环、读下行环
+    };
+
+    /**
+     * @brief 构造函数
+     */
+    SharedMemoryChannel();
+
+    /**
+     * @brief 析构函数
+     */
+    ~SharedMemoryChannel();
+
+    SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+    SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+    /**
+     * @brief 创建共享内存通道（服务端）
+     * @param name 通道名称（不含前导斜杠）
+     * @param ringCapacity 单个环容量（字节，向上取整为2的幂）
+     * @return 是否成功创建
+     */
+    bool create(const std::string& name, size_t ringCapacity = DEFAULT_RING_CAPACITY);
+
+    /**
+     * @brief 打开已存在的共享内存通道（客户端）
+     * @param name 通道名称（不含前导斜杠）
+     * @return 是否成功打开，段头声明的环容量超出段大小时失败
+     */
+    bool open(const std::string& name);
+
+    /**
+     * @brief 关闭通道，服务端同时删除共享内存段
+     */
+    void close();
+
+    /**
+     * @brief 检查通道是否已打开
+     * @return 是否已打开
+     */
+    bool isOpen() const { return m_base != nullptr; }
+
+    /**
+     * @brief 检查对端是否仍在线
+     * @return 对端是否已映射通道且未关闭
+     */
+    bool isPeerAttached() const;
+
+    /**
+     * @brief 写入一条记录（不阻塞）
+     * @param data 数据指针
+     * @param size 数据大小
+     * @return 是否写入成功，环空间不足时返回false
+     */
+    bool write(const void* data, size_t size);
+
+    /**
+     * @brief 读取一条记录
+     * @param out 输出缓冲区（复用其容量）
+     * @param timeoutMs 等待超时（毫秒），0表示不等待，负数表示无限等待
+     * @return 是否读到记录；对端写入的长度越界时丢弃环中未读数据并返回false
+     */
+    bool read(std::vector<uint8_t>& out, int timeoutMs);
+
+    /**
+     * @brief 唤醒阻塞在read()中的本端读线程（用于关闭）
+     */
+    void interruptRead();
+
+    /**
+     * @brief 获取单条记录的最大负载大小
+     * @return 最大负载字节数
+     */
+    size_t maxRecordSize() const;
+
+    static constexpr size_t DEFAULT_RING_CAPACITY = 4 * 1024 * 1024; ///< 默认4MB
+
+private:
+    struct RingHeader;
+    struct SegmentHeader;
+
+    /**
+     * @brief 映射共享内存段
+     * @param fd 共享内存描述符
+     * @param size 段大小
+     * @return 是否成功
+     */
+    bool mapSegment(int fd, size_t size);
+
+    /**
+     * @brief 获取本端写入的环
+     */
+    RingHeader* txRing() const;
+
+    /**
+     * @brief 获取本端读取的环
+     */
+    RingHeader* rxRing() const;
+
+    /**
+     * @brief 获取环的数据区
+     */
+    uint8_t* ringData(RingHeader* ring) const;
+
+    /**
+     * @brief 环形复制写入
+     */
+    void copyIn(RingHeader* ring, uint64_t position, const void* data, size_t size);
+
+    /**
+     * @brief 环形复制读取
+     */
+    void copyOut(RingHeader* ring, uint64_t position, void* data, size_t size) const;
+
+    /**
+     * @brief 在futex字上等待
+     */
+    static void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs);
+
+    /**
+     * @brief 唤醒futex字上的等待者
+     */
+    static void futexWake(std::atomic<uint32_t>* word);
+
+private:
+    Role m_role;                    ///< 本端角色
+    std::string m_name;             ///< 共享内存名称
+    void* m_base;                   ///< 映射基址
+    size_t m_mappedSize;            ///< 映射大小
+    size_t m_ringCapacity;          ///< 单环容量
+};
@@ -0,0 +1,705 @@
+/**
+ * @file AIWriteBehindCache.cpp
+ * @brief RANOnline EP7 AI系统 - AI玩家写回缓存实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "AIWriteBehindCache.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief 编码一条日志记录：魔数 + 负载长度 + CRC16 + 负载
+ */
+QByteArray encodeJournalRecord(quint32 magic, const QString& aiId, int columnIndex, const QVariant& value)
+{
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << aiId << qint32(columnIndex) << value;
+    }
+
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << magic << quint32(payload.size()) << qChecksum(payload);
+    record.append(payload);
+    return record;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ */
+AIWriteBehindCache::AIWriteBehindCache(const BulkUpsertWriter::TableSpec& spec, const QString& journalPath,
+                                       SqlDialect dialect)
+    : m_spec(spec)
+    , m_keyColumn(spec.keyColumns.value(0))
+    , m_dialect(dialect)
+    , m_fullMask(0)
+    , m_capacity(DEFAULT_CAPACITY)
+    , m_accessClock(0)
+    , m_journalPath(journalPath)
+    , m_journalRecords(0)
+    , m_lastFlushedRows(0)
+{
+    for (const QString& column : spec.columns) {
+        if (column != m_keyColumn && m_columns.size() < MAX_COLUMNS) {
+            m_columns << column;
+        }
+    }
+    m_fullMask = m_columns.size() >= MAX_COLUMNS ? 0xFFFFFFFFu : ((1u << m_columns.size()) - 1);
+}
+
+/**
+ * @brief 析构函数
+ */
+AIWriteBehindCache::~AIWriteBehindCache()
+{
+    if (m_journal.isOpen()) {
+        syncJournalLocked();
+        m_journal.close();
+    }
+}
+
+/**
+ * @brief 打开日志并恢复上次未刷写的修改
+ */
+int AIWriteBehindCache::open()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QDir().mkpath(QFileInfo(m_journalPath).absolutePath());
+
+    int recovered = replayJournal();
+
+    // 回放后立即压缩，丢弃可能存在的残缺尾记录
+    compactJournalLocked();
+    if (!m_journal.isOpen()) {
+        qCritical() << "AIWriteBehindCache: 无法打开日志文件:" << m_journalPath;
+        return -1;
+    }
+
+    if (recovered > 0) {
+        qDebug() << "AIWriteBehindCache: 从日志恢复" << recovered << "个AI的未刷写修改";
+    }
+    return recovered;
+}
+
+/**
+ * @brief 设置单个字段
+ */
+bool AIWriteBehindCache::setField(const QString& aiId, const QString& column, const QVariant& value)
+{
+    int columnIndex = m_columns.indexOf(column);
+    if (columnIndex < 0) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    bool changed = setFieldLocked(aiId, columnIndex, value, true);
+    if (changed) {
+        syncJournalLocked();
+    }
+    return changed;
+}
+
+/**
+ * @brief 按列顺序设置一整行
+ */
+int AIWriteBehindCache::setRow(const QString& aiId, const QVariantList& values)
+{
+    QMutexLocker locker(&m_mutex);
+
+    int changed = 0;
+    int count = qMin(values.size(), m_columns.size());
+    for (int i = 0; i < count; ++i) {
+        if (setFieldLocked(aiId, i, values.at(i), true)) {
+            ++changed;
+        }
+    }
+
+    if (changed > 0) {
+        syncJournalLocked();
+    }
+    return changed;
+}
+
+/**
+ * @brief 移除AI
+ */
+void AIWriteBehindCache::remove(const QString& aiId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_entries.remove(aiId) > 0) {
+        appendJournal(aiId, REMOVE_RECORD, QVariant());
+        syncJournalLocked();
+    }
+}
+
+/**
+ * @brief 批量移除AI，日志只落盘一次
+ */
+void AIWriteBehindCache::remove(const QStringList& aiIds)
+{
+    QMutexLocker locker(&m_mutex);
+
+    bool removed = false;
+    for (const QString& aiId : aiIds) {
+        if (m_entries.remove(aiId) > 0) {
+            appendJournal(aiId, REMOVE_RECORD, QVariant());
+            removed = true;
+        }
+    }
+
+    if (removed) {
+        syncJournalLocked();
+    }
+}
+
+/**
+ * @brief 将脏数据写入数据库
+ */
+bool AIWriteBehindCache::flush(QSqlDatabase& db, int batchSize)
+{
+    m_lastError.clear();
+    m_lastFlushedRows = 0;
+
+    QStringList newRows;
+    QHash<quint32, QStringList> changedByMask;
+    QHash<QString, QVector<QVariant>> snapshot;
+    QSet<QString> complete;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // 取出脏数据快照，刷写期间的新修改重新置脏，不受影响
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            Entry& entry = it.value();
+            if (entry.dirtyMask == 0) {
+                continue;
+            }
+
+            // 库中无此行且列值不全：UPDATE不会命中，等待整行已知
+            if (entry.awaitingInsert && entry.knownMask != m_fullMask) {
+                continue;
+            }
+
+            snapshot.insert(it.key(), entry.values);
+            m_inFlight.insert(it.key(), entry.dirtyMask);
+
+            if (entry.knownMask == m_fullMask) {
+                complete.insert(it.key());
+            }
+            if (!entry.persisted && entry.knownMask == m_fullMask) {
+                newRows << it.key();
+                m_inFlightNew.insert(it.key());
+            } else {
+                changedByMask[entry.dirtyMask] << it.key();
+            }
+            entry.dirtyMask = 0;
+        }
+    }
+
+    if (snapshot.isEmpty()) {
+        return true;
+    }
+
+    if (!newRows.isEmpty() && !flushNewRows(db, newRows, snapshot, batchSize)) {
+        return false;
+    }
+
+    QStringList missingRows;
+    for (auto it = changedByMask.constBegin(); it != changedByMask.constEnd(); ++it) {
+        if (!flushChangedColumns(db, it.key(), it.value(), snapshot, batchSize, missingRows)) {
+            return false;
+        }
+    }
+
+    // UPDATE未命中的行已不在库中（被外部删除或从未写入）：整行已知的补插入，其余保持为脏
+    QStringList reinsertRows;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString& aiId : missingRows) {
+            if (complete.contains(aiId)) {
+                reinsertRows << aiId;
+            } else {
+                m_inFlightMissing.insert(aiId);
+            }
+        }
+    }
+    if (!reinsertRows.isEmpty()) {
+        qWarning() << "AIWriteBehindCache:" << reinsertRows.size() << "个AI在库中不存在，改为完整插入";
+        if (!flushNewRows(db, reinsertRows, snapshot, batchSize)) {
+            return false;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_lastFlushedRows = snapshot.size() - m_inFlightMissing.size() - m_inFlightRejected.size();
+    return true;
+}
+
+/**
+ * @brief 事务提交后确认刷写
+ */
+void AIWriteBehindCache::commitFlush()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, quint32> flushedMasks;
+    for (auto it = m_inFlight.constBegin(); it != m_inFlight.constEnd(); ++it) {
+        auto entry = m_entries.find(it.key());
+        if (entry == m_entries.end()) {
+            continue;
+        }
+
+        if (m_inFlightMissing.contains(it.key())) {
+            entry->persisted = false;
+            entry->awaitingInsert = true;
+            entry->dirtyMask |= it.value();
+            qWarning() << "AIWriteBehindCache: AI" << it.key() << "在库中不存在且列值不全，暂缓写入";
+            continue;
+        }
+
+        // 被拒绝的行不视为已写入，但同样记录标记，避免重启后反复重试同一坏数据
+        entry->persisted = !m_inFlightRejected.contains(it.key());
+        entry->awaitingInsert = false;
+
+        // 刷写期间再次修改的列仍为脏，不在标记之内
+        quint32 flushedMask = it.value() & ~entry->dirtyMask;
+        if (flushedMask != 0) {
+            flushedMasks.insert(it.key(), flushedMask);
+        }
+    }
+    m_inFlight.clear();
+    m_inFlightNew.clear();
+    m_inFlightMissing.clear();
+    m_inFlightRejected.clear();
+
+    evictCleanLocked();
+
+    qint64 pendingFields = 0;
+    for (const Entry& entry : std::as_const(m_entries)) {
+        pendingFields += qPopulationCount(entry.dirtyMask);
+    }
+
+    // 没有待写字段时日志整体失效，截断即可
+    if (pendingFields == 0 && m_journal.isOpen() && m_journal.resize(0)) {
+        m_journalRecords = 0;
+        syncJournalLocked();
+        return;
+    }
+
+    // 失效记录占多数且日志足够大时才重写，平时只追加标记
+    if (m_journal.size() >= JOURNAL_COMPACT_MIN_BYTES &&
+        m_journalRecords >= pendingFields * JOURNAL_COMPACT_RATIO) {
+        compactJournalLocked();
+        return;
+    }
+
+    for (auto it = flushedMasks.constBegin(); it != flushedMasks.constEnd(); ++it) {
+        appendJournal(it.key(), FLUSHED_RECORD, QVariant(it.value()));
+    }
+    syncJournalLocked();
+}
+
+/**
+ * @brief 事务回滚后恢复本次刷写的脏标记
+ */
+void AIWriteBehindCache::abortFlush()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (auto it = m_inFlight.constBegin(); it != m_inFlight.constEnd(); ++it) {
+        auto entry = m_entries.find(it.key());
+        if (entry != m_entries.end()) {
+            entry->dirtyMask |= it.value();
+        }
+    }
+    m_inFlight.clear();
+    m_inFlightNew.clear();
+    m_inFlightMissing.clear();
+    m_inFlightRejected.clear();
+}
+
+/**
+ * @brief 获取脏AI数量
+ */
+int AIWriteBehindCache::dirtyCount() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    int count = 0;
+    for (const Entry& entry : m_entries) {
+        if (entry.dirtyMask != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 获取缓存中的AI数量
+ */
+int AIWriteBehindCache::cachedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+/**
+ * @brief 设置缓存容量
+ */
+void AIWriteBehindCache::setCapacity(int maxEntries)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(0, maxEntries);
+}
+
+/**
+ * @brief 更新字段（调用方持锁）
+ */
+bool AIWriteBehindCache::setFieldLocked(const QString& aiId, int columnIndex, const QVariant& value, bool journal)
+{
+    Entry& entry = m_entries[aiId];
+    if (entry.values.size() != m_columns.size()) {
+        entry.values.resize(m_columns.size());
+    }
+    entry.lastAccess = ++m_accessClock;
+
+    const quint32 bit = 1u << columnIndex;
+    if ((entry.knownMask & bit) && entry.values[columnIndex] == value) {
+        return false;   // 值未变化，不置脏
+    }
+
+    entry.values[columnIndex] = value;
+    entry.knownMask |= bit;
+    entry.dirtyMask |= bit;
+
+    if (journal) {
+        appendJournal(aiId, columnIndex, value);
+    }
+    return true;
+}
+
+/**
+ * @brief 追加日志记录
+ */
+void AIWriteBehindCache::appendJournal(const QString& aiId, int columnIndex, const QVariant& value)
+{
+    if (m_journal.isOpen()) {
+        m_journal.write(encodeJournalRecord(JOURNAL_MAGIC, aiId, columnIndex, value));
+        ++m_journalRecords;
+    }
+}
+
+/**
+ * @brief 将日志写入落盘
+ */
+bool AIWriteBehindCache::syncJournalLocked()
+{
+    if (!m_journal.isOpen() || !m_journal.flush()) {
+        return false;
+    }
+
+    // flush()只交给操作系统，掉电前须强制写入磁盘
+#ifdef _WIN32
+    return _commit(m_journal.handle()) == 0;
+#else
+    return ::fsync(m_journal.handle()) == 0;
+#endif
+}
+
+/**
+ * @brief 回放日志
+ */
+int AIWriteBehindCache::replayJournal()
+{
+    QFile file(m_journalPath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    QByteArray data = file.readAll();
+    QDataStream stream(data);
+
+    // 进程崩溃可能留下半条记录，遇到第一条无效记录即停止
+    while (!stream.atEnd()) {
+        quint32 magic = 0;
+        quint32 length = 0;
+        quint16 checksum = 0;
+        stream >> magic >> length >> checksum;
+
+        if (stream.status() != QDataStream::Ok || magic != JOURNAL_MAGIC ||
+            length > static_cast<quint32>(data.size())) {
+            break;
+        }
+
+        QByteArray payload(static_cast<int>(length), Qt::Uninitialized);
+        if (stream.readRawData(payload.data(), static_cast<int>(length)) != static_cast<int>(length) ||
+            qChecksum(payload) != checksum) {
+            break;
+        }
+
+        QDataStream record(payload);
+        QString aiId;
+        qint32 columnIndex = 0;
+        QVariant value;
+        record >> aiId >> columnIndex >> value;
+
+        if (columnIndex == REMOVE_RECORD) {
+            m_entries.remove(aiId);
+        } else if (columnIndex == FLUSHED_RECORD) {
+            auto entry = m_entries.find(aiId);
+            if (entry != m_entries.end()) {
+                entry->dirtyMask &= ~value.toUInt();
+                entry->persisted = true;
+            }
+        } else if (columnIndex >= 0 && columnIndex < m_columns.size()) {
+            setFieldLocked(aiId, columnIndex, value, false);
+        }
+    }
+
+    int recovered = 0;
+    for (const Entry& entry : std::as_const(m_entries)) {
+        if (entry.dirtyMask != 0) {
+            ++recovered;
+        }
+    }
+    return recovered;
+}
+
+/**
+ * @brief 重写日志，仅保留仍为脏（含正在刷写）的字段
+ */
+void AIWriteBehindCache::compactJournalLocked()
+{
+    if (m_journal.isOpen()) {
+        m_journal.close();
+    }
+
+    // QSaveFile先写临时文件再原子替换，压缩过程中崩溃不会丢失旧日志
+    QSaveFile compacted(m_journalPath);
+    if (compacted.open(QIODevice::WriteOnly)) {
+        qint64 records = 0;
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            quint32 pending = it->dirtyMask | m_inFlight.value(it.key(), 0);
+            for (int i = 0; i < m_columns.size(); ++i) {
+                if (pending & (1u << i)) {
+                    compacted.write(encodeJournalRecord(JOURNAL_MAGIC, it.key(), i, it->values.at(i)));
+                    ++records;
+                }
+            }
+        }
+        if (compacted.commit()) {
+            m_journalRecords = records;
+        } else {
+            qWarning() << "AIWriteBehindCache: 日志压缩失败:" << compacted.errorString();
+        }
+    }
+
+    m_journal.setFileName(m_journalPath);
+    if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCritical() << "AIWriteBehindCache: 无法打开日志文件:" << m_journal.errorString();
+    }
+}
+
+/**
+ * @brief 按最近使用淘汰超出容量的干净项
+ */
+void AIWriteBehindCache::evictCleanLocked()
+{
+    if (m_entries.size() <= m_capacity) {
+        return;
+    }
+
+    QVector<QPair<quint64, QString>> clean;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it->dirtyMask == 0 && !m_inFlight.contains(it.key())) {
+            clean.append(qMakePair(it->lastAccess, it.key()));
+        }
+    }
+
+    // 淘汰后再次修改的AI按未知旧值处理，只会多写几列，不影响正确性
+    const int excess = qMin(m_entries.size() - m_capacity, clean.size());
+    std::partial_sort(clean.begin(), clean.begin() + excess, clean.end());
+    for (int i = 0; i < excess; ++i) {
+        m_entries.remove(clean.at(i).second);
+    }
+}
+
+/**
+ * @brief 写入首次出现的AI（完整Upsert）
+ */
+bool AIWriteBehindCache::flushNewRows(QSqlDatabase& db, const QStringList& aiIds,
+                                      const QHash<QString, QVector<QVariant>>& snapshot, int batchSize)
+{
+    QVector<QVariantList> columns(m_spec.columns.size());
+    for (int c = 0; c < m_spec.columns.size(); ++c) {
+        const QString& name = m_spec.columns.at(c);
+        int dataIndex = m_columns.indexOf(name);
+        columns[c].reserve(aiIds.size());
+
+        for (const QString& aiId : aiIds) {
+            columns[c] << (name == m_keyColumn ? QVariant(aiId) : snapshot.value(aiId).value(dataIndex));
+        }
+    }
+
+    BulkUpsertWriter writer(m_spec, batchSize, m_dialect);
+    const bool written = writer.upsert(db, columns);
+
+    // 全部行被拒绝时writer返回false，但与连接错误不同，重试也无法写入
+    if (!written && (writer.connectionLost() || writer.rejectedRows().size() != aiIds.size())) {
+        m_lastError = writer.lastError();
+        return false;
+    }
+
+    if (!writer.rejectedRows().isEmpty()) {
+        QMutexLocker locker(&m_mutex);
+        for (int row : writer.rejectedRows()) {
+            m_inFlightRejected.insert(aiIds.at(row));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 按掩码写入已存在AI的变化列
+ */
+bool AIWriteBehindCache::flushChangedColumns(QSqlDatabase& db, quint32 mask, const QStringList& aiIds,
+                                             const QHash<QString, QVector<QVariant>>& snapshot, int batchSize,
+                                             QStringList& missingRows)
+{
+    QVector<int> dirtyColumns;
+    QStringList sourceColumns = { m_keyColumn };
+    QStringList assignments;
+
+    for (int i = 0; i < m_columns.size(); ++i) {
+        if (mask & (1u << i)) {
+            dirtyColumns << i;
+            sourceColumns << m_columns.at(i);
+            assignments << QString("%1 = source.%1").arg(m_columns.at(i));
+        }
+    }
+    for (const BulkUpsertWriter::ComputedColumn& computed : m_spec.computedColumns) {
+        if (computed.applyOnUpdate) {
+            assignments << QString("%1 = %2").arg(computed.name, computed.expression);
+        }
+    }
+
+    // SQLite没有带列名的VALUES派生表，逐行执行同一条预编译UPDATE（本地写入无往返开销）
+    if (m_dialect == SqlDialect::Sqlite) {
+        QStringList setters;
+        for (int column : dirtyColumns) {
+            setters << QString("%1 = ?").arg(m_columns.at(column));
+        }
+        for (const BulkUpsertWriter::ComputedColumn& computed : m_spec.computedColumns) {
+            if (computed.applyOnUpdate) {
+                setters << QString("%1 = %2").arg(computed.name, computed.expression);
+            }
+        }
+
+        QSqlQuery query(db);
+        if (!query.prepare(QString("UPDATE %1 SET %2 WHERE %3 = ?")
+                           .arg(m_spec.targetTable, setters.join(", "), m_keyColumn))) {
+            m_lastError = "变化列写入失败: " + query.lastError().text();
+            return false;
+        }
+
+        for (const QString& aiId : aiIds) {
+            const QVector<QVariant>& values = snapshot.value(aiId);
+            int index = 0;
+            for (int column : dirtyColumns) {
+                query.bindValue(index++, values.value(column));
+            }
+            query.bindValue(index, aiId);
+
+            if (!query.exec()) {
+                m_lastError = "变化列写入失败: " + query.lastError().text();
+                return false;
+            }
+            if (query.numRowsAffected() == 0) {
+                missingRows << aiId;
+            }
+        }
+        return true;
+    }
+
+    QStringList placeholders;
+    for (int i = 0; i < sourceColumns.size(); ++i) {
+        placeholders << "?";
+    }
+    const QString rowPlaceholder = "(" + placeholders.join(", ") + ")";
+
+    // 每块一条 UPDATE ... FROM (VALUES ...)，受SQL Server参数上限约束；
+    // OUTPUT返回实际命中的键，据此找出库中不存在的行
+    int chunkRows = qMax(1, qMin(batchSize, SQLSERVER_MAX_PARAMETERS / sourceColumns.size() - 1));
+
+    for (int offset = 0; offset < aiIds.size(); offset += chunkRows) {
+        int count = qMin(chunkRows, aiIds.size() - offset);
+
+        QStringList rows;
+        for (int r = 0; r < count; ++r) {
+            rows << rowPlaceholder;
+        }
+
+        QSqlQuery query(db);
+        query.prepare(QString(
+            "UPDATE target SET %1 "
+            "OUTPUT inserted.%5 "
+            "FROM %2 AS target "
+            "INNER JOIN (VALUES %3) AS source (%4) "
+            "ON target.%5 = source.%5"
+        ).arg(assignments.join(", "),
+              m_spec.targetTable,
+              rows.join(", "),
+              sourceColumns.join(", "),
+              m_keyColumn));
+
+        for (int r = offset; r < offset + count; ++r) {
+            const QString& aiId = aiIds.at(r);
+            const QVector<QVariant>& values = snapshot.value(aiId);
+            query.addBindValue(aiId);
+            for (int column : dirtyColumns) {
+                query.addBindValue(values.value(column));
+            }
+        }
+
+        if (!query.exec()) {
+            m_lastError = "变化列写入失败: " + query.lastError().text();
+            return false;
+        }
+
+        QSet<QString> updated;
+        while (query.next()) {
+            updated.insert(query.value(0).toString());
+        }
+        for (int r = offset; r < offset + count; ++r) {
+            if (!updated.contains(aiIds.at(r))) {
+                missingRows << aiIds.at(r);
+            }
+        }
+    }
+
+    return true;
+}
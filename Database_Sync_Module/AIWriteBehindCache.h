@@ -0,0 +1,233 @@
+/**
+ * @file AIWriteBehindCache.h
+ * @brief RANOnline EP7 AI系统 - AI玩家写回缓存头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 按AI ID记录每列最新值和脏字段掩码
+ * - 同步间隔内的多次更新合并为一次写入
+ * - 只写入变化的列，相同掩码的行共用一条语句批量执行
+ * - 本地追加日志（每次修改落盘），未刷写的修改在进程重启后可恢复
+ * - 已写入的干净项按最近使用淘汰，内存占用有上限
+ */
+
+#pragma once
+
+#include "BulkUpsertWriter.h"
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+class QSqlDatabase;
+
+/**
+ * @class AIWriteBehindCache
+ * @brief AI玩家数据写回缓存
+ *
+ * setField()只在值与上次已知值不同时置脏，并把修改追加到日志文件。
+ * flush()在调用方的事务内把脏数据写入数据库：尚未写入过且各列均已知的AI
+ * 走完整Upsert，其余AI按脏字段掩码分组，以UPDATE ... FROM (VALUES ...)
+ * 每块一条语句写入变化列。UPDATE未命中的行（库中已不存在）在同一刷写中
+ * 补插入；列值不全无法插入的保持为脏，待整行已知后再写入。
+ *
+ * 调用方提交事务后调用commitFlush()：向日志追加“已写入”标记并落盘，日志
+ * 超过大小阈值且失效记录占多数时才整体重写；没有待写字段时直接截断。
+ * 失败时调用abortFlush()恢复脏标记。
+ */
+class AIWriteBehindCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param spec 目标表描述（单一键列，数据列最多32列）
+     * @param journalPath 日志文件路径
+     * @param dialect SQL方言
+     */
+    AIWriteBehindCache(const BulkUpsertWriter::TableSpec& spec, const QString& journalPath,
+                       SqlDialect dialect = SqlDialect::SqlServer);
+
+    /**
+     * @brief 析构函数
+     */
+    ~AIWriteBehindCache();
+
+    /**
+     * @brief 打开日志并恢复上次未刷写的修改
+     * @return 恢复的AI数量，失败返回-1
+     */
+    int open();
+
+    /**
+     * @brief 设置单个字段
+     * @param aiId AI ID
+     * @param column 列名
+     * @param value 新值
+     * @return 是否产生了修改
+     */
+    bool setField(const QString& aiId, const QString& column, const QVariant& value);
+
+    /**
+     * @brief 按列顺序设置一整行
+     * @param aiId AI ID
+     * @param values 各数据列的值（与spec.columns去掉键列后的顺序一致）
+     * @return 实际变化的列数
+     */
+    int setRow(const QString& aiId, const QVariantList& values);
+
+    /**
+     * @brief 移除AI（删除后不再写回）
+     * @param aiId AI ID
+     */
+    void remove(const QString& aiId);
+
+    /**
+     * @brief 批量移除AI（已由其他途径写入，缓存中的旧值不再写回）
+     * @param aiIds AI ID列表
+     */
+    void remove(const QStringList& aiIds);
+
+    /**
+     * @brief 将脏数据写入数据库（须在事务内调用）
+     * @param db 数据库连接
+     * @param batchSize 单次批量写入行数
+     * @return 是否成功
+     */
+    bool flush(QSqlDatabase& db, int batchSize);
+
+    /**
+     * @brief 事务提交后确认刷写，记录已写入标记并按需压缩日志
+     */
+    void commitFlush();
+
+    /**
+     * @brief 事务回滚后恢复本次刷写的脏标记
+     */
+    void abortFlush();
+
+    /**
+     * @brief 获取脏AI数量
+     * @return 数量
+     */
+    int dirtyCount() const;
+
+    /**
+     * @brief 获取缓存中的AI数量（含干净项）
+     * @return 数量
+     */
+    int cachedCount() const;
+
+    /**
+     * @brief 设置缓存容量，超出时在提交后按最近使用淘汰干净项
+     * @param maxEntries 最大缓存项数（0表示写入后立即淘汰）
+     */
+    void setCapacity(int maxEntries);
+
+    /**
+     * @brief 获取上次刷写写入的行数
+     * @return 行数
+     */
+    int lastFlushedRows() const { return m_lastFlushedRows; }
+
+    /**
+     * @brief 获取上次错误信息
+     * @return 错误信息
+     */
+    QString lastError() const { return m_lastError; }
+
+private:
+    /**
+     * @struct Entry
+     * @brief 单个AI的缓存项
+     */
+    struct Entry {
+        QVector<QVariant> values;       ///< 各列最新值
+        quint32 knownMask = 0;          ///< 已知值的列掩码
+        quint32 dirtyMask = 0;          ///< 待写入列掩码
+        bool persisted = false;         ///< 是否已成功写入过数据库
+        bool awaitingInsert = false;    ///< 库中无此行且列值不全，等待整行已知后插入
+        quint64 lastAccess = 0;         ///< 最近访问序号（LRU淘汰依据）
+    };
+
+    /**
+     * @brief 更新字段（调用方持锁）
+     */
+    bool setFieldLocked(const QString& aiId, int columnIndex, const QVariant& value, bool journal);
+
+    /**
+     * @brief 追加日志记录
+     */
+    void appendJournal(const QString& aiId, int columnIndex, const QVariant& value);
+
+    /**
+     * @brief 回放日志
+     */
+    int replayJournal();
+
+    /**
+     * @brief 将日志写入落盘
+     */
+    bool syncJournalLocked();
+
+    /**
+     * @brief 重写日志，仅保留仍为脏的字段
+     */
+    void compactJournalLocked();
+
+    /**
+     * @brief 按最近使用淘汰超出容量的干净项
+     */
+    void evictCleanLocked();
+
+    /**
+     * @brief 写入首次出现的AI（完整Upsert）
+     */
+    bool flushNewRows(QSqlDatabase& db, const QStringList& aiIds,
+                      const QHash<QString, QVector<QVariant>>& snapshot, int batchSize);
+
+    /**
+     * @brief 按掩码写入已存在AI的变化列
+     * @param missingRows 输出UPDATE未命中（库中不存在）的AI
+     */
+    bool flushChangedColumns(QSqlDatabase& db, quint32 mask, const QStringList& aiIds,
+                             const QHash<QString, QVector<QVariant>>& snapshot, int batchSize,
+                             QStringList& missingRows);
+
+private:
+    BulkUpsertWriter::TableSpec m_spec; ///< 目标表描述
+    QString m_keyColumn;                ///< 键列
+    SqlDialect m_dialect;               ///< SQL方言
+    QStringList m_columns;              ///< 数据列（不含键列）
+    quint32 m_fullMask;                 ///< 全部列掩码
+
+    mutable QMutex m_mutex;             ///< 缓存互斥锁
+    QHash<QString, Entry> m_entries;    ///< AI缓存项
+    QHash<QString, quint32> m_inFlight; ///< 正在刷写的AI及其掩码
+    QSet<QString> m_inFlightNew;        ///< 正在刷写且走完整Upsert的AI
+    QSet<QString> m_inFlightMissing;    ///< 本次刷写中库中不存在且无法补插入的AI
+    QSet<QString> m_inFlightRejected;   ///< 本次刷写中被数据库拒绝的AI
+    int m_capacity;                     ///< 缓存容量
+    quint64 m_accessClock;              ///< 访问序号
+
+    QString m_journalPath;              ///< 日志路径
+    QFile m_journal;                    ///< 日志文件
+    qint64 m_journalRecords;            ///< 日志中的记录数
+
+    int m_lastFlushedRows;              ///< 上次刷写行数
+    QString m_lastError;                ///< 上次错误
+
+    static constexpr quint32 JOURNAL_MAGIC = 0x52574243;   ///< "RWBC"
+    static constexpr int MAX_COLUMNS = 32;
+    static constexpr int REMOVE_RECORD = -1;                ///< 日志中的删除记录
+    static constexpr int FLUSHED_RECORD = -2;               ///< 日志中的已写入标记（值为列掩码）
+    static constexpr int DEFAULT_CAPACITY = 20000;          ///< 默认缓存容量
+    static constexpr qint64 JOURNAL_COMPACT_MIN_BYTES = 4 * 1024 * 1024; ///< 日志重写的最小大小
+    static constexpr int JOURNAL_COMPACT_RATIO = 4;         ///< 记录数超过待写字段数的倍数时重写
+    static constexpr int SQLSERVER_MAX_PARAMETERS = 2100;   ///< SQL Server单语句参数上限
+};
@@ -0,0 +1,400 @@
+/**
+ * @file BulkUpsertWriter.cpp
+ * @brief RANOnline EP7 AI系统 - 批量Upsert写入器实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "BulkUpsertWriter.h"
+#include "OfflineWriteBuffer.h"
+#include <QtCore/QDebug>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlDriver>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/**
+ * @brief 构造函数
+ */
+BulkUpsertWriter::BulkUpsertWriter(const TableSpec& spec, int chunkSize, SqlDialect dialect)
+    : m_spec(spec)
+    , m_chunkSize(qMax(1, chunkSize))
+    , m_dialect(dialect)
+    , m_lastRoundTrips(0)
+    , m_lastAffectedRows(0)
+    , m_connectionLost(false)
+    , m_statementInvalid(false)
+{
+}
+
+/**
+ * @brief 批量Upsert
+ */
+bool BulkUpsertWriter::upsert(QSqlDatabase& db, const QVector<QVariantList>& columnValues)
+{
+    m_lastError.clear();
+    m_lastRoundTrips = 0;
+    m_lastAffectedRows = 0;
+    m_rejectedRows.clear();
+    m_connectionLost = false;
+    m_statementInvalid = false;
+
+    if (columnValues.size() != m_spec.columns.size()) {
+        m_lastError = QString("列数不匹配: 期望%1，实际%2").arg(m_spec.columns.size()).arg(columnValues.size());
+        return false;
+    }
+
+    const int rowCount = columnValues.isEmpty() ? 0 : columnValues.first().size();
+    if (rowCount == 0) {
+        return true;
+    }
+
+    // SQLite本地写入没有往返开销，不经暂存表直接按块Upsert
+    if (m_dialect == SqlDialect::Sqlite) {
+        const int chunkRows = qMax(1, qMin(m_chunkSize, SQLITE_MAX_PARAMETERS / m_spec.columns.size()));
+        for (int offset = 0; offset < rowCount; offset += chunkRows) {
+            if (!writeChunkSplitting(db, columnValues, offset, qMin(chunkRows, rowCount - offset),
+                                     &BulkUpsertWriter::upsertChunkOnConflict)) {
+                return false;
+            }
+        }
+        return m_rejectedRows.size() < rowCount;
+    }
+
+    if (!prepareStagingTable(db)) {
+        return false;
+    }
+
+    // 驱动原生支持参数数组时走execBatch，否则用多行VALUES，受SQL Server参数上限约束
+    const bool useBatch = db.driver()->hasFeature(QSqlDriver::BatchOperations);
+    int chunkRows = m_chunkSize;
+    if (!useBatch) {
+        chunkRows = qMin(chunkRows, SQLSERVER_MAX_PARAMETERS / m_spec.columns.size() - 1);
+        chunkRows = qMin(chunkRows, SQLSERVER_MAX_VALUES_ROWS);
+    }
+
+    const ChunkWriter stageChunk = useBatch ? &BulkUpsertWriter::stageChunkBatch
+                                            : &BulkUpsertWriter::stageChunkMultiRow;
+    for (int offset = 0; offset < rowCount; offset += chunkRows) {
+        if (!writeChunkSplitting(db, columnValues, offset, qMin(chunkRows, rowCount - offset), stageChunk)) {
+            return false;
+        }
+    }
+
+    if (m_rejectedRows.size() == rowCount) {
+        return false;
+    }
+    return mergeStagedRows(db);
+}
+
+/**
+ * @brief 写入一块数据，失败时对半拆分重试
+ */
+bool BulkUpsertWriter::writeChunkSplitting(QSqlDatabase& db, const QVector<QVariantList>& columnValues,
+                                           int offset, int count, ChunkWriter writeChunk)
+{
+    if ((this->*writeChunk)(db, columnValues, offset, count)) {
+        return true;
+    }
+    if (m_connectionLost || m_statementInvalid) {
+        return false;   // 拆分无助于连接中断或语句本身错误
+    }
+
+    // 单行仍失败：拒绝该行，其余行继续写入
+    if (count == 1) {
+        m_rejectedRows.append(offset);
+        qWarning() << "BulkUpsertWriter: 跳过无法写入的行" << columnValues.first().at(offset).toString()
+                   << m_lastError;
+        return true;
+    }
+
+    // 语句级错误只作废整块，二分定位出错的行
+    const int half = count / 2;
+    return writeChunkSplitting(db, columnValues, offset, half, writeChunk) &&
+           writeChunkSplitting(db, columnValues, offset + half, count - half, writeChunk);
+}
+
+/**
+ * @brief 记录语句错误并判断是否为连接中断
+ */
+void BulkUpsertWriter::recordError(QSqlDatabase& db, const QString& context, const QSqlError& error)
+{
+    m_lastError = context + error.text();
+    m_connectionLost = OfflineWriteBuffer::isConnectionError(error) || !db.isOpen();
+}
+
+/**
+ * @brief 创建或清空暂存表
+ */
+bool BulkUpsertWriter::prepareStagingTable(QSqlDatabase& db)
+{
+    QStringList definitions;
+    for (int i = 0; i < m_spec.columns.size(); ++i) {
+        definitions << QString("%1 %2").arg(m_spec.columns[i], m_spec.columnTypes.value(i, "NVARCHAR(MAX)"));
+    }
+
+    // 临时表随会话存在，池化连接上首次创建，之后清空复用
+    QString sql = QString(
+        "IF OBJECT_ID('tempdb..%1') IS NULL "
+        "CREATE TABLE %1 (%2, PRIMARY KEY (%3)) "
+        "ELSE TRUNCATE TABLE %1"
+    ).arg(m_spec.stagingTable, definitions.join(", "), m_spec.keyColumns.join(", "));
+
+    QSqlQuery query(db);
+    ++m_lastRoundTrips;
+    if (!query.exec(sql)) {
+        recordError(db, "暂存表准备失败: ", query.lastError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 使用参数数组写入一块数据
+ */
+bool BulkUpsertWriter::stageChunkBatch(QSqlDatabase& db, const QVector<QVariantList>& columnValues,
+                                       int offset, int count)
+{
+    QStringList placeholders;
+    for (int i = 0; i < m_spec.columns.size(); ++i) {
+        placeholders << "?";
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare(QString("INSERT INTO %1 (%2) VALUES (%3)")
+                       .arg(m_spec.stagingTable, m_spec.columns.join(", "), placeholders.join(", ")))) {
+        recordError(db, "暂存预编译失败: ", query.lastError());
+        m_statementInvalid = true;
+        return false;
+    }
+
+    for (const QVariantList& column : columnValues) {
+        query.addBindValue(column.mid(offset, count));
+    }
+
+    ++m_lastRoundTrips;
+    if (!query.execBatch()) {
+        recordError(db, "暂存写入失败: ", query.lastError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 使用多行VALUES写入一块数据
+ */
+bool BulkUpsertWriter::stageChunkMultiRow(QSqlDatabase& db, const QVector<QVariantList>& columnValues,
+                                          int offset, int count)
+{
+    QStringList rowPlaceholders;
+    for (int i = 0; i < m_spec.columns.size(); ++i) {
+        rowPlaceholders << "?";
+    }
+    const QString row = "(" + rowPlaceholders.join(", ") + ")";
+
+    QStringList rows;
+    rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        rows << row;
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare(QString("INSERT INTO %1 (%2) VALUES %3")
+                       .arg(m_spec.stagingTable, m_spec.columns.join(", "), rows.join(", ")))) {
+        recordError(db, "暂存预编译失败: ", query.lastError());
+        m_statementInvalid = true;
+        return false;
+    }
+
+    for (int r = offset; r < offset + count; ++r) {
+        for (const QVariantList& column : columnValues) {
+            query.addBindValue(column.at(r));
+        }
+    }
+
+    ++m_lastRoundTrips;
+    if (!query.exec()) {
+        recordError(db, "暂存写入失败: ", query.lastError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 从暂存表MERGE到目标表
+ */
+bool BulkUpsertWriter::mergeStagedRows(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    ++m_lastRoundTrips;
+    if (!query.exec(buildMergeSql())) {
+        recordError(db, "集合MERGE失败: ", query.lastError());
+        return false;
+    }
+
+    m_lastAffectedRows = query.numRowsAffected();
+    return true;
+}
+
+/**
+ * @brief 构建MERGE语句
+ */
+QString BulkUpsertWriter::buildMergeSql() const
+{
+    QStringList matchConditions;
+    for (const QString& key : m_spec.keyColumns) {
+        matchConditions << QString("target.%1 = source.%1").arg(key);
+    }
+
+    QStringList updateAssignments;
+    QStringList insertColumns;
+    QStringList insertValues;
+
+    for (const QString& column : m_spec.columns) {
+        if (!m_spec.keyColumns.contains(column)) {
+            updateAssignments << QString("%1 = source.%1").arg(column);
+        }
+        insertColumns << column;
+        insertValues << "source." + column;
+    }
+
+    for (const ComputedColumn& computed : m_spec.computedColumns) {
+        if (computed.applyOnUpdate) {
+            updateAssignments << QString("%1 = %2").arg(computed.name, computed.expression);
+        }
+        insertColumns << computed.name;
+        insertValues << computed.expression;
+    }
+
+    return QString(
+        "MERGE %1 AS target "
+        "USING %2 AS source "
+        "ON %3 "
+        "WHEN MATCHED THEN UPDATE SET %4 "
+        "WHEN NOT MATCHED THEN INSERT (%5) VALUES (%6);"
+    ).arg(m_spec.targetTable,
+          m_spec.stagingTable,
+          matchConditions.join(" AND "),
+          updateAssignments.join(", "),
+          insertColumns.join(", "),
+          insertValues.join(", "));
+}
+
+/**
+ * @brief 生成单行Upsert语句
+ */
+QString BulkUpsertWriter::singleRowUpsertSql(const TableSpec& spec, SqlDialect dialect)
+{
+    if (dialect == SqlDialect::Sqlite) {
+        return buildOnConflictSql(spec, 1);
+    }
+
+    QStringList sourceColumns;
+    QStringList matchConditions;
+    QStringList updateAssignments;
+    QStringList insertColumns;
+    QStringList insertValues;
+
+    for (const QString& column : spec.columns) {
+        sourceColumns << QString("? AS %1").arg(column);
+        if (spec.keyColumns.contains(column)) {
+            matchConditions << QString("target.%1 = source.%1").arg(column);
+        } else {
+            updateAssignments << QString("%1 = source.%1").arg(column);
+        }
+        insertColumns << column;
+        insertValues << "source." + column;
+    }
+
+    for (const ComputedColumn& computed : spec.computedColumns) {
+        if (computed.applyOnUpdate) {
+            updateAssignments << QString("%1 = %2").arg(computed.name, computed.expression);
+        }
+        insertColumns << computed.name;
+        insertValues << computed.expression;
+    }
+
+    return QString(
+        "MERGE %1 AS target "
+        "USING (SELECT %2) AS source "
+        "ON %3 "
+        "WHEN MATCHED THEN UPDATE SET %4 "
+        "WHEN NOT MATCHED THEN INSERT (%5) VALUES (%6);"
+    ).arg(spec.targetTable,
+          sourceColumns.join(", "),
+          matchConditions.join(" AND "),
+          updateAssignments.join(", "),
+          insertColumns.join(", "),
+          insertValues.join(", "));
+}
+
+/**
+ * @brief 直接写入一块数据，冲突键转为更新
+ */
+bool BulkUpsertWriter::upsertChunkOnConflict(QSqlDatabase& db, const QVector<QVariantList>& columnValues,
+                                             int offset, int count)
+{
+    QSqlQuery query(db);
+    if (!query.prepare(buildOnConflictSql(m_spec, count))) {
+        recordError(db, "Upsert预编译失败: ", query.lastError());
+        m_statementInvalid = true;
+        return false;
+    }
+
+    for (int r = offset; r < offset + count; ++r) {
+        for (const QVariantList& column : columnValues) {
+            query.addBindValue(column.at(r));
+        }
+    }
+
+    ++m_lastRoundTrips;
+    if (!query.exec()) {
+        recordError(db, "Upsert写入失败: ", query.lastError());
+        return false;
+    }
+
+    m_lastAffectedRows += query.numRowsAffected();
+    return true;
+}
+
+/**
+ * @brief 构建INSERT ... ON CONFLICT语句
+ */
+QString BulkUpsertWriter::buildOnConflictSql(const TableSpec& spec, int rows)
+{
+    QStringList insertColumns = spec.columns;
+    QStringList rowValues;
+    QStringList updateAssignments;
+
+    for (const QString& column : spec.columns) {
+        rowValues << "?";
+        if (!spec.keyColumns.contains(column)) {
+            updateAssignments << QString("%1 = excluded.%1").arg(column);
+        }
+    }
+
+    for (const ComputedColumn& computed : spec.computedColumns) {
+        insertColumns << computed.name;
+        rowValues << computed.expression;
+        if (computed.applyOnUpdate) {
+            updateAssignments << QString("%1 = %2").arg(computed.name, computed.expression);
+        }
+    }
+
+    const QString row = "(" + rowValues.join(", ") + ")";
+    QStringList values;
+    values.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        values << row;
+    }
+
+    return QString(
+        "INSERT INTO %1 (%2) VALUES %3 "
+        "ON CONFLICT (%4) DO UPDATE SET %5"
+    ).arg(spec.targetTable,
+          insertColumns.join(", "),
+          values.join(", "),
+          spec.keyColumns.join(", "),
+          updateAssignments.join(", "));
+}
@@ -0,0 +1,187 @@
+/**
+ * @file BulkUpsertWriter.h
+ * @brief RANOnline EP7 AI系统 - 批量Upsert写入器头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 行数据先分块写入会话级临时暂存表
+ * - 驱动支持参数数组时使用QSqlQuery::execBatch，否则使用多行VALUES
+ * - 暂存完成后一条集合式MERGE写入目标表
+ * - 往返次数从“每行一次”降为“每块一次 + 1”
+ * - SQLite方言直接分块INSERT ... ON CONFLICT DO UPDATE
+ * - 块写入失败时二分重试，只拒绝真正出错的行
+ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantList>
+#include <QtCore/QVector>
+#include "StorageBackend.h"
+
+class QSqlDatabase;
+class QSqlError;
+
+/**
+ * @class BulkUpsertWriter
+ * @brief 暂存表 + 集合MERGE的批量Upsert
+ *
+ * 使用方需在事务内调用upsert()，暂存表为#临时表，随连接会话存在，
+ * 连接归还连接池后可被下次调用复用（每次调用前会清空）。SQLite没有
+ * MERGE和会话临时表，按块直接写入目标表，冲突键转为更新。
+ *
+ * 某块因语句级错误（约束冲突、数据超长、同批重复键等）写入失败时，
+ * 该块被对半拆分后重试，直到定位到单行；单行仍失败则记入rejectedRows()
+ * 并跳过，其余行照常写入。连接中断或语句预编译失败时立即失败，不再拆分。
+ */
+class BulkUpsertWriter
+{
+public:
+    /**
+     * @struct ComputedColumn
+     * @brief 由SQL表达式生成的列（如GETDATE()）
+     */
+    struct ComputedColumn {
+        QString name;                   ///< 列名
+        QString expression;             ///< SQL表达式
+        bool applyOnUpdate = true;      ///< 更新时是否也写入（否则仅插入时写入）
+    };
+
+    /**
+     * @struct TableSpec
+     * @brief 目标表描述
+     */
+    struct TableSpec {
+        QString targetTable;            ///< 目标表
+        QString stagingTable;           ///< 暂存表名（须以#开头）
+        QStringList columns;            ///< 绑定列（顺序与upsert()的列数据一致）
+        QStringList columnTypes;        ///< 绑定列的SQL类型，用于创建暂存表
+        QStringList keyColumns;         ///< 匹配键列（须为columns子集）
+        QVector<ComputedColumn> computedColumns; ///< 计算列
+    };
+
+    /**
+     * @brief 构造函数
+     * @param spec 目标表描述
+     * @param chunkSize 每次暂存写入的行数
+     * @param dialect SQL方言
+     */
+    BulkUpsertWriter(const TableSpec& spec, int chunkSize, SqlDialect dialect = SqlDialect::SqlServer);
+
+    /**
+     * @brief 生成单行Upsert语句
+     * @param spec 目标表描述
+     * @param dialect SQL方言
+     * @return 按spec.columns顺序绑定参数的语句
+     */
+    static QString singleRowUpsertSql(const TableSpec& spec, SqlDialect dialect);
+
+    /**
+     * @brief 批量Upsert
+     * @param db 数据库连接（须已开启事务）
+     * @param columnValues 按列组织的数据，每个元素为一列的全部行值
+     * @return 是否成功；部分行被拒绝时仍返回true，全部行被拒绝或连接中断时返回false
+     */
+    bool upsert(QSqlDatabase& db, const QVector<QVariantList>& columnValues);
+
+    /**
+     * @brief 获取上次执行的错误信息
+     * @return 错误信息
+     */
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief 获取上次执行中被拒绝的行
+     * @return 行下标（升序）
+     */
+    const QVector<int>& rejectedRows() const { return m_rejectedRows; }
+
+    /**
+     * @brief 上次失败是否由连接中断引起
+     * @return 是否连接中断
+     */
+    bool connectionLost() const { return m_connectionLost; }
+
+    /**
+     * @brief 获取上次执行的数据库往返次数
+     * @return 往返次数
+     */
+    int lastRoundTrips() const { return m_lastRoundTrips; }
+
+    /**
+     * @brief 获取上次MERGE影响的行数
+     * @return 行数
+     */
+    int lastAffectedRows() const { return m_lastAffectedRows; }
+
+private:
+    using ChunkWriter = bool (BulkUpsertWriter::*)(QSqlDatabase&, const QVector<QVariantList>&, int, int);
+
+    /**
+     * @brief 写入一块数据，失败时对半拆分重试
+     * @param writeChunk 实际写入函数
+     * @return 是否继续（连接中断或语句预编译失败时返回false）
+     */
+    bool writeChunkSplitting(QSqlDatabase& db, const QVector<QVariantList>& columnValues,
+                             int offset, int count, ChunkWriter writeChunk);
+
+    /**
+     * @brief 记录语句错误并判断是否为连接中断
+     */
+    void recordError(QSqlDatabase& db, const QString& context, const QSqlError& error);
+
+    /**
+     * @brief 创建或清空暂存表
+     */
+    bool prepareStagingTable(QSqlDatabase& db);
+
+    /**
+     * @brief 使用参数数组写入一块数据
+     */
+    bool stageChunkBatch(QSqlDatabase& db, const QVector<QVariantList>& columnValues, int offset, int count);
+
+    /**
+     * @brief 使用多行VALUES写入一块数据
+     */
+    bool stageChunkMultiRow(QSqlDatabase& db, const QVector<QVariantList>& columnValues, int offset, int count);
+
+    /**
+     * @brief 从暂存表MERGE到目标表
+     */
+    bool mergeStagedRows(QSqlDatabase& db);
+
+    /**
+     * @brief 构建MERGE语句
+     */
+    QString buildMergeSql() const;
+
+    /**
+     * @brief 直接写入一块数据，冲突键转为更新（SQLite）
+     */
+    bool upsertChunkOnConflict(QSqlDatabase& db, const QVector<QVariantList>& columnValues, int offset, int count);
+
+    /**
+     * @brief 构建INSERT ... ON CONFLICT语句
+     * @param spec 目标表描述
+     * @param rows 行数
+     */
+    static QString buildOnConflictSql(const TableSpec& spec, int rows);
+
+private:
+    TableSpec m_spec;                   ///< 目标表描述
+    int m_chunkSize;                    ///< 分块大小
+    SqlDialect m_dialect;               ///< SQL方言
+    QString m_lastError;                ///< 上次错误
+    int m_lastRoundTrips;               ///< 上次往返次数
+    int m_lastAffectedRows;             ///< 上次影响行数
+    QVector<int> m_rejectedRows;        ///< 上次被拒绝的行
+    bool m_connectionLost;              ///< 上次失败是否为连接中断
+    bool m_statementInvalid;            ///< 语句预编译失败（与数据无关，不拆分重试）
+
+    static constexpr int SQLSERVER_MAX_PARAMETERS = 2100;   ///< SQL Server单语句参数上限
+    static constexpr int SQLSERVER_MAX_VALUES_ROWS = 1000;  ///< 单个VALUES子句行数上限
+    static constexpr int SQLITE_MAX_PARAMETERS = 32766;     ///< SQLite单语句参数上限（3.32起）
+};
@@ -0,0 +1,421 @@
+/**
+ * @file ConnectionPool.cpp
+ * @brief RANOnline EP7 AI系统 - 线程亲和数据库连接池实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "ConnectionPool.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtSql/QSqlDatabase>
+#include <atomic>
+
+namespace {
+
+std::atomic<int> g_poolInstances{0};    ///< 连接池编号，保证不同池的连接名不冲突
+
+} // namespace
+
+/**
+ * @brief 等待时间百分位
+ */
+double ConnectionPoolStats::waitPercentileMs(double percentile) const
+{
+    quint64 count = 0;
+    for (quint64 bucket : waitHistogram) {
+        count += bucket;
+    }
+    if (count == 0) {
+        return 0.0;
+    }
+
+    const quint64 target = qMax<quint64>(1, static_cast<quint64>(count * qBound(0.0, percentile, 100.0) / 100.0 + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < WAIT_BUCKETS; ++i) {
+        seen += waitHistogram[i];
+        if (seen >= target) {
+            return static_cast<double>(quint64(1) << (i + 1)) / 1000.0;
+        }
+    }
+    return static_cast<double>(quint64(1) << WAIT_BUCKETS) / 1000.0;
+}
+
+/**
+ * @brief 构造函数
+ */
+ConnectionPool::ConnectionPool(ConnectionFactory factory, const QString& namePrefix,
+                               int minSize, int maxSize, int idleTimeoutMs)
+    : m_factory(std::move(factory))
+    , m_namePrefix(QString("%1_%2").arg(namePrefix).arg(++g_poolInstances))
+    , m_minSize(qMax(0, minSize))
+    , m_maxSize(qMax(1, qMax(minSize, maxSize)))
+    , m_idleTimeoutMs(qMax(0, idleTimeoutMs))
+    , m_total(0)
+    , m_idleCount(0)
+    , m_retiringCount(0)
+    , m_sequence(0)
+    , m_closed(false)
+{
+    m_stats.minSize = m_minSize;
+    m_stats.maxSize = m_maxSize;
+}
+
+/**
+ * @brief 析构函数
+ */
+ConnectionPool::~ConnectionPool()
+{
+    closeAll();
+
+    // 剩余退役连接的所属线程没有再回到连接池，不能跨线程关闭，只释放句柄
+    if (m_retiringCount > 0) {
+        qWarning() << "ConnectionPool: 所属线程未回收的退役连接:" << m_retiringCount;
+    }
+}
+
+/**
+ * @brief 设置连接关闭回调
+ */
+void ConnectionPool::setCloseHook(CloseHook hook)
+{
+    QMutexLocker locker(&m_mutex);
+    m_closeHook = std::move(hook);
+}
+
+/**
+ * @brief 在调用线程上预先创建连接
+ */
+bool ConnectionPool::warmUp(int count)
+{
+    QVector<std::shared_ptr<QSqlDatabase>> connections;
+    bool success = true;
+
+    for (int i = 0; i < count; ++i) {
+        auto connection = tryAcquire(0);
+        if (!connection) {
+            success = false;
+            break;
+        }
+        connections.append(connection);
+    }
+
+    for (auto& connection : connections) {
+        release(connection);
+    }
+    return success;
+}
+
+/**
+ * @brief 获取当前线程的连接
+ */
+std::shared_ptr<QSqlDatabase> ConnectionPool::tryAcquire(int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QDeadlineTimer deadline(qMax(0, timeoutMs));
+    const Qt::HANDLE self = QThread::currentThreadId();
+    bool waited = false;
+
+    QMutexLocker locker(&m_mutex);
+
+    // 先关闭其他线程为腾名额而让本线程退役的连接
+    QVector<std::shared_ptr<QSqlDatabase>> retired = takeRetired(self);
+    if (!retired.isEmpty()) {
+        locker.unlock();
+        for (auto& connection : retired) {
+            closeConnection(std::move(connection));
+        }
+        locker.relock();
+    }
+
+    while (!m_closed) {
+        // 优先复用本线程最近归还的连接
+        auto idle = m_idle.find(self);
+        if (idle != m_idle.end() && !idle->isEmpty()) {
+            auto connection = idle->takeLast().connection;
+            --m_idleCount;
+            recordAcquire(timer.nsecsElapsed(), waited);
+            return connection;
+        }
+
+        // 已到上限时让其他线程的空闲连接退役，把名额让给本线程
+        if (m_total >= m_maxSize) {
+            retireForeignIdle(self);
+        }
+
+        if (m_total < m_maxSize) {
+            // 先占名额，在锁外建立连接
+            ++m_total;
+            const QString connectionName = QString("%1_%2").arg(m_namePrefix).arg(++m_sequence);
+            locker.unlock();
+
+            auto connection = m_factory(connectionName);
+
+            locker.relock();
+            if (!connection) {
+                --m_total;
+                ++m_stats.createFailures;
+                m_condition.wakeAll();
+                return nullptr;
+            }
+
+            m_owners.insert(connection.get(), self);
+            ++m_stats.created;
+            recordAcquire(timer.nsecsElapsed(), waited);
+            return connection;
+        }
+
+        if (deadline.hasExpired()) {
+            ++m_stats.timeouts;
+            qWarning() << "ConnectionPool: 获取连接超时，等待" << timer.elapsed() << "ms，连接数:" << m_total;
+            return nullptr;
+        }
+
+        waited = true;
+        m_condition.wait(&m_mutex, deadline);
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief 归还连接
+ */
+void ConnectionPool::release(std::shared_ptr<QSqlDatabase> connection)
+{
+    if (!connection) {
+        return;
+    }
+
+    const bool open = connection->isOpen();
+    QVector<std::shared_ptr<QSqlDatabase>> toClose;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        toClose = takeRetired(QThread::currentThreadId());
+
+        auto owner = m_owners.find(connection.get());
+        if (owner == m_owners.end()) {
+            qWarning() << "ConnectionPool: 归还的连接不属于本连接池";
+        } else if (open && !m_closed) {
+            m_idle[owner.value()].append({ connection, QDateTime::currentMSecsSinceEpoch() });
+            ++m_idleCount;
+            // 等待者可能属于其他线程，需要全部唤醒重新判断
+            m_condition.wakeAll();
+        } else {
+            // 已断开或连接池已关闭
+            m_owners.erase(owner);
+            --m_total;
+            m_condition.wakeAll();
+            toClose.append(std::move(connection));
+        }
+    }
+
+    for (auto& retired : toClose) {
+        closeConnection(std::move(retired));
+    }
+}
+
+/**
+ * @brief 在线程池线程上获取连接并执行任务
+ */
+void ConnectionPool::acquireAsync(AsyncWork work, int timeoutMs, QThreadPool* threadPool)
+{
+    threadPool->start([this, work = std::move(work), timeoutMs]() {
+        auto connection = tryAcquire(timeoutMs);
+        work(connection);
+        release(connection);
+    });
+}
+
+/**
+ * @brief 关闭空闲超时的连接
+ */
+int ConnectionPool::shrink()
+{
+    QVector<std::shared_ptr<QSqlDatabase>> toClose;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const Qt::HANDLE self = QThread::currentThreadId();
+    int expired = 0;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        toClose = takeRetired(self);
+
+        for (auto it = m_idle.begin(); it != m_idle.end() && m_total > m_minSize;) {
+            QVector<IdleConnection>& list = it.value();
+            // 队首是最久未用的连接
+            while (!list.isEmpty() && m_total > m_minSize &&
+                   now - list.first().idleSinceMs >= m_idleTimeoutMs) {
+                dropIdle(list.takeFirst().connection, it.key(), self, toClose);
+                ++expired;
+            }
+
+            if (list.isEmpty()) {
+                it = m_idle.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 只关闭本线程的连接，其他线程的已退役，由所属线程关闭
+    for (auto& connection : toClose) {
+        closeConnection(std::move(connection));
+    }
+
+    if (expired > 0) {
+        qDebug() << "ConnectionPool: 收缩空闲连接:" << expired;
+    }
+    return expired;
+}
+
+/**
+ * @brief 关闭全部空闲连接
+ */
+void ConnectionPool::closeAll()
+{
+    QVector<std::shared_ptr<QSqlDatabase>> toClose;
+    const Qt::HANDLE self = QThread::currentThreadId();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        toClose = takeRetired(self);
+
+        for (auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+            for (IdleConnection& entry : it.value()) {
+                dropIdle(std::move(entry.connection), it.key(), self, toClose);
+            }
+        }
+        m_idle.clear();
+        m_condition.wakeAll();
+    }
+
+    for (auto& connection : toClose) {
+        closeConnection(std::move(connection));
+    }
+}
+
+/**
+ * @brief 获取统计
+ */
+ConnectionPoolStats ConnectionPool::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    ConnectionPoolStats stats = m_stats;
+    stats.total = m_total;
+    stats.idle = m_idleCount;
+    stats.inUse = m_total - m_idleCount;
+    stats.threads = m_idle.size();
+    stats.retiring = m_retiringCount;
+    return stats;
+}
+
+/**
+ * @brief 让其他线程的一个空闲连接退役
+ */
+bool ConnectionPool::retireForeignIdle(Qt::HANDLE self)
+{
+    for (auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+        if (it.key() == self || it->isEmpty()) {
+            continue;
+        }
+
+        // 取最久未用的那个；所属线程不是本线程，不会放入toClose
+        const Qt::HANDLE owner = it.key();
+        QVector<std::shared_ptr<QSqlDatabase>> toClose;
+        dropIdle(it->takeFirst().connection, owner, self, toClose);
+        if (it->isEmpty()) {
+            m_idle.erase(it);
+        }
+        ++m_stats.retired;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 从连接数中移除一个空闲连接
+ */
+void ConnectionPool::dropIdle(std::shared_ptr<QSqlDatabase> connection, Qt::HANDLE owner, Qt::HANDLE self,
+                              QVector<std::shared_ptr<QSqlDatabase>>& toClose)
+{
+    m_owners.remove(connection.get());
+    --m_total;
+    --m_idleCount;
+
+    if (owner == self) {
+        toClose.append(std::move(connection));
+        return;
+    }
+
+    // QSqlDatabase只能在创建它的线程上使用，交给所属线程关闭
+    m_retiring[owner].append(std::move(connection));
+    ++m_retiringCount;
+}
+
+/**
+ * @brief 取出本线程的退役连接
+ */
+QVector<std::shared_ptr<QSqlDatabase>> ConnectionPool::takeRetired(Qt::HANDLE self)
+{
+    auto it = m_retiring.find(self);
+    if (it == m_retiring.end()) {
+        return {};
+    }
+
+    QVector<std::shared_ptr<QSqlDatabase>> retired = std::move(it.value());
+    m_retiring.erase(it);
+    m_retiringCount -= retired.size();
+    return retired;
+}
+
+/**
+ * @brief 记录一次成功获取的等待时间
+ */
+void ConnectionPool::recordAcquire(qint64 elapsedNs, bool waited)
+{
+    ++m_stats.acquired;
+    if (waited) {
+        ++m_stats.waited;
+    }
+
+    quint64 micros = static_cast<quint64>(qMax<qint64>(0, elapsedNs / 1000));
+    int bucket = 0;
+    while (micros > 1 && bucket < ConnectionPoolStats::WAIT_BUCKETS - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    ++m_stats.waitHistogram[bucket];
+}
+
+/**
+ * @brief 关闭连接并从Qt连接表中移除
+ */
+void ConnectionPool::closeConnection(std::shared_ptr<QSqlDatabase> connection)
+{
+    CloseHook hook;
+    {
+        QMutexLocker locker(&m_mutex);
+        hook = m_closeHook;
+        ++m_stats.closed;
+    }
+
+    if (hook) {
+        hook(connection.get());
+    }
+
+    const QString connectionName = connection->connectionName();
+    connection->close();
+    // 先释放最后一个QSqlDatabase副本，removeDatabase才不会报告连接仍在使用
+    connection.reset();
+    QSqlDatabase::removeDatabase(connectionName);
+}
@@ -0,0 +1,232 @@
+/**
+ * @file ConnectionPool.h
+ * @brief RANOnline EP7 AI系统 - 线程亲和数据库连接池头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 连接固定在创建它的线程上使用，符合QSqlDatabase的线程限制
+ * - 带截止时间的获取，超时返回空而不是无限阻塞
+ * - 异步获取：在线程池线程上获取连接并执行任务
+ * - 按需在minSize与maxSize之间增长，空闲超时后收缩
+ * - 等待时间直方图
+ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+#include <array>
+#include <functional>
+#include <memory>
+
+class QSqlDatabase;
+class QThreadPool;
+
+/**
+ * @struct ConnectionPoolStats
+ * @brief 连接池统计快照
+ */
+struct ConnectionPoolStats
+{
+    static constexpr int WAIT_BUCKETS = 24;    ///< 等待直方图桶数，桶i覆盖[2^i, 2^(i+1))微秒
+
+    int total = 0;                  ///< 当前连接数（含正在创建的）
+    int idle = 0;                   ///< 空闲连接数
+    int inUse = 0;                  ///< 使用中连接数
+    int threads = 0;                ///< 持有连接的线程数
+    int minSize = 0;                ///< 最小连接数
+    int maxSize = 0;                ///< 最大连接数
+    quint64 acquired = 0;           ///< 成功获取次数
+    quint64 waited = 0;             ///< 需要等待的获取次数
+    quint64 timeouts = 0;           ///< 获取超时次数
+    quint64 created = 0;            ///< 创建的连接数
+    quint64 createFailures = 0;     ///< 创建失败次数
+    quint64 closed = 0;             ///< 关闭的连接数
+    quint64 retired = 0;            ///< 为其他线程腾出名额而退役的空闲连接数
+    int retiring = 0;               ///< 已退役、等待所属线程关闭的连接数
+    std::array<quint64, WAIT_BUCKETS> waitHistogram{};  ///< 获取等待时间直方图
+
+    /**
+     * @brief 等待时间百分位
+     * @param percentile 百分位（0-100）
+     * @return 所在桶的上界（毫秒），无记录时返回0
+     */
+    double waitPercentileMs(double percentile) const;
+};
+
+/**
+ * @class ConnectionPool
+ * @brief 线程亲和数据库连接池
+ *
+ * 每个连接只在创建它的线程上借出，空闲连接按所属线程分组、后进先出，
+ * 使同一工作线程反复拿到同一个热连接。当前线程没有空闲连接时在上限内
+ * 新建；已到上限时让其他线程最久未用的空闲连接退役以腾出名额，仍不可得
+ * 则等待到截止时间。
+ *
+ * 连接也只在所属线程上关闭：为其他线程腾名额、shrink()和closeAll()遇到
+ * 其他线程的空闲连接时只将其移入退役列表（不再计入连接数），由所属线程
+ * 在下次tryAcquire()或release()时关闭。所属线程不再回到连接池时，退役
+ * 连接保留到连接池析构。
+ */
+class ConnectionPool
+{
+public:
+    /**
+     * @brief 创建并打开连接，失败返回nullptr
+     */
+    using ConnectionFactory = std::function<std::shared_ptr<QSqlDatabase>(const QString& connectionName)>;
+
+    /**
+     * @brief 连接关闭前的回调（用于销毁其上的预编译语句）
+     */
+    using CloseHook = std::function<void(QSqlDatabase* connection)>;
+
+    /**
+     * @brief 异步获取的任务，获取超时时参数为空，返回后连接自动归还
+     */
+    using AsyncWork = std::function<void(std::shared_ptr<QSqlDatabase> connection)>;
+
+    /**
+     * @brief 构造函数
+     * @param factory 连接工厂
+     * @param namePrefix 连接名前缀
+     * @param minSize 最小连接数（收缩下限）
+     * @param maxSize 最大连接数
+     * @param idleTimeoutMs 空闲超时（毫秒），超过minSize的空闲连接到期后关闭
+     */
+    ConnectionPool(ConnectionFactory factory, const QString& namePrefix,
+                   int minSize, int maxSize, int idleTimeoutMs);
+
+    /**
+     * @brief 析构函数，关闭全部空闲连接
+     */
+    ~ConnectionPool();
+
+    /**
+     * @brief 设置连接关闭回调
+     * @param hook 回调
+     */
+    void setCloseHook(CloseHook hook);
+
+    /**
+     * @brief 在调用线程上预先创建连接
+     * @param count 连接数（不超过maxSize）
+     * @return 是否全部创建成功
+     */
+    bool warmUp(int count);
+
+    /**
+     * @brief 获取当前线程的连接
+     * @param timeoutMs 最长等待时间（毫秒），0为不等待
+     * @return 连接，超时或创建失败返回nullptr
+     */
+    std::shared_ptr<QSqlDatabase> tryAcquire(int timeoutMs);
+
+    /**
+     * @brief 归还连接，已断开的连接直接关闭
+     * @param connection 连接
+     */
+    void release(std::shared_ptr<QSqlDatabase> connection);
+
+    /**
+     * @brief 在线程池线程上获取连接并执行任务
+     * @param work 任务
+     * @param timeoutMs 获取连接的最长等待时间
+     * @param threadPool 执行任务的线程池（须在连接池之前结束）
+     */
+    void acquireAsync(AsyncWork work, int timeoutMs, QThreadPool* threadPool);
+
+    /**
+     * @brief 关闭空闲超时的连接，保留minSize个
+     *
+     * 其他线程的连接只退役，由所属线程随后关闭。
+     * @return 关闭或退役的连接数
+     */
+    int shrink();
+
+    /**
+     * @brief 关闭全部空闲连接并拒绝后续获取，使用中的连接归还时关闭
+     *
+     * 其他线程的空闲连接只退役，由所属线程随后关闭。
+     */
+    void closeAll();
+
+    /**
+     * @brief 获取统计
+     * @return 统计快照
+     */
+    ConnectionPoolStats stats() const;
+
+private:
+    /**
+     * @struct IdleConnection
+     * @brief 空闲连接
+     */
+    struct IdleConnection {
+        std::shared_ptr<QSqlDatabase> connection;   ///< 连接
+        qint64 idleSinceMs = 0;                     ///< 进入空闲的时间
+    };
+
+    /**
+     * @brief 让其他线程最久未用的一个空闲连接退役（调用方持有m_mutex）
+     * @param self 当前线程
+     * @return 是否腾出了名额
+     */
+    bool retireForeignIdle(Qt::HANDLE self);
+
+    /**
+     * @brief 从连接数中移除一个空闲连接，本线程的放入toClose，其他线程的退役（调用方持有m_mutex）
+     * @param connection 连接
+     * @param owner 所属线程
+     * @param self 当前线程
+     * @param toClose 由调用方在锁外关闭的连接
+     */
+    void dropIdle(std::shared_ptr<QSqlDatabase> connection, Qt::HANDLE owner, Qt::HANDLE self,
+                  QVector<std::shared_ptr<QSqlDatabase>>& toClose);
+
+    /**
+     * @brief 取出本线程的退役连接（调用方持有m_mutex）
+     * @param self 当前线程
+     * @return 待关闭的连接
+     */
+    QVector<std::shared_ptr<QSqlDatabase>> takeRetired(Qt::HANDLE self);
+
+    /**
+     * @brief 记录一次成功获取的等待时间（调用方持有m_mutex）
+     * @param elapsedNs 等待时间（纳秒）
+     * @param waited 是否进入过等待
+     */
+    void recordAcquire(qint64 elapsedNs, bool waited);
+
+    /**
+     * @brief 关闭连接并从Qt连接表中移除（不持有m_mutex）
+     * @param connection 连接
+     */
+    void closeConnection(std::shared_ptr<QSqlDatabase> connection);
+
+private:
+    ConnectionFactory m_factory;        ///< 连接工厂
+    CloseHook m_closeHook;              ///< 连接关闭回调
+    QString m_namePrefix;               ///< 连接名前缀（含池编号）
+    int m_minSize;                      ///< 最小连接数
+    int m_maxSize;                      ///< 最大连接数
+    int m_idleTimeoutMs;                ///< 空闲超时
+
+    mutable QMutex m_mutex;             ///< 连接池互斥锁
+    QWaitCondition m_condition;         ///< 连接归还/名额释放通知
+    QHash<Qt::HANDLE, QVector<IdleConnection>> m_idle;  ///< 所属线程 -> 空闲连接（后进先出）
+    QHash<QSqlDatabase*, Qt::HANDLE> m_owners;          ///< 存活连接 -> 所属线程
+    QHash<Qt::HANDLE, QVector<std::shared_ptr<QSqlDatabase>>> m_retiring;  ///< 所属线程 -> 等待其关闭的退役连接
+    int m_retiringCount;                ///< 退役连接数
+    int m_total;                        ///< 当前连接数（含正在创建的）
+    int m_idleCount;                    ///< 空闲连接数
+    quint64 m_sequence;                 ///< 连接名序号
+    bool m_closed;                      ///< 是否已关闭
+
+    ConnectionPoolStats m_stats;        ///< 累计统计（受m_mutex保护）
+};
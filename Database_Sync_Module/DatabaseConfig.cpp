@@ -0,0 +1,99 @@
+/**
+ * @file DatabaseConfig.cpp
+ * @brief RANOnline EP7 AI系统 - 数据库配置结构实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "DatabaseConfig.h"
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+/**
+ * @brief 从JSON配置文件加载
+ */
+DatabaseConfig DatabaseConfig::loadFromFile(const QString& filePath, bool* ok)
+{
+    DatabaseConfig config;
+    if (ok) {
+        *ok = false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "DatabaseConfig: 无法打开配置文件:" << filePath;
+        return config;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "DatabaseConfig: JSON解析错误:" << error.errorString();
+        return config;
+    }
+
+    QJsonObject root = doc.object();
+
+    QJsonObject database = root["database"].toObject();
+    config.backendType = database["type"].toString(config.backendType);
+    QJsonObject sqlite = database["sqlite"].toObject();
+    config.sqlitePath = sqlite["path"].toString(config.sqlitePath);
+    config.sqliteBusyTimeout = sqlite["busyTimeout"].toInt(config.sqliteBusyTimeout);
+
+    QJsonObject connection = root["connection"].toObject();
+    config.serverName = connection["serverName"].toString(config.serverName);
+    config.databaseName = connection["databaseName"].toString(config.databaseName);
+    config.trustedConnection = connection["trustedConnection"].toBool(config.trustedConnection);
+    config.username = connection["username"].toString(config.username);
+    config.password = connection["password"].toString(config.password);
+
+    QJsonObject pool = database["connectionPool"].toObject();
+    config.poolSize = pool["size"].toInt(config.poolSize);
+    config.poolMinSize = pool["minSize"].toInt(config.poolMinSize);
+    config.poolMaxSize = pool["maxSize"].toInt(config.poolMaxSize);
+    config.poolIdleTimeout = pool["idleTimeout"].toInt(config.poolIdleTimeout);
+    config.poolAcquireTimeout = pool["acquireTimeout"].toInt(config.poolAcquireTimeout);
+    config.connectionTimeout = pool["timeout"].toInt(config.connectionTimeout);
+
+    QJsonObject queries = root["queries"].toObject();
+    config.queryTimeout = queries["timeout"].toInt(config.queryTimeout);
+    config.statementCacheSize = queries["statementCacheSize"].toInt(config.statementCacheSize);
+    config.slowQueryThresholdMs = queries["slowQueryThreshold"].toInt(config.slowQueryThresholdMs);
+    config.slowQueryLogSize = queries["slowQueryLogSize"].toInt(config.slowQueryLogSize);
+
+    QJsonObject sync = root["synchronization"].toObject();
+    config.syncInterval = sync["interval"].toInt(config.syncInterval);
+    config.syncBatchSize = sync["batchSize"].toInt(config.syncBatchSize);
+    config.bulkSyncEnabled = sync["bulkMode"].toBool(config.bulkSyncEnabled);
+
+    QJsonObject writeBehind = sync["writeBehind"].toObject();
+    config.writeBehindEnabled = writeBehind["enabled"].toBool(config.writeBehindEnabled);
+    config.writeBehindJournal = writeBehind["journalPath"].toString(config.writeBehindJournal);
+
+    QJsonObject groupCommit = sync["groupCommit"].toObject();
+    config.groupCommitEnabled = groupCommit["enabled"].toBool(config.groupCommitEnabled);
+    config.groupCommitMaxBatch = groupCommit["maxBatch"].toInt(config.groupCommitMaxBatch);
+    config.groupCommitMaxDelayMs = groupCommit["maxDelayMs"].toInt(config.groupCommitMaxDelayMs);
+
+    QJsonObject logPartitions = sync["logPartitions"].toObject();
+    config.logPartitionsEnabled = logPartitions["enabled"].toBool(config.logPartitionsEnabled);
+    config.logBufferMaxRows = logPartitions["maxBufferedRows"].toInt(config.logBufferMaxRows);
+    config.logPrecreateDays = logPartitions["precreateDays"].toInt(config.logPrecreateDays);
+
+    QJsonObject offlineBuffer = sync["offlineBuffer"].toObject();
+    config.offlineBufferEnabled = offlineBuffer["enabled"].toBool(config.offlineBufferEnabled);
+    config.offlineBufferPath = offlineBuffer["path"].toString(config.offlineBufferPath);
+    config.offlineReplayBatch = offlineBuffer["replayBatch"].toInt(config.offlineReplayBatch);
+
+    QJsonObject serverStats = sync["serverStats"].toObject();
+    config.serverStatsCacheEnabled = serverStats["cacheEnabled"].toBool(config.serverStatsCacheEnabled);
+    config.serverStatsReconcileInterval = serverStats["reconcileInterval"].toInt(config.serverStatsReconcileInterval);
+
+    if (ok) {
+        *ok = true;
+    }
+    return config;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file DatabaseConfig.h
+ * @brief RANOnline EP7 AI系统 - 数据库配置结构头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#pragma once
+
+#include <QtCore/QString>
+
+/**
+ * @struct DatabaseConfig
+ * @brief DatabaseManager配置，对应Config/database_config.json
+ */
+struct DatabaseConfig
+{
+    // 存储后端（database节）
+    QString backendType = "SQLServer";              ///< 后端类型：SQLServer或SQLite
+    QString sqlitePath = "data/ran_ai_local.db";    ///< SQLite数据库文件路径
+    int sqliteBusyTimeout = 5000;                   ///< SQLite写锁等待时间（毫秒）
+
+    // 连接参数（connection节）
+    QString serverName = "localhost\\SQLEXPRESS";   ///< 服务器名称
+    QString databaseName = "RAN_AI_Database";       ///< 数据库名称
+    bool trustedConnection = true;                  ///< 是否使用Windows身份验证
+    QString username;                               ///< 用户名
+    QString password;                               ///< 密码
+
+    // 连接池（database.connectionPool节）
+    int poolSize = 10;                              ///< 启动时预建的连接数
+    int poolMinSize = 2;                            ///< 最小连接数（空闲收缩下限）
+    int poolMaxSize = 50;                           ///< 最大连接数
+    int poolIdleTimeout = 300000;                   ///< 空闲连接超时（毫秒）
+    int poolAcquireTimeout = 2000;                  ///< 获取连接的最长等待（毫秒）
+    int connectionTimeout = 30000;                  ///< 连接超时（毫秒）
+    int queryTimeout = 10000;                       ///< 查询超时（毫秒，queries.timeout）
+    int statementCacheSize = 64;                    ///< 每个连接缓存的预编译语句数，0为关闭
+    int slowQueryThresholdMs = 200;                 ///< 慢查询阈值（毫秒，queries.slowQueryThreshold）
+    int slowQueryLogSize = 256;                     ///< 保留的最近慢查询条数
+
+    // 同步（synchronization节）
+    int syncInterval = 5000;                        ///< 同步间隔（毫秒）
+    int syncBatchSize = 100;                        ///< 批量同步分块大小（行）
+    bool bulkSyncEnabled = true;                    ///< 是否使用暂存表+集合MERGE的批量同步
+    bool writeBehindEnabled = true;                 ///< 单条同步是否走写回缓存
+    QString writeBehindJournal = "data/ai_write_behind.journal"; ///< 写回缓存日志路径
+    bool groupCommitEnabled = true;                 ///< 状态写入是否走分组提交（分区日志关闭时日志也走）
+    int groupCommitMaxBatch = 500;                  ///< 分组提交触发数量
+    int groupCommitMaxDelayMs = 50;                 ///< 分组提交最长等待（毫秒）
+    bool logPartitionsEnabled = true;               ///< 操作日志是否写入按天分区的日志表（开启时不经过分组提交）
+    int logBufferMaxRows = 100000;                  ///< 操作日志缓冲上限（行）
+    int logPrecreateDays = 3;                       ///< 提前创建的日志分区天数
+    bool offlineBufferEnabled = true;               ///< 远端离线时写操作是否缓冲到本地
+    QString offlineBufferPath = "data/ran_ai_offline.db"; ///< 离线缓冲文件路径
+    int offlineReplayBatch = 500;                   ///< 每次重放的最大操作数
+    bool serverStatsCacheEnabled = true;            ///< 服务器统计是否使用增量维护的内存汇总
+    int serverStatsReconcileInterval = 300000;      ///< 服务器统计对账间隔（毫秒）
+
+    /**
+     * @brief 从JSON配置文件加载
+     * @param filePath 配置文件路径
+     * @param ok 输出是否加载成功（可为空）
+     * @return 配置对象，文件缺失的字段保留默认值
+     */
+    static DatabaseConfig loadFromFile(const QString& filePath, bool* ok = nullptr);
+};
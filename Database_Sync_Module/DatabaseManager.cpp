@@ -7,12 +7,119 @@
  */
 
 #include "DatabaseManager.h"
+#include "DatabaseConfig.h"
+#include "BulkUpsertWriter.h"
+#include "AIWriteBehindCache.h"
+#include "PreparedStatementCache.h"
+#include "RowCursor.h"
+#include "GroupCommitPipeline.h"
+#include "ConnectionPool.h"
+#include "LogPartitionStore.h"
+#include "StorageBackend.h"
+#include "OfflineWriteBuffer.h"
+#include "ServerStatsAggregator.h"
+#include "QueryMetrics.h"
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
 #include <QtSql/QSqlError>
 #include <QtSql/QSqlQuery>
 #include <QtConcurrent/QtConcurrent>
 
+namespace {
+
+/**
+ * @brief RAN_AI_Players批量Upsert的表描述
+ * @param nowExpression 后端的当前时间表达式
+ */
+BulkUpsertWriter::TableSpec aiPlayersUpsertSpec(const QString& nowExpression)
+{
+    BulkUpsertWriter::TableSpec spec;
+    spec.targetTable = "RAN_AI_Players";
+    spec.stagingTable = "#RAN_AI_Players_Stage";
+    spec.columns = { "ai_id", "name", "school", "level", "server_id",
+                     "aggression", "intelligence", "social", "anti_lag" };
+    spec.columnTypes = { "NVARCHAR(50) NOT NULL", "NVARCHAR(100)", "INT", "INT", "INT",
+                         "INT", "INT", "INT", "BIT" };
+    spec.keyColumns = { "ai_id" };
+    spec.computedColumns = {
+        { "created_time", nowExpression, false },
+        { "last_update", nowExpression, true }
+    };
+    return spec;
+}
+
+/**
+ * @brief AI玩家Upsert参数（与aiPlayersUpsertSpec()列顺序一致）
+ */
+QVariantList aiPlayerParams(const QString& aiId, const AIPlayerData& playerData)
+{
+    return {
+        aiId,
+        playerData.name,
+        static_cast<int>(playerData.school),
+        playerData.level,
+        playerData.serverId,
+        playerData.aggression,
+        playerData.intelligence,
+        playerData.social,
+        playerData.antiLag
+    };
+}
+
+/**
+ * @enum AiPlayerColumn
+ * @brief AI玩家读取列下标（与aiPlayerColumns()顺序一致）
+ */
+enum AiPlayerColumn {
+    AiColAiId,
+    AiColName,
+    AiColSchool,
+    AiColLevel,
+    AiColServerId,
+    AiColAggression,
+    AiColIntelligence,
+    AiColSocial,
+    AiColAntiLag
+};
+
+/**
+ * @brief RAN_AI_Players读取列描述
+ */
+const QVector<ColumnSpec>& aiPlayerColumns()
+{
+    static const QVector<ColumnSpec> columns = {
+        { "ai_id" },
+        { "name" },
+        { "school" },
+        { "level" },
+        { "server_id" },
+        { "aggression" },
+        { "intelligence" },
+        { "social" },
+        { "anti_lag" }
+    };
+    return columns;
+}
+
+/**
+ * @brief 从游标当前行直接填充AIPlayerData
+ */
+void readAiPlayer(const RowCursor& cursor, AIPlayerData& playerData)
+{
+    playerData.name = cursor.stringAt(AiColName);
+    playerData.school = static_cast<School>(cursor.intAt(AiColSchool));
+    playerData.level = static_cast<int>(cursor.intAt(AiColLevel));
+    playerData.serverId = static_cast<int>(cursor.intAt(AiColServerId));
+    playerData.aggression = static_cast<int>(cursor.intAt(AiColAggression));
+    playerData.intelligence = static_cast<int>(cursor.intAt(AiColIntelligence));
+    playerData.social = static_cast<int>(cursor.intAt(AiColSocial));
+    playerData.antiLag = cursor.boolAt(AiColAntiLag);
+}
+
+} // namespace
+
 /**
  * @brief 构造函数
  */
@@ -26,13 +133,15 @@ DatabaseManager::DatabaseManager(QObject *parent)
     , m_syncTimer(new QTimer(this))
     , m_heartbeatTimer(new QTimer(this))
     , m_threadPool(new QThreadPool(this))
+    , m_statementCounters(std::make_unique<StatementCacheCounters>())
 {
     // 配置定时器
     m_syncTimer->setInterval(5000);     // 5秒同步一次
-    m_heartbeatTimer->setInterval(60000); // 60秒心跳一次
+    m_heartbeatTimer->setInterval(HEARTBEAT_INTERVAL * 1000); // 60秒心跳一次
     
-    // 配置线程池
+    // 配置线程池（工作线程常驻，各自固定的池连接一直可复用）
     m_threadPool->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+    m_threadPool->setExpiryTimeout(-1);
     
     // 连接信号槽
     connect(m_syncTimer, &QTimer::timeout, this, &DatabaseManager::performSync);
@@ -64,26 +173,85 @@ bool DatabaseManager::initialize(const DatabaseConfig& config)
         return false;
     }
     
+    // 查询统计：按语句的延迟直方图与慢查询记录
+    m_queryMetrics = std::make_unique<QueryMetrics>(m_config.slowQueryThresholdMs,
+                                                    m_config.slowQueryLogSize);
+    
+    // 存储后端：SQL Server或本地SQLite（database.type）
+    m_backend = StorageBackend::create(m_config);
+    qDebug() << "DatabaseManager: 存储后端:" << m_backend->name();
+    
+    // 离线缓冲：远端不可达时写操作先落到本地，恢复后按顺序重放
+    if (m_config.offlineBufferEnabled && m_backend->dialect() != SqlDialect::Sqlite) {
+        m_offlineBuffer = std::make_unique<OfflineWriteBuffer>(m_config.offlineBufferPath);
+        if (!m_offlineBuffer->open()) {
+            qWarning() << "DatabaseManager: 离线缓冲不可用";
+            m_offlineBuffer.reset();
+        }
+    }
+    
     // 创建连接池
-    if (!createConnectionPool()) {
+    bool poolReady = createConnectionPool();
+    if (!poolReady && !m_offlineBuffer) {
         qCritical() << "DatabaseManager: 连接池创建失败";
         return false;
     }
     
+    // 分区日志存储：日志先缓冲，由同步定时器批量写入按天分区的日志表
+    if (m_config.logPartitionsEnabled && m_backend->supportsPartitionedLogs()) {
+        m_logStore = std::make_unique<LogPartitionStore>(m_config.logBufferMaxRows,
+                                                         m_config.logPrecreateDays);
+    }
+    
     // 初始化数据库结构
-    if (!initializeDatabaseSchema()) {
+    m_schemaReady = poolReady && initializeDatabaseSchema();
+    if (!m_schemaReady && !m_offlineBuffer) {
         qCritical() << "DatabaseManager: 数据库结构初始化失败";
         return false;
     }
     
     m_initialized = true;
-    m_connected = true;
+    m_connected = m_schemaReady;
+    
+    const SqlDialect dialect = m_backend->dialect();
+    
+    // 写回缓存：恢复上次未刷写的修改，在首次同步时写入
+    if (m_config.writeBehindEnabled) {
+        m_writeBehindCache = std::make_unique<AIWriteBehindCache>(aiPlayersUpsertSpec(m_backend->nowExpression()),
+                                                                  m_config.writeBehindJournal,
+                                                                  dialect);
+        if (m_writeBehindCache->open() < 0) {
+            qWarning() << "DatabaseManager: 写回缓存日志不可用，改为直接写入";
+            m_writeBehindCache.reset();
+        }
+    }
+    
+    // 分组提交：高频的日志和状态写入合并为每批一次提交
+    if (m_config.groupCommitEnabled) {
+        m_groupCommit = std::make_unique<GroupCommitPipeline>(
+            [this]() { return getConnection(); },
+            [this](std::shared_ptr<QSqlDatabase> connection) { releaseConnection(connection); },
+            m_config.groupCommitMaxBatch,
+            m_config.groupCommitMaxDelayMs);
+        m_groupCommit->start();
+    }
+    
+    // 服务器统计：首次同步时扫描加载，之后由写入路径增量维护
+    if (m_config.serverStatsCacheEnabled) {
+        m_serverStats = std::make_unique<ServerStatsAggregator>();
+    }
+    
+    // 远端不可达时以离线模式启动，心跳按重连间隔检测恢复
+    if (!m_connected) {
+        qWarning() << "DatabaseManager: 数据库不可达，以离线模式启动";
+        m_heartbeatTimer->setInterval(RECONNECT_INTERVAL * 1000);
+    }
     
     // 启动定时器
     m_syncTimer->start();
     m_heartbeatTimer->start();
     
-    emit connectionStateChanged(true);
+    emit connectionStateChanged(m_connected);
     
     qDebug() << "DatabaseManager: 初始化成功";
     return true;
@@ -103,9 +271,35 @@ void DatabaseManager::shutdown()
     // 等待所有查询完成
     m_threadPool->waitForDone(10000);
     
+    // 写完分组提交中剩余的操作
+    if (m_groupCommit) {
+        m_groupCommit->stop();
+        m_groupCommit.reset();
+    }
+    
+    // 刷写写回缓存，失败的修改保留在日志中下次启动恢复
+    if (m_writeBehindCache) {
+        flushWriteBehindCache();
+        m_writeBehindCache.reset();
+    }
+    
+    // 写入缓冲中剩余的操作日志
+    if (m_logStore) {
+        flushLogStore();
+        m_logStore.reset();
+    }
+    
     // 关闭连接池
     closeConnectionPool();
     
+    m_serverStats.reset();
+    
+    // 未重放的操作保留在本地，下次启动后重放
+    if (m_offlineBuffer) {
+        m_offlineBuffer->close();
+        m_offlineBuffer.reset();
+    }
+    
     m_initialized = false;
     m_connected = false;
     
@@ -119,63 +313,76 @@ void DatabaseManager::shutdown()
  */
 bool DatabaseManager::syncAiData(const QString& aiId, const AIPlayerData& playerData)
 {
-    if (!m_connected) {
+    if (!m_connected && !m_offlineBuffer) {
         qWarning() << "DatabaseManager: 未连接到数据库";
         return false;
     }
     
-    QString sql = R"(
-        MERGE RAN_AI_Players AS target
-        USING (SELECT ? AS ai_id, ? AS name, ? AS school, ? AS level, 
-                      ? AS server_id, ? AS aggression, ? AS intelligence, 
-                      ? AS social, ? AS anti_lag, GETDATE() AS last_update) AS source
-        ON target.ai_id = source.ai_id
-        WHEN MATCHED THEN
-            UPDATE SET name = source.name, school = source.school, level = source.level,
-                      server_id = source.server_id, aggression = source.aggression,
-                      intelligence = source.intelligence, social = source.social,
-                      anti_lag = source.anti_lag, last_update = source.last_update
-        WHEN NOT MATCHED THEN
-            INSERT (ai_id, name, school, level, server_id, aggression, intelligence, 
-                   social, anti_lag, created_time, last_update)
-            VALUES (source.ai_id, source.name, source.school, source.level,
-                   source.server_id, source.aggression, source.intelligence,
-                   source.social, source.anti_lag, GETDATE(), source.last_update);
-    )";
+    bool success = true;
     
-    return executeQuery(sql, {
-        aiId,
-        playerData.name,
-        static_cast<int>(playerData.school),
-        playerData.level,
-        playerData.serverId,
-        playerData.aggression,
-        playerData.intelligence,
-        playerData.social,
-        playerData.antiLag
-    });
+    // 写回模式：只记录变化的列，由performSync合并写入
+    if (m_writeBehindCache) {
+        m_writeBehindCache->setRow(aiId, {
+            playerData.name,
+            static_cast<int>(playerData.school),
+            playerData.level,
+            playerData.serverId,
+            playerData.aggression,
+            playerData.intelligence,
+            playerData.social,
+            playerData.antiLag
+        });
+    } else {
+        QString sql = BulkUpsertWriter::singleRowUpsertSql(aiPlayersUpsertSpec(m_backend->nowExpression()),
+                                                           m_backend->dialect());
+        success = executeWrite(sql, aiPlayerParams(aiId, playerData));
+    }
+    
+    if (success && m_serverStats) {
+        m_serverStats->upsertPlayer(aiId, playerData.serverId, playerData.level);
+    }
+    
+    return success;
 }
 
 /**
  * @brief 更新AI状态
+ * 
+ * 分组提交开启时返回值只表示已受理；之后远端写入失败且未转入离线缓冲时
+ * 发出asyncWriteFailed，并让服务器统计在下次同步时重新对账。
  */
 bool DatabaseManager::updateAiStatus(const QString& aiId, AIStatus status)
 {
-    if (!m_connected) {
+    if (!m_connected && !m_offlineBuffer) {
         qWarning() << "DatabaseManager: 未连接到数据库";
         return false;
     }
     
-    QString sql = R"(
+    QString sql = QString(R"(
         UPDATE RAN_AI_Players 
-        SET status = ?, last_update = GETDATE()
+        SET status = ?, last_update = %1
         WHERE ai_id = ?
-    )";
+    )").arg(m_backend->nowExpression());
     
-    return executeQuery(sql, {
-        static_cast<int>(status),
-        aiId
-    });
+    QVariantList params = { static_cast<int>(status), aiId };
+    
+    bool success = false;
+    if (m_groupCommit && m_connected) {
+        success = m_groupCommit->submit(sql, params, [this, sql, params](bool success, const QString& error) {
+            if (!success) {
+                handleAsyncWriteFailure(sql, params, error);
+            }
+        });
+    } else {
+        success = executeWrite(sql, params);
+    }
+    
+    // 分组提交在受理时即计入，之后写入失败由对账纠正
+    if (success && m_serverStats) {
+        m_serverStats->setStatus(aiId, static_cast<int>(status));
+    }
+    
+    return success;
 }
 
 /**
@@ -183,14 +390,23 @@ bool DatabaseManager::updateAiStatus(const QString& aiId, AIStatus status)
  */
 bool DatabaseManager::deleteAiData(const QString& aiId)
 {
-    if (!m_connected) {
+    if (!m_connected && !m_offlineBuffer) {
         qWarning() << "DatabaseManager: 未连接到数据库";
         return false;
     }
     
+    if (m_writeBehindCache) {
+        m_writeBehindCache->remove(aiId);
+    }
+    
     QString sql = "DELETE FROM RAN_AI_Players WHERE ai_id = ?";
     
-    return executeQuery(sql, { aiId });
+    bool success = executeWrite(sql, { aiId });
+    if (success && m_serverStats) {
+        m_serverStats->removePlayer(aiId);
+    }
+    
+    return success;
 }
 
 /**
@@ -225,6 +441,7 @@ QVector<AIPlayerData> DatabaseManager::getAiList(int serverId)
     }
     
     QSqlQuery query(*connection);
+    query.setForwardOnly(true);
     query.prepare(sql);
     
     for (const auto& param : params) {
@@ -232,18 +449,14 @@ QVector<AIPlayerData> DatabaseManager::getAiList(int serverId)
     }
     
     if (query.exec()) {
-        while (query.next()) {
-            AIPlayerData playerData;
-            playerData.name = query.value("name").toString();
-            playerData.school = static_cast<School>(query.value("school").toInt());
-            playerData.level = query.value("level").toInt();
-            playerData.serverId = query.value("server_id").toInt();
-            playerData.aggression = query.value("aggression").toInt();
-            playerData.intelligence = query.value("intelligence").toInt();
-            playerData.social = query.value("social").toInt();
-            playerData.antiLag = query.value("anti_lag").toBool();
-            
-            result.append(playerData);
+        // 列序号只解析一次，逐行直接填充，不再按列名查找
+        RowCursor cursor(query);
+        if (cursor.bind(aiPlayerColumns())) {
+            while (cursor.next()) {
+                AIPlayerData playerData;
+                readAiPlayer(cursor, playerData);
+                result.append(playerData);
+            }
         }
     } else {
         qCritical() << "DatabaseManager: 查询AI列表失败:" << query.lastError().text();
@@ -253,6 +466,173 @@ QVector<AIPlayerData> DatabaseManager::getAiList(int serverId)
     return result;
 }
 
+/**
+ * @brief 按服务器统计AI数量
+ */
+QMap<int, int> DatabaseManager::getAiCountByServer()
+{
+    QMap<int, int> result;
+    
+    if (!m_connected) {
+        qWarning() << "DatabaseManager: 未连接到数据库";
+        return result;
+    }
+    
+    auto connection = getConnection();
+    if (!connection) {
+        return result;
+    }
+    
+    QSqlQuery query(*connection);
+    query.setForwardOnly(true);
+    
+    if (query.exec("SELECT server_id, COUNT(*) FROM RAN_AI_Players GROUP BY server_id")) {
+        while (query.next()) {
+            result[query.value(0).toInt()] = query.value(1).toInt();
+        }
+    } else {
+        qCritical() << "DatabaseManager: 统计服务器AI数量失败:" << query.lastError().text();
+    }
+    
+    releaseConnection(connection);
+    return result;
+}
+
+/**
+ * @brief 将服务器内的AI按ai_id切分为行数相近的区间
+ */
+QStringList DatabaseManager::getAiKeyBoundaries(int serverId, int parts)
+{
+    QStringList result;
+    
+    if (!m_connected || parts <= 1) {
+        return result;
+    }
+    
+    // NTILE按ai_id顺序等分，每组的最小ai_id即区间下界
+    QString sql = R"(
+        SELECT MIN(ai_id) AS lower_bound
+        FROM (
+            SELECT ai_id, NTILE(?) OVER (ORDER BY ai_id) AS part
+            FROM RAN_AI_Players
+            WHERE server_id = ?
+        ) AS parts
+        GROUP BY part
+        ORDER BY part
+    )";
+    
+    auto connection = getConnection();
+    if (!connection) {
+        return result;
+    }
+    
+    QSqlQuery query(*connection);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(parts);
+    query.addBindValue(serverId);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            result << query.value(0).toString();
+        }
+    } else {
+        qCritical() << "DatabaseManager: 计算分片边界失败:" << query.lastError().text();
+    }
+    
+    releaseConnection(connection);
+    return result;
+}
+
+/**
+ * @brief 流式扫描一个分片的AI数据
+ */
+int DatabaseManager::scanAiShard(int serverId, const QString& fromAiId, const QString& toAiId,
+                                 const std::function<void(const QString&, const AIPlayerData&)>& visitor)
+{
+    QString condition = "server_id = ?";
+    QVariantList params = { serverId };
+    if (!fromAiId.isEmpty()) {
+        condition += " AND ai_id >= ?";
+        params << fromAiId;
+    }
+    if (!toAiId.isEmpty()) {
+        condition += " AND ai_id < ?";
+        params << toAiId;
+    }
+    
+    return scanAiPlayers(condition, params, visitor);
+}
+
+/**
+ * @brief 流式扫描指定时间之后有变化的AI数据
+ */
+int DatabaseManager::scanAiChangedSince(const QDateTime& since,
+                                        const std::function<void(const QString&, const AIPlayerData&)>& visitor)
+{
+    return scanAiPlayers("last_update >= ?", { since }, visitor);
+}
+
+/**
+ * @brief 按条件流式扫描AI数据
+ */
+int DatabaseManager::scanAiPlayers(const QString& condition, const QVariantList& params,
+                                   const std::function<void(const QString&, const AIPlayerData&)>& visitor)
+{
+    if (!m_connected) {
+        qWarning() << "DatabaseManager: 未连接到数据库";
+        return -1;
+    }
+    
+    QString sql = R"(
+        SELECT ai_id, name, school, level, server_id, aggression, 
+               intelligence, social, anti_lag
+        FROM RAN_AI_Players
+        WHERE )" + condition;
+    
+    // 每次扫描独占一个池连接，多个扫描可在不同线程并行执行
+    auto connection = getConnection();
+    if (!connection) {
+        return -1;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    QSqlQuery query(*connection);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    
+    for (const auto& param : params) {
+        query.addBindValue(param);
+    }
+    
+    int rows = -1;
+    if (query.exec()) {
+        RowCursor cursor(query);
+        if (cursor.bind(aiPlayerColumns())) {
+            rows = 0;
+            while (cursor.next()) {
+                AIPlayerData playerData;
+                readAiPlayer(cursor, playerData);
+                visitor(cursor.stringAt(AiColAiId), playerData);
+                ++rows;
+            }
+        }
+    } else {
+        qCritical() << "DatabaseManager: 扫描AI数据失败:" << query.lastError().text();
+    }
+    
+    // 耗时包含逐行回调，行数是实际读出的行
+    if (m_queryMetrics) {
+        m_queryMetrics->record(sql, timer.nsecsElapsed(), rows >= 0, qMax(rows, 0),
+                               QueryMetrics::parameterBytes(params), params);
+    }
+    
+    releaseConnection(connection);
+    return rows;
+}
+
 /**
  * @brief 获取服务器统计信息
  */
@@ -260,6 +640,22 @@ QMap<int, ServerStats> DatabaseManager::getServerStats()
 {
     QMap<int, ServerStats> result;
     
+    // 增量维护的汇总：O(服务器数)，不扫描AI玩家表
+    if (m_serverStats && m_serverStats->isReady()) {
+        const QMap<int, ServerAggregate> aggregates = m_serverStats->snapshot();
+        for (auto it = aggregates.constBegin(); it != aggregates.constEnd(); ++it) {
+            ServerStats stats;
+            stats.totalCount = it->totalCount;
+            stats.onlineCount = it->onlineCount;
+            stats.averageLevel = it->averageLevel;
+            stats.loadPercentage = stats.totalCount > 0 ? 
+                (static_cast<double>(stats.onlineCount) / stats.totalCount * 100) : 0.0;
+            
+            result[it.key()] = stats;
+        }
+        return result;
+    }
+    
     if (!m_connected) {
         qWarning() << "DatabaseManager: 未连接到数据库";
         return result;
@@ -279,8 +675,12 @@ QMap<int, ServerStats> DatabaseManager::getServerStats()
         return result;
     }
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QSqlQuery query(*connection);
-    if (query.exec(sql)) {
+    bool success = query.exec(sql);
+    if (success) {
         while (query.next()) {
             int serverId = query.value("server_id").toInt();
             
@@ -297,26 +697,50 @@ QMap<int, ServerStats> DatabaseManager::getServerStats()
         qCritical() << "DatabaseManager: 查询服务器统计失败:" << query.lastError().text();
     }
     
+    if (m_queryMetrics) {
+        m_queryMetrics->record(sql, timer.nsecsElapsed(), success, result.size());
+    }
+    
     releaseConnection(connection);
     return result;
 }
 
 /**
  * @brief 记录AI操作日志
+ * 
+ * 分区日志开启（默认）时只追加到LogPartitionStore，由performSync批量写入，
+ * 不经过分组提交；关闭分区日志时才走分组提交，返回值只表示已受理，
+ * 失败通过asyncWriteFailed上报。
  */
 bool DatabaseManager::logAiOperation(const QString& aiId, const QString& operation, 
                                     const QString& details)
 {
-    if (!m_connected) {
+    if (!m_connected && !m_offlineBuffer) {
         return false;
     }
     
-    QString sql = R"(
+    // 分区日志存储：只做内存追加，由performSync批量写入
+    if (m_logStore) {
+        m_logStore->append({ aiId, operation, details, QDateTime::currentDateTime() });
+        return true;
+    }
+    
+    QString sql = QString(R"(
         INSERT INTO RAN_AI_Logs (ai_id, operation, details, timestamp)
-        VALUES (?, ?, ?, GETDATE())
-    )";
+        VALUES (?, ?, ?, %1)
+    )").arg(m_backend->nowExpression());
+    
+    QVariantList params = { aiId, operation, details };
+    
+    if (m_groupCommit && m_connected) {
+        return m_groupCommit->submit(sql, params, [this, sql, params](bool success, const QString& error) {
+            if (!success) {
+                handleAsyncWriteFailure(sql, params, error);
+            }
+        });
+    }
     
-    return executeQuery(sql, { aiId, operation, details });
+    return executeWrite(sql, params);
 }
 
 /**
@@ -328,21 +752,36 @@ bool DatabaseManager::cleanupExpiredData(int daysToKeep)
         return false;
     }
     
-    // 清理过期日志
-    QString logSql = R"(
-        DELETE FROM RAN_AI_Logs 
-        WHERE timestamp < DATEADD(day, -?, GETDATE())
-    )";
+    // 清理过期日志：分区存储按整天截断分区，不逐行DELETE锁表
+    bool logCleanup = false;
+    if (m_logStore) {
+        auto connection = getConnection();
+        if (connection) {
+            logCleanup = m_logStore->dropPartitionsBefore(*connection,
+                                                          QDate::currentDate().addDays(-daysToKeep)) >= 0;
+            releaseConnection(connection);
+        }
+    } else {
+        QString logSql = QString(R"(
+            DELETE FROM RAN_AI_Logs 
+            WHERE timestamp < %1
+        )").arg(m_backend->daysAgoExpression());
+        logCleanup = executeQuery(logSql, { daysToKeep });
+    }
     
     // 清理长时间离线的AI
-    QString aiSql = R"(
+    QString aiSql = QString(R"(
         DELETE FROM RAN_AI_Players 
-        WHERE status = 0 AND last_update < DATEADD(day, -?, GETDATE())
-    )";
+        WHERE status = 0 AND last_update < %1
+    )").arg(m_backend->daysAgoExpression());
     
-    bool logCleanup = executeQuery(logSql, { daysToKeep });
     bool aiCleanup = executeQuery(aiSql, { daysToKeep * 2 }); // AI数据保留更长时间
     
+    // 按条件批量删除，无法逐个AI扣减，下次同步时对账
+    if (m_serverStats) {
+        m_serverStats->invalidate();
+    }
+    
     return logCleanup && aiCleanup;
 }
 
@@ -351,13 +790,51 @@ bool DatabaseManager::cleanupExpiredData(int daysToKeep)
  */
 bool DatabaseManager::batchSyncAiData(const QMap<QString, AIPlayerData>& aiDataMap)
 {
-    if (!m_connected || aiDataMap.isEmpty()) {
+    if ((!m_connected && !m_offlineBuffer) || aiDataMap.isEmpty()) {
         return false;
     }
     
-    auto connection = getConnection();
+    const BulkUpsertWriter::TableSpec spec = aiPlayersUpsertSpec(m_backend->nowExpression());
+    
+    // 批量写入时被拒绝的行（数据本身无法写入），不计入统计
+    QSet<QString> rejectedIds;
+    
+    // 写入（或缓冲）成功后计入服务器统计，并丢弃写回缓存中这些AI的旧值：
+    // 否则较早的脏值会在下次刷写时覆盖本次写入，已知值也不再与库中一致
+    auto recordSynced = [&]() {
+        QStringList writtenIds;
+        writtenIds.reserve(aiDataMap.size());
+        for (auto it = aiDataMap.constBegin(); it != aiDataMap.constEnd(); ++it) {
+            if (rejectedIds.contains(it.key())) {
+                continue;
+            }
+            writtenIds << it.key();
+            if (m_serverStats) {
+                m_serverStats->upsertPlayer(it.key(), it.value().serverId, it.value().level);
+            }
+        }
+        if (m_writeBehindCache) {
+            m_writeBehindCache->remove(writtenIds);
+        }
+    };
+    
+    // 离线时（或写入失败且远端不可达时）逐行缓冲到本地，恢复后重放
+    auto bufferRows = [&]() {
+        QVector<QVariantList> rows;
+        rows.reserve(aiDataMap.size());
+        for (auto it = aiDataMap.constBegin(); it != aiDataMap.constEnd(); ++it) {
+            rows.append(aiPlayerParams(it.key(), it.value()));
+        }
+        bool buffered = bufferIfOffline(BulkUpsertWriter::singleRowUpsertSql(spec, m_backend->dialect()), rows);
+        if (buffered) {
+            recordSynced();
+        }
+        return buffered;
+    };
+    
+    auto connection = m_connected ? getConnection() : nullptr;
     if (!connection) {
-        return false;
+        return bufferRows();
     }
     
     QSqlDatabase db = *connection;
@@ -366,50 +843,72 @@ bool DatabaseManager::batchSyncAiData(const QMap<QString, AIPlayerData>& aiDataM
     if (!db.transaction()) {
         qCritical() << "DatabaseManager: 开始事务失败";
         releaseConnection(connection);
-        return false;
+        return bufferRows();
     }
     
     bool success = true;
-    QString sql = R"(
-        MERGE RAN_AI_Players AS target
-        USING (SELECT ? AS ai_id, ? AS name, ? AS school, ? AS level, 
-                      ? AS server_id, ? AS aggression, ? AS intelligence, 
-                      ? AS social, ? AS anti_lag, GETDATE() AS last_update) AS source
-        ON target.ai_id = source.ai_id
-        WHEN MATCHED THEN
-            UPDATE SET name = source.name, school = source.school, level = source.level,
-                      server_id = source.server_id, aggression = source.aggression,
-                      intelligence = source.intelligence, social = source.social,
-                      anti_lag = source.anti_lag, last_update = source.last_update
-        WHEN NOT MATCHED THEN
-            INSERT (ai_id, name, school, level, server_id, aggression, intelligence, 
-                   social, anti_lag, created_time, last_update)
-            VALUES (source.ai_id, source.name, source.school, source.level,
-                   source.server_id, source.aggression, source.intelligence,
-                   source.social, source.anti_lag, GETDATE(), source.last_update);
-    )";
     
-    QSqlQuery query(db);
-    query.prepare(sql);
+    if (m_config.bulkSyncEnabled) {
+        // 批量模式：分块写入暂存表后一条集合MERGE
+        QVector<QVariantList> columns(9);
+        for (QVariantList& column : columns) {
+            column.reserve(aiDataMap.size());
+        }
+        
+        for (auto it = aiDataMap.constBegin(); it != aiDataMap.constEnd(); ++it) {
+            const AIPlayerData& playerData = it.value();
+            columns[0] << it.key();
+            columns[1] << playerData.name;
+            columns[2] << static_cast<int>(playerData.school);
+            columns[3] << playerData.level;
+            columns[4] << playerData.serverId;
+            columns[5] << playerData.aggression;
+            columns[6] << playerData.intelligence;
+            columns[7] << playerData.social;
+            columns[8] << playerData.antiLag;
+        }
+        
+        BulkUpsertWriter writer(spec, m_config.syncBatchSize, m_backend->dialect());
+        success = writer.upsert(db, columns);
+        
+        if (success) {
+            for (int row : writer.rejectedRows()) {
+                rejectedIds.insert(columns[0].at(row).toString());
+            }
+            if (!rejectedIds.isEmpty()) {
+                qWarning() << "DatabaseManager: 批量同步跳过" << rejectedIds.size() << "条无法写入的AI数据:"
+                           << writer.lastError();
+            }
+            qDebug() << "DatabaseManager: 批量同步" << aiDataMap.size() - rejectedIds.size() << "条AI数据，往返"
+                     << writer.lastRoundTrips() << "次";
+        } else {
+            qCritical() << "DatabaseManager: 批量同步AI数据失败:" << writer.lastError();
+        }
+    } else {
+        QString sql = BulkUpsertWriter::singleRowUpsertSql(spec, m_backend->dialect());
+    
+        QSqlQuery query(db);
+        query.prepare(sql);
     
-    for (auto it = aiDataMap.constBegin(); it != aiDataMap.constEnd(); ++it) {
-        const QString& aiId = it.key();
-        const AIPlayerData& playerData = it.value();
+        for (auto it = aiDataMap.constBegin(); it != aiDataMap.constEnd(); ++it) {
+            const QString& aiId = it.key();
+            const AIPlayerData& playerData = it.value();
         
-        query.bindValue(0, aiId);
-        query.bindValue(1, playerData.name);
-        query.bindValue(2, static_cast<int>(playerData.school));
-        query.bindValue(3, playerData.level);
-        query.bindValue(4, playerData.serverId);
-        query.bindValue(5, playerData.aggression);
-        query.bindValue(6, playerData.intelligence);
-        query.bindValue(7, playerData.social);
-        query.bindValue(8, playerData.antiLag);
+            query.bindValue(0, aiId);
+            query.bindValue(1, playerData.name);
+            query.bindValue(2, static_cast<int>(playerData.school));
+            query.bindValue(3, playerData.level);
+            query.bindValue(4, playerData.serverId);
+            query.bindValue(5, playerData.aggression);
+            query.bindValue(6, playerData.intelligence);
+            query.bindValue(7, playerData.social);
+            query.bindValue(8, playerData.antiLag);
         
-        if (!query.exec()) {
-            qCritical() << "DatabaseManager: 批量同步AI数据失败:" << query.lastError().text();
-            success = false;
-            break;
+            if (!query.exec()) {
+                qCritical() << "DatabaseManager: 批量同步AI数据失败:" << query.lastError().text();
+                success = false;
+                break;
+            }
         }
     }
     
@@ -426,10 +925,12 @@ bool DatabaseManager::batchSyncAiData(const QMap<QString, AIPlayerData>& aiDataM
     releaseConnection(connection);
     
     if (success) {
-        emit dataSynced(aiDataMap.size());
+        recordSynced();
+        emit dataSynced(aiDataMap.size() - rejectedIds.size());
+        return true;
     }
     
-    return success;
+    return bufferRows();
 }
 
 /**
@@ -437,19 +938,19 @@ bool DatabaseManager::batchSyncAiData(const QMap<QString, AIPlayerData>& aiDataM
  */
 std::shared_ptr<QSqlDatabase> DatabaseManager::getConnection()
 {
-    QMutexLocker locker(&m_poolMutex);
-    
-    if (!m_connectionPool.isEmpty()) {
-        return m_connectionPool.dequeue();
+    if (!m_connectionPool) {
+        return nullptr;
     }
     
-    // 如果池为空，创建新连接
-    auto connection = createNewConnection();
-    if (connection && connection->isOpen()) {
-        return connection;
-    }
+    QElapsedTimer timer;
+    timer.start();
     
-    return nullptr;
+    // 有截止时间的获取，池满时最多等待acquireTimeout而不是无限阻塞
+    auto connection = m_connectionPool->tryAcquire(m_config.poolAcquireTimeout);
+    if (m_queryMetrics) {
+        m_queryMetrics->recordPoolWait(timer.nsecsElapsed());
+    }
+    return connection;
 }
 
 /**
@@ -457,16 +958,172 @@ std::shared_ptr<QSqlDatabase> DatabaseManager::getConnection()
  */
 void DatabaseManager::releaseConnection(std::shared_ptr<QSqlDatabase> connection)
 {
-    if (!connection) {
+    if (!connection || !m_connectionPool) {
         return;
     }
     
+    // 失效连接由连接池关闭，其上的预编译语句在关闭回调中销毁
+    m_connectionPool->release(std::move(connection));
+}
+
+/**
+ * @brief 在工作线程上获取连接并执行任务
+ */
+void DatabaseManager::acquireConnectionAsync(std::function<void(std::shared_ptr<QSqlDatabase>)> work)
+{
+    if (!m_connectionPool) {
+        work(nullptr);
+        return;
+    }
+    
+    m_connectionPool->acquireAsync(std::move(work), m_config.poolAcquireTimeout, m_threadPool);
+}
+
+/**
+ * @brief 获取连接池统计
+ */
+ConnectionPoolStats DatabaseManager::getConnectionPoolStats() const
+{
+    return m_connectionPool ? m_connectionPool->stats() : ConnectionPoolStats();
+}
+
+/**
+ * @brief 获取连接对应的预编译语句缓存
+ */
+PreparedStatementCache* DatabaseManager::statementCacheFor(const std::shared_ptr<QSqlDatabase>& connection)
+{
+    if (m_config.statementCacheSize <= 0) {
+        return nullptr;
+    }
+    
     QMutexLocker locker(&m_poolMutex);
     
-    // 检查连接是否有效
-    if (connection->isOpen()) {
-        m_connectionPool.enqueue(connection);
+    auto& cache = m_statementCaches[connection.get()];
+    if (!cache) {
+        cache = std::make_unique<PreparedStatementCache>(*connection, m_config.statementCacheSize,
+                                                         m_statementCounters.get());
     }
+    return cache.get();
+}
+
+/**
+ * @brief 异步执行操作
+ */
+bool DatabaseManager::executeAsync(const DatabaseOperation& operation)
+{
+    const bool isSelect = operation.type == DatabaseOperation::Type::Select;
+    
+    QString sql = QString::fromStdString(operation.sql);
+    QVariantList params;
+    params.reserve(static_cast<int>(operation.parameters.size()));
+    for (const auto& param : operation.parameters) {
+        params << QString::fromStdString(param.second);
+    }
+    
+    // 任意语句可能修改AI玩家表，下次同步时对账服务器统计
+    if (!isSelect && m_serverStats && sql.contains("RAN_AI_Players", Qt::CaseInsensitive)) {
+        m_serverStats->invalidate();
+    }
+    
+    // 离线时写操作直接写入本地缓冲，查询无法执行
+    if (!m_connected) {
+        return !isSelect && bufferIfOffline(sql, { params });
+    }
+    
+    auto callback = operation.callback;
+    
+    // 查询需要结果集，未开启分组提交时写操作没有写入线程：都在工作线程上直接执行
+    if (!m_groupCommit || isSelect) {
+        acquireConnectionAsync([this, callback, sql, params, isSelect](std::shared_ptr<QSqlDatabase> connection) {
+            QueryResult result;
+            
+            if (!connection) {
+                result.errorMessage = "获取数据库连接超时";
+            } else {
+                QElapsedTimer timer;
+                timer.start();
+                
+                QSqlQuery query(*connection);
+                query.setForwardOnly(true);
+                query.prepare(sql);
+                for (const auto& param : params) {
+                    query.addBindValue(param);
+                }
+                
+                result.success = query.exec();
+                if (result.success) {
+                    if (isSelect) {
+                        while (query.next()) {
+                            ++result.affectedRows;
+                        }
+                    } else {
+                        result.affectedRows = query.numRowsAffected();
+                    }
+                } else {
+                    const QSqlError error = query.lastError();
+                    result.errorMessage = error.text().toStdString();
+                    if (OfflineWriteBuffer::isConnectionError(error)) {
+                        query = QSqlQuery();
+                        connection->close();
+                    }
+                }
+                recordQuery(sql, timer.nsecsElapsed(), result.success, result.affectedRows, params);
+            }
+            
+            // 写操作失败时与分组提交相同：远端不可达转入离线缓冲，否则上报
+            if (!result.success && !isSelect) {
+                result.success = handleAsyncWriteFailure(sql, params, QString::fromStdString(result.errorMessage));
+            }
+            
+            if (callback) {
+                callback(result);
+            }
+        });
+        return true;
+    }
+    
+    return m_groupCommit->submit(sql, params,
+        [this, callback, sql, params](bool success, const QString& error) {
+            // 远端不可达导致的失败转入离线缓冲，视为已受理
+            bool buffered = !success && handleAsyncWriteFailure(sql, params, error);
+            if (!callback) {
+                return;
+            }
+            QueryResult result;
+            result.success = success || buffered;
+            result.errorMessage = error.toStdString();
+            callback(result);
+        });
+}
+
+/**
+ * @brief 批量异步执行写操作
+ */
+int DatabaseManager::executeBatchAsync(const std::vector<DatabaseOperation>& operations)
+{
+    int queued = 0;
+    for (const auto& operation : operations) {
+        if (executeAsync(operation)) {
+            ++queued;
+        }
+    }
+    return queued;
+}
+
+/**
+ * @brief 获取分组提交统计
+ */
+GroupCommitStats DatabaseManager::getGroupCommitStats() const
+{
+    return m_groupCommit ? m_groupCommit->stats() : GroupCommitStats();
+}
+
+/**
+ * @brief 获取预编译语句缓存统计
+ */
+StatementCacheStats DatabaseManager::getStatementCacheStats() const
+{
+    return m_statementCounters->snapshot();
 }
 
 /**
@@ -479,6 +1136,45 @@ bool DatabaseManager::executeQuery(const QString& sql, const QVariantList& param
         return false;
     }
     
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 命中缓存时复用连接上已prepare的语句，只重新绑定参数
+    PreparedStatementCache* cache = statementCacheFor(connection);
+    if (cache) {
+        QSqlQuery* query = cache->acquire(sql);
+        if (!query) {
+            qCritical() << "DatabaseManager: 查询预编译失败:" << cache->lastError();
+            qCritical() << "SQL:" << sql;
+            recordQuery(sql, timer.nsecsElapsed(), false, 0, params);
+            releaseConnection(connection);
+            return false;
+        }
+        
+        for (int i = 0; i < params.size(); ++i) {
+            query->bindValue(i, params.at(i));
+        }
+        
+        bool success = query->exec();
+        recordQuery(sql, timer.nsecsElapsed(), success, success ? query->numRowsAffected() : 0, params);
+        if (success) {
+            cache->release(query);
+        } else {
+            const QSqlError error = query->lastError();
+            qCritical() << "DatabaseManager: 查询执行失败:" << error.text();
+            qCritical() << "SQL:" << sql;
+            cache->invalidate(sql);
+            
+            // 已断开的连接关闭后归还，连接池不再复用
+            if (OfflineWriteBuffer::isConnectionError(error)) {
+                connection->close();
+            }
+        }
+        
+        releaseConnection(connection);
+        return success;
+    }
+    
     QSqlQuery query(*connection);
     query.prepare(sql);
     
@@ -487,9 +1183,16 @@ bool DatabaseManager::executeQuery(const QString& sql, const QVariantList& param
     }
     
     bool success = query.exec();
+    recordQuery(sql, timer.nsecsElapsed(), success, success ? query.numRowsAffected() : 0, params);
     if (!success) {
-        qCritical() << "DatabaseManager: 查询执行失败:" << query.lastError().text();
+        const QSqlError error = query.lastError();
+        qCritical() << "DatabaseManager: 查询执行失败:" << error.text();
         qCritical() << "SQL:" << sql;
+        
+        if (OfflineWriteBuffer::isConnectionError(error)) {
+            query = QSqlQuery();
+            connection->close();
+        }
     }
     
     releaseConnection(connection);
@@ -501,20 +1204,35 @@ bool DatabaseManager::executeQuery(const QString& sql, const QVariantList& param
  */
 bool DatabaseManager::validateConfiguration()
 {
-    if (m_config.serverName.isEmpty()) {
-        qCritical() << "DatabaseManager: 服务器名称不能为空";
-        return false;
+    if (m_config.backendType.compare("SQLite", Qt::CaseInsensitive) == 0) {
+        if (m_config.sqlitePath.isEmpty()) {
+            qCritical() << "DatabaseManager: SQLite数据库路径不能为空";
+            return false;
+        }
+    } else {
+        if (m_config.serverName.isEmpty()) {
+            qCritical() << "DatabaseManager: 服务器名称不能为空";
+            return false;
+        }
+        
+        if (m_config.databaseName.isEmpty()) {
+            qCritical() << "DatabaseManager: 数据库名称不能为空";
+            return false;
+        }
     }
     
-    if (m_config.databaseName.isEmpty()) {
-        qCritical() << "DatabaseManager: 数据库名称不能为空";
-        return false;
+    if (m_config.poolMaxSize <= 0 || m_config.poolMaxSize > MAX_POOL_SIZE) {
+        qWarning() << "DatabaseManager: 最大连接数无效，使用默认值";
+        m_config.poolMaxSize = MAX_POOL_SIZE;
     }
     
-    if (m_config.poolSize <= 0 || m_config.poolSize > 50) {
+    m_config.poolMinSize = qBound(0, m_config.poolMinSize, m_config.poolMaxSize);
+    
+    if (m_config.poolSize <= 0 || m_config.poolSize > m_config.poolMaxSize) {
         qWarning() << "DatabaseManager: 连接池大小无效，使用默认值";
-        m_config.poolSize = 10;
+        m_config.poolSize = qMin(DEFAULT_POOL_SIZE, m_config.poolMaxSize);
     }
+    m_config.poolSize = qMax(m_config.poolSize, m_config.poolMinSize);
     
     m_poolSize = m_config.poolSize;
     m_connectionTimeout = m_config.connectionTimeout;
@@ -528,16 +1246,27 @@ bool DatabaseManager::validateConfiguration()
  */
 bool DatabaseManager::createConnectionPool()
 {
-    qDebug() << "DatabaseManager: 创建连接池，大小:" << m_poolSize;
+    qDebug() << "DatabaseManager: 创建连接池，预建:" << m_poolSize
+             << "范围:" << m_config.poolMinSize << "-" << m_config.poolMaxSize;
+    
+    m_connectionPool = std::make_unique<ConnectionPool>(
+        [this](const QString& connectionName) { return createNewConnection(connectionName); },
+        "RAN_AI_DB",
+        m_config.poolMinSize,
+        m_config.poolMaxSize,
+        m_config.poolIdleTimeout);
+    
+    // 连接关闭前销毁其上的预编译语句
+    m_connectionPool->setCloseHook([this](QSqlDatabase* connection) {
+        QMutexLocker locker(&m_poolMutex);
+        m_statementCaches.erase(connection);
+    });
     
-    for (int i = 0; i < m_poolSize; ++i) {
-        auto connection = createNewConnection();
-        if (!connection || !connection->isOpen()) {
-            qCritical() << "DatabaseManager: 创建连接失败，索引:" << i;
-            return false;
-        }
-        
-        m_connectionPool.enqueue(connection);
+    // 预建的连接归属当前线程，其余线程首次获取时按需创建
+    // 失败时保留连接池，远端恢复后按需创建连接
+    if (!m_connectionPool->warmUp(m_poolSize)) {
+        qCritical() << "DatabaseManager: 创建连接失败";
+        return false;
     }
     
     qDebug() << "DatabaseManager: 连接池创建成功";
@@ -547,34 +1276,13 @@ bool DatabaseManager::createConnectionPool()
 /**
  * @brief 创建新连接
  */
-std::shared_ptr<QSqlDatabase> DatabaseManager::createNewConnection()
+std::shared_ptr<QSqlDatabase> DatabaseManager::createNewConnection(const QString& connectionName)
 {
-    QString connectionName = QString("RAN_AI_DB_%1").arg(QDateTime::currentMSecsSinceEpoch());
-    
-    auto db = std::make_shared<QSqlDatabase>(QSqlDatabase::addDatabase("QODBC", connectionName));
-    
-    // 构建连接字符串
-    QString connectionString = QString(
-        "DRIVER={ODBC Driver 17 for SQL Server};"
-        "SERVER=%1;"
-        "DATABASE=%2;"
-        "Trusted_Connection=%3;"
-    ).arg(m_config.serverName)
-     .arg(m_config.databaseName)
-     .arg(m_config.trustedConnection ? "yes" : "no");
-    
-    if (!m_config.trustedConnection) {
-        connectionString += QString("UID=%1;PWD=%2;").arg(m_config.username, m_config.password);
-    }
+    QString error;
+    auto db = m_backend->openConnection(connectionName, &error);
     
-    // 添加连接选项
-    connectionString += "Connection Timeout=30;Login Timeout=10;";
-    
-    db->setDatabaseName(connectionString);
-    
-    if (!db->open()) {
-        qCritical() << "DatabaseManager: 数据库连接失败:" << db->lastError().text();
-        QSqlDatabase::removeDatabase(connectionName);
+    if (!db) {
+        qCritical() << "DatabaseManager: 数据库连接失败:" << error;
         return nullptr;
     }
     
@@ -587,15 +1295,9 @@ std::shared_ptr<QSqlDatabase> DatabaseManager::createNewConnection()
  */
 void DatabaseManager::closeConnectionPool()
 {
-    QMutexLocker locker(&m_poolMutex);
-    
-    while (!m_connectionPool.isEmpty()) {
-        auto connection = m_connectionPool.dequeue();
-        if (connection) {
-            QString connectionName = connection->connectionName();
-            connection->close();
-            QSqlDatabase::removeDatabase(connectionName);
-        }
+    // 关闭回调先销毁预编译语句，再移除其所属连接
+    if (m_connectionPool) {
+        m_connectionPool->closeAll();
     }
     
     qDebug() << "DatabaseManager: 连接池已关闭";
@@ -608,57 +1310,8 @@ bool DatabaseManager::initializeDatabaseSchema()
 {
     qDebug() << "DatabaseManager: 初始化数据库结构...";
     
-    QStringList createTableSqls = {
-        // AI玩家表
-        R"(
-            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_AI_Players' AND xtype='U')
-            CREATE TABLE RAN_AI_Players (
-                id BIGINT IDENTITY(1,1) PRIMARY KEY,
-                ai_id NVARCHAR(50) UNIQUE NOT NULL,
-                name NVARCHAR(100) NOT NULL,
-                school INT NOT NULL,
-                level INT NOT NULL DEFAULT 1,
-                server_id INT NOT NULL DEFAULT 1,
-                aggression INT NOT NULL DEFAULT 50,
-                intelligence INT NOT NULL DEFAULT 50,
-                social INT NOT NULL DEFAULT 50,
-                anti_lag BIT NOT NULL DEFAULT 0,
-                status INT NOT NULL DEFAULT 0,
-                created_time DATETIME NOT NULL DEFAULT GETDATE(),
-                last_update DATETIME NOT NULL DEFAULT GETDATE(),
-                INDEX IX_AI_Players_ServerId (server_id),
-                INDEX IX_AI_Players_School (school),
-                INDEX IX_AI_Players_Status (status)
-            )
-        )",
-        
-        // AI操作日志表
-        R"(
-            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_AI_Logs' AND xtype='U')
-            CREATE TABLE RAN_AI_Logs (
-                id BIGINT IDENTITY(1,1) PRIMARY KEY,
-                ai_id NVARCHAR(50) NOT NULL,
-                operation NVARCHAR(100) NOT NULL,
-                details NVARCHAR(MAX),
-                timestamp DATETIME NOT NULL DEFAULT GETDATE(),
-                INDEX IX_AI_Logs_AiId (ai_id),
-                INDEX IX_AI_Logs_Timestamp (timestamp)
-            )
-        )",
-        
-        // 服务器状态表
-        R"(
-            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_Server_Status' AND xtype='U')
-            CREATE TABLE RAN_Server_Status (
-                server_id INT PRIMARY KEY,
-                server_name NVARCHAR(100) NOT NULL,
-                ai_count INT NOT NULL DEFAULT 0,
-                online_count INT NOT NULL DEFAULT 0,
-                load_percentage FLOAT NOT NULL DEFAULT 0.0,
-                last_update DATETIME NOT NULL DEFAULT GETDATE()
-            )
-        )"
-    };
+    // AI操作日志表：启用分区存储时由其创建按天分区的表
+    const QStringList createTableSqls = m_backend->schemaStatements(!m_logStore);
     
     for (const QString& sql : createTableSqls) {
         if (!executeQuery(sql, {})) {
@@ -667,6 +1320,16 @@ bool DatabaseManager::initializeDatabaseSchema()
         }
     }
     
+    if (m_logStore) {
+        auto connection = getConnection();
+        bool success = connection && m_logStore->ensureSchema(*connection);
+        releaseConnection(connection);
+        if (!success) {
+            qCritical() << "DatabaseManager: 创建分区日志表失败";
+            return false;
+        }
+    }
+    
     qDebug() << "DatabaseManager: 数据库结构初始化完成";
     return true;
 }
@@ -680,18 +1343,354 @@ void DatabaseManager::performSync()
         return;
     }
     
-    // 这里可以实现定期同步逻辑
-    // 例如：同步统计数据、清理过期数据等
+    // 先重放离线期间缓冲的写操作，保持写入顺序
+    if (m_offlineBuffer && m_offlineBuffer->pendingCount() > 0 && !replayOfflineBuffer()) {
+        return;
+    }
+    
+    // 对账从刷写前开始：之前的修改由刷写落库，之后的修改记录在聚合器中
+    const bool reconcile = m_serverStats
+        && m_serverStats->reconcileDue(m_config.serverStatsReconcileInterval);
+    if (reconcile) {
+        m_serverStats->beginReconcile();
+    }
+    
+    // 刷写写回缓存中合并后的修改
+    bool flushed = true;
+    if (m_writeBehindCache) {
+        flushed = flushWriteBehindCache();
+    }
+    
+    // 批量写入缓冲的操作日志
+    if (m_logStore) {
+        flushLogStore();
+    }
+    
+    if (reconcile) {
+        reconcileServerStats(flushed);
+    }
     
     emit syncCompleted();
 }
 
+/**
+ * @brief 扫描AI玩家表对账服务器统计
+ */
+void DatabaseManager::reconcileServerStats(bool flushed)
+{
+    auto connection = flushed ? getConnection() : nullptr;
+    if (!connection) {
+        m_serverStats->cancelReconcile();
+        return;
+    }
+    
+    if (m_serverStats->finishReconcile(*connection)) {
+        const ServerStatsAggregatorStats stats = m_serverStats->stats();
+        qDebug() << "DatabaseManager: 服务器统计对账完成，AI数:" << stats.trackedPlayers
+                 << "耗时:" << stats.lastReconcileDurationMs << "ms";
+    }
+    
+    releaseConnection(connection);
+}
+
+/**
+ * @brief 获取服务器统计聚合器的统计
+ */
+ServerStatsAggregatorStats DatabaseManager::getServerStatsAggregatorStats() const
+{
+    return m_serverStats ? m_serverStats->stats() : ServerStatsAggregatorStats();
+}
+
+/**
+ * @brief 记录一次查询到按语句的统计
+ */
+void DatabaseManager::recordQuery(const QString& sql, qint64 elapsedNs, bool success, int rows,
+                                  const QVariantList& params)
+{
+    if (m_queryMetrics) {
+        m_queryMetrics->record(sql, elapsedNs, success, qMax(rows, 0),
+                               QueryMetrics::parameterBytes(params), params);
+    }
+}
+
+/**
+ * @brief 获取数据库性能统计
+ */
+std::unordered_map<std::string, double> DatabaseManager::getPerformanceStats() const
+{
+    std::unordered_map<std::string, double> result;
+    if (!m_queryMetrics) {
+        return result;
+    }
+    
+    const QueryMetricsSnapshot snapshot = m_queryMetrics->snapshot();
+    
+    auto addLatency = [&result](const std::string& prefix, const LatencySummary& latency) {
+        result[prefix + ".count"] = static_cast<double>(latency.count);
+        result[prefix + ".total_ms"] = latency.totalMs;
+        result[prefix + ".mean_ms"] = latency.meanMs;
+        result[prefix + ".p50_ms"] = latency.p50Ms;
+        result[prefix + ".p95_ms"] = latency.p95Ms;
+        result[prefix + ".p99_ms"] = latency.p99Ms;
+        result[prefix + ".p999_ms"] = latency.p999Ms;
+        result[prefix + ".max_ms"] = latency.maxMs;
+    };
+    
+    addLatency("queries", snapshot.overall);
+    result["queries.errors"] = static_cast<double>(snapshot.errors);
+    result["queries.slow"] = static_cast<double>(snapshot.slowQueries);
+    
+    addLatency("pool.wait", snapshot.poolWait);
+    const ConnectionPoolStats poolStats = getConnectionPoolStats();
+    result["pool.timeouts"] = static_cast<double>(poolStats.timeouts);
+    result["pool.in_use"] = poolStats.inUse;
+    result["pool.idle"] = poolStats.idle;
+    
+    // 按语句的键形如"statement[SELECT ...].p99_ms"
+    for (const StatementMetrics& statement : snapshot.statements) {
+        const std::string prefix = "statement[" + statement.sql.toStdString() + "]";
+        addLatency(prefix, statement.latency);
+        result[prefix + ".errors"] = static_cast<double>(statement.errors);
+        result[prefix + ".rows"] = static_cast<double>(statement.rows);
+        result[prefix + ".bytes"] = static_cast<double>(statement.bytes);
+    }
+    
+    return result;
+}
+
+/**
+ * @brief 获取查询历史（最近的慢查询）
+ */
+std::vector<std::string> DatabaseManager::getQueryHistory(int limit) const
+{
+    std::vector<std::string> result;
+    if (!m_queryMetrics || limit <= 0) {
+        return result;
+    }
+    
+    const QueryMetricsSnapshot snapshot = m_queryMetrics->snapshot(0);
+    const int count = qMin(limit, static_cast<int>(snapshot.slowLog.size()));
+    result.reserve(count);
+    
+    for (int i = 0; i < count; ++i) {
+        const SlowQueryRecord& slow = snapshot.slowLog.at(i);
+        result.push_back(QString("%1 %2ms rows=%3 %4 [%5] %6")
+            .arg(slow.timestamp.toString(Qt::ISODateWithMs))
+            .arg(slow.elapsedMs, 0, 'f', 1)
+            .arg(slow.rows)
+            .arg(slow.success ? QStringLiteral("OK") : QStringLiteral("FAILED"))
+            .arg(slow.parameterShape)
+            .arg(slow.sql)
+            .toStdString());
+    }
+    
+    return result;
+}
+
+/**
+ * @brief 清理性能统计
+ */
+void DatabaseManager::clearPerformanceStats()
+{
+    if (m_queryMetrics) {
+        m_queryMetrics->reset();
+    }
+}
+
+/**
+ * @brief 获取按语句的查询统计
+ */
+QueryMetricsSnapshot DatabaseManager::getQueryMetrics() const
+{
+    return m_queryMetrics ? m_queryMetrics->snapshot() : QueryMetricsSnapshot();
+}
+
+/**
+ * @brief 将写回缓存中的脏数据刷写到数据库
+ */
+bool DatabaseManager::flushWriteBehindCache()
+{
+    if (!m_writeBehindCache || m_writeBehindCache->dirtyCount() == 0) {
+        return true;
+    }
+    
+    auto connection = getConnection();
+    if (!connection) {
+        return false;
+    }
+    
+    QSqlDatabase db = *connection;
+    
+    if (!db.transaction()) {
+        qCritical() << "DatabaseManager: 开始事务失败";
+        releaseConnection(connection);
+        return false;
+    }
+    
+    bool success = m_writeBehindCache->flush(db, m_config.syncBatchSize) && db.commit();
+    
+    if (success) {
+        m_writeBehindCache->commitFlush();
+        emit dataSynced(m_writeBehindCache->lastFlushedRows());
+    } else {
+        qCritical() << "DatabaseManager: 写回缓存刷写失败:" << m_writeBehindCache->lastError();
+        db.rollback();
+        m_writeBehindCache->abortFlush();
+    }
+    
+    releaseConnection(connection);
+    return success;
+}
+
+/**
+ * @brief 将缓冲的操作日志写入分区日志表
+ */
+bool DatabaseManager::flushLogStore()
+{
+    if (!m_logStore || m_logStore->stats().buffered == 0) {
+        return true;
+    }
+    
+    auto connection = getConnection();
+    if (!connection) {
+        return false;
+    }
+    
+    bool success = m_logStore->flush(*connection) >= 0;
+    
+    releaseConnection(connection);
+    return success;
+}
+
+/**
+ * @brief 获取分区日志存储统计
+ */
+LogPartitionStats DatabaseManager::getLogPartitionStats() const
+{
+    return m_logStore ? m_logStore->stats() : LogPartitionStats();
+}
+
+/**
+ * @brief 写操作：远端失败且不可达时转入离线缓冲
+ */
+bool DatabaseManager::executeWrite(const QString& sql, const QVariantList& params)
+{
+    if (m_connected && executeQuery(sql, params)) {
+        return true;
+    }
+    return bufferIfOffline(sql, { params });
+}
+
+/**
+ * @brief 远端不可达时把写操作追加到离线缓冲
+ */
+bool DatabaseManager::bufferIfOffline(const QString& sql, const QVector<QVariantList>& rows)
+{
+    if (!m_offlineBuffer) {
+        return false;
+    }
+    
+    // 远端仍可达说明是语句本身的错误，缓冲后重放也会失败
+    if (m_connected && executeQuery("SELECT 1", {})) {
+        return false;
+    }
+    
+    markDisconnected();
+    return m_offlineBuffer->appendAll(sql, rows);
+}
+
+/**
+ * @brief 处理异步执行失败的写操作
+ */
+bool DatabaseManager::handleAsyncWriteFailure(const QString& sql, const QVariantList& params, const QString& error)
+{
+    if (bufferIfOffline(sql, { params })) {
+        return true;
+    }
+    
+    // 受理时已计入服务器统计的修改没有落库，下次同步时重新对账
+    if (m_serverStats && sql.contains("RAN_AI_Players", Qt::CaseInsensitive)) {
+        m_serverStats->invalidate();
+    }
+    
+    qWarning() << "DatabaseManager: 异步写入失败:" << error;
+    
+    // 在写入线程上调用，信号在管理器所在线程上发出
+    QMetaObject::invokeMethod(this, [this, sql, error]() {
+        emit asyncWriteFailed(sql, error);
+    });
+    return false;
+}
+
+/**
+ * @brief 标记为已断开
+ */
+void DatabaseManager::markDisconnected()
+{
+    // 可能在工作线程上调用，状态和定时器在管理器所在线程上修改
+    QMetaObject::invokeMethod(this, [this]() {
+        if (!m_connected) {
+            return;
+        }
+        qWarning() << "DatabaseManager: 数据库连接已断开，写操作转入离线缓冲";
+        m_connected = false;
+        m_heartbeatTimer->setInterval(RECONNECT_INTERVAL * 1000);
+        emit connectionStateChanged(false);
+    });
+}
+
+/**
+ * @brief 重放离线缓冲中的写操作
+ */
+bool DatabaseManager::replayOfflineBuffer()
+{
+    auto connection = getConnection();
+    if (!connection) {
+        return false;
+    }
+    
+    // 每批一个远端事务，直到清空或不再有进展
+    bool connectionLost = false;
+    qint64 pending = m_offlineBuffer->pendingCount();
+    while (pending > 0) {
+        if (m_offlineBuffer->replay(*connection, m_config.offlineReplayBatch, &connectionLost) < 0
+            || connectionLost) {
+            break;
+        }
+        
+        const qint64 remaining = m_offlineBuffer->pendingCount();
+        if (remaining >= pending) {
+            break;
+        }
+        pending = remaining;
+    }
+    
+    if (connectionLost) {
+        connection->close();
+    }
+    releaseConnection(connection);
+    
+    if (connectionLost) {
+        markDisconnected();
+        return false;
+    }
+    return m_offlineBuffer->pendingCount() == 0;
+}
+
+/**
+ * @brief 获取离线缓冲统计
+ */
+OfflineBufferStats DatabaseManager::getOfflineBufferStats() const
+{
+    return m_offlineBuffer ? m_offlineBuffer->stats() : OfflineBufferStats();
+}
+
 /**
  * @brief 发送心跳
  */
 void DatabaseManager::sendHeartbeat()
 {
-    if (!m_connected) {
+    if (!m_initialized) {
         return;
     }
     
@@ -699,9 +1698,29 @@ void DatabaseManager::sendHeartbeat()
     QString sql = "SELECT 1";
     bool success = executeQuery(sql, {});
     
-    if (!success) {
+    if (!success && m_connected) {
         qWarning() << "DatabaseManager: 心跳检测失败，可能已断开连接";
-        m_connected = false;
-        emit connectionStateChanged(false);
+        if (m_offlineBuffer) {
+            markDisconnected();
+        } else {
+            m_connected = false;
+            emit connectionStateChanged(false);
+        }
+    } else if (success && !m_connected && m_offlineBuffer) {
+        // 远端恢复：补建表结构，先重放离线写操作再恢复直接写入
+        if (!m_schemaReady) {
+            m_schemaReady = initializeDatabaseSchema();
+        }
+        if (m_schemaReady && replayOfflineBuffer()) {
+            qDebug() << "DatabaseManager: 数据库连接已恢复";
+            m_connected = true;
+            m_heartbeatTimer->setInterval(HEARTBEAT_INTERVAL * 1000);
+            emit connectionStateChanged(true);
+        }
+    }
+    
+    // 收缩空闲超时的连接（工作线程的连接由其下次获取或归还时关闭）
+    if (m_connectionPool) {
+        m_connectionPool->shrink();
     }
 }
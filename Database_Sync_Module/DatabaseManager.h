@@ -4,74 +4,117 @@
  * @author Jy技术团队
  * @date 2025年6月14日
  * @version 2.0.0
- * 
+ *
  * 功能特色:
- * - SQL Server 2022 完整支持
- * - ODBC/ADO 双重连接选项
- * - 连接池管理
- * - 事务安全保障
- * - 异步数据同步
+ * - SQL Server 2022 / 本地SQLite 双存储后端
+ * - 线程亲和连接池与预编译语句缓存
+ * - 写回缓存、分组提交、分区日志
+ * - 远端离线时本地缓冲，恢复后按顺序重放
+ * - 异步数据同步与按语句的查询统计
  */
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
 #include <unordered_map>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <thread>
-#include <atomic>
-#include <chrono>
 #include <functional>
 
-// Windows平台ODBC支持
-#ifdef _WIN32
-#include <windows.h>
-#include <sql.h>
-#include <sqlext.h>
-#include <sqltypes.h>
-#endif
+#include <QtCore/QObject>
+#include <QtCore/QDateTime>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include "DatabaseConfig.h"
 
 // 前置声明
-struct AIPlayerData;
+class AIWriteBehindCache;
+class PreparedStatementCache;
+class QSqlDatabase;
+struct StatementCacheCounters;
+struct StatementCacheStats;
+class GroupCommitPipeline;
+struct GroupCommitStats;
+class ConnectionPool;
+struct ConnectionPoolStats;
+class LogPartitionStore;
+struct LogPartitionStats;
+class StorageBackend;
+class OfflineWriteBuffer;
+struct OfflineBufferStats;
+class ServerStatsAggregator;
+struct ServerStatsAggregatorStats;
+class QueryMetrics;
+struct QueryMetricsSnapshot;
+
+/**
+ * @enum School
+ * @brief 学校（对应RAN_AI_Players.school，与ai_config.json的schools.id一致）
+ */
+enum class School {
+    EXTREME = 0,        ///< 极限学园
+    HOLY_SPIRIT = 1,    ///< 圣飞斯学园
+    FIRE_DEMON = 2      ///< 炎魔学园
+};
+
+/**
+ * @enum AIStatus
+ * @brief AI在线状态（对应RAN_AI_Players.status）
+ */
+enum class AIStatus {
+    OFFLINE = 0,        ///< 离线
+    ONLINE = 1          ///< 在线
+};
 
 /**
- * @struct DatabaseConnection
- * @brief 数据库连接结构
+ * @struct AIPlayerData
+ * @brief AI玩家持久化数据（RAN_AI_Players的一行，不含ai_id）
  */
-struct DatabaseConnection {
-    SQLHENV henv;       ///< 环境句柄
-    SQLHDBC hdbc;       ///< 连接句柄
-    SQLHSTMT hstmt;     ///< 语句句柄
-    bool isConnected;   ///< 连接状态
-    std::chrono::steady_clock::time_point lastUsed; ///< 最后使用时间
-    std::string connectionId; ///< 连接标识
-    
-    DatabaseConnection() : henv(SQL_NULL_HENV), hdbc(SQL_NULL_HDBC), 
-                          hstmt(SQL_NULL_HSTMT), isConnected(false) {
-        lastUsed = std::chrono::steady_clock::now();
-    }
+struct AIPlayerData {
+    QString name;                       ///< 角色名称
+    School school = School::EXTREME;    ///< 学校
+    int level = 1;                      ///< 角色等级
+    int serverId = 1;                   ///< 服务器ID
+    int aggression = 50;                ///< 攻击性 (0-100)
+    int intelligence = 50;              ///< 智能度 (0-100)
+    int social = 50;                    ///< 社交性 (0-100)
+    bool antiLag = false;               ///< 防卡顿
+};
+
+/**
+ * @struct ServerStats
+ * @brief 单个服务器的AI统计
+ */
+struct ServerStats {
+    int totalCount = 0;                 ///< AI总数
+    int onlineCount = 0;                ///< 在线AI数
+    double averageLevel = 0.0;          ///< 平均等级
+    double loadPercentage = 0.0;        ///< 在线比例（%）
 };
 
 /**
  * @struct QueryResult
- * @brief 查询结果结构
+ * @brief 异步操作结果
  */
 struct QueryResult {
-    bool success;                                    ///< 查询是否成功
+    bool success;                                    ///< 是否成功
     std::string errorMessage;                        ///< 错误信息
-    std::vector<std::unordered_map<std::string, std::string>> rows; ///< 结果行
-    int affectedRows;                               ///< 影响的行数
-    
+    int affectedRows;                                ///< 影响的行数（查询为结果行数）
+
     QueryResult() : success(false), affectedRows(0) {}
 };
 
 /**
  * @struct DatabaseOperation
- * @brief 数据库操作结构
+ * @brief 异步数据库操作
  */
 struct DatabaseOperation {
     enum class Type {
@@ -81,374 +124,463 @@ struct DatabaseOperation {
         Select,         ///< 查询操作
         StoredProc      ///< 存储过程调用
     } type;
-    
-    std::string sql;                                ///< SQL语句
-    std::vector<std::pair<std::string, std::string>> parameters; ///< 参数列表
+
+    std::string sql;                                ///< SQL语句（使用?占位）
+    std::vector<std::pair<std::string, std::string>> parameters; ///< 参数列表（按顺序绑定值）
     int priority;                                   ///< 优先级 (1-10)
-    std::chrono::steady_clock::time_point timestamp; ///< 时间戳
-    std::function<void(const QueryResult&)> callback; ///< 回调函数
-    
-    DatabaseOperation(Type t, const std::string& sqlText, int prio = 5) 
-        : type(t), sql(sqlText), priority(prio) {
-        timestamp = std::chrono::steady_clock::now();
-    }
+    std::function<void(const QueryResult&)> callback; ///< 完成回调（在写入线程或工作线程上调用）
+
+    DatabaseOperation(Type t, const std::string& sqlText, int prio = 5)
+        : type(t), sql(sqlText), priority(prio) {}
 };
 
 /**
  * @class DatabaseManager
  * @brief 数据库管理器核心类
- * 
+ *
  * 核心功能:
- * 1. SQL Server 2022 连接管理
- * 2. 连接池优化
- * 3. 异步查询处理
- * 4. 事务管理
- * 5. AI数据同步
- * 6. 性能监控
+ * 1. 存储后端与连接池管理
+ * 2. AI数据同步（写回缓存/批量Upsert）
+ * 3. 高频写入的分组提交
+ * 4. 离线缓冲与重放
+ * 5. 服务器统计与查询性能监控
+ *
+ * 公有方法在管理器所在线程调用；scanAiShard/scanAiChangedSince和
+ * acquireConnectionAsync可在工作线程调用。
  */
-class DatabaseManager {
+class DatabaseManager : public QObject
+{
+    Q_OBJECT
+
 public:
     /**
      * @brief 构造函数
+     * @param parent 父对象指针
      */
-    DatabaseManager();
-    
+    explicit DatabaseManager(QObject *parent = nullptr);
+
     /**
      * @brief 析构函数
      */
     ~DatabaseManager();
-    
+
     /**
-     * @brief 初始化数据库管理器
-     * @param connectionString 连接字符串
-     * @param poolSize 连接池大小
-     * @return 是否成功初始化
+     * @brief 初始化数据库管理器并启动同步与心跳定时器
+     * @param config 数据库配置
+     * @return 是否成功（远端不可达但离线缓冲可用时以离线模式返回true）
      */
-    bool initialize(const std::string& connectionString, int poolSize = 10);
-    
+    bool initialize(const DatabaseConfig& config);
+
     /**
-     * @brief 启动数据库管理器
-     * @return 是否成功启动
+     * @brief 刷写缓冲数据并关闭数据库管理器
      */
-    bool start();
-    
+    void shutdown();
+
     /**
-     * @brief 停止数据库管理器
+     * @brief 是否已初始化
      */
-    void stop();
-    
+    bool isInitialized() const { return m_initialized; }
+
     /**
-     * @brief 检查是否运行中
-     * @return 运行状态
+     * @brief 远端数据库是否可达
      */
-    bool isRunning() const { return m_isRunning.load(); }
-    
-    // 连接管理接口
+    bool isConnected() const { return m_connected; }
+
+    // AI数据同步接口
     /**
-     * @brief 测试数据库连接
-     * @return 是否连接成功
+     * @brief 同步单个AI数据（写回模式下只记录变化的列）
+     * @param aiId AI ID
+     * @param playerData AI数据
+     * @return 是否成功
      */
-    bool testConnection();
-    
+    bool syncAiData(const QString& aiId, const AIPlayerData& playerData);
+
     /**
-     * @brief 获取连接池状态
-     * @return 状态信息映射
+     * @brief 批量同步AI数据
+     * @param aiDataMap AI ID -> AI数据
+     * @return 是否已写入远端或离线缓冲
      */
-    std::unordered_map<std::string, int> getConnectionPoolStatus() const;
-    
-    // 同步查询接口
+    bool batchSyncAiData(const QMap<QString, AIPlayerData>& aiDataMap);
+
     /**
-     * @brief 执行查询
-     * @param sql SQL语句
-     * @param parameters 参数列表
-     * @return 查询结果
+     * @brief 更新AI状态
+     * @param aiId AI ID
+     * @param status 状态
+     * @return 是否成功（分组提交开启时表示已受理）
      */
-    QueryResult executeQuery(const std::string& sql, 
-                           const std::vector<std::pair<std::string, std::string>>& parameters = {});
-    
+    bool updateAiStatus(const QString& aiId, AIStatus status);
+
     /**
-     * @brief 执行非查询语句
-     * @param sql SQL语句
-     * @param parameters 参数列表
-     * @return 影响的行数，失败返回-1
+     * @brief 删除AI数据
+     * @param aiId AI ID
+     * @return 是否成功
      */
-    int executeNonQuery(const std::string& sql, 
-                       const std::vector<std::pair<std::string, std::string>>& parameters = {});
-    
+    bool deleteAiData(const QString& aiId);
+
     /**
-     * @brief 执行存储过程
-     * @param procName 存储过程名称
-     * @param parameters 参数列表
-     * @return 查询结果
+     * @brief 获取AI列表
+     * @param serverId 服务器ID，小于等于0表示所有服务器
+     * @return AI数据列表
      */
-    QueryResult executeStoredProcedure(const std::string& procName,
-                                      const std::vector<std::pair<std::string, std::string>>& parameters = {});
-    
-    // 异步查询接口
+    QVector<AIPlayerData> getAiList(int serverId = -1);
+
     /**
-     * @brief 异步执行查询
-     * @param operation 数据库操作
-     * @return 是否成功加入队列
+     * @brief 按服务器统计AI数量（用于启动时分片）
+     * @return 服务器ID -> AI数量
      */
-    bool executeAsync(const DatabaseOperation& operation);
-    
+    QMap<int, int> getAiCountByServer();
+
     /**
-     * @brief 批量异步执行
-     * @param operations 操作列表
-     * @return 成功加入队列的操作数量
+     * @brief 将服务器内的AI按ai_id切分为行数相近的区间
+     * @param serverId 服务器ID
+     * @param parts 区间数
+     * @return 各区间下界（升序）
      */
-    int executeBatchAsync(const std::vector<DatabaseOperation>& operations);
-    
-    // 事务管理接口
+    QStringList getAiKeyBoundaries(int serverId, int parts);
+
     /**
-     * @brief 开始事务
-     * @return 事务ID
+     * @brief 流式扫描一个分片的AI数据
+     * @param serverId 服务器ID
+     * @param fromAiId 区间下界（含），为空表示不设下界
+     * @param toAiId 区间上界（不含），为空表示不设上界
+     * @param visitor 每行回调，在调用线程上执行
+     * @return 读取的行数，失败返回-1
      */
-    std::string beginTransaction();
-    
+    int scanAiShard(int serverId, const QString& fromAiId, const QString& toAiId,
+                    const std::function<void(const QString&, const AIPlayerData&)>& visitor);
+
     /**
-     * @brief 提交事务
-     * @param transactionId 事务ID
-     * @return 是否成功提交
+     * @brief 流式扫描指定时间之后有变化的AI数据（用于快照对账）
+     * @param since 起始时间（按last_update过滤）
+     * @param visitor 每行回调，在调用线程上执行
+     * @return 读取的行数，失败返回-1
      */
-    bool commitTransaction(const std::string& transactionId);
-    
+    int scanAiChangedSince(const QDateTime& since,
+                           const std::function<void(const QString&, const AIPlayerData&)>& visitor);
+
     /**
-     * @brief 回滚事务
-     * @param transactionId 事务ID
-     * @return 是否成功回滚
+     * @brief 获取服务器统计信息
+     * @return 服务器ID -> 统计
      */
-    bool rollbackTransaction(const std::string& transactionId);
-    
-    // AI数据同步接口
+    QMap<int, ServerStats> getServerStats();
+
     /**
-     * @brief 同步AI玩家数据到数据库
-     * @param aiData AI数据
-     * @return 是否成功同步
+     * @brief 记录AI操作日志
+     * @param aiId AI ID
+     * @param operation 操作
+     * @param details 详情
+     * @return 是否已受理
      */
-    bool syncAIPlayer(const AIPlayerData& aiData);
-    
+    bool logAiOperation(const QString& aiId, const QString& operation, const QString& details = QString());
+
     /**
-     * @brief 批量同步AI玩家数据
-     * @param aiDataList AI数据列表
-     * @return 成功同步的数量
+     * @brief 清理过期日志和长时间离线的AI
+     * @param daysToKeep 日志保留天数（AI数据保留两倍时间）
+     * @return 是否成功
      */
-    int syncBatchAIPlayers(const std::vector<AIPlayerData>& aiDataList);
-    
+    bool cleanupExpiredData(int daysToKeep = 30);
+
+    // 异步写入接口
     /**
-     * @brief 从数据库加载AI玩家数据
-     * @param serverId 服务器ID，-1表示所有服务器
-     * @return AI数据列表
+     * @brief 异步执行操作
+     *
+     * 写操作走分组提交；查询和未开启分组提交时的写操作在工作线程上直接执行。
+     * @param operation 数据库操作
+     * @return 是否已受理
      */
-    std::vector<AIPlayerData> loadAIPlayers(int serverId = -1);
-    
+    bool executeAsync(const DatabaseOperation& operation);
+
     /**
-     * @brief 删除AI玩家数据
-     * @param aiId AI ID
-     * @return 是否成功删除
+     * @brief 批量异步执行写操作
+     * @param operations 操作列表
+     * @return 已受理的操作数量
      */
-    bool deleteAIPlayer(const std::string& aiId);
-    
+    int executeBatchAsync(const std::vector<DatabaseOperation>& operations);
+
     /**
-     * @brief 更新服务器负载统计
-     * @param serverId 服务器ID
-     * @param cpuUsage CPU使用率
-     * @param memoryUsage 内存使用率
-     * @param activeConnections 活跃连接数
-     * @return 是否成功更新
+     * @brief 在工作线程上获取连接并执行任务，不阻塞调用线程
+     * @param work 任务（获取超时时参数为空），返回后连接自动归还
      */
-    bool updateServerLoadStats(int serverId, float cpuUsage, float memoryUsage, int activeConnections);
-    
+    void acquireConnectionAsync(std::function<void(std::shared_ptr<QSqlDatabase>)> work);
+
     // 性能监控接口
     /**
      * @brief 获取数据库性能统计
-     * @return 性能数据映射
+     * @return 性能数据映射（整体及各语句的p50/p95/p99/最大延迟、行数、连接等待等）
      */
     std::unordered_map<std::string, double> getPerformanceStats() const;
-    
+
     /**
      * @brief 获取查询历史
      * @param limit 限制数量
-     * @return 查询历史列表
+     * @return 最近的慢查询（新的在前，只含参数形状不含参数值）
      */
     std::vector<std::string> getQueryHistory(int limit = 100) const;
-    
+
     /**
      * @brief 清理性能统计
      */
     void clearPerformanceStats();
 
-private:
     /**
-     * @brief 创建数据库连接
-     * @return 连接指针，失败返回nullptr
+     * @brief 获取按语句的查询统计
+     * @return 延迟直方图摘要、行数/字节数和慢查询记录
      */
-    std::shared_ptr<DatabaseConnection> createConnection();
-    
+    QueryMetricsSnapshot getQueryMetrics() const;
+
     /**
-     * @brief 从连接池获取连接
-     * @return 连接指针，失败返回nullptr
+     * @brief 获取预编译语句缓存统计
+     * @return 命中率、淘汰次数、prepare耗时等统计
      */
-    std::shared_ptr<DatabaseConnection> getConnection();
-    
+    StatementCacheStats getStatementCacheStats() const;
+
     /**
-     * @brief 返回连接到连接池
-     * @param connection 连接指针
+     * @brief 获取分组提交统计
+     * @return 提交次数、批量语句数、待写入数等统计
      */
-    void returnConnection(std::shared_ptr<DatabaseConnection> connection);
-    
+    GroupCommitStats getGroupCommitStats() const;
+
     /**
-     * @brief 关闭连接
-     * @param connection 连接指针
+     * @brief 获取连接池统计
+     * @return 连接数、超时次数、等待时间直方图等统计
+     */
+    ConnectionPoolStats getConnectionPoolStats() const;
+
+    /**
+     * @brief 获取分区日志存储统计
+     * @return 缓冲行数、写入行数、分区创建/清理数等统计
      */
-    void closeConnection(std::shared_ptr<DatabaseConnection> connection);
-    
+    LogPartitionStats getLogPartitionStats() const;
+
     /**
-     * @brief 异步处理循环
+     * @brief 获取离线缓冲统计
+     * @return 待重放数、累计缓冲/重放/丢弃数等统计
      */
-    void asyncProcessingLoop();
-    
+    OfflineBufferStats getOfflineBufferStats() const;
+
     /**
-     * @brief 连接池维护循环
+     * @brief 获取服务器统计聚合器的统计
+     * @return 跟踪的AI数、对账次数、偏差服务器数等统计
      */
-    void connectionPoolMaintenanceLoop();
-    
+    ServerStatsAggregatorStats getServerStatsAggregatorStats() const;
+
+signals:
     /**
-     * @brief 性能监控循环
+     * @brief 连接状态改变信号
+     * @param connected 远端是否可达
      */
-    void performanceMonitorLoop();
-    
+    void connectionStateChanged(bool connected);
+
     /**
-     * @brief 处理数据库操作
-     * @param operation 数据库操作
+     * @brief 数据已写入远端
+     * @param count 写入的AI数
      */
-    void processOperation(const DatabaseOperation& operation);
-    
+    void dataSynced(int count);
+
     /**
-     * @brief 检查连接有效性
-     * @param connection 连接指针
+     * @brief 一轮同步完成
+     */
+    void syncCompleted();
+
+    /**
+     * @brief 已受理的异步写操作最终写入失败（未转入离线缓冲）
+     * @param sql SQL语句
+     * @param error 错误信息
+     */
+    void asyncWriteFailed(const QString& sql, const QString& error);
+
+private slots:
+    /**
+     * @brief 执行同步（重放离线缓冲、刷写写回缓存和日志、对账统计）
+     */
+    void performSync();
+
+    /**
+     * @brief 发送心跳，检测断开与恢复
+     */
+    void sendHeartbeat();
+
+private:
+    /**
+     * @brief 验证并规整配置
      * @return 是否有效
      */
-    bool isConnectionValid(std::shared_ptr<DatabaseConnection> connection);
-    
+    bool validateConfiguration();
+
     /**
-     * @brief 准备SQL语句
-     * @param connection 连接指针
+     * @brief 创建连接池并预建连接
+     * @return 是否成功预建
+     */
+    bool createConnectionPool();
+
+    /**
+     * @brief 创建新连接（连接池回调）
+     * @param connectionName 连接名称
+     * @return 连接，失败返回nullptr
+     */
+    std::shared_ptr<QSqlDatabase> createNewConnection(const QString& connectionName);
+
+    /**
+     * @brief 关闭连接池
+     */
+    void closeConnectionPool();
+
+    /**
+     * @brief 初始化数据库结构
+     * @return 是否成功
+     */
+    bool initializeDatabaseSchema();
+
+    /**
+     * @brief 从连接池获取连接（最多等待poolAcquireTimeout）
+     * @return 连接，超时返回nullptr
+     */
+    std::shared_ptr<QSqlDatabase> getConnection();
+
+    /**
+     * @brief 归还连接
+     * @param connection 连接
+     */
+    void releaseConnection(std::shared_ptr<QSqlDatabase> connection);
+
+    /**
+     * @brief 执行语句
+     * @param sql SQL语句（使用?占位）
+     * @param params 参数
+     * @return 是否成功
+     */
+    bool executeQuery(const QString& sql, const QVariantList& params);
+
+    /**
+     * @brief 将写回缓存中的脏数据刷写到数据库
+     * @return 是否成功
+     */
+    bool flushWriteBehindCache();
+
+    /**
+     * @brief 将缓冲的操作日志写入分区日志表
+     * @return 是否成功
+     */
+    bool flushLogStore();
+
+    /**
+     * @brief 执行写操作，远端失败且不可达时转入离线缓冲
      * @param sql SQL语句
-     * @param parameters 参数列表
-     * @return 是否成功准备
+     * @param params 参数
+     * @return 是否已写入远端或离线缓冲
      */
-    bool prepareStatement(std::shared_ptr<DatabaseConnection> connection,
-                         const std::string& sql,
-                         const std::vector<std::pair<std::string, std::string>>& parameters);
-    
+    bool executeWrite(const QString& sql, const QVariantList& params);
+
+    /**
+     * @brief 确认远端不可达后把写操作追加到离线缓冲
+     * @param sql SQL语句
+     * @param rows 每组参数
+     * @return 是否已缓冲（远端仍可达时返回false）
+     */
+    bool bufferIfOffline(const QString& sql, const QVector<QVariantList>& rows);
+
+    /**
+     * @brief 处理异步执行失败的写操作（在写入线程或工作线程上调用）
+     *
+     * 远端不可达时转入离线缓冲；否则标记服务器统计待对账并发出asyncWriteFailed。
+     * @param sql SQL语句
+     * @param params 参数
+     * @param error 错误信息
+     * @return 是否已转入离线缓冲
+     */
+    bool handleAsyncWriteFailure(const QString& sql, const QVariantList& params, const QString& error);
+
+    /**
+     * @brief 标记为已断开并切换到重连检测间隔（可在任意线程调用）
+     */
+    void markDisconnected();
+
+    /**
+     * @brief 按顺序重放离线缓冲中的写操作
+     * @return 是否已全部重放
+     */
+    bool replayOfflineBuffer();
+
+    /**
+     * @brief 扫描AI玩家表对账服务器统计
+     * @param flushed 写回缓存是否已刷写（否则放弃本次对账）
+     */
+    void reconcileServerStats(bool flushed);
+
+    /**
+     * @brief 记录一次查询到按语句的统计
+     * @param sql 语句
+     * @param elapsedNs 耗时（纳秒）
+     * @param success 是否成功
+     * @param rows 影响的行数
+     * @param params 绑定参数
+     */
+    void recordQuery(const QString& sql, qint64 elapsedNs, bool success, int rows, const QVariantList& params);
+
     /**
-     * @brief 执行准备好的语句
+     * @brief 获取连接对应的预编译语句缓存（按需创建）
      * @param connection 连接指针
-     * @return 查询结果
+     * @return 缓存指针，缓存关闭时返回nullptr
      */
-    QueryResult executeStatement(std::shared_ptr<DatabaseConnection> connection);
-    
+    PreparedStatementCache* statementCacheFor(const std::shared_ptr<QSqlDatabase>& connection);
+
     /**
-     * @brief 处理ODBC错误
-     * @param handleType 句柄类型
-     * @param handle 句柄
-     * @return 错误信息
+     * @brief 按条件流式扫描AI数据
+     * @param condition WHERE条件（使用?占位）
+     * @param params 条件参数
+     * @param visitor 每行回调
+     * @return 读取的行数，失败返回-1
      */
-    std::string getODBCError(SQLSMALLINT handleType, SQLHANDLE handle);
+    int scanAiPlayers(const QString& condition, const QVariantList& params,
+                      const std::function<void(const QString&, const AIPlayerData&)>& visitor);
 
 private:
-    // 连接配置
-    std::string m_connectionString;                    ///< 连接字符串
-    int m_poolSize;                                    ///< 连接池大小
-    
-    // 连接池管理
-    std::queue<std::shared_ptr<DatabaseConnection>> m_connectionPool;
-    std::mutex m_poolMutex;                           ///< 连接池互斥锁
-    std::condition_variable m_poolCondition;          ///< 连接池条件变量
-    std::atomic<int> m_activeConnections;             ///< 活跃连接数
-    std::atomic<int> m_totalConnections;              ///< 总连接数
-    
-    // 操作队列
-    std::priority_queue<DatabaseOperation, std::vector<DatabaseOperation>,
-                       std::function<bool(const DatabaseOperation&, const DatabaseOperation&)>> m_operationQueue;
-    std::mutex m_queueMutex;                          ///< 操作队列互斥锁
-    std::condition_variable m_queueCondition;         ///< 队列条件变量
-    
-    // 线程管理
-    std::vector<std::thread> m_workerThreads;         ///< 工作线程组
-    std::atomic<bool> m_isRunning;                    ///< 运行状态标志
-    std::atomic<bool> m_shouldStop;                   ///< 停止标志
-    
-    // 事务管理
-    std::unordered_map<std::string, std::shared_ptr<DatabaseConnection>> m_transactions;
-    std::mutex m_transactionMutex;                    ///< 事务互斥锁
-    
+    // 状态
+    bool m_initialized;                                ///< 是否已初始化
+    std::atomic<bool> m_connected;                     ///< 远端是否可达（写入线程也会读取）
+    bool m_schemaReady = false;                        ///< 远端表结构是否已初始化
+
+    // 配置
+    DatabaseConfig m_config;                           ///< 数据库配置
+    int m_poolSize;                                    ///< 启动时预建的连接数
+    int m_connectionTimeout;                           ///< 连接超时（毫秒）
+    int m_queryTimeout;                                ///< 查询超时（毫秒）
+
+    // 定时器与线程池
+    QTimer* m_syncTimer;                               ///< 同步定时器
+    QTimer* m_heartbeatTimer;                          ///< 心跳定时器（离线时按重连间隔）
+    QThreadPool* m_threadPool;                         ///< 异步获取连接的工作线程池
+
+    // 连接池
+    std::unique_ptr<ConnectionPool> m_connectionPool;  ///< 线程亲和连接池
+    QMutex m_poolMutex;                                ///< 预编译语句缓存表互斥锁
+
+    // 预编译语句缓存（受m_poolMutex保护，缓存本身只由持有连接的线程使用）
+    std::unordered_map<QSqlDatabase*, std::unique_ptr<PreparedStatementCache>> m_statementCaches;
+    std::unique_ptr<StatementCacheCounters> m_statementCounters; ///< 所有连接的汇总计数
+
     // 性能统计
-    mutable std::mutex m_statsMutex;                  ///< 统计互斥锁
-    std::unordered_map<std::string, double> m_performanceStats; ///< 性能统计
-    std::vector<std::string> m_queryHistory;          ///< 查询历史
-    std::chrono::steady_clock::time_point m_lastStatsUpdate; ///< 上次统计更新时间
-    
+    std::unique_ptr<QueryMetrics> m_queryMetrics;      ///< 按语句的延迟直方图与慢查询记录
+
+    // 写回缓存
+    std::unique_ptr<AIWriteBehindCache> m_writeBehindCache; ///< AI玩家写回缓存（脏字段合并写入）
+
+    // 分组提交
+    std::unique_ptr<GroupCommitPipeline> m_groupCommit; ///< 日志/状态等高频写入的分组提交管线
+
+    // 分区日志
+    std::unique_ptr<LogPartitionStore> m_logStore;     ///< 按天分区的操作日志存储
+
+    // 存储后端与离线缓冲
+    std::unique_ptr<StorageBackend> m_backend;         ///< SQL Server或SQLite后端
+    std::unique_ptr<OfflineWriteBuffer> m_offlineBuffer; ///< 远端离线时的本地预写缓冲
+
+    // 服务器统计
+    std::unique_ptr<ServerStatsAggregator> m_serverStats; ///< 按服务器增量维护的AI汇总
+
     // 常量定义
     static constexpr int DEFAULT_POOL_SIZE = 10;             ///< 默认连接池大小
     static constexpr int MAX_POOL_SIZE = 50;                 ///< 最大连接池大小
-    static constexpr int CONNECTION_TIMEOUT = 30;            ///< 连接超时时间（秒）
-    static constexpr int QUERY_TIMEOUT = 60;                 ///< 查询超时时间（秒）
-    static constexpr int MAINTENANCE_INTERVAL = 300;         ///< 维护间隔（秒）
-    static constexpr int MAX_QUERY_HISTORY = 1000;           ///< 最大查询历史数量
-};
-
-/**
- * @class SqlServerConnector
- * @brief SQL Server专用连接器
- */
-class SqlServerConnector {
-public:
-    /**
-     * @brief 构建SQL Server连接字符串
-     * @param server 服务器地址
-     * @param database 数据库名称
-     * @param username 用户名（可选，使用Windows身份验证时为空）
-     * @param password 密码（可选）
-     * @param useWindowsAuth 是否使用Windows身份验证
-     * @return 连接字符串
-     */
-    static std::string buildConnectionString(const std::string& server,
-                                            const std::string& database,
-                                            const std::string& username = "",
-                                            const std::string& password = "",
-                                            bool useWindowsAuth = true);
-    
-    /**
-     * @brief 测试SQL Server连接
-     * @param connectionString 连接字符串
-     * @return 测试结果信息
-     */
-    static std::pair<bool, std::string> testConnection(const std::string& connectionString);
-    
-    /**
-     * @brief 获取SQL Server版本信息
-     * @param connectionString 连接字符串
-     * @return 版本信息
-     */
-    static std::string getServerVersion(const std::string& connectionString);
-    
-    /**
-     * @brief 检查数据库是否存在
-     * @param connectionString 连接字符串
-     * @param databaseName 数据库名称
-     * @return 是否存在
-     */
-    static bool isDatabaseExists(const std::string& connectionString, const std::string& databaseName);
-    
-    /**
-     * @brief 创建数据库（如果不存在）
-     * @param connectionString 连接字符串
-     * @param databaseName 数据库名称
-     * @return 是否成功创建
-     */
-    static bool createDatabaseIfNotExists(const std::string& connectionString, const std::string& databaseName);
+    static constexpr int HEARTBEAT_INTERVAL = 60;            ///< 心跳间隔（秒）
+    static constexpr int RECONNECT_INTERVAL = 5;             ///< 离线时重连检测间隔（秒）
 };
-
-#endif // DATABASEMANAGER_H
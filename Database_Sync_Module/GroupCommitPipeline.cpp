@@ -0,0 +1,292 @@
+/**
+ * @file GroupCommitPipeline.cpp
+ * @brief RANOnline EP7 AI系统 - 分组提交异步写入管线实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "GroupCommitPipeline.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/**
+ * @brief 构造函数
+ */
+GroupCommitPipeline::GroupCommitPipeline(AcquireConnection acquire, ReleaseConnection release,
+                                         int maxBatch, int maxDelayMs, int maxPending)
+    : m_acquire(std::move(acquire))
+    , m_release(std::move(release))
+    , m_maxBatch(qMax(1, maxBatch))
+    , m_maxDelayMs(qMax(1, maxDelayMs))
+    , m_maxPending(qMax(m_maxBatch, maxPending))
+    , m_pending(0)
+    , m_oldestEnqueueMs(0)
+    , m_flushRequested(false)
+    , m_running(false)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+GroupCommitPipeline::~GroupCommitPipeline()
+{
+    stop();
+}
+
+/**
+ * @brief 启动写入线程
+ */
+void GroupCommitPipeline::start()
+{
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_thread = std::thread(&GroupCommitPipeline::run, this);
+}
+
+/**
+ * @brief 刷写剩余操作并停止写入线程
+ */
+void GroupCommitPipeline::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_condition.wakeAll();
+    }
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+/**
+ * @brief 提交异步写入
+ */
+bool GroupCommitPipeline::submit(const QString& sql, const QVariantList& params, Callback callback)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_running.load() || m_pending >= m_maxPending) {
+        ++m_stats.rejected;
+        return false;
+    }
+
+    // 只并入紧邻的同一语句，其他语句插在中间时新开分组以保持执行顺序
+    if (m_groups.isEmpty() || m_groups.last().sql != sql) {
+        Group group;
+        group.sql = sql;
+        group.columns.resize(params.size());
+        m_groups.append(std::move(group));
+    } else if (m_groups.last().columns.size() != params.size()) {
+        // 同一SQL参数个数必须一致
+        ++m_stats.rejected;
+        return false;
+    }
+
+    Group& group = m_groups.last();
+
+    for (int i = 0; i < params.size(); ++i) {
+        group.columns[i].append(params.at(i));
+    }
+    group.callbacks.append(std::move(callback));
+    ++group.rows;
+
+    if (m_pending++ == 0) {
+        m_oldestEnqueueMs = QDateTime::currentMSecsSinceEpoch();
+    }
+    ++m_stats.submitted;
+
+    if (m_pending >= m_maxBatch) {
+        m_condition.wakeOne();
+    }
+    return true;
+}
+
+/**
+ * @brief 立即唤醒写入线程刷写
+ */
+void GroupCommitPipeline::flushNow()
+{
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+}
+
+/**
+ * @brief 获取统计
+ */
+GroupCommitStats GroupCommitPipeline::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    GroupCommitStats stats = m_stats;
+    stats.pending = m_pending;
+    return stats;
+}
+
+/**
+ * @brief 写入线程主循环
+ */
+void GroupCommitPipeline::run()
+{
+    while (true) {
+        QVector<Group> groups;
+        {
+            QMutexLocker locker(&m_mutex);
+
+            // 等到数量达标、最早操作到期、请求刷写或停止
+            while (m_running.load() && !m_flushRequested && m_pending < m_maxBatch) {
+                if (m_pending == 0) {
+                    m_condition.wait(&m_mutex);
+                    continue;
+                }
+
+                qint64 waited = QDateTime::currentMSecsSinceEpoch() - m_oldestEnqueueMs;
+                if (waited >= m_maxDelayMs) {
+                    break;
+                }
+                m_condition.wait(&m_mutex, static_cast<unsigned long>(m_maxDelayMs - waited));
+            }
+
+            if (m_pending == 0) {
+                m_flushRequested = false;
+                if (!m_running.load()) {
+                    return;
+                }
+                continue;
+            }
+
+            groups.swap(m_groups);
+            m_pending = 0;
+            m_flushRequested = false;
+        }
+
+        flushGroups(groups);
+    }
+}
+
+/**
+ * @brief 在一个事务中按顺序写入全部分组
+ */
+void GroupCommitPipeline::flushGroups(const QVector<Group>& groups)
+{
+    auto connection = m_acquire();
+    if (!connection) {
+        {
+            QMutexLocker locker(&m_mutex);
+            for (const Group& group : groups) {
+                m_stats.failedOperations += group.rows;
+            }
+        }
+        for (const Group& group : groups) {
+            notifyGroup(group, false, "无可用数据库连接");
+        }
+        return;
+    }
+
+    QSqlDatabase& db = *connection;
+    QString error;
+    bool success = db.transaction();
+
+    for (int i = 0; success && i < groups.size(); ++i) {
+        success = executeGroup(db, groups.at(i), error);
+    }
+
+    if (success && db.commit()) {
+        {
+            QMutexLocker locker(&m_mutex);
+            ++m_stats.flushes;
+            m_stats.statements += groups.size();
+        }
+        for (const Group& group : groups) {
+            notifyGroup(group, true, QString());
+        }
+        m_release(connection);
+        return;
+    }
+
+    db.rollback();
+    qWarning() << "GroupCommitPipeline: 批量提交失败，按语句分别重试:" << error;
+
+    // 按原顺序逐个分组重试，隔离出错的语句
+    for (const Group& group : groups) {
+        QString groupError;
+        bool groupSuccess = db.transaction()
+            && executeGroup(db, group, groupError)
+            && db.commit();
+
+        if (!groupSuccess) {
+            db.rollback();
+            if (groupError.isEmpty()) {
+                groupError = db.lastError().text();
+            }
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            ++m_stats.flushes;
+            ++m_stats.statements;
+            if (!groupSuccess) {
+                m_stats.failedOperations += group.rows;
+            }
+        }
+        notifyGroup(group, groupSuccess, groupError);
+    }
+
+    m_release(connection);
+}
+
+/**
+ * @brief 执行一个分组
+ */
+bool GroupCommitPipeline::executeGroup(QSqlDatabase& db, const Group& group, QString& error)
+{
+    QSqlQuery query(db);
+    if (!query.prepare(group.sql)) {
+        error = query.lastError().text();
+        return false;
+    }
+
+    // 单个操作或无参数语句逐次执行，其余数组绑定
+    if (group.rows == 1 || group.columns.isEmpty()) {
+        for (int row = 0; row < group.rows; ++row) {
+            for (int i = 0; i < group.columns.size(); ++i) {
+                query.bindValue(i, group.columns.at(i).at(row));
+            }
+            if (!query.exec()) {
+                error = query.lastError().text();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    for (int i = 0; i < group.columns.size(); ++i) {
+        query.bindValue(i, group.columns.at(i));
+    }
+    if (!query.execBatch()) {
+        error = query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 回调分组内全部操作
+ */
+void GroupCommitPipeline::notifyGroup(const Group& group, bool success, const QString& error)
+{
+    for (const Callback& callback : group.callbacks) {
+        if (callback) {
+            callback(success, error);
+        }
+    }
+}
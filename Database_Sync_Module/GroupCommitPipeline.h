@@ -0,0 +1,173 @@
+/**
+ * @file GroupCommitPipeline.h
+ * @brief RANOnline EP7 AI系统 - 分组提交异步写入管线头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 连续的相同语句异步写入合并为一次数组绑定执行，保持提交顺序
+ * - 一次刷写的所有语句共用一个事务，每批只提交一次
+ * - 按数量或最长等待时间触发刷写
+ * - 每个操作单独回调执行结果
+ */
+
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+class QSqlDatabase;
+
+/**
+ * @struct GroupCommitStats
+ * @brief 分组提交统计
+ */
+struct GroupCommitStats
+{
+    quint64 submitted = 0;          ///< 提交的操作数
+    quint64 rejected = 0;           ///< 队列满被拒绝的操作数
+    quint64 flushes = 0;            ///< 刷写次数（即事务提交次数）
+    quint64 statements = 0;         ///< 执行的批量语句数
+    quint64 failedOperations = 0;   ///< 执行失败的操作数
+    int pending = 0;                ///< 当前待写入操作数
+};
+
+/**
+ * @class GroupCommitPipeline
+ * @brief 分组提交异步写入管线
+ *
+ * submit()把参数追加到按提交顺序排列的分组中：与上一个分组SQL相同时并入，
+ * 否则新开分组，因此只有连续的相同语句会合并，不同语句之间的先后顺序不变
+ * （例如先UPDATE再DELETE同一行）。写入线程在待写入数达到maxBatch或最早的
+ * 操作等待超过maxDelayMs时取走全部分组，在一个事务中按顺序对每个分组
+ * prepare一次并execBatch，提交后逐个回调。整批失败时回滚，再按顺序以各自的
+ * 事务重试每个分组，只让出错语句上的操作收到失败回调。
+ */
+class GroupCommitPipeline
+{
+public:
+    /**
+     * @brief 操作完成回调（在写入线程上执行）
+     */
+    using Callback = std::function<void(bool success, const QString& error)>;
+
+    /**
+     * @brief 获取连接
+     */
+    using AcquireConnection = std::function<std::shared_ptr<QSqlDatabase>()>;
+
+    /**
+     * @brief 归还连接
+     */
+    using ReleaseConnection = std::function<void(std::shared_ptr<QSqlDatabase>)>;
+
+    /**
+     * @brief 构造函数
+     * @param acquire 获取连接
+     * @param release 归还连接
+     * @param maxBatch 触发刷写的待写入数
+     * @param maxDelayMs 最长等待时间（毫秒）
+     * @param maxPending 待写入上限，超过后拒绝提交
+     */
+    GroupCommitPipeline(AcquireConnection acquire, ReleaseConnection release,
+                        int maxBatch, int maxDelayMs, int maxPending = 100000);
+
+    /**
+     * @brief 析构函数，刷写剩余操作
+     */
+    ~GroupCommitPipeline();
+
+    /**
+     * @brief 启动写入线程
+     */
+    void start();
+
+    /**
+     * @brief 刷写剩余操作并停止写入线程
+     */
+    void stop();
+
+    /**
+     * @brief 提交异步写入
+     * @param sql SQL语句（与上一个操作文本相同时合并执行）
+     * @param params 位置参数
+     * @param callback 完成回调（可为空）
+     * @return 是否成功加入队列（写入结果只通过回调得知）
+     */
+    bool submit(const QString& sql, const QVariantList& params, Callback callback = Callback());
+
+    /**
+     * @brief 立即唤醒写入线程刷写
+     */
+    void flushNow();
+
+    /**
+     * @brief 获取统计
+     * @return 统计快照
+     */
+    GroupCommitStats stats() const;
+
+private:
+    /**
+     * @struct Group
+     * @brief 同一语句的待写入操作
+     */
+    struct Group {
+        QString sql;                    ///< SQL语句
+        QVector<QVariantList> columns;  ///< 按列存放的参数
+        QVector<Callback> callbacks;    ///< 每个操作的回调
+        int rows = 0;                   ///< 操作数
+    };
+
+    /**
+     * @brief 写入线程主循环
+     */
+    void run();
+
+    /**
+     * @brief 在一个事务中按顺序写入全部分组
+     * @param groups 待写入分组（按提交顺序）
+     */
+    void flushGroups(const QVector<Group>& groups);
+
+    /**
+     * @brief 执行一个分组
+     * @param db 数据库连接
+     * @param group 分组
+     * @param error 输出错误信息
+     * @return 是否成功
+     */
+    bool executeGroup(QSqlDatabase& db, const Group& group, QString& error);
+
+    /**
+     * @brief 回调分组内全部操作
+     */
+    void notifyGroup(const Group& group, bool success, const QString& error);
+
+private:
+    AcquireConnection m_acquire;        ///< 获取连接
+    ReleaseConnection m_release;        ///< 归还连接
+    int m_maxBatch;                     ///< 触发刷写的待写入数
+    int m_maxDelayMs;                   ///< 最长等待时间
+    int m_maxPending;                   ///< 待写入上限
+
+    mutable QMutex m_mutex;             ///< 缓冲互斥锁
+    QWaitCondition m_condition;         ///< 写入线程唤醒条件
+    QVector<Group> m_groups;            ///< 按提交顺序排列的待写入分组
+    int m_pending;                      ///< 待写入操作数
+    qint64 m_oldestEnqueueMs;           ///< 最早待写入操作的入队时间
+    bool m_flushRequested;              ///< 是否请求立即刷写
+
+    std::thread m_thread;               ///< 写入线程
+    std::atomic<bool> m_running;        ///< 运行标志
+
+    GroupCommitStats m_stats;           ///< 统计（受m_mutex保护）
+};
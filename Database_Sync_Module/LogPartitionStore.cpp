@@ -0,0 +1,389 @@
+/**
+ * @file LogPartitionStore.cpp
+ * @brief RANOnline EP7 AI系统 - 按天分区的AI操作日志存储实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "LogPartitionStore.h"
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+const QLatin1String PARTITION_FUNCTION("PF_RAN_AI_Logs_Day");
+const QLatin1String PARTITION_SCHEME("PS_RAN_AI_Logs_Day");
+
+/**
+ * @brief 日期字面量（yyyyMMdd不受DATEFORMAT设置影响）
+ */
+QString dateLiteral(const QDate& date)
+{
+    return QString("'%1'").arg(date.toString("yyyyMMdd"));
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ */
+LogPartitionStore::LogPartitionStore(int maxBufferedRows, int precreateDays)
+    : m_maxBufferedRows(qMax(1, maxBufferedRows))
+    , m_precreateDays(qMax(0, precreateDays))
+    , m_boundariesLoaded(false)
+{
+}
+
+/**
+ * @brief 创建分区函数、分区方案和分区表
+ */
+bool LogPartitionStore::ensureSchema(QSqlDatabase& db)
+{
+    const QDate today = QDate::currentDate();
+
+    const QStringList statements = {
+        // 分区函数：每个边界是一天的开始，RANGE RIGHT使边界当天归入右侧分区
+        QString(R"(
+            IF NOT EXISTS (SELECT * FROM sys.partition_functions WHERE name = '%1')
+            CREATE PARTITION FUNCTION %1 (DATETIME) AS RANGE RIGHT FOR VALUES (%2)
+        )").arg(PARTITION_FUNCTION, dateLiteral(today)),
+
+        QString(R"(
+            IF NOT EXISTS (SELECT * FROM sys.partition_schemes WHERE name = '%1')
+            CREATE PARTITION SCHEME %1 AS PARTITION %2 ALL TO ([PRIMARY])
+        )").arg(PARTITION_SCHEME, PARTITION_FUNCTION),
+
+        // 旧版未分区的日志表改名保留，到期后整表删除
+        QString(R"(
+            IF OBJECT_ID('RAN_AI_Logs', 'U') IS NOT NULL
+               AND OBJECT_ID('RAN_AI_Logs_Legacy', 'U') IS NULL
+               AND NOT EXISTS (SELECT * FROM sys.indexes i
+                               JOIN sys.partition_schemes ps ON i.data_space_id = ps.data_space_id
+                               WHERE i.object_id = OBJECT_ID('RAN_AI_Logs') AND i.index_id <= 1)
+            EXEC sp_rename 'RAN_AI_Logs', 'RAN_AI_Logs_Legacy'
+        )"),
+
+        // 聚集键以时间开头，追加写入只落在最新分区；索引与表按同一方案对齐
+        QString(R"(
+            IF OBJECT_ID('RAN_AI_Logs', 'U') IS NULL
+            CREATE TABLE RAN_AI_Logs (
+                id BIGINT IDENTITY(1,1) NOT NULL,
+                ai_id NVARCHAR(50) NOT NULL,
+                operation NVARCHAR(100) NOT NULL,
+                details NVARCHAR(MAX),
+                timestamp DATETIME NOT NULL DEFAULT GETDATE(),
+                CONSTRAINT PK_RAN_AI_Logs PRIMARY KEY CLUSTERED (timestamp, id),
+                INDEX IX_AI_Logs_AiId NONCLUSTERED (ai_id, timestamp)
+            ) ON %1 (timestamp)
+        )").arg(PARTITION_SCHEME)
+    };
+
+    for (const QString& sql : statements) {
+        if (!execute(db, sql)) {
+            qCritical() << "LogPartitionStore: 创建分区日志表失败:" << lastError();
+            return false;
+        }
+    }
+
+    m_boundariesLoaded = false;
+    return ensurePartitions(db, today, today.addDays(m_precreateDays));
+}
+
+/**
+ * @brief 追加日志
+ */
+void LogPartitionStore::append(const LogRecord& record)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_buffer.size() >= m_maxBufferedRows) {
+        // 数据库长时间不可用时丢弃最旧的日志，避免内存无限增长
+        m_buffer.removeFirst();
+        ++m_stats.droppedRows;
+    }
+
+    m_buffer.append(record);
+    ++m_stats.appended;
+}
+
+/**
+ * @brief 将缓冲写入数据库
+ */
+int LogPartitionStore::flush(QSqlDatabase& db)
+{
+    QVector<LogRecord> records;
+    {
+        QMutexLocker locker(&m_mutex);
+        records.swap(m_buffer);
+    }
+
+    if (records.isEmpty()) {
+        return 0;
+    }
+
+    QDate firstDay = records.first().timestamp.date();
+    QDate lastDay = firstDay;
+    for (const LogRecord& record : records) {
+        const QDate day = record.timestamp.date();
+        firstDay = qMin(firstDay, day);
+        lastDay = qMax(lastDay, day);
+    }
+
+    // 先补齐分区（只在空分区上SPLIT），再在一个事务中分块插入
+    bool success = ensurePartitions(db, firstDay, qMax(lastDay, QDate::currentDate().addDays(m_precreateDays)));
+    bool inTransaction = false;
+
+    if (success) {
+        inTransaction = db.transaction();
+        success = inTransaction;
+    }
+
+    for (int offset = 0; success && offset < records.size(); offset += ROWS_PER_INSERT) {
+        success = insertChunk(db, records, offset, qMin(ROWS_PER_INSERT, records.size() - offset));
+    }
+
+    if (success) {
+        success = db.commit();
+        if (!success) {
+            setError(db.lastError().text());
+        }
+    }
+
+    if (!success) {
+        if (inTransaction) {
+            db.rollback();
+        }
+
+        // 放回缓冲头部，下次重试
+        QMutexLocker locker(&m_mutex);
+        records += m_buffer;
+        const int overflow = records.size() - m_maxBufferedRows;
+        if (overflow > 0) {
+            records.remove(0, overflow);
+            m_stats.droppedRows += overflow;
+        }
+        m_buffer.swap(records);
+        ++m_stats.failedFlushes;
+        qWarning() << "LogPartitionStore: 日志写入失败，保留待重试:" << m_lastError;
+        return -1;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.flushedRows += records.size();
+    ++m_stats.flushes;
+    return records.size();
+}
+
+/**
+ * @brief 补齐分区边界
+ */
+bool LogPartitionStore::ensurePartitions(QSqlDatabase& db, const QDate& from, const QDate& to)
+{
+    if (!m_boundariesLoaded && !loadBoundaries(db)) {
+        return false;
+    }
+
+    const QVector<QDate> missing = missingBoundaries(m_boundaries, from, to);
+
+    for (const QDate& day : missing) {
+        bool success = execute(db, QString("ALTER PARTITION SCHEME %1 NEXT USED [PRIMARY]").arg(PARTITION_SCHEME))
+            && execute(db, QString("ALTER PARTITION FUNCTION %1() SPLIT RANGE (%2)")
+                               .arg(PARTITION_FUNCTION, dateLiteral(day)));
+        if (!success) {
+            // 边界可能已被其他实例创建，下次重新读取
+            m_boundariesLoaded = false;
+            qWarning() << "LogPartitionStore: 创建分区失败:" << day << lastError();
+            return false;
+        }
+
+        m_boundaries.append(day);
+
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.partitionsCreated;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 清理早于cutoff的分区
+ */
+int LogPartitionStore::dropPartitionsBefore(QSqlDatabase& db, const QDate& cutoff)
+{
+    if (!loadBoundaries(db)) {
+        return -1;
+    }
+
+    const int count = expiredPartitionCount(m_boundaries, cutoff);
+
+    // 最旧的分区只含早于第一个边界的行：截断后与右侧分区合并，均为元数据操作
+    for (int i = 0; i < count; ++i) {
+        const QDate boundary = m_boundaries.first();
+        bool success = execute(db, "TRUNCATE TABLE RAN_AI_Logs WITH (PARTITIONS (1))")
+            && execute(db, QString("ALTER PARTITION FUNCTION %1() MERGE RANGE (%2)")
+                               .arg(PARTITION_FUNCTION, dateLiteral(boundary)));
+        if (!success) {
+            m_boundariesLoaded = false;
+            qWarning() << "LogPartitionStore: 清理分区失败:" << boundary << lastError();
+            return -1;
+        }
+
+        m_boundaries.removeFirst();
+
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.partitionsDropped;
+    }
+
+    // 旧版未分区表在全部过期后整表删除
+    execute(db, QString(R"(
+        IF OBJECT_ID('RAN_AI_Logs_Legacy', 'U') IS NOT NULL
+           AND NOT EXISTS (SELECT 1 FROM RAN_AI_Logs_Legacy WHERE timestamp >= %1)
+        DROP TABLE RAN_AI_Logs_Legacy
+    )").arg(dateLiteral(cutoff)));
+
+    if (count > 0) {
+        qDebug() << "LogPartitionStore: 已清理" << count << "个日志分区，保留自" << cutoff;
+    }
+    return count;
+}
+
+/**
+ * @brief 获取统计
+ */
+LogPartitionStats LogPartitionStore::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    LogPartitionStats stats = m_stats;
+    stats.buffered = m_buffer.size();
+    return stats;
+}
+
+/**
+ * @brief 获取上次错误信息
+ */
+QString LogPartitionStore::lastError() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastError;
+}
+
+/**
+ * @brief 计算需要新建的边界
+ */
+QVector<QDate> LogPartitionStore::missingBoundaries(const QVector<QDate>& existing,
+                                                    const QDate& from, const QDate& to)
+{
+    QVector<QDate> result;
+    if (!from.isValid() || !to.isValid()) {
+        return result;
+    }
+
+    // 只向右追加，保证新边界右侧没有数据；早于最大边界的日期已由现有分区覆盖
+    QDate day = existing.isEmpty() ? from : existing.last().addDays(1);
+    for (; day <= to; day = day.addDays(1)) {
+        result.append(day);
+    }
+    return result;
+}
+
+/**
+ * @brief 计算可整体清理的分区数
+ */
+int LogPartitionStore::expiredPartitionCount(const QVector<QDate>& boundaries, const QDate& cutoff)
+{
+    int count = 0;
+    // 保留最后一个边界，分区函数不为空
+    while (count < boundaries.size() - 1 && boundaries.at(count) <= cutoff) {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief 从数据库读取分区边界
+ */
+bool LogPartitionStore::loadBoundaries(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    const QString sql = QString(R"(
+        SELECT CAST(prv.value AS DATETIME)
+        FROM sys.partition_range_values prv
+        JOIN sys.partition_functions pf ON pf.function_id = prv.function_id
+        WHERE pf.name = '%1'
+        ORDER BY prv.boundary_id
+    )").arg(PARTITION_FUNCTION);
+
+    if (!query.exec(sql)) {
+        setError(query.lastError().text());
+        return false;
+    }
+
+    m_boundaries.clear();
+    while (query.next()) {
+        m_boundaries.append(query.value(0).toDateTime().date());
+    }
+    m_boundariesLoaded = true;
+    return true;
+}
+
+/**
+ * @brief 多行VALUES插入一块
+ */
+bool LogPartitionStore::insertChunk(QSqlDatabase& db, const QVector<LogRecord>& records, int offset, int count)
+{
+    QStringList rows;
+    rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        rows.append("(?, ?, ?, ?)");
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare("INSERT INTO RAN_AI_Logs (ai_id, operation, details, timestamp) VALUES "
+                       + rows.join(", "))) {
+        setError(query.lastError().text());
+        return false;
+    }
+
+    int index = 0;
+    for (int i = offset; i < offset + count; ++i) {
+        const LogRecord& record = records.at(i);
+        query.bindValue(index++, record.aiId);
+        query.bindValue(index++, record.operation);
+        query.bindValue(index++, record.details);
+        query.bindValue(index++, record.timestamp);
+    }
+
+    if (!query.exec()) {
+        setError(query.lastError().text());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 执行一条SQL并记录错误
+ */
+bool LogPartitionStore::execute(QSqlDatabase& db, const QString& sql)
+{
+    QSqlQuery query(db);
+    if (!query.exec(sql)) {
+        setError(query.lastError().text());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 记录错误
+ */
+void LogPartitionStore::setError(const QString& error)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastError = error;
+}
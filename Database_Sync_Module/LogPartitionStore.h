@@ -0,0 +1,174 @@
+/**
+ * @file LogPartitionStore.h
+ * @brief RANOnline EP7 AI系统 - 按天分区的AI操作日志存储头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 日志先追加到内存缓冲，由同步定时器批量写入
+ * - RAN_AI_Logs按天分区（分区函数RANGE RIGHT），提前创建空分区
+ * - 多行VALUES批量插入，一次往返写入数百行
+ * - 保留期清理按整个分区截断并合并边界，不再逐行DELETE
+ */
+
+#pragma once
+
+#include <QtCore/QDate>
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class QSqlDatabase;
+
+/**
+ * @struct LogPartitionStats
+ * @brief 日志存储统计
+ */
+struct LogPartitionStats
+{
+    int buffered = 0;                   ///< 当前缓冲行数
+    quint64 appended = 0;               ///< 追加的行数
+    quint64 droppedRows = 0;            ///< 缓冲满被丢弃的行数
+    quint64 flushedRows = 0;            ///< 已写入数据库的行数
+    quint64 flushes = 0;                ///< 成功刷写次数
+    quint64 failedFlushes = 0;          ///< 失败刷写次数
+    quint64 partitionsCreated = 0;      ///< 新建分区数
+    quint64 partitionsDropped = 0;      ///< 清理的分区数
+};
+
+/**
+ * @class LogPartitionStore
+ * @brief 按天分区的AI操作日志存储
+ *
+ * append()可在任意线程调用，只做内存追加；flush()在持有连接的线程上调用，
+ * 先为缓冲中出现的日期补齐分区边界，再分块多行插入。新边界总是加在最大
+ * 边界之后的空分区上，SPLIT不搬移数据；清理时截断最旧的分区再MERGE掉其
+ * 边界，两者都只改元数据。
+ */
+class LogPartitionStore
+{
+public:
+    /**
+     * @struct LogRecord
+     * @brief 一条日志
+     */
+    struct LogRecord {
+        QString aiId;                   ///< AI ID
+        QString operation;              ///< 操作
+        QString details;                ///< 详情
+        QDateTime timestamp;            ///< 发生时间
+    };
+
+    /**
+     * @brief 构造函数
+     * @param maxBufferedRows 缓冲上限，超过后丢弃最旧的行
+     * @param precreateDays 提前创建的未来分区天数
+     */
+    LogPartitionStore(int maxBufferedRows, int precreateDays);
+
+    /**
+     * @brief 创建分区函数、分区方案和分区表
+     * @param db 数据库连接
+     * @return 是否成功
+     *
+     * 已存在的未分区RAN_AI_Logs会被重命名为RAN_AI_Logs_Legacy，
+     * 到期后整表删除。
+     */
+    bool ensureSchema(QSqlDatabase& db);
+
+    /**
+     * @brief 追加日志（线程安全）
+     * @param record 日志
+     */
+    void append(const LogRecord& record);
+
+    /**
+     * @brief 将缓冲写入数据库
+     * @param db 数据库连接
+     * @return 写入的行数，失败返回-1（缓冲保留，下次重试）
+     */
+    int flush(QSqlDatabase& db);
+
+    /**
+     * @brief 补齐[from, to]范围内的分区边界
+     * @param db 数据库连接
+     * @param from 起始日期
+     * @param to 结束日期
+     * @return 是否成功
+     */
+    bool ensurePartitions(QSqlDatabase& db, const QDate& from, const QDate& to);
+
+    /**
+     * @brief 清理早于cutoff的分区
+     * @param db 数据库连接
+     * @param cutoff 保留起始日期，更早的整天分区被截断
+     * @return 清理的分区数，失败返回-1
+     */
+    int dropPartitionsBefore(QSqlDatabase& db, const QDate& cutoff);
+
+    /**
+     * @brief 获取统计
+     * @return 统计快照
+     */
+    LogPartitionStats stats() const;
+
+    /**
+     * @brief 获取上次错误信息
+     * @return 错误信息
+     */
+    QString lastError() const;
+
+    /**
+     * @brief 计算需要新建的边界（只在最大已有边界之后追加）
+     * @param existing 已有边界（升序）
+     * @param from 起始日期
+     * @param to 结束日期
+     * @return 需要新建的边界（升序）
+     */
+    static QVector<QDate> missingBoundaries(const QVector<QDate>& existing, const QDate& from, const QDate& to);
+
+    /**
+     * @brief 计算可整体清理的分区数
+     * @param boundaries 已有边界（升序）
+     * @param cutoff 保留起始日期
+     * @return 从最旧分区起可清理的个数（至少保留一个边界）
+     */
+    static int expiredPartitionCount(const QVector<QDate>& boundaries, const QDate& cutoff);
+
+private:
+    /**
+     * @brief 从数据库读取分区边界
+     */
+    bool loadBoundaries(QSqlDatabase& db);
+
+    /**
+     * @brief 多行VALUES插入一块
+     */
+    bool insertChunk(QSqlDatabase& db, const QVector<LogRecord>& records, int offset, int count);
+
+    /**
+     * @brief 执行一条SQL并记录错误
+     */
+    bool execute(QSqlDatabase& db, const QString& sql);
+
+    /**
+     * @brief 记录错误
+     */
+    void setError(const QString& error);
+
+private:
+    int m_maxBufferedRows;              ///< 缓冲上限
+    int m_precreateDays;                ///< 提前创建的分区天数
+
+    mutable QMutex m_mutex;             ///< 缓冲和统计互斥锁
+    QVector<LogRecord> m_buffer;        ///< 待写入日志
+    LogPartitionStats m_stats;          ///< 统计
+    QString m_lastError;                ///< 上次错误
+
+    QVector<QDate> m_boundaries;        ///< 已知分区边界（升序，仅刷写线程访问）
+    bool m_boundariesLoaded;            ///< 边界是否已从数据库读取
+
+    static constexpr int ROWS_PER_INSERT = 500;     ///< 每条INSERT的行数（4列，低于2100参数上限）
+};
@@ -347,7 +347,11 @@ QStringList ODBCConnectionManager::getAvailableDrivers() const
 
 QSqlQuery ODBCConnectionManager::executeQuery(const QString &queryString)
 {
+    // 单连接由m_mutex串行化，等锁时间即连接等待时间
+    QElapsedTimer waitTimer;
+    waitTimer.start();
     QMutexLocker locker(&m_mutex);
+    m_queryMetrics.recordPoolWait(waitTimer.nsecsElapsed());
     
     if (!m_database.isOpen()) {
         logError("executeQuery", "Database not connected");
@@ -361,9 +365,9 @@ QSqlQuery ODBCConnectionManager::executeQuery(const QString &queryString)
     query.setForwardOnly(true); // 优化性能
     
     bool success = query.exec(queryString);
-    double executionTime = timer.elapsed();
+    double executionTime = timer.nsecsElapsed() / 1e6;
     
-    recordQueryMetrics(success, executionTime);
+    recordQueryMetrics(queryString, success, timer.nsecsElapsed(), query);
     
     if (success) {
         logInfo(QString("Query executed successfully in %1ms: %2")
@@ -381,7 +385,10 @@ QSqlQuery ODBCConnectionManager::executeQuery(const QString &queryString)
 
 QSqlQuery ODBCConnectionManager::executePreparedQuery(const QString &queryString, const QVariantList &parameters)
 {
+    QElapsedTimer waitTimer;
+    waitTimer.start();
     QMutexLocker locker(&m_mutex);
+    m_queryMetrics.recordPoolWait(waitTimer.nsecsElapsed());
     
     if (!m_database.isOpen()) {
         logError("executePreparedQuery", "Database not connected");
@@ -398,6 +405,7 @@ QSqlQuery ODBCConnectionManager::executePreparedQuery(const QString &queryString
         QString error = query.lastError().text();
         logError("executePreparedQuery", QString("Query preparation failed: %1 | Error: %2")
                  .arg(queryString.left(100)).arg(error));
+        recordQueryMetrics(queryString, false, timer.nsecsElapsed(), query, parameters);
         return query;
     }
     
@@ -407,9 +415,9 @@ QSqlQuery ODBCConnectionManager::executePreparedQuery(const QString &queryString
     }
     
     bool success = query.exec();
-    double executionTime = timer.elapsed();
+    double executionTime = timer.nsecsElapsed() / 1e6;
     
-    recordQueryMetrics(success, executionTime);
+    recordQueryMetrics(queryString, success, timer.nsecsElapsed(), query, parameters);
     
     if (success) {
         logInfo(QString("Prepared query executed successfully in %1ms: %2")
@@ -736,7 +744,8 @@ bool ODBCConnectionManager::testConnection(const QString &connectionString)
     return success;
 }
 
-void ODBCConnectionManager::recordQueryMetrics(bool success, double executionTime)
+void ODBCConnectionManager::recordQueryMetrics(const QString &queryString, bool success, qint64 elapsedNs,
+                                               const QSqlQuery &query, const QVariantList &parameters)
 {
     m_status.totalQueries++;
     
@@ -746,8 +755,18 @@ void ODBCConnectionManager::recordQueryMetrics(bool success, double executionTim
         m_status.failedQueries++;
     }
     
-    m_totalQueryTime += executionTime;
+    m_totalQueryTime += elapsedNs / 1e6;
     m_status.averageQueryTime = m_totalQueryTime / m_status.totalQueries;
+    
+    // 平均值掩盖尾延迟，按语句记录直方图；SELECT的行数在此时未知，只记录影响行数
+    int rows = success ? query.numRowsAffected() : 0;
+    m_queryMetrics.record(queryString, elapsedNs, success, qMax(rows, 0),
+                          QueryMetrics::parameterBytes(parameters), parameters);
+}
+
+QueryMetricsSnapshot ODBCConnectionManager::getQueryMetrics() const
+{
+    return m_queryMetrics.snapshot();
 }
 
 // ============================================================================
@@ -13,6 +13,7 @@
 #include <QDebug>
 #include <memory>
 #include <atomic>
+#include "QueryMetrics.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -110,6 +111,7 @@ public:
     QString getConnectionString() const;
     QString getLastError() const;
     void clearErrorHistory();
+    QueryMetricsSnapshot getQueryMetrics() const;   // 按语句的延迟分布、慢查询和锁等待
 
 public slots:
     void reconnect();
@@ -135,7 +137,8 @@ private:
     void updateConnectionStatus(bool connected, const QString &error = QString());
     QString formatConnectionString(const ConnectionConfig &config) const;
     bool testConnection(const QString &connectionString);
-    void recordQueryMetrics(bool success, double executionTime);
+    void recordQueryMetrics(const QString &queryString, bool success, qint64 elapsedNs,
+                            const QSqlQuery &query, const QVariantList &parameters = QVariantList());
 
     // 数据成员
     mutable QMutex m_mutex;
@@ -153,6 +156,9 @@ private:
     // 性能统计
     QDateTime m_lastQueryTime;
     double m_totalQueryTime = 0.0;
+    static const int SLOW_QUERY_THRESHOLD_MS = 200;
+    static const int SLOW_QUERY_LOG_SIZE = 256;
+    QueryMetrics m_queryMetrics{SLOW_QUERY_THRESHOLD_MS, SLOW_QUERY_LOG_SIZE};
     
     // 错误历史
     QStringList m_errorHistory;
@@ -0,0 +1,362 @@
+/**
+ * @file OfflineWriteBuffer.cpp
+ * @brief RANOnline EP7 AI系统 - 远端数据库离线时的本地预写缓冲实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "OfflineWriteBuffer.h"
+#include "ConnectionPool.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QIODevice>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/**
+ * @brief 构造函数
+ */
+OfflineWriteBuffer::OfflineWriteBuffer(const QString& filePath)
+    : m_backend(filePath, LOCAL_ACQUIRE_TIMEOUT)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+OfflineWriteBuffer::~OfflineWriteBuffer()
+{
+    close();
+}
+
+/**
+ * @brief 打开本地缓冲
+ */
+bool OfflineWriteBuffer::open()
+{
+    m_pool = std::make_unique<ConnectionPool>(
+        [this](const QString& connectionName) { return m_backend.openConnection(connectionName); },
+        "RAN_AI_OFFLINE", 0, LOCAL_MAX_CONNECTIONS, 60000);
+
+    auto local = m_pool->tryAcquire(LOCAL_ACQUIRE_TIMEOUT);
+    if (!local) {
+        qCritical() << "OfflineWriteBuffer: 无法打开本地缓冲:" << m_backend.filePath();
+        m_pool.reset();
+        return false;
+    }
+
+    QSqlQuery query(*local);
+    bool success = query.exec(QString(R"(
+        CREATE TABLE IF NOT EXISTS RAN_Offline_Writes (
+            seq INTEGER PRIMARY KEY AUTOINCREMENT,
+            statement TEXT NOT NULL,
+            params BLOB NOT NULL,
+            created_time TEXT NOT NULL DEFAULT (%1)
+        )
+    )").arg(m_backend.nowExpression()))
+        && query.exec("SELECT COUNT(*) FROM RAN_Offline_Writes")
+        && query.next();
+
+    if (success) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.pending = query.value(0).toLongLong();
+    } else {
+        qCritical() << "OfflineWriteBuffer: 初始化本地缓冲失败:" << query.lastError().text();
+    }
+
+    query = QSqlQuery();
+    m_pool->release(local);
+
+    if (!success) {
+        m_pool.reset();
+        return false;
+    }
+
+    if (pendingCount() > 0) {
+        qWarning() << "OfflineWriteBuffer: 上次离线期间有" << pendingCount() << "个写操作待重放";
+    }
+    return true;
+}
+
+/**
+ * @brief 关闭本地缓冲
+ */
+void OfflineWriteBuffer::close()
+{
+    if (m_pool) {
+        m_pool->closeAll();
+        m_pool.reset();
+    }
+}
+
+/**
+ * @brief 追加一个写操作
+ */
+bool OfflineWriteBuffer::append(const QString& sql, const QVariantList& params)
+{
+    return appendAll(sql, { params });
+}
+
+/**
+ * @brief 追加同一语句的多组参数
+ */
+bool OfflineWriteBuffer::appendAll(const QString& sql, const QVector<QVariantList>& rows)
+{
+    if (rows.isEmpty()) {
+        return true;
+    }
+
+    auto local = m_pool ? m_pool->tryAcquire(LOCAL_ACQUIRE_TIMEOUT) : nullptr;
+    if (!local) {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.appendFailures;
+        return false;
+    }
+
+    bool success = local->transaction();
+    {
+        QSqlQuery query(*local);
+        success = success && query.prepare("INSERT INTO RAN_Offline_Writes (statement, params) VALUES (?, ?)");
+
+        for (int i = 0; success && i < rows.size(); ++i) {
+            query.bindValue(0, sql);
+            query.bindValue(1, encodeParams(rows.at(i)));
+            success = query.exec();
+        }
+
+        if (!success) {
+            qCritical() << "OfflineWriteBuffer: 写入本地缓冲失败:" << query.lastError().text();
+        }
+    }
+
+    if (success) {
+        success = local->commit();
+    }
+    if (!success) {
+        local->rollback();
+    }
+
+    m_pool->release(local);
+
+    QMutexLocker locker(&m_mutex);
+    if (success) {
+        m_stats.pending += rows.size();
+        m_stats.buffered += rows.size();
+    } else {
+        ++m_stats.appendFailures;
+    }
+    return success;
+}
+
+/**
+ * @brief 按顺序重放到远端
+ */
+int OfflineWriteBuffer::replay(QSqlDatabase& remote, int maxOperations, bool* connectionLost)
+{
+    QMutexLocker replayLocker(&m_replayMutex);
+
+    if (connectionLost) {
+        *connectionLost = false;
+    }
+
+    auto local = m_pool ? m_pool->tryAcquire(LOCAL_ACQUIRE_TIMEOUT) : nullptr;
+    if (!local) {
+        return -1;
+    }
+
+    QVector<Operation> operations;
+    {
+        QSqlQuery query(*local);
+        query.setForwardOnly(true);
+        query.prepare("SELECT seq, statement, params FROM RAN_Offline_Writes ORDER BY seq LIMIT ?");
+        query.addBindValue(qMax(1, maxOperations));
+
+        if (!query.exec()) {
+            qCritical() << "OfflineWriteBuffer: 读取本地缓冲失败:" << query.lastError().text();
+            query = QSqlQuery();
+            m_pool->release(local);
+            return -1;
+        }
+
+        while (query.next()) {
+            operations.append({ query.value(0).toLongLong(),
+                                query.value(1).toString(),
+                                decodeParams(query.value(2).toByteArray()) });
+        }
+    }
+
+    int replayed = 0;
+    int discarded = 0;
+    int offset = 0;
+
+    while (offset < operations.size()) {
+        int failedIndex = -1;
+        bool lost = false;
+
+        if (executeRange(remote, operations, offset, operations.size(), &failedIndex, &lost)) {
+            removeThrough(*local, operations.last().seq);
+            replayed += operations.size() - offset;
+            break;
+        }
+
+        if (lost) {
+            if (connectionLost) {
+                *connectionLost = true;
+            }
+            break;
+        }
+
+        // 语句本身出错：先提交它之前的操作，再丢弃这一条，继续重放后面的
+        if (failedIndex > offset) {
+            int retryFailed = -1;
+            if (!executeRange(remote, operations, offset, failedIndex, &retryFailed, &lost)) {
+                if (lost && connectionLost) {
+                    *connectionLost = true;
+                }
+                break;
+            }
+            replayed += failedIndex - offset;
+        }
+
+        qWarning() << "OfflineWriteBuffer: 丢弃无法执行的缓冲操作:" << operations.at(failedIndex).sql.simplified();
+        removeThrough(*local, operations.at(failedIndex).seq);
+        ++discarded;
+        offset = failedIndex + 1;
+    }
+
+    m_pool->release(local);
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.replayed += replayed;
+    m_stats.discarded += discarded;
+
+    if (replayed > 0) {
+        qDebug() << "OfflineWriteBuffer: 已重放" << replayed << "个写操作，剩余" << m_stats.pending;
+    }
+    return replayed;
+}
+
+/**
+ * @brief 待重放操作数
+ */
+qint64 OfflineWriteBuffer::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats.pending;
+}
+
+/**
+ * @brief 获取统计
+ */
+OfflineBufferStats OfflineWriteBuffer::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+/**
+ * @brief 判断错误是否为连接中断
+ */
+bool OfflineWriteBuffer::isConnectionError(const QSqlError& error)
+{
+    if (error.type() == QSqlError::ConnectionError) {
+        return true;
+    }
+
+    // ODBC的SQLSTATE 08xxx为连接类错误（如08S01通信链路失败）
+    const QStringList states = error.nativeErrorCode().split(';', Qt::SkipEmptyParts);
+    for (const QString& state : states) {
+        if (state.trimmed().startsWith("08")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 序列化参数
+ */
+QByteArray OfflineWriteBuffer::encodeParams(const QVariantList& params)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << params;
+    return data;
+}
+
+/**
+ * @brief 反序列化参数
+ */
+QVariantList OfflineWriteBuffer::decodeParams(const QByteArray& data)
+{
+    QVariantList params;
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream >> params;
+    return params;
+}
+
+/**
+ * @brief 在一个远端事务中执行一段操作
+ */
+bool OfflineWriteBuffer::executeRange(QSqlDatabase& remote, const QVector<Operation>& operations,
+                                      int from, int to, int* failedIndex, bool* connectionLost)
+{
+    *connectionLost = false;
+
+    if (!remote.transaction()) {
+        *connectionLost = true;
+        return false;
+    }
+
+    for (int i = from; i < to; ++i) {
+        const Operation& operation = operations.at(i);
+
+        QSqlQuery query(remote);
+        bool success = query.prepare(operation.sql);
+        if (success) {
+            for (int p = 0; p < operation.params.size(); ++p) {
+                query.bindValue(p, operation.params.at(p));
+            }
+            success = query.exec();
+        }
+
+        if (!success) {
+            *failedIndex = i;
+            *connectionLost = isConnectionError(query.lastError()) || !remote.isOpen();
+            query = QSqlQuery();
+            remote.rollback();
+            return false;
+        }
+    }
+
+    // 提交失败时无法确定远端状态，按连接中断处理，下次整体重试
+    if (!remote.commit()) {
+        *connectionLost = true;
+        remote.rollback();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 删除顺序号不大于seq的本地操作
+ */
+bool OfflineWriteBuffer::removeThrough(QSqlDatabase& local, qint64 seq)
+{
+    QSqlQuery query(local);
+    query.prepare("DELETE FROM RAN_Offline_Writes WHERE seq <= ?");
+    query.addBindValue(seq);
+
+    if (!query.exec()) {
+        qCritical() << "OfflineWriteBuffer: 删除已重放操作失败:" << query.lastError().text();
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.pending = qMax<qint64>(0, m_stats.pending - query.numRowsAffected());
+    return true;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file OfflineWriteBuffer.h
+ * @brief RANOnline EP7 AI系统 - 远端数据库离线时的本地预写缓冲头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 远端不可达时写操作按顺序追加到本地SQLite（WAL模式）
+ * - 保存远端方言的SQL和序列化参数，恢复连接后原样按顺序重放
+ * - 重放按批提交，提交成功后才从本地删除
+ * - 语句本身出错的操作单独丢弃，不阻塞后续重放
+ */
+
+#pragma once
+
+#include "StorageBackend.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <memory>
+
+class ConnectionPool;
+class QSqlError;
+
+/**
+ * @struct OfflineBufferStats
+ * @brief 离线缓冲统计
+ */
+struct OfflineBufferStats
+{
+    qint64 pending = 0;             ///< 待重放操作数
+    quint64 buffered = 0;           ///< 累计缓冲的操作数
+    quint64 replayed = 0;           ///< 累计重放成功的操作数
+    quint64 discarded = 0;          ///< 重放时因语句错误丢弃的操作数
+    quint64 appendFailures = 0;     ///< 本地写入失败次数
+};
+
+/**
+ * @class OfflineWriteBuffer
+ * @brief 本地预写缓冲
+ *
+ * append()可在任意线程调用，每个线程使用自己的本地连接。replay()在持有
+ * 远端连接的线程上调用，同一时刻只有一个重放。远端事务提交后、本地删除
+ * 前进程崩溃时，该批操作会在下次重放时再执行一次，缓冲的写操作须为
+ * Upsert、按键更新等可重复执行的语句（日志插入会重复一次）。
+ */
+class OfflineWriteBuffer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 本地缓冲文件路径
+     */
+    explicit OfflineWriteBuffer(const QString& filePath);
+
+    /**
+     * @brief 析构函数
+     */
+    ~OfflineWriteBuffer();
+
+    /**
+     * @brief 打开本地缓冲（创建表并读取待重放数）
+     * @return 是否成功
+     */
+    bool open();
+
+    /**
+     * @brief 关闭本地缓冲
+     */
+    void close();
+
+    /**
+     * @brief 追加一个写操作
+     * @param sql 远端方言的SQL
+     * @param params 位置参数
+     * @return 是否成功写入本地
+     */
+    bool append(const QString& sql, const QVariantList& params);
+
+    /**
+     * @brief 在一个本地事务中追加同一语句的多组参数
+     * @param sql 远端方言的SQL
+     * @param rows 每组参数
+     * @return 是否成功写入本地
+     */
+    bool appendAll(const QString& sql, const QVector<QVariantList>& rows);
+
+    /**
+     * @brief 按顺序重放到远端
+     * @param remote 远端连接
+     * @param maxOperations 本次最多重放的操作数
+     * @param connectionLost 输出重放是否因连接中断而停止（可为空）
+     * @return 重放成功的操作数，本地缓冲不可用时返回-1
+     */
+    int replay(QSqlDatabase& remote, int maxOperations, bool* connectionLost = nullptr);
+
+    /**
+     * @brief 待重放操作数
+     */
+    qint64 pendingCount() const;
+
+    /**
+     * @brief 获取统计
+     * @return 统计快照
+     */
+    OfflineBufferStats stats() const;
+
+    /**
+     * @brief 判断错误是否为连接中断（而非语句本身的错误）
+     * @param error 错误
+     * @return 是否为连接错误
+     */
+    static bool isConnectionError(const QSqlError& error);
+
+    /**
+     * @brief 序列化参数
+     */
+    static QByteArray encodeParams(const QVariantList& params);
+
+    /**
+     * @brief 反序列化参数
+     */
+    static QVariantList decodeParams(const QByteArray& data);
+
+private:
+    /**
+     * @struct Operation
+     * @brief 一个缓冲的写操作
+     */
+    struct Operation {
+        qint64 seq = 0;                 ///< 顺序号
+        QString sql;                    ///< SQL
+        QVariantList params;            ///< 参数
+    };
+
+    /**
+     * @brief 在一个远端事务中执行[from, to)范围的操作
+     * @param failedIndex 输出失败操作的下标
+     * @param connectionLost 输出是否为连接中断
+     * @return 是否全部成功并提交
+     */
+    bool executeRange(QSqlDatabase& remote, const QVector<Operation>& operations, int from, int to,
+                      int* failedIndex, bool* connectionLost);
+
+    /**
+     * @brief 删除顺序号不大于seq的本地操作
+     */
+    bool removeThrough(QSqlDatabase& local, qint64 seq);
+
+private:
+    SqliteBackend m_backend;            ///< 本地SQLite
+    std::unique_ptr<ConnectionPool> m_pool; ///< 本地连接（每线程一个）
+
+    mutable QMutex m_mutex;             ///< 统计互斥锁
+    QMutex m_replayMutex;               ///< 重放互斥锁
+    OfflineBufferStats m_stats;         ///< 统计
+
+    static constexpr int LOCAL_ACQUIRE_TIMEOUT = 5000;  ///< 获取本地连接的最长等待（毫秒）
+    static constexpr int LOCAL_MAX_CONNECTIONS = 8;     ///< 本地连接上限
+};
@@ -0,0 +1,147 @@
+/**
+ * @file PreparedStatementCache.cpp
+ * @brief RANOnline EP7 AI系统 - 预编译语句缓存实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "PreparedStatementCache.h"
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/**
+ * @brief 获取统计快照
+ */
+StatementCacheStats StatementCacheCounters::snapshot() const
+{
+    StatementCacheStats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.evictions = evictions.load(std::memory_order_relaxed);
+    stats.prepareFailures = prepareFailures.load(std::memory_order_relaxed);
+    stats.prepareTimeNs = prepareTimeNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief 构造函数
+ */
+PreparedStatementCache::PreparedStatementCache(const QSqlDatabase& db, int capacity,
+                                               StatementCacheCounters* counters)
+    : m_db(db)
+    , m_capacity(qMax(1, capacity))
+    , m_counters(counters)
+    , m_useClock(0)
+{
+    m_statements.reserve(m_capacity);
+}
+
+/**
+ * @brief 析构函数
+ */
+PreparedStatementCache::~PreparedStatementCache()
+{
+    clear();
+}
+
+/**
+ * @brief 获取已prepare的语句
+ */
+QSqlQuery* PreparedStatementCache::acquire(const QString& sql)
+{
+    auto it = m_statements.find(sql);
+    if (it != m_statements.end()) {
+        it->lastUsed = ++m_useClock;
+        ++m_stats.hits;
+        if (m_counters) {
+            m_counters->hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        return it->query.get();
+    }
+
+    if (m_statements.size() >= m_capacity) {
+        evictLeastRecentlyUsed();
+    }
+
+    auto query = std::make_shared<QSqlQuery>(m_db);
+    query->setForwardOnly(true);
+
+    QElapsedTimer timer;
+    timer.start();
+    bool prepared = query->prepare(sql);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    ++m_stats.misses;
+    m_stats.prepareTimeNs += elapsed;
+    if (m_counters) {
+        m_counters->misses.fetch_add(1, std::memory_order_relaxed);
+        m_counters->prepareTimeNs.fetch_add(elapsed, std::memory_order_relaxed);
+    }
+
+    if (!prepared) {
+        m_lastError = query->lastError().text();
+        ++m_stats.prepareFailures;
+        if (m_counters) {
+            m_counters->prepareFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+        qWarning() << "PreparedStatementCache: 语句预编译失败:" << m_lastError;
+        return nullptr;
+    }
+
+    Slot slot;
+    slot.query = query;
+    slot.lastUsed = ++m_useClock;
+    m_statements.insert(sql, slot);
+    return query.get();
+}
+
+/**
+ * @brief 释放语句的结果集
+ */
+void PreparedStatementCache::release(QSqlQuery* query)
+{
+    if (query) {
+        // finish()关闭游标但保留预编译句柄，下次只需重新绑定参数
+        query->finish();
+    }
+}
+
+/**
+ * @brief 丢弃指定SQL的缓存语句
+ */
+void PreparedStatementCache::invalidate(const QString& sql)
+{
+    m_statements.remove(sql);
+}
+
+/**
+ * @brief 清空缓存
+ */
+void PreparedStatementCache::clear()
+{
+    m_statements.clear();
+}
+
+/**
+ * @brief 淘汰最近最少使用的语句
+ */
+void PreparedStatementCache::evictLeastRecentlyUsed()
+{
+    auto victim = m_statements.end();
+    for (auto it = m_statements.begin(); it != m_statements.end(); ++it) {
+        if (victim == m_statements.end() || it->lastUsed < victim->lastUsed) {
+            victim = it;
+        }
+    }
+
+    if (victim != m_statements.end()) {
+        m_statements.erase(victim);
+        ++m_stats.evictions;
+        if (m_counters) {
+            m_counters->evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/**
+ * @file PreparedStatementCache.h
+ * @brief RANOnline EP7 AI系统 - 预编译语句缓存头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 每个池连接一份缓存，按SQL文本复用已prepare的QSqlQuery
+ * - 命中时只重新绑定参数，不再向服务器重复prepare
+ * - 容量上限+最近最少使用淘汰
+ * - 命中率、淘汰次数、prepare耗时统计
+ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtSql/QSqlDatabase>
+#include <atomic>
+#include <memory>
+
+class QSqlQuery;
+
+/**
+ * @struct StatementCacheStats
+ * @brief 预编译语句缓存统计快照
+ */
+struct StatementCacheStats
+{
+    quint64 hits = 0;               ///< 命中次数
+    quint64 misses = 0;             ///< 未命中次数（需要prepare）
+    quint64 evictions = 0;          ///< 淘汰次数
+    quint64 prepareFailures = 0;    ///< prepare失败次数
+    qint64 prepareTimeNs = 0;       ///< prepare累计耗时（纳秒）
+
+    /**
+     * @brief 命中率
+     * @return 0.0 - 1.0
+     */
+    double hitRate() const
+    {
+        quint64 total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    /**
+     * @brief 平均prepare耗时
+     * @return 毫秒
+     */
+    double averagePrepareMs() const
+    {
+        return misses > 0 ? prepareTimeNs / 1.0e6 / misses : 0.0;
+    }
+};
+
+/**
+ * @struct StatementCacheCounters
+ * @brief 多个连接缓存共享的汇总计数器（无锁读取）
+ */
+struct StatementCacheCounters
+{
+    std::atomic<quint64> hits{0};
+    std::atomic<quint64> misses{0};
+    std::atomic<quint64> evictions{0};
+    std::atomic<quint64> prepareFailures{0};
+    std::atomic<qint64> prepareTimeNs{0};
+
+    /**
+     * @brief 获取统计快照
+     * @return 统计
+     */
+    StatementCacheStats snapshot() const;
+};
+
+/**
+ * @class PreparedStatementCache
+ * @brief 单个数据库连接的预编译语句缓存
+ *
+ * 缓存与连接一一对应，只能由当前持有该连接的线程使用，本身不加锁。
+ * acquire()返回的语句在使用完毕后须调用release()释放结果集；
+ * 执行失败的语句应调用invalidate()丢弃，下次重新prepare。
+ */
+class PreparedStatementCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param db 所属连接
+     * @param capacity 最大缓存语句数
+     * @param counters 汇总计数器（可为空）
+     */
+    PreparedStatementCache(const QSqlDatabase& db, int capacity,
+                           StatementCacheCounters* counters = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~PreparedStatementCache();
+
+    PreparedStatementCache(const PreparedStatementCache&) = delete;
+    PreparedStatementCache& operator=(const PreparedStatementCache&) = delete;
+
+    /**
+     * @brief 获取已prepare的语句，未命中时prepare并缓存
+     * @param sql SQL文本
+     * @return 语句指针，prepare失败返回nullptr
+     */
+    QSqlQuery* acquire(const QString& sql);
+
+    /**
+     * @brief 释放语句的结果集，保留预编译状态
+     * @param query acquire()返回的语句
+     */
+    void release(QSqlQuery* query);
+
+    /**
+     * @brief 丢弃指定SQL的缓存语句
+     * @param sql SQL文本
+     */
+    void invalidate(const QString& sql);
+
+    /**
+     * @brief 清空缓存（须在连接关闭前调用）
+     */
+    void clear();
+
+    /**
+     * @brief 获取缓存语句数
+     * @return 数量
+     */
+    int size() const { return m_statements.size(); }
+
+    /**
+     * @brief 获取本连接的统计
+     * @return 统计
+     */
+    StatementCacheStats stats() const { return m_stats; }
+
+    /**
+     * @brief 获取上次prepare错误
+     * @return 错误信息
+     */
+    QString lastError() const { return m_lastError; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief 缓存槽
+     */
+    struct Slot {
+        std::shared_ptr<QSqlQuery> query;   ///< 已prepare的语句
+        quint64 lastUsed = 0;               ///< 最近使用序号
+    };
+
+    /**
+     * @brief 淘汰最近最少使用的语句
+     */
+    void evictLeastRecentlyUsed();
+
+private:
+    QSqlDatabase m_db;                      ///< 所属连接
+    int m_capacity;                         ///< 容量
+    StatementCacheCounters* m_counters;     ///< 汇总计数器
+    QHash<QString, Slot> m_statements;      ///< SQL文本 -> 语句
+    quint64 m_useClock;                     ///< 使用序号
+    StatementCacheStats m_stats;            ///< 本连接统计
+    QString m_lastError;                    ///< 上次错误
+};
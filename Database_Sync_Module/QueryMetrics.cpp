@@ -0,0 +1,364 @@
+/**
+ * @file QueryMetrics.cpp
+ * @brief RANOnline EP7 AI系统 - 查询延迟直方图与慢查询记录实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "QueryMetrics.h"
+#include <QtCore/QStringList>
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+/**
+ * @brief 原子地把最大值更新为value
+ */
+void updateMax(std::atomic<quint64>& target, quint64 value)
+{
+    quint64 current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 记录一个样本
+ */
+void LatencyHistogram::record(quint64 micros)
+{
+    m_buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumMicros.fetch_add(micros, std::memory_order_relaxed);
+    updateMax(m_maxMicros, micros);
+}
+
+/**
+ * @brief 计算分布摘要
+ */
+LatencySummary LatencyHistogram::summary() const
+{
+    LatencySummary summary;
+
+    // 先复制各桶，以复制结果的合计为准，避免与并发记录不一致
+    std::array<quint64, BUCKETS> buckets;
+    quint64 count = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+    if (count == 0) {
+        return summary;
+    }
+
+    const quint64 maxMicros = m_maxMicros.load(std::memory_order_relaxed);
+    const double percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+    double* outputs[] = { &summary.p50Ms, &summary.p95Ms, &summary.p99Ms, &summary.p999Ms };
+
+    int next = 0;
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKETS && next < 4; ++i) {
+        seen += buckets[i];
+        while (next < 4 && seen >= qMax<quint64>(1, static_cast<quint64>(count * percentiles[next] / 100.0 + 0.5))) {
+            *outputs[next] = std::min(bucketUpperBound(i), maxMicros) / 1000.0;
+            ++next;
+        }
+    }
+
+    summary.count = count;
+    summary.totalMs = m_sumMicros.load(std::memory_order_relaxed) / 1000.0;
+    summary.meanMs = summary.totalMs / count;
+    summary.maxMs = maxMicros / 1000.0;
+    return summary;
+}
+
+/**
+ * @brief 清零
+ */
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumMicros.store(0, std::memory_order_relaxed);
+    m_maxMicros.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 值所在的桶
+ */
+int LatencyHistogram::bucketIndex(quint64 micros)
+{
+    if (micros < SUB_BUCKETS) {
+        return static_cast<int>(micros);
+    }
+
+    // 最高位决定区间，其后SUB_BUCKET_BITS位决定区间内的细分
+    const int exponent = qMin(static_cast<int>(std::bit_width(micros)) - 1, MAX_EXPONENT - 1);
+    if (exponent == MAX_EXPONENT - 1 && micros >= (quint64(1) << MAX_EXPONENT)) {
+        return BUCKETS - 1;
+    }
+
+    const int shift = exponent - SUB_BUCKET_BITS;
+    const int sub = static_cast<int>((micros >> shift) & (SUB_BUCKETS - 1));
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief 桶覆盖的最大值
+ */
+quint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SUB_BUCKETS) {
+        return static_cast<quint64>(index);
+    }
+
+    const int shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    const quint64 lower = static_cast<quint64>(SUB_BUCKETS + sub) << shift;
+    return lower + (quint64(1) << shift) - 1;
+}
+
+/**
+ * @brief 构造函数
+ */
+QueryMetrics::QueryMetrics(int slowThresholdMs, int slowLogCapacity)
+    : m_slowThresholdNs(static_cast<qint64>(qMax(0, slowThresholdMs)) * 1000000)
+    , m_slowLogCapacity(qMax(1, slowLogCapacity))
+    , m_slowNext(0)
+    , m_slowCount(0)
+{
+    m_overflow.sql = "<other>";
+    m_slowLog.reserve(m_slowLogCapacity);
+}
+
+/**
+ * @brief 记录一次查询
+ */
+void QueryMetrics::record(const QString& sql, qint64 elapsedNs, bool success,
+                          qint64 rows, qint64 bytes, const QVariantList& params)
+{
+    const quint64 micros = static_cast<quint64>(qMax<qint64>(0, elapsedNs)) / 1000;
+
+    StatementEntry* entry = entryFor(sql);
+    entry->latency.record(micros);
+    entry->rows.fetch_add(static_cast<quint64>(qMax<qint64>(0, rows)), std::memory_order_relaxed);
+    entry->bytes.fetch_add(static_cast<quint64>(qMax<qint64>(0, bytes)), std::memory_order_relaxed);
+    m_overall.record(micros);
+
+    if (!success) {
+        entry->errors.fetch_add(1, std::memory_order_relaxed);
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (elapsedNs < m_slowThresholdNs) {
+        return;
+    }
+
+    // 慢查询很少，形状和文本只在这里生成
+    SlowQueryRecord slow;
+    slow.timestamp = QDateTime::currentDateTime();
+    slow.sql = entry->sql;
+    slow.parameterShape = parameterShape(params);
+    slow.elapsedMs = elapsedNs / 1e6;
+    slow.rows = rows;
+    slow.success = success;
+
+    QMutexLocker locker(&m_slowMutex);
+    if (m_slowLog.size() < m_slowLogCapacity) {
+        m_slowLog.append(slow);
+    } else {
+        m_slowLog[m_slowNext] = slow;
+    }
+    m_slowNext = (m_slowNext + 1) % m_slowLogCapacity;
+    ++m_slowCount;
+}
+
+/**
+ * @brief 记录一次获取连接的等待
+ */
+void QueryMetrics::recordPoolWait(qint64 waitNs)
+{
+    m_poolWait.record(static_cast<quint64>(qMax<qint64>(0, waitNs)) / 1000);
+}
+
+/**
+ * @brief 获取统计快照
+ */
+QueryMetricsSnapshot QueryMetrics::snapshot(int maxStatements) const
+{
+    QueryMetricsSnapshot snapshot;
+    snapshot.overall = m_overall.summary();
+    snapshot.errors = m_errors.load(std::memory_order_relaxed);
+    snapshot.poolWait = m_poolWait.summary();
+
+    auto collect = [&snapshot](const StatementEntry& entry) {
+        StatementMetrics metrics;
+        metrics.latency = entry.latency.summary();
+        if (metrics.latency.count == 0) {
+            return;
+        }
+        metrics.sql = entry.sql;
+        metrics.errors = entry.errors.load(std::memory_order_relaxed);
+        metrics.rows = entry.rows.load(std::memory_order_relaxed);
+        metrics.bytes = entry.bytes.load(std::memory_order_relaxed);
+        snapshot.statements.append(metrics);
+    };
+
+    {
+        QReadLocker locker(&m_entriesLock);
+        for (const auto& entry : m_storage) {
+            collect(*entry);
+        }
+    }
+    collect(m_overflow);
+
+    std::sort(snapshot.statements.begin(), snapshot.statements.end(),
+              [](const StatementMetrics& a, const StatementMetrics& b) {
+                  return a.latency.totalMs > b.latency.totalMs;
+              });
+    if (snapshot.statements.size() > maxStatements) {
+        snapshot.statements.resize(qMax(0, maxStatements));
+    }
+
+    QMutexLocker locker(&m_slowMutex);
+    snapshot.slowQueries = m_slowCount;
+    snapshot.slowLog.reserve(m_slowLog.size());
+    for (int i = 1; i <= m_slowLog.size(); ++i) {
+        int index = (m_slowNext - i + m_slowLogCapacity) % m_slowLogCapacity;
+        if (index < m_slowLog.size()) {
+            snapshot.slowLog.append(m_slowLog.at(index));
+        }
+    }
+    return snapshot;
+}
+
+/**
+ * @brief 清零全部统计
+ */
+void QueryMetrics::reset()
+{
+    {
+        QReadLocker locker(&m_entriesLock);
+        for (const auto& entry : m_storage) {
+            entry->latency.reset();
+            entry->errors.store(0, std::memory_order_relaxed);
+            entry->rows.store(0, std::memory_order_relaxed);
+            entry->bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_overflow.latency.reset();
+    m_overflow.errors.store(0, std::memory_order_relaxed);
+    m_overflow.rows.store(0, std::memory_order_relaxed);
+    m_overflow.bytes.store(0, std::memory_order_relaxed);
+
+    m_overall.reset();
+    m_errors.store(0, std::memory_order_relaxed);
+    m_poolWait.reset();
+
+    QMutexLocker locker(&m_slowMutex);
+    m_slowLog.clear();
+    m_slowNext = 0;
+    m_slowCount = 0;
+}
+
+/**
+ * @brief 生成参数形状
+ */
+QString QueryMetrics::parameterShape(const QVariantList& params)
+{
+    QStringList shape;
+    shape.reserve(params.size());
+
+    for (const QVariant& param : params) {
+        if (param.isNull()) {
+            shape << "NULL";
+        } else if (param.typeId() == QMetaType::QString) {
+            shape << QString("QString(%1)").arg(param.toString().size());
+        } else if (param.typeId() == QMetaType::QByteArray) {
+            shape << QString("QByteArray(%1)").arg(param.toByteArray().size());
+        } else {
+            shape << QString::fromLatin1(param.typeName());
+        }
+    }
+    return shape.join(", ");
+}
+
+/**
+ * @brief 估算参数字节数
+ */
+qint64 QueryMetrics::parameterBytes(const QVariantList& params)
+{
+    qint64 bytes = 0;
+    for (const QVariant& param : params) {
+        switch (param.typeId()) {
+        case QMetaType::QString:
+            bytes += param.toString().size() * 2;   // NVARCHAR按UTF-16传输
+            break;
+        case QMetaType::QByteArray:
+            bytes += param.toByteArray().size();
+            break;
+        case QMetaType::Bool:
+            bytes += 1;
+            break;
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Float:
+            bytes += 4;
+            break;
+        default:
+            bytes += 8;
+            break;
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief 查找或创建语句条目
+ */
+QueryMetrics::StatementEntry* QueryMetrics::entryFor(const QString& sql)
+{
+    {
+        QReadLocker locker(&m_entriesLock);
+        auto it = m_entries.constFind(sql);
+        if (it != m_entries.constEnd()) {
+            return it.value();
+        }
+        if (m_entries.size() >= MAX_STATEMENTS) {
+            return &m_overflow;
+        }
+    }
+
+    QWriteLocker locker(&m_entriesLock);
+    auto it = m_entries.constFind(sql);
+    if (it != m_entries.constEnd()) {
+        return it.value();
+    }
+    if (m_entries.size() >= MAX_STATEMENTS) {
+        return &m_overflow;
+    }
+
+    auto entry = std::make_unique<StatementEntry>();
+    entry->sql = displaySql(sql);
+    StatementEntry* raw = entry.get();
+    m_storage.push_back(std::move(entry));
+    m_entries.insert(sql, raw);
+    return raw;
+}
+
+/**
+ * @brief 压缩空白并截断语句
+ */
+QString QueryMetrics::displaySql(const QString& sql)
+{
+    QString display = sql.simplified();
+    if (display.size() > MAX_DISPLAY_SQL) {
+        display = display.left(MAX_DISPLAY_SQL - 3) + "...";
+    }
+    return display;
+}
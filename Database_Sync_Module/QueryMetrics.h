@@ -0,0 +1,250 @@
+/**
+ * @file QueryMetrics.h
+ * @brief RANOnline EP7 AI系统 - 查询延迟直方图与慢查询记录头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 按语句统计的对数-线性延迟直方图（HDR风格，相对误差不超过6.25%）
+ * - p50/p95/p99/p99.9/最大值，不再只有平均值
+ * - 每条语句的执行次数、失败次数、行数、参数字节数
+ * - 固定容量的慢查询环形记录，只保存参数形状不保存参数值
+ * - 记录路径无锁（查找已有语句只取读锁），适合在每次查询上调用
+ */
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct LatencySummary
+ * @brief 延迟分布摘要
+ */
+struct LatencySummary
+{
+    quint64 count = 0;                  ///< 样本数
+    double totalMs = 0.0;               ///< 总耗时（毫秒）
+    double meanMs = 0.0;                ///< 平均值（毫秒）
+    double p50Ms = 0.0;                 ///< 中位数（毫秒）
+    double p95Ms = 0.0;                 ///< 95分位（毫秒）
+    double p99Ms = 0.0;                 ///< 99分位（毫秒）
+    double p999Ms = 0.0;                ///< 99.9分位（毫秒）
+    double maxMs = 0.0;                 ///< 最大值（毫秒）
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief 对数-线性延迟直方图（微秒）
+ *
+ * 小于16微秒的值每微秒一个桶，之后每个2的幂区间等分为16个桶，覆盖到
+ * 2^36微秒（约19小时）。所有计数为原子变量，record()可并发调用。
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;                       ///< 每个2的幂区间的细分位数
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;        ///< 每个2的幂区间的桶数
+    static constexpr int MAX_EXPONENT = 36;                         ///< 最大可记录值的位数
+    static constexpr int BUCKETS = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKETS; ///< 桶数
+
+    /**
+     * @brief 记录一个样本
+     * @param micros 延迟（微秒）
+     */
+    void record(quint64 micros);
+
+    /**
+     * @brief 计算分布摘要
+     * @return 摘要（百分位取所在桶的上界，不超过最大值）
+     */
+    LatencySummary summary() const;
+
+    /**
+     * @brief 清零
+     */
+    void reset();
+
+    /**
+     * @brief 值所在的桶
+     * @param micros 延迟（微秒）
+     * @return 桶下标
+     */
+    static int bucketIndex(quint64 micros);
+
+    /**
+     * @brief 桶覆盖的最大值
+     * @param index 桶下标
+     * @return 上界（微秒，含）
+     */
+    static quint64 bucketUpperBound(int index);
+
+private:
+    std::array<std::atomic<quint64>, BUCKETS> m_buckets{};  ///< 各桶计数
+    std::atomic<quint64> m_count{0};                        ///< 样本数
+    std::atomic<quint64> m_sumMicros{0};                    ///< 总耗时
+    std::atomic<quint64> m_maxMicros{0};                    ///< 最大值
+};
+
+/**
+ * @struct StatementMetrics
+ * @brief 单条语句的统计
+ */
+struct StatementMetrics
+{
+    QString sql;                        ///< 语句（压缩空白后截断）
+    quint64 errors = 0;                 ///< 失败次数
+    quint64 rows = 0;                   ///< 读取或影响的行数
+    quint64 bytes = 0;                  ///< 绑定参数字节数
+    LatencySummary latency;             ///< 延迟分布
+};
+
+/**
+ * @struct SlowQueryRecord
+ * @brief 一条慢查询记录
+ */
+struct SlowQueryRecord
+{
+    QDateTime timestamp;                ///< 完成时间
+    QString sql;                        ///< 语句（压缩空白后截断）
+    QString parameterShape;             ///< 参数形状，如"QString(12), int, NULL"
+    double elapsedMs = 0.0;             ///< 耗时（毫秒）
+    qint64 rows = 0;                    ///< 行数
+    bool success = true;                ///< 是否成功
+};
+
+/**
+ * @struct QueryMetricsSnapshot
+ * @brief 查询统计快照
+ */
+struct QueryMetricsSnapshot
+{
+    LatencySummary overall;             ///< 全部语句的延迟分布
+    quint64 errors = 0;                 ///< 全部失败次数
+    LatencySummary poolWait;            ///< 获取连接的等待时间分布
+    QVector<StatementMetrics> statements;   ///< 各语句统计（按总耗时降序）
+    quint64 slowQueries = 0;            ///< 累计慢查询数
+    QVector<SlowQueryRecord> slowLog;   ///< 最近的慢查询（新的在前）
+};
+
+/**
+ * @class QueryMetrics
+ * @brief 按语句的查询统计
+ *
+ * 以SQL文本为键，参数化语句天然归为一类。不同语句数超过上限后其余的
+ * 计入"<other>"，避免动态拼接的SQL撑大统计表。条目创建后不再删除，
+ * reset()只清零，记录路径拿到的指针始终有效。
+ */
+class QueryMetrics
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param slowThresholdMs 慢查询阈值（毫秒）
+     * @param slowLogCapacity 慢查询记录容量
+     */
+    QueryMetrics(int slowThresholdMs, int slowLogCapacity);
+
+    /**
+     * @brief 记录一次查询
+     * @param sql 语句
+     * @param elapsedNs 耗时（纳秒）
+     * @param success 是否成功
+     * @param rows 读取或影响的行数
+     * @param bytes 绑定参数字节数
+     * @param params 绑定参数（仅慢查询时用于生成形状）
+     */
+    void record(const QString& sql, qint64 elapsedNs, bool success,
+                qint64 rows = 0, qint64 bytes = 0, const QVariantList& params = QVariantList());
+
+    /**
+     * @brief 记录一次获取连接的等待
+     * @param waitNs 等待时间（纳秒）
+     */
+    void recordPoolWait(qint64 waitNs);
+
+    /**
+     * @brief 获取统计快照
+     * @param maxStatements 最多返回的语句数
+     * @return 快照
+     */
+    QueryMetricsSnapshot snapshot(int maxStatements = 50) const;
+
+    /**
+     * @brief 清零全部统计
+     */
+    void reset();
+
+    /**
+     * @brief 慢查询阈值（毫秒）
+     */
+    int slowThresholdMs() const { return static_cast<int>(m_slowThresholdNs / 1000000); }
+
+    /**
+     * @brief 生成参数形状（类型和长度，不含值）
+     * @param params 参数
+     * @return 形状文本
+     */
+    static QString parameterShape(const QVariantList& params);
+
+    /**
+     * @brief 估算参数字节数
+     * @param params 参数
+     * @return 字节数
+     */
+    static qint64 parameterBytes(const QVariantList& params);
+
+private:
+    /**
+     * @struct StatementEntry
+     * @brief 单条语句的计数
+     */
+    struct StatementEntry {
+        QString sql;                            ///< 展示用语句
+        LatencyHistogram latency;               ///< 延迟直方图
+        std::atomic<quint64> errors{0};         ///< 失败次数
+        std::atomic<quint64> rows{0};           ///< 行数
+        std::atomic<quint64> bytes{0};          ///< 参数字节数
+    };
+
+    /**
+     * @brief 查找或创建语句条目
+     */
+    StatementEntry* entryFor(const QString& sql);
+
+    /**
+     * @brief 压缩空白并截断语句
+     */
+    static QString displaySql(const QString& sql);
+
+private:
+    qint64 m_slowThresholdNs;                   ///< 慢查询阈值（纳秒）
+    int m_slowLogCapacity;                      ///< 慢查询记录容量
+
+    mutable QReadWriteLock m_entriesLock;       ///< 语句表读写锁
+    QHash<QString, StatementEntry*> m_entries;  ///< 语句表
+    std::vector<std::unique_ptr<StatementEntry>> m_storage; ///< 条目存储
+    StatementEntry m_overflow;                  ///< 超过上限的语句
+
+    LatencyHistogram m_overall;                 ///< 全部语句
+    std::atomic<quint64> m_errors{0};           ///< 全部失败次数
+    LatencyHistogram m_poolWait;                ///< 连接等待
+
+    mutable QMutex m_slowMutex;                 ///< 慢查询记录互斥锁
+    QVector<SlowQueryRecord> m_slowLog;         ///< 慢查询环形记录
+    int m_slowNext;                             ///< 下一个写入位置
+    quint64 m_slowCount;                        ///< 累计慢查询数
+
+    static constexpr int MAX_STATEMENTS = 512;          ///< 单独统计的语句数上限
+    static constexpr int MAX_DISPLAY_SQL = 200;         ///< 展示用语句最大长度
+};
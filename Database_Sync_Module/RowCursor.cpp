@@ -0,0 +1,105 @@
+/**
+ * @file RowCursor.cpp
+ * @brief RANOnline EP7 AI系统 - 查询结果行游标实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "RowCursor.h"
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+
+/**
+ * @brief 构造函数
+ */
+RowCursor::RowCursor(QSqlQuery& query)
+    : m_query(query)
+{
+}
+
+/**
+ * @brief 绑定列并解析序号
+ */
+bool RowCursor::bind(const QVector<ColumnSpec>& columns)
+{
+    m_columns = columns;
+    m_ordinals.clear();
+    m_ordinals.reserve(columns.size());
+
+    QSqlRecord record = m_query.record();
+    bool complete = true;
+
+    for (const ColumnSpec& column : columns) {
+        int ordinal = record.indexOf(column.name);
+        if (ordinal < 0) {
+            qWarning() << "RowCursor: 结果集中不存在列:" << column.name;
+            complete = false;
+        }
+        m_ordinals << ordinal;
+    }
+    return complete;
+}
+
+/**
+ * @brief 移动到下一行
+ */
+bool RowCursor::next()
+{
+    return m_query.next();
+}
+
+/**
+ * @brief 判断当前行某列是否为NULL
+ */
+bool RowCursor::isNull(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal < 0 || m_query.isNull(ordinal);
+}
+
+/**
+ * @brief 读取整数列
+ */
+qint64 RowCursor::intAt(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal < 0 ? 0 : m_query.value(ordinal).toLongLong();
+}
+
+/**
+ * @brief 读取浮点列
+ */
+double RowCursor::doubleAt(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal < 0 ? 0.0 : m_query.value(ordinal).toDouble();
+}
+
+/**
+ * @brief 读取布尔列
+ */
+bool RowCursor::boolAt(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal >= 0 && m_query.value(ordinal).toBool();
+}
+
+/**
+ * @brief 读取字符串列
+ */
+QString RowCursor::stringAt(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal < 0 ? QString() : m_query.value(ordinal).toString();
+}
+
+/**
+ * @brief 读取日期时间列
+ */
+QDateTime RowCursor::dateTimeAt(int column) const
+{
+    int ordinal = m_ordinals.value(column, -1);
+    return ordinal < 0 ? QDateTime() : m_query.value(ordinal).toDateTime();
+}
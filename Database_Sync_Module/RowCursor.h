@@ -0,0 +1,106 @@
+/**
+ * @file RowCursor.h
+ * @brief RANOnline EP7 AI系统 - 查询结果行游标头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 列名只在绑定时解析一次，之后按列序号读取
+ * - 逐行流式读取，大表扫描不缓存整个结果
+ */
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class QSqlQuery;
+
+/**
+ * @struct ColumnSpec
+ * @brief 列描述
+ */
+struct ColumnSpec {
+    QString name;       ///< 列名
+};
+
+/**
+ * @class RowCursor
+ * @brief 查询结果行游标
+ *
+ * 包装已执行的QSqlQuery（建议setForwardOnly(true)），bind()时把列名解析为
+ * 记录中的序号，之后所有读取都以bind()传入的列顺序为下标，不再按名字查找。
+ * QtSql驱动只以QVariant交付单元格，每个单元格读取一次；整数和布尔存放在
+ * QVariant内部，字符串只增加引用计数，不产生额外拷贝。
+ */
+class RowCursor
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param query 已执行的查询（生命周期须长于游标）
+     */
+    explicit RowCursor(QSqlQuery& query);
+
+    /**
+     * @brief 绑定列并解析序号
+     * @param columns 需要读取的列
+     * @return 全部列都存在时返回true
+     */
+    bool bind(const QVector<ColumnSpec>& columns);
+
+    /**
+     * @brief 获取绑定的列
+     * @return 列描述
+     */
+    const QVector<ColumnSpec>& columns() const { return m_columns; }
+
+    /**
+     * @brief 移动到下一行
+     * @return 是否还有数据
+     */
+    bool next();
+
+    /**
+     * @brief 判断当前行某列是否为NULL
+     * @param column 绑定列下标
+     */
+    bool isNull(int column) const;
+
+    /**
+     * @brief 读取整数列
+     * @param column 绑定列下标
+     */
+    qint64 intAt(int column) const;
+
+    /**
+     * @brief 读取浮点列
+     * @param column 绑定列下标
+     */
+    double doubleAt(int column) const;
+
+    /**
+     * @brief 读取布尔列
+     * @param column 绑定列下标
+     */
+    bool boolAt(int column) const;
+
+    /**
+     * @brief 读取字符串列
+     * @param column 绑定列下标
+     */
+    QString stringAt(int column) const;
+
+    /**
+     * @brief 读取日期时间列
+     * @param column 绑定列下标
+     */
+    QDateTime dateTimeAt(int column) const;
+
+private:
+    QSqlQuery& m_query;                 ///< 底层查询
+    QVector<ColumnSpec> m_columns;      ///< 绑定的列
+    QVector<int> m_ordinals;            ///< 绑定列 -> 记录序号
+};
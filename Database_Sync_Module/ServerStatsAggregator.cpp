@@ -0,0 +1,279 @@
+/**
+ * @file ServerStatsAggregator.cpp
+ * @brief RANOnline EP7 AI系统 - 按服务器增量维护的AI统计实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "ServerStatsAggregator.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/**
+ * @brief 构造函数
+ */
+ServerStatsAggregator::ServerStatsAggregator()
+    : m_ready(false)
+    , m_invalidated(false)
+    , m_reconciling(false)
+{
+}
+
+/**
+ * @brief 写入或更新AI的服务器和等级
+ */
+void ServerStatsAggregator::upsertPlayer(const QString& aiId, int serverId, int level)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_players.find(aiId);
+    if (it == m_players.end()) {
+        it = m_players.insert(aiId, PlayerEntry());
+    } else {
+        apply(it.value(), -1);
+    }
+
+    it->serverId = serverId;
+    it->level = level;
+    apply(it.value(), 1);
+
+    touch(aiId);
+    ++m_stats.updates;
+}
+
+/**
+ * @brief 更新AI状态
+ */
+void ServerStatsAggregator::setStatus(const QString& aiId, int status)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 未跟踪的AI不知道所属服务器，留给对账补上
+    auto it = m_players.find(aiId);
+    if (it == m_players.end()) {
+        m_invalidated = true;
+        return;
+    }
+
+    apply(it.value(), -1);
+    it->online = (status == 1);
+    apply(it.value(), 1);
+
+    touch(aiId);
+    ++m_stats.updates;
+}
+
+/**
+ * @brief 删除AI
+ */
+void ServerStatsAggregator::removePlayer(const QString& aiId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_players.find(aiId);
+    if (it != m_players.end()) {
+        apply(it.value(), -1);
+        m_players.erase(it);
+    }
+
+    touch(aiId);
+    ++m_stats.updates;
+}
+
+/**
+ * @brief 标记需要尽快对账
+ */
+void ServerStatsAggregator::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_invalidated = true;
+}
+
+/**
+ * @brief 是否已完成过对账
+ */
+bool ServerStatsAggregator::isReady() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ready;
+}
+
+/**
+ * @brief 是否需要对账
+ */
+bool ServerStatsAggregator::reconcileDue(int intervalMs) const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_ready || m_invalidated
+        || QDateTime::currentMSecsSinceEpoch() - m_stats.lastReconcileMs >= intervalMs;
+}
+
+/**
+ * @brief 开始对账
+ */
+void ServerStatsAggregator::beginReconcile()
+{
+    QMutexLocker locker(&m_mutex);
+    m_reconciling = true;
+    m_invalidated = false;
+    m_touched.clear();
+}
+
+/**
+ * @brief 扫描数据库完成对账
+ */
+bool ServerStatsAggregator::finishReconcile(QSqlDatabase& db)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 扫描在锁外进行，期间的增量更新记录在m_touched中
+    QHash<QString, PlayerEntry> scanned;
+    {
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+
+        if (!query.exec("SELECT ai_id, server_id, level, status FROM RAN_AI_Players")) {
+            qCritical() << "ServerStatsAggregator: 对账扫描失败:" << query.lastError().text();
+            cancelReconcile();
+            return false;
+        }
+
+        while (query.next()) {
+            PlayerEntry entry;
+            entry.serverId = query.value(1).toInt();
+            entry.level = query.value(2).toInt();
+            entry.online = query.value(3).toInt() == 1;
+            scanned.insert(query.value(0).toString(), entry);
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // 扫描开始后被修改的AI以内存为准
+    for (const QString& aiId : std::as_const(m_touched)) {
+        auto current = m_players.constFind(aiId);
+        if (current != m_players.constEnd()) {
+            scanned.insert(aiId, current.value());
+        } else {
+            scanned.remove(aiId);
+        }
+    }
+
+    const QHash<int, ServerTotals> previous = m_servers;
+
+    m_players.swap(scanned);
+    m_servers.clear();
+    for (auto it = m_players.constBegin(); it != m_players.constEnd(); ++it) {
+        apply(it.value(), 1);
+    }
+
+    // 首次对账只是加载，之后出现偏差说明有未经本进程的写入
+    if (m_ready) {
+        int drifted = 0;
+        QSet<int> serverIds;
+        for (auto it = previous.constBegin(); it != previous.constEnd(); ++it) {
+            serverIds.insert(it.key());
+        }
+        for (auto it = m_servers.constBegin(); it != m_servers.constEnd(); ++it) {
+            serverIds.insert(it.key());
+        }
+        for (int serverId : std::as_const(serverIds)) {
+            const ServerTotals before = previous.value(serverId);
+            const ServerTotals after = m_servers.value(serverId);
+            if (before.total != after.total || before.online != after.online || before.levelSum != after.levelSum) {
+                ++drifted;
+            }
+        }
+        if (drifted > 0) {
+            qWarning() << "ServerStatsAggregator: 对账纠正了" << drifted << "个服务器的统计偏差";
+        }
+        m_stats.driftedServers += drifted;
+    }
+
+    m_ready = true;
+    m_reconciling = false;
+    m_touched.clear();
+    ++m_stats.reconciles;
+    m_stats.lastReconcileMs = QDateTime::currentMSecsSinceEpoch();
+    m_stats.lastReconcileDurationMs = timer.elapsed();
+    return true;
+}
+
+/**
+ * @brief 放弃本次对账
+ */
+void ServerStatsAggregator::cancelReconcile()
+{
+    QMutexLocker locker(&m_mutex);
+    m_reconciling = false;
+    m_invalidated = true;
+    m_touched.clear();
+}
+
+/**
+ * @brief 获取按服务器的汇总
+ */
+QMap<int, ServerAggregate> ServerStatsAggregator::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QMap<int, ServerAggregate> result;
+    for (auto it = m_servers.constBegin(); it != m_servers.constEnd(); ++it) {
+        const ServerTotals& totals = it.value();
+        if (totals.total <= 0) {
+            continue;
+        }
+
+        ServerAggregate aggregate;
+        aggregate.totalCount = totals.total;
+        aggregate.onlineCount = totals.online;
+        aggregate.averageLevel = static_cast<double>(totals.levelSum) / totals.total;
+        result.insert(it.key(), aggregate);
+    }
+    return result;
+}
+
+/**
+ * @brief 获取统计
+ */
+ServerStatsAggregatorStats ServerStatsAggregator::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    ServerStatsAggregatorStats stats = m_stats;
+    stats.trackedPlayers = m_players.size();
+    stats.servers = 0;
+    for (const ServerTotals& totals : m_servers) {
+        if (totals.total > 0) {
+            ++stats.servers;
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief 从服务器累加值中加上或减去一个AI
+ */
+void ServerStatsAggregator::apply(const PlayerEntry& entry, int sign)
+{
+    ServerTotals& totals = m_servers[entry.serverId];
+    totals.total += sign;
+    totals.online += entry.online ? sign : 0;
+    totals.levelSum += static_cast<qint64>(sign) * entry.level;
+}
+
+/**
+ * @brief 记录对账期间被修改的AI
+ */
+void ServerStatsAggregator::touch(const QString& aiId)
+{
+    if (m_reconciling) {
+        m_touched.insert(aiId);
+    }
+}
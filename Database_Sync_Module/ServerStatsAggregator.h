@@ -0,0 +1,177 @@
+/**
+ * @file ServerStatsAggregator.h
+ * @brief RANOnline EP7 AI系统 - 按服务器增量维护的AI统计头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - 由写入AI玩家的同步路径增量更新，每次更新O(1)
+ * - 读取按服务器汇总，O(服务器数)，不再每次GROUP BY全表
+ * - 定期全表扫描对账，纠正外部写入和清理造成的偏差
+ * - 对账期间的增量更新优先于扫描结果，不会被旧数据覆盖
+ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+class QSqlDatabase;
+
+/**
+ * @struct ServerAggregate
+ * @brief 单个服务器的AI汇总
+ */
+struct ServerAggregate
+{
+    int totalCount = 0;                 ///< AI总数
+    int onlineCount = 0;                ///< 在线AI数（status = 1）
+    double averageLevel = 0.0;          ///< 平均等级
+};
+
+/**
+ * @struct ServerStatsAggregatorStats
+ * @brief 聚合器自身的统计
+ */
+struct ServerStatsAggregatorStats
+{
+    int trackedPlayers = 0;             ///< 跟踪的AI数
+    int servers = 0;                    ///< 服务器数
+    quint64 updates = 0;                ///< 增量更新次数
+    quint64 reconciles = 0;             ///< 对账次数
+    quint64 driftedServers = 0;         ///< 对账时发现偏差的服务器累计数
+    qint64 lastReconcileMs = 0;         ///< 上次对账完成时间（毫秒时间戳）
+    qint64 lastReconcileDurationMs = 0; ///< 上次对账耗时（毫秒）
+};
+
+/**
+ * @class ServerStatsAggregator
+ * @brief 按服务器增量维护的AI统计
+ *
+ * 更新方法可在任意线程调用。对账分两步：beginReconcile()之后的更新会被
+ * 记录，finishReconcile()扫描数据库后，这些AI保留内存中的值，其余以扫描
+ * 结果为准。调用方应在beginReconcile()之后、扫描之前把写回缓存刷写到
+ * 数据库，使扫描能看到之前的全部修改。
+ */
+class ServerStatsAggregator
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    ServerStatsAggregator();
+
+    /**
+     * @brief 写入或更新AI的服务器和等级（在线状态不变，新AI为离线）
+     * @param aiId AI ID
+     * @param serverId 服务器ID
+     * @param level 等级
+     */
+    void upsertPlayer(const QString& aiId, int serverId, int level);
+
+    /**
+     * @brief 更新AI状态
+     * @param aiId AI ID
+     * @param status 状态值（1为在线）
+     */
+    void setStatus(const QString& aiId, int status);
+
+    /**
+     * @brief 删除AI
+     * @param aiId AI ID
+     */
+    void removePlayer(const QString& aiId);
+
+    /**
+     * @brief 标记需要尽快对账（如批量清理或外部写入之后）
+     */
+    void invalidate();
+
+    /**
+     * @brief 是否已完成过对账（之前的汇总不可信）
+     */
+    bool isReady() const;
+
+    /**
+     * @brief 是否需要对账
+     * @param intervalMs 对账间隔（毫秒）
+     * @return 从未对账、被标记或超过间隔时返回true
+     */
+    bool reconcileDue(int intervalMs) const;
+
+    /**
+     * @brief 开始对账，之后的增量更新会覆盖扫描结果
+     */
+    void beginReconcile();
+
+    /**
+     * @brief 扫描数据库完成对账
+     * @param db 数据库连接
+     * @return 是否成功（失败时保持原有汇总）
+     */
+    bool finishReconcile(QSqlDatabase& db);
+
+    /**
+     * @brief 放弃本次对账（如写回缓存刷写失败，扫描结果会缺少未写入的修改）
+     */
+    void cancelReconcile();
+
+    /**
+     * @brief 获取按服务器的汇总
+     * @return 服务器ID到汇总的映射
+     */
+    QMap<int, ServerAggregate> snapshot() const;
+
+    /**
+     * @brief 获取统计
+     * @return 统计快照
+     */
+    ServerStatsAggregatorStats stats() const;
+
+private:
+    /**
+     * @struct PlayerEntry
+     * @brief 单个AI的计入值
+     */
+    struct PlayerEntry {
+        int serverId = 0;               ///< 服务器ID
+        int level = 0;                  ///< 等级
+        bool online = false;            ///< 是否在线
+    };
+
+    /**
+     * @struct ServerTotals
+     * @brief 单个服务器的累加值
+     */
+    struct ServerTotals {
+        int total = 0;                  ///< AI总数
+        int online = 0;                 ///< 在线AI数
+        qint64 levelSum = 0;            ///< 等级合计
+    };
+
+    /**
+     * @brief 从服务器累加值中加上或减去一个AI（调用方持有m_mutex）
+     */
+    void apply(const PlayerEntry& entry, int sign);
+
+    /**
+     * @brief 记录对账期间被修改的AI（调用方持有m_mutex）
+     */
+    void touch(const QString& aiId);
+
+private:
+    mutable QMutex m_mutex;                     ///< 互斥锁
+    QHash<QString, PlayerEntry> m_players;      ///< 每个AI的计入值
+    QHash<int, ServerTotals> m_servers;         ///< 每个服务器的累加值
+
+    bool m_ready;                               ///< 是否已对账
+    bool m_invalidated;                         ///< 是否被标记需要对账
+    bool m_reconciling;                         ///< 是否在对账中
+    QSet<QString> m_touched;                    ///< 对账期间被修改的AI
+
+    ServerStatsAggregatorStats m_stats;         ///< 统计
+};
@@ -0,0 +1,274 @@
+/**
+ * @file StorageBackend.cpp
+ * @brief RANOnline EP7 AI系统 - 可替换的存储后端实现文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ */
+
+#include "StorageBackend.h"
+#include "DatabaseConfig.h"
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+/**
+ * @brief SQLite时间文本格式（与Qt::ISODateWithMs一致）
+ */
+const QLatin1String SQLITE_TIME_FORMAT("'%Y-%m-%dT%H:%M:%f'");
+
+/**
+ * @brief 移除打开失败的连接
+ */
+void discardConnection(std::shared_ptr<QSqlDatabase>& db, const QString& connectionName,
+                       const QString& message, QString* error)
+{
+    if (error) {
+        *error = message;
+    }
+    db.reset();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+} // namespace
+
+/**
+ * @brief 按配置创建后端
+ */
+std::unique_ptr<StorageBackend> StorageBackend::create(const DatabaseConfig& config)
+{
+    if (config.backendType.compare("SQLite", Qt::CaseInsensitive) == 0) {
+        return std::make_unique<SqliteBackend>(config.sqlitePath, config.sqliteBusyTimeout);
+    }
+    return std::make_unique<SqlServerBackend>(config);
+}
+
+/**
+ * @brief 构造函数
+ */
+SqlServerBackend::SqlServerBackend(const DatabaseConfig& config)
+{
+    m_connectionString = QString(
+        "DRIVER={ODBC Driver 17 for SQL Server};"
+        "SERVER=%1;"
+        "DATABASE=%2;"
+        "Trusted_Connection=%3;"
+    ).arg(config.serverName)
+     .arg(config.databaseName)
+     .arg(config.trustedConnection ? "yes" : "no");
+
+    if (!config.trustedConnection) {
+        m_connectionString += QString("UID=%1;PWD=%2;").arg(config.username, config.password);
+    }
+
+    // 添加连接选项
+    m_connectionString += "Connection Timeout=30;Login Timeout=10;";
+}
+
+/**
+ * @brief 创建并打开连接
+ */
+std::shared_ptr<QSqlDatabase> SqlServerBackend::openConnection(const QString& connectionName,
+                                                               QString* error) const
+{
+    auto db = std::make_shared<QSqlDatabase>(QSqlDatabase::addDatabase("QODBC", connectionName));
+    db->setDatabaseName(m_connectionString);
+
+    if (!db->open()) {
+        discardConnection(db, connectionName, db->lastError().text(), error);
+        return nullptr;
+    }
+    return db;
+}
+
+/**
+ * @brief 建表语句
+ */
+QStringList SqlServerBackend::schemaStatements(bool includeLogTable) const
+{
+    QStringList statements = {
+        // AI玩家表
+        R"(
+            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_AI_Players' AND xtype='U')
+            CREATE TABLE RAN_AI_Players (
+                id BIGINT IDENTITY(1,1) PRIMARY KEY,
+                ai_id NVARCHAR(50) UNIQUE NOT NULL,
+                name NVARCHAR(100) NOT NULL,
+                school INT NOT NULL,
+                level INT NOT NULL DEFAULT 1,
+                server_id INT NOT NULL DEFAULT 1,
+                aggression INT NOT NULL DEFAULT 50,
+                intelligence INT NOT NULL DEFAULT 50,
+                social INT NOT NULL DEFAULT 50,
+                anti_lag BIT NOT NULL DEFAULT 0,
+                status INT NOT NULL DEFAULT 0,
+                created_time DATETIME NOT NULL DEFAULT GETDATE(),
+                last_update DATETIME NOT NULL DEFAULT GETDATE(),
+                INDEX IX_AI_Players_ServerId (server_id),
+                INDEX IX_AI_Players_School (school),
+                INDEX IX_AI_Players_Status (status)
+            )
+        )",
+
+        // 服务器状态表
+        R"(
+            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_Server_Status' AND xtype='U')
+            CREATE TABLE RAN_Server_Status (
+                server_id INT PRIMARY KEY,
+                server_name NVARCHAR(100) NOT NULL,
+                ai_count INT NOT NULL DEFAULT 0,
+                online_count INT NOT NULL DEFAULT 0,
+                load_percentage FLOAT NOT NULL DEFAULT 0.0,
+                last_update DATETIME NOT NULL DEFAULT GETDATE()
+            )
+        )"
+    };
+
+    // AI操作日志表：启用分区存储时由LogPartitionStore创建按天分区的表
+    if (includeLogTable) {
+        statements << R"(
+            IF NOT EXISTS (SELECT * FROM sysobjects WHERE name='RAN_AI_Logs' AND xtype='U')
+            CREATE TABLE RAN_AI_Logs (
+                id BIGINT IDENTITY(1,1) PRIMARY KEY,
+                ai_id NVARCHAR(50) NOT NULL,
+                operation NVARCHAR(100) NOT NULL,
+                details NVARCHAR(MAX),
+                timestamp DATETIME NOT NULL DEFAULT GETDATE(),
+                INDEX IX_AI_Logs_AiId (ai_id),
+                INDEX IX_AI_Logs_Timestamp (timestamp)
+            )
+        )";
+    }
+
+    return statements;
+}
+
+/**
+ * @brief 构造函数
+ */
+SqliteBackend::SqliteBackend(const QString& filePath, int busyTimeoutMs)
+    : m_filePath(filePath)
+    , m_busyTimeoutMs(qMax(0, busyTimeoutMs))
+{
+}
+
+/**
+ * @brief 创建并打开连接
+ */
+std::shared_ptr<QSqlDatabase> SqliteBackend::openConnection(const QString& connectionName,
+                                                            QString* error) const
+{
+    if (m_filePath != ":memory:") {
+        QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    }
+
+    auto db = std::make_shared<QSqlDatabase>(QSqlDatabase::addDatabase("QSQLITE", connectionName));
+    db->setDatabaseName(m_filePath);
+    db->setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(m_busyTimeoutMs));
+
+    if (!db->open()) {
+        discardConnection(db, connectionName, db->lastError().text(), error);
+        return nullptr;
+    }
+
+    // WAL：写入追加到日志文件，读不阻塞写；NORMAL只在检查点时fsync
+    const QStringList pragmas = {
+        "PRAGMA journal_mode=WAL",
+        "PRAGMA synchronous=NORMAL",
+        "PRAGMA temp_store=MEMORY"
+    };
+
+    QSqlQuery query(*db);
+    for (const QString& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            const QString message = query.lastError().text();
+            query = QSqlQuery();
+            db->close();
+            discardConnection(db, connectionName, message, error);
+            return nullptr;
+        }
+    }
+
+    return db;
+}
+
+/**
+ * @brief 建表语句
+ */
+QStringList SqliteBackend::schemaStatements(bool includeLogTable) const
+{
+    const QString now = nowExpression();
+
+    QStringList statements = {
+        // AI玩家表
+        QString(R"(
+            CREATE TABLE IF NOT EXISTS RAN_AI_Players (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                ai_id TEXT UNIQUE NOT NULL,
+                name TEXT NOT NULL,
+                school INTEGER NOT NULL,
+                level INTEGER NOT NULL DEFAULT 1,
+                server_id INTEGER NOT NULL DEFAULT 1,
+                aggression INTEGER NOT NULL DEFAULT 50,
+                intelligence INTEGER NOT NULL DEFAULT 50,
+                social INTEGER NOT NULL DEFAULT 50,
+                anti_lag INTEGER NOT NULL DEFAULT 0,
+                status INTEGER NOT NULL DEFAULT 0,
+                created_time TEXT NOT NULL DEFAULT (%1),
+                last_update TEXT NOT NULL DEFAULT (%1)
+            )
+        )").arg(now),
+        "CREATE INDEX IF NOT EXISTS IX_AI_Players_ServerId ON RAN_AI_Players (server_id)",
+        "CREATE INDEX IF NOT EXISTS IX_AI_Players_School ON RAN_AI_Players (school)",
+        "CREATE INDEX IF NOT EXISTS IX_AI_Players_Status ON RAN_AI_Players (status)",
+
+        // 服务器状态表
+        QString(R"(
+            CREATE TABLE IF NOT EXISTS RAN_Server_Status (
+                server_id INTEGER PRIMARY KEY,
+                server_name TEXT NOT NULL,
+                ai_count INTEGER NOT NULL DEFAULT 0,
+                online_count INTEGER NOT NULL DEFAULT 0,
+                load_percentage REAL NOT NULL DEFAULT 0.0,
+                last_update TEXT NOT NULL DEFAULT (%1)
+            )
+        )").arg(now)
+    };
+
+    // SQLite没有分区，日志表始终为普通表
+    Q_UNUSED(includeLogTable);
+    statements << QString(R"(
+            CREATE TABLE IF NOT EXISTS RAN_AI_Logs (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                ai_id TEXT NOT NULL,
+                operation TEXT NOT NULL,
+                details TEXT,
+                timestamp TEXT NOT NULL DEFAULT (%1)
+            )
+        )").arg(now)
+        << "CREATE INDEX IF NOT EXISTS IX_AI_Logs_AiId ON RAN_AI_Logs (ai_id)"
+        << "CREATE INDEX IF NOT EXISTS IX_AI_Logs_Timestamp ON RAN_AI_Logs (timestamp)";
+
+    return statements;
+}
+
+/**
+ * @brief 当前时间表达式
+ */
+QString SqliteBackend::nowExpression() const
+{
+    return QString("strftime(%1, 'now', 'localtime')").arg(SQLITE_TIME_FORMAT);
+}
+
+/**
+ * @brief N天前时间表达式
+ */
+QString SqliteBackend::daysAgoExpression() const
+{
+    return QString("strftime(%1, 'now', 'localtime', '-' || ? || ' days')").arg(SQLITE_TIME_FORMAT);
+}
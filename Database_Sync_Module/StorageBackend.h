@@ -0,0 +1,154 @@
+/**
+ * @file StorageBackend.h
+ * @brief RANOnline EP7 AI系统 - 可替换的存储后端头文件
+ * @author Jy技术团队
+ * @date 2025年6月14日
+ * @version 2.0.0
+ *
+ * 功能特色:
+ * - SQL Server（QODBC）与SQLite（QSQLITE，WAL模式）两种后端
+ * - 同一套表结构：RAN_AI_Players、RAN_AI_Logs、RAN_Server_Status
+ * - 按方言生成时间表达式，Upsert语句由BulkUpsertWriter按方言生成
+ * - 无SQL Server的开发机可用SQLite后端测试和压测同步吞吐
+ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <memory>
+
+class QSqlDatabase;
+struct DatabaseConfig;
+
+/**
+ * @enum SqlDialect
+ * @brief SQL方言
+ */
+enum class SqlDialect {
+    SqlServer,      ///< SQL Server（MERGE、#临时表、GETDATE()）
+    Sqlite          ///< SQLite（INSERT ... ON CONFLICT、strftime()）
+};
+
+/**
+ * @class StorageBackend
+ * @brief 存储后端接口
+ *
+ * 负责打开连接、提供建表语句和方言相关的SQL片段。连接由ConnectionPool
+ * 通过openConnection()按需创建，实现须可在任意线程调用。
+ */
+class StorageBackend
+{
+public:
+    virtual ~StorageBackend() = default;
+
+    /**
+     * @brief 获取SQL方言
+     */
+    virtual SqlDialect dialect() const = 0;
+
+    /**
+     * @brief 获取后端名称（用于日志）
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * @brief 创建并打开连接
+     * @param connectionName Qt连接名
+     * @param error 输出错误信息（可为空）
+     * @return 连接，失败返回nullptr（连接名已移除）
+     */
+    virtual std::shared_ptr<QSqlDatabase> openConnection(const QString& connectionName,
+                                                         QString* error = nullptr) const = 0;
+
+    /**
+     * @brief 建表语句（AI玩家表、服务器状态表）
+     * @param includeLogTable 是否包含未分区的日志表
+     * @return 可重复执行的建表语句
+     */
+    virtual QStringList schemaStatements(bool includeLogTable) const = 0;
+
+    /**
+     * @brief 当前时间表达式
+     */
+    virtual QString nowExpression() const = 0;
+
+    /**
+     * @brief N天前时间表达式（含一个天数占位符?）
+     */
+    virtual QString daysAgoExpression() const = 0;
+
+    /**
+     * @brief 是否支持按天分区的日志表
+     */
+    virtual bool supportsPartitionedLogs() const = 0;
+
+    /**
+     * @brief 按配置创建后端
+     * @param config 数据库配置（database.type为"SQLite"时使用SQLite）
+     * @return 后端实例
+     */
+    static std::unique_ptr<StorageBackend> create(const DatabaseConfig& config);
+};
+
+/**
+ * @class SqlServerBackend
+ * @brief SQL Server后端（ODBC Driver 17）
+ */
+class SqlServerBackend : public StorageBackend
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param config 数据库配置
+     */
+    explicit SqlServerBackend(const DatabaseConfig& config);
+
+    SqlDialect dialect() const override { return SqlDialect::SqlServer; }
+    QString name() const override { return "SQL Server"; }
+    std::shared_ptr<QSqlDatabase> openConnection(const QString& connectionName,
+                                                 QString* error = nullptr) const override;
+    QStringList schemaStatements(bool includeLogTable) const override;
+    QString nowExpression() const override { return "GETDATE()"; }
+    QString daysAgoExpression() const override { return "DATEADD(day, -?, GETDATE())"; }
+    bool supportsPartitionedLogs() const override { return true; }
+
+private:
+    QString m_connectionString;         ///< ODBC连接字符串
+};
+
+/**
+ * @class SqliteBackend
+ * @brief SQLite后端（WAL模式）
+ *
+ * WAL模式下读不阻塞写，synchronous=NORMAL只在检查点时fsync。时间以
+ * ISO 8601本地时间文本保存，与Qt绑定QDateTime参数的格式一致，可直接比较。
+ */
+class SqliteBackend : public StorageBackend
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 数据库文件路径
+     * @param busyTimeoutMs 写锁等待时间（毫秒）
+     */
+    SqliteBackend(const QString& filePath, int busyTimeoutMs);
+
+    SqlDialect dialect() const override { return SqlDialect::Sqlite; }
+    QString name() const override { return "SQLite"; }
+    std::shared_ptr<QSqlDatabase> openConnection(const QString& connectionName,
+                                                 QString* error = nullptr) const override;
+    QStringList schemaStatements(bool includeLogTable) const override;
+    QString nowExpression() const override;
+    QString daysAgoExpression() const override;
+    bool supportsPartitionedLogs() const override { return false; }
+
+    /**
+     * @brief 数据库文件路径
+     */
+    QString filePath() const { return m_filePath; }
+
+private:
+    QString m_filePath;                 ///< 数据库文件路径
+    int m_busyTimeoutMs;                ///< 写锁等待时间
+};
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include "AIPlayerTableModel.h"
+
+using namespace RANOnline::AI;
+
+class AIPlayerTableModelTest : public ::testing::Test {
+protected:
+    static AIPlayerData makePlayer(int index) {
+        AIPlayerData player;
+        player.aiId = QString("AI_%1").arg(index, 5, 10, QChar('0'));
+        player.academy = index % 2 == 0 ? "聖門" : "懸岩";
+        player.department = "劍道";
+        player.name = QString("Bot%1").arg(index);
+        player.personality = "冷靜";
+        player.combatStyle = "近戰";
+        player.state = "idle";
+        player.hp = 100;
+        player.mp = 100;
+        return player;
+    }
+
+    static QVector<AIPlayerData> makeRoster(int count) {
+        QVector<AIPlayerData> players;
+        for (int i = 0; i < count; ++i) {
+            players.append(makePlayer(i));
+        }
+        return players;
+    }
+
+    // 記錄模型發出的通知
+    void watch(AIPlayerTableModel &model) {
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted, [this](const QModelIndex &, int first, int last) {
+            m_inserted.append({first, last});
+        });
+        QObject::connect(&model, &QAbstractItemModel::rowsRemoved, [this](const QModelIndex &, int first, int last) {
+            m_removed.append({first, last});
+        });
+        QObject::connect(&model, &QAbstractItemModel::dataChanged, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+            m_changed.append({topLeft, bottomRight});
+        });
+    }
+
+    QVector<QPair<int, int>> m_inserted;
+    QVector<QPair<int, int>> m_removed;
+    QVector<QPair<QModelIndex, QModelIndex>> m_changed;
+};
+
+TEST_F(AIPlayerTableModelTest, AppendInsertsWholeBatchOnce) {
+    AIPlayerTableModel model;
+    watch(model);
+
+    model.appendPlayers(makeRoster(10000));
+
+    ASSERT_EQ(m_inserted.size(), 1);
+    EXPECT_EQ(m_inserted.first(), qMakePair(0, 9999));
+    EXPECT_EQ(model.rowCount(), 10000);
+    EXPECT_EQ(model.rowOf("AI_09999"), 9999);
+}
+
+TEST_F(AIPlayerTableModelTest, SyncNotifiesChangedCellsOnly) {
+    AIPlayerTableModel model;
+    model.appendPlayers(makeRoster(100));
+    watch(model);
+
+    QVector<AIPlayerData> roster = makeRoster(100);
+    roster[42].state = "combat";
+    roster[50].name = "Renamed";
+    roster[50].state = "dead";
+    model.syncPlayers(roster);
+
+    EXPECT_TRUE(m_inserted.isEmpty());
+    EXPECT_TRUE(m_removed.isEmpty());
+    ASSERT_EQ(m_changed.size(), 2);
+    EXPECT_EQ(m_changed[0].first, model.index(42, AIPlayerTableModel::StateColumn));
+    EXPECT_EQ(m_changed[0].second, model.index(42, AIPlayerTableModel::StateColumn));
+    EXPECT_EQ(m_changed[1].first, model.index(50, AIPlayerTableModel::NameColumn));
+    EXPECT_EQ(m_changed[1].second, model.index(50, AIPlayerTableModel::StateColumn));
+
+    // 再次同步相同名冊不發任何通知
+    m_changed.clear();
+    model.syncPlayers(roster);
+    EXPECT_TRUE(m_changed.isEmpty());
+}
+
+TEST_F(AIPlayerTableModelTest, SyncRemovesRunsAndAppendsNewPlayers) {
+    AIPlayerTableModel model;
+    model.appendPlayers(makeRoster(10));
+    watch(model);
+
+    QVector<AIPlayerData> roster = makeRoster(10);
+    roster.remove(3, 3);    // 移除 AI_00003..AI_00005
+    roster.append(makePlayer(20));
+    roster.append(makePlayer(21));
+    model.syncPlayers(roster);
+
+    ASSERT_EQ(m_removed.size(), 1);
+    EXPECT_EQ(m_removed.first(), qMakePair(3, 5));
+    ASSERT_EQ(m_inserted.size(), 1);
+    EXPECT_EQ(m_inserted.first(), qMakePair(7, 8));
+    EXPECT_EQ(model.rowCount(), 9);
+    EXPECT_EQ(model.rowOf("AI_00006"), 3);
+    EXPECT_EQ(model.rowOf("AI_00003"), -1);
+    EXPECT_EQ(model.rowOf("AI_00021"), 8);
+}
+
+TEST_F(AIPlayerTableModelTest, DuplicateIdsInOneBatchInsertOnce) {
+    AIPlayerTableModel model;
+    watch(model);
+
+    QVector<AIPlayerData> batch = makeRoster(3);
+    batch.append(makePlayer(1));
+    batch.last().state = "combat";
+    model.appendPlayers(batch);
+
+    // 同一批內重複的ID只新增一行，以最後一筆為準
+    ASSERT_EQ(m_inserted.size(), 1);
+    EXPECT_EQ(m_inserted.first(), qMakePair(0, 2));
+    EXPECT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.playerAt(model.rowOf("AI_00001")).state, "combat");
+
+    batch = makeRoster(3);
+    batch.append(makePlayer(7));
+    batch.append(makePlayer(7));
+    model.syncPlayers(batch);
+    EXPECT_EQ(model.rowCount(), 4);
+    EXPECT_EQ(model.rowOf("AI_00007"), 3);
+}
+
+TEST_F(AIPlayerTableModelTest, ProxyFiltersAndSorts) {
+    AIPlayerTableModel model;
+    model.appendPlayers(makeRoster(100));
+
+    AIPlayerFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setAcademyFilter("聖門");
+    EXPECT_EQ(proxy.rowCount(), 50);
+
+    proxy.sort(AIPlayerTableModel::IdColumn, Qt::DescendingOrder);
+    EXPECT_EQ(proxy.index(0, AIPlayerTableModel::IdColumn).data().toString(), "AI_00098");
+
+    // 狀態變化後仍按篩選顯示
+    model.updateState("AI_00098", "combat");
+    EXPECT_EQ(proxy.index(0, AIPlayerTableModel::StateColumn).data().toString(), "combat");
+
+    proxy.setAcademyFilter(QString());
+    EXPECT_EQ(proxy.rowCount(), 100);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "BulkUpsertWriter.h"
+
+class BulkUpsertWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = QSqlDatabase::addDatabase("QSQLITE", "bulk_upsert_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open());
+
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec("CREATE TABLE RAN_AI_Players ("
+                               "ai_id TEXT PRIMARY KEY, name TEXT NOT NULL, level INTEGER, "
+                               "created_time TEXT, last_update TEXT)"));
+    }
+
+    void TearDown() override {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("bulk_upsert_test");
+    }
+
+    static BulkUpsertWriter::TableSpec playerSpec() {
+        BulkUpsertWriter::TableSpec spec;
+        spec.targetTable = "RAN_AI_Players";
+        spec.stagingTable = "#RAN_AI_Players_Stage";
+        spec.columns = { "ai_id", "name", "level" };
+        spec.columnTypes = { "NVARCHAR(50) NOT NULL", "NVARCHAR(100)", "INT" };
+        spec.keyColumns = { "ai_id" };
+        spec.computedColumns = {
+            { "created_time", "CURRENT_TIMESTAMP", false },
+            { "last_update", "CURRENT_TIMESTAMP", true }
+        };
+        return spec;
+    }
+
+    static QVector<QVariantList> playerColumns(int count, int level) {
+        QVector<QVariantList> columns(3);
+        for (int i = 0; i < count; ++i) {
+            columns[0] << QString("AI_%1").arg(i);
+            columns[1] << QString("Player_%1").arg(i);
+            columns[2] << level;
+        }
+        return columns;
+    }
+
+    QVariant scalar(const QString& sql) {
+        QSqlQuery query(db);
+        query.exec(sql);
+        query.next();
+        return query.value(0);
+    }
+
+    QSqlDatabase db;
+};
+
+TEST_F(BulkUpsertWriterTest, GeneratesSqlServerMerge) {
+    QString sql = BulkUpsertWriter::singleRowUpsertSql(playerSpec(), SqlDialect::SqlServer);
+
+    EXPECT_TRUE(sql.startsWith("MERGE RAN_AI_Players AS target USING (SELECT ? AS ai_id, ? AS name, ? AS level)"));
+    EXPECT_TRUE(sql.contains("ON target.ai_id = source.ai_id"));
+    EXPECT_TRUE(sql.contains("WHEN MATCHED THEN UPDATE SET name = source.name, level = source.level, "
+                             "last_update = CURRENT_TIMESTAMP"));
+    EXPECT_TRUE(sql.contains("INSERT (ai_id, name, level, created_time, last_update)"));
+
+    // 键列不更新，仅插入时写入的计算列不出现在UPDATE中
+    EXPECT_FALSE(sql.contains("ai_id = source.ai_id,"));
+    EXPECT_FALSE(sql.contains("created_time = CURRENT_TIMESTAMP"));
+}
+
+TEST_F(BulkUpsertWriterTest, GeneratesSqliteOnConflict) {
+    QString sql = BulkUpsertWriter::singleRowUpsertSql(playerSpec(), SqlDialect::Sqlite);
+
+    EXPECT_EQ(sql, "INSERT INTO RAN_AI_Players (ai_id, name, level, created_time, last_update) "
+                   "VALUES (?, ?, ?, CURRENT_TIMESTAMP, CURRENT_TIMESTAMP) "
+                   "ON CONFLICT (ai_id) DO UPDATE SET name = excluded.name, level = excluded.level, "
+                   "last_update = CURRENT_TIMESTAMP");
+}
+
+TEST_F(BulkUpsertWriterTest, WritesInChunksAndUpdatesExistingRows) {
+    BulkUpsertWriter writer(playerSpec(), 100, SqlDialect::Sqlite);
+
+    ASSERT_TRUE(writer.upsert(db, playerColumns(1050, 1))) << writer.lastError().toStdString();
+    EXPECT_EQ(writer.lastRoundTrips(), 11);
+    EXPECT_EQ(writer.lastAffectedRows(), 1050);
+    EXPECT_TRUE(writer.rejectedRows().isEmpty());
+
+    ASSERT_TRUE(writer.upsert(db, playerColumns(1050, 2)));
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 1050);
+    EXPECT_EQ(scalar("SELECT MIN(level) FROM RAN_AI_Players").toInt(), 2);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players WHERE created_time IS NULL").toInt(), 0);
+}
+
+TEST_F(BulkUpsertWriterTest, RejectsColumnCountMismatch) {
+    BulkUpsertWriter writer(playerSpec(), 100, SqlDialect::Sqlite);
+    QVector<QVariantList> columns = playerColumns(10, 1);
+    columns.removeLast();
+
+    EXPECT_FALSE(writer.upsert(db, columns));
+    EXPECT_FALSE(writer.lastError().isEmpty());
+    EXPECT_EQ(writer.lastRoundTrips(), 0);
+}
+
+TEST_F(BulkUpsertWriterTest, SplitsFailedChunkAndRejectsOnlyBadRows) {
+    BulkUpsertWriter writer(playerSpec(), 64, SqlDialect::Sqlite);
+    QVector<QVariantList> columns = playerColumns(200, 1);
+    columns[1][37] = QVariant();     // 违反NOT NULL
+    columns[1][150] = QVariant();
+
+    ASSERT_TRUE(writer.upsert(db, columns)) << writer.lastError().toStdString();
+    EXPECT_EQ(writer.rejectedRows(), QVector<int>({ 37, 150 }));
+    EXPECT_FALSE(writer.connectionLost());
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 198);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players WHERE ai_id IN ('AI_37', 'AI_150')").toInt(), 0);
+
+    // 只有出错块被拆分：4块各一次，加两个坏块各自的二分重试
+    EXPECT_GT(writer.lastRoundTrips(), 4);
+    EXPECT_LT(writer.lastRoundTrips(), 4 + 2 * 2 * 7);
+}
+
+TEST_F(BulkUpsertWriterTest, FailsWhenEveryRowIsRejected) {
+    BulkUpsertWriter writer(playerSpec(), 4, SqlDialect::Sqlite);
+    QVector<QVariantList> columns = playerColumns(8, 1);
+    for (QVariant& name : columns[1]) {
+        name = QVariant();
+    }
+
+    EXPECT_FALSE(writer.upsert(db, columns));
+    EXPECT_EQ(writer.rejectedRows().size(), 8);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 0);
+}
+
+TEST_F(BulkUpsertWriterTest, InvalidStatementIsNotSplit) {
+    BulkUpsertWriter::TableSpec spec = playerSpec();
+    spec.targetTable = "RAN_AI_Missing";
+    BulkUpsertWriter writer(spec, 10, SqlDialect::Sqlite);
+
+    EXPECT_FALSE(writer.upsert(db, playerColumns(100, 1)));
+    EXPECT_TRUE(writer.rejectedRows().isEmpty());
+    EXPECT_EQ(writer.lastRoundTrips(), 0);
+}
+
+TEST_F(BulkUpsertWriterTest, ClosedConnectionStopsWithoutSplitting) {
+    BulkUpsertWriter writer(playerSpec(), 10, SqlDialect::Sqlite);
+    db.close();
+
+    EXPECT_FALSE(writer.upsert(db, playerColumns(100, 1)));
+    EXPECT_TRUE(writer.connectionLost());
+    EXPECT_TRUE(writer.rejectedRows().isEmpty());
+    EXPECT_LE(writer.lastRoundTrips(), 1);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <cmath>
+#include "ChartSeriesBuffer.h"
+
+class ChartSeriesBufferTest : public ::testing::Test {
+protected:
+    // 每秒一个采样，第i秒的值为i % 100
+    static void appendSeconds(ChartSeriesBuffer &buffer, int seconds) {
+        for (int i = 0; i < seconds; ++i) {
+            buffer.append(i, i % 100);
+        }
+    }
+};
+
+TEST_F(ChartSeriesBufferTest, WindowKeepsNewestPoints) {
+    ChartSeriesBuffer buffer(10);
+    appendSeconds(buffer, 25);
+
+    EXPECT_EQ(buffer.size(), 10);
+    EXPECT_DOUBLE_EQ(buffer.at(0).x(), 15.0);
+    EXPECT_DOUBLE_EQ(buffer.at(9).x(), 24.0);
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.isEmpty());
+    buffer.append(100, 1);
+    EXPECT_DOUBLE_EQ(buffer.at(0).x(), 100.0);
+}
+
+TEST_F(ChartSeriesBufferTest, SmallRangeIsReturnedUnchanged) {
+    ChartSeriesBuffer buffer(100);
+    appendSeconds(buffer, 50);
+
+    const QList<QPointF> points = buffer.decimated(10, 19, 200);
+    ASSERT_EQ(points.size(), 10);
+    EXPECT_DOUBLE_EQ(points.first().x(), 10.0);
+    EXPECT_DOUBLE_EQ(points.last().x(), 19.0);
+}
+
+TEST_F(ChartSeriesBufferTest, DecimationIsBoundedByPixelWidth) {
+    ChartSeriesBuffer buffer(100000);
+    appendSeconds(buffer, 100000);
+
+    const QList<QPointF> points = buffer.decimated(0, 100000, 500);
+    EXPECT_LE(points.size(), 1000);
+    EXPECT_GE(points.size(), 500);
+
+    // 输出按时间顺序排列
+    for (int i = 1; i < points.size(); ++i) {
+        EXPECT_LT(points[i - 1].x(), points[i].x());
+    }
+}
+
+TEST_F(ChartSeriesBufferTest, DecimationKeepsSpikes) {
+    ChartSeriesBuffer buffer(10000);
+    for (int i = 0; i < 10000; ++i) {
+        double value = 50.0;
+        if (i == 1234) {
+            value = 99.0;
+        } else if (i == 8765) {
+            value = 1.0;
+        }
+        buffer.append(i, value);
+    }
+
+    const QList<QPointF> points = buffer.decimated(0, 10000, 100);
+    bool sawHigh = false;
+    bool sawLow = false;
+    for (const QPointF &point : points) {
+        sawHigh = sawHigh || (point.x() == 1234.0 && point.y() == 99.0);
+        sawLow = sawLow || (point.x() == 8765.0 && point.y() == 1.0);
+    }
+    EXPECT_TRUE(sawHigh);
+    EXPECT_TRUE(sawLow);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
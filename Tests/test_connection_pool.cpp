@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <thread>
+#include "ConnectionPool.h"
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+    std::unique_ptr<ConnectionPool> makePool(int minSize, int maxSize, int idleTimeoutMs = 300000) {
+        return std::make_unique<ConnectionPool>(
+            [this](const QString& connectionName) -> std::shared_ptr<QSqlDatabase> {
+                ++created;
+                auto db = std::make_shared<QSqlDatabase>(QSqlDatabase::addDatabase("QSQLITE", connectionName));
+                db->setDatabaseName(":memory:");
+                if (!db->open()) {
+                    return nullptr;
+                }
+                return db;
+            },
+            "POOL_TEST", minSize, maxSize, idleTimeoutMs);
+    }
+
+    std::atomic<int> created{0};
+};
+
+TEST_F(ConnectionPoolTest, ReusesConnectionOnSameThread) {
+    auto pool = makePool(1, 4);
+
+    auto first = pool->tryAcquire(0);
+    ASSERT_TRUE(first);
+    QSqlDatabase* raw = first.get();
+    pool->release(first);
+
+    auto second = pool->tryAcquire(0);
+    EXPECT_EQ(second.get(), raw);
+    EXPECT_EQ(created.load(), 1);
+    pool->release(second);
+
+    ConnectionPoolStats stats = pool->stats();
+    EXPECT_EQ(stats.total, 1);
+    EXPECT_EQ(stats.idle, 1);
+    EXPECT_EQ(stats.acquired, 2u);
+}
+
+TEST_F(ConnectionPoolTest, ConnectionsAreNotSharedAcrossThreads) {
+    auto pool = makePool(1, 4);
+
+    auto mine = pool->tryAcquire(0);
+    ASSERT_TRUE(mine);
+    pool->release(mine);
+
+    QSqlDatabase* other = nullptr;
+    std::thread worker([&]() {
+        auto connection = pool->tryAcquire(0);
+        other = connection.get();
+        pool->release(connection);
+    });
+    worker.join();
+
+    EXPECT_NE(other, nullptr);
+    EXPECT_NE(other, mine.get());
+    EXPECT_EQ(pool->stats().total, 2);
+}
+
+TEST_F(ConnectionPoolTest, TimesOutWhenExhausted) {
+    auto pool = makePool(0, 1);
+
+    auto held = pool->tryAcquire(0);
+    ASSERT_TRUE(held);
+
+    auto none = pool->tryAcquire(20);
+    EXPECT_FALSE(none);
+    EXPECT_EQ(pool->stats().timeouts, 1u);
+
+    pool->release(held);
+}
+
+TEST_F(ConnectionPoolTest, WaiterGetsSlotWhenConnectionReturned) {
+    auto pool = makePool(0, 1);
+
+    auto held = pool->tryAcquire(0);
+    ASSERT_TRUE(held);
+
+    std::atomic<bool> acquired{false};
+    std::thread worker([&]() {
+        auto connection = pool->tryAcquire(5000);
+        acquired = static_cast<bool>(connection);
+        pool->release(connection);
+    });
+
+    QThread::msleep(20);
+    pool->release(held);
+    worker.join();
+
+    // 其他线程的空闲连接退役，名额转给等待线程；退役连接留给本线程关闭
+    ConnectionPoolStats stats = pool->stats();
+    EXPECT_TRUE(acquired.load());
+    EXPECT_EQ(stats.retired, 1u);
+    EXPECT_EQ(stats.waited, 1u);
+    EXPECT_LE(stats.total, 1);
+    EXPECT_EQ(stats.retiring, 1);
+    EXPECT_EQ(stats.closed, 0u);
+
+    // 本线程再次获取时关闭自己的退役连接（工作线程的空闲连接随之退役）
+    pool->release(pool->tryAcquire(0));
+    EXPECT_EQ(pool->stats().closed, 1u);
+}
+
+TEST_F(ConnectionPoolTest, ShrinkFromOtherThreadLeavesCloseToOwner) {
+    auto pool = makePool(0, 4, 0);
+    ASSERT_TRUE(pool->warmUp(2));
+
+    int shrunk = 0;
+    std::thread maintenance([&]() {
+        shrunk = pool->shrink();
+    });
+    maintenance.join();
+
+    EXPECT_EQ(shrunk, 2);
+    ConnectionPoolStats stats = pool->stats();
+    EXPECT_EQ(stats.total, 0);
+    EXPECT_EQ(stats.retiring, 2);
+    EXPECT_EQ(stats.closed, 0u);
+
+    // 所属线程下次获取时关闭
+    auto connection = pool->tryAcquire(0);
+    ASSERT_TRUE(connection);
+    EXPECT_EQ(pool->stats().retiring, 0);
+    EXPECT_EQ(pool->stats().closed, 2u);
+    pool->release(connection);
+}
+
+TEST_F(ConnectionPoolTest, ShrinksIdleConnectionsToMinimum) {
+    auto pool = makePool(1, 4, 0);
+
+    ASSERT_TRUE(pool->warmUp(3));
+    EXPECT_EQ(pool->stats().total, 3);
+
+    EXPECT_EQ(pool->shrink(), 2);
+    EXPECT_EQ(pool->stats().total, 1);
+}
+
+TEST_F(ConnectionPoolTest, AcquireAsyncRunsOnPoolThread) {
+    auto pool = makePool(0, 2);
+    QThreadPool threadPool;
+
+    std::atomic<bool> gotConnection{false};
+    pool->acquireAsync([&](std::shared_ptr<QSqlDatabase> connection) {
+        gotConnection = connection && connection->isOpen();
+    }, 1000, &threadPool);
+    threadPool.waitForDone();
+
+    EXPECT_TRUE(gotConnection.load());
+    EXPECT_EQ(pool->stats().idle, 1);
+}
+
+TEST_F(ConnectionPoolTest, WaitHistogramRecordsAcquires) {
+    auto pool = makePool(0, 2);
+
+    for (int i = 0; i < 10; ++i) {
+        pool->release(pool->tryAcquire(0));
+    }
+
+    ConnectionPoolStats stats = pool->stats();
+    quint64 recorded = 0;
+    for (quint64 bucket : stats.waitHistogram) {
+        recorded += bucket;
+    }
+    EXPECT_EQ(recorded, 10u);
+    EXPECT_GT(stats.waitPercentileMs(99.0), 0.0);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
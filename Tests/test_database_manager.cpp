@@ -1,59 +1,249 @@
 #include <gtest/gtest.h>
 #include <QApplication>
+#include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
+#include <atomic>
 #include "DatabaseManager.h"
+#include "GroupCommitPipeline.h"
 
 class DatabaseManagerTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        // 使用测试数据库连接
+        ASSERT_TRUE(tempDir.isValid());
         dbManager = std::make_unique<DatabaseManager>();
     }
-    
+
     void TearDown() override {
         if (dbManager) {
             dbManager->shutdown();
         }
     }
-    
+
+    // 本地SQLite后端，写回缓存日志放在临时目录
+    DatabaseConfig sqliteConfig() {
+        DatabaseConfig config;
+        config.backendType = "SQLite";
+        config.sqlitePath = tempDir.filePath("ran_ai_local.db");
+        config.writeBehindJournal = tempDir.filePath("ai_write_behind.journal");
+        config.poolSize = 2;
+        config.poolMinSize = 1;
+        config.poolMaxSize = 4;
+        return config;
+    }
+
+    static AIPlayerData makePlayer(int serverId, int level) {
+        AIPlayerData player;
+        player.name = QString("Player_%1_%2").arg(serverId).arg(level);
+        player.school = School::HOLY_SPIRIT;
+        player.level = level;
+        player.serverId = serverId;
+        player.aggression = 70;
+        player.antiLag = true;
+        return player;
+    }
+
+    void performSync() {
+        ASSERT_TRUE(QMetaObject::invokeMethod(dbManager.get(), "performSync"));
+    }
+
+    QTemporaryDir tempDir;
     std::unique_ptr<DatabaseManager> dbManager;
 };
 
-TEST_F(DatabaseManagerTest, Initialization) {
-    // 测试数据库管理器初始化
-    QString testConnectionString = "Driver={SQL Server};Server=localhost;Database=RanOnlineTest;Trusted_Connection=yes;";
-    
-    // 这里只测试初始化逻辑，不需要真实数据库连接
-    EXPECT_NE(dbManager.get(), nullptr);
-}
-
-TEST_F(DatabaseManagerTest, ConnectionPoolCreation) {
-    // 测试连接池创建
-    auto poolStatus = dbManager->getConnectionPoolStatus();
-    
-    // 检查默认状态
-    EXPECT_GE(poolStatus["totalConnections"].toInt(), 0);
-    EXPECT_GE(poolStatus["activeConnections"].toInt(), 0);
-}
-
-TEST_F(DatabaseManagerTest, AIDataSerialization) {
-    // 测试AI数据序列化
-    AIPlayerData testAI;
-    testAI.id = "TEST_AI_001";
-    testAI.name = "测试AI";
-    testAI.school = "聖門";
-    testAI.level = 50;
-    testAI.status = AIPlayerData::Status::Idle;
-    
-    // 序列化
-    auto serialized = dbManager->serializeAIData(testAI);
-    EXPECT_FALSE(serialized.isEmpty());
-    
-    // 反序列化
-    auto deserialized = dbManager->deserializeAIData(serialized);
-    EXPECT_EQ(deserialized.id.toStdString(), testAI.id);
-    EXPECT_EQ(deserialized.name.toStdString(), testAI.name);
-    EXPECT_EQ(deserialized.level, testAI.level);
+TEST_F(DatabaseManagerTest, InitializesSqliteBackend) {
+    QSignalSpy stateSpy(dbManager.get(), &DatabaseManager::connectionStateChanged);
+
+    ASSERT_TRUE(dbManager->initialize(sqliteConfig()));
+    EXPECT_TRUE(dbManager->isInitialized());
+    EXPECT_TRUE(dbManager->isConnected());
+    ASSERT_EQ(stateSpy.count(), 1);
+    EXPECT_TRUE(stateSpy.at(0).at(0).toBool());
+
+    EXPECT_TRUE(dbManager->getAiList().isEmpty());
+    EXPECT_TRUE(dbManager->getAiCountByServer().isEmpty());
+
+    dbManager->shutdown();
+    EXPECT_FALSE(dbManager->isConnected());
+}
+
+TEST_F(DatabaseManagerTest, DirectSyncRoundTrip) {
+    DatabaseConfig config = sqliteConfig();
+    config.writeBehindEnabled = false;
+    ASSERT_TRUE(dbManager->initialize(config));
+
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    ASSERT_TRUE(dbManager->syncAiData("AI_2", makePlayer(2, 20)));
+
+    QVector<AIPlayerData> players = dbManager->getAiList(2);
+    ASSERT_EQ(players.size(), 1);
+    EXPECT_EQ(players.first().name, "Player_2_20");
+    EXPECT_EQ(players.first().school, School::HOLY_SPIRIT);
+    EXPECT_EQ(players.first().level, 20);
+    EXPECT_EQ(players.first().aggression, 70);
+    EXPECT_TRUE(players.first().antiLag);
+
+    QMap<int, int> counts = dbManager->getAiCountByServer();
+    EXPECT_EQ(counts.value(1), 1);
+    EXPECT_EQ(counts.value(2), 1);
+
+    ASSERT_TRUE(dbManager->deleteAiData("AI_1"));
+    EXPECT_EQ(dbManager->getAiList().size(), 1);
+}
+
+TEST_F(DatabaseManagerTest, WriteBehindSyncLandsOnPerformSync) {
+    ASSERT_TRUE(dbManager->initialize(sqliteConfig()));
+    QSignalSpy syncedSpy(dbManager.get(), &DatabaseManager::dataSynced);
+
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    EXPECT_TRUE(dbManager->getAiList().isEmpty());
+
+    performSync();
+    ASSERT_EQ(dbManager->getAiList().size(), 1);
+    ASSERT_EQ(syncedSpy.count(), 1);
+    EXPECT_EQ(syncedSpy.at(0).at(0).toInt(), 1);
+
+    // 未变化的数据不再写入
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    performSync();
+    EXPECT_EQ(syncedSpy.count(), 1);
+}
+
+TEST_F(DatabaseManagerTest, BatchSyncAfterSingleSyncWins) {
+    ASSERT_TRUE(dbManager->initialize(sqliteConfig()));
+
+    // 写回缓存中较早的脏值不能覆盖随后的批量写入
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    QMap<QString, AIPlayerData> batch;
+    batch.insert("AI_1", makePlayer(1, 20));
+    ASSERT_TRUE(dbManager->batchSyncAiData(batch));
+
+    performSync();
+    QVector<AIPlayerData> players = dbManager->getAiList();
+    ASSERT_EQ(players.size(), 1);
+    EXPECT_EQ(players.first().level, 20);
+
+    // 缓存不再认为库中仍是旧值，改回旧值时照常写入
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    performSync();
+    players = dbManager->getAiList();
+    ASSERT_EQ(players.size(), 1);
+    EXPECT_EQ(players.first().level, 10);
+}
+
+TEST_F(DatabaseManagerTest, BatchSyncAndServerStats) {
+    DatabaseConfig config = sqliteConfig();
+    config.groupCommitEnabled = false;
+    ASSERT_TRUE(dbManager->initialize(config));
+
+    QMap<QString, AIPlayerData> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.insert(QString("AI_%1").arg(i), makePlayer(i % 2 + 1, 10 + i));
+    }
+    ASSERT_TRUE(dbManager->batchSyncAiData(batch));
+    EXPECT_EQ(dbManager->getAiList().size(), 10);
+
+    ASSERT_TRUE(dbManager->updateAiStatus("AI_0", AIStatus::ONLINE));
+    ASSERT_TRUE(dbManager->updateAiStatus("AI_1", AIStatus::ONLINE));
+
+    QMap<int, ServerStats> stats = dbManager->getServerStats();
+    ASSERT_EQ(stats.size(), 2);
+    EXPECT_EQ(stats.value(1).totalCount, 5);
+    EXPECT_EQ(stats.value(1).onlineCount, 1);
+    EXPECT_DOUBLE_EQ(stats.value(1).averageLevel, 14.0);
+    EXPECT_DOUBLE_EQ(stats.value(2).loadPercentage, 20.0);
+
+    // 首次同步对账后由增量汇总应答，结果一致
+    performSync();
+    EXPECT_EQ(dbManager->getServerStats().value(1).totalCount, 5);
+    EXPECT_EQ(dbManager->getServerStats().value(2).onlineCount, 1);
+}
+
+TEST_F(DatabaseManagerTest, GroupCommittedStatusReachesDatabase) {
+    ASSERT_TRUE(dbManager->initialize(sqliteConfig()));
+
+    QMap<QString, AIPlayerData> batch;
+    batch.insert("AI_1", makePlayer(1, 10));
+    ASSERT_TRUE(dbManager->batchSyncAiData(batch));
+
+    ASSERT_TRUE(dbManager->updateAiStatus("AI_1", AIStatus::ONLINE));
+    QTRY_VERIFY_WITH_TIMEOUT(dbManager->getGroupCommitStats().flushes >= 1
+                             && dbManager->getGroupCommitStats().pending == 0, 5000);
+    EXPECT_EQ(dbManager->getGroupCommitStats().failedOperations, 0u);
+    EXPECT_EQ(dbManager->getServerStats().value(1).onlineCount, 1);
+}
+
+TEST_F(DatabaseManagerTest, ExecuteAsyncWithoutGroupCommit) {
+    DatabaseConfig config = sqliteConfig();
+    config.groupCommitEnabled = false;
+    config.writeBehindEnabled = false;
+    ASSERT_TRUE(dbManager->initialize(config));
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+
+    std::atomic<int> writeRows{ -1 };
+    DatabaseOperation update(DatabaseOperation::Type::Update, "UPDATE RAN_AI_Players SET level = ? WHERE ai_id = ?");
+    update.parameters = { { "level", "30" }, { "ai_id", "AI_1" } };
+    update.callback = [&writeRows](const QueryResult& result) {
+        writeRows = result.success ? result.affectedRows : 0;
+    };
+    ASSERT_TRUE(dbManager->executeAsync(update));
+    QTRY_COMPARE_WITH_TIMEOUT(writeRows.load(), 1, 5000);
+    QVector<AIPlayerData> players = dbManager->getAiList();
+    ASSERT_EQ(players.size(), 1);
+    EXPECT_EQ(players.first().level, 30);
+
+    // 查询不走分组提交，在工作线程上执行并返回结果行数
+    std::atomic<int> selectRows{ -1 };
+    DatabaseOperation select(DatabaseOperation::Type::Select, "SELECT ai_id FROM RAN_AI_Players WHERE server_id = ?");
+    select.parameters = { { "server_id", "1" } };
+    select.callback = [&selectRows](const QueryResult& result) {
+        selectRows = result.success ? result.affectedRows : 0;
+    };
+    ASSERT_TRUE(dbManager->executeAsync(select));
+    QTRY_COMPARE_WITH_TIMEOUT(selectRows.load(), 1, 5000);
+}
+
+TEST_F(DatabaseManagerTest, FailedAsyncWriteIsReported) {
+    DatabaseConfig config = sqliteConfig();
+    config.groupCommitEnabled = false;
+    ASSERT_TRUE(dbManager->initialize(config));
+    QSignalSpy failedSpy(dbManager.get(), &DatabaseManager::asyncWriteFailed);
+
+    std::atomic<bool> reported{ false };
+    std::atomic<bool> succeeded{ true };
+    DatabaseOperation insert(DatabaseOperation::Type::Insert, "INSERT INTO RAN_AI_Missing (ai_id) VALUES (?)");
+    insert.parameters = { { "ai_id", "AI_1" } };
+    insert.callback = [&](const QueryResult& result) {
+        succeeded = result.success;
+        reported = true;
+    };
+
+    ASSERT_TRUE(dbManager->executeAsync(insert));
+    QTRY_VERIFY_WITH_TIMEOUT(reported.load(), 5000);
+    EXPECT_FALSE(succeeded.load());
+    QTRY_COMPARE_WITH_TIMEOUT(failedSpy.count(), 1, 5000);
+    EXPECT_TRUE(failedSpy.at(0).at(0).toString().contains("RAN_AI_Missing"));
+}
+
+TEST_F(DatabaseManagerTest, ScanAiChangedSince) {
+    DatabaseConfig config = sqliteConfig();
+    config.writeBehindEnabled = false;
+    ASSERT_TRUE(dbManager->initialize(config));
+
+    const QDateTime before = QDateTime::currentDateTime().addSecs(-60);
+    ASSERT_TRUE(dbManager->syncAiData("AI_1", makePlayer(1, 10)));
+    ASSERT_TRUE(dbManager->syncAiData("AI_2", makePlayer(1, 11)));
+
+    QStringList seen;
+    int rows = dbManager->scanAiChangedSince(before, [&seen](const QString& aiId, const AIPlayerData&) {
+        seen << aiId;
+    });
+    EXPECT_EQ(rows, 2);
+    seen.sort();
+    EXPECT_EQ(seen, QStringList({ "AI_1", "AI_2" }));
+
+    dbManager->shutdown();
+    EXPECT_EQ(dbManager->scanAiChangedSince(before, [](const QString&, const AIPlayerData&) {}), -1);
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "Protocol.h"
+#include "SocketServer.h"
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+#include "EpollSocketServer.h"
+
+class EpollSocketServerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (int fd : m_clients) {
+            close(fd);
+        }
+    }
+
+    int connectClient(uint16_t port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        m_clients.push_back(fd);
+        return fd;
+    }
+
+    static bool sendAll(int fd, const std::vector<uint8_t>& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    static bool receiveAll(int fd, uint8_t* data, size_t size) {
+        size_t received = 0;
+        while (received < size) {
+            ssize_t count = recv(fd, data + received, size - received, 0);
+            if (count <= 0) {
+                return false;
+            }
+            received += static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    static std::unique_ptr<Message> receiveMessage(int fd) {
+        std::vector<uint8_t> frame(MessageHeader::SIZE);
+        if (!receiveAll(fd, frame.data(), frame.size())) {
+            return nullptr;
+        }
+        uint32_t length;
+        std::memcpy(&length, frame.data() + offsetof(MessageHeader, length), sizeof(length));
+        frame.resize(MessageHeader::SIZE + length);
+        if (!receiveAll(fd, frame.data() + MessageHeader::SIZE, length)) {
+            return nullptr;
+        }
+        auto message = std::make_unique<Message>(MessageType::SYSTEM_PING);
+        return message->deserialize(frame) ? std::move(message) : nullptr;
+    }
+
+    static std::vector<uint8_t> bytes(const std::string& text) {
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    std::vector<int> m_clients;
+};
+
+TEST_F(EpollSocketServerTest, MessageRoundTrip) {
+    Message original(MessageType::AI_CREATE);
+    original.setData(bytes("{\"school\":\"聖門\"}"));
+
+    Message decoded(MessageType::SYSTEM_PING);
+    ASSERT_TRUE(decoded.deserialize(original.serialize()));
+    EXPECT_EQ(decoded.getType(), MessageType::AI_CREATE);
+    EXPECT_EQ(decoded.getSequence(), original.getSequence());
+    EXPECT_EQ(decoded.getData(), original.getData());
+
+    // 负载被篡改时校验失败
+    std::vector<uint8_t> corrupted = original.serialize();
+    corrupted.back() ^= 0xFF;
+    EXPECT_FALSE(decoded.deserialize(corrupted));
+}
+
+TEST_F(EpollSocketServerTest, LoopbackEchoAndBroadcast) {
+    EpollSocketServer::Config config;
+    config.eventLoopCount = 2;
+    config.workerCount = 2;
+    EpollSocketServer server(config);
+
+    server.setConnectionMessageCallback([&server](uint64_t connectionId, std::unique_ptr<Message> message) {
+        Message reply(MessageType::RESPONSE_SUCCESS);
+        reply.setSequence(message->getSequence());
+        reply.setData(message->getData());
+        server.sendMessage(connectionId, reply);
+    });
+    ASSERT_TRUE(server.startServer(0));
+    ASSERT_NE(server.getPort(), 0);
+
+    int first = connectClient(server.getPort());
+    int second = connectClient(server.getPort());
+
+    // 每个客户端连续发送多条，回复顺序与请求一致
+    for (int fd : {first, second}) {
+        std::vector<uint32_t> sequences;
+        for (int i = 0; i < 20; ++i) {
+            Message request(MessageType::AI_QUERY);
+            request.setData(bytes("request-" + std::to_string(i)));
+            sequences.push_back(request.getSequence());
+            ASSERT_TRUE(sendAll(fd, request.serialize()));
+        }
+        for (int i = 0; i < 20; ++i) {
+            auto reply = receiveMessage(fd);
+            ASSERT_NE(reply, nullptr);
+            EXPECT_EQ(reply->getType(), MessageType::RESPONSE_SUCCESS);
+            EXPECT_EQ(reply->getSequence(), sequences[i]);
+            EXPECT_EQ(reply->getData(), bytes("request-" + std::to_string(i)));
+        }
+    }
+
+    // 广播共享同一帧缓冲，两个客户端都应收到
+    Message notice(MessageType::STATUS_SERVER_LOAD);
+    notice.setData(bytes("load"));
+    ASSERT_TRUE(server.sendMessage(notice));
+    for (int fd : {first, second}) {
+        auto received = receiveMessage(fd);
+        ASSERT_NE(received, nullptr);
+        EXPECT_EQ(received->getType(), MessageType::STATUS_SERVER_LOAD);
+    }
+
+    server.stop();
+}
+
+TEST_F(EpollSocketServerTest, OversizedFrameClosesConnection) {
+    EpollSocketServer::Config config;
+    config.eventLoopCount = 1;
+    config.maxFrameSize = 1024;
+    EpollSocketServer server(config);
+    ASSERT_TRUE(server.startServer(0));
+
+    int fd = connectClient(server.getPort());
+    Message large(MessageType::AI_UPDATE);
+    large.setData(std::vector<uint8_t>(4096, 'x'));
+    sendAll(fd, large.serialize());
+
+    // 服务器读到帧头即断开
+    uint8_t byte;
+    EXPECT_LE(recv(fd, &byte, 1, 0), 0);
+    server.stop();
+}
+
+TEST_F(EpollSocketServerTest, LargeBurstWithSmallReadBudget) {
+    EpollSocketServer::Config config;
+    config.eventLoopCount = 1;
+    config.readChunkSize = 512;
+    config.maxReadsPerWakeup = 1;
+    EpollSocketServer server(config);
+
+    std::atomic<int> received{0};
+    server.setMessageCallback([&received](std::unique_ptr<Message>) { received++; });
+    ASSERT_TRUE(server.startServer(0));
+
+    // 连续写入远超单轮读预算的数据，读预算用完后应在下一轮继续读取
+    int fd = connectClient(server.getPort());
+    std::vector<uint8_t> burst;
+    for (int i = 0; i < 500; ++i) {
+        Message message(MessageType::STATUS_AI_UPDATE);
+        message.setData(std::vector<uint8_t>(100, static_cast<uint8_t>(i)));
+        std::vector<uint8_t> frame = message.serialize();
+        burst.insert(burst.end(), frame.begin(), frame.end());
+    }
+    ASSERT_TRUE(sendAll(fd, burst));
+
+    for (int i = 0; i < 500 && received.load() < 500; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(received.load(), 500);
+    server.stop();
+}
+
+TEST_F(EpollSocketServerTest, BackendServerUsesCommunicationConfig) {
+    const QJsonObject communication = QJsonDocument::fromJson(R"({
+        "backend": {"port": 0, "eventLoops": 3, "workerThreads": 2},
+        "messages": {"maxMessageSize": 65536}
+    })").object();
+
+    SocketServer::Config config = SocketServer::Config::fromJson(communication);
+    EXPECT_EQ(config.port, 0);
+    EXPECT_EQ(config.eventLoops, 3);
+    EXPECT_EQ(config.workerThreads, 2);
+    EXPECT_EQ(config.maxMessageSize, 65536u);
+
+    SocketServer server;
+    ASSERT_TRUE(server.initialize(config));
+    ASSERT_TRUE(server.start());
+    auto stats = server.getStatistics();
+    EXPECT_EQ(stats["eventLoops"], 3u);
+    EXPECT_EQ(stats["workers"], 2u);
+
+    // 心跳由通信层直接应答
+    int fd = connectClient(server.getPort());
+    Message ping(MessageType::SYSTEM_PING);
+    ping.setData(bytes("ping"));
+    ASSERT_TRUE(sendAll(fd, ping.serialize()));
+    auto pong = receiveMessage(fd);
+    ASSERT_NE(pong, nullptr);
+    EXPECT_EQ(pong->getType(), MessageType::SYSTEM_PONG);
+    EXPECT_EQ(pong->getSequence(), ping.getSequence());
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+}
+
+#endif // __linux__
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <atomic>
+#include <memory>
+#include "GroupCommitPipeline.h"
+
+class GroupCommitPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 使用文件库，写入线程在自己的线程上打开连接
+        ASSERT_TRUE(tempDir.isValid());
+        dbPath = tempDir.filePath("group_commit.db");
+
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "group_commit_reader");
+            db.setDatabaseName(dbPath);
+            ASSERT_TRUE(db.open());
+
+            QSqlQuery query(db);
+            ASSERT_TRUE(query.exec("CREATE TABLE logs (ai_id TEXT, operation TEXT)"));
+            ASSERT_TRUE(query.exec("CREATE TABLE status (ai_id TEXT PRIMARY KEY, value INT)"));
+        }
+    }
+
+    void TearDown() override {
+        writer.reset();
+        QSqlDatabase::removeDatabase("group_commit_writer");
+        QSqlDatabase::database("group_commit_reader").close();
+        QSqlDatabase::removeDatabase("group_commit_reader");
+    }
+
+    std::unique_ptr<GroupCommitPipeline> makePipeline(int maxBatch, int maxDelayMs) {
+        return std::make_unique<GroupCommitPipeline>(
+            [this]() {
+                ++acquired;
+                if (!writer) {
+                    writer = std::make_shared<QSqlDatabase>(
+                        QSqlDatabase::addDatabase("QSQLITE", "group_commit_writer"));
+                    writer->setDatabaseName(dbPath);
+                    writer->open();
+                }
+                return writer;
+            },
+            [](std::shared_ptr<QSqlDatabase>) {},
+            maxBatch, maxDelayMs);
+    }
+
+    int count(const QString& table) {
+        QSqlQuery query(QSqlDatabase::database("group_commit_reader"));
+        query.exec("SELECT COUNT(*) FROM " + table);
+        query.next();
+        return query.value(0).toInt();
+    }
+
+    QTemporaryDir tempDir;
+    QString dbPath;
+    std::shared_ptr<QSqlDatabase> writer;
+    std::atomic<int> acquired{0};
+};
+
+TEST_F(GroupCommitPipelineTest, GroupsOperationsIntoOneCommit) {
+    auto pipeline = makePipeline(1000, 10000);
+    pipeline->start();
+
+    std::atomic<int> succeeded{0};
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)",
+                                     { QString("AI_%1").arg(i), "move" },
+                                     [&succeeded](bool success, const QString&) {
+                                         if (success) {
+                                             ++succeeded;
+                                         }
+                                     }));
+    }
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(pipeline->submit("INSERT INTO status (ai_id, value) VALUES (?, ?)",
+                                     { QString("AI_%1").arg(i), i }));
+    }
+
+    pipeline->stop();
+
+    GroupCommitStats stats = pipeline->stats();
+    EXPECT_EQ(succeeded.load(), 200);
+    EXPECT_EQ(stats.submitted, 250u);
+    EXPECT_EQ(stats.flushes, 1u);
+    EXPECT_EQ(stats.statements, 2u);
+    EXPECT_EQ(acquired.load(), 1);
+    EXPECT_EQ(count("logs"), 200);
+    EXPECT_EQ(count("status"), 50);
+}
+
+TEST_F(GroupCommitPipelineTest, FlushesWhenBatchIsFull) {
+    auto pipeline = makePipeline(10, 10000);
+    pipeline->start();
+
+    for (int i = 0; i < 35; ++i) {
+        pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)", { QString::number(i), "x" });
+    }
+    pipeline->stop();
+
+    EXPECT_GE(pipeline->stats().flushes, 3u);
+    EXPECT_EQ(count("logs"), 35);
+}
+
+TEST_F(GroupCommitPipelineTest, FailingStatementDoesNotFailOthers) {
+    auto pipeline = makePipeline(1000, 10000);
+    pipeline->start();
+
+    std::atomic<int> failed{0};
+    std::atomic<int> succeeded{0};
+    auto callback = [&](bool success, const QString&) {
+        success ? ++succeeded : ++failed;
+    };
+
+    pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)", { "AI_1", "move" }, callback);
+    pipeline->submit("INSERT INTO missing_table (a) VALUES (?)", { 1 }, callback);
+    pipeline->submit("INSERT INTO missing_table (a) VALUES (?)", { 2 }, callback);
+    pipeline->stop();
+
+    EXPECT_EQ(succeeded.load(), 1);
+    EXPECT_EQ(failed.load(), 2);
+    EXPECT_EQ(pipeline->stats().failedOperations, 2u);
+    EXPECT_EQ(count("logs"), 1);
+}
+
+TEST_F(GroupCommitPipelineTest, KeepsOrderAcrossDifferentStatements) {
+    auto pipeline = makePipeline(1000, 10000);
+    pipeline->start();
+
+    std::atomic<int> failed{0};
+    auto callback = [&failed](bool success, const QString&) {
+        if (!success) {
+            ++failed;
+        }
+    };
+
+    // 插入、删除、再插入同一主键：只有保持顺序才不会主键冲突
+    const QString insert = "INSERT INTO status (ai_id, value) VALUES (?, ?)";
+    pipeline->submit(insert, { "AI_1", 1 }, callback);
+    pipeline->submit(insert, { "AI_2", 1 }, callback);
+    pipeline->submit("DELETE FROM status WHERE ai_id = ?", { "AI_1" }, callback);
+    pipeline->submit(insert, { "AI_1", 2 }, callback);
+    pipeline->stop();
+
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(pipeline->stats().flushes, 1u);
+    EXPECT_EQ(pipeline->stats().statements, 3u);
+    EXPECT_EQ(count("status"), 2);
+
+    QSqlQuery query(QSqlDatabase::database("group_commit_reader"));
+    ASSERT_TRUE(query.exec("SELECT value FROM status WHERE ai_id = 'AI_1'"));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(query.value(0).toInt(), 2);
+}
+
+TEST_F(GroupCommitPipelineTest, RejectsMismatchedParameterCount) {
+    auto pipeline = makePipeline(1000, 10000);
+    pipeline->start();
+
+    EXPECT_TRUE(pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)", { "AI_1", "move" }));
+    EXPECT_FALSE(pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)", { "AI_2" }));
+    pipeline->stop();
+
+    EXPECT_FALSE(pipeline->submit("INSERT INTO logs (ai_id, operation) VALUES (?, ?)", { "AI_3", "x" }));
+    EXPECT_EQ(pipeline->stats().rejected, 2u);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QThread>
+#include <atomic>
+#include <cstring>
+#include "LinuxMetricsCollector.h"
+
+#ifdef Q_OS_LINUX
+
+class LinuxMetricsCollectorTest : public ::testing::Test {
+protected:
+    LinuxMetricsCollector collector;
+};
+
+TEST_F(LinuxMetricsCollectorTest, ReportsSystemMetrics) {
+    collector.sample();
+    QThread::msleep(100);
+    collector.sample();
+
+    EXPECT_GT(collector.memoryTotal(), 0u);
+    EXPECT_LE(collector.memoryUsed(), collector.memoryTotal());
+    EXPECT_GT(collector.processResidentMemory(), 0u);
+    EXPECT_GE(collector.systemCpuUsage(), 0.0);
+    EXPECT_LE(collector.systemCpuUsage(), 100.0);
+    EXPECT_GT(collector.diskUsage(), 0.0);
+    EXPECT_LE(collector.diskUsage(), 100.0);
+    EXPECT_GE(collector.threadCount(), 1);
+}
+
+TEST_F(LinuxMetricsCollectorTest, ReportsBusyWorkerThread) {
+    std::atomic<bool> stop{false};
+    QThread *worker = QThread::create([&stop]() {
+        volatile quint64 counter = 0;
+        while (!stop) {
+            counter = counter + 1;
+        }
+    });
+    worker->setObjectName("AIWorker-Test");
+    worker->start();
+    QThread::msleep(50);
+
+    collector.sample();
+    QThread::msleep(300);
+    collector.sample();
+
+    double workerCpu = -1.0;
+    for (int i = 0; i < collector.threadCount(); ++i) {
+        if (std::strcmp(collector.threadUsage(i).name, "AIWorker-Test") == 0) {
+            workerCpu = collector.threadUsage(i).cpuUsage;
+        }
+    }
+    EXPECT_GT(workerCpu, 10.0);
+    EXPECT_GT(collector.processCpuUsage(), 0.0);
+
+    stop = true;
+    worker->wait();
+    delete worker;
+
+    // 线程退出后下次采样不再报告
+    collector.sample();
+    for (int i = 0; i < collector.threadCount(); ++i) {
+        EXPECT_STRNE(collector.threadUsage(i).name, "AIWorker-Test");
+    }
+}
+
+TEST_F(LinuxMetricsCollectorTest, RescansWhenThreadIsReplaced) {
+    auto startWorker = [](const char *name, std::atomic<bool> &stop) {
+        QThread *worker = QThread::create([&stop]() {
+            while (!stop) {
+                QThread::msleep(5);
+            }
+        });
+        worker->setObjectName(name);
+        worker->start();
+        return worker;
+    };
+    auto reported = [this](const char *name) {
+        for (int i = 0; i < collector.threadCount(); ++i) {
+            if (std::strcmp(collector.threadUsage(i).name, name) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::atomic<bool> stopFirst{false};
+    QThread *first = startWorker("AIWorker-First", stopFirst);
+    QThread::msleep(50);
+    collector.sample();
+    collector.sample();
+    EXPECT_TRUE(reported("AIWorker-First"));
+
+    // 一个线程退出、另一个线程启动，采样时线程数不变
+    stopFirst = true;
+    first->wait();
+    delete first;
+    std::atomic<bool> stopSecond{false};
+    QThread *second = startWorker("AIWorker-Second", stopSecond);
+    QThread::msleep(50);
+
+    collector.sample();
+    collector.sample();
+    EXPECT_FALSE(reported("AIWorker-First"));
+    EXPECT_TRUE(reported("AIWorker-Second"));
+
+    stopSecond = true;
+    second->wait();
+    delete second;
+}
+
+#endif // Q_OS_LINUX
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -2,6 +2,9 @@
 #include <QApplication>
 #include <QTest>
 #include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QSet>
+#include <iostream>
 #include "LoadBalancer.h"
 
 class LoadBalancerTest : public ::testing::Test {
@@ -127,6 +130,227 @@ TEST_F(LoadBalancerTest, RequestCancellation) {
     EXPECT_FALSE(cancelledAgain);
 }
 
+TEST_F(LoadBalancerTest, DispatchesImmediatelyOnSubmit) {
+    QSignalSpy assignedSpy(loadBalancer.get(), &LoadBalancer::requestAssigned);
+    QSignalSpy completedSpy(loadBalancer.get(), &LoadBalancer::requestCompleted);
+    
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    QString requestId = loadBalancer->submitRequest(request);
+    
+    // 不等待定时器，提交返回时已分派
+    ASSERT_EQ(assignedSpy.count(), 1);
+    EXPECT_EQ(assignedSpy.at(0).at(0).toString(), requestId);
+    EXPECT_EQ(loadBalancer->getQueueSize(), 0);
+    
+    QString instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+    EXPECT_FALSE(instanceId.isEmpty());
+    
+    loadBalancer->handleRequestSuccess(requestId, instanceId, 12.0, "OK");
+    EXPECT_EQ(completedSpy.count(), 1);
+    EXPECT_EQ(loadBalancer->getAIInstance(instanceId).currentConnections, 0);
+}
+
+TEST_F(LoadBalancerTest, DispatchesWhenCapacityFrees) {
+    // 两个实例都满载，请求排队
+    loadBalancer->updateInstanceMetrics("AI_001", 10.0, 10.0, 100);
+    loadBalancer->updateInstanceMetrics("AI_002", 10.0, 10.0, 150);
+    
+    QSignalSpy assignedSpy(loadBalancer.get(), &LoadBalancer::requestAssigned);
+    
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    QString first = loadBalancer->submitRequest(request);
+    QString second = loadBalancer->submitRequest(request);
+    EXPECT_EQ(loadBalancer->getQueueSize(), 2);
+    EXPECT_EQ(assignedSpy.count(), 0);
+    
+    // 满载不等于不健康
+    EXPECT_EQ(loadBalancer->getHealthyAIInstances().size(), 2);
+    
+    // 实例上报空出一个连接，队首请求立即分派
+    loadBalancer->updateInstanceMetrics("AI_002", 10.0, 10.0, 149);
+    ASSERT_EQ(assignedSpy.count(), 1);
+    EXPECT_EQ(assignedSpy.at(0).at(0).toString(), first);
+    EXPECT_EQ(assignedSpy.at(0).at(1).toString(), "AI_002");
+    EXPECT_EQ(loadBalancer->getQueueSize(), 1);
+    
+    // 排队中的请求可直接取消
+    EXPECT_TRUE(loadBalancer->cancelRequest(second));
+    EXPECT_EQ(loadBalancer->getQueueSize(), 0);
+    EXPECT_TRUE(loadBalancer->getRequest(second).id.isEmpty());
+}
+
+TEST_F(LoadBalancerTest, FailedRequestIsRetried) {
+    QSignalSpy retrySpy(loadBalancer.get(), &LoadBalancer::requestRetrying);
+    QSignalSpy failedSpy(loadBalancer.get(), &LoadBalancer::requestFailed);
+    
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    request.maxRetries = 1;
+    QString requestId = loadBalancer->submitRequest(request);
+    
+    QString instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+    loadBalancer->handleRequestFailure(requestId, instanceId, "timeout");
+    EXPECT_EQ(retrySpy.count(), 1);
+    
+    // 重试请求已重新分派
+    instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+    ASSERT_FALSE(instanceId.isEmpty());
+    loadBalancer->handleRequestFailure(requestId, instanceId, "timeout");
+    EXPECT_EQ(failedSpy.count(), 1);
+    EXPECT_EQ(loadBalancer->getStatistics().failedRequests, 1);
+}
+
+TEST_F(LoadBalancerTest, PowerOfTwoChoicesIsDefaultAndAvoidsSlowInstance) {
+    EXPECT_EQ(loadBalancer->getCurrentAlgorithm(), LoadBalancer::Algorithm::PowerOfTwoChoices);
+    
+    // AI_002的近期延迟是AI_001的十倍，两者都空闲时应选AI_001
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    for (int i = 0; i < 4; ++i) {
+        QString requestId = loadBalancer->submitRequest(request);
+        QString instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+        loadBalancer->handleRequestSuccess(requestId, instanceId, instanceId == "AI_001" ? 10.0 : 100.0, QByteArray());
+    }
+    
+    int fast = 0;
+    for (int i = 0; i < 20; ++i) {
+        QString requestId = loadBalancer->submitRequest(request);
+        QString instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+        fast += instanceId == "AI_001" ? 1 : 0;
+        loadBalancer->handleRequestSuccess(requestId, instanceId, instanceId == "AI_001" ? 10.0 : 100.0, QByteArray());
+    }
+    EXPECT_GE(fast, 18);
+}
+
+TEST_F(LoadBalancerTest, ConsistentHashKeepsBotOnInstance) {
+    loadBalancer->setAlgorithm(LoadBalancer::Algorithm::ConsistentHash);
+    
+    auto route = [this](const QString &aiId) {
+        LoadBalancer::Request request;
+        request.type = "TEST";
+        request.affinityKey = aiId;
+        QString requestId = loadBalancer->submitRequest(request);
+        QString instanceId = loadBalancer->getRequest(requestId).assignedInstanceId;
+        loadBalancer->handleRequestSuccess(requestId, instanceId, 1.0, QByteArray());
+        return instanceId;
+    };
+    
+    QMap<QString, QString> before;
+    for (int i = 0; i < 300; ++i) {
+        const QString aiId = QString("BOT_%1").arg(i);
+        before[aiId] = route(aiId);
+        EXPECT_EQ(route(aiId), before[aiId]);
+    }
+    
+    // 新增实例后只有映射到新实例的键迁移
+    LoadBalancer::AIInstance instance3;
+    instance3.id = "AI_003";
+    instance3.isActive = true;
+    instance3.maxConnections = 100;
+    loadBalancer->addAIInstance(instance3);
+    
+    int moved = 0;
+    for (auto it = before.cbegin(); it != before.cend(); ++it) {
+        const QString now = route(it.key());
+        if (now != it.value()) {
+            EXPECT_EQ(now, "AI_003");
+            ++moved;
+        }
+    }
+    EXPECT_GT(moved, 0);
+    EXPECT_LT(moved, 150);
+}
+
+TEST_F(LoadBalancerTest, ConsistentHashSpillsWhenOverloaded) {
+    loadBalancer->setAlgorithm(LoadBalancer::Algorithm::ConsistentHash);
+    
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    request.affinityKey = "HOT_BOT";
+    
+    // 同一个键的请求持续占用连接，超过负载上限后溢出到另一个实例
+    QSet<QString> used;
+    for (int i = 0; i < 20; ++i) {
+        QString requestId = loadBalancer->submitRequest(request);
+        used.insert(loadBalancer->getRequest(requestId).assignedInstanceId);
+    }
+    EXPECT_EQ(used.size(), 2);
+}
+
+TEST_F(LoadBalancerTest, ConsistentHashBoundIgnoresUndispatchableLoad) {
+    loadBalancer->setAlgorithm(LoadBalancer::Algorithm::ConsistentHash);
+
+    // 停用实例上的连接不计入平均负载，否则上限被抬高，热点键不会溢出
+    LoadBalancer::AIInstance drained;
+    drained.id = "AI_003";
+    drained.isActive = false;
+    drained.isHealthy = true;
+    drained.maxConnections = 2000;
+    drained.currentConnections = 1000;
+    loadBalancer->addAIInstance(drained);
+
+    LoadBalancer::Request request;
+    request.type = "TEST";
+    request.affinityKey = "HOT_BOT";
+
+    QSet<QString> used;
+    for (int i = 0; i < 20; ++i) {
+        QString requestId = loadBalancer->submitRequest(request);
+        used.insert(loadBalancer->getRequest(requestId).assignedInstanceId);
+    }
+    EXPECT_EQ(used.size(), 2);
+    EXPECT_FALSE(used.contains("AI_003"));
+}
+
+TEST_F(LoadBalancerTest, DispatchLatencyWith10kQueued) {
+    const int queued = 10000;
+    
+    loadBalancer->updateInstanceHealth("AI_001", false);
+    loadBalancer->updateInstanceHealth("AI_002", false);
+    
+    LoadBalancer::Request request;
+    request.type = "BENCH";
+    
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < queued; ++i) {
+        loadBalancer->submitRequest(request);
+    }
+    const qint64 submitNs = timer.nsecsElapsed();
+    ASSERT_EQ(loadBalancer->getQueueSize(), queued);
+    
+    QStringList assigned;
+    QObject::connect(loadBalancer.get(), &LoadBalancer::requestAssigned,
+                     [&assigned](const QString &requestId, const QString &) { assigned.append(requestId); });
+    
+    // 实例恢复后立即填满其容量
+    loadBalancer->updateInstanceHealth("AI_001", true);
+    ASSERT_EQ(assigned.size(), 100);
+    
+    // 每完成一个请求立即分派队首请求，单次分派与队列长度无关
+    qint64 maxNs = 0;
+    timer.restart();
+    for (int i = 0; i < queued - 100; ++i) {
+        QElapsedTimer single;
+        single.start();
+        loadBalancer->handleRequestSuccess(assigned.at(i), "AI_001", 1.0, QByteArray());
+        maxNs = qMax(maxNs, single.nsecsElapsed());
+    }
+    const qint64 drainNs = timer.nsecsElapsed();
+    
+    EXPECT_EQ(assigned.size(), queued);
+    EXPECT_EQ(loadBalancer->getQueueSize(), 0);
+    
+    std::cout << "[ BENCH    ] submit " << queued << ": " << submitNs / 1000 / queued << " us/request, "
+              << "complete+dispatch: " << drainNs / 1000 / (queued - 100) << " us/request, max "
+              << maxNs / 1000 << " us" << std::endl;
+    
+    // 轮询实现下平均要等待50ms
+    EXPECT_LT(drainNs / (queued - 100), 1000000);
+}
+
 int main(int argc, char **argv) {
     QApplication app(argc, argv);
     ::testing::InitGoogleTest(&argc, argv);
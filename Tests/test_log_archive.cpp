@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "LogArchive.h"
+
+class LogArchiveTest : public ::testing::Test {
+protected:
+    static constexpr qint64 MS_PER_DAY = 24LL * 60 * 60 * 1000;
+
+    void SetUp() override {
+        ASSERT_TRUE(m_dir.isValid());
+        // 前天零点开始，跨两天写入
+        m_start = QDateTime(QDate::currentDate().addDays(-2), QTime(0, 0)).toMSecsSinceEpoch();
+    }
+
+    static LogEntry makeEntry(qint64 timestampMs, LogLevel level, const QString& message) {
+        LogEntry entry;
+        entry.timestamp = QDateTime::fromMSecsSinceEpoch(timestampMs);
+        entry.level = level;
+        entry.message = message;
+        entry.source = "Test";
+        return entry;
+    }
+
+    // 每分钟一条，共count条；每100条有一条连接失败，级别按DEBUG..CRITICAL循环
+    void fill(LogArchive& archive, int count) {
+        for (int i = 0; i < count; ++i) {
+            const QString message = i % 100 == 0
+                ? QString("connection failed to node_%1").arg(i % 7)
+                : QString("heartbeat ok from node_%1").arg(i % 7);
+            archive.append(makeEntry(m_start + qint64(i) * 60000, static_cast<LogLevel>(i % 5), message));
+        }
+    }
+
+    QTemporaryDir m_dir;
+    qint64 m_start = 0;
+};
+
+TEST_F(LogArchiveTest, TokenizeSplitsWordsAndHanCharacters) {
+    const QVector<QByteArray> tokens = LogArchive::tokenize("连接失败 Error_42, retry");
+
+    ASSERT_EQ(tokens.size(), 6);
+    EXPECT_EQ(tokens[0], QString("连").toUtf8());
+    EXPECT_EQ(tokens[3], QString("败").toUtf8());
+    EXPECT_EQ(tokens[4], QByteArray("error_42"));
+    EXPECT_EQ(tokens[5], QByteArray("retry"));
+}
+
+TEST_F(LogArchiveTest, KeywordLevelAndTimeQueries) {
+    LogArchive archive(m_dir.path());
+    ASSERT_TRUE(archive.open());
+    fill(archive, 2000);
+
+    // 2000分钟跨越两个自然日，按天切分
+    EXPECT_EQ(archive.segmentCount(), 2);
+
+    LogArchive::Query query;
+    query.keyword = "Connection Failed";
+    QVector<LogEntry> results = archive.search(query);
+    ASSERT_EQ(results.size(), 20);
+    EXPECT_GT(results.first().timestamp, results.last().timestamp);
+
+    // 前缀匹配后再做子串确认
+    query.keyword = "node_";
+    EXPECT_EQ(archive.search(query).size(), 2000);
+
+    // 关键词从词中间开始也能命中（封存分段和当前分段）
+    query.keyword = "ection fail";
+    EXPECT_EQ(archive.search(query).size(), 20);
+    query.keyword = "EARTBEAT";
+    EXPECT_EQ(archive.search(query).size(), 1980);
+    query.keyword = "ode_3";
+    EXPECT_EQ(archive.search(query).size(), 286);
+
+    query.keyword.clear();
+    query.minimumLevel = LogLevel::ERROR;
+    EXPECT_EQ(archive.search(query).size(), 800);
+
+    query.minimumLevel = LogLevel::DEBUG;
+    query.from = QDateTime::fromMSecsSinceEpoch(m_start + 60 * 60000);
+    query.to = QDateTime::fromMSecsSinceEpoch(m_start + 120 * 60000 - 1);
+    results = archive.search(query);
+    ASSERT_EQ(results.size(), 60);
+    EXPECT_EQ(results.first().timestamp.toMSecsSinceEpoch(), m_start + 119 * 60000);
+
+    query.limit = 5;
+    EXPECT_EQ(archive.search(query).size(), 5);
+}
+
+TEST_F(LogArchiveTest, ReopenLoadsSealedSegments) {
+    {
+        LogArchive archive(m_dir.path());
+        ASSERT_TRUE(archive.open());
+        fill(archive, 2000);
+    }
+
+    LogArchive archive(m_dir.path());
+    ASSERT_TRUE(archive.open());
+    EXPECT_EQ(archive.segmentCount(), 2);
+
+    LogArchive::Query query;
+    query.keyword = "failed";
+    query.minimumLevel = LogLevel::INFO;
+    EXPECT_EQ(archive.search(query).size(), 0);
+
+    query.minimumLevel = LogLevel::DEBUG;
+    EXPECT_EQ(archive.search(query).size(), 20);
+}
+
+TEST_F(LogArchiveTest, RecoversUnsealedSegment) {
+    {
+        LogArchive archive(m_dir.path());
+        ASSERT_TRUE(archive.open());
+        fill(archive, 100);
+    }
+
+    // 模拟崩溃：索引文件未生成，数据文件尾部有半条记录
+    QDir dir(m_dir.path());
+    const QStringList dataFiles = dir.entryList({ "*.log" }, QDir::Files);
+    ASSERT_EQ(dataFiles.size(), 1);
+    const QString dataPath = dir.filePath(dataFiles.first());
+    ASSERT_TRUE(QFile::remove(dataPath.left(dataPath.size() - 4) + ".idx"));
+    QFile file(dataPath);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("partial");
+    file.close();
+
+    LogArchive archive(m_dir.path());
+    ASSERT_TRUE(archive.open());
+
+    LogArchive::Query query;
+    query.keyword = "heartbeat";
+    EXPECT_EQ(archive.search(query).size(), 99);
+
+    archive.append(makeEntry(QDateTime::currentMSecsSinceEpoch(), LogLevel::CRITICAL, "raid boss crashed"));
+    query.keyword = "crash";
+    const QVector<LogEntry> results = archive.search(query);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.first().level, LogLevel::CRITICAL);
+}
+
+TEST_F(LogArchiveTest, RemovesExpiredSegments) {
+    LogArchive archive(m_dir.path(), LogArchive::DEFAULT_SEGMENT_BYTES, 1);
+    ASSERT_TRUE(archive.open());
+
+    archive.append(makeEntry(QDateTime::currentMSecsSinceEpoch() - 3 * MS_PER_DAY, LogLevel::INFO, "ancient"));
+    archive.append(makeEntry(QDateTime::currentMSecsSinceEpoch(), LogLevel::INFO, "recent"));
+
+    EXPECT_EQ(archive.segmentCount(), 1);
+    LogArchive::Query query;
+    query.keyword = "ancient";
+    EXPECT_TRUE(archive.search(query).isEmpty());
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include "LogPartitionStore.h"
+
+class LogPartitionStoreTest : public ::testing::Test {
+protected:
+    LogPartitionStore::LogRecord makeRecord(int index) {
+        LogPartitionStore::LogRecord record;
+        record.aiId = QString("AI_%1").arg(index);
+        record.operation = "move";
+        record.timestamp = QDateTime(QDate(2025, 6, 14), QTime(12, 0));
+        return record;
+    }
+};
+
+TEST_F(LogPartitionStoreTest, MissingBoundariesOnlyAppendAfterLast) {
+    QVector<QDate> existing = { QDate(2025, 6, 10), QDate(2025, 6, 11) };
+
+    QVector<QDate> missing = LogPartitionStore::missingBoundaries(existing, QDate(2025, 6, 9), QDate(2025, 6, 14));
+
+    ASSERT_EQ(missing.size(), 3);
+    EXPECT_EQ(missing.first(), QDate(2025, 6, 12));
+    EXPECT_EQ(missing.last(), QDate(2025, 6, 14));
+}
+
+TEST_F(LogPartitionStoreTest, MissingBoundariesWithoutExisting) {
+    QVector<QDate> missing = LogPartitionStore::missingBoundaries({}, QDate(2025, 6, 14), QDate(2025, 6, 17));
+
+    ASSERT_EQ(missing.size(), 4);
+    EXPECT_EQ(missing.first(), QDate(2025, 6, 14));
+    EXPECT_TRUE(LogPartitionStore::missingBoundaries({ QDate(2025, 6, 20) },
+                                                     QDate(2025, 6, 14), QDate(2025, 6, 17)).isEmpty());
+}
+
+TEST_F(LogPartitionStoreTest, ExpiredPartitionCountKeepsLastBoundary) {
+    QVector<QDate> boundaries = { QDate(2025, 6, 1), QDate(2025, 6, 2), QDate(2025, 6, 3), QDate(2025, 6, 4) };
+
+    EXPECT_EQ(LogPartitionStore::expiredPartitionCount(boundaries, QDate(2025, 5, 31)), 0);
+    EXPECT_EQ(LogPartitionStore::expiredPartitionCount(boundaries, QDate(2025, 6, 2)), 2);
+    EXPECT_EQ(LogPartitionStore::expiredPartitionCount(boundaries, QDate(2025, 7, 1)), 3);
+    EXPECT_EQ(LogPartitionStore::expiredPartitionCount({}, QDate(2025, 7, 1)), 0);
+}
+
+TEST_F(LogPartitionStoreTest, BufferDropsOldestWhenFull) {
+    LogPartitionStore store(10, 3);
+
+    for (int i = 0; i < 15; ++i) {
+        store.append(makeRecord(i));
+    }
+
+    LogPartitionStats stats = store.stats();
+    EXPECT_EQ(stats.buffered, 10);
+    EXPECT_EQ(stats.appended, 15u);
+    EXPECT_EQ(stats.droppedRows, 5u);
+}
+
+TEST_F(LogPartitionStoreTest, FailedFlushKeepsBufferedRows) {
+    LogPartitionStore store(100, 3);
+    for (int i = 0; i < 20; ++i) {
+        store.append(makeRecord(i));
+    }
+
+    // SQLite没有分区目录视图，刷写失败后日志应保留在缓冲中
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "log_partition_test");
+    db.setDatabaseName(":memory:");
+    ASSERT_TRUE(db.open());
+
+    EXPECT_EQ(store.flush(db), -1);
+
+    LogPartitionStats stats = store.stats();
+    EXPECT_EQ(stats.buffered, 20);
+    EXPECT_EQ(stats.failedFlushes, 1u);
+    EXPECT_EQ(stats.flushedRows, 0u);
+    EXPECT_FALSE(store.lastError().isEmpty());
+
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("log_partition_test");
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include "LogStore.h"
+
+class LogStoreTest : public ::testing::Test {
+protected:
+    static LogEntry makeEntry(int i, LogLevel level) {
+        LogEntry entry;
+        entry.timestamp = QDateTime::currentDateTime();
+        entry.level = level;
+        entry.message = QString::number(i);
+        entry.source = "Test";
+        return entry;
+    }
+
+    // 级别按DEBUG..CRITICAL循环
+    static void fill(LogStore& store, int count) {
+        for (int i = 0; i < count; ++i) {
+            store.append(makeEntry(i, static_cast<LogLevel>(i % 5)));
+        }
+    }
+};
+
+TEST_F(LogStoreTest, EvictsOldestBeyondCapacity) {
+    LogStore store(10000);
+    fill(store, 25000);
+
+    EXPECT_EQ(store.size(), 10000);
+    EXPECT_EQ(store.firstSequence(), 15000u);
+    EXPECT_EQ(store.endSequence(), 25000u);
+    for (quint64 sequence = store.firstSequence(); sequence < store.endSequence(); sequence += 997) {
+        EXPECT_EQ(store.at(sequence).message, QString::number(sequence));
+    }
+}
+
+TEST_F(LogStoreTest, LevelIndexTracksEviction) {
+    LogStore store(10000);
+    fill(store, 25000);
+
+    EXPECT_EQ(store.countAtLeast(LogLevel::DEBUG), 10000);
+    EXPECT_EQ(store.countAtLeast(LogLevel::WARNING), 6000);
+    EXPECT_EQ(store.countAtLeast(LogLevel::CRITICAL), 2000);
+
+    // 第一个ERROR及以上的是15003
+    EXPECT_EQ(store.sequenceAtLeast(LogLevel::ERROR, 0), 15003u);
+    EXPECT_EQ(store.at(store.sequenceAtLeast(LogLevel::ERROR, 1)).level, LogLevel::CRITICAL);
+
+    // 15002、15003、15004、15007、15008、15009
+    EXPECT_EQ(store.countAtLeastBefore(LogLevel::WARNING, 15010), 6);
+    EXPECT_EQ(store.countAtLeastBefore(LogLevel::DEBUG, 15010), 10);
+}
+
+TEST_F(LogStoreTest, SnapshotIsUnaffectedByLaterAppends) {
+    LogStore store(10000);
+    fill(store, 9000);
+
+    const LogStore::Snapshot snapshot = store.snapshot();
+    fill(store, 20000);
+
+    EXPECT_EQ(snapshot.firstSequence(), 0u);
+    EXPECT_EQ(snapshot.endSequence(), 9000u);
+    for (quint64 sequence = 0; sequence < 9000; sequence += 331) {
+        EXPECT_EQ(snapshot.at(sequence).message, QString::number(sequence));
+    }
+    EXPECT_EQ(snapshot.at(8999).message, "8999");
+}
+
+TEST_F(LogStoreTest, ClearKeepsSequencesIncreasing) {
+    LogStore store(100);
+    fill(store, 50);
+    store.clear();
+
+    EXPECT_EQ(store.size(), 0);
+    EXPECT_EQ(store.countAtLeast(LogLevel::INFO), 0);
+
+    const quint64 sequence = store.append(makeEntry(7, LogLevel::ERROR));
+    EXPECT_EQ(sequence, 50u);
+    EXPECT_EQ(store.at(sequence).message, "7");
+    EXPECT_EQ(store.countAtLeast(LogLevel::ERROR), 1);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
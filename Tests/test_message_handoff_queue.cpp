@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QString>
+#include <atomic>
+#include <thread>
+#include "MessageHandoffQueue.h"
+
+class MessageHandoffQueueTest : public ::testing::Test {
+protected:
+    MessageHandoffQueue<QString> queue;
+};
+
+TEST_F(MessageHandoffQueueTest, PopsInPushOrder) {
+    QString value;
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.tryPop(value));
+
+    queue.push("a");
+    queue.push("b");
+    queue.push("c");
+    EXPECT_FALSE(queue.isEmpty());
+
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, "a");
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, "b");
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, "c");
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(MessageHandoffQueueTest, UnconsumedElementsAreReleased) {
+    // 析构时释放未取出的节点（配合ASan检查）
+    auto local = std::make_unique<MessageHandoffQueue<QString>>();
+    for (int i = 0; i < 1000; ++i) {
+        local->push(QString::number(i));
+    }
+    QString value;
+    ASSERT_TRUE(local->tryPop(value));
+    local.reset();
+}
+
+TEST_F(MessageHandoffQueueTest, ProducerAndConsumerThreadsPreserveOrder) {
+    constexpr int kCount = 200000;
+    MessageHandoffQueue<int> numbers;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&numbers, &done]() {
+        for (int i = 0; i < kCount; ++i) {
+            numbers.push(i);
+        }
+        done = true;
+    });
+
+    // 消费者与生产者并发读取，序号必须连续
+    int expected = 0;
+    int value = -1;
+    while (expected < kCount) {
+        if (numbers.tryPop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else if (done && numbers.isEmpty()) {
+            break;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(expected, kCount);
+    EXPECT_FALSE(numbers.tryPop(value));
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -111,6 +111,25 @@ TEST_F(PerformanceMonitorTest, NetworkMetricsUpdate) {
     EXPECT_GE(metrics.networkBytesSent, initialSent);
 }
 
+TEST_F(PerformanceMonitorTest, SamplingKeepsReportedMetrics) {
+    // 采样得到的网卡和进程数据不覆盖上报的应用流量和AI引擎占用
+    perfMonitor->updateNetworkMetrics(1000, 2000);
+    perfMonitor->updateEngineMetrics(12.5, 4096);
+    perfMonitor->startMonitoring(100);
+    QTest::qWait(250);
+    
+    auto metrics = perfMonitor->getSystemMetrics();
+    EXPECT_EQ(metrics.networkBytesReceived, 1000u);
+    EXPECT_EQ(metrics.networkBytesSent, 2000u);
+#ifdef Q_OS_LINUX
+    EXPECT_GT(metrics.processMemoryUsage, 0u);
+#endif
+    
+    auto aiMetrics = perfMonitor->getAIMetrics();
+    EXPECT_DOUBLE_EQ(aiMetrics.aiCpuUsage, 12.5);
+    EXPECT_EQ(aiMetrics.aiMemoryUsage, 4096u);
+}
+
 int main(int argc, char **argv) {
     QApplication app(argc, argv);
     ::testing::InitGoogleTest(&argc, argv);
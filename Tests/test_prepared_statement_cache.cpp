@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "PreparedStatementCache.h"
+
+class PreparedStatementCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 使用SQLite内存数据库，不依赖SQL Server
+        db = QSqlDatabase::addDatabase("QSQLITE", "stmt_cache_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open());
+
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec("CREATE TABLE ai (ai_id TEXT PRIMARY KEY, level INT)"));
+    }
+
+    void TearDown() override {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("stmt_cache_test");
+    }
+
+    QSqlDatabase db;
+};
+
+TEST_F(PreparedStatementCacheTest, ReusesPreparedStatement) {
+    StatementCacheCounters counters;
+    PreparedStatementCache cache(db, 8, &counters);
+
+    const QString sql = "INSERT INTO ai (ai_id, level) VALUES (?, ?)";
+    for (int i = 0; i < 5; ++i) {
+        QSqlQuery* query = cache.acquire(sql);
+        ASSERT_NE(query, nullptr);
+        query->bindValue(0, QString("AI_%1").arg(i));
+        query->bindValue(1, i);
+        ASSERT_TRUE(query->exec());
+        cache.release(query);
+    }
+
+    StatementCacheStats stats = counters.snapshot();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 4u);
+    EXPECT_DOUBLE_EQ(stats.hitRate(), 0.8);
+    EXPECT_EQ(cache.size(), 1);
+
+    QSqlQuery count(db);
+    ASSERT_TRUE(count.exec("SELECT COUNT(*) FROM ai"));
+    ASSERT_TRUE(count.next());
+    EXPECT_EQ(count.value(0).toInt(), 5);
+}
+
+TEST_F(PreparedStatementCacheTest, EvictsLeastRecentlyUsed) {
+    PreparedStatementCache cache(db, 2);
+
+    const QString first = "SELECT level FROM ai WHERE ai_id = ?";
+    const QString second = "SELECT ai_id FROM ai WHERE level = ?";
+    const QString third = "SELECT COUNT(*) FROM ai";
+
+    ASSERT_NE(cache.acquire(first), nullptr);
+    ASSERT_NE(cache.acquire(second), nullptr);
+    ASSERT_NE(cache.acquire(first), nullptr);   // first变为最近使用
+    ASSERT_NE(cache.acquire(third), nullptr);   // 淘汰second
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.stats().evictions, 1u);
+
+    ASSERT_NE(cache.acquire(first), nullptr);
+    EXPECT_EQ(cache.stats().hits, 2u);
+}
+
+TEST_F(PreparedStatementCacheTest, PrepareFailureIsNotCached) {
+    PreparedStatementCache cache(db, 4);
+
+    EXPECT_EQ(cache.acquire("SELECT * FROM missing_table"), nullptr);
+    EXPECT_FALSE(cache.lastError().isEmpty());
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.stats().prepareFailures, 1u);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
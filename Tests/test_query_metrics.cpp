@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <thread>
+#include <vector>
+#include "QueryMetrics.h"
+
+class QueryMetricsTest : public ::testing::Test {
+protected:
+    static constexpr qint64 MS = 1000000;   // 纳秒
+};
+
+TEST_F(QueryMetricsTest, BucketsCoverValuesWithBoundedError) {
+    for (quint64 micros : { 0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456ull, 99999999ull }) {
+        const int index = LatencyHistogram::bucketIndex(micros);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, LatencyHistogram::BUCKETS);
+
+        const quint64 upper = LatencyHistogram::bucketUpperBound(index);
+        EXPECT_GE(upper, micros);
+        if (index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), micros);
+        }
+        if (micros >= 16) {
+            EXPECT_LE(static_cast<double>(upper - micros) / micros, 0.0625);
+        }
+    }
+}
+
+TEST_F(QueryMetricsTest, PercentilesReflectTail) {
+    LatencyHistogram histogram;
+
+    // 99个1ms加1个500ms：平均值约6ms，p50仍为1ms，最大值为500ms
+    for (int i = 0; i < 99; ++i) {
+        histogram.record(1000);
+    }
+    histogram.record(500000);
+
+    const LatencySummary summary = histogram.summary();
+    EXPECT_EQ(summary.count, 100u);
+    EXPECT_NEAR(summary.p50Ms, 1.0, 1.0 * 0.0625);
+    EXPECT_NEAR(summary.p99Ms, 1.0, 1.0 * 0.0625);
+    EXPECT_DOUBLE_EQ(summary.p999Ms, 500.0);
+    EXPECT_DOUBLE_EQ(summary.maxMs, 500.0);
+    EXPECT_NEAR(summary.meanMs, 5.99, 0.01);
+}
+
+TEST_F(QueryMetricsTest, RecordsPerStatementCounters) {
+    QueryMetrics metrics(1000, 8);
+
+    const QString select = "SELECT * FROM RAN_AI_Players WHERE ai_id = ?";
+    const QString update = "UPDATE RAN_AI_Players SET status = ? WHERE ai_id = ?";
+    metrics.record(select, 2 * MS, true, 1, 20);
+    metrics.record(select, 4 * MS, true, 1, 20);
+    metrics.record(update, 50 * MS, false, 0, 24);
+
+    const QueryMetricsSnapshot snapshot = metrics.snapshot();
+    ASSERT_EQ(snapshot.statements.size(), 2);
+    EXPECT_EQ(snapshot.overall.count, 3u);
+    EXPECT_EQ(snapshot.errors, 1u);
+
+    // 按总耗时降序
+    EXPECT_EQ(snapshot.statements[0].sql, update);
+    EXPECT_EQ(snapshot.statements[0].errors, 1u);
+    EXPECT_EQ(snapshot.statements[1].latency.count, 2u);
+    EXPECT_EQ(snapshot.statements[1].rows, 2u);
+    EXPECT_EQ(snapshot.statements[1].bytes, 40u);
+}
+
+TEST_F(QueryMetricsTest, SlowLogKeepsNewestShapesOnly) {
+    QueryMetrics metrics(10, 3);
+
+    metrics.record("SELECT 1", 1 * MS, true);
+    for (int i = 0; i < 5; ++i) {
+        metrics.record(QString("SELECT %1").arg(i), (20 + i) * MS, true, i,
+                       0, QVariantList{ QString("secret-%1").arg(i), 42, QVariant() });
+    }
+
+    const QueryMetricsSnapshot snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.slowQueries, 5u);
+    ASSERT_EQ(snapshot.slowLog.size(), 3);
+    EXPECT_EQ(snapshot.slowLog[0].sql, "SELECT 4");
+    EXPECT_EQ(snapshot.slowLog[2].sql, "SELECT 2");
+    EXPECT_EQ(snapshot.slowLog[0].parameterShape, "QString(8), int, NULL");
+    EXPECT_FALSE(snapshot.slowLog[0].parameterShape.contains("secret"));
+
+    metrics.reset();
+    EXPECT_TRUE(metrics.snapshot().slowLog.isEmpty());
+    EXPECT_EQ(metrics.snapshot().overall.count, 0u);
+}
+
+TEST_F(QueryMetricsTest, DistinctStatementsAreCapped) {
+    QueryMetrics metrics(1000, 4);
+
+    for (int i = 0; i < 600; ++i) {
+        metrics.record(QString("SELECT * FROM t WHERE id = %1").arg(i), MS, true);
+    }
+
+    const QueryMetricsSnapshot snapshot = metrics.snapshot(1000);
+    EXPECT_EQ(snapshot.statements.size(), 513);
+    EXPECT_EQ(snapshot.overall.count, 600u);
+
+    bool foundOther = false;
+    for (const StatementMetrics& statement : snapshot.statements) {
+        if (statement.sql == "<other>") {
+            foundOther = true;
+            EXPECT_EQ(statement.latency.count, 88u);
+        }
+    }
+    EXPECT_TRUE(foundOther);
+}
+
+TEST_F(QueryMetricsTest, ConcurrentRecordingLosesNothing) {
+    QueryMetrics metrics(1000, 4);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metrics, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                metrics.record(QString("Q%1").arg(i % 8), (t + 1) * 1000, true, 1);
+                metrics.recordPoolWait(500);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const QueryMetricsSnapshot snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.overall.count, 40000u);
+    EXPECT_EQ(snapshot.poolWait.count, 40000u);
+    EXPECT_EQ(snapshot.statements.size(), 8);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <set>
+#include "RequestCorrelator.h"
+
+class RequestCorrelatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        now = 1000;
+        correlator = std::make_unique<RequestCorrelator<int>>(10, [this]() { return now; });
+    }
+
+    void TearDown() override {
+        correlator.reset();
+    }
+
+    uint64_t now;
+    std::unique_ptr<RequestCorrelator<int>> correlator;
+};
+
+TEST_F(RequestCorrelatorTest, SequenceIdsAreUnique) {
+    // 同一毫秒内大量请求也不会冲突
+    std::set<uint64_t> ids;
+    for (int i = 0; i < 10000; ++i) {
+        ids.insert(correlator->registerRequest(std::chrono::milliseconds(1000), nullptr));
+    }
+    EXPECT_EQ(ids.size(), 10000u);
+    EXPECT_EQ(ids.count(0), 0u);
+    EXPECT_EQ(correlator->size(), 10000u);
+}
+
+TEST_F(RequestCorrelatorTest, CompleteInvokesCallback) {
+    CorrelationStatus status = CorrelationStatus::Cancelled;
+    int payload = 0;
+
+    uint64_t id = correlator->registerRequest(std::chrono::milliseconds(1000),
+        [&](CorrelationStatus s, int p) { status = s; payload = p; });
+
+    EXPECT_TRUE(correlator->complete(id, 42));
+    EXPECT_EQ(status, CorrelationStatus::Completed);
+    EXPECT_EQ(payload, 42);
+
+    // 重复响应应被忽略
+    EXPECT_FALSE(correlator->complete(id, 43));
+    EXPECT_EQ(payload, 42);
+    EXPECT_EQ(correlator->size(), 0u);
+}
+
+TEST_F(RequestCorrelatorTest, TimeoutNeverFiresEarly) {
+    bool timedOut = false;
+    correlator->registerRequest(std::chrono::milliseconds(5000),
+        [&](CorrelationStatus s, int) { timedOut = (s == CorrelationStatus::TimedOut); });
+
+    now += 4999;
+    EXPECT_EQ(correlator->expire(), 0u);
+    EXPECT_FALSE(timedOut);
+
+    now += 11;
+    EXPECT_EQ(correlator->expire(), 1u);
+    EXPECT_TRUE(timedOut);
+    EXPECT_EQ(correlator->size(), 0u);
+}
+
+TEST_F(RequestCorrelatorTest, LongTimeoutsCascadeThroughWheel) {
+    // 跨越多个时间轮层级的超时
+    std::vector<int64_t> timeouts = {5, 650, 41000, 2700000};
+    std::vector<uint64_t> firedAt(timeouts.size(), 0);
+    uint64_t start = now;
+
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        correlator->registerRequest(std::chrono::milliseconds(timeouts[i]),
+            [&, i](CorrelationStatus, int) { firedAt[i] = now; });
+    }
+
+    while (correlator->size() > 0) {
+        now += 7;
+        correlator->expire();
+    }
+
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        uint64_t elapsed = firedAt[i] - start;
+        EXPECT_GE(elapsed, static_cast<uint64_t>(timeouts[i]));
+        EXPECT_LE(elapsed, static_cast<uint64_t>(timeouts[i]) + 20);
+    }
+}
+
+TEST_F(RequestCorrelatorTest, CompletedRequestsDoNotTimeOut) {
+    int timeouts = 0;
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(correlator->registerRequest(std::chrono::milliseconds(100 + i),
+            [&](CorrelationStatus s, int) { if (s == CorrelationStatus::TimedOut) ++timeouts; }));
+    }
+
+    // 完成偶数请求
+    for (size_t i = 0; i < ids.size(); i += 2) {
+        EXPECT_TRUE(correlator->complete(ids[i], 1));
+    }
+
+    now += 5000;
+    EXPECT_EQ(correlator->expire(), 500u);
+    EXPECT_EQ(timeouts, 500);
+
+    // 超时后的响应为迟到响应
+    EXPECT_FALSE(correlator->complete(ids[1], 1));
+}
+
+TEST_F(RequestCorrelatorTest, FutureAndCancel) {
+    auto [id, future] = correlator->registerRequestFuture(std::chrono::milliseconds(1000));
+    EXPECT_TRUE(correlator->contains(id));
+
+    EXPECT_TRUE(correlator->cancel(id));
+    EXPECT_FALSE(correlator->contains(id));
+
+    auto result = future.get();
+    EXPECT_EQ(result.status, CorrelationStatus::Cancelled);
+
+    // 取消全部
+    for (int i = 0; i < 10; ++i) {
+        correlator->registerRequest(std::chrono::milliseconds(1000), nullptr);
+    }
+    EXPECT_EQ(correlator->cancelAll(), 10u);
+    EXPECT_EQ(correlator->size(), 0u);
+}
+
+TEST_F(RequestCorrelatorTest, ReRegisterWithSameId) {
+    // 超时重发沿用同一ID
+    uint64_t id = correlator->nextRequestId();
+    EXPECT_TRUE(correlator->registerRequestWithId(id, std::chrono::milliseconds(100), nullptr));
+    EXPECT_FALSE(correlator->registerRequestWithId(id, std::chrono::milliseconds(100), nullptr));
+
+    now += 200;
+    EXPECT_EQ(correlator->expire(), 1u);
+    EXPECT_TRUE(correlator->registerRequestWithId(id, std::chrono::milliseconds(100), nullptr));
+    EXPECT_TRUE(correlator->complete(id, 0));
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
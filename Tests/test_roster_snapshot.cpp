@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include "RosterSnapshot.h"
+
+class RosterSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        path = tempDir.filePath("roster.snapshot");
+
+        for (int i = 0; i < 100; ++i) {
+            RosterSnapshot::Entry entry;
+            entry.aiId = QString("AI_%1").arg(i, 5, 10, QChar('0'));
+            entry.name = QString("測試AI_%1").arg(i);
+            entry.school = i % 3;
+            entry.level = 1 + i;
+            entry.serverId = 1 + i % 4;
+            entry.aggression = i % 100;
+            entry.antiLag = (i % 2) == 0;
+            entry.status = i % 5;
+            entries.append(entry);
+        }
+    }
+
+    QTemporaryDir tempDir;
+    QString path;
+    QVector<RosterSnapshot::Entry> entries;
+};
+
+TEST_F(RosterSnapshotTest, RoundTrip) {
+    QDateTime capturedAt = QDateTime::fromMSecsSinceEpoch(1750000000000LL);
+    ASSERT_TRUE(RosterSnapshot::write(path, entries, capturedAt));
+
+    QVector<RosterSnapshot::Entry> loaded;
+    QDateTime loadedAt;
+    QString error;
+    ASSERT_TRUE(RosterSnapshot::read(path, loaded, loadedAt, &error)) << error.toStdString();
+
+    EXPECT_EQ(loadedAt.toMSecsSinceEpoch(), capturedAt.toMSecsSinceEpoch());
+    ASSERT_EQ(loaded.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(loaded[i].aiId, entries[i].aiId);
+        EXPECT_EQ(loaded[i].name, entries[i].name);
+        EXPECT_EQ(loaded[i].level, entries[i].level);
+        EXPECT_EQ(loaded[i].serverId, entries[i].serverId);
+        EXPECT_EQ(loaded[i].antiLag, entries[i].antiLag);
+        EXPECT_EQ(loaded[i].status, entries[i].status);
+    }
+}
+
+TEST_F(RosterSnapshotTest, EmptyRoster) {
+    ASSERT_TRUE(RosterSnapshot::write(path, {}, QDateTime::currentDateTimeUtc()));
+
+    QVector<RosterSnapshot::Entry> loaded;
+    QDateTime loadedAt;
+    EXPECT_TRUE(RosterSnapshot::read(path, loaded, loadedAt));
+    EXPECT_TRUE(loaded.isEmpty());
+}
+
+TEST_F(RosterSnapshotTest, RejectsCorruptedFile) {
+    ASSERT_TRUE(RosterSnapshot::write(path, entries, QDateTime::currentDateTimeUtc()));
+
+    // 翻转记录区的一个字节
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.seek(100);
+    char byte = 0;
+    file.getChar(&byte);
+    file.seek(100);
+    file.putChar(static_cast<char>(byte ^ 0x5A));
+    file.close();
+
+    QVector<RosterSnapshot::Entry> loaded;
+    QDateTime loadedAt;
+    QString error;
+    EXPECT_FALSE(RosterSnapshot::read(path, loaded, loadedAt, &error));
+    EXPECT_FALSE(error.isEmpty());
+}
+
+TEST_F(RosterSnapshotTest, RejectsTruncatedFile) {
+    ASSERT_TRUE(RosterSnapshot::write(path, entries, QDateTime::currentDateTimeUtc()));
+
+    QFile file(path);
+    ASSERT_TRUE(file.resize(file.size() - 10));
+
+    QVector<RosterSnapshot::Entry> loaded;
+    QDateTime loadedAt;
+    EXPECT_FALSE(RosterSnapshot::read(path, loaded, loadedAt));
+}
+
+TEST_F(RosterSnapshotTest, Crc32MatchesKnownValue) {
+    const QByteArray data("123456789");
+    EXPECT_EQ(RosterSnapshot::crc32(reinterpret_cast<const uchar*>(data.constData()), data.size()),
+              0xCBF43926u);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "RowCursor.h"
+
+class RowCursorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = QSqlDatabase::addDatabase("QSQLITE", "row_cursor_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open());
+
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec("CREATE TABLE ai (ai_id TEXT, name TEXT, level INT, ratio REAL, anti_lag INT)"));
+        ASSERT_TRUE(query.exec("INSERT INTO ai VALUES ('AI_1', '聖門劍士', 10, 0.5, 1)"));
+        ASSERT_TRUE(query.exec("INSERT INTO ai VALUES ('AI_2', NULL, 20, 1.5, 0)"));
+        ASSERT_TRUE(query.exec("INSERT INTO ai VALUES ('AI_3', '玄巖弓手', 30, 2.5, 1)"));
+    }
+
+    void TearDown() override {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("row_cursor_test");
+    }
+
+    QVector<ColumnSpec> columns() const {
+        return {
+            { "name" },
+            { "level" },
+            { "ratio" },
+            { "anti_lag" }
+        };
+    }
+
+    QSqlDatabase db;
+};
+
+TEST_F(RowCursorTest, CursorReadsByOrdinal) {
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    ASSERT_TRUE(query.exec("SELECT anti_lag, ratio, level, name FROM ai ORDER BY ai_id"));
+
+    RowCursor cursor(query);
+    ASSERT_TRUE(cursor.bind(columns()));
+
+    ASSERT_TRUE(cursor.next());
+    EXPECT_EQ(cursor.stringAt(0), QString("聖門劍士"));
+    EXPECT_EQ(cursor.intAt(1), 10);
+    EXPECT_DOUBLE_EQ(cursor.doubleAt(2), 0.5);
+    EXPECT_TRUE(cursor.boolAt(3));
+
+    ASSERT_TRUE(cursor.next());
+    EXPECT_TRUE(cursor.isNull(0));
+}
+
+TEST_F(RowCursorTest, BindReportsMissingColumn) {
+    QSqlQuery query(db);
+    ASSERT_TRUE(query.exec("SELECT name FROM ai"));
+
+    RowCursor cursor(query);
+    EXPECT_FALSE(cursor.bind({ { "name" }, { "missing" } }));
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
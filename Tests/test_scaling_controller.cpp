@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <cmath>
+#include "ScalingController.h"
+
+class ScalingControllerTest : public ::testing::Test {
+protected:
+    static constexpr qint64 START_MS = 1000000;
+    static constexpr qint64 INTERVAL_MS = 250;
+
+    static ScalingController::Sample makeSample(qint64 timestampMs, int instances, double arrivalRate,
+                                                double serviceTimeMs, int queueDepth = 0,
+                                                double p95LatencyMs = 100.0, double cpuUsage = 10.0) {
+        ScalingController::Sample sample;
+        sample.timestampMs = timestampMs;
+        sample.instances = instances;
+        sample.queueDepth = queueDepth;
+        sample.inFlight = static_cast<int>(arrivalRate * serviceTimeMs / 1000.0);
+        sample.arrivalRate = arrivalRate;
+        sample.p95LatencyMs = p95LatencyMs;
+        sample.serviceTimeMs = serviceTimeMs;
+        sample.cpuUsage = cpuUsage;
+        return sample;
+    }
+
+    // 团战开始：10秒平稳的100请求/秒，随后15秒内每秒增加100请求/秒
+    static QVector<ScalingController::Sample> raidRampTrace() {
+        QVector<ScalingController::Sample> trace;
+        qint64 now = START_MS;
+        for (int i = 0; i < 40; ++i, now += INTERVAL_MS) {
+            trace.append(makeSample(now, 1, 100.0, 200.0));
+        }
+        for (int i = 1; i <= 60; ++i, now += INTERVAL_MS) {
+            trace.append(makeSample(now, 1, 100.0 + 100.0 * i * INTERVAL_MS / 1000.0, 200.0));
+        }
+        return trace;
+    }
+};
+
+TEST_F(ScalingControllerTest, RaidRampScalesUpAheadOfLoad) {
+    const ScalingController::Config config;
+    const QVector<ScalingController::Sample> trace = raidRampTrace();
+    const QVector<ScalingController::Decision> decisions = ScalingController::replay(config, trace);
+
+    ASSERT_FALSE(decisions.isEmpty());
+    EXPECT_EQ(decisions.first().reason, ScalingController::Reason::ForecastLoad);
+    EXPECT_EQ(decisions.first().fromInstances, 1);
+
+    // 首次扩容时实际负载仍在单实例容量内，扩容由趋势触发
+    for (const auto &sample : trace) {
+        if (sample.timestampMs == decisions.first().timestampMs) {
+            EXPECT_LT(sample.inFlight, config.instanceCapacity * config.targetUtilization);
+        }
+    }
+
+    // 按回放决策模拟实例数，整个爬坡过程没有任何时刻超过总容量
+    int instances = 1;
+    int next = 0;
+    int overloaded = 0;
+    for (const auto &sample : trace) {
+        if (next < decisions.size() && decisions[next].timestampMs == sample.timestampMs) {
+            instances = decisions[next++].toInstances;
+        }
+        if (sample.inFlight > instances * config.instanceCapacity) {
+            overloaded++;
+        }
+    }
+    EXPECT_EQ(overloaded, 0);
+    EXPECT_GE(decisions.last().toInstances, 5);
+    EXPECT_LE(decisions.last().toInstances, config.maxInstances);
+}
+
+TEST_F(ScalingControllerTest, ReplayIsDeterministic) {
+    const QVector<ScalingController::Sample> trace = raidRampTrace();
+    const QVector<ScalingController::Decision> first = ScalingController::replay(ScalingController::Config(), trace);
+    const QVector<ScalingController::Decision> second = ScalingController::replay(ScalingController::Config(), trace);
+
+    ASSERT_EQ(first.size(), second.size());
+    for (int i = 0; i < first.size(); ++i) {
+        EXPECT_EQ(first[i].timestampMs, second[i].timestampMs);
+        EXPECT_EQ(first[i].toInstances, second[i].toInstances);
+        EXPECT_EQ(first[i].reason, second[i].reason);
+        EXPECT_DOUBLE_EQ(first[i].forecastRate, second[i].forecastRate);
+    }
+}
+
+TEST_F(ScalingControllerTest, ScaleUpRespectsCooldown) {
+    // 持续超出延迟目标：每个冷却期只扩容一个实例
+    QVector<ScalingController::Sample> trace;
+    for (qint64 now = START_MS; now < START_MS + 12000; now += INTERVAL_MS) {
+        trace.append(makeSample(now, 1, 10.0, 100.0, 0, 800.0));
+    }
+
+    const QVector<ScalingController::Decision> decisions = ScalingController::replay(ScalingController::Config(), trace);
+    ASSERT_EQ(decisions.size(), 3);
+    EXPECT_EQ(decisions[0].timestampMs, START_MS);
+    EXPECT_EQ(decisions[1].timestampMs, START_MS + 5000);
+    EXPECT_EQ(decisions[2].timestampMs, START_MS + 10000);
+    for (const auto &decision : decisions) {
+        EXPECT_EQ(decision.reason, ScalingController::Reason::LatencySlo);
+        EXPECT_EQ(decision.toInstances, decision.fromInstances + 1);
+    }
+}
+
+TEST_F(ScalingControllerTest, ScaleDownWaitsForStableLowLoad) {
+    // 3个实例只需1个；20秒处的短暂积压重新开始计算低负载时间
+    QVector<ScalingController::Sample> trace;
+    for (qint64 now = START_MS; now < START_MS + 180000; now += INTERVAL_MS) {
+        const int queueDepth = now == START_MS + 20000 ? 5 : 0;
+        trace.append(makeSample(now, 3, 50.0, 200.0, queueDepth));
+    }
+
+    const QVector<ScalingController::Decision> decisions = ScalingController::replay(ScalingController::Config(), trace);
+    ASSERT_EQ(decisions.size(), 2);
+
+    EXPECT_EQ(decisions[0].reason, ScalingController::Reason::LowLoad);
+    EXPECT_EQ(decisions[0].timestampMs, START_MS + 20250 + 30000);
+    EXPECT_EQ(decisions[0].toInstances, 2);
+
+    // 第二次缩容还需等待缩容冷却期，之后到达最少实例数不再缩容
+    EXPECT_EQ(decisions[1].timestampMs, decisions[0].timestampMs + 60000);
+    EXPECT_EQ(decisions[1].toInstances, 1);
+}
+
+TEST_F(ScalingControllerTest, QueueBacklogAddsInstances) {
+    ScalingController controller;
+    ScalingController::Sample sample = makeSample(START_MS, 1, 10.0, 100.0, 200);
+    sample.inFlight = 70;
+
+    const ScalingController::Decision decision = controller.observe(sample);
+    EXPECT_EQ(decision.reason, ScalingController::Reason::QueueBacklog);
+    EXPECT_EQ(decision.desiredInstances, 4);
+    EXPECT_EQ(decision.toInstances, 4);
+    EXPECT_TRUE(decision.description().startsWith("queue-backlog"));
+}
+
+TEST_F(ScalingControllerTest, TraceRoundTrip) {
+    const ScalingController::Sample sample = makeSample(START_MS, 3, 123.5, 80.25, 7, 412.5, 55.5);
+
+    const QString text = ScalingController::traceHeader() + "\n"
+        + "# recorded on raid night\n"
+        + ScalingController::toTraceLine(sample) + "\n";
+    const QVector<ScalingController::Sample> parsed = ScalingController::parseTrace(text);
+
+    ASSERT_EQ(parsed.size(), 1);
+    EXPECT_EQ(parsed[0].timestampMs, sample.timestampMs);
+    EXPECT_EQ(parsed[0].instances, 3);
+    EXPECT_EQ(parsed[0].queueDepth, 7);
+    EXPECT_EQ(parsed[0].inFlight, sample.inFlight);
+    EXPECT_DOUBLE_EQ(parsed[0].arrivalRate, 123.5);
+    EXPECT_DOUBLE_EQ(parsed[0].p95LatencyMs, 412.5);
+    EXPECT_DOUBLE_EQ(parsed[0].serviceTimeMs, 80.25);
+    EXPECT_DOUBLE_EQ(parsed[0].cpuUsage, 55.5);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
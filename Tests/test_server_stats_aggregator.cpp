@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "ServerStatsAggregator.h"
+
+class ServerStatsAggregatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = QSqlDatabase::addDatabase("QSQLITE", "server_stats_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open());
+
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec("CREATE TABLE RAN_AI_Players (ai_id TEXT PRIMARY KEY, server_id INT, level INT, status INT)"));
+    }
+
+    void TearDown() override {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("server_stats_test");
+    }
+
+    void insertPlayer(const QString& aiId, int serverId, int level, int status) {
+        QSqlQuery query(db);
+        query.prepare("INSERT OR REPLACE INTO RAN_AI_Players VALUES (?, ?, ?, ?)");
+        query.addBindValue(aiId);
+        query.addBindValue(serverId);
+        query.addBindValue(level);
+        query.addBindValue(status);
+        ASSERT_TRUE(query.exec());
+    }
+
+    QSqlDatabase db;
+};
+
+TEST_F(ServerStatsAggregatorTest, IncrementalUpdatesMaintainAggregates) {
+    ServerStatsAggregator aggregator;
+
+    aggregator.upsertPlayer("AI_1", 1, 10);
+    aggregator.upsertPlayer("AI_2", 1, 20);
+    aggregator.upsertPlayer("AI_3", 2, 30);
+    aggregator.setStatus("AI_1", 1);
+    aggregator.setStatus("AI_3", 1);
+
+    QMap<int, ServerAggregate> stats = aggregator.snapshot();
+    ASSERT_EQ(stats.size(), 2);
+    EXPECT_EQ(stats[1].totalCount, 2);
+    EXPECT_EQ(stats[1].onlineCount, 1);
+    EXPECT_DOUBLE_EQ(stats[1].averageLevel, 15.0);
+
+    // 换服、升级、删除都只调整受影响的服务器
+    aggregator.upsertPlayer("AI_1", 2, 40);
+    aggregator.removePlayer("AI_3");
+
+    stats = aggregator.snapshot();
+    EXPECT_EQ(stats[1].totalCount, 1);
+    EXPECT_EQ(stats[1].onlineCount, 0);
+    EXPECT_EQ(stats[2].totalCount, 1);
+    EXPECT_EQ(stats[2].onlineCount, 1);
+    EXPECT_DOUBLE_EQ(stats[2].averageLevel, 40.0);
+}
+
+TEST_F(ServerStatsAggregatorTest, ReconcileLoadsAndCorrectsDrift) {
+    insertPlayer("AI_1", 1, 10, 1);
+    insertPlayer("AI_2", 1, 20, 0);
+
+    ServerStatsAggregator aggregator;
+    EXPECT_FALSE(aggregator.isReady());
+    EXPECT_TRUE(aggregator.reconcileDue(60000));
+
+    aggregator.beginReconcile();
+    ASSERT_TRUE(aggregator.finishReconcile(db));
+    EXPECT_TRUE(aggregator.isReady());
+    EXPECT_FALSE(aggregator.reconcileDue(60000));
+    EXPECT_EQ(aggregator.snapshot()[1].onlineCount, 1);
+
+    // 绕过聚合器的写入在下次对账时被纠正
+    insertPlayer("AI_3", 3, 5, 1);
+    aggregator.beginReconcile();
+    ASSERT_TRUE(aggregator.finishReconcile(db));
+
+    EXPECT_EQ(aggregator.snapshot()[3].totalCount, 1);
+    EXPECT_EQ(aggregator.stats().driftedServers, 1u);
+    EXPECT_EQ(aggregator.stats().trackedPlayers, 3);
+}
+
+TEST_F(ServerStatsAggregatorTest, UpdatesDuringReconcileWinOverScan) {
+    insertPlayer("AI_1", 1, 10, 0);
+    insertPlayer("AI_2", 1, 20, 0);
+
+    ServerStatsAggregator aggregator;
+    aggregator.beginReconcile();
+
+    // 扫描看到的是旧数据，扫描开始后的修改应保留
+    aggregator.upsertPlayer("AI_1", 2, 50);
+    aggregator.removePlayer("AI_2");
+    ASSERT_TRUE(aggregator.finishReconcile(db));
+
+    QMap<int, ServerAggregate> stats = aggregator.snapshot();
+    EXPECT_FALSE(stats.contains(1));
+    EXPECT_EQ(stats[2].totalCount, 1);
+    EXPECT_DOUBLE_EQ(stats[2].averageLevel, 50.0);
+}
+
+TEST_F(ServerStatsAggregatorTest, InvalidateAndFailedScanRequestReconcile) {
+    ServerStatsAggregator aggregator;
+    aggregator.beginReconcile();
+    ASSERT_TRUE(aggregator.finishReconcile(db));
+    EXPECT_FALSE(aggregator.reconcileDue(60000));
+
+    aggregator.invalidate();
+    EXPECT_TRUE(aggregator.reconcileDue(60000));
+
+    QSqlQuery query(db);
+    ASSERT_TRUE(query.exec("DROP TABLE RAN_AI_Players"));
+    aggregator.beginReconcile();
+    EXPECT_FALSE(aggregator.finishReconcile(db));
+    EXPECT_TRUE(aggregator.reconcileDue(60000));
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QHash>
+#include <QMutex>
+#include "AIEngine.h"
+#include "ShardedRosterLoader.h"
+
+// 内存名册：按ai_id有序存放，可指定分片先失败若干次（失败前已送出一半行）
+class FakeRosterLoader : public ShardedRosterLoader {
+public:
+    FakeRosterLoader() : ShardedRosterLoader(nullptr) {}
+    ~FakeRosterLoader() override { waitForFinished(); }
+
+    void addServer(int serverId, int count) {
+        for (int i = 0; i < count; ++i) {
+            m_roster[serverId] << QString("S%1_AI_%2").arg(serverId).arg(i, 4, 10, QChar('0'));
+        }
+    }
+
+    // fromAiId为空表示服务器的首个分片
+    void failShard(int serverId, const QString& fromAiId, int times) {
+        m_failures[QString("%1|%2").arg(serverId).arg(fromAiId)] = times;
+    }
+
+    int scans() const { return m_scans.load(); }
+
+protected:
+    QMap<int, int> countRowsByServer() override {
+        QMap<int, int> counts;
+        for (auto it = m_roster.constBegin(); it != m_roster.constEnd(); ++it) {
+            counts[it.key()] = it.value().size();
+        }
+        return counts;
+    }
+
+    QStringList keyBoundaries(int serverId, int parts) override {
+        const QStringList& ids = m_roster[serverId];
+        QStringList bounds;
+        for (int i = 0; i < parts; ++i) {
+            bounds << ids.at(i * ids.size() / parts);
+        }
+        return bounds;
+    }
+
+    int scanShard(int serverId, const QString& fromAiId, const QString& toAiId, const RowSink& sink) override {
+        ++m_scans;
+        QStringList rows;
+        for (const QString& aiId : m_roster[serverId]) {
+            if ((fromAiId.isEmpty() || aiId >= fromAiId) && (toAiId.isEmpty() || aiId < toAiId)) {
+                rows << aiId;
+            }
+        }
+
+        bool fail = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            int& remaining = m_failures[QString("%1|%2").arg(serverId).arg(fromAiId)];
+            if (remaining > 0) {
+                --remaining;
+                fail = true;
+            }
+        }
+
+        const int count = fail ? rows.size() / 2 : rows.size();
+        for (int i = 0; i < count; ++i) {
+            AIPlayerData playerData;
+            playerData.serverId = serverId;
+            sink(rows.at(i), playerData);
+        }
+        return fail ? -1 : count;
+    }
+
+private:
+    QMap<int, QStringList> m_roster;
+    QMutex m_mutex;
+    QHash<QString, int> m_failures;
+    std::atomic<int> m_scans{0};
+};
+
+class ShardedRosterLoaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_loader.addServer(1, 100);
+        m_loader.addServer(2, 30);
+        m_loader.setTargetShardRows(25);
+        m_loader.setRetryPolicy(2, 1);
+
+        // 信号在工作线程上发出，直接连接并加锁记录
+        QObject::connect(&m_loader, &ShardedRosterLoader::serverReady, [this](int serverId, int rows) {
+            QMutexLocker locker(&m_mutex);
+            m_ready[serverId] = rows;
+        });
+        QObject::connect(&m_loader, &ShardedRosterLoader::serverFailed, [this](int serverId, int failedParts) {
+            QMutexLocker locker(&m_mutex);
+            m_failed[serverId] = failedParts;
+        });
+        QObject::connect(&m_loader, &ShardedRosterLoader::loadFinished, [this](int rows, int failedShards, qint64) {
+            QMutexLocker locker(&m_mutex);
+            m_finishedRows = rows;
+            m_failedShards = failedShards;
+        });
+    }
+
+    bool load() {
+        return m_loader.start([this](const QString& aiId, const AIPlayerData&) {
+            QMutexLocker locker(&m_mutex);
+            m_delivered[aiId]++;
+        }) && m_loader.waitForFinished(10000);
+    }
+
+    FakeRosterLoader m_loader;
+    QMutex m_mutex;
+    QHash<QString, int> m_delivered;
+    QHash<int, int> m_ready;
+    QHash<int, int> m_failed;
+    int m_finishedRows = -1;
+    int m_failedShards = -1;
+};
+
+TEST_F(ShardedRosterLoaderTest, LoadsAllShardsAndReportsEachServerOnce) {
+    ASSERT_TRUE(load());
+
+    EXPECT_EQ(m_delivered.size(), 130);
+    EXPECT_EQ(m_ready.value(1), 100);
+    EXPECT_EQ(m_ready.value(2), 30);
+    EXPECT_TRUE(m_failed.isEmpty());
+    EXPECT_EQ(m_finishedRows, 130);
+    EXPECT_EQ(m_failedShards, 0);
+    EXPECT_EQ(m_loader.scans(), 4 + 2);
+}
+
+TEST_F(ShardedRosterLoaderTest, RetriesFailedShardWithoutDuplicateRows) {
+    // 服务器1的第二个分片前两次读到一半失败
+    m_loader.failShard(1, "S1_AI_0025", 2);
+
+    ASSERT_TRUE(load());
+
+    EXPECT_EQ(m_loader.scans(), 4 + 2 + 2);
+    EXPECT_EQ(m_delivered.size(), 130);
+    for (auto it = m_delivered.constBegin(); it != m_delivered.constEnd(); ++it) {
+        EXPECT_EQ(it.value(), 1) << it.key().toStdString();
+    }
+    EXPECT_EQ(m_ready.value(1), 100);
+    EXPECT_TRUE(m_loader.isServerReady(1));
+    EXPECT_EQ(m_failedShards, 0);
+}
+
+TEST_F(ShardedRosterLoaderTest, ShardFailingPastRetriesKeepsServerNotReady) {
+    m_loader.failShard(1, QString(), 10);
+
+    ASSERT_TRUE(load());
+
+    // 首个分片共尝试1 + 2次，服务器1不就绪，服务器2不受影响
+    EXPECT_EQ(m_loader.scans(), 4 + 2 + 2);
+    EXPECT_FALSE(m_ready.contains(1));
+    EXPECT_FALSE(m_loader.isServerReady(1));
+    EXPECT_EQ(m_failed.value(1), 1);
+    EXPECT_EQ(m_ready.value(2), 30);
+    EXPECT_TRUE(m_loader.isServerReady(2));
+    EXPECT_EQ(m_failedShards, 1);
+    EXPECT_EQ(m_finishedRows, 130 - 25);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
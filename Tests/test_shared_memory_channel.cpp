@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "NetworkFrame.h"
+#include "SharedMemoryChannel.h"
+#include "SocketServer.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+class SharedMemoryChannelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_name = "ranonline_test_" + std::to_string(getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        shm_unlink(("/" + m_name).c_str());
+    }
+
+    static std::vector<uint8_t> bytes(const std::string& text) {
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    // 段布局：64字节段头，随后是下行环、上行环；每个环为192字节控制块加数据区
+    static constexpr size_t SEGMENT_HEADER = 64;
+    static constexpr size_t RING_HEADER = 192;
+
+    std::string m_name;
+};
+
+TEST_F(SharedMemoryChannelTest, ServerClientRoundTrip) {
+    SharedMemoryChannel server;
+    SharedMemoryChannel client;
+    ASSERT_TRUE(server.create(m_name, 4096));
+    ASSERT_TRUE(client.open(m_name));
+    EXPECT_TRUE(server.isPeerAttached());
+    EXPECT_TRUE(client.isPeerAttached());
+
+    std::vector<uint8_t> record;
+    ASSERT_TRUE(client.write("request", 7));
+    ASSERT_TRUE(server.read(record, 1000));
+    EXPECT_EQ(record, bytes("request"));
+
+    // 跨越环尾的记录也能完整读出
+    for (int i = 0; i < 100; ++i) {
+        std::vector<uint8_t> payload(300, static_cast<uint8_t>(i));
+        ASSERT_TRUE(server.write(payload.data(), payload.size()));
+        ASSERT_TRUE(client.read(record, 1000));
+        EXPECT_EQ(record, payload);
+    }
+
+    // 空环上等待超时
+    EXPECT_FALSE(client.read(record, 10));
+
+    client.close();
+    EXPECT_FALSE(server.isPeerAttached());
+}
+
+TEST_F(SharedMemoryChannelTest, BlockingReadWakesOnWrite) {
+    SharedMemoryChannel server;
+    SharedMemoryChannel client;
+    ASSERT_TRUE(server.create(m_name, 4096));
+    ASSERT_TRUE(client.open(m_name));
+
+    std::thread writer([&server]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        server.write("wake", 4);
+    });
+
+    std::vector<uint8_t> record;
+    EXPECT_TRUE(client.read(record, 5000));
+    EXPECT_EQ(record, bytes("wake"));
+    writer.join();
+}
+
+TEST_F(SharedMemoryChannelTest, OpenRejectsCapacityBeyondSegment) {
+    // 伪造段头：声明1MB环容量，实际段只有4KB
+    int fd = shm_open(("/" + m_name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, 4096), 0);
+    void* base = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(base, MAP_FAILED);
+    close(fd);
+
+    uint32_t magic = 0x524E5348;
+    uint32_t version = 1;
+    uint64_t capacity = 1 << 20;
+    std::memcpy(static_cast<uint8_t*>(base), &magic, sizeof(magic));
+    std::memcpy(static_cast<uint8_t*>(base) + 4, &version, sizeof(version));
+    std::memcpy(static_cast<uint8_t*>(base) + 8, &capacity, sizeof(capacity));
+
+    SharedMemoryChannel client;
+    EXPECT_FALSE(client.open(m_name));
+
+    // 非2的幂同样拒绝
+    capacity = 1000;
+    std::memcpy(static_cast<uint8_t*>(base) + 8, &capacity, sizeof(capacity));
+    EXPECT_FALSE(client.open(m_name));
+
+    munmap(base, 4096);
+}
+
+TEST_F(SharedMemoryChannelTest, ReadRejectsCorruptLengthPrefix) {
+    constexpr size_t capacity = 4096;
+    SharedMemoryChannel server;
+    SharedMemoryChannel client;
+    ASSERT_TRUE(server.create(m_name, capacity));
+    ASSERT_TRUE(client.open(m_name));
+
+    ASSERT_TRUE(client.write("hello", 5));
+
+    // 另行映射同一段，篡改上行环第一条记录的长度前缀
+    size_t segmentSize = SEGMENT_HEADER + 2 * (RING_HEADER + capacity);
+    int fd = shm_open(("/" + m_name).c_str(), O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    void* base = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(base, MAP_FAILED);
+    close(fd);
+
+    uint8_t* uplinkData = static_cast<uint8_t*>(base) + SEGMENT_HEADER + (RING_HEADER + capacity) + RING_HEADER;
+    uint32_t bogus = 0xFFFFFFF0u;
+    std::memcpy(uplinkData, &bogus, sizeof(bogus));
+
+    std::vector<uint8_t> record;
+    EXPECT_FALSE(server.read(record, 0));
+    EXPECT_TRUE(record.empty());
+
+    // 长度未超出容量但超出已写入数据，同样拒绝
+    ASSERT_TRUE(client.write("hello", 5));
+    uint32_t pastWrite = 100;
+    std::memcpy(uplinkData + 9, &pastWrite, sizeof(pastWrite));
+    EXPECT_FALSE(server.read(record, 0));
+
+    // 丢弃损坏数据后从写位置重新对齐，后续记录正常
+    ASSERT_TRUE(client.write("again", 5));
+    ASSERT_TRUE(server.read(record, 0));
+    EXPECT_EQ(record, bytes("again"));
+
+    munmap(base, segmentSize);
+}
+
+TEST_F(SharedMemoryChannelTest, BackendServesChannelFromConfig) {
+    const QJsonObject communication = QJsonDocument::fromJson(QString(R"({
+        "backend": {"port": 0, "eventLoops": 1, "workerThreads": 1},
+        "sharedMemory": {"name": "%1", "ringCapacity": 65536}
+    })").arg(QString::fromStdString(m_name)).toUtf8()).object();
+
+    SocketServer::Config config = SocketServer::Config::fromJson(communication);
+    EXPECT_TRUE(config.sharedMemoryEnabled);
+    EXPECT_EQ(config.sharedMemoryName, m_name);
+    EXPECT_EQ(config.sharedMemoryRingCapacity, 65536u);
+
+    SocketServer server;
+    ASSERT_TRUE(server.initialize(config));
+    ASSERT_TRUE(server.start());
+
+    // 前端以客户端身份打开后端创建的通道
+    SharedMemoryChannel client;
+    ASSERT_TRUE(client.open(m_name));
+
+    Message ping(MessageType::SYSTEM_PING);
+    ping.setData(bytes("ping"));
+    std::vector<uint8_t> frame = ping.serialize();
+    ASSERT_TRUE(client.write(frame.data(), frame.size()));
+
+    std::vector<uint8_t> record;
+    ASSERT_TRUE(client.read(record, 5000));
+    Message pong(MessageType::SYSTEM_PING);
+    ASSERT_TRUE(pong.deserialize(record));
+    EXPECT_EQ(pong.getType(), MessageType::SYSTEM_PONG);
+    EXPECT_EQ(pong.getSequence(), ping.getSequence());
+    EXPECT_EQ(pong.getData(), bytes("ping"));
+
+    // 广播同时送达共享内存对端
+    Message notice(MessageType::STATUS_SERVER_LOAD);
+    ASSERT_TRUE(server.sendMessage(notice));
+    ASSERT_TRUE(client.read(record, 5000));
+    ASSERT_TRUE(pong.deserialize(record));
+    EXPECT_EQ(pong.getType(), MessageType::STATUS_SERVER_LOAD);
+    EXPECT_EQ(server.getStatistics()["sharedMemoryAttached"], 1u);
+
+    // 停止后通道被删除，前端看到对端离线
+    server.stop();
+    EXPECT_FALSE(client.isPeerAttached());
+    SharedMemoryChannel late;
+    EXPECT_FALSE(late.open(m_name));
+}
+
+TEST_F(SharedMemoryChannelTest, BackendAcceptsFrontendFrames) {
+    SocketServer::Config config;
+    config.port = 0;
+    config.eventLoops = 1;
+    config.workerThreads = 1;
+    config.sharedMemoryName = m_name;
+    config.sharedMemoryRingCapacity = 65536;
+
+    std::mutex mutex;
+    std::condition_variable received;
+    std::unique_ptr<Message> request;
+
+    SocketServer server;
+    ASSERT_TRUE(server.initialize(config));
+    server.setMessageHandler([&](uint64_t connectionId, std::unique_ptr<Message> message) {
+        EXPECT_EQ(connectionId, SocketServer::SHARED_MEMORY_CONNECTION_ID);
+        std::lock_guard<std::mutex> lock(mutex);
+        request = std::move(message);
+        received.notify_one();
+    });
+    ASSERT_TRUE(server.start());
+
+    SharedMemoryChannel client;
+    ASSERT_TRUE(client.open(m_name));
+
+    // 与NetworkIoWorker::serializeMessage相同：紧凑JSON负载，心跳帧类型为SYSTEM_PING
+    QByteArray heartbeat = NetworkFrame::encode(NetworkFrame::PING_TYPE,
+        R"({"data":{},"requestId":"1","timestamp":1,"type":9999})", 7);
+    ASSERT_TRUE(client.write(heartbeat.constData(), static_cast<size_t>(heartbeat.size())));
+
+    std::vector<uint8_t> record;
+    ASSERT_TRUE(client.read(record, 5000));
+    QByteArray buffer(reinterpret_cast<const char*>(record.data()), static_cast<int>(record.size()));
+    quint16 type = 0;
+    QByteArray payload;
+    ASSERT_EQ(NetworkFrame::decode(buffer, type, payload), NetworkFrame::Status::Complete);
+    EXPECT_EQ(type, NetworkFrame::PONG_TYPE);
+    EXPECT_TRUE(buffer.isEmpty());
+
+    Message pong(MessageType::SYSTEM_PING);
+    ASSERT_TRUE(pong.deserialize(record));
+    EXPECT_EQ(pong.getSequence(), 7u);
+
+    // 业务帧交给上层处理器，负载保持原样
+    const QByteArray json = R"({"data":{},"requestId":"42","timestamp":1,"type":1008})";
+    QByteArray list = NetworkFrame::encode(1008, json);
+    ASSERT_TRUE(client.write(list.constData(), static_cast<size_t>(list.size())));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(received.wait_for(lock, std::chrono::seconds(5), [&]() { return request != nullptr; }));
+        EXPECT_EQ(static_cast<uint16_t>(request->getType()), 1008u);
+        EXPECT_EQ(request->getData(), std::vector<uint8_t>(json.begin(), json.end()));
+    }
+
+    // 后端下发的帧前端能解出，连续的多帧逐一取出
+    Message notice(MessageType::STATUS_SERVER_LOAD);
+    notice.setData(bytes(R"({"load":3})"));
+    std::vector<uint8_t> noticeFrame = notice.serialize();
+    buffer = QByteArray(reinterpret_cast<const char*>(noticeFrame.data()), static_cast<int>(noticeFrame.size()));
+    buffer += buffer;
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(NetworkFrame::decode(buffer, type, payload), NetworkFrame::Status::Complete);
+        EXPECT_EQ(type, static_cast<quint16>(MessageType::STATUS_SERVER_LOAD));
+        EXPECT_EQ(payload, QByteArray(R"({"load":3})"));
+    }
+    EXPECT_EQ(NetworkFrame::decode(buffer, type, payload), NetworkFrame::Status::Incomplete);
+
+    server.stop();
+}
+
+TEST_F(SharedMemoryChannelTest, FrontendRejectsUntrustedFrameHeaders) {
+    quint16 type = 0;
+    QByteArray payload;
+
+    // 旧格式的长度前缀JSON没有魔数
+    QByteArray legacy = QByteArray("\x28\x00\x00\x00", 4) + QByteArray(40, ' ');
+    EXPECT_EQ(NetworkFrame::decode(legacy, type, payload), NetworkFrame::Status::Invalid);
+
+    // 长度超过上限时立即拒绝，而不是等待补齐
+    QByteArray oversized = NetworkFrame::encode(NetworkFrame::PING_TYPE, QByteArray());
+    quint32 huge = NetworkFrame::MAX_PAYLOAD_SIZE + 1;
+    std::memcpy(oversized.data() + 8, &huge, sizeof(huge));
+    EXPECT_EQ(NetworkFrame::decode(oversized, type, payload), NetworkFrame::Status::Invalid);
+
+    // 校验和不符的帧被移除，后续帧照常解出
+    QByteArray frames = NetworkFrame::encode(1008, "abc") + NetworkFrame::encode(1009, "def");
+    frames[NetworkFrame::HEADER_SIZE] = 'x';
+    EXPECT_EQ(NetworkFrame::decode(frames, type, payload), NetworkFrame::Status::Corrupt);
+    ASSERT_EQ(NetworkFrame::decode(frames, type, payload), NetworkFrame::Status::Complete);
+    EXPECT_EQ(type, 1009u);
+    EXPECT_EQ(payload, QByteArray("def"));
+}
+
+#endif // __linux__
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
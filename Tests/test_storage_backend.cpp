@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include "StorageBackend.h"
+#include "BulkUpsertWriter.h"
+#include "OfflineWriteBuffer.h"
+
+class StorageBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        backend = std::make_unique<SqliteBackend>(tempDir.filePath("local.db"), 5000);
+        db = backend->openConnection("storage_backend_test");
+        ASSERT_TRUE(db);
+
+        QSqlQuery query(*db);
+        for (const QString& sql : backend->schemaStatements(true)) {
+            ASSERT_TRUE(query.exec(sql)) << sql.toStdString();
+        }
+    }
+
+    void TearDown() override {
+        db->close();
+        db.reset();
+        QSqlDatabase::removeDatabase("storage_backend_test");
+    }
+
+    BulkUpsertWriter::TableSpec playerSpec() {
+        BulkUpsertWriter::TableSpec spec;
+        spec.targetTable = "RAN_AI_Players";
+        spec.columns = { "ai_id", "name", "school", "level" };
+        spec.keyColumns = { "ai_id" };
+        spec.computedColumns = {
+            { "created_time", backend->nowExpression(), false },
+            { "last_update", backend->nowExpression(), true }
+        };
+        return spec;
+    }
+
+    QVector<QVariantList> playerColumns(int count, int level) {
+        QVector<QVariantList> columns(4);
+        for (int i = 0; i < count; ++i) {
+            columns[0] << QString("AI_%1").arg(i);
+            columns[1] << QString("Player_%1").arg(i);
+            columns[2] << i % 3;
+            columns[3] << level;
+        }
+        return columns;
+    }
+
+    QVariant scalar(const QString& sql) {
+        QSqlQuery query(*db);
+        query.exec(sql);
+        query.next();
+        return query.value(0);
+    }
+
+    QTemporaryDir tempDir;
+    std::unique_ptr<SqliteBackend> backend;
+    std::shared_ptr<QSqlDatabase> db;
+};
+
+TEST_F(StorageBackendTest, OpensInWalModeWithSchema) {
+    EXPECT_EQ(scalar("PRAGMA journal_mode").toString(), "wal");
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name LIKE 'RAN_%'").toInt(), 3);
+    EXPECT_FALSE(backend->supportsPartitionedLogs());
+}
+
+TEST_F(StorageBackendTest, SingleRowUpsertInsertsThenUpdates) {
+    QString sql = BulkUpsertWriter::singleRowUpsertSql(playerSpec(), SqlDialect::Sqlite);
+
+    QSqlQuery query(*db);
+    ASSERT_TRUE(query.prepare(sql));
+    for (int level : { 1, 7 }) {
+        query.bindValue(0, "AI_1");
+        query.bindValue(1, "Player");
+        query.bindValue(2, 2);
+        query.bindValue(3, level);
+        ASSERT_TRUE(query.exec());
+    }
+
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 1);
+    EXPECT_EQ(scalar("SELECT level FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toInt(), 7);
+}
+
+TEST_F(StorageBackendTest, DaysAgoExpressionComparesWithTimestamps) {
+    QSqlQuery query(*db);
+    ASSERT_TRUE(query.exec("INSERT INTO RAN_AI_Logs (ai_id, operation, timestamp) "
+                           "VALUES ('AI_1', 'old', '2000-01-01T00:00:00.000')"));
+    ASSERT_TRUE(query.exec("INSERT INTO RAN_AI_Logs (ai_id, operation) VALUES ('AI_1', 'new')"));
+
+    ASSERT_TRUE(query.prepare("DELETE FROM RAN_AI_Logs WHERE timestamp < " + backend->daysAgoExpression()));
+    query.addBindValue(7);
+    ASSERT_TRUE(query.exec());
+
+    EXPECT_EQ(query.numRowsAffected(), 1);
+    EXPECT_EQ(scalar("SELECT operation FROM RAN_AI_Logs").toString(), "new");
+}
+
+TEST_F(StorageBackendTest, BulkUpsertThroughput) {
+    const int rows = 10000;
+    BulkUpsertWriter writer(playerSpec(), 500, SqlDialect::Sqlite);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ASSERT_TRUE(db->transaction());
+    ASSERT_TRUE(writer.upsert(*db, playerColumns(rows, 1))) << writer.lastError().toStdString();
+    ASSERT_TRUE(writer.upsert(*db, playerColumns(rows, 2))) << writer.lastError().toStdString();
+    ASSERT_TRUE(db->commit());
+
+    qint64 elapsedMs = qMax<qint64>(1, timer.elapsed());
+    RecordProperty("rows_per_second", static_cast<int>(2 * rows * 1000 / elapsedMs));
+
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), rows);
+    EXPECT_EQ(scalar("SELECT MIN(level) FROM RAN_AI_Players").toInt(), 2);
+    EXPECT_LT(elapsedMs, 10000);
+}
+
+TEST_F(StorageBackendTest, OfflineBufferReplaysInOrderAndDiscardsBadStatements) {
+    OfflineWriteBuffer buffer(tempDir.filePath("offline.db"));
+    ASSERT_TRUE(buffer.open());
+
+    QString upsert = BulkUpsertWriter::singleRowUpsertSql(playerSpec(), SqlDialect::Sqlite);
+    ASSERT_TRUE(buffer.append(upsert, { "AI_1", "Player", 0, 1 }));
+    ASSERT_TRUE(buffer.append("UPDATE RAN_AI_Missing SET level = ?", { 5 }));
+    ASSERT_TRUE(buffer.appendAll(upsert, { { "AI_1", "Player", 0, 3 }, { "AI_2", "Other", 1, 4 } }));
+    EXPECT_EQ(buffer.pendingCount(), 4);
+
+    bool connectionLost = true;
+    EXPECT_EQ(buffer.replay(*db, 100, &connectionLost), 3);
+    EXPECT_FALSE(connectionLost);
+
+    OfflineBufferStats stats = buffer.stats();
+    EXPECT_EQ(stats.pending, 0);
+    EXPECT_EQ(stats.buffered, 4u);
+    EXPECT_EQ(stats.discarded, 1u);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 2);
+    EXPECT_EQ(scalar("SELECT level FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toInt(), 3);
+
+    buffer.close();
+}
+
+TEST_F(StorageBackendTest, OfflineBufferKeepsOperationsAcrossReopen) {
+    const QString path = tempDir.filePath("offline_reopen.db");
+    {
+        OfflineWriteBuffer buffer(path);
+        ASSERT_TRUE(buffer.open());
+        ASSERT_TRUE(buffer.append("DELETE FROM RAN_AI_Players WHERE ai_id = ?", { "AI_1" }));
+    }
+
+    OfflineWriteBuffer reopened(path);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(reopened.pendingCount(), 1);
+
+    // 远端连接已关闭：保留操作，报告连接中断
+    db->close();
+    bool connectionLost = false;
+    EXPECT_EQ(reopened.replay(*db, 100, &connectionLost), 0);
+    EXPECT_TRUE(connectionLost);
+    EXPECT_EQ(reopened.pendingCount(), 1);
+}
+
+TEST_F(StorageBackendTest, ParamsRoundTrip) {
+    QVariantList params = { "AI_1", 42, true, QVariant(), 3.5 };
+    QVariantList decoded = OfflineWriteBuffer::decodeParams(OfflineWriteBuffer::encodeParams(params));
+
+    ASSERT_EQ(decoded.size(), params.size());
+    EXPECT_EQ(decoded.at(0).toString(), "AI_1");
+    EXPECT_EQ(decoded.at(1).toInt(), 42);
+    EXPECT_TRUE(decoded.at(2).toBool());
+    EXPECT_TRUE(decoded.at(3).isNull());
+    EXPECT_DOUBLE_EQ(decoded.at(4).toDouble(), 3.5);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TimeSeriesStore.h"
+
+class TimeSeriesStoreTest : public ::testing::Test {
+protected:
+    // 每秒一个采样，通道0为i，通道1为2i
+    static void appendSeconds(TimeSeriesStore &store, int seconds) {
+        for (int i = 0; i < seconds; ++i) {
+            const double values[2] = { static_cast<double>(i), 2.0 * i };
+            store.append(i * 1000LL, values);
+        }
+    }
+};
+
+TEST_F(TimeSeriesStoreTest, RawRingKeepsNewestPoints) {
+    TimeSeriesStore::Capacity capacity;
+    capacity.raw = 5;
+    TimeSeriesStore store(2, capacity);
+    appendSeconds(store, 12);
+
+    EXPECT_EQ(store.size(TimeSeriesStore::Resolution::Raw), 5);
+
+    const auto points = store.latest(TimeSeriesStore::Resolution::Raw, 10);
+    ASSERT_EQ(points.size(), 5);
+    EXPECT_EQ(points.first().timestampMs, 7000);
+    EXPECT_EQ(points.last().timestampMs, 11000);
+    EXPECT_DOUBLE_EQ(points.last().values[1].avg, 22.0);
+}
+
+TEST_F(TimeSeriesStoreTest, RollupsKeepMinMaxAvg) {
+    TimeSeriesStore store(2);
+    appendSeconds(store, 125);
+
+    // 120秒开始的10秒桶和1分钟桶尚未结束，不可见
+    const auto tenSeconds = store.latest(TimeSeriesStore::Resolution::TenSeconds, 100);
+    ASSERT_EQ(tenSeconds.size(), 12);
+    EXPECT_EQ(tenSeconds.last().timestampMs, 110000);
+    EXPECT_DOUBLE_EQ(tenSeconds.last().values[0].min, 110.0);
+    EXPECT_DOUBLE_EQ(tenSeconds.last().values[0].max, 119.0);
+    EXPECT_DOUBLE_EQ(tenSeconds.last().values[0].avg, 114.5);
+
+    const auto minutes = store.latest(TimeSeriesStore::Resolution::OneMinute, 100);
+    ASSERT_EQ(minutes.size(), 2);
+    EXPECT_DOUBLE_EQ(minutes[0].values[0].avg, 29.5);
+    EXPECT_DOUBLE_EQ(minutes[1].values[1].avg, 179.0);
+    EXPECT_DOUBLE_EQ(minutes[1].values[1].max, 238.0);
+}
+
+TEST_F(TimeSeriesStoreTest, RangeQueryFiltersByTime) {
+    TimeSeriesStore store(2);
+    appendSeconds(store, 60);
+
+    const auto all = store.range(TimeSeriesStore::Resolution::OneSecond, 10000, 20000);
+    ASSERT_EQ(all.size(), 11);
+    EXPECT_EQ(all.first().timestampMs, 10000);
+    EXPECT_EQ(all.last().timestampMs, 20000);
+
+    // 超过maxPoints时保留最新的点
+    const auto newest = store.range(TimeSeriesStore::Resolution::OneSecond, 10000, 20000, 5);
+    ASSERT_EQ(newest.size(), 5);
+    EXPECT_EQ(newest.first().timestampMs, 16000);
+}
+
+TEST_F(TimeSeriesStoreTest, ResolutionCoversSpan) {
+    TimeSeriesStore store(1);
+    EXPECT_EQ(store.resolutionFor(60 * 1000), TimeSeriesStore::Resolution::OneSecond);
+    EXPECT_EQ(store.resolutionFor(2 * 3600 * 1000), TimeSeriesStore::Resolution::TenSeconds);
+    EXPECT_EQ(store.resolutionFor(24 * 3600 * 1000), TimeSeriesStore::Resolution::OneMinute);
+}
+
+TEST_F(TimeSeriesStoreTest, ConcurrentReadersSeeConsistentPoints) {
+    TimeSeriesStore::Capacity capacity;
+    capacity.raw = 64;
+    TimeSeriesStore store(8, capacity);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<int> reads{0};
+
+    std::thread writer([&]() {
+        double values[8];
+        for (int i = 1; i <= 200000; ++i) {
+            std::fill(std::begin(values), std::end(values), static_cast<double>(i));
+            store.append(i * 1000LL, values);
+        }
+        done = true;
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            do {
+                qint64 previous = -1;
+                for (const auto &point : store.latest(TimeSeriesStore::Resolution::Raw, 64)) {
+                    // 同一个点的所有通道必须来自同一次写入，且时间严格递增
+                    for (const auto &value : point.values) {
+                        if (value.avg * 1000 != point.timestampMs) {
+                            inconsistent++;
+                        }
+                    }
+                    if (point.timestampMs <= previous) {
+                        inconsistent++;
+                    }
+                    previous = point.timestampMs;
+                }
+                reads++;
+            } while (!done);
+        });
+    }
+
+    writer.join();
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(inconsistent.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include "AIWriteBehindCache.h"
+
+class WriteBehindCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_dir.isValid());
+        m_journalPath = m_dir.filePath("ai_write_behind.journal");
+
+        db = QSqlDatabase::addDatabase("QSQLITE", "write_behind_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open());
+
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec("CREATE TABLE RAN_AI_Players ("
+                               "ai_id TEXT PRIMARY KEY, name TEXT NOT NULL, level INTEGER, "
+                               "created_time TEXT, last_update TEXT)"));
+    }
+
+    void TearDown() override {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("write_behind_test");
+    }
+
+    static BulkUpsertWriter::TableSpec playerSpec() {
+        BulkUpsertWriter::TableSpec spec;
+        spec.targetTable = "RAN_AI_Players";
+        spec.stagingTable = "#RAN_AI_Players_Stage";
+        spec.columns = { "ai_id", "name", "level" };
+        spec.columnTypes = { "NVARCHAR(50) NOT NULL", "NVARCHAR(100)", "INT" };
+        spec.keyColumns = { "ai_id" };
+        spec.computedColumns = {
+            { "created_time", "CURRENT_TIMESTAMP", false },
+            { "last_update", "CURRENT_TIMESTAMP", true }
+        };
+        return spec;
+    }
+
+    // 与DatabaseManager相同的调用顺序：事务内刷写，提交后确认，失败回滚后恢复
+    bool flushCommitted(AIWriteBehindCache& cache) {
+        if (!db.transaction()) {
+            return false;
+        }
+        if (cache.flush(db, 100) && db.commit()) {
+            cache.commitFlush();
+            return true;
+        }
+        db.rollback();
+        cache.abortFlush();
+        return false;
+    }
+
+    QVariant scalar(const QString& sql) {
+        QSqlQuery query(db);
+        query.exec(sql);
+        query.next();
+        return query.value(0);
+    }
+
+    qint64 journalSize() const {
+        return QFileInfo(m_journalPath).size();
+    }
+
+    QTemporaryDir m_dir;
+    QString m_journalPath;
+    QSqlDatabase db;
+};
+
+TEST_F(WriteBehindCacheTest, CrashReplayRecoversUnflushedChanges) {
+    {
+        AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+        ASSERT_EQ(cache.open(), 0);
+        EXPECT_EQ(cache.setRow("AI_1", { "Alpha", 1 }), 2);
+        EXPECT_TRUE(cache.setField("AI_2", "level", 5));
+        // 未刷写即退出
+    }
+
+    // 崩溃时写了一半的尾记录
+    QFile journal(m_journalPath);
+    ASSERT_TRUE(journal.open(QIODevice::Append));
+    journal.write("\x52\x57\x42", 3);
+    journal.close();
+
+    {
+        AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+        ASSERT_EQ(cache.open(), 2);
+        ASSERT_TRUE(flushCommitted(cache)) << cache.lastError().toStdString();
+
+        // AI_2只知道level，库中也没有这一行：无法插入，保持为脏
+        EXPECT_EQ(cache.lastFlushedRows(), 1);
+        EXPECT_EQ(cache.dirtyCount(), 1);
+        EXPECT_EQ(scalar("SELECT name FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toString(), "Alpha");
+        EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 1);
+    }
+
+    // 已写入标记生效：重启后只恢复仍未写入的AI_2
+    AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+    ASSERT_EQ(cache.open(), 1);
+
+    // 补齐整行后插入
+    EXPECT_TRUE(cache.setField("AI_2", "name", "Beta"));
+    ASSERT_TRUE(flushCommitted(cache));
+    EXPECT_EQ(cache.dirtyCount(), 0);
+    EXPECT_EQ(scalar("SELECT level FROM RAN_AI_Players WHERE ai_id = 'AI_2'").toInt(), 5);
+    EXPECT_EQ(journalSize(), 0);
+}
+
+TEST_F(WriteBehindCacheTest, AbortRestoresDirtyFieldsForRetry) {
+    AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+    ASSERT_EQ(cache.open(), 0);
+    for (int i = 0; i < 3; ++i) {
+        cache.setRow(QString("AI_%1").arg(i), { QString("Player_%1").arg(i), i });
+    }
+
+    ASSERT_TRUE(db.transaction());
+    ASSERT_TRUE(cache.flush(db, 100));
+    EXPECT_EQ(cache.dirtyCount(), 0);
+    ASSERT_TRUE(db.rollback());
+    cache.abortFlush();
+
+    EXPECT_EQ(cache.dirtyCount(), 3);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 0);
+    EXPECT_GT(journalSize(), 0);
+
+    ASSERT_TRUE(flushCommitted(cache));
+    EXPECT_EQ(cache.dirtyCount(), 0);
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 3);
+
+    // 没有待写字段时日志直接截断
+    EXPECT_EQ(journalSize(), 0);
+}
+
+TEST_F(WriteBehindCacheTest, UpdateOfMissingRowReinsertsFullRow) {
+    AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+    ASSERT_EQ(cache.open(), 0);
+    cache.setRow("AI_1", { "Alpha", 1 });
+    ASSERT_TRUE(flushCommitted(cache));
+
+    // 行在库外被删除，之后的变化列UPDATE命中0行
+    QSqlQuery query(db);
+    ASSERT_TRUE(query.exec("DELETE FROM RAN_AI_Players"));
+    EXPECT_TRUE(cache.setField("AI_1", "level", 2));
+
+    ASSERT_TRUE(flushCommitted(cache)) << cache.lastError().toStdString();
+    EXPECT_EQ(cache.lastFlushedRows(), 1);
+    EXPECT_EQ(cache.dirtyCount(), 0);
+    EXPECT_EQ(scalar("SELECT name FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toString(), "Alpha");
+    EXPECT_EQ(scalar("SELECT level FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toInt(), 2);
+}
+
+TEST_F(WriteBehindCacheTest, ChangesDuringFlushSurviveCommitAndRestart) {
+    {
+        AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+        ASSERT_EQ(cache.open(), 0);
+        cache.setRow("AI_1", { "Alpha", 1 });
+
+        ASSERT_TRUE(db.transaction());
+        ASSERT_TRUE(cache.flush(db, 100));
+        EXPECT_TRUE(cache.setField("AI_1", "level", 9));   // 刷写期间的新修改
+        ASSERT_TRUE(db.commit());
+        cache.commitFlush();
+
+        EXPECT_EQ(cache.dirtyCount(), 1);
+        EXPECT_GT(journalSize(), 0);
+    }
+
+    AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+    ASSERT_EQ(cache.open(), 1);
+    ASSERT_TRUE(flushCommitted(cache));
+    EXPECT_EQ(scalar("SELECT level FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toInt(), 9);
+    EXPECT_EQ(scalar("SELECT name FROM RAN_AI_Players WHERE ai_id = 'AI_1'").toString(), "Alpha");
+}
+
+TEST_F(WriteBehindCacheTest, EvictsLeastRecentlyUsedCleanEntries) {
+    AIWriteBehindCache cache(playerSpec(), m_journalPath, SqlDialect::Sqlite);
+    ASSERT_EQ(cache.open(), 0);
+    cache.setCapacity(2);
+
+    for (int i = 0; i < 5; ++i) {
+        cache.setRow(QString("AI_%1").arg(i), { QString("Player_%1").arg(i), i });
+    }
+    EXPECT_EQ(cache.cachedCount(), 5);     // 脏项不淘汰
+
+    ASSERT_TRUE(flushCommitted(cache));
+    EXPECT_EQ(cache.cachedCount(), 2);
+
+    // 最近使用的仍在缓存中，相同值不置脏；被淘汰的按未知旧值处理
+    EXPECT_EQ(cache.setRow("AI_4", { "Player_4", 4 }), 0);
+    EXPECT_EQ(cache.setRow("AI_0", { "Player_0", 0 }), 2);
+    ASSERT_TRUE(flushCommitted(cache));
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM RAN_AI_Players").toInt(), 5);
+}
+
+int main(int argc, char **argv) {
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}